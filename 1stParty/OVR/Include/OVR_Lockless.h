@@ -29,7 +29,10 @@ limitations under the License.
 
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include <cstring> // memcpy
+#include <cstdint>
 
 #if defined(OVR_OS_WIN32) || defined(_WIN32) || defined(_WIN64)
 #if !defined(NOMINMAX)
@@ -361,6 +364,189 @@ class LocklessDataBuffer {
     uint8_t Slots[2][MaxBufferSize];
 };
 
+// ***** LocklessSpscQueue
+
+// Bounded queue for exactly one producer thread and one consumer thread, for cases where every
+// item matters (events, telemetry samples) rather than only the most recent one. Push() fails
+// instead of blocking when the queue is full, and Pop() fails when it is empty. The read and
+// write counters each live on their own cache line so the two threads don't contend.
+//
+// Capacity must be a power of two.
+
+template <class T, int Capacity>
+class LocklessSpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "power of two capacity");
+
+   public:
+    LocklessSpscQueue() : WriteCount(0), ReadCount(0) {}
+
+    LocklessSpscQueue(const LocklessSpscQueue&) = delete;
+    LocklessSpscQueue& operator=(const LocklessSpscQueue&) = delete;
+
+    // producer only
+    bool Push(const T& item) {
+        const uint32_t write = WriteCount.load(std::memory_order_relaxed);
+        if (write - ReadCount.load(std::memory_order_acquire) >= uint32_t(Capacity)) {
+            return false;
+        }
+        Slots[write & (Capacity - 1)] = item;
+        WriteCount.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only
+    bool Pop(T& item) {
+        const uint32_t read = ReadCount.load(std::memory_order_relaxed);
+        if (read == WriteCount.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = Slots[read & (Capacity - 1)];
+        ReadCount.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only; appends everything queued to items, with one acquire and one release for
+    // the whole batch. Returns the number of items taken.
+    int PopAll(std::vector<T>& items) {
+        const uint32_t read = ReadCount.load(std::memory_order_relaxed);
+        const uint32_t write = WriteCount.load(std::memory_order_acquire);
+        for (uint32_t i = read; i != write; ++i) {
+            items.push_back(Slots[i & (Capacity - 1)]);
+        }
+        ReadCount.store(write, std::memory_order_release);
+        return int(write - read);
+    }
+
+    // approximate unless called from the consumer with the producer idle
+    int GetCount() const {
+        return int(WriteCount.load(std::memory_order_acquire) -
+                   ReadCount.load(std::memory_order_acquire));
+    }
+
+   private:
+    alignas(64) std::atomic<uint32_t> WriteCount;
+    alignas(64) std::atomic<uint32_t> ReadCount;
+    alignas(64) T Slots[Capacity];
+};
+
+// ***** LocklessSpscOverflowQueue
+
+// A LocklessSpscQueue that never drops an item. While the ring has room, pushing and popping
+// are lock free. Once it fills up, the producer appends to an overflow vector under a mutex, and
+// keeps doing so until the consumer has taken the overflow, so items stay in order: the consumer
+// drains the ring first, then takes the whole overflow in one swap under the same mutex.
+//
+// The overflow grows as needed, so a consumer that stops popping costs memory instead of items.
+// The vectors are swapped rather than freed, so a recurring overflow stops allocating once they
+// are large enough.
+
+template <class T, int Capacity>
+class LocklessSpscOverflowQueue {
+   public:
+    LocklessSpscOverflowQueue()
+        : Overflowing(false), OverflowSize(0), NumOverflowed(0), DrainedIndex(0) {}
+
+    LocklessSpscOverflowQueue(const LocklessSpscOverflowQueue&) = delete;
+    LocklessSpscOverflowQueue& operator=(const LocklessSpscOverflowQueue&) = delete;
+
+    // producer only; never fails
+    void Push(const T& item) {
+        if (!Overflowing.load(std::memory_order_acquire) && Ring.Push(item)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(OverflowMutex);
+        Overflow.push_back(item);
+        OverflowSize.store(int(Overflow.size()), std::memory_order_relaxed);
+        NumOverflowed.fetch_add(1, std::memory_order_relaxed);
+        Overflowing.store(true, std::memory_order_release);
+    }
+
+    // consumer only
+    bool Pop(T& item) {
+        // items taken from the overflow are older than anything in the ring
+        if (DrainedIndex < Drained.size()) {
+            item = Drained[DrainedIndex++];
+            return true;
+        }
+        if (Ring.Pop(item)) {
+            return true;
+        }
+        if (!Overflowing.load(std::memory_order_acquire)) {
+            return false;
+        }
+        // the producer may have filled the ring and started on the overflow since the ring was
+        // found empty; those items are older, and no more go into the ring until this clears
+        // Overflowing
+        if (Ring.Pop(item)) {
+            return true;
+        }
+        // the ring is empty and the producer is appending to the overflow; take all of it, and
+        // the producer goes back to the ring with its next item
+        Drained.clear();
+        DrainedIndex = 0;
+        {
+            std::lock_guard<std::mutex> lock(OverflowMutex);
+            Drained.swap(Overflow);
+            OverflowSize.store(0, std::memory_order_relaxed);
+            Overflowing.store(false, std::memory_order_release);
+        }
+        if (Drained.empty()) {
+            return false;
+        }
+        item = Drained[DrainedIndex++];
+        return true;
+    }
+
+    // consumer only; replaces items with everything queued, in order. This is how a frame takes
+    // its events: the ring is copied out in one batch, and an overflow is swapped in without a
+    // copy when nothing older is ahead of it, so items and the overflow trade their storage.
+    void PopAll(std::vector<T>& items) {
+        items.clear();
+        if (DrainedIndex < Drained.size()) {
+            items.insert(items.end(), Drained.begin() + DrainedIndex, Drained.end());
+        }
+        Drained.clear();
+        DrainedIndex = 0;
+        Ring.PopAll(items);
+        if (!Overflowing.load(std::memory_order_acquire)) {
+            return;
+        }
+        // as in Pop(), the ring may have filled up again before the overflow started
+        Ring.PopAll(items);
+        std::lock_guard<std::mutex> lock(OverflowMutex);
+        if (items.empty()) {
+            items.swap(Overflow);
+        } else {
+            items.insert(items.end(), Overflow.begin(), Overflow.end());
+        }
+        Overflow.clear();
+        OverflowSize.store(0, std::memory_order_relaxed);
+        Overflowing.store(false, std::memory_order_release);
+    }
+
+    // approximate unless called from the consumer with the producer idle
+    int GetCount() const {
+        return Ring.GetCount() + int(Drained.size() - DrainedIndex) +
+            OverflowSize.load(std::memory_order_relaxed);
+    }
+
+    // Items that went through the overflow since the last call. Any thread.
+    int TakeNumOverflowed() {
+        return NumOverflowed.exchange(0, std::memory_order_relaxed);
+    }
+
+   private:
+    LocklessSpscQueue<T, Capacity> Ring;
+    std::atomic<bool> Overflowing; // set by the producer, cleared by the consumer
+    std::mutex OverflowMutex;
+    std::vector<T> Overflow;
+    std::atomic<int> OverflowSize;
+    std::atomic<int> NumOverflowed;
+    // consumer only: the overflow being drained
+    std::vector<T> Drained;
+    size_t DrainedIndex;
+};
+
 } // namespace OVR
 
 #endif // OVR_Lockless_h
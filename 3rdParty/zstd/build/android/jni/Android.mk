@@ -0,0 +1,26 @@
+LOCAL_PATH := $(call my-dir)/../../..
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := zstd
+LOCAL_ARM_MODE := arm
+LOCAL_ARM_NEON := true
+
+include $(LOCAL_PATH)/../../cflags.mk
+LOCAL_CFLAGS   := -w -DZSTD_DISABLE_ASM -DZSTD_LEGACY_SUPPORT=0
+
+LOCAL_SRC_FILES := \
+  src/common/debug.c \
+  src/common/entropy_common.c \
+  src/common/error_private.c \
+  src/common/fse_decompress.c \
+  src/common/xxhash.c \
+  src/common/zstd_common.c \
+  src/decompress/huf_decompress.c \
+  src/decompress/zstd_ddict.c \
+  src/decompress/zstd_decompress.c \
+  src/decompress/zstd_decompress_block.c
+
+LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH)/src
+
+include $(BUILD_STATIC_LIBRARY)
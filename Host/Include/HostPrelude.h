@@ -0,0 +1,32 @@
+/************************************************************************************
+
+Filename    :   HostPrelude.h
+Content     :   Included ahead of every host translation unit
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+// The NDK's libc++ headers pull these in transitively and the sources rely on it.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef __cplusplus
+#include <memory>
+#endif
+
+// bionic has these, glibc only since 2.38; HostApp.cpp provides them for older versions.
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+#ifdef __cplusplus
+extern "C" {
+#endif
+size_t strlcpy(char* dst, const char* src, size_t size);
+size_t strlcat(char* dst, const char* src, size_t size);
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,52 @@
+/************************************************************************************
+
+Filename    :   input.h
+Content     :   Host stand-in for the Android input events
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <android/keycodes.h>
+
+enum {
+    AINPUT_EVENT_TYPE_KEY = 1,
+    AINPUT_EVENT_TYPE_MOTION = 2,
+};
+
+enum {
+    AKEY_EVENT_ACTION_DOWN = 0,
+    AKEY_EVENT_ACTION_UP = 1,
+};
+
+enum {
+    AMOTION_EVENT_ACTION_MASK = 0xff,
+    AMOTION_EVENT_ACTION_DOWN = 0,
+    AMOTION_EVENT_ACTION_UP = 1,
+    AMOTION_EVENT_ACTION_MOVE = 2,
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The host never delivers input events through the looper, so these are never called with one.
+struct AInputEvent;
+typedef struct AInputEvent AInputEvent;
+
+int32_t AInputEvent_getType(const AInputEvent* event);
+int32_t AKeyEvent_getAction(const AInputEvent* keyEvent);
+int32_t AKeyEvent_getKeyCode(const AInputEvent* keyEvent);
+float AMotionEvent_getRawX(const AInputEvent* motionEvent, size_t pointerIndex);
+float AMotionEvent_getRawY(const AInputEvent* motionEvent, size_t pointerIndex);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,27 @@
+/************************************************************************************
+
+Filename    :   keycodes.h
+Content     :   Host stand-in for the Android key codes
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+// The codes match the Android ones, so recorded and scripted events mean the same on both.
+enum {
+    AKEYCODE_UNKNOWN = 0,
+    AKEYCODE_BACK = 4,
+    AKEYCODE_DPAD_UP = 19,
+    AKEYCODE_DPAD_DOWN = 20,
+    AKEYCODE_DPAD_LEFT = 21,
+    AKEYCODE_DPAD_RIGHT = 22,
+    AKEYCODE_DPAD_CENTER = 23,
+    AKEYCODE_VOLUME_UP = 24,
+    AKEYCODE_VOLUME_DOWN = 25,
+    AKEYCODE_ENTER = 66,
+    AKEYCODE_ESCAPE = 111,
+};
@@ -0,0 +1,33 @@
+/************************************************************************************
+
+Filename    :   looper.h
+Content     :   Host stand-in for ALooper
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+enum {
+    ALOOPER_POLL_WAKE = -1,
+    ALOOPER_POLL_CALLBACK = -2,
+    ALOOPER_POLL_TIMEOUT = -3,
+    ALOOPER_POLL_ERROR = -4,
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ALooper;
+typedef struct ALooper ALooper;
+
+// Scripted by HostApp.cpp: returns the next pending lifecycle command, or a timeout.
+int ALooper_pollAll(int timeoutMillis, int* outFd, int* outEvents, void** outData);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,39 @@
+/************************************************************************************
+
+Filename    :   native_activity.h
+Content     :   Host stand-in for ANativeActivity
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <jni.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct AAssetManager;
+
+typedef struct ANativeActivity {
+    void* callbacks;
+    JavaVM* vm;
+    JNIEnv* env;
+    jobject clazz;
+    const char* internalDataPath;
+    const char* externalDataPath;
+    int32_t sdkVersion;
+    void* instance;
+    struct AAssetManager* assetManager;
+    const char* obbPath;
+} ANativeActivity;
+
+void ANativeActivity_finish(ANativeActivity* activity);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,25 @@
+/************************************************************************************
+
+Filename    :   native_window.h
+Content     :   Host stand-in for ANativeWindow
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ANativeWindow;
+typedef struct ANativeWindow ANativeWindow;
+
+void ANativeWindow_release(ANativeWindow* window);
+
+#ifdef __cplusplus
+}
+#endif
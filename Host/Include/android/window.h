@@ -0,0 +1,12 @@
+/************************************************************************************
+
+Filename    :   window.h
+Content     :   Host stand-in for the Android window flags
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
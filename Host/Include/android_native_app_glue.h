@@ -0,0 +1,65 @@
+/************************************************************************************
+
+Filename    :   android_native_app_glue.h
+Content     :   Host stand-in for the native app glue, driven by HostApp.cpp
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <android/input.h>
+#include <android/looper.h>
+#include <android/native_activity.h>
+#include <android/native_window.h>
+
+struct android_app;
+
+struct android_poll_source {
+    int32_t id;
+    struct android_app* app;
+    void (*process)(struct android_app* app, struct android_poll_source* source);
+};
+
+// The members the framework reads, in the glue's order.
+struct android_app {
+    void* userData;
+    void (*onAppCmd)(struct android_app* app, int32_t cmd);
+    int32_t (*onInputEvent)(struct android_app* app, AInputEvent* event);
+    ANativeActivity* activity;
+    void* config;
+    void* savedState;
+    size_t savedStateSize;
+    ALooper* looper;
+    void* inputQueue;
+    ANativeWindow* window;
+    int activityState;
+    int destroyRequested;
+};
+
+enum {
+    APP_CMD_INPUT_CHANGED,
+    APP_CMD_INIT_WINDOW,
+    APP_CMD_TERM_WINDOW,
+    APP_CMD_WINDOW_RESIZED,
+    APP_CMD_WINDOW_REDRAW_NEEDED,
+    APP_CMD_CONTENT_RECT_CHANGED,
+    APP_CMD_GAINED_FOCUS,
+    APP_CMD_LOST_FOCUS,
+    APP_CMD_CONFIG_CHANGED,
+    APP_CMD_LOW_MEMORY,
+    APP_CMD_START,
+    APP_CMD_RESUME,
+    APP_CMD_SAVE_STATE,
+    APP_CMD_PAUSE,
+    APP_CMD_STOP,
+    APP_CMD_DESTROY,
+};
+
+extern void android_main(struct android_app* app);
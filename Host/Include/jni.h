@@ -0,0 +1,138 @@
+/************************************************************************************
+
+Filename    :   jni.h
+Content     :   Host stand-in for the JNI interface
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <stdarg.h>
+#include <stdint.h>
+
+// Only the part of JNI the framework uses. There is no Java VM on the host; HostJni.cpp answers
+// the package queries the file system makes and fails everything else the way a missing class
+// or method would, so callers take their existing error paths.
+
+#ifdef __cplusplus
+
+class _jobject {};
+class _jclass : public _jobject {};
+class _jstring : public _jobject {};
+class _jthrowable : public _jobject {};
+class _jarray : public _jobject {};
+class _jobjectArray : public _jarray {};
+class _jfloatArray : public _jarray {};
+class _jbyteArray : public _jarray {};
+class _jintArray : public _jarray {};
+
+typedef _jobject* jobject;
+typedef _jclass* jclass;
+typedef _jstring* jstring;
+typedef _jthrowable* jthrowable;
+typedef _jarray* jarray;
+typedef _jobjectArray* jobjectArray;
+typedef _jfloatArray* jfloatArray;
+typedef _jbyteArray* jbyteArray;
+typedef _jintArray* jintArray;
+typedef jobject jweak;
+
+#else // C sources only pass these around
+
+typedef void* jobject;
+typedef jobject jclass;
+typedef jobject jstring;
+typedef jobject jthrowable;
+typedef jobject jarray;
+typedef jarray jobjectArray;
+typedef jarray jfloatArray;
+typedef jarray jbyteArray;
+typedef jarray jintArray;
+typedef jobject jweak;
+
+#endif
+
+struct _jfieldID;
+struct _jmethodID;
+typedef struct _jfieldID* jfieldID;
+typedef struct _jmethodID* jmethodID;
+
+typedef uint8_t jboolean;
+typedef int8_t jbyte;
+typedef uint16_t jchar;
+typedef int16_t jshort;
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef float jfloat;
+typedef double jdouble;
+typedef jint jsize;
+
+#define JNI_FALSE 0
+#define JNI_TRUE 1
+
+#define JNI_OK 0
+#define JNI_ERR (-1)
+#define JNI_EDETACHED (-2)
+#define JNI_EVERSION (-3)
+
+#define JNI_VERSION_1_6 0x00010006
+
+#define JNIEXPORT __attribute__((visibility("default")))
+#define JNICALL
+
+#ifdef __cplusplus
+
+struct _JNIEnv {
+    jclass FindClass(const char* name);
+    jclass GetObjectClass(jobject obj);
+    jmethodID GetMethodID(jclass clazz, const char* name, const char* sig);
+    jmethodID GetStaticMethodID(jclass clazz, const char* name, const char* sig);
+    jfieldID GetFieldID(jclass clazz, const char* name, const char* sig);
+    jfieldID GetStaticFieldID(jclass clazz, const char* name, const char* sig);
+
+    jobject NewObject(jclass clazz, jmethodID methodID, ...);
+    jobject CallObjectMethod(jobject obj, jmethodID methodID, ...);
+    void CallVoidMethod(jobject obj, jmethodID methodID, ...);
+    jboolean CallBooleanMethod(jobject obj, jmethodID methodID, ...);
+    jint CallIntMethod(jobject obj, jmethodID methodID, ...);
+    jlong CallLongMethod(jobject obj, jmethodID methodID, ...);
+    jobject CallStaticObjectMethod(jclass clazz, jmethodID methodID, ...);
+    void CallStaticVoidMethod(jclass clazz, jmethodID methodID, ...);
+
+    jobject GetObjectField(jobject obj, jfieldID fieldID);
+    jint GetIntField(jobject obj, jfieldID fieldID);
+    jobject GetStaticObjectField(jclass clazz, jfieldID fieldID);
+    jint GetStaticIntField(jclass clazz, jfieldID fieldID);
+
+    jstring NewStringUTF(const char* bytes);
+    const char* GetStringUTFChars(jstring string, jboolean* isCopy);
+    void ReleaseStringUTFChars(jstring string, const char* utf);
+
+    jobject NewGlobalRef(jobject obj);
+    void DeleteGlobalRef(jobject globalRef);
+    void DeleteLocalRef(jobject localRef);
+
+    jthrowable ExceptionOccurred();
+    void ExceptionDescribe();
+    void ExceptionClear();
+};
+
+struct _JavaVM {
+    jint AttachCurrentThread(_JNIEnv** env, void* args);
+    jint DetachCurrentThread();
+    jint GetEnv(void** env, jint version);
+};
+
+typedef _JNIEnv JNIEnv;
+typedef _JavaVM JavaVM;
+
+#else
+
+typedef struct _JNIEnv JNIEnv;
+typedef struct _JavaVM JavaVM;
+
+#endif
@@ -0,0 +1,138 @@
+/************************************************************************************
+
+Filename    :   HostAndroid.cpp
+Content     :   Android NDK functions the libraries call outside of the app lifecycle
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostAndroid.h"
+
+#include <android/input.h>
+#include <android/native_window_jni.h>
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace OVRFW {
+
+namespace {
+
+std::atomic<int> LogPriority{ANDROID_LOG_INFO};
+std::mutex LogMutex;
+
+// ANativeWindow is opaque; the app only passes it on to vrapi_EnterVrMode
+struct ANativeWindowStandIn {
+    int Unused;
+} HostWindow;
+
+} // namespace
+
+//==============================
+// ovrHostAndroid::SetLogPriority
+void ovrHostAndroid::SetLogPriority(const android_LogPriority priority) {
+    LogPriority = priority;
+}
+
+//==============================
+// ovrHostAndroid::GetWindow
+ANativeWindow* ovrHostAndroid::GetWindow() {
+    return reinterpret_cast<ANativeWindow*>(&HostWindow);
+}
+
+} // namespace OVRFW
+
+using namespace OVRFW;
+
+extern "C" {
+
+ANativeWindow* ANativeWindow_fromSurface(JNIEnv* env, jobject surface) {
+    return ovrHostAndroid::GetWindow();
+}
+
+void ANativeWindow_release(ANativeWindow* window) {}
+
+int32_t AInputEvent_getType(const AInputEvent* event) {
+    return 0;
+}
+
+int32_t AKeyEvent_getAction(const AInputEvent* keyEvent) {
+    return 0;
+}
+
+int32_t AKeyEvent_getKeyCode(const AInputEvent* keyEvent) {
+    return AKEYCODE_UNKNOWN;
+}
+
+float AMotionEvent_getRawX(const AInputEvent* motionEvent, size_t pointerIndex) {
+    return 0.0f;
+}
+
+float AMotionEvent_getRawY(const AInputEvent* motionEvent, size_t pointerIndex) {
+    return 0.0f;
+}
+
+int __android_log_write(int prio, const char* tag, const char* text) {
+    if (prio < LogPriority) {
+        return 0;
+    }
+    static const char PRIORITY_LETTERS[] = "??VDIWEFS";
+    std::lock_guard<std::mutex> lock(LogMutex);
+    return fprintf(stderr, "%c/%s: %s\n", PRIORITY_LETTERS[prio & 7], tag, text);
+}
+
+int __android_log_vprint(int prio, const char* tag, const char* fmt, va_list ap) {
+    if (prio < LogPriority) {
+        return 0;
+    }
+    char text[4096];
+    vsnprintf(text, sizeof(text), fmt, ap);
+    return __android_log_write(prio, tag, text);
+}
+
+int __android_log_print(int prio, const char* tag, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    const int result = __android_log_vprint(prio, tag, fmt, ap);
+    va_end(ap);
+    return result;
+}
+
+void __android_log_assert(const char* cond, const char* tag, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    __android_log_vprint(ANDROID_LOG_FATAL, tag, fmt, ap);
+    va_end(ap);
+    abort();
+}
+
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    const size_t length = strlen(src);
+    if (size > 0) {
+        const size_t n = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return length;
+}
+
+size_t strlcat(char* dst, const char* src, size_t size) {
+    const size_t dstLength = strnlen(dst, size);
+    if (dstLength == size) {
+        return size + strlen(src);
+    }
+    return dstLength + strlcpy(dst + dstLength, src, size - dstLength);
+}
+
+#endif
+
+} // extern "C"
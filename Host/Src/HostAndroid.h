@@ -0,0 +1,31 @@
+/************************************************************************************
+
+Filename    :   HostAndroid.h
+Content     :   Android NDK functions the libraries call outside of the app lifecycle
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <android/log.h>
+#include <android/native_window.h>
+
+namespace OVRFW {
+
+//==============================================================
+// ovrHostAndroid
+// Logging goes to stderr, input events are empty and there is one window, which only stands for
+// the surface the app hands to vrapi_EnterVrMode. The looper and the activity are ovrHostApp's.
+class ovrHostAndroid {
+   public:
+    // Messages below this priority are not printed.
+    static void SetLogPriority(const android_LogPriority priority);
+
+    static ANativeWindow* GetWindow();
+};
+
+} // namespace OVRFW
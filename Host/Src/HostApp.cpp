@@ -0,0 +1,161 @@
+/************************************************************************************
+
+Filename    :   HostApp.cpp
+Content     :   Drives android_main() on the host through a scripted activity lifecycle
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostApp.h"
+#include "HostAndroid.h"
+#include "HostJni.h"
+#include "HostVrApi.h"
+
+#include "Misc/Log.h"
+
+namespace OVRFW {
+
+namespace {
+
+const int32_t LOOPER_ID_MAIN = 1;
+
+ovrHostApp* ActiveApp = nullptr;
+
+} // namespace
+
+//==============================
+// ovrHostApp::ovrHostApp
+ovrHostApp::ovrHostApp() : App(), Activity(), CmdSource(), PendingCmd(-1), StartFrames(0) {
+    Activity.vm = ovrHostJni::GetVm();
+    Activity.vm->GetEnv(reinterpret_cast<void**>(&Activity.env), JNI_VERSION_1_6);
+    Activity.clazz = ovrHostJni::GetActivity();
+    Activity.internalDataPath = "/tmp";
+    Activity.externalDataPath = "/tmp";
+    Activity.sdkVersion = 29;
+    App.activity = &Activity;
+    CmdSource.id = LOOPER_ID_MAIN;
+    CmdSource.app = &App;
+    CmdSource.process = ProcessCmd;
+
+    AddCommand(0, APP_CMD_START);
+    AddCommand(0, APP_CMD_RESUME);
+    AddCommand(0, APP_CMD_INIT_WINDOW);
+}
+
+//==============================
+// ovrHostApp::~ovrHostApp
+ovrHostApp::~ovrHostApp() {
+    if (ActiveApp == this) {
+        ActiveApp = nullptr;
+    }
+}
+
+//==============================
+// ovrHostApp::AddCommand
+void ovrHostApp::AddCommand(const uint64_t afterFrames, const int32_t cmd) {
+    Commands.push_back({afterFrames, cmd});
+}
+
+//==============================
+// ovrHostApp::ExitAfterFrames
+void ovrHostApp::ExitAfterFrames(const uint64_t frames) {
+    AddCommand(frames, APP_CMD_PAUSE);
+    AddCommand(frames, APP_CMD_TERM_WINDOW);
+    AddCommand(frames, APP_CMD_STOP);
+    AddCommand(frames, APP_CMD_DESTROY);
+}
+
+//==============================
+// ovrHostApp::Run
+void ovrHostApp::Run() {
+    ActiveApp = this;
+    StartFrames = ovrHostVrApi::GetStats().SubmittedFrames;
+    android_main(&App);
+    ActiveApp = nullptr;
+}
+
+//==============================
+// ovrHostApp::Poll
+int ovrHostApp::Poll(const int timeoutMillis, void** outData) {
+    if (Commands.empty()) {
+        if (timeoutMillis < 0 && App.destroyRequested == 0) {
+            // nothing would ever wake the looper up
+            ALOGW("host script ran out while the app waits for commands, destroying it");
+            ExitAfterFrames(0);
+        } else {
+            return ALOOPER_POLL_TIMEOUT;
+        }
+    }
+    const uint64_t frames = ovrHostVrApi::GetStats().SubmittedFrames - StartFrames;
+    // Without a VR session no frames are submitted, so a blocking poll takes the next command
+    // rather than waiting for a frame count that cannot be reached.
+    if (Commands.front().AfterFrames > frames && timeoutMillis >= 0) {
+        return ALOOPER_POLL_TIMEOUT;
+    }
+    PendingCmd = Commands.front().Cmd;
+    Commands.pop_front();
+    *outData = &CmdSource;
+    return LOOPER_ID_MAIN;
+}
+
+//==============================
+// ovrHostApp::ProcessCmd
+// What the glue does around onAppCmd for the commands the script sends.
+void ovrHostApp::ProcessCmd(android_app* app, android_poll_source* source) {
+    const int32_t cmd = ActiveApp->PendingCmd;
+    switch (cmd) {
+        case APP_CMD_INIT_WINDOW:
+            app->window = ovrHostAndroid::GetWindow();
+            break;
+        case APP_CMD_START:
+        case APP_CMD_RESUME:
+        case APP_CMD_PAUSE:
+        case APP_CMD_STOP:
+            app->activityState = cmd;
+            break;
+        default:
+            break;
+    }
+    if (app->onAppCmd != nullptr) {
+        app->onAppCmd(app, cmd);
+    }
+    switch (cmd) {
+        case APP_CMD_TERM_WINDOW:
+            app->window = nullptr;
+            break;
+        case APP_CMD_DESTROY:
+            app->destroyRequested = 1;
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace OVRFW
+
+using namespace OVRFW;
+
+//==============================================================================
+// Looper and activity stand-ins
+//==============================================================================
+
+extern "C" {
+
+int ALooper_pollAll(int timeoutMillis, int* outFd, int* outEvents, void** outData) {
+    if (ActiveApp == nullptr) {
+        return ALOOPER_POLL_ERROR;
+    }
+    return ActiveApp->Poll(timeoutMillis, outData);
+}
+
+void ANativeActivity_finish(ANativeActivity* activity) {
+    if (ActiveApp != nullptr) {
+        ActiveApp->Commands.clear();
+        ActiveApp->ExitAfterFrames(0);
+    }
+}
+
+} // extern "C"
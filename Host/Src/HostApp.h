@@ -0,0 +1,60 @@
+/************************************************************************************
+
+Filename    :   HostApp.h
+Content     :   Drives android_main() on the host through a scripted activity lifecycle
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <android_native_app_glue.h>
+
+#include <cstdint>
+#include <deque>
+
+namespace OVRFW {
+
+//==============================================================
+// ovrHostApp
+// Hands android_main() an android_app whose looper delivers lifecycle commands from a script
+// instead of the system. Each command waits until the stand-in VrApi has seen a number of frames
+// submitted, so a script can resume the activity, let it run, pause it and resume it again.
+// The default script starts, resumes and opens the window right away.
+class ovrHostApp {
+   public:
+    ovrHostApp();
+    ~ovrHostApp();
+
+    // Queues a command for once this many frames have been submitted since the app started.
+    void AddCommand(const uint64_t afterFrames, const int32_t cmd);
+    // Pauses, closes the window, stops and destroys the activity after this many frames.
+    void ExitAfterFrames(const uint64_t frames);
+
+    // Calls android_main() and returns when it does.
+    void Run();
+
+   private:
+    struct ovrHostCommand {
+        uint64_t AfterFrames;
+        int32_t Cmd;
+    };
+
+    android_app App;
+    ANativeActivity Activity;
+    android_poll_source CmdSource;
+    std::deque<ovrHostCommand> Commands;
+    int32_t PendingCmd;
+    uint64_t StartFrames;
+
+    friend int ::ALooper_pollAll(int, int*, int*, void**);
+    friend void ::ANativeActivity_finish(ANativeActivity*);
+
+    int Poll(const int timeoutMillis, void** outData);
+    static void ProcessCmd(android_app* app, android_poll_source* source);
+};
+
+} // namespace OVRFW
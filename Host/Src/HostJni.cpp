@@ -0,0 +1,252 @@
+/************************************************************************************
+
+Filename    :   HostJni.cpp
+Content     :   Stand-in Java VM for host builds
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostJni.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace OVRFW {
+
+namespace {
+
+enum ovrHostMethod {
+    HOST_METHOD_GET_PACKAGE_NAME = 1,
+    HOST_METHOD_GET_PACKAGE_CODE_PATH,
+    HOST_METHOD_GET_PACKAGE_MANAGER,
+    HOST_METHOD_GET_APPLICATION_INFO
+};
+
+enum ovrHostField { HOST_FIELD_SOURCE_DIR = 1 };
+
+struct ovrHostJniState {
+    std::mutex Mutex;
+    std::string PackageName = "cz.walle.wallevrcontroller2";
+    std::string PackageCodePath;
+    std::unordered_set<std::string> Strings; // interned, they live as long as the process
+    _jobject Activity;
+    _jclass ActivityClass;
+    _jobject PackageManager;
+    _jclass PackageManagerClass;
+    _jobject ApplicationInfo; // every package is "installed" at the package code path
+    _jclass ApplicationInfoClass;
+    _JNIEnv Env;
+    _JavaVM Vm;
+};
+
+ovrHostJniState& State() {
+    static ovrHostJniState state;
+    return state;
+}
+
+jmethodID MethodID(const ovrHostMethod method) {
+    return reinterpret_cast<jmethodID>(static_cast<uintptr_t>(method));
+}
+
+jfieldID FieldID(const ovrHostField field) {
+    return reinterpret_cast<jfieldID>(static_cast<uintptr_t>(field));
+}
+
+} // namespace
+
+//==============================
+// ovrHostJni::SetPackage
+void ovrHostJni::SetPackage(const char* packageName, const char* packageCodePath) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().PackageName = packageName;
+    State().PackageCodePath = packageCodePath;
+}
+
+//==============================
+// ovrHostJni::GetVm
+JavaVM* ovrHostJni::GetVm() {
+    return &State().Vm;
+}
+
+//==============================
+// ovrHostJni::GetActivity
+jobject ovrHostJni::GetActivity() {
+    return &State().Activity;
+}
+
+} // namespace OVRFW
+
+using namespace OVRFW;
+
+//==============================================================================
+// _JNIEnv
+//==============================================================================
+
+jclass _JNIEnv::FindClass(const char* name) {
+    if (strcmp(name, "android/content/pm/PackageManager") == 0) {
+        return &State().PackageManagerClass;
+    }
+    return nullptr;
+}
+
+jclass _JNIEnv::GetObjectClass(jobject obj) {
+    if (obj == &State().Activity) {
+        return &State().ActivityClass;
+    }
+    if (obj == &State().PackageManager) {
+        return &State().PackageManagerClass;
+    }
+    if (obj == &State().ApplicationInfo) {
+        return &State().ApplicationInfoClass;
+    }
+    return nullptr;
+}
+
+jmethodID _JNIEnv::GetMethodID(jclass clazz, const char* name, const char* sig) {
+    if (clazz == &State().ActivityClass) {
+        if (strcmp(name, "getPackageName") == 0) {
+            return MethodID(HOST_METHOD_GET_PACKAGE_NAME);
+        }
+        if (strcmp(name, "getPackageCodePath") == 0) {
+            return MethodID(HOST_METHOD_GET_PACKAGE_CODE_PATH);
+        }
+        if (strcmp(name, "getPackageManager") == 0) {
+            return MethodID(HOST_METHOD_GET_PACKAGE_MANAGER);
+        }
+    } else if (clazz == &State().PackageManagerClass) {
+        if (strcmp(name, "getApplicationInfo") == 0) {
+            return MethodID(HOST_METHOD_GET_APPLICATION_INFO);
+        }
+    }
+    return nullptr;
+}
+
+jmethodID _JNIEnv::GetStaticMethodID(jclass clazz, const char* name, const char* sig) {
+    return nullptr;
+}
+
+jfieldID _JNIEnv::GetFieldID(jclass clazz, const char* name, const char* sig) {
+    if (clazz == &State().ApplicationInfoClass && strcmp(name, "sourceDir") == 0) {
+        return FieldID(HOST_FIELD_SOURCE_DIR);
+    }
+    return nullptr;
+}
+
+jfieldID _JNIEnv::GetStaticFieldID(jclass clazz, const char* name, const char* sig) {
+    return nullptr;
+}
+
+jobject _JNIEnv::NewObject(jclass clazz, jmethodID methodID, ...) {
+    return nullptr;
+}
+
+jobject _JNIEnv::CallObjectMethod(jobject obj, jmethodID methodID, ...) {
+    if (obj == &State().Activity) {
+        if (methodID == MethodID(HOST_METHOD_GET_PACKAGE_NAME)) {
+            return NewStringUTF(State().PackageName.c_str());
+        }
+        if (methodID == MethodID(HOST_METHOD_GET_PACKAGE_CODE_PATH)) {
+            return NewStringUTF(State().PackageCodePath.c_str());
+        }
+        if (methodID == MethodID(HOST_METHOD_GET_PACKAGE_MANAGER)) {
+            return &State().PackageManager;
+        }
+    } else if (obj == &State().PackageManager) {
+        if (methodID == MethodID(HOST_METHOD_GET_APPLICATION_INFO)) {
+            return &State().ApplicationInfo;
+        }
+    }
+    return nullptr;
+}
+
+void _JNIEnv::CallVoidMethod(jobject obj, jmethodID methodID, ...) {}
+
+jboolean _JNIEnv::CallBooleanMethod(jobject obj, jmethodID methodID, ...) {
+    return JNI_FALSE;
+}
+
+jint _JNIEnv::CallIntMethod(jobject obj, jmethodID methodID, ...) {
+    return 0;
+}
+
+jlong _JNIEnv::CallLongMethod(jobject obj, jmethodID methodID, ...) {
+    return 0;
+}
+
+jobject _JNIEnv::CallStaticObjectMethod(jclass clazz, jmethodID methodID, ...) {
+    return nullptr;
+}
+
+void _JNIEnv::CallStaticVoidMethod(jclass clazz, jmethodID methodID, ...) {}
+
+jobject _JNIEnv::GetObjectField(jobject obj, jfieldID fieldID) {
+    if (obj == &State().ApplicationInfo && fieldID == FieldID(HOST_FIELD_SOURCE_DIR)) {
+        return NewStringUTF(State().PackageCodePath.c_str());
+    }
+    return nullptr;
+}
+
+jint _JNIEnv::GetIntField(jobject obj, jfieldID fieldID) {
+    return 0;
+}
+
+jobject _JNIEnv::GetStaticObjectField(jclass clazz, jfieldID fieldID) {
+    return nullptr;
+}
+
+jint _JNIEnv::GetStaticIntField(jclass clazz, jfieldID fieldID) {
+    return 0;
+}
+
+jstring _JNIEnv::NewStringUTF(const char* bytes) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    const std::string& interned = *State().Strings.insert(bytes).first;
+    return reinterpret_cast<jstring>(const_cast<std::string*>(&interned));
+}
+
+const char* _JNIEnv::GetStringUTFChars(jstring string, jboolean* isCopy) {
+    if (isCopy != nullptr) {
+        *isCopy = JNI_FALSE;
+    }
+    return string != nullptr ? reinterpret_cast<std::string*>(string)->c_str() : nullptr;
+}
+
+void _JNIEnv::ReleaseStringUTFChars(jstring string, const char* utf) {}
+
+jobject _JNIEnv::NewGlobalRef(jobject obj) {
+    return obj;
+}
+
+void _JNIEnv::DeleteGlobalRef(jobject globalRef) {}
+
+void _JNIEnv::DeleteLocalRef(jobject localRef) {}
+
+jthrowable _JNIEnv::ExceptionOccurred() {
+    return nullptr;
+}
+
+void _JNIEnv::ExceptionDescribe() {}
+
+void _JNIEnv::ExceptionClear() {}
+
+//==============================================================================
+// _JavaVM
+//==============================================================================
+
+jint _JavaVM::AttachCurrentThread(_JNIEnv** env, void* args) {
+    *env = &State().Env;
+    return JNI_OK;
+}
+
+jint _JavaVM::DetachCurrentThread() {
+    return JNI_OK;
+}
+
+jint _JavaVM::GetEnv(void** env, jint version) {
+    *env = &State().Env;
+    return JNI_OK;
+}
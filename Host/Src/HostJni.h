@@ -0,0 +1,33 @@
+/************************************************************************************
+
+Filename    :   HostJni.h
+Content     :   Stand-in Java VM for host builds
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <jni.h>
+
+namespace OVRFW {
+
+//==============================================================
+// ovrHostJni
+// There is no Java on the host. The activity answers getPackageName(), getPackageCodePath() and
+// the package manager's getApplicationInfo(), which is all the file system needs to open "apk://"
+// URIs from a zip; every package, the system activities with the fonts included, is installed at
+// the package code path. Every other class and method is missing, so callers take the paths they
+// take for a missing class on the device.
+class ovrHostJni {
+   public:
+    static void SetPackage(const char* packageName, const char* packageCodePath);
+
+    static JavaVM* GetVm();
+    static jobject GetActivity();
+};
+
+} // namespace OVRFW
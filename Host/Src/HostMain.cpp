@@ -0,0 +1,80 @@
+/************************************************************************************
+
+Filename    :   HostMain.cpp
+Content     :   Runs the app's android_main() on the host for a number of frames
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostAndroid.h"
+#include "HostApp.h"
+#include "HostJni.h"
+#include "HostVrApi.h"
+#include "NullGl.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace OVRFW;
+
+// The app's frame timings are logged when it shuts down, after the last frame; the VrApi and GL
+// stand-ins' counters are printed here.
+int main(int argc, char* argv[]) {
+    int frames = 600;
+    const char* apk = HOST_APK_PATH;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--refresh") == 0 && i + 1 < argc) {
+            ovrHostVrApi::SetRefreshRate(static_cast<float>(atof(argv[++i])));
+        } else if (strcmp(argv[i], "--no-vsync") == 0) {
+            ovrHostVrApi::SetWaitForVsync(false);
+        } else if (strcmp(argv[i], "--apk") == 0 && i + 1 < argc) {
+            apk = argv[++i];
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            ovrHostAndroid::SetLogPriority(ANDROID_LOG_VERBOSE);
+        } else {
+            fprintf(
+                stderr,
+                "usage: %s [--frames N] [--refresh Hz] [--no-vsync] [--apk file.zip] "
+                "[--verbose]\n",
+                argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    ovrHostJni::SetPackage("cz.walle.wallevrcontroller2", apk);
+    ovrHostApp app;
+    app.ExitAfterFrames(frames);
+    app.Run();
+
+    const ovrHostVrApiStats vrapi = ovrHostVrApi::GetStats();
+    const ovrNullGlStats gl = ovrNullGl::GetStats();
+    printf(
+        "frames %llu, missed vsyncs %i, frame index regressions %i\n"
+        "input: %i enumerations, %i state and %i tracking queries\n"
+        "haptics: %i buffers (%i samples), %i simple, %i over the per-frame limit\n"
+        "gl: %lld draws, %lld buffer stores, %lld KiB buffers, %lld KiB textures\n",
+        static_cast<unsigned long long>(vrapi.SubmittedFrames),
+        vrapi.MissedVsyncs,
+        vrapi.FrameIndexRegressions,
+        vrapi.EnumerateCalls,
+        vrapi.InputStateCalls,
+        vrapi.InputTrackingCalls,
+        vrapi.HapticBufferCalls,
+        vrapi.HapticSamples,
+        vrapi.HapticSimpleCalls,
+        vrapi.HapticCallsPerFrameExceeded,
+        static_cast<long long>(gl.DrawCalls),
+        static_cast<long long>(gl.BufferDataCalls),
+        static_cast<long long>(gl.BufferBytes / 1024),
+        static_cast<long long>(gl.TextureBytes / 1024));
+    // a frame whose index or display time doesn't advance would be shown out of order on device
+    const bool ok =
+        vrapi.SubmittedFrames >= static_cast<uint64_t>(frames) && vrapi.FrameIndexRegressions == 0;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
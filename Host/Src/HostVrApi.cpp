@@ -0,0 +1,646 @@
+/************************************************************************************
+
+Filename    :   HostVrApi.cpp
+Content     :   Stand-in VrApi for host builds, driven by synthetic or scripted tracking
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostVrApi.h"
+
+#include "VrApi_Helpers.h"
+#include "Misc/Log.h"
+
+#include <GLES3/gl3.h>
+
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct ovrMobile {
+    int Unused;
+};
+
+struct ovrTextureSwapChain {
+    static const int MAX_LENGTH = 3;
+    int Length;
+    GLuint Textures[MAX_LENGTH];
+};
+
+namespace OVRFW {
+
+namespace {
+
+const ovrDeviceID REMOTE_DEVICE_IDS[2] = {0x100, 0x101};
+const int HAPTIC_SAMPLES_MAX = 1024;
+const uint32_t HAPTIC_SAMPLE_DURATION_MS = 2;
+const float EYE_FOV_DEGREES = 90.0f;
+const float INTERPUPILLARY_DISTANCE = 0.063f;
+const int EYE_TEXTURE_SIZE = 1024;
+
+ovrQuatf AxisAngle(const float x, const float y, const float z, const float radians) {
+    const float s = sinf(radians * 0.5f);
+    ovrQuatf q = {x * s, y * s, z * s, cosf(radians * 0.5f)};
+    return q;
+}
+
+ovrQuatf Multiply(const ovrQuatf& a, const ovrQuatf& b) {
+    ovrQuatf q;
+    q.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+    q.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+    q.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
+    q.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+    return q;
+}
+
+struct ovrHostVrApiState {
+    std::mutex Mutex;
+    float RefreshRate = 72.0f;
+    bool WaitForVsync = true;
+    int RemoteCount = 2;
+    ovrHostTrackingSource Source = ovrHostVrApi::SyntheticTracking;
+
+    bool Initialized = false;
+    ovrMobile Mobile = {};
+    bool InVrMode = false;
+    double StartTime = 0.0; // vsync 0
+    int64_t LastReleaseVsync = 0;
+    int64_t LastDisplayVsync = 0;
+    // the latest frame index a display time was predicted for, and its vsync
+    long long LastPredictedIndex = 0;
+    int64_t LastPredictedVsync = 0;
+    std::deque<ovrEventType> Events;
+    ovrTrackingSpace TrackingSpace = VRAPI_TRACKING_SPACE_LOCAL;
+    int HapticCallsThisFrame[2] = {};
+
+    ovrHostVrApiStats Stats;
+
+    double Period() const {
+        return 1.0 / RefreshRate;
+    }
+    int64_t VsyncAt(const double time) const {
+        return static_cast<int64_t>(floor((time - StartTime) / Period()));
+    }
+    int RemoteIndex(const ovrDeviceID deviceID) const {
+        for (int i = 0; i < RemoteCount; i++) {
+            if (REMOTE_DEVICE_IDS[i] == deviceID) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+ovrHostVrApiState& State() {
+    static ovrHostVrApiState state;
+    return state;
+}
+
+double Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+ovrHostTracking TrackingAt(ovrHostVrApiState& state, const double time) {
+    ovrHostTracking tracking;
+    state.Source(time, tracking);
+    return tracking;
+}
+
+} // namespace
+
+//==============================
+// ovrHostVrApi::SetRefreshRate
+void ovrHostVrApi::SetRefreshRate(const float refreshRate) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().RefreshRate = refreshRate;
+}
+
+//==============================
+// ovrHostVrApi::GetRefreshRate
+float ovrHostVrApi::GetRefreshRate() {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    return State().RefreshRate;
+}
+
+//==============================
+// ovrHostVrApi::SetWaitForVsync
+void ovrHostVrApi::SetWaitForVsync(const bool wait) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().WaitForVsync = wait;
+}
+
+//==============================
+// ovrHostVrApi::SetTrackingSource
+void ovrHostVrApi::SetTrackingSource(ovrHostTrackingSource source) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Source = source ? source : ovrHostTrackingSource(SyntheticTracking);
+}
+
+//==============================
+// ovrHostVrApi::SetRemoteCount
+void ovrHostVrApi::SetRemoteCount(const int count) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().RemoteCount = count < 0 ? 0 : (count > 2 ? 2 : count);
+}
+
+//==============================
+// ovrHostVrApi::SyntheticTracking
+void ovrHostVrApi::SyntheticTracking(const double timeInSeconds, ovrHostTracking& tracking) {
+    const float t = static_cast<float>(timeInSeconds);
+
+    // looking around slowly at standing height
+    tracking.HeadPose.Orientation = Multiply(
+        AxisAngle(0.0f, 1.0f, 0.0f, 0.5f * sinf(t * 0.4f)),
+        AxisAngle(1.0f, 0.0f, 0.0f, 0.2f * sinf(t * 0.3f)));
+    tracking.HeadPose.Position = {0.0f, 1.6f, 0.0f};
+
+    for (int hand = 0; hand < 2; hand++) {
+        ovrHostRemote& remote = tracking.Remotes[hand];
+        const float side = hand == 0 ? -1.0f : 1.0f;
+        const float phase = t * 1.5f + hand * 1.7f;
+        remote.Connected = true;
+        remote.Pose.Orientation = Multiply(
+            AxisAngle(0.0f, 1.0f, 0.0f, 0.4f * sinf(phase)),
+            AxisAngle(1.0f, 0.0f, 0.0f, 0.3f * cosf(phase * 0.7f)));
+        remote.Pose.Position = {
+            side * 0.25f + 0.1f * cosf(phase), 1.2f + 0.1f * sinf(phase), -0.35f};
+
+        // the index trigger cycles every two seconds, a face button every three
+        remote.IndexTrigger = 0.5f + 0.5f * sinf(t * 3.14159265f + hand);
+        remote.GripTrigger = 0.5f + 0.5f * cosf(t * 1.3f + hand);
+        remote.Joystick = {0.8f * sinf(t * 0.9f + hand), 0.8f * cosf(t * 0.7f + hand)};
+        remote.Buttons = 0;
+        remote.Touches = ovrTouch_Joystick;
+        if (remote.IndexTrigger > 0.5f) {
+            remote.Buttons |= ovrButton_Trigger;
+            remote.Touches |= ovrTouch_IndexTrigger;
+        }
+        if (remote.GripTrigger > 0.5f) {
+            remote.Buttons |= ovrButton_GripTrigger;
+        }
+        if (fmodf(t + hand, 3.0f) < 0.5f) {
+            remote.Buttons |= hand == 0 ? ovrButton_X : ovrButton_A;
+        }
+    }
+}
+
+//==============================
+// ovrHostVrApi::GetRemoteDeviceID
+ovrDeviceID ovrHostVrApi::GetRemoteDeviceID(const int hand) {
+    return REMOTE_DEVICE_IDS[hand & 1];
+}
+
+//==============================
+// ovrHostVrApi::GetStats
+ovrHostVrApiStats ovrHostVrApi::GetStats() {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    return State().Stats;
+}
+
+//==============================
+// ovrHostVrApi::ResetStats
+void ovrHostVrApi::ResetStats() {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats = ovrHostVrApiStats();
+}
+
+} // namespace OVRFW
+
+using namespace OVRFW;
+
+//==============================================================================
+// vrapi_* stand-ins
+//==============================================================================
+
+extern "C" {
+
+const char* vrapi_GetVersionString() {
+    return "host";
+}
+
+double vrapi_GetTimeInSeconds() {
+    return Now();
+}
+
+ovrInitializeStatus vrapi_Initialize(const ovrInitParms* initParms) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Initialized = true;
+    return VRAPI_INITIALIZE_SUCCESS;
+}
+
+void vrapi_Shutdown() {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Initialized = false;
+}
+
+void vrapi_SetPropertyInt(const ovrJava* java, const ovrProperty propType, const int intVal) {}
+
+void vrapi_SetPropertyFloat(const ovrJava* java, const ovrProperty propType, const float floatVal) {
+}
+
+bool vrapi_GetPropertyInt(const ovrJava* java, const ovrProperty propType, int* intVal) {
+    if (propType == VRAPI_ACTIVE_INPUT_DEVICE_ID) {
+        *intVal = static_cast<int>(REMOTE_DEVICE_IDS[1]);
+        return true;
+    }
+    return false;
+}
+
+int vrapi_GetSystemPropertyInt(const ovrJava* java, const ovrSystemProperty propType) {
+    switch (propType) {
+        case VRAPI_SYS_PROP_DEVICE_TYPE:
+            return VRAPI_DEVICE_TYPE_OCULUSQUEST2;
+        case VRAPI_SYS_PROP_SUGGESTED_EYE_TEXTURE_WIDTH:
+        case VRAPI_SYS_PROP_SUGGESTED_EYE_TEXTURE_HEIGHT:
+            return EYE_TEXTURE_SIZE;
+        case VRAPI_SYS_PROP_DISPLAY_REFRESH_RATE:
+            return static_cast<int>(ovrHostVrApi::GetRefreshRate());
+        case VRAPI_SYS_PROP_DOMINANT_HAND:
+            return VRAPI_HAND_RIGHT;
+        case VRAPI_SYS_PROP_HAS_ORIENTATION_TRACKING:
+        case VRAPI_SYS_PROP_HAS_POSITION_TRACKING:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+float vrapi_GetSystemPropertyFloat(const ovrJava* java, const ovrSystemProperty propType) {
+    switch (propType) {
+        case VRAPI_SYS_PROP_SUGGESTED_EYE_FOV_DEGREES_X:
+        case VRAPI_SYS_PROP_SUGGESTED_EYE_FOV_DEGREES_Y:
+            return EYE_FOV_DEGREES;
+        case VRAPI_SYS_PROP_DISPLAY_REFRESH_RATE:
+            return ovrHostVrApi::GetRefreshRate();
+        default:
+            return 0.0f;
+    }
+}
+
+int vrapi_GetSystemStatusInt(const ovrJava* java, const ovrSystemStatus statusType) {
+    return statusType == VRAPI_SYS_STATUS_MOUNTED ? 1 : 0;
+}
+
+float vrapi_GetSystemStatusFloat(const ovrJava* java, const ovrSystemStatus statusType) {
+    return 0.0f;
+}
+
+ovrMobile* vrapi_EnterVrMode(const ovrModeParms* parms) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    state.InVrMode = true;
+    state.StartTime = Now();
+    state.LastReleaseVsync = 0;
+    state.LastDisplayVsync = 0;
+    state.LastPredictedIndex = 0;
+    state.LastPredictedVsync = 0;
+    state.Events.push_back(VRAPI_EVENT_VISIBILITY_GAINED);
+    state.Events.push_back(VRAPI_EVENT_FOCUS_GAINED);
+    state.Stats.EnterVrModeCalls++;
+    return &state.Mobile;
+}
+
+void vrapi_LeaveVrMode(ovrMobile* ovr) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    state.InVrMode = false;
+    state.Events.push_back(VRAPI_EVENT_FOCUS_LOST);
+    state.Events.push_back(VRAPI_EVENT_VISIBILITY_LOST);
+}
+
+ovrResult vrapi_PollEvent(ovrEventHeader* event) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    if (state.Events.empty()) {
+        event->EventType = VRAPI_EVENT_NONE;
+        return ovrSuccess_EventUnavailable;
+    }
+    event->EventType = state.Events.front();
+    state.Events.pop_front();
+    return ovrSuccess;
+}
+
+// A frame is shown two vsyncs out, or on the vsync after the last submitted one if the app is
+// running ahead, plus one vsync for each frame between the last submitted one and this one.
+// Frames predicted but not submitted yet keep the vsyncs they were given: time moving on between
+// two predictions must not let a later frame land on the vsync promised to an earlier one.
+double vrapi_GetPredictedDisplayTime(ovrMobile* ovr, long long frameIndex) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    const int64_t nowVsync = state.VsyncAt(Now());
+    int64_t vsync = std::max(nowVsync + 2, state.LastDisplayVsync + 1);
+    const long long ahead = frameIndex - static_cast<long long>(state.Stats.LastFrameIndex) - 1;
+    if (state.Stats.SubmittedFrames > 0 && ahead > 0) {
+        vsync += ahead;
+    }
+    if (frameIndex > state.LastPredictedIndex) {
+        vsync = std::max<int64_t>(
+            vsync, state.LastPredictedVsync + (frameIndex - state.LastPredictedIndex));
+        state.LastPredictedIndex = frameIndex;
+        state.LastPredictedVsync = vsync;
+    }
+    return state.StartTime + vsync * state.Period();
+}
+
+ovrTracking2 vrapi_GetPredictedTracking2(ovrMobile* ovr, double absTimeInSeconds) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    const ovrHostTracking tracking = TrackingAt(state, absTimeInSeconds);
+
+    ovrTracking2 result = {};
+    result.Status = VRAPI_TRACKING_STATUS_ORIENTATION_TRACKED |
+        VRAPI_TRACKING_STATUS_POSITION_TRACKED | VRAPI_TRACKING_STATUS_ORIENTATION_VALID |
+        VRAPI_TRACKING_STATUS_POSITION_VALID | VRAPI_TRACKING_STATUS_HMD_CONNECTED;
+    result.HeadPose.Pose = tracking.HeadPose;
+    result.HeadPose.TimeInSeconds = absTimeInSeconds;
+    result.HeadPose.PredictionInSeconds = absTimeInSeconds - Now();
+
+    const ovrMatrix4f head = vrapi_GetTransformFromPose(&tracking.HeadPose);
+    for (int eye = 0; eye < VRAPI_EYE_COUNT; eye++) {
+        const float offset = (eye == 0 ? -0.5f : 0.5f) * INTERPUPILLARY_DISTANCE;
+        const ovrMatrix4f eyeOffset = ovrMatrix4f_CreateTranslation(offset, 0.0f, 0.0f);
+        const ovrMatrix4f eyeTransform = ovrMatrix4f_Multiply(&head, &eyeOffset);
+        result.Eye[eye].ViewMatrix = ovrMatrix4f_Inverse(&eyeTransform);
+        result.Eye[eye].ProjectionMatrix =
+            ovrMatrix4f_CreateProjectionFov(EYE_FOV_DEGREES, EYE_FOV_DEGREES, 0.0f, 0.0f, 0.1f, 0.0f);
+    }
+    return result;
+}
+
+ovrTracking vrapi_GetPredictedTracking(ovrMobile* ovr, double absTimeInSeconds) {
+    const ovrTracking2 tracking2 = vrapi_GetPredictedTracking2(ovr, absTimeInSeconds);
+    ovrTracking tracking = {};
+    tracking.Status = tracking2.Status;
+    tracking.HeadPose = tracking2.HeadPose;
+    return tracking;
+}
+
+ovrTrackingSpace vrapi_GetTrackingSpace(ovrMobile* ovr) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    return State().TrackingSpace;
+}
+
+ovrResult vrapi_SetTrackingSpace(ovrMobile* ovr, ovrTrackingSpace whichSpace) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().TrackingSpace = whichSpace;
+    return ovrSuccess;
+}
+
+ovrPosef vrapi_LocateTrackingSpace(ovrMobile* ovr, ovrTrackingSpace target) {
+    ovrPosef pose = {};
+    pose.Orientation.w = 1.0f;
+    if (target == VRAPI_TRACKING_SPACE_LOCAL_FLOOR || target == VRAPI_TRACKING_SPACE_STAGE) {
+        pose.Position.y = -1.6f;
+    }
+    return pose;
+}
+
+ovrResult vrapi_SetClockLevels(ovrMobile* ovr, const int32_t cpuLevel, const int32_t gpuLevel) {
+    return ovrSuccess;
+}
+
+ovrResult vrapi_SetPerfThread(ovrMobile* ovr, const ovrPerfThreadType type, const uint32_t threadId) {
+    return ovrSuccess;
+}
+
+ovrResult vrapi_SetDisplayRefreshRate(ovrMobile* ovr, const float refreshRate) {
+    ovrHostVrApi::SetRefreshRate(refreshRate);
+    return ovrSuccess;
+}
+
+ovrResult vrapi_SetClientColorDesc(ovrMobile* ovr, const ovrHmdColorDesc* colorDesc) {
+    return ovrSuccess;
+}
+
+ovrTextureSwapChain* vrapi_CreateTextureSwapChain3(
+    ovrTextureType type,
+    int64_t format,
+    int width,
+    int height,
+    int levels,
+    int bufferCount) {
+    ovrTextureSwapChain* chain = new ovrTextureSwapChain;
+    chain->Length = std::min(bufferCount, static_cast<int>(ovrTextureSwapChain::MAX_LENGTH));
+    glGenTextures(chain->Length, chain->Textures);
+    return chain;
+}
+
+void vrapi_DestroyTextureSwapChain(ovrTextureSwapChain* chain) {
+    if (chain != nullptr) {
+        glDeleteTextures(chain->Length, chain->Textures);
+        delete chain;
+    }
+}
+
+int vrapi_GetTextureSwapChainLength(ovrTextureSwapChain* chain) {
+    return chain != nullptr ? chain->Length : 0;
+}
+
+unsigned int vrapi_GetTextureSwapChainHandle(ovrTextureSwapChain* chain, int index) {
+    return (chain != nullptr && index >= 0 && index < chain->Length) ? chain->Textures[index] : 0;
+}
+
+// Paces like the device: returns halfway through the vsync interval at least SwapInterval
+// vsyncs after the previous release.
+ovrResult vrapi_SubmitFrame2(ovrMobile* ovr, const ovrSubmitFrameDescription2* frameDescription) {
+    ovrHostVrApiState& state = State();
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    ovrHostVrApiStats& stats = state.Stats;
+
+    if (stats.SubmittedFrames > 0 &&
+        (frameDescription->FrameIndex <= stats.LastFrameIndex ||
+         frameDescription->DisplayTime <= stats.LastDisplayTime)) {
+        stats.FrameIndexRegressions++;
+    }
+    stats.SubmittedFrames++;
+    stats.LastFrameIndex = frameDescription->FrameIndex;
+    stats.LastDisplayTime = frameDescription->DisplayTime;
+    state.LastDisplayVsync = std::max(
+        state.LastDisplayVsync,
+        static_cast<int64_t>(
+            std::llround((frameDescription->DisplayTime - state.StartTime) / state.Period())));
+    state.HapticCallsThisFrame[0] = 0;
+    state.HapticCallsThisFrame[1] = 0;
+
+    const double period = state.Period();
+    const int64_t swapInterval = std::max<int64_t>(1, frameDescription->SwapInterval);
+    const double now = Now();
+    const int64_t nowVsync = state.VsyncAt(now - 0.5 * period);
+    int64_t releaseVsync = std::max(state.LastReleaseVsync + swapInterval, nowVsync + 1);
+    if (state.LastReleaseVsync > 0 && releaseVsync > state.LastReleaseVsync + swapInterval) {
+        stats.MissedVsyncs += static_cast<int>(releaseVsync - state.LastReleaseVsync - swapInterval);
+    }
+    state.LastReleaseVsync = releaseVsync;
+    const double releaseTime = state.StartTime + (releaseVsync + 0.5) * period;
+    const bool wait = state.WaitForVsync;
+    lock.unlock();
+
+    if (wait && releaseTime > now) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(releaseTime - now));
+    }
+    return ovrSuccess;
+}
+
+ovrResult vrapi_EnumerateInputDevices(
+    ovrMobile* ovr,
+    const uint32_t index,
+    ovrInputCapabilityHeader* capsHeader) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    state.Stats.EnumerateCalls++;
+    if (index >= static_cast<uint32_t>(state.RemoteCount)) {
+        return ovrError_InvalidParameter;
+    }
+    capsHeader->Type = ovrControllerType_TrackedRemote;
+    capsHeader->DeviceID = REMOTE_DEVICE_IDS[index];
+    return ovrSuccess;
+}
+
+ovrResult vrapi_GetInputDeviceCapabilities(ovrMobile* ovr, ovrInputCapabilityHeader* capsHeader) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    state.Stats.CapabilityCalls++;
+    const int hand = state.RemoteIndex(capsHeader->DeviceID);
+    if (hand < 0 || capsHeader->Type != ovrControllerType_TrackedRemote) {
+        return ovrError_InvalidParameter;
+    }
+    ovrInputTrackedRemoteCapabilities* caps =
+        reinterpret_cast<ovrInputTrackedRemoteCapabilities*>(capsHeader);
+    caps->ControllerCapabilities = ovrControllerCaps_HasOrientationTracking |
+        ovrControllerCaps_HasPositionTracking |
+        (hand == 0 ? ovrControllerCaps_LeftHand : ovrControllerCaps_RightHand) |
+        ovrControllerCaps_ModelOculusTouch | ovrControllerCaps_HasJoystick |
+        ovrControllerCaps_HasAnalogIndexTrigger | ovrControllerCaps_HasAnalogGripTrigger |
+        ovrControllerCaps_HasSimpleHapticVibration | ovrControllerCaps_HasBufferedHapticVibration;
+    caps->ButtonCapabilities = ovrButton_A | ovrButton_B | ovrButton_X | ovrButton_Y |
+        ovrButton_Enter | ovrButton_Joystick | ovrButton_GripTrigger | ovrButton_Trigger;
+    caps->TrackpadMaxX = 0;
+    caps->TrackpadMaxY = 0;
+    caps->TrackpadSizeX = 0.0f;
+    caps->TrackpadSizeY = 0.0f;
+    caps->HapticSamplesMax = HAPTIC_SAMPLES_MAX;
+    caps->HapticSampleDurationMS = HAPTIC_SAMPLE_DURATION_MS;
+    caps->TouchCapabilities = ovrTouch_Joystick | ovrTouch_IndexTrigger;
+    return ovrSuccess;
+}
+
+ovrResult vrapi_GetCurrentInputState(
+    ovrMobile* ovr,
+    const ovrDeviceID deviceID,
+    ovrInputStateHeader* inputState) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    state.Stats.InputStateCalls++;
+    const int hand = state.RemoteIndex(deviceID);
+    if (hand < 0 || inputState->ControllerType != ovrControllerType_TrackedRemote) {
+        return ovrError_InvalidParameter;
+    }
+    const double now = Now();
+    const ovrHostRemote remote = TrackingAt(state, now).Remotes[hand];
+    if (!remote.Connected) {
+        return ovrError_DeviceUnavailable;
+    }
+    ovrInputStateTrackedRemote* remoteState =
+        reinterpret_cast<ovrInputStateTrackedRemote*>(inputState);
+    remoteState->Header.TimeInSeconds = now;
+    remoteState->Buttons = remote.Buttons;
+    remoteState->TrackpadStatus = 0;
+    remoteState->TrackpadPosition = {0.0f, 0.0f};
+    remoteState->BatteryPercentRemaining = 100;
+    remoteState->RecenterCount = 0;
+    remoteState->IndexTrigger = remote.IndexTrigger;
+    remoteState->GripTrigger = remote.GripTrigger;
+    remoteState->Touches = remote.Touches;
+    remoteState->Joystick = remote.Joystick;
+    remoteState->JoystickNoDeadZone = remote.Joystick;
+    return ovrSuccess;
+}
+
+ovrResult vrapi_GetInputTrackingState(
+    ovrMobile* ovr,
+    const ovrDeviceID deviceID,
+    const double absTimeInSeconds,
+    ovrTracking* tracking) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    state.Stats.InputTrackingCalls++;
+    const int hand = state.RemoteIndex(deviceID);
+    if (hand < 0) {
+        return ovrError_InvalidParameter;
+    }
+    const ovrHostRemote remote = TrackingAt(state, absTimeInSeconds).Remotes[hand];
+    if (!remote.Connected) {
+        return ovrError_DeviceUnavailable;
+    }
+    *tracking = {};
+    tracking->Status = VRAPI_TRACKING_STATUS_ORIENTATION_TRACKED |
+        VRAPI_TRACKING_STATUS_POSITION_TRACKED | VRAPI_TRACKING_STATUS_ORIENTATION_VALID |
+        VRAPI_TRACKING_STATUS_POSITION_VALID;
+    tracking->HeadPose.Pose = remote.Pose;
+    tracking->HeadPose.TimeInSeconds = absTimeInSeconds;
+    return ovrSuccess;
+}
+
+ovrResult
+vrapi_SetHapticVibrationSimple(ovrMobile* ovr, const ovrDeviceID deviceID, const float intensity) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    const int hand = state.RemoteIndex(deviceID);
+    if (hand < 0) {
+        return ovrError_InvalidParameter;
+    }
+    state.Stats.HapticSimpleCalls++;
+    if (++state.HapticCallsThisFrame[hand] > 1) {
+        state.Stats.HapticCallsPerFrameExceeded++;
+        return ovrError_InvalidOperation;
+    }
+    return ovrSuccess;
+}
+
+ovrResult vrapi_SetHapticVibrationBuffer(
+    ovrMobile* ovr,
+    const ovrDeviceID deviceID,
+    const ovrHapticBuffer* hapticBuffer) {
+    ovrHostVrApiState& state = State();
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    const int hand = state.RemoteIndex(deviceID);
+    if (hand < 0 || hapticBuffer->NumSamples > static_cast<uint32_t>(HAPTIC_SAMPLES_MAX)) {
+        return ovrError_InvalidParameter;
+    }
+    state.Stats.HapticBufferCalls++;
+    state.Stats.HapticSamples += hapticBuffer->NumSamples;
+    if (++state.HapticCallsThisFrame[hand] > 1) {
+        state.Stats.HapticCallsPerFrameExceeded++;
+        return ovrError_InvalidOperation;
+    }
+    return ovrSuccess;
+}
+
+// No hand tracking on the host; the app falls back to the controllers.
+ovrResult vrapi_GetHandPose(
+    ovrMobile* ovr,
+    const ovrDeviceID deviceID,
+    const double absTimeInSeconds,
+    ovrHandPoseHeader* header) {
+    return ovrError_NotImplemented;
+}
+
+ovrResult vrapi_GetHandSkeleton(
+    ovrMobile* ovr,
+    const ovrHandedness handedness,
+    ovrHandSkeletonHeader* header) {
+    return ovrError_NotImplemented;
+}
+
+ovrResult
+vrapi_GetHandMesh(ovrMobile* ovr, const ovrHandedness handedness, ovrHandMeshHeader* header) {
+    return ovrError_NotImplemented;
+}
+
+} // extern "C"
@@ -0,0 +1,88 @@
+/************************************************************************************
+
+Filename    :   HostVrApi.h
+Content     :   Stand-in VrApi for host builds, driven by synthetic or scripted tracking
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include "VrApi.h"
+#include "VrApi_Input.h"
+
+#include <cstdint>
+#include <functional>
+
+namespace OVRFW {
+
+//==============================================================
+// ovrHostRemote
+// One tracked remote as the stand-in reports it.
+struct ovrHostRemote {
+    bool Connected = true;
+    ovrPosef Pose;
+    uint32_t Buttons = 0;
+    uint32_t Touches = 0;
+    float IndexTrigger = 0.0f;
+    float GripTrigger = 0.0f;
+    ovrVector2f Joystick = {0.0f, 0.0f};
+};
+
+//==============================================================
+// ovrHostTracking
+// What the stand-in reports for a given time: the head and the left and right remotes.
+struct ovrHostTracking {
+    ovrPosef HeadPose;
+    ovrHostRemote Remotes[2];
+};
+
+typedef std::function<void(const double timeInSeconds, ovrHostTracking& tracking)>
+    ovrHostTrackingSource;
+
+//==============================================================
+// ovrHostVrApiStats
+struct ovrHostVrApiStats {
+    uint64_t SubmittedFrames = 0;
+    uint64_t LastFrameIndex = 0;
+    double LastDisplayTime = 0.0;
+    int FrameIndexRegressions = 0; // submits whose index or display time did not advance
+    int MissedVsyncs = 0; // vsyncs that passed without a new frame
+    int EnterVrModeCalls = 0;
+    int EnumerateCalls = 0;
+    int CapabilityCalls = 0;
+    int InputStateCalls = 0;
+    int InputTrackingCalls = 0;
+    int HapticBufferCalls = 0;
+    int HapticSimpleCalls = 0;
+    int HapticSamples = 0; // samples handed to vrapi_SetHapticVibrationBuffer
+    int HapticCallsPerFrameExceeded = 0; // more than one haptic call per device between submits
+};
+
+//==============================================================
+// ovrHostVrApi
+// Configures the vrapi_* stand-ins. Tracking comes from a source function, by default the
+// synthetic one below: a head looking around slowly and two remotes moving in circles with
+// their triggers and buttons cycling. SubmitFrame2 paces like the device, releasing halfway
+// through the next display refresh, unless WaitForVsync is off.
+class ovrHostVrApi {
+   public:
+    static void SetRefreshRate(const float refreshRate);
+    static float GetRefreshRate();
+    static void SetWaitForVsync(const bool wait);
+    static void SetTrackingSource(ovrHostTrackingSource source);
+    static void SetRemoteCount(const int count); // 0 to 2, set before vrapi_EnterVrMode
+
+    static void SyntheticTracking(const double timeInSeconds, ovrHostTracking& tracking);
+
+    // The device ids the stand-in enumerates for the left and right remote.
+    static ovrDeviceID GetRemoteDeviceID(const int hand);
+
+    static ovrHostVrApiStats GetStats();
+    static void ResetStats();
+};
+
+} // namespace OVRFW
@@ -0,0 +1,901 @@
+/************************************************************************************
+
+Filename    :   NullGl.cpp
+Content     :   GLES3 and EGL entry points for host builds that record instead of drawing
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "NullGl.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl3ext.h>
+#include <GLES2/gl2ext.h>
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace OVRFW {
+
+namespace {
+
+struct ovrNullBuffer {
+    GLsizeiptr Size = 0;
+    GLenum Usage = 0;
+    bool HasStore = false;
+    std::vector<uint8_t> Mapped;
+};
+
+struct ovrNullGlState {
+    std::mutex Mutex;
+    std::atomic<GLuint> NextName{1};
+    ovrNullGlStats Stats;
+    std::unordered_map<GLuint, ovrNullBuffer> Buffers;
+    std::unordered_map<GLuint, GLint> LinkStatus;
+    uint32_t DriverVersion = 1;
+};
+
+ovrNullGlState& State() {
+    static ovrNullGlState state;
+    return state;
+}
+
+// bindings are per context, and every host thread has its own context
+struct ovrNullBindings {
+    GLuint ArrayBuffer = 0;
+    GLuint ElementArrayBuffer = 0;
+    GLuint UniformBuffer = 0;
+    GLuint Program = 0;
+};
+thread_local ovrNullBindings Bindings;
+
+thread_local EGLDisplay CurrentDisplay = EGL_NO_DISPLAY;
+thread_local EGLSurface CurrentDraw = EGL_NO_SURFACE;
+thread_local EGLSurface CurrentRead = EGL_NO_SURFACE;
+thread_local EGLContext CurrentContext = EGL_NO_CONTEXT;
+
+// the program binary is the magic, the driver version and the program name
+const uint32_t PROGRAM_BINARY_MAGIC = 0x4E554C4C;
+const GLint PROGRAM_BINARY_LENGTH = 3 * sizeof(uint32_t);
+
+GLuint* BoundBuffer(const GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:
+            return &Bindings.ArrayBuffer;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return &Bindings.ElementArrayBuffer;
+        case GL_UNIFORM_BUFFER:
+            return &Bindings.UniformBuffer;
+        default:
+            return nullptr;
+    }
+}
+
+void GenNames(GLsizei n, GLuint* names) {
+    for (GLsizei i = 0; i < n; i++) {
+        names[i] = State().NextName++;
+    }
+}
+
+void CountTextureUpload(const GLsizei bytes) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats.TextureUploads++;
+    State().Stats.TextureBytes += bytes;
+}
+
+GLsizei PixelBytes(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type) {
+    int components = 4;
+    switch (format) {
+        case GL_RED:
+        case GL_ALPHA:
+        case GL_LUMINANCE:
+            components = 1;
+            break;
+        case GL_RG:
+        case GL_LUMINANCE_ALPHA:
+            components = 2;
+            break;
+        case GL_RGB:
+            components = 3;
+            break;
+        default:
+            break;
+    }
+    const int componentBytes = (type == GL_FLOAT) ? 4 : ((type == GL_HALF_FLOAT) ? 2 : 1);
+    return width * height * depth * components * componentBytes;
+}
+
+} // namespace
+
+//==============================
+// ovrNullGl::GetStats
+ovrNullGlStats ovrNullGl::GetStats() {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    return State().Stats;
+}
+
+//==============================
+// ovrNullGl::ResetStats
+void ovrNullGl::ResetStats() {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats = ovrNullGlStats();
+}
+
+//==============================
+// ovrNullGl::GetBufferStore
+bool ovrNullGl::GetBufferStore(const GLuint buffer, GLsizeiptr& size, GLenum& usage) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    auto it = State().Buffers.find(buffer);
+    if (it == State().Buffers.end() || !it->second.HasStore) {
+        return false;
+    }
+    size = it->second.Size;
+    usage = it->second.Usage;
+    return true;
+}
+
+//==============================
+// ovrNullGl::SetDriverVersion
+void ovrNullGl::SetDriverVersion(const uint32_t version) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().DriverVersion = version;
+}
+
+} // namespace OVRFW
+
+using namespace OVRFW;
+
+//==============================================================================
+// GLES3
+//==============================================================================
+
+extern "C" {
+
+void glActiveTexture(GLenum texture) {}
+void glAttachShader(GLuint program, GLuint shader) {}
+void glBindAttribLocation(GLuint program, GLuint index, const GLchar* name) {}
+
+void glBindBuffer(GLenum target, GLuint buffer) {
+    GLuint* binding = BoundBuffer(target);
+    if (binding != nullptr) {
+        *binding = buffer;
+    }
+}
+
+void glBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    glBindBuffer(target, buffer);
+}
+
+void glBindFramebuffer(GLenum target, GLuint framebuffer) {}
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer) {}
+void glBindTexture(GLenum target, GLuint texture) {}
+void glBindVertexArray(GLuint array) {}
+void glBlendEquation(GLenum mode) {}
+void glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha) {}
+void glBlendFunc(GLenum sfactor, GLenum dfactor) {}
+void glBlendFuncSeparate(
+    GLenum sfactorRGB,
+    GLenum dfactorRGB,
+    GLenum sfactorAlpha,
+    GLenum dfactorAlpha) {}
+
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    GLuint* binding = BoundBuffer(target);
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    ovrNullGlStats& stats = State().Stats;
+    stats.BufferDataCalls++;
+    stats.BufferBytes += data != nullptr ? size : 0;
+    stats.StaticBufferStores += usage == GL_STATIC_DRAW ? 1 : 0;
+    if (binding != nullptr && *binding != 0) {
+        ovrNullBuffer& buffer = State().Buffers[*binding];
+        buffer.Size = size;
+        buffer.Usage = usage;
+        buffer.HasStore = true;
+    }
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats.BufferSubDataCalls++;
+    State().Stats.BufferBytes += size;
+}
+
+GLenum glCheckFramebufferStatus(GLenum target) {
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void glClear(GLbitfield mask) {}
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {}
+void glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {}
+
+void glCompileShader(GLuint shader) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats.ShaderCompiles++;
+}
+
+void glCompressedTexImage2D(
+    GLenum target,
+    GLint level,
+    GLenum internalformat,
+    GLsizei width,
+    GLsizei height,
+    GLint border,
+    GLsizei imageSize,
+    const void* data) {
+    CountTextureUpload(imageSize);
+}
+
+void glCompressedTexSubImage2D(
+    GLenum target,
+    GLint level,
+    GLint xoffset,
+    GLint yoffset,
+    GLsizei width,
+    GLsizei height,
+    GLenum format,
+    GLsizei imageSize,
+    const void* data) {
+    CountTextureUpload(imageSize);
+}
+
+void glCompressedTexSubImage3D(
+    GLenum target,
+    GLint level,
+    GLint xoffset,
+    GLint yoffset,
+    GLint zoffset,
+    GLsizei width,
+    GLsizei height,
+    GLsizei depth,
+    GLenum format,
+    GLsizei imageSize,
+    const void* data) {
+    CountTextureUpload(imageSize);
+}
+
+GLuint glCreateProgram(void) {
+    return State().NextName++;
+}
+
+GLuint glCreateShader(GLenum type) {
+    return State().NextName++;
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* buffers) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    for (GLsizei i = 0; i < n; i++) {
+        State().Buffers.erase(buffers[i]);
+    }
+}
+
+void glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) {}
+
+void glDeleteProgram(GLuint program) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().LinkStatus.erase(program);
+}
+
+void glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {}
+void glDeleteShader(GLuint shader) {}
+void glDeleteSync(GLsync sync) {}
+void glDeleteTextures(GLsizei n, const GLuint* textures) {}
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays) {}
+void glDepthFunc(GLenum func) {}
+void glDepthMask(GLboolean flag) {}
+void glDepthRangef(GLfloat n, GLfloat f) {}
+void glDisable(GLenum cap) {}
+void glDisableVertexAttribArray(GLuint index) {}
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats.DrawCalls++;
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats.DrawCalls++;
+    State().Stats.IndicesDrawn += count;
+}
+
+void glDrawElementsInstanced(
+    GLenum mode,
+    GLsizei count,
+    GLenum type,
+    const void* indices,
+    GLsizei instancecount) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats.DrawCalls++;
+    State().Stats.IndicesDrawn += static_cast<int64_t>(count) * instancecount;
+}
+
+void glEnable(GLenum cap) {}
+void glEnableVertexAttribArray(GLuint index) {}
+
+GLsync glFenceSync(GLenum condition, GLbitfield flags) {
+    return reinterpret_cast<GLsync>(static_cast<uintptr_t>(State().NextName++));
+}
+
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    return GL_ALREADY_SIGNALED;
+}
+
+void glFinish(void) {}
+void glFlush(void) {}
+void glFramebufferRenderbuffer(
+    GLenum target,
+    GLenum attachment,
+    GLenum renderbuffertarget,
+    GLuint renderbuffer) {}
+void glFramebufferTexture2D(
+    GLenum target,
+    GLenum attachment,
+    GLenum textarget,
+    GLuint texture,
+    GLint level) {}
+void glFramebufferTextureLayer(
+    GLenum target,
+    GLenum attachment,
+    GLuint texture,
+    GLint level,
+    GLint layer) {}
+void glFrontFace(GLenum mode) {}
+
+void glGenBuffers(GLsizei n, GLuint* buffers) {
+    GenNames(n, buffers);
+}
+
+void glGenFramebuffers(GLsizei n, GLuint* framebuffers) {
+    GenNames(n, framebuffers);
+}
+
+void glGenRenderbuffers(GLsizei n, GLuint* renderbuffers) {
+    GenNames(n, renderbuffers);
+}
+
+void glGenTextures(GLsizei n, GLuint* textures) {
+    GenNames(n, textures);
+}
+
+void glGenVertexArrays(GLsizei n, GLuint* arrays) {
+    GenNames(n, arrays);
+}
+
+void glGenerateMipmap(GLenum target) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats.GenerateMipmapCalls++;
+}
+
+GLenum glGetError(void) {
+    return GL_NO_ERROR;
+}
+
+void glGetFloatv(GLenum pname, GLfloat* data) {
+    *data = 0.0f;
+}
+
+void glGetIntegerv(GLenum pname, GLint* data) {
+    switch (pname) {
+        case GL_MAX_TEXTURE_SIZE:
+            *data = 4096;
+            break;
+        case GL_MAX_VERTEX_ATTRIBS:
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+            *data = 16;
+            break;
+        case GL_NUM_PROGRAM_BINARY_FORMATS:
+            *data = 1;
+            break;
+        case GL_PROGRAM_BINARY_FORMATS:
+            *data = ovrNullGl::PROGRAM_BINARY_FORMAT;
+            break;
+        default:
+            *data = 0;
+            break;
+    }
+}
+
+void glGetProgramBinary(
+    GLuint program,
+    GLsizei bufSize,
+    GLsizei* length,
+    GLenum* binaryFormat,
+    void* binary) {
+    if (bufSize < PROGRAM_BINARY_LENGTH) {
+        *length = 0;
+        return;
+    }
+    uint32_t words[3] = {PROGRAM_BINARY_MAGIC, 0, program};
+    {
+        std::lock_guard<std::mutex> lock(State().Mutex);
+        words[1] = State().DriverVersion;
+    }
+    memcpy(binary, words, sizeof(words));
+    *length = PROGRAM_BINARY_LENGTH;
+    *binaryFormat = ovrNullGl::PROGRAM_BINARY_FORMAT;
+}
+
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    if (length != nullptr) {
+        *length = 0;
+    }
+    if (bufSize > 0) {
+        infoLog[0] = '\0';
+    }
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+    switch (pname) {
+        case GL_LINK_STATUS: {
+            std::lock_guard<std::mutex> lock(State().Mutex);
+            auto it = State().LinkStatus.find(program);
+            *params = it != State().LinkStatus.end() ? it->second : GL_FALSE;
+            break;
+        }
+        case GL_PROGRAM_BINARY_LENGTH:
+            *params = PROGRAM_BINARY_LENGTH;
+            break;
+        case GL_COMPLETION_STATUS_KHR:
+            *params = GL_TRUE;
+            break;
+        default:
+            *params = 0;
+            break;
+    }
+}
+
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    glGetProgramInfoLog(shader, bufSize, length, infoLog);
+}
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    *params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+const GLubyte* glGetString(GLenum name) {
+    switch (name) {
+        case GL_VENDOR:
+            return reinterpret_cast<const GLubyte*>("host");
+        case GL_RENDERER:
+            return reinterpret_cast<const GLubyte*>("null");
+        case GL_VERSION:
+            return reinterpret_cast<const GLubyte*>("OpenGL ES 3.2 null");
+        case GL_SHADING_LANGUAGE_VERSION:
+            return reinterpret_cast<const GLubyte*>("OpenGL ES GLSL ES 3.20");
+        case GL_EXTENSIONS:
+            return reinterpret_cast<const GLubyte*>(
+                "GL_OVR_multiview2 GL_OVR_multiview_multisampled_render_to_texture "
+                "GL_EXT_multisampled_render_to_texture GL_EXT_texture_border_clamp "
+                "GL_EXT_texture_filter_anisotropic GL_KHR_parallel_shader_compile");
+        default:
+            return nullptr;
+    }
+}
+
+GLuint glGetUniformBlockIndex(GLuint program, const GLchar* uniformBlockName) {
+    return 0;
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar* name) {
+    return 0;
+}
+
+void glHint(GLenum target, GLenum mode) {}
+void glInvalidateFramebuffer(GLenum target, GLsizei numAttachments, const GLenum* attachments) {}
+void glLineWidth(GLfloat width) {}
+
+void glLinkProgram(GLuint program) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    State().Stats.ProgramLinks++;
+    State().LinkStatus[program] = GL_TRUE;
+}
+
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    GLuint* binding = BoundBuffer(target);
+    if (binding == nullptr || *binding == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    ovrNullBuffer& buffer = State().Buffers[*binding];
+    buffer.Mapped.resize(length);
+    State().Stats.BufferMapCalls++;
+    State().Stats.BufferBytes += length;
+    return buffer.Mapped.data();
+}
+
+void glPixelStorei(GLenum pname, GLint param) {}
+void glPolygonOffset(GLfloat factor, GLfloat units) {}
+
+void glProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) {
+    std::lock_guard<std::mutex> lock(State().Mutex);
+    uint32_t words[3] = {};
+    if (length == PROGRAM_BINARY_LENGTH) {
+        memcpy(words, binary, sizeof(words));
+    }
+    const bool accepted = binaryFormat == ovrNullGl::PROGRAM_BINARY_FORMAT &&
+        words[0] == PROGRAM_BINARY_MAGIC && words[1] == State().DriverVersion;
+    State().LinkStatus[program] = accepted ? GL_TRUE : GL_FALSE;
+    if (accepted) {
+        State().Stats.ProgramBinaryLoads++;
+    } else {
+        State().Stats.ProgramBinaryRejects++;
+    }
+}
+
+void glProgramParameteri(GLuint program, GLenum pname, GLint value) {}
+void glReadPixels(
+    GLint x,
+    GLint y,
+    GLsizei width,
+    GLsizei height,
+    GLenum format,
+    GLenum type,
+    void* pixels) {
+    memset(pixels, 0, PixelBytes(width, height, 1, format, type));
+}
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {}
+void glScissor(GLint x, GLint y, GLsizei width, GLsizei height) {}
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {
+}
+
+void glTexImage2D(
+    GLenum target,
+    GLint level,
+    GLint internalformat,
+    GLsizei width,
+    GLsizei height,
+    GLint border,
+    GLenum format,
+    GLenum type,
+    const void* pixels) {
+    if (pixels != nullptr) {
+        CountTextureUpload(PixelBytes(width, height, 1, format, type));
+    }
+}
+
+void glTexImage3D(
+    GLenum target,
+    GLint level,
+    GLint internalformat,
+    GLsizei width,
+    GLsizei height,
+    GLsizei depth,
+    GLint border,
+    GLenum format,
+    GLenum type,
+    const void* pixels) {
+    if (pixels != nullptr) {
+        CountTextureUpload(PixelBytes(width, height, depth, format, type));
+    }
+}
+
+void glTexParameterf(GLenum target, GLenum pname, GLfloat param) {}
+void glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params) {}
+void glTexParameteri(GLenum target, GLenum pname, GLint param) {}
+void glTexStorage2D(
+    GLenum target,
+    GLsizei levels,
+    GLenum internalformat,
+    GLsizei width,
+    GLsizei height) {}
+void glTexStorage3D(
+    GLenum target,
+    GLsizei levels,
+    GLenum internalformat,
+    GLsizei width,
+    GLsizei height,
+    GLsizei depth) {}
+
+void glTexSubImage2D(
+    GLenum target,
+    GLint level,
+    GLint xoffset,
+    GLint yoffset,
+    GLsizei width,
+    GLsizei height,
+    GLenum format,
+    GLenum type,
+    const void* pixels) {
+    CountTextureUpload(PixelBytes(width, height, 1, format, type));
+}
+
+void glTexSubImage3D(
+    GLenum target,
+    GLint level,
+    GLint xoffset,
+    GLint yoffset,
+    GLint zoffset,
+    GLsizei width,
+    GLsizei height,
+    GLsizei depth,
+    GLenum format,
+    GLenum type,
+    const void* pixels) {
+    CountTextureUpload(PixelBytes(width, height, depth, format, type));
+}
+
+void glUniform1f(GLint location, GLfloat v0) {}
+void glUniform1i(GLint location, GLint v0) {}
+void glUniform1iv(GLint location, GLsizei count, const GLint* value) {}
+void glUniform2fv(GLint location, GLsizei count, const GLfloat* value) {}
+void glUniform2iv(GLint location, GLsizei count, const GLint* value) {}
+void glUniform3fv(GLint location, GLsizei count, const GLfloat* value) {}
+void glUniform3iv(GLint location, GLsizei count, const GLint* value) {}
+void glUniform4fv(GLint location, GLsizei count, const GLfloat* value) {}
+void glUniform4iv(GLint location, GLsizei count, const GLint* value) {}
+void glUniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding) {}
+void glUniformMatrix4fv(
+    GLint location,
+    GLsizei count,
+    GLboolean transpose,
+    const GLfloat* value) {}
+
+GLboolean glUnmapBuffer(GLenum target) {
+    GLuint* binding = BoundBuffer(target);
+    if (binding != nullptr && *binding != 0) {
+        std::lock_guard<std::mutex> lock(State().Mutex);
+        State().Buffers[*binding].Mapped.clear();
+    }
+    return GL_TRUE;
+}
+
+void glUseProgram(GLuint program) {
+    Bindings.Program = program;
+}
+
+void glVertexAttribPointer(
+    GLuint index,
+    GLint size,
+    GLenum type,
+    GLboolean normalized,
+    GLsizei stride,
+    const void* pointer) {}
+void glVertexAttribIPointer(
+    GLuint index,
+    GLint size,
+    GLenum type,
+    GLsizei stride,
+    const void* pointer) {}
+void glVertexAttribDivisor(GLuint index, GLuint divisor) {}
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {}
+void glDrawBuffers(GLsizei n, const GLenum* bufs) {}
+
+} // extern "C"
+
+//==============================================================================
+// Extensions, only reachable through eglGetProcAddress
+//==============================================================================
+
+namespace {
+
+void GL_APIENTRY NullRenderbufferStorageMultisampleEXT(
+    GLenum target,
+    GLsizei samples,
+    GLenum internalformat,
+    GLsizei width,
+    GLsizei height) {}
+
+void GL_APIENTRY NullFramebufferTexture2DMultisampleEXT(
+    GLenum target,
+    GLenum attachment,
+    GLenum textarget,
+    GLuint texture,
+    GLint level,
+    GLsizei samples) {}
+
+void GL_APIENTRY NullFramebufferTextureMultiviewOVR(
+    GLenum target,
+    GLenum attachment,
+    GLuint texture,
+    GLint level,
+    GLint baseViewIndex,
+    GLsizei numViews) {}
+
+void GL_APIENTRY NullFramebufferTextureMultisampleMultiviewOVR(
+    GLenum target,
+    GLenum attachment,
+    GLuint texture,
+    GLint level,
+    GLsizei samples,
+    GLint baseViewIndex,
+    GLsizei numViews) {}
+
+void GL_APIENTRY NullMaxShaderCompilerThreadsKHR(GLuint count) {}
+
+EGLSyncKHR EGLAPIENTRY NullCreateSyncKHR(EGLDisplay dpy, EGLenum type, const EGLint* attrib_list) {
+    return reinterpret_cast<EGLSyncKHR>(static_cast<uintptr_t>(State().NextName++));
+}
+
+EGLBoolean EGLAPIENTRY NullDestroySyncKHR(EGLDisplay dpy, EGLSyncKHR sync) {
+    return EGL_TRUE;
+}
+
+EGLint EGLAPIENTRY
+NullClientWaitSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeKHR timeout) {
+    return EGL_CONDITION_SATISFIED_KHR;
+}
+
+EGLBoolean EGLAPIENTRY NullSignalSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLenum mode) {
+    return EGL_TRUE;
+}
+
+EGLBoolean EGLAPIENTRY
+NullGetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, EGLint* value) {
+    *value = attribute == EGL_SYNC_STATUS_KHR ? EGL_SIGNALED_KHR : 0;
+    return EGL_TRUE;
+}
+
+struct ovrNullProc {
+    const char* Name;
+    __eglMustCastToProperFunctionPointerType Proc;
+};
+
+#define NULL_PROC(name, proc) \
+    { name, reinterpret_cast<__eglMustCastToProperFunctionPointerType>(proc) }
+
+const ovrNullProc NullProcs[] = {
+    NULL_PROC("glRenderbufferStorageMultisampleEXT", NullRenderbufferStorageMultisampleEXT),
+    NULL_PROC("glFramebufferTexture2DMultisampleEXT", NullFramebufferTexture2DMultisampleEXT),
+    NULL_PROC("glFramebufferTextureMultiviewOVR", NullFramebufferTextureMultiviewOVR),
+    NULL_PROC(
+        "glFramebufferTextureMultisampleMultiviewOVR",
+        NullFramebufferTextureMultisampleMultiviewOVR),
+    NULL_PROC("glMaxShaderCompilerThreadsKHR", NullMaxShaderCompilerThreadsKHR),
+    NULL_PROC("glInvalidateFramebuffer", glInvalidateFramebuffer),
+    NULL_PROC("eglCreateSyncKHR", NullCreateSyncKHR),
+    NULL_PROC("eglDestroySyncKHR", NullDestroySyncKHR),
+    NULL_PROC("eglClientWaitSyncKHR", NullClientWaitSyncKHR),
+    NULL_PROC("eglSignalSyncKHR", NullSignalSyncKHR),
+    NULL_PROC("eglGetSyncAttribKHR", NullGetSyncAttribKHR),
+};
+
+#undef NULL_PROC
+
+// one display with one config that matches what the framework asks for
+EGLDisplay const NullDisplay = reinterpret_cast<EGLDisplay>(0x1);
+EGLConfig const NullConfig = reinterpret_cast<EGLConfig>(0x1);
+
+} // namespace
+
+//==============================================================================
+// EGL
+//==============================================================================
+
+extern "C" {
+
+EGLDisplay eglGetDisplay(EGLNativeDisplayType display_id) {
+    return NullDisplay;
+}
+
+EGLBoolean eglInitialize(EGLDisplay dpy, EGLint* major, EGLint* minor) {
+    if (major != nullptr) {
+        *major = 1;
+    }
+    if (minor != nullptr) {
+        *minor = 5;
+    }
+    return EGL_TRUE;
+}
+
+EGLBoolean eglTerminate(EGLDisplay dpy) {
+    return EGL_TRUE;
+}
+
+EGLint eglGetError(void) {
+    return EGL_SUCCESS;
+}
+
+const char* eglQueryString(EGLDisplay dpy, EGLint name) {
+    switch (name) {
+        case EGL_VENDOR:
+            return "host";
+        case EGL_VERSION:
+            return "1.5 null";
+        case EGL_CLIENT_APIS:
+            return "OpenGL_ES";
+        case EGL_EXTENSIONS:
+            return "EGL_KHR_fence_sync EGL_KHR_reusable_sync EGL_KHR_create_context";
+        default:
+            return "";
+    }
+}
+
+EGLBoolean eglGetConfigs(EGLDisplay dpy, EGLConfig* configs, EGLint config_size, EGLint* num_config) {
+    if (configs != nullptr && config_size > 0) {
+        configs[0] = NullConfig;
+    }
+    *num_config = 1;
+    return EGL_TRUE;
+}
+
+EGLBoolean eglChooseConfig(
+    EGLDisplay dpy,
+    const EGLint* attrib_list,
+    EGLConfig* configs,
+    EGLint config_size,
+    EGLint* num_config) {
+    return eglGetConfigs(dpy, configs, config_size, num_config);
+}
+
+EGLBoolean eglGetConfigAttrib(EGLDisplay dpy, EGLConfig config, EGLint attribute, EGLint* value) {
+    switch (attribute) {
+        case EGL_RED_SIZE:
+        case EGL_GREEN_SIZE:
+        case EGL_BLUE_SIZE:
+        case EGL_ALPHA_SIZE:
+            *value = 8;
+            break;
+        case EGL_RENDERABLE_TYPE:
+            *value = EGL_OPENGL_ES2_BIT | EGL_OPENGL_ES3_BIT_KHR;
+            break;
+        case EGL_SURFACE_TYPE:
+            *value = EGL_WINDOW_BIT | EGL_PBUFFER_BIT;
+            break;
+        case EGL_CONFIG_ID:
+            *value = 1;
+            break;
+        default:
+            *value = 0;
+            break;
+    }
+    return EGL_TRUE;
+}
+
+EGLContext
+eglCreateContext(EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint* attrib_list) {
+    return reinterpret_cast<EGLContext>(static_cast<uintptr_t>(State().NextName++));
+}
+
+EGLBoolean eglDestroyContext(EGLDisplay dpy, EGLContext ctx) {
+    return EGL_TRUE;
+}
+
+EGLBoolean eglQueryContext(EGLDisplay dpy, EGLContext ctx, EGLint attribute, EGLint* value) {
+    *value = attribute == EGL_CONFIG_ID ? 1 : 0;
+    return EGL_TRUE;
+}
+
+EGLSurface eglCreatePbufferSurface(EGLDisplay dpy, EGLConfig config, const EGLint* attrib_list) {
+    return reinterpret_cast<EGLSurface>(static_cast<uintptr_t>(State().NextName++));
+}
+
+EGLBoolean eglDestroySurface(EGLDisplay dpy, EGLSurface surface) {
+    return EGL_TRUE;
+}
+
+EGLBoolean eglMakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGLContext ctx) {
+    CurrentDisplay = ctx != EGL_NO_CONTEXT ? dpy : EGL_NO_DISPLAY;
+    CurrentDraw = draw;
+    CurrentRead = read;
+    CurrentContext = ctx;
+    return EGL_TRUE;
+}
+
+EGLDisplay eglGetCurrentDisplay(void) {
+    return CurrentDisplay;
+}
+
+EGLSurface eglGetCurrentSurface(EGLint readdraw) {
+    return readdraw == EGL_READ ? CurrentRead : CurrentDraw;
+}
+
+EGLContext eglGetCurrentContext(void) {
+    return CurrentContext;
+}
+
+__eglMustCastToProperFunctionPointerType eglGetProcAddress(const char* procname) {
+    for (const ovrNullProc& proc : NullProcs) {
+        if (strcmp(proc.Name, procname) == 0) {
+            return proc.Proc;
+        }
+    }
+    return nullptr;
+}
+
+} // extern "C"
@@ -0,0 +1,57 @@
+/************************************************************************************
+
+Filename    :   NullGl.h
+Content     :   GLES3 and EGL entry points for host builds that record instead of drawing
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <GLES3/gl3.h>
+
+#include <cstdint>
+
+namespace OVRFW {
+
+//==============================================================
+// ovrNullGlStats
+struct ovrNullGlStats {
+    int64_t DrawCalls = 0;
+    int64_t IndicesDrawn = 0;
+    int64_t BufferDataCalls = 0; // glBufferData, each one a new store
+    int64_t BufferSubDataCalls = 0;
+    int64_t BufferMapCalls = 0;
+    int64_t BufferBytes = 0; // bytes uploaded by any of the above
+    int64_t StaticBufferStores = 0; // glBufferData with GL_STATIC_DRAW
+    int64_t TextureUploads = 0; // glTexImage, glTexSubImage and their compressed versions
+    int64_t TextureBytes = 0;
+    int64_t GenerateMipmapCalls = 0;
+    int64_t ShaderCompiles = 0;
+    int64_t ProgramLinks = 0;
+    int64_t ProgramBinaryLoads = 0; // glProgramBinary calls that were accepted
+    int64_t ProgramBinaryRejects = 0;
+};
+
+//==============================================================
+// ovrNullGl
+// GL objects are only names and the few properties tests look at: buffers remember their size
+// and usage. Shaders compile, programs link, and program binaries round trip if they came from
+// glGetProgramBinary in this process or an earlier one.
+class ovrNullGl {
+   public:
+    static const GLenum PROGRAM_BINARY_FORMAT = 0x6E67; // no GL format uses this value
+
+    static ovrNullGlStats GetStats();
+    static void ResetStats();
+
+    // Returns false if the buffer has no store.
+    static bool GetBufferStore(const GLuint buffer, GLsizeiptr& size, GLenum& usage);
+    // Program binaries from another driver version are rejected, as drivers do after an update.
+    static void SetDriverVersion(const uint32_t version);
+};
+
+} // namespace OVRFW
@@ -0,0 +1,248 @@
+/************************************************************************************
+
+Filename    :   AsyncLoaderTest.cpp
+Content     :   Checks the budgeted upload queue and that model loads only upload on the GL thread
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostGui.h"
+#include "NullGl.h"
+
+#include "AsyncLoader.h"
+#include "Model/ModelFile.h"
+#include "Model/ModelUploads.h"
+#include "Render/GlProgram.h"
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+const char* const CONTROLLER_URI = "apk:///assets/oculusQuest_oculusTouch_Left.gltf.ovrscene";
+
+// An upload that takes numSteps calls, logging each one.
+ovrGpuUploadSteps MakeStubSteps(std::vector<std::string>& log, const char* name, int numSteps) {
+    std::shared_ptr<int> step = std::make_shared<int>(0);
+    return [&log, name, numSteps, step]() {
+        log.push_back(std::string(name) + std::to_string((*step)++));
+        return *step == numSteps;
+    };
+}
+
+bool HasPlaceholders(const ModelFile& model) {
+    for (const ModelTexture& texture : model.Textures) {
+        if (ModelGpuUploads::IsPlaceholder(texture.texid)) {
+            return true;
+        }
+    }
+    for (const Model& m : model.Models) {
+        for (const ModelSurface& surface : m.surfaces) {
+            if (ModelGpuUploads::IsPlaceholder(surface.surfaceDef.geo)) {
+                return true;
+            }
+            const ovrGraphicsCommand& gc = surface.surfaceDef.graphicsCommand;
+            for (int i = 0; i < ovrGraphicsCommand::MAX_TEXTURES; i++) {
+                if (ModelGpuUploads::IsPlaceholder(gc.Textures[i])) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Loads the controller through loader, running one upload step per Update() and checking each
+// step only creates one texture or one geometry. Returns the model and the number of steps.
+ModelFile* LoadStepByStep(
+    ovrAsyncLoader& loader,
+    ovrFileSys& fileSys,
+    const ModelGlPrograms& programs,
+    const char* cachePath,
+    int& numSteps) {
+    MaterialParms materialParms;
+    ModelFile* loaded = nullptr;
+    bool called = false;
+    ovrNullGl::ResetStats();
+    LoadModelFileAsync(
+        loader,
+        fileSys,
+        CONTROLLER_URI,
+        programs,
+        materialParms,
+        [&loaded, &called](ModelFile* model) {
+            loaded = model;
+            called = true;
+        },
+        cachePath);
+
+    numSteps = 0;
+    const double timeout = HostTestSeconds() + 10.0;
+    while (!called && HostTestSeconds() < timeout) {
+        const ovrNullGlStats before = ovrNullGl::GetStats();
+        // no budget still runs one step
+        const int numRun = loader.Update(0.0);
+        const ovrNullGlStats after = ovrNullGl::GetStats();
+        if (numRun == 0) {
+            // the loader thread is reading and parsing, without touching GL
+            HOST_CHECK_EQ(after.TextureUploads + after.BufferDataCalls, 0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        HOST_CHECK_EQ(numRun, 1);
+        numSteps++;
+        const int64_t textures = after.TextureUploads - before.TextureUploads;
+        const int64_t buffers = after.BufferDataCalls - before.BufferDataCalls;
+        // a texture with its mips, or a vertex and index buffer
+        HOST_CHECK(textures == 0 || buffers == 0);
+        HOST_CHECK(buffers <= 2);
+        HOST_CHECK_EQ(after.BufferSubDataCalls, before.BufferSubDataCalls);
+    }
+    HOST_CHECK(called);
+    HOST_CHECK(loader.IsIdle());
+    return loaded;
+}
+
+} // namespace
+
+int main(int, char**) {
+    // a stepped upload keeps its place and its slot until its last step, and no budget still
+    // runs one step per drain
+    {
+        std::vector<std::string> log;
+        ovrGpuUploadQueue queue(2);
+        HOST_CHECK(queue.PostSteps(MakeStubSteps(log, "a", 3)));
+        HOST_CHECK(queue.Post([&log]() { log.push_back("b"); }));
+        HOST_CHECK_EQ(queue.Drain(0.0), 1);
+        HOST_CHECK_EQ(queue.GetNumQueued(), 2);
+        HOST_CHECK_EQ(queue.Drain(0.0), 1);
+        HOST_CHECK_EQ(queue.Drain(0.0), 1);
+        HOST_CHECK_EQ(queue.GetNumQueued(), 1);
+        HOST_CHECK_EQ(queue.Drain(1.0), 1);
+        HOST_CHECK_EQ(queue.GetNumQueued(), 0);
+        const std::vector<std::string> expected = {"a0", "a1", "a2", "b"};
+        HOST_CHECK(log == expected);
+
+        // a budget runs as many steps as fit
+        log.clear();
+        HOST_CHECK(queue.PostSteps(MakeStubSteps(log, "c", 4)));
+        HOST_CHECK_EQ(queue.Drain(1.0), 4);
+
+        // closing drops a half done upload
+        log.clear();
+        HOST_CHECK(queue.PostSteps(MakeStubSteps(log, "d", 4)));
+        HOST_CHECK_EQ(queue.Drain(0.0), 1);
+        queue.Close();
+        HOST_CHECK_EQ(queue.GetNumQueued(), 0);
+        HOST_CHECK(!queue.Post([]() {}));
+    }
+
+    ovrHostGui gui;
+    GlProgram program;
+    const ModelGlPrograms programs(&program);
+
+    // the model loaded the old way, everything on the calling thread
+    ModelFile* reference = LoadModelFile(*gui.FileSys, CONTROLLER_URI, programs, MaterialParms());
+    HOST_CHECK(reference != nullptr);
+
+    ovrAsyncLoader loader;
+    loader.Init(1);
+    const char* const cachePath = "AsyncLoaderTest.ovrcooked";
+    remove(cachePath);
+    // read from the source and cooked, then created from the cooked file
+    for (int pass = 0; pass < 2 && reference != nullptr; pass++) {
+        int numSteps = 0;
+        ModelFile* model = LoadStepByStep(loader, *gui.FileSys, programs, cachePath, numSteps);
+        HOST_CHECK(model != nullptr);
+        if (model == nullptr) {
+            break;
+        }
+        // one step per texture and per surface
+        int numSurfaces = 0;
+        for (const Model& m : model->Models) {
+            numSurfaces += static_cast<int>(m.surfaces.size());
+        }
+        HOST_CHECK(numSurfaces > 0);
+        HOST_CHECK_EQ(numSteps, static_cast<int>(model->Textures.size()) + numSurfaces);
+
+        HOST_CHECK(!HasPlaceholders(*model));
+        HOST_CHECK_EQ(model->Textures.size(), reference->Textures.size());
+        HOST_CHECK_EQ(model->Models.size(), reference->Models.size());
+        for (size_t i = 0; i < model->Models.size() && i < reference->Models.size(); i++) {
+            const Model& a = model->Models[i];
+            const Model& b = reference->Models[i];
+            HOST_CHECK_EQ(a.surfaces.size(), b.surfaces.size());
+            for (size_t j = 0; j < a.surfaces.size() && j < b.surfaces.size(); j++) {
+                const ovrSurfaceDef& sa = a.surfaces[j].surfaceDef;
+                const ovrSurfaceDef& sb = b.surfaces[j].surfaceDef;
+                HOST_CHECK(sa.geo.vertexArrayObject != 0);
+                HOST_CHECK_EQ(sa.geo.vertexCount, sb.geo.vertexCount);
+                HOST_CHECK_EQ(sa.geo.indexCount, sb.geo.indexCount);
+                HOST_CHECK_EQ(sa.geo.primitiveType, sb.geo.primitiveType);
+                HOST_CHECK(sa.graphicsCommand.Textures[0].target == GL_TEXTURE_2D);
+                HOST_CHECK_EQ(
+                    sa.graphicsCommand.Textures[0].Width, sb.graphicsCommand.Textures[0].Width);
+            }
+        }
+        delete model;
+
+        // the first load cooked the geometry on the loader thread
+        FILE* cooked = fopen(cachePath, "rb");
+        HOST_CHECK(cooked != nullptr);
+        if (cooked != nullptr) {
+            fclose(cooked);
+        }
+    }
+    remove(cachePath);
+
+    // ParallelFor runs every item once, also from a load job while its only loader thread is
+    // busy running that job
+    {
+        std::vector<std::atomic<int>> runs(1000);
+        loader.ParallelFor(static_cast<int>(runs.size()), [&runs](int i) { runs[i]++; });
+        std::atomic<bool> nestedDone(false);
+        loader.Load([&loader, &runs, &nestedDone]() -> ovrGpuUpload {
+            loader.ParallelFor(static_cast<int>(runs.size()), [&runs](int i) { runs[i]++; });
+            nestedDone = true;
+            return ovrGpuUpload();
+        });
+        const double timeout = HostTestSeconds() + 10.0;
+        while (!loader.IsIdle() && HostTestSeconds() < timeout) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        HOST_CHECK(nestedDone);
+        int numWrong = 0;
+        for (const std::atomic<int>& r : runs) {
+            numWrong += (r != 2) ? 1 : 0;
+        }
+        HOST_CHECK_EQ(numWrong, 0);
+    }
+
+    // a load dropped by a shutdown frees its model without creating anything
+    ovrNullGl::ResetStats();
+    bool called = false;
+    LoadModelFileAsync(
+        loader,
+        *gui.FileSys,
+        CONTROLLER_URI,
+        programs,
+        MaterialParms(),
+        [&called](ModelFile*) { called = true; });
+    loader.Shutdown();
+    HOST_CHECK(!called);
+    HOST_CHECK_EQ(ovrNullGl::GetStats().TextureUploads, 0);
+    HOST_CHECK_EQ(ovrNullGl::GetStats().BufferDataCalls, 0);
+
+    delete reference;
+    return HOST_TEST_RESULT();
+}
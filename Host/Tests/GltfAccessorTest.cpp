@@ -0,0 +1,198 @@
+/************************************************************************************
+
+Filename    :   GltfAccessorTest.cpp
+Content     :   Checks which glTF primitives are uploaded in place and which are read attribute by
+                attribute, and that sparse and normalized accessors are read correctly
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostGui.h"
+#include "NullGl.h"
+
+#include "Model/ModelFile.h"
+#include "Render/GlProgram.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace OVRFW;
+using OVR::Matrix4f;
+using OVR::Vector3f;
+
+namespace {
+
+// One bufferView with four vertices of a float position, a float texture coordinate and a
+// normalized unsigned short texture coordinate, 24 bytes each. The same quad is used three
+// times: with the float attributes, which can go to GL in place, with the normalized texture
+// coordinate, and with a sparse position accessor that moves the last vertex to (5, 6, 7).
+const char* const QUADS_GLTF = R"({
+  "asset": { "version": "2.0" },
+  "scene": 0,
+  "scenes": [ { "nodes": [ 0, 1, 2 ] } ],
+  "nodes": [ { "mesh": 0 }, { "mesh": 1 }, { "mesh": 2 } ],
+  "meshes": [
+    { "name": "float",
+      "primitives": [ { "attributes": { "POSITION": 0, "TEXCOORD_0": 1 }, "indices": 3 } ] },
+    { "name": "normalized",
+      "primitives": [ { "attributes": { "POSITION": 0, "TEXCOORD_0": 2 }, "indices": 3 } ] },
+    { "name": "sparse",
+      "primitives": [ { "attributes": { "POSITION": 4, "TEXCOORD_0": 1 }, "indices": 3 } ] }
+  ],
+  "buffers": [ { "byteLength": 124 } ],
+  "bufferViews": [
+    { "buffer": 0, "byteOffset": 0, "byteLength": 96, "byteStride": 24, "target": 34962 },
+    { "buffer": 0, "byteOffset": 96, "byteLength": 12, "target": 34963 },
+    { "buffer": 0, "byteOffset": 108, "byteLength": 1 },
+    { "buffer": 0, "byteOffset": 112, "byteLength": 12 }
+  ],
+  "accessors": [
+    { "bufferView": 0, "byteOffset": 0, "componentType": 5126, "count": 4, "type": "VEC3",
+      "min": [ 0.0, 0.0, 0.0 ], "max": [ 1.0, 1.0, 0.0 ] },
+    { "bufferView": 0, "byteOffset": 12, "componentType": 5126, "count": 4, "type": "VEC2" },
+    { "bufferView": 0, "byteOffset": 20, "componentType": 5123, "normalized": true,
+      "count": 4, "type": "VEC2" },
+    { "bufferView": 1, "componentType": 5123, "count": 6, "type": "SCALAR" },
+    { "bufferView": 0, "byteOffset": 0, "componentType": 5126, "count": 4, "type": "VEC3",
+      "min": [ 0.0, 0.0, 0.0 ], "max": [ 5.0, 6.0, 7.0 ],
+      "sparse": { "count": 1,
+                  "indices": { "bufferView": 2, "componentType": 5121 },
+                  "values": { "bufferView": 3 } } }
+  ]
+})";
+
+const int NUM_VERTICES = 4;
+const int STRIDE = 24;
+
+std::vector<uint8_t> MakeQuadsGlb() {
+    std::vector<uint8_t> bin(124, 0);
+    for (int i = 0; i < NUM_VERTICES; i++) {
+        const float x = static_cast<float>(i & 1);
+        const float y = static_cast<float>(i >> 1);
+        const float vertex[5] = {x, y, 0.0f, x, y};
+        const uint16_t uv[2] = {
+            static_cast<uint16_t>(x * 65535), static_cast<uint16_t>(y * 65535)};
+        memcpy(&bin[i * STRIDE], vertex, sizeof(vertex));
+        memcpy(&bin[i * STRIDE + 20], uv, sizeof(uv));
+    }
+    const uint16_t indices[6] = {0, 1, 2, 2, 1, 3};
+    memcpy(&bin[96], indices, sizeof(indices));
+    bin[108] = 3;
+    const float moved[3] = {5.0f, 6.0f, 7.0f};
+    memcpy(&bin[112], moved, sizeof(moved));
+
+    std::string json = QUADS_GLTF;
+    while (json.size() % 4 != 0) {
+        json += ' ';
+    }
+    std::vector<uint8_t> glb;
+    auto append = [&glb](const uint32_t value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        glb.insert(glb.end(), bytes, bytes + sizeof(value));
+    };
+    append(0x46546C67); // "glTF"
+    append(2);
+    append(static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.size()));
+    append(static_cast<uint32_t>(json.size()));
+    append(0x4E4F534A); // "JSON"
+    glb.insert(glb.end(), json.begin(), json.end());
+    append(static_cast<uint32_t>(bin.size()));
+    append(0x004E4942); // "BIN"
+    glb.insert(glb.end(), bin.begin(), bin.end());
+    return glb;
+}
+
+ModelFile* LoadQuads(
+    const std::vector<uint8_t>& glb,
+    const ModelGlPrograms& programs,
+    ModelGeo* outModelGeo = nullptr) {
+    return LoadModelFileFromMemory(
+        "quads.glb",
+        glb.data(),
+        static_cast<int>(glb.size()),
+        programs,
+        MaterialParms(),
+        outModelGeo);
+}
+
+GLsizeiptr GetVertexStoreSize(const ModelFile& model, const int mesh) {
+    GLsizeiptr size = 0;
+    GLenum usage = 0;
+    HOST_CHECK(ovrNullGl::GetBufferStore(
+        model.Models[mesh].surfaces[0].surfaceDef.geo.vertexBuffer, size, usage));
+    return size;
+}
+
+} // namespace
+
+int main(int, char**) {
+    ovrHostGui gui;
+    GlProgram program;
+    const ModelGlPrograms programs(&program);
+    const std::vector<uint8_t> glb = MakeQuadsGlb();
+
+    // only the all float primitive uses the source view, with its unused bytes
+    ModelFile* model = LoadQuads(glb, programs);
+    HOST_CHECK(model != nullptr);
+    if (model != nullptr) {
+        HOST_CHECK_EQ(model->Models.size(), 3u);
+        HOST_CHECK_EQ(GetVertexStoreSize(*model, 0), NUM_VERTICES * STRIDE);
+        HOST_CHECK(GetVertexStoreSize(*model, 1) < NUM_VERTICES * STRIDE);
+        HOST_CHECK(GetVertexStoreSize(*model, 2) < NUM_VERTICES * STRIDE);
+        for (const Model& m : model->Models) {
+            HOST_CHECK_EQ(m.surfaces[0].surfaceDef.geo.vertexCount, NUM_VERTICES);
+            HOST_CHECK_EQ(m.surfaces[0].surfaceDef.geo.indexCount, 6);
+        }
+        const OVR::Bounds3f& bounds = model->Models[2].surfaces[0].surfaceDef.geo.localBounds;
+        HOST_CHECK(bounds.GetMaxs() == Vector3f(5.0f, 6.0f, 7.0f));
+    }
+    delete model;
+
+    // a transform has to be applied, so nothing goes to GL in place
+    {
+        GlGeometry::TransformScope scope(Matrix4f::Translation(0.0f, 0.0f, 10.0f));
+        model = LoadQuads(glb, programs);
+    }
+    HOST_CHECK(model != nullptr);
+    if (model != nullptr) {
+        // the same quad created from its attributes under the same transform
+        VertexAttribs attribs;
+        for (int i = 0; i < NUM_VERTICES; i++) {
+            const float x = static_cast<float>(i & 1);
+            const float y = static_cast<float>(i >> 1);
+            attribs.position.push_back(Vector3f(x, y, 0.0f));
+            attribs.uv0.push_back(OVR::Vector2f(x, y));
+        }
+        GlGeometry reference;
+        {
+            GlGeometry::TransformScope scope(Matrix4f::Translation(0.0f, 0.0f, 10.0f));
+            reference.Create(attribs, std::vector<TriangleIndex>{0, 1, 2, 2, 1, 3});
+        }
+        GLsizeiptr size = 0;
+        GLenum usage = 0;
+        HOST_CHECK(ovrNullGl::GetBufferStore(reference.vertexBuffer, size, usage));
+        HOST_CHECK_EQ(GetVertexStoreSize(*model, 0), size);
+        reference.Free();
+    }
+    delete model;
+
+    // the sparse value replaces the last vertex of the third quad only
+    ModelGeo geo;
+    model = LoadQuads(glb, programs, &geo);
+    HOST_CHECK(model != nullptr);
+    HOST_CHECK_EQ(geo.positions.size(), static_cast<size_t>(3 * NUM_VERTICES));
+    if (geo.positions.size() == static_cast<size_t>(3 * NUM_VERTICES)) {
+        HOST_CHECK(geo.positions[NUM_VERTICES - 1] == Vector3f(1.0f, 1.0f, 0.0f));
+        HOST_CHECK(geo.positions[2 * NUM_VERTICES - 1] == Vector3f(1.0f, 1.0f, 0.0f));
+        HOST_CHECK(geo.positions[3 * NUM_VERTICES - 2] == Vector3f(0.0f, 1.0f, 0.0f));
+        HOST_CHECK(geo.positions[3 * NUM_VERTICES - 1] == Vector3f(5.0f, 6.0f, 7.0f));
+    }
+    delete model;
+
+    return HOST_TEST_RESULT();
+}
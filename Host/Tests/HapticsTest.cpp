@@ -0,0 +1,321 @@
+/************************************************************************************
+
+Filename    :   HapticsTest.cpp
+Content     :   Drives the haptics engine frame by frame into a sink that records what would have
+                played, and through the stand-in VrApi, and checks effects, ramps and call counts
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "HostVrApi.h"
+#include "Input/Haptics.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <map>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+const double SAMPLE_SECONDS = 0.002;
+
+ovrInputTrackedRemoteCapabilities MakeCaps(const bool buffered) {
+    ovrInputTrackedRemoteCapabilities caps = {};
+    caps.ControllerCapabilities = ovrControllerCaps_HasSimpleHapticVibration;
+    if (buffered) {
+        caps.ControllerCapabilities |= ovrControllerCaps_HasBufferedHapticVibration;
+        caps.HapticSamplesMax = 1024;
+        caps.HapticSampleDurationMS = static_cast<uint32_t>(SAMPLE_SECONDS * 1000.0 + 0.5);
+    }
+    return caps;
+}
+
+//==============================================================
+// ovrRecordingSink
+// Plays buffers onto a timeline of 2 ms samples the way the device queues them: a buffer
+// replaces whatever was queued from its start time on, and a terminated one ends playback after
+// its last sample.
+class ovrRecordingSink : public ovrHapticsSink {
+   public:
+    int NumBuffers = 0;
+    int NumSimple = 0;
+    int NumTerminated = 0;
+    // buffers that left a gap after the previous one while it was still playing
+    int NumGaps = 0;
+    bool Fail = false;
+    std::map<int64_t, uint8_t> Timeline;
+    std::vector<float> SimpleLevels;
+
+    virtual bool SubmitBuffer(const ovrHapticBuffer& buffer) override {
+        NumBuffers++;
+        if (Fail) {
+            return false;
+        }
+        const int64_t start = ToSample(buffer.BufferTime);
+        if (Playing && start > PlayingUntil) {
+            NumGaps++;
+        }
+        Timeline.erase(Timeline.lower_bound(start), Timeline.end());
+        for (uint32_t i = 0; i < buffer.NumSamples; ++i) {
+            Timeline[start + i] = buffer.HapticBuffer[i];
+        }
+        Playing = !buffer.Terminated;
+        PlayingUntil = start + buffer.NumSamples;
+        NumTerminated += buffer.Terminated ? 1 : 0;
+        return true;
+    }
+    virtual bool SubmitSimple(const float intensity) override {
+        NumSimple++;
+        SimpleLevels.push_back(intensity);
+        return !Fail;
+    }
+
+    // The strongest sample played between two times.
+    int MaxBetween(const double start, const double end) const {
+        int result = 0;
+        for (auto it = Timeline.lower_bound(ToSample(start));
+             it != Timeline.end() && it->first < ToSample(end);
+             ++it) {
+            result = it->second > result ? it->second : result;
+        }
+        return result;
+    }
+    // The largest change from one played sample to the next.
+    int MaxStep() const {
+        int result = 0;
+        for (auto it = Timeline.begin(); it != Timeline.end(); ++it) {
+            const auto next = std::next(it);
+            if (next != Timeline.end() && next->first == it->first + 1) {
+                const int step = abs(next->second - it->second);
+                result = step > result ? step : result;
+            }
+        }
+        return result;
+    }
+
+   private:
+    bool Playing = false;
+    int64_t PlayingUntil = 0;
+
+    static int64_t ToSample(const double time) {
+        return static_cast<int64_t>(floor(time / SAMPLE_SECONDS + 0.5));
+    }
+};
+
+// Updates the engine once per frame from one display time up to another, and returns the
+// number of frames.
+int RunFrames(
+    ovrHapticsEngine& engine,
+    ovrHapticsSink& sink,
+    double& displayTime,
+    const double endTime,
+    const double frameSeconds) {
+    int frames = 0;
+    for (; displayTime < endTime; displayTime += frameSeconds) {
+        const int before = engine.GetNumSubmits();
+        engine.Update(displayTime, sink);
+        // never more than one call per frame
+        HOST_CHECK(engine.GetNumSubmits() - before <= 1);
+        frames++;
+    }
+    return frames;
+}
+
+void TestSustained() {
+    // a held level streams without gaps, ramps at the slew limit, and stops with a terminated
+    // buffer; the number of calls is set by the buffer length rather than the frame rate
+    for (const double hz : {72.0, 120.0}) {
+        ovrHapticsEngine engine;
+        engine.SetCapabilities(MakeCaps(true));
+        ovrRecordingSink sink;
+        double time = 100.0;
+        RunFrames(engine, sink, time, 101.0, 1.0 / hz);
+        HOST_CHECK_EQ(sink.NumBuffers, 0);
+
+        engine.SetSustained(HAPTIC_CHANNEL_INPUT, 1.0f);
+        const double start = time;
+        RunFrames(engine, sink, time, start + 2.0, 1.0 / hz);
+        HOST_CHECK(engine.IsPlaying());
+        HOST_CHECK_EQ(sink.NumGaps, 0);
+        HOST_CHECK_EQ(sink.MaxBetween(start + 0.5, start + 2.0), 255);
+        const int maxStep = static_cast<int>(
+            ceil(ovrHapticsEngine::SLEW_PER_SECOND * SAMPLE_SECONDS * 255.0));
+        HOST_CHECK(sink.MaxStep() <= maxStep);
+        const int perSecond = sink.NumBuffers / 2;
+        printf("%.0f Hz: %d buffers per second of sustained haptics\n", hz, perSecond);
+        HOST_CHECK(perSecond < 60);
+
+        engine.SetSustained(HAPTIC_CHANNEL_INPUT, 0.0f);
+        RunFrames(engine, sink, time, time + 1.0, 1.0 / hz);
+        HOST_CHECK(!engine.IsPlaying());
+        HOST_CHECK_EQ(sink.NumTerminated, 1);
+        HOST_CHECK_EQ(sink.NumGaps, 0);
+        const int numBuffers = sink.NumBuffers;
+        RunFrames(engine, sink, time, time + 1.0, 1.0 / hz);
+        HOST_CHECK_EQ(sink.NumBuffers, numBuffers);
+    }
+}
+
+void TestOneShot() {
+    // a click shorter than what is already queued still plays, in full, over a held level
+    const double frameSeconds = 1.0 / 72.0;
+    ovrHapticsEngine engine;
+    engine.SetCapabilities(MakeCaps(true));
+    ovrRecordingSink sink;
+    double time = 100.0;
+    engine.SetSustained(HAPTIC_CHANNEL_FORCE, 0.25f);
+    RunFrames(engine, sink, time, 101.0, frameSeconds);
+
+    int numLost = 0;
+    double maxDelay = 0.0;
+    for (int i = 0; i < 20; i++) {
+        // at every point of the refill cycle
+        RunFrames(engine, sink, time, time + frameSeconds * (i % 3), frameSeconds);
+        const double clickTime = time;
+        const int id = engine.Play(clickTime, 0.01, 1.0f, 1.0f);
+        HOST_CHECK(id >= 0);
+        RunFrames(engine, sink, time, clickTime + 0.2, frameSeconds);
+        // full strength for the click's 5 samples, no later than the queue allows
+        int numFull = 0;
+        for (double t = clickTime; t < clickTime + ovrHapticsEngine::FILL_AHEAD_SECONDS + 0.02;
+             t += SAMPLE_SECONDS) {
+            if (sink.MaxBetween(t, t + SAMPLE_SECONDS) == 255) {
+                maxDelay = numFull++ == 0 && t - clickTime > maxDelay ? t - clickTime : maxDelay;
+            }
+        }
+        numLost += numFull >= 5 ? 0 : 1;
+    }
+    printf(
+        "clicks over a held level: %d of 20 lost, up to %.1f ms late\n", numLost, maxDelay * 1e3);
+    HOST_CHECK_EQ(numLost, 0);
+    HOST_CHECK(maxDelay <= ovrHapticsEngine::REFILL_SECONDS + SAMPLE_SECONDS);
+    HOST_CHECK_EQ(sink.NumGaps, 0);
+
+    // an effect scheduled later than the queue plays when it was asked to
+    const double later = time + 0.5;
+    engine.Play(later, 0.02, 1.0f, 1.0f);
+    RunFrames(engine, sink, time, later + 0.2, frameSeconds);
+    HOST_CHECK_EQ(sink.MaxBetween(later - 0.01, later), 64);
+    HOST_CHECK_EQ(sink.MaxBetween(later, later + 0.02), 255);
+
+    // stopped effects don't play, and there are only so many at once
+    ovrHapticsEngine full;
+    full.SetCapabilities(MakeCaps(true));
+    for (int i = 0; i < ovrHapticsEngine::MAX_EFFECTS; i++) {
+        HOST_CHECK(full.Play(time, 1.0, 0.5f, 0.5f) >= 0);
+    }
+    HOST_CHECK_EQ(full.Play(time, 1.0, 0.5f, 0.5f), -1);
+    ovrRecordingSink quiet;
+    const int id = engine.Play(time + 0.5, 0.02, 1.0f, 1.0f);
+    engine.Stop(id);
+    engine.SetSustained(HAPTIC_CHANNEL_FORCE, 0.0f);
+    const double stopped = time + 0.5;
+    RunFrames(engine, quiet, time, stopped + 0.2, frameSeconds);
+    HOST_CHECK_EQ(quiet.MaxBetween(stopped, stopped + 0.02), 0);
+}
+
+void TestFailingSink() {
+    // a rejected buffer is sent again from the display time on the next frame
+    const double frameSeconds = 1.0 / 72.0;
+    ovrHapticsEngine engine;
+    engine.SetCapabilities(MakeCaps(true));
+    ovrRecordingSink sink;
+    engine.SetSustained(HAPTIC_CHANNEL_INPUT, 1.0f);
+    double time = 100.0;
+    sink.Fail = true;
+    RunFrames(engine, sink, time, 100.1, frameSeconds);
+    HOST_CHECK_EQ(sink.NumBuffers, static_cast<int>(ceil(0.1 / frameSeconds)));
+    HOST_CHECK(!engine.IsPlaying());
+    sink.Fail = false;
+    RunFrames(engine, sink, time, 100.2, frameSeconds);
+    HOST_CHECK(engine.IsPlaying());
+    HOST_CHECK(sink.MaxBetween(100.1, 100.3) > 0);
+}
+
+void TestSimple() {
+    // without buffers the level is sent when it changes enough, and stopping and full strength
+    // exactly
+    const double frameSeconds = 1.0 / 72.0;
+    ovrHapticsEngine engine;
+    engine.SetCapabilities(MakeCaps(false));
+    ovrRecordingSink sink;
+    double time = 100.0;
+    engine.SetSustained(HAPTIC_CHANNEL_INPUT, 1.0f);
+    RunFrames(engine, sink, time, 101.0, frameSeconds);
+    HOST_CHECK_EQ(sink.NumBuffers, 0);
+    HOST_CHECK(!sink.SimpleLevels.empty() && sink.SimpleLevels.back() == 1.0f);
+    // the ramp takes 1 / SLEW_PER_SECOND, in steps larger than the threshold
+    HOST_CHECK(sink.NumSimple <= 1 + static_cast<int>(1.0 / ovrHapticsEngine::SIMPLE_THRESHOLD));
+    const int numRamp = sink.NumSimple;
+    RunFrames(engine, sink, time, 102.0, frameSeconds);
+    HOST_CHECK_EQ(sink.NumSimple, numRamp);
+    engine.SetSustained(HAPTIC_CHANNEL_INPUT, 0.0f);
+    RunFrames(engine, sink, time, 103.0, frameSeconds);
+    HOST_CHECK(sink.SimpleLevels.back() == 0.0f);
+
+    // a device without haptics gets nothing
+    ovrHapticsEngine none;
+    none.SetCapabilities(ovrInputTrackedRemoteCapabilities());
+    none.SetSustained(HAPTIC_CHANNEL_INPUT, 1.0f);
+    HOST_CHECK(!none.Update(time, sink));
+}
+
+void TestVrApi() {
+    // through the stand-in VrApi, at one call per device and frame at most
+    ovrHostVrApi::SetRemoteCount(2);
+    ovrModeParms parms = {};
+    ovrMobile* ovr = vrapi_EnterVrMode(&parms);
+    ovrInputTrackedRemoteCapabilities caps = {};
+    caps.Header.Type = ovrControllerType_TrackedRemote;
+    caps.Header.DeviceID = ovrHostVrApi::GetRemoteDeviceID(1);
+    HOST_CHECK_EQ(vrapi_GetInputDeviceCapabilities(ovr, &caps.Header), ovrSuccess);
+
+    ovrHapticsEngine engine;
+    engine.SetCapabilities(caps);
+    ovrVrApiHapticsSink sink(ovr, caps.Header.DeviceID);
+    ovrHostVrApi::SetWaitForVsync(false);
+    ovrHostVrApi::ResetStats();
+    engine.SetSustained(HAPTIC_CHANNEL_FORCE, 0.5f);
+    for (int frame = 1; frame <= 144; frame++) {
+        const double displayTime = vrapi_GetPredictedDisplayTime(ovr, frame);
+        if (frame % 30 == 0) {
+            engine.Play(displayTime, 0.01, 1.0f, 1.0f);
+        }
+        engine.Update(displayTime, sink);
+        ovrSubmitFrameDescription2 frameDesc = {};
+        frameDesc.SwapInterval = 1;
+        frameDesc.FrameIndex = frame;
+        frameDesc.DisplayTime = displayTime;
+        vrapi_SubmitFrame2(ovr, &frameDesc);
+    }
+    const ovrHostVrApiStats stats = ovrHostVrApi::GetStats();
+    printf(
+        "vrapi: %d buffers, %d samples over %d frames\n",
+        stats.HapticBufferCalls,
+        stats.HapticSamples,
+        static_cast<int>(stats.SubmittedFrames));
+    HOST_CHECK(stats.HapticBufferCalls > 0);
+    HOST_CHECK_EQ(stats.HapticBufferCalls, engine.GetNumSubmits());
+    HOST_CHECK_EQ(stats.HapticSimpleCalls, 0);
+    HOST_CHECK_EQ(stats.HapticCallsPerFrameExceeded, 0);
+    ovrHostVrApi::SetWaitForVsync(true);
+    vrapi_LeaveVrMode(ovr);
+}
+
+} // namespace
+
+int main(int, char**) {
+    TestSustained();
+    TestOneShot();
+    TestFailingSink();
+    TestSimple();
+    TestVrApi();
+    return HOST_TEST_RESULT();
+}
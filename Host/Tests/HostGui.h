@@ -0,0 +1,66 @@
+/************************************************************************************
+
+Filename    :   HostGui.h
+Content     :   A GUI system on the host build's file system, for the GUI tests
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include "HostAndroid.h"
+#include "HostJni.h"
+
+#include "GUI/GuiSys.h"
+#include "OVR_FileSys.h"
+#include "Render/DebugLines.h"
+
+#include <GLES3/gl3.h>
+
+namespace OVRFW {
+
+//==============================================================
+// ovrHostGui
+// Set up as an app does in AppInit, with host.apk as the package so the default font loads.
+class ovrHostGui {
+   public:
+    ovrHostGui() {
+        ovrHostAndroid::SetLogPriority(ANDROID_LOG_WARN);
+        ovrHostJni::SetPackage("cz.walle.wallevrcontroller2", HOST_APK_PATH);
+        Java.Vm = ovrHostJni::GetVm();
+        Java.Vm->GetEnv(reinterpret_cast<void**>(&Java.Env), JNI_VERSION_1_6);
+        Java.ActivityObject = ovrHostJni::GetActivity();
+        FileSys = ovrFileSys::Create(Java);
+        DebugLines = OvrDebugLines::Create();
+        DebugLines->Init();
+        GuiSys = OvrGuiSys::Create(&Java);
+        GuiSys->Init(FileSys, SoundEffectPlayer, "efigs.fnt", DebugLines);
+    }
+    ~ovrHostGui() {
+        OvrGuiSys::Destroy(GuiSys);
+        OvrDebugLines::Free(DebugLines);
+        ovrFileSys::Destroy(FileSys);
+    }
+
+    // A texture for menu surfaces, without loading an image.
+    static GLuint CreateTexture(const int width, const int height) {
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(
+            GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return texture;
+    }
+
+    xrJava Java;
+    ovrFileSys* FileSys = nullptr;
+    OvrDebugLines* DebugLines = nullptr;
+    OvrGuiSys::ovrDummySoundEffectPlayer SoundEffectPlayer;
+    OvrGuiSys* GuiSys = nullptr;
+};
+
+} // namespace OVRFW
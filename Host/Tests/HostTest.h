@@ -0,0 +1,93 @@
+/************************************************************************************
+
+Filename    :   HostTest.h
+Content     :   Checks and benchmark timing for the host tests
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// Each test is an executable whose main() runs its checks and returns HOST_TEST_RESULT().
+// A failed check is reported and counted but does not stop the test, so one run shows every
+// failure. Benchmarks take --quick, which ctest passes, to run just long enough to be checked.
+
+namespace OVRFW {
+
+inline int& HostTestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline bool HostTestQuick(const int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline double HostTestSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace OVRFW
+
+#define HOST_CHECK(cond)                                                             \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            OVRFW::HostTestFailures()++;                                             \
+        }                                                                            \
+    } while (0)
+
+#define HOST_CHECK_EQ(a, b)                                                                \
+    do {                                                                                   \
+        const auto hostA_ = (a);                                                           \
+        const auto hostB_ = (b);                                                           \
+        if (!(hostA_ == hostB_)) {                                                         \
+            fprintf(                                                                       \
+                stderr,                                                                    \
+                "%s:%d: check failed: %s == %s (%.17g vs %.17g)\n",                        \
+                __FILE__,                                                                  \
+                __LINE__,                                                                  \
+                #a,                                                                        \
+                #b,                                                                        \
+                static_cast<double>(hostA_),                                               \
+                static_cast<double>(hostB_));                                              \
+            OVRFW::HostTestFailures()++;                                                   \
+        }                                                                                  \
+    } while (0)
+
+#define HOST_CHECK_NEAR(a, b, tolerance)                                                   \
+    do {                                                                                   \
+        const double hostA_ = (a);                                                         \
+        const double hostB_ = (b);                                                         \
+        if (!(std::fabs(hostA_ - hostB_) <= (tolerance))) {                                \
+            fprintf(                                                                       \
+                stderr,                                                                    \
+                "%s:%d: check failed: %s ~= %s (%.9g vs %.9g)\n",                          \
+                __FILE__,                                                                  \
+                __LINE__,                                                                  \
+                #a,                                                                        \
+                #b,                                                                        \
+                hostA_,                                                                    \
+                hostB_);                                                                   \
+            OVRFW::HostTestFailures()++;                                                   \
+        }                                                                                  \
+    } while (0)
+
+#define HOST_TEST_RESULT()                                                             \
+    (fflush(stdout), OVRFW::HostTestFailures() == 0                                    \
+         ? (fprintf(stderr, "passed\n"), 0)                                            \
+         : (fprintf(stderr, "%d check(s) failed\n", OVRFW::HostTestFailures()), 1))
@@ -0,0 +1,306 @@
+/************************************************************************************
+
+Filename    :   IndexWidthTest.cpp
+Content     :   Checks that geometry is drawn with 16 bit indices when its vertices allow it and
+                with 32 bit indices when they don't, for every way geometry is created
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostGui.h"
+#include "NullGl.h"
+
+#include "Model/ModelCache.h"
+#include "Model/ModelFile.h"
+#include "Model/ModelUploads.h"
+#include "Render/GlGeometry.h"
+#include "Render/GlProgram.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace OVRFW;
+using OVR::Vector3f;
+
+namespace {
+
+// more vertices than 16 bit indices can address
+const int LARGE_WIDTH = 300;
+const int LARGE_HEIGHT = 240;
+const int SMALL_WIDTH = 4;
+const int SMALL_HEIGHT = 4;
+
+const GLenum COMPONENT_UNSIGNED_BYTE = 5121;
+const GLenum COMPONENT_UNSIGNED_INT = 5125;
+
+// A grid of width x height vertices, two triangles per cell.
+void MakeGrid(
+    const int width,
+    const int height,
+    VertexAttribs& attribs,
+    std::vector<TriangleIndex32>& indices) {
+    attribs = VertexAttribs();
+    indices.clear();
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            attribs.position.push_back(Vector3f(static_cast<float>(x), static_cast<float>(y), 0));
+        }
+    }
+    for (int y = 0; y + 1 < height; y++) {
+        for (int x = 0; x + 1 < width; x++) {
+            const TriangleIndex32 i = y * width + x;
+            indices.insert(indices.end(), {i, i + 1, i + width, i + width, i + 1, i + width + 1});
+        }
+    }
+}
+
+// A .glb with one primitive: the grid's positions and its indices as componentType.
+std::vector<uint8_t> MakeGridGlb(const int width, const int height, const GLenum componentType) {
+    VertexAttribs attribs;
+    std::vector<TriangleIndex32> indices;
+    MakeGrid(width, height, attribs, indices);
+
+    const size_t positionBytes = attribs.position.size() * sizeof(Vector3f);
+    size_t indexSize = 2;
+    if (componentType == COMPONENT_UNSIGNED_INT) {
+        indexSize = 4;
+    } else if (componentType == COMPONENT_UNSIGNED_BYTE) {
+        indexSize = 1;
+    }
+    std::vector<uint8_t> bin(positionBytes);
+    memcpy(bin.data(), attribs.position.data(), positionBytes);
+    for (const TriangleIndex32 index : indices) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&index);
+        bin.insert(bin.end(), bytes, bytes + indexSize);
+    }
+    while (bin.size() % 4 != 0) {
+        bin.push_back(0);
+    }
+
+    char json[2048];
+    snprintf(
+        json,
+        sizeof(json),
+        R"({
+  "asset": { "version": "2.0" },
+  "scene": 0,
+  "scenes": [ { "nodes": [ 0 ] } ],
+  "nodes": [ { "mesh": 0 } ],
+  "meshes": [ { "primitives": [ { "attributes": { "POSITION": 0 }, "indices": 1 } ] } ],
+  "buffers": [ { "byteLength": %zu } ],
+  "bufferViews": [
+    { "buffer": 0, "byteOffset": 0, "byteLength": %zu, "target": 34962 },
+    { "buffer": 0, "byteOffset": %zu, "byteLength": %zu, "target": 34963 }
+  ],
+  "accessors": [
+    { "bufferView": 0, "componentType": 5126, "count": %zu, "type": "VEC3",
+      "min": [ 0.0, 0.0, 0.0 ], "max": [ %d.0, %d.0, 0.0 ] },
+    { "bufferView": 1, "componentType": %u, "count": %zu, "type": "SCALAR" }
+  ]
+})",
+        bin.size(),
+        positionBytes,
+        positionBytes,
+        indices.size() * indexSize,
+        attribs.position.size(),
+        width - 1,
+        height - 1,
+        componentType,
+        indices.size());
+
+    std::string header = json;
+    while (header.size() % 4 != 0) {
+        header += ' ';
+    }
+    std::vector<uint8_t> glb;
+    auto append = [&glb](const uint32_t value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        glb.insert(glb.end(), bytes, bytes + sizeof(value));
+    };
+    append(0x46546C67); // "glTF"
+    append(2);
+    append(static_cast<uint32_t>(12 + 8 + header.size() + 8 + bin.size()));
+    append(static_cast<uint32_t>(header.size()));
+    append(0x4E4F534A); // "JSON"
+    glb.insert(glb.end(), header.begin(), header.end());
+    append(static_cast<uint32_t>(bin.size()));
+    append(0x004E4942); // "BIN"
+    glb.insert(glb.end(), bin.begin(), bin.end());
+    return glb;
+}
+
+GLsizeiptr GetIndexStoreSize(const GlGeometry& geo) {
+    GLsizeiptr size = 0;
+    GLenum usage = 0;
+    HOST_CHECK(ovrNullGl::GetBufferStore(geo.indexBuffer, size, usage));
+    return size;
+}
+
+// The index type, count and store of geo are those of width x height grid indices of indexSize.
+void CheckGridIndices(
+    const GlGeometry& geo,
+    const int width,
+    const int height,
+    const GLenum indexType,
+    const int indexSize) {
+    const int numIndices = (width - 1) * (height - 1) * 6;
+    HOST_CHECK_EQ(geo.indexType, indexType);
+    HOST_CHECK_EQ(geo.vertexCount, width * height);
+    HOST_CHECK_EQ(geo.indexCount, numIndices);
+    HOST_CHECK_EQ(GetIndexStoreSize(geo), static_cast<GLsizeiptr>(numIndices) * indexSize);
+}
+
+const GlGeometry* GetSurfaceGeometry(const ModelFile* model) {
+    HOST_CHECK(model != nullptr);
+    if (model == nullptr || model->Models.empty() || model->Models[0].surfaces.empty()) {
+        HOST_CHECK(model == nullptr);
+        return nullptr;
+    }
+    return &model->Models[0].surfaces[0].surfaceDef.geo;
+}
+
+ModelFile* LoadGlb(
+    const std::vector<uint8_t>& glb,
+    const ModelGlPrograms& programs,
+    const ModelLoadContext& context = ModelLoadContext()) {
+    return LoadModelFileFromMemory(
+        "grid.glb",
+        glb.data(),
+        static_cast<int>(glb.size()),
+        programs,
+        MaterialParms(),
+        nullptr,
+        context);
+}
+
+// Loads glb with its geometry recorded on uploads, then uploads it.
+ModelFile* LoadGlbUploaded(const std::vector<uint8_t>& glb, const ModelGlPrograms& programs) {
+    ModelGpuUploads uploads;
+    ModelLoadContext context;
+    context.Uploads = &uploads;
+    ModelFile* model = LoadGlb(glb, programs, context);
+    if (model != nullptr) {
+        while (!uploads.UploadNext(*model)) {
+        }
+    }
+    return model;
+}
+
+// Loads glb through a cache on cachePath.
+ModelFile* LoadGlbCached(
+    const std::vector<uint8_t>& glb,
+    const ModelGlPrograms& programs,
+    const char* cachePath,
+    bool& wasCooked) {
+    ModelGeometryCache cache;
+    cache.Open(
+        cachePath,
+        ModelGeometryCache::HashContent(glb.data(), glb.size()),
+        ModelGeometryCache::GetGeometryOptions(MaterialParms()));
+    wasCooked = cache.IsCooked();
+    ModelLoadContext context;
+    context.Cache = &cache;
+    ModelFile* model = LoadGlb(glb, programs, context);
+    cache.Finish(model != nullptr);
+    return model;
+}
+
+} // namespace
+
+int main(int, char**) {
+    ovrHostGui gui;
+    GlProgram program;
+    const ModelGlPrograms programs(&program);
+
+    VertexAttribs small;
+    std::vector<TriangleIndex32> smallIndices;
+    MakeGrid(SMALL_WIDTH, SMALL_HEIGHT, small, smallIndices);
+    VertexAttribs large;
+    std::vector<TriangleIndex32> largeIndices;
+    MakeGrid(LARGE_WIDTH, LARGE_HEIGHT, large, largeIndices);
+    HOST_CHECK(large.position.size() > static_cast<size_t>(GlGeometry::GetMaxGeometryVertices()));
+
+    // 32 bit indices are narrowed if the vertices fit, and kept if they don't
+    GlGeometry geo;
+    geo.Create(small, smallIndices);
+    CheckGridIndices(geo, SMALL_WIDTH, SMALL_HEIGHT, GL_UNSIGNED_SHORT, 2);
+    geo.Free();
+    geo.Create(large, largeIndices);
+    CheckGridIndices(geo, LARGE_WIDTH, LARGE_HEIGHT, GL_UNSIGNED_INT, 4);
+
+    // all of the large grid is drawn
+    ovrNullGl::ResetStats();
+    glDrawElements(GL_TRIANGLES, geo.indexCount, geo.indexType, nullptr);
+    HOST_CHECK_EQ(ovrNullGl::GetStats().IndicesDrawn, static_cast<int64_t>(largeIndices.size()));
+    geo.Free();
+
+    // the uploads narrow the same way, and tell the index type before anything is created
+    {
+        ModelFile model;
+        model.Models.resize(2);
+        model.Models[0].surfaces.resize(1);
+        model.Models[1].surfaces.resize(1);
+        GlGeometry& smallGeo = model.Models[0].surfaces[0].surfaceDef.geo;
+        GlGeometry& largeGeo = model.Models[1].surfaces[0].surfaceDef.geo;
+        ModelGpuUploads uploads;
+        uploads.CreateGeometry(smallGeo, small, smallIndices, GlVertexFormat());
+        uploads.CreateGeometry(largeGeo, large, largeIndices, GlVertexFormat());
+        HOST_CHECK_EQ(smallGeo.indexType, static_cast<unsigned>(GL_UNSIGNED_SHORT));
+        HOST_CHECK_EQ(largeGeo.indexType, static_cast<unsigned>(GL_UNSIGNED_INT));
+        while (!uploads.UploadNext(model)) {
+        }
+        CheckGridIndices(smallGeo, SMALL_WIDTH, SMALL_HEIGHT, GL_UNSIGNED_SHORT, 2);
+        CheckGridIndices(largeGeo, LARGE_WIDTH, LARGE_HEIGHT, GL_UNSIGNED_INT, 4);
+    }
+
+    // glTF indices of any width end up 16 bit on a small grid
+    const GLenum componentTypes[] = {COMPONENT_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT};
+    for (const GLenum componentType : componentTypes) {
+        const std::vector<uint8_t> glb = MakeGridGlb(SMALL_WIDTH, SMALL_HEIGHT, componentType);
+        ModelFile* model = LoadGlb(glb, programs);
+        const GlGeometry* gridGeo = GetSurfaceGeometry(model);
+        if (gridGeo != nullptr) {
+            CheckGridIndices(*gridGeo, SMALL_WIDTH, SMALL_HEIGHT, GL_UNSIGNED_SHORT, 2);
+        }
+        delete model;
+    }
+
+    // and stay 32 bit on a large one, loaded directly, through the uploads and cooked
+    const std::vector<uint8_t> largeGlb =
+        MakeGridGlb(LARGE_WIDTH, LARGE_HEIGHT, COMPONENT_UNSIGNED_INT);
+    ModelFile* model = LoadGlb(largeGlb, programs);
+    const GlGeometry* gridGeo = GetSurfaceGeometry(model);
+    if (gridGeo != nullptr) {
+        CheckGridIndices(*gridGeo, LARGE_WIDTH, LARGE_HEIGHT, GL_UNSIGNED_INT, 4);
+    }
+    delete model;
+
+    model = LoadGlbUploaded(largeGlb, programs);
+    gridGeo = GetSurfaceGeometry(model);
+    if (gridGeo != nullptr) {
+        CheckGridIndices(*gridGeo, LARGE_WIDTH, LARGE_HEIGHT, GL_UNSIGNED_INT, 4);
+    }
+    delete model;
+
+    const char* const cachePath = "IndexWidthTest.grid.cooked";
+    remove(cachePath);
+    for (int pass = 0; pass < 2; pass++) {
+        bool wasCooked = false;
+        model = LoadGlbCached(largeGlb, programs, cachePath, wasCooked);
+        HOST_CHECK_EQ(wasCooked, pass == 1);
+        gridGeo = GetSurfaceGeometry(model);
+        if (gridGeo != nullptr) {
+            CheckGridIndices(*gridGeo, LARGE_WIDTH, LARGE_HEIGHT, GL_UNSIGNED_INT, 4);
+        }
+        delete model;
+    }
+    remove(cachePath);
+
+    return HOST_TEST_RESULT();
+}
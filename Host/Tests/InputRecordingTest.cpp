@@ -0,0 +1,198 @@
+/************************************************************************************
+
+Filename    :   InputRecordingTest.cpp
+Content     :   Records input snapshots from the stand-in VrApi, reads them back, and checks
+                that damaged recordings and failing storage are handled
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "HostVrApi.h"
+#include "Input/InputRecording.h"
+#include "Input/InputSnapshot.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+const char* const RECORDING_PATH = "InputRecordingTest.rec";
+const int FILE_HEADER_SIZE = 12;
+const int CHUNK_HEADER_SIZE = 24;
+
+std::vector<uint8_t> ReadAll(const char* path) {
+    std::vector<uint8_t> data;
+    FILE* f = fopen(path, "rb");
+    if (f != nullptr) {
+        for (int c = fgetc(f); c != EOF; c = fgetc(f)) {
+            data.push_back(static_cast<uint8_t>(c));
+        }
+        fclose(f);
+    }
+    return data;
+}
+
+void WriteAll(const char* path, const std::vector<uint8_t>& data) {
+    FILE* f = fopen(path, "wb");
+    if (f != nullptr) {
+        fwrite(data.data(), 1, data.size(), f);
+        fclose(f);
+    }
+}
+
+void Put32(uint8_t* p, const uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<uint8_t>(v >> (i * 8));
+    }
+}
+
+// Records frames of the synthetic remotes as ovrAppl does, and returns them.
+std::vector<ovrInputFrameRecord> RecordFrames(const int count, const bool compress) {
+    ovrModeParms parms = {};
+    ovrMobile* ovr = vrapi_EnterVrMode(&parms);
+    const ovrJava java = {};
+    ovrInputSnapshot snapshot;
+    ovrInputRecordWriter writer;
+    HOST_CHECK(writer.Open(RECORDING_PATH, sizeof(ovrInputFrameRecord), compress));
+
+    std::vector<ovrInputFrameRecord> frames(count);
+    std::vector<double> appendMicros;
+    for (int i = 0; i < count; i++) {
+        const double displayTime = 1.0 + i / 72.0;
+        snapshot.Capture(ovr, &java, displayTime);
+        snapshot.Save(frames[i]);
+        frames[i].HeadTracking = vrapi_GetPredictedTracking2(ovr, displayTime);
+        const double start = HostTestSeconds();
+        HOST_CHECK(writer.Append(&frames[i]));
+        appendMicros.push_back((HostTestSeconds() - start) * 1e6);
+    }
+    HOST_CHECK_EQ(writer.GetNumRecords(), count);
+    writer.Close();
+    HOST_CHECK(!writer.IsOpen());
+    vrapi_LeaveVrMode(ovr);
+
+    // a full chunk only costs the frame loop a hand-over; the writer thread compresses it
+    std::sort(appendMicros.begin(), appendMicros.end());
+    printf(
+        "%s: %d frames of %zu bytes in %zu bytes, append p50 %.2f us, max %.1f us\n",
+        compress ? "compressed" : "raw",
+        count,
+        sizeof(ovrInputFrameRecord),
+        ReadAll(RECORDING_PATH).size(),
+        appendMicros[appendMicros.size() / 2],
+        appendMicros.back());
+    return frames;
+}
+
+void CheckPlayback(const std::vector<ovrInputFrameRecord>& frames) {
+    ovrInputRecordReader reader;
+    HOST_CHECK(reader.Open(RECORDING_PATH, sizeof(ovrInputFrameRecord)));
+    HOST_CHECK_EQ(reader.GetNumRecords(), static_cast<int>(frames.size()));
+    int numDifferent = 0;
+    ovrInputSnapshot snapshot;
+    ovrInputFrameRecord record;
+    for (int i = 0; i < reader.GetNumRecords(); i++) {
+        const void* data = reader.GetRecord(i);
+        if (data == nullptr || memcmp(data, &frames[i], sizeof(record)) != 0) {
+            numDifferent++;
+            continue;
+        }
+        memcpy(&record, data, sizeof(record));
+        snapshot.Restore(record, 100.0 + i);
+    }
+    HOST_CHECK_EQ(numDifferent, 0);
+    HOST_CHECK(reader.GetRecord(reader.GetNumRecords()) == nullptr);
+
+    // the restored snapshot reads like a captured one
+    const ovrInputFrameRecord& last = frames.back();
+    HOST_CHECK_EQ(snapshot.GetNumDevices(), last.NumDevices);
+    HOST_CHECK_EQ(snapshot.GetDisplayTime(), 100.0 + frames.size() - 1);
+    HOST_CHECK_EQ(snapshot.GetDeviceChangeCount(), 2u);
+    const ovrInputDeviceSnapshot* right = snapshot.FindRemote(false);
+    HOST_CHECK(right != nullptr && right->StateValid && right->TrackingValid);
+    if (right != nullptr) {
+        HOST_CHECK_EQ(right->RemoteState.IndexTrigger, last.Devices[1].RemoteState.IndexTrigger);
+    }
+}
+
+} // namespace
+
+int main(int, char**) {
+    // frames with two remotes, in full chunks and a partial one
+    const int count = 5 * ovrInputRecordWriter::RECORDS_PER_CHUNK + 7;
+    for (const bool compress : {false, true}) {
+        CheckPlayback(RecordFrames(count, compress));
+    }
+
+    // a recording cut short loses only the chunk that was being written
+    std::vector<uint8_t> file = ReadAll(RECORDING_PATH);
+    file.resize(file.size() - 10);
+    WriteAll(RECORDING_PATH, file);
+    {
+        ovrInputRecordReader reader;
+        HOST_CHECK(reader.Open(RECORDING_PATH, sizeof(ovrInputFrameRecord)));
+        HOST_CHECK_EQ(reader.GetNumRecords(), count - 7);
+        // a recording made with a different record layout is refused
+        HOST_CHECK(!reader.Open(RECORDING_PATH, sizeof(ovrInputFrameRecord) + 8));
+        HOST_CHECK(!reader.Open("InputRecordingTest.missing", sizeof(ovrInputFrameRecord)));
+    }
+
+    // a corrupt record count whose 32 bit product with the record size wraps around to the raw
+    // size must not pass as valid
+    {
+        const uint32_t recordSize = 16;
+        ovrInputRecordWriter writer;
+        HOST_CHECK(writer.Open(RECORDING_PATH, recordSize, false));
+        uint8_t record[recordSize] = {};
+        for (int i = 0; i < 4; i++) {
+            record[0] = static_cast<uint8_t>(i);
+            HOST_CHECK(writer.Append(record));
+        }
+        writer.Close();
+        file = ReadAll(RECORDING_PATH);
+        ovrInputRecordReader reader;
+        HOST_CHECK(reader.Open(RECORDING_PATH, recordSize));
+        HOST_CHECK_EQ(reader.GetNumRecords(), 4);
+        reader.Close();
+        Put32(&file[FILE_HEADER_SIZE + 8], 4 + (1u << 28));
+        WriteAll(RECORDING_PATH, file);
+        HOST_CHECK(reader.Open(RECORDING_PATH, recordSize));
+        HOST_CHECK_EQ(reader.GetNumRecords(), 0);
+        HOST_CHECK(reader.GetRecord(4) == nullptr);
+        // and neither does a damaged chunk
+        Put32(&file[FILE_HEADER_SIZE + 8], 4);
+        file[FILE_HEADER_SIZE + CHUNK_HEADER_SIZE] ^= 1;
+        WriteAll(RECORDING_PATH, file);
+        HOST_CHECK(reader.Open(RECORDING_PATH, recordSize));
+        HOST_CHECK_EQ(reader.GetNumRecords(), 4);
+        HOST_CHECK(reader.GetRecord(0) == nullptr);
+    }
+
+    // storage that fails stops the recording instead of blocking the frame loop
+    if (access("/dev/full", W_OK) == 0) {
+        ovrInputRecordWriter writer;
+        HOST_CHECK(writer.Open("/dev/full", 64, true));
+        uint8_t record[64] = {};
+        bool failed = false;
+        for (int i = 0; i < 1000 && !failed; i++) {
+            failed = !writer.Append(record) || !writer.Flush();
+        }
+        HOST_CHECK(failed);
+        HOST_CHECK(!writer.IsOpen());
+        HOST_CHECK(!writer.Append(record));
+    }
+
+    unlink(RECORDING_PATH);
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,155 @@
+/************************************************************************************
+
+Filename    :   InputSnapshotTest.cpp
+Content     :   Captures input snapshots from the stand-in VrApi and checks what is read, how
+                often VrApi is asked, and how connects and disconnects are followed
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "HostVrApi.h"
+#include "Input/InputSnapshot.h"
+
+#include <stdio.h>
+
+using namespace OVRFW;
+
+namespace {
+
+// Remotes that say in their pose when they were sampled, with the right one holding A down
+// and the left one connected only while LeftConnected is set.
+bool LeftConnected = true;
+
+void ScriptedTracking(const double timeInSeconds, ovrHostTracking& tracking) {
+    tracking.HeadPose.Orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+    tracking.HeadPose.Position = {0.0f, 1.6f, 0.0f};
+    for (int hand = 0; hand < 2; hand++) {
+        ovrHostRemote& remote = tracking.Remotes[hand];
+        remote.Pose.Orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+        remote.Pose.Position = {static_cast<float>(timeInSeconds), hand * 1.0f, 0.0f};
+        remote.IndexTrigger = hand == 0 ? 0.25f : 0.75f;
+        remote.Buttons = hand == 0 ? 0u : static_cast<uint32_t>(ovrButton_A);
+    }
+    tracking.Remotes[0].Connected = LeftConnected;
+}
+
+} // namespace
+
+int main(int, char**) {
+    ovrHostVrApi::SetTrackingSource(ScriptedTracking);
+    ovrHostVrApi::SetRemoteCount(2);
+    ovrModeParms parms = {};
+    ovrMobile* ovr = vrapi_EnterVrMode(&parms);
+    const ovrJava java = {};
+    const ovrDeviceID leftID = ovrHostVrApi::GetRemoteDeviceID(0);
+    const ovrDeviceID rightID = ovrHostVrApi::GetRemoteDeviceID(1);
+
+    // everything about both remotes, with tracking predicted to the display time
+    ovrInputSnapshot snapshot;
+    ovrHostVrApi::ResetStats();
+    snapshot.Capture(ovr, &java, 10.0);
+    HOST_CHECK_EQ(snapshot.GetNumDevices(), 2);
+    HOST_CHECK_EQ(snapshot.GetDisplayTime(), 10.0);
+    HOST_CHECK_EQ(snapshot.GetDominantHand(), VRAPI_HAND_RIGHT);
+    HOST_CHECK_EQ(snapshot.GetActiveInputDeviceID(), rightID);
+    HOST_CHECK_EQ(snapshot.GetDeviceChangeCount(), 2u);
+    const ovrInputDeviceSnapshot* left = snapshot.FindRemote(true);
+    const ovrInputDeviceSnapshot* right = snapshot.FindRemote(false);
+    HOST_CHECK(left != nullptr && right != nullptr);
+    if (left == nullptr || right == nullptr) {
+        return HOST_TEST_RESULT();
+    }
+    HOST_CHECK_EQ(left->Header.DeviceID, leftID);
+    HOST_CHECK_EQ(right->Header.DeviceID, rightID);
+    HOST_CHECK(snapshot.FindDevice(rightID) == right);
+    HOST_CHECK(snapshot.FindDevice(0x999) == nullptr);
+    HOST_CHECK(left->CapsValid && left->StateValid && left->TrackingValid);
+    HOST_CHECK(left->IsLeftHand() && !right->IsLeftHand());
+    HOST_CHECK(right->RemoteCaps.HapticSamplesMax > 0);
+    HOST_CHECK_EQ(left->RemoteState.IndexTrigger, 0.25f);
+    HOST_CHECK_EQ(right->RemoteState.IndexTrigger, 0.75f);
+    HOST_CHECK_EQ(right->RemoteState.Buttons, static_cast<uint32_t>(ovrButton_A));
+    HOST_CHECK_EQ(left->Tracking.HeadPose.TimeInSeconds, 10.0);
+    HOST_CHECK_EQ(left->Tracking.HeadPose.Pose.Position.x, 10.0f);
+    HOST_CHECK_EQ(right->Tracking.HeadPose.Pose.Position.y, 1.0f);
+
+    // one enumeration pass, one state and one tracking read per remote, and the capabilities
+    // only the first time a device is seen
+    ovrHostVrApiStats stats = ovrHostVrApi::GetStats();
+    HOST_CHECK_EQ(stats.EnumerateCalls, 3); // two devices and the end of the list
+    HOST_CHECK_EQ(stats.CapabilityCalls, 2);
+    HOST_CHECK_EQ(stats.InputStateCalls, 2);
+    HOST_CHECK_EQ(stats.InputTrackingCalls, 2);
+    const int frames = 100;
+    for (int i = 0; i < frames; i++) {
+        snapshot.Capture(ovr, &java, 11.0 + i);
+    }
+    stats = ovrHostVrApi::GetStats();
+    HOST_CHECK_EQ(stats.EnumerateCalls, 3 * (frames + 1));
+    HOST_CHECK_EQ(stats.CapabilityCalls, 2);
+    HOST_CHECK_EQ(stats.InputStateCalls, 2 * (frames + 1));
+    HOST_CHECK_EQ(stats.InputTrackingCalls, 2 * (frames + 1));
+    HOST_CHECK_EQ(snapshot.GetDeviceChangeCount(), 2u);
+    printf(
+        "%d frames: %d VrApi input calls, %.1f per frame\n",
+        frames + 1,
+        stats.EnumerateCalls + stats.CapabilityCalls + stats.InputStateCalls +
+            stats.InputTrackingCalls,
+        static_cast<double>(
+            stats.EnumerateCalls + stats.CapabilityCalls + stats.InputStateCalls +
+            stats.InputTrackingCalls) /
+            (frames + 1));
+
+    // a remote that is enumerated but not reporting stays, without state or tracking
+    LeftConnected = false;
+    snapshot.Capture(ovr, &java, 200.0);
+    left = snapshot.FindRemote(true);
+    HOST_CHECK(left != nullptr);
+    HOST_CHECK(left != nullptr && left->CapsValid && !left->StateValid && !left->TrackingValid);
+    HOST_CHECK(snapshot.FindRemote(false)->StateValid);
+    HOST_CHECK_EQ(snapshot.GetDeviceChangeCount(), 2u);
+    LeftConnected = true;
+
+    // a remote that leaves the enumeration is dropped, and queried again when it comes back
+    ovrHostVrApi::ResetStats();
+    ovrHostVrApi::SetRemoteCount(1);
+    snapshot.Capture(ovr, &java, 201.0);
+    HOST_CHECK_EQ(snapshot.GetNumDevices(), 1);
+    HOST_CHECK(snapshot.FindDevice(rightID) == nullptr);
+    HOST_CHECK(snapshot.FindRemote(false) == nullptr);
+    HOST_CHECK(snapshot.FindRemote(true) != nullptr);
+    HOST_CHECK_EQ(snapshot.GetDeviceChangeCount(), 3u);
+    ovrHostVrApi::SetRemoteCount(2);
+    snapshot.Capture(ovr, &java, 202.0);
+    HOST_CHECK_EQ(snapshot.GetNumDevices(), 2);
+    HOST_CHECK_EQ(snapshot.GetDeviceChangeCount(), 4u);
+    right = snapshot.FindRemote(false);
+    HOST_CHECK(right != nullptr && right->CapsValid && right->StateValid);
+    HOST_CHECK_EQ(ovrHostVrApi::GetStats().CapabilityCalls, 1);
+
+    // no remotes at all
+    ovrHostVrApi::SetRemoteCount(0);
+    snapshot.Capture(ovr, &java, 203.0);
+    HOST_CHECK_EQ(snapshot.GetNumDevices(), 0);
+    HOST_CHECK(snapshot.FindRemote(true) == nullptr);
+    HOST_CHECK_EQ(snapshot.GetDeviceChangeCount(), 6u);
+
+    // after a reset every device's capabilities are read again
+    ovrHostVrApi::SetRemoteCount(2);
+    snapshot.Capture(ovr, &java, 204.0);
+    ovrHostVrApi::ResetStats();
+    snapshot.Reset();
+    HOST_CHECK_EQ(snapshot.GetNumDevices(), 0);
+    snapshot.Capture(ovr, &java, 205.0);
+    HOST_CHECK_EQ(snapshot.GetNumDevices(), 2);
+    HOST_CHECK_EQ(ovrHostVrApi::GetStats().CapabilityCalls, 2);
+
+    vrapi_LeaveVrMode(ovr);
+    ovrHostVrApi::SetTrackingSource(nullptr);
+    return HOST_TEST_RESULT();
+}
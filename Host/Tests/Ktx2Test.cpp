@@ -0,0 +1,206 @@
+/************************************************************************************
+
+Filename    :   Ktx2Test.cpp
+Content     :   Loads KTX2 files with zstd supercompressed levels, and checks that damaged ones and
+                Basis Universal payloads fail cleanly
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostGui.h"
+#include "NullGl.h"
+
+#include "Render/GlTexture.h"
+
+#include <string.h>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+const int SIZE = 16;
+const int NUM_LEVELS = 5;
+const uint32_t VK_FORMAT_R8G8B8A8_UNORM = 37;
+const uint32_t SUPERCOMPRESSION_ZSTD = 2;
+
+typedef std::vector<std::vector<uint8_t>> Levels;
+typedef std::vector<size_t> Sizes;
+
+// Level 0 of the test texture, compressed by the zstd command line tool at level 19. It has
+// Huffman coded literals, matches and a content checksum.
+const uint8_t LEVEL0_ZSTD[] = {
+    0x28, 0xB5, 0x2F, 0xFD, 0x64, 0x00, 0x03, 0x75, 0x02, 0x00, 0xD2, 0x47, 0x10, 0x12, 0xD0,
+    0x67, 0x0D, 0x94, 0x2E, 0x97, 0xEB, 0x72, 0x5D, 0x0E, 0x15, 0x93, 0xEB, 0x72, 0xB9, 0x2E,
+    0x57, 0x64, 0x9B, 0x65, 0x76, 0x59, 0x65, 0x93, 0x45, 0xF6, 0xD8, 0xD6, 0xD8, 0x62, 0x89,
+    0x1D, 0x56, 0xD8, 0x60, 0x81, 0xDD, 0x69, 0x76, 0x98, 0x9D, 0x65, 0x47, 0xD9, 0x49, 0x76,
+    0x90, 0x9D, 0x63, 0xA7, 0x1D, 0x63, 0xA7, 0xD8, 0x21, 0x76, 0x86, 0x1D, 0x61, 0x27, 0xD8,
+    0x01, 0x76, 0x4E, 0x02, 0x00, 0xFD, 0x0B, 0x2A, 0x00, 0xBE, 0x83, 0x1A, 0xCE, 0xC9, 0x74,
+    0x6E, 0x9B};
+
+// The texels of a level: level 0 is what LEVEL0_ZSTD holds, the smaller levels are anything.
+std::vector<uint8_t> MakeLevel(const int level) {
+    const int size = SIZE >> level;
+    std::vector<uint8_t> texels;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            const uint8_t pixel[4] = {
+                static_cast<uint8_t>(x * 16),
+                static_cast<uint8_t>((level == 0) ? ((y < 8) ? 0 : 255) : level * 40 + y),
+                128,
+                255};
+            texels.insert(texels.end(), pixel, pixel + 4);
+        }
+    }
+    return texels;
+}
+
+template <typename _type_>
+void Append(std::vector<uint8_t>& out, const _type_ value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+// A zstd frame with the data in one stored block, as a compressor writes incompressible data.
+std::vector<uint8_t> MakeStoredZstdFrame(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> frame;
+    Append(frame, uint32_t(0xFD2FB528));
+    // single segment, with a 1 or 2 byte content size
+    if (data.size() < 256) {
+        frame.push_back(0x20);
+        frame.push_back(static_cast<uint8_t>(data.size()));
+    } else {
+        frame.push_back(0x60);
+        Append(frame, static_cast<uint16_t>(data.size() - 256));
+    }
+    // last block, raw
+    const uint32_t blockHeader = static_cast<uint32_t>(data.size() << 3) | 1;
+    frame.push_back(static_cast<uint8_t>(blockHeader));
+    frame.push_back(static_cast<uint8_t>(blockHeader >> 8));
+    frame.push_back(static_cast<uint8_t>(blockHeader >> 16));
+    frame.insert(frame.end(), data.begin(), data.end());
+    return frame;
+}
+
+// A 2D KTX2 file with the levels as given, stored smallest first as the format has them.
+std::vector<uint8_t> MakeKtx2(
+    const uint32_t vkFormat,
+    const uint32_t supercompression,
+    const Levels& levels,
+    const Sizes& uncompressedSizes) {
+    const int numLevels = static_cast<int>(levels.size());
+    std::vector<uint8_t> ktx2 = {
+        0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+    const uint32_t header[] = {
+        vkFormat,
+        1, // typeSize
+        SIZE,
+        SIZE,
+        0, // pixelDepth
+        0, // layerCount
+        1, // faceCount
+        static_cast<uint32_t>(numLevels),
+        supercompression,
+        0, // dfd
+        0,
+        0, // kvd
+        0};
+    for (const uint32_t value : header) {
+        Append(ktx2, value);
+    }
+    Append(ktx2, uint64_t(0)); // sgd
+    Append(ktx2, uint64_t(0));
+
+    uint64_t offset = ktx2.size() + numLevels * 3 * sizeof(uint64_t);
+    std::vector<uint64_t> offsets(numLevels);
+    for (int i = numLevels - 1; i >= 0; i--) {
+        offsets[i] = offset;
+        offset += levels[i].size();
+    }
+    for (int i = 0; i < numLevels; i++) {
+        Append(ktx2, offsets[i]);
+        Append(ktx2, uint64_t(levels[i].size()));
+        Append(ktx2, uint64_t(uncompressedSizes[i]));
+    }
+    for (int i = numLevels - 1; i >= 0; i--) {
+        ktx2.insert(ktx2.end(), levels[i].begin(), levels[i].end());
+    }
+    return ktx2;
+}
+
+// The test texture with every level zstd supercompressed, the damage function applied to the
+// compressed levels and sizes.
+template <typename _damage_>
+std::vector<uint8_t> MakeZstdKtx2(const _damage_& damage) {
+    Levels levels;
+    Sizes uncompressedSizes;
+    for (int i = 0; i < NUM_LEVELS; i++) {
+        const std::vector<uint8_t> texels = MakeLevel(i);
+        levels.push_back(
+            (i == 0) ? std::vector<uint8_t>(LEVEL0_ZSTD, LEVEL0_ZSTD + sizeof(LEVEL0_ZSTD))
+                     : MakeStoredZstdFrame(texels));
+        uncompressedSizes.push_back(texels.size());
+    }
+    damage(levels, uncompressedSizes);
+    return MakeKtx2(VK_FORMAT_R8G8B8A8_UNORM, SUPERCOMPRESSION_ZSTD, levels, uncompressedSizes);
+}
+
+bool Decodes(const std::vector<uint8_t>& ktx2) {
+    ovrDecodedTexture decoded;
+    return DecodeTextureBuffer("test.ktx2", ktx2.data(), ktx2.size(), TextureFlags_t(), decoded);
+}
+
+} // namespace
+
+int main(int, char**) {
+    ovrHostGui gui;
+
+    // every level comes back as it was before it was compressed
+    const std::vector<uint8_t> ktx2 = MakeZstdKtx2([](Levels&, Sizes&) {});
+    ovrDecodedTexture decoded;
+    HOST_CHECK(
+        DecodeTextureBuffer("test.ktx2", ktx2.data(), ktx2.size(), TextureFlags_t(), decoded));
+    HOST_CHECK_EQ(decoded.Width, SIZE);
+    HOST_CHECK_EQ(decoded.NumLevels, NUM_LEVELS);
+    HOST_CHECK_EQ(decoded.Format, Texture_RGBA);
+    if (decoded.Pixels != nullptr && decoded.NumLevels == NUM_LEVELS) {
+        const uint8_t* level = decoded.Pixels;
+        for (int i = 0; i < NUM_LEVELS; i++) {
+            const std::vector<uint8_t> texels = MakeLevel(i);
+            HOST_CHECK(memcmp(level, texels.data(), texels.size()) == 0);
+            level += texels.size();
+        }
+    }
+
+    // and the synchronous load uploads all of them
+    ovrNullGl::ResetStats();
+    int width = 0;
+    int height = 0;
+    GlTexture texture = LoadTextureFromBuffer(
+        "test.ktx2", ktx2.data(), ktx2.size(), TextureFlags_t(), width, height);
+    HOST_CHECK(texture.texture != 0);
+    HOST_CHECK_EQ(width, SIZE);
+    HOST_CHECK_EQ(ovrNullGl::GetStats().TextureUploads, NUM_LEVELS);
+    DeleteTexture(texture);
+
+    // a wrong checksum, a cut off frame or a wrong size fail the load
+    HOST_CHECK(!Decodes(MakeZstdKtx2([](Levels& levels, Sizes&) { levels[0].back() ^= 1; })));
+    HOST_CHECK(!Decodes(MakeZstdKtx2([](Levels& levels, Sizes&) { levels[0].pop_back(); })));
+    HOST_CHECK(!Decodes(MakeZstdKtx2([](Levels& levels, Sizes&) { levels[2].pop_back(); })));
+    HOST_CHECK(!Decodes(MakeZstdKtx2([](Levels&, Sizes& sizes) { sizes[1] *= 2; })));
+
+    // a Basis Universal payload is not supported, so the default texture is used
+    const std::vector<uint8_t> basis = MakeKtx2(0, SUPERCOMPRESSION_ZSTD, Levels(1, {0, 0}), {2});
+    HOST_CHECK(!Decodes(basis));
+    texture = LoadTextureFromBuffer(
+        "basis.ktx2", basis.data(), basis.size(), TextureFlags_t(), width, height);
+    HOST_CHECK(texture.texture != 0);
+    HOST_CHECK_EQ(texture.Width, 8);
+    DeleteTexture(texture);
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,188 @@
+/************************************************************************************
+
+Filename    :   MenuSubmitBenchmark.cpp
+Content     :   Times submitting a 2000 object menu tree, static and with objects moving
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostGui.h"
+
+#include "GUI/VRMenuMgr.h"
+#include "GUI/VRMenuObject.h"
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace OVRFW;
+using OVR::Matrix4f;
+using OVR::Posef;
+using OVR::Quatf;
+using OVR::Vector3f;
+
+// Surfaces may only be changed through the SetSurface* methods, which keep the caches valid.
+static_assert(
+    std::is_const<std::remove_reference<
+        decltype(std::declval<VRMenuObject&>().GetSurface(0))>::type>::value,
+    "VRMenuObject::GetSurface must not hand out a mutable surface");
+
+namespace {
+
+const int GROUP_COUNT = 40;
+const int ITEMS_PER_GROUP = 50;
+
+menuHandle_t CreateItem(
+    OvrVRMenuMgr& menuMgr,
+    menuHandle_t const parent,
+    GLuint const texture,
+    Vector3f const& position) {
+    VRMenuSurfaceParms surfParms(
+        "item",
+        texture,
+        64,
+        64,
+        SURFACE_TEXTURE_DIFFUSE,
+        0,
+        0,
+        0,
+        SURFACE_TEXTURE_MAX,
+        0,
+        0,
+        0,
+        SURFACE_TEXTURE_MAX);
+    VRMenuObjectParms parms(
+        VRMENU_STATIC,
+        std::vector<VRMenuComponent*>(),
+        surfParms,
+        "",
+        Posef(Quatf(), position),
+        Vector3f(1.0f),
+        VRMenuFontParms(),
+        VRMenuId_t(),
+        VRMenuObjectFlags_t(),
+        VRMenuObjectInitFlags_t(VRMENUOBJECT_INIT_FORCE_POSITION));
+    menuHandle_t const handle = menuMgr.CreateObject(parms);
+    if (parent.IsValid()) {
+        menuMgr.ToObject(parent)->AddChild(menuMgr, handle);
+    }
+    return handle;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = HostTestQuick(argc, argv);
+    const int frames = quick ? 10 : 500;
+
+    ovrHostGui gui;
+    OvrVRMenuMgr& menuMgr = gui.GuiSys->GetVRMenuMgr();
+    GLuint const texture = ovrHostGui::CreateTexture(64, 64);
+
+    menuHandle_t const root = CreateItem(menuMgr, menuHandle_t(), texture, Vector3f(0, 0, -3));
+    std::vector<menuHandle_t> items;
+    for (int g = 0; g < GROUP_COUNT; g++) {
+        const Vector3f groupPos((g % 8) * 0.25f - 1.0f, (g / 8) * 0.25f - 0.5f, 0.0f);
+        menuHandle_t const group = CreateItem(menuMgr, root, texture, groupPos);
+        for (int i = 0; i < ITEMS_PER_GROUP; i++) {
+            const Vector3f itemPos((i % 10) * 0.02f, (i / 10) * 0.02f, 0.0f);
+            items.push_back(CreateItem(menuMgr, group, texture, itemPos));
+        }
+    }
+    HOST_CHECK_EQ(items.size(), static_cast<size_t>(GROUP_COUNT * ITEMS_PER_GROUP));
+
+    const Matrix4f view =
+        Matrix4f::LookAtRH(Vector3f(0, 0, 0), Vector3f(0, 0, -1), Vector3f(0, 1, 0));
+    std::vector<ovrDrawSurface> surfaces;
+    auto submitFrame = [&]() {
+        menuMgr.SubmitForRendering(*gui.GuiSys, view, root, Posef(), VRMenuRenderFlags_t());
+        menuMgr.Finish(view);
+        surfaces.clear();
+        menuMgr.AppendSurfaceList(view, surfaces);
+    };
+
+    auto indexCount = [&]() {
+        int count = 0;
+        for (const ovrDrawSurface& surface : surfaces) {
+            count += surface.surface->geo.indexCount;
+        }
+        return count;
+    };
+    auto timeStaticFrames = [&](size_t const expectedSurfaces) {
+        const double start = HostTestSeconds();
+        for (int frame = 0; frame < frames; frame++) {
+            submitFrame();
+            HOST_CHECK_EQ(surfaces.size(), expectedSurfaces);
+        }
+        return HostTestSeconds() - start;
+    };
+
+    // the first frame fills the caches; static frames must then produce the same list, whether
+    // it is built again every frame or the last frame's list is reused
+    menuMgr.SetReuseSurfaceList(false);
+    submitFrame();
+    const size_t surfaceCount = surfaces.size();
+    const int surfaceIndices = indexCount();
+    HOST_CHECK(surfaceCount > 0);
+    const double uncachedStaticSeconds = timeStaticFrames(surfaceCount);
+
+    menuMgr.SetReuseSurfaceList(true);
+    submitFrame();
+    const std::vector<ovrDrawSurface> builtSurfaces = surfaces;
+    const double staticSeconds = timeStaticFrames(surfaceCount);
+    HOST_CHECK_EQ(surfaces.size(), builtSurfaces.size());
+    for (size_t i = 0; i < surfaces.size() && i < builtSurfaces.size(); i++) {
+        HOST_CHECK(surfaces[i].surface == builtSurfaces[i].surface);
+        HOST_CHECK(surfaces[i].modelMatrix == builtSurfaces[i].modelMatrix);
+    }
+    HOST_CHECK(staticSeconds < uncachedStaticSeconds);
+
+    // hiding one item must not leave it in the reused list, and showing it again must restore it
+    VRMenuObject* first = menuMgr.ToObject(items.front());
+    first->SetVisible(false);
+    submitFrame();
+    HOST_CHECK(indexCount() < surfaceIndices);
+    first->SetVisible(true);
+    submitFrame();
+    HOST_CHECK_EQ(indexCount(), surfaceIndices);
+
+    // move a tenth of the items every frame, so their transforms and groups' bounds go stale
+    const int movedPerFrame = static_cast<int>(items.size()) / 10;
+    const double start = HostTestSeconds();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int i = 0; i < movedPerFrame; i++) {
+            const size_t index = (static_cast<size_t>(frame) * movedPerFrame + i) % items.size();
+            VRMenuObject* obj = menuMgr.ToObject(items[index]);
+            const Vector3f pos = obj->GetLocalPosition();
+            obj->SetLocalPosition(Vector3f(pos.x, pos.y, (frame & 1) ? 0.0f : 0.01f));
+        }
+        submitFrame();
+        HOST_CHECK_EQ(surfaces.size(), surfaceCount);
+    }
+    const double movingSeconds = HostTestSeconds() - start;
+
+    // a change deep in the tree must reach the root's cached cull bounds
+    VRMenuObject* last = menuMgr.ToObject(items.back());
+    const float rootMaxX = menuMgr.ToObject(root)->GetCullBounds().GetMaxs().x;
+    last->SetLocalPosition(Vector3f(10.0f, 0.0f, 0.0f));
+    submitFrame();
+    HOST_CHECK(menuMgr.ToObject(root)->GetCullBounds().GetMaxs().x > rootMaxX + 5.0f);
+
+    printf(
+        "menu submit (%zu objects, %zu surfaces): static %.3f ms (%.3f ms rebuilding the list), "
+        "%d moving %.3f ms\n",
+        items.size() + GROUP_COUNT + 1,
+        surfaceCount,
+        staticSeconds * 1e3 / frames,
+        uncachedStaticSeconds * 1e3 / frames,
+        movedPerFrame,
+        movingSeconds * 1e3 / frames);
+
+    menuMgr.FreeObject(root);
+    glDeleteTextures(1, &texture);
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,157 @@
+/************************************************************************************
+
+Filename    :   MeshOptimizerTest.cpp
+Content     :   Measures the vertex cache miss ratio of a shuffled grid before and after the
+                load time mesh optimization, and checks that the mesh itself is unchanged
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "Model/ModelCache.h"
+#include "Model/ModelDef.h"
+#include "Render/MeshOptimizer.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+using namespace OVRFW;
+using OVR::Vector2f;
+using OVR::Vector3f;
+
+namespace {
+
+const int GRID_SIZE = 100;
+
+// A GRID_SIZE x GRID_SIZE vertex grid, two triangles per cell, in random triangle order.
+void MakeShuffledGrid(VertexAttribs& attribs, std::vector<TriangleIndex32>& indices) {
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            attribs.position.push_back(Vector3f(static_cast<float>(x), static_cast<float>(y), 0));
+            attribs.uv0.push_back(Vector2f(static_cast<float>(x), static_cast<float>(y)));
+        }
+    }
+    std::vector<std::array<TriangleIndex32, 3>> triangles;
+    for (int y = 0; y + 1 < GRID_SIZE; y++) {
+        for (int x = 0; x + 1 < GRID_SIZE; x++) {
+            const TriangleIndex32 i = y * GRID_SIZE + x;
+            triangles.push_back({i, i + 1, i + GRID_SIZE});
+            triangles.push_back({i + GRID_SIZE, i + 1, i + GRID_SIZE + 1});
+        }
+    }
+    std::mt19937 random(1234);
+    std::shuffle(triangles.begin(), triangles.end(), random);
+    for (const std::array<TriangleIndex32, 3>& t : triangles) {
+        indices.insert(indices.end(), t.begin(), t.end());
+    }
+}
+
+// The triangles as positions, each rotated to start at its smallest corner so the winding is
+// kept, in sorted order.
+std::vector<std::array<Vector3f, 3>> GetTriangleSet(
+    const VertexAttribs& attribs,
+    const std::vector<TriangleIndex32>& indices) {
+    auto less = [](const Vector3f& a, const Vector3f& b) {
+        return (a.x != b.x) ? a.x < b.x : (a.y != b.y) ? a.y < b.y : a.z < b.z;
+    };
+    std::vector<std::array<Vector3f, 3>> triangles;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        std::array<Vector3f, 3> t = {
+            attribs.position[indices[i + 0]],
+            attribs.position[indices[i + 1]],
+            attribs.position[indices[i + 2]]};
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end(), less), t.end());
+        triangles.push_back(t);
+    }
+    std::sort(
+        triangles.begin(),
+        triangles.end(),
+        [&less](const std::array<Vector3f, 3>& a, const std::array<Vector3f, 3>& b) {
+            return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), less);
+        });
+    return triangles;
+}
+
+} // namespace
+
+int main(int, char**) {
+    VertexAttribs attribs;
+    std::vector<TriangleIndex32> indices;
+    MakeShuffledGrid(attribs, indices);
+    const int numVertices = static_cast<int>(attribs.position.size());
+    const std::vector<std::array<Vector3f, 3>> sourceTriangles = GetTriangleSet(attribs, indices);
+
+    // in random order almost every triangle misses the cache with all three vertices
+    const ovrVertexCacheStats shuffled = AnalyzeVertexCache(indices, numVertices);
+    HOST_CHECK(shuffled.Acmr > 2.9f);
+
+    std::vector<TriangleIndex32> cacheOrder = indices;
+    OptimizeVertexCache(cacheOrder, numVertices);
+    const ovrVertexCacheStats optimized = AnalyzeVertexCache(cacheOrder, numVertices);
+    HOST_CHECK(optimized.Acmr < 0.75f);
+    HOST_CHECK(optimized.Atvr < 1.5f);
+    HOST_CHECK(GetTriangleSet(attribs, cacheOrder) == sourceTriangles);
+
+    // the overdraw pass keeps the cache efficiency within its threshold
+    std::vector<TriangleIndex32> overdrawOrder = cacheOrder;
+    OptimizeOverdraw(overdrawOrder, attribs.position);
+    const ovrVertexCacheStats overdraw = AnalyzeVertexCache(overdrawOrder, numVertices);
+    HOST_CHECK(overdraw.Acmr <= optimized.Acmr * 1.05f + 1e-6f);
+    HOST_CHECK(GetTriangleSet(attribs, overdrawOrder) == sourceTriangles);
+
+    // the vertex fetch pass numbers the vertices in the order they are first used
+    VertexAttribs fetchAttribs = attribs;
+    std::vector<TriangleIndex32> fetchOrder = cacheOrder;
+    OptimizeVertexFetch(fetchAttribs, fetchOrder);
+    HOST_CHECK_EQ(fetchAttribs.position.size(), attribs.position.size());
+    HOST_CHECK_EQ(fetchAttribs.uv0.size(), attribs.uv0.size());
+    TriangleIndex32 nextNew = 0;
+    for (size_t i = 0; i < fetchOrder.size(); i++) {
+        HOST_CHECK(fetchOrder[i] <= nextNew);
+        nextNew = std::max(nextNew, fetchOrder[i] + 1);
+        // every vertex moved with all of its attributes
+        const Vector3f& p = fetchAttribs.position[fetchOrder[i]];
+        HOST_CHECK(fetchAttribs.uv0[fetchOrder[i]] == Vector2f(p.x, p.y));
+        HOST_CHECK(p == attribs.position[cacheOrder[i]]);
+    }
+    HOST_CHECK(AnalyzeVertexCache(fetchOrder, numVertices).Acmr == optimized.Acmr);
+
+    // all of it together
+    VertexAttribs meshAttribs = attribs;
+    std::vector<TriangleIndex32> meshIndices = indices;
+    OptimizeMesh(meshAttribs, meshIndices, true, "grid");
+    const ovrVertexCacheStats mesh = AnalyzeVertexCache(meshIndices, numVertices);
+    HOST_CHECK(mesh.Acmr < 0.75f);
+    HOST_CHECK(GetTriangleSet(meshAttribs, meshIndices) == sourceTriangles);
+
+    printf(
+        "%dx%d grid: ACMR %.3f shuffled, %.3f optimized, %.3f with overdraw, ATVR %.3f -> %.3f\n",
+        GRID_SIZE,
+        GRID_SIZE,
+        shuffled.Acmr,
+        optimized.Acmr,
+        overdraw.Acmr,
+        shuffled.Atvr,
+        optimized.Atvr);
+
+    // optimized meshes are cooked separately from the source order
+    MaterialParms parms;
+    const uint32_t sourceOptions = ModelGeometryCache::GetGeometryOptions(parms);
+    parms.OptimizeMeshes = true;
+    const uint32_t optimizedOptions = ModelGeometryCache::GetGeometryOptions(parms);
+    parms.Transparent = true;
+    const uint32_t transparentOptions = ModelGeometryCache::GetGeometryOptions(parms);
+    HOST_CHECK(optimizedOptions != sourceOptions);
+    HOST_CHECK(transparentOptions != optimizedOptions);
+    parms.OptimizeMeshes = false;
+    HOST_CHECK_EQ(ModelGeometryCache::GetGeometryOptions(parms), sourceOptions);
+
+    return HOST_TEST_RESULT();
+}
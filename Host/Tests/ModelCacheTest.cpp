@@ -0,0 +1,474 @@
+/************************************************************************************
+
+Filename    :   ModelCacheTest.cpp
+Content     :   Checks that cooked glTF models come back the same as they load from the source
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostGui.h"
+#include "NullGl.h"
+
+#include "Model/ModelCache.h"
+#include "Model/ModelFile.h"
+#include "Render/GlProgram.h"
+
+#include <zip.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace OVRFW;
+using OVR::Matrix4f;
+
+namespace {
+
+const char* const CONTROLLER_URI = "apk:///assets/oculusQuest_oculusTouch_Left.gltf.ovrscene";
+
+// Two quads under a root node, one of them animated, a camera in a second scene, a skin, a
+// textured blended material and a plain one. The image is in a buffer view, which the zip
+// loader replaces with the default texture.
+const char* const SCENE_GLTF = R"({
+  "asset": { "version": "2.0" },
+  "scene": 0,
+  "scenes": [ { "name": "main", "nodes": [ 0 ] }, { "name": "cameras", "nodes": [ 3 ] } ],
+  "nodes": [
+    { "name": "root", "translation": [ 0.0, 1.0, 0.0 ], "children": [ 1, 2 ] },
+    { "name": "quad_a", "mesh": 0, "rotation": [ 0.0, 0.7071068, 0.0, 0.7071068 ] },
+    { "name": "quad_b", "mesh": 1, "scale": [ 2.0, 2.0, 2.0 ], "skin": 0 },
+    { "name": "eye", "camera": 0, "translation": [ 0.0, 0.0, 5.0 ] }
+  ],
+  "cameras": [
+    { "name": "eye", "type": "perspective",
+      "perspective": { "aspectRatio": 1.5, "yfov": 1.0, "znear": 0.1, "zfar": 100.0 } }
+  ],
+  "meshes": [
+    { "name": "quad_a",
+      "primitives": [ { "attributes": { "POSITION": 0 }, "indices": 1, "material": 0 } ] },
+    { "name": "quad_b", "weights": [ 0.25 ],
+      "primitives": [ { "attributes": { "POSITION": 0 }, "indices": 1, "material": 1 },
+                      { "attributes": { "POSITION": 0 }, "indices": 1 } ] }
+  ],
+  "materials": [
+    { "name": "textured", "alphaMode": "BLEND", "doubleSided": true,
+      "pbrMetallicRoughness": { "baseColorTexture": { "index": 0 } } },
+    { "name": "plain", "emissiveFactor": [ 0.5, 0.25, 0.0 ],
+      "pbrMetallicRoughness": { "metallicFactor": 0.5, "roughnessFactor": 0.75 } }
+  ],
+  "textures": [ { "name": "image", "source": 0, "sampler": 0 } ],
+  "samplers": [ { "wrapS": 33071, "wrapT": 33648 } ],
+  "images": [ { "bufferView": 4, "mimeType": "image/png" } ],
+  "animations": [
+    { "name": "move",
+      "samplers": [ { "input": 2, "output": 3 } ],
+      "channels": [ { "sampler": 0, "target": { "node": 1, "path": "translation" } } ] }
+  ],
+  "skins": [ { "name": "skin", "joints": [ 1 ], "inverseBindMatrices": 4 } ],
+  "buffers": [ { "uri": "scene.bin", "byteLength": 160 } ],
+  "bufferViews": [
+    { "buffer": 0, "byteOffset": 0, "byteLength": 48 },
+    { "buffer": 0, "byteOffset": 48, "byteLength": 12 },
+    { "buffer": 0, "byteOffset": 60, "byteLength": 8 },
+    { "buffer": 0, "byteOffset": 68, "byteLength": 24 },
+    { "buffer": 0, "byteOffset": 92, "byteLength": 4 },
+    { "buffer": 0, "byteOffset": 96, "byteLength": 64 }
+  ],
+  "accessors": [
+    { "bufferView": 0, "componentType": 5126, "count": 4, "type": "VEC3",
+      "min": [ 0.0, 0.0, 0.0 ], "max": [ 1.0, 1.0, 0.0 ] },
+    { "bufferView": 1, "componentType": 5123, "count": 6, "type": "SCALAR" },
+    { "bufferView": 2, "componentType": 5126, "count": 2, "type": "SCALAR",
+      "min": [ 0.5 ], "max": [ 2.5 ] },
+    { "bufferView": 3, "componentType": 5126, "count": 2, "type": "VEC3" },
+    { "bufferView": 5, "componentType": 5126, "count": 1, "type": "MAT4" }
+  ]
+})";
+
+std::vector<uint8_t> MakeSceneBin() {
+    std::vector<uint8_t> bin(160, 0);
+    const float positions[12] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0};
+    const uint16_t indices[6] = {0, 1, 2, 2, 1, 3};
+    const float times[2] = {0.5f, 2.5f};
+    const float translations[6] = {0, 0, 0, 0, 3, 0};
+    const Matrix4f inverseBind = Matrix4f::Translation(1.0f, 2.0f, 3.0f).Transposed();
+    memcpy(&bin[0], positions, sizeof(positions));
+    memcpy(&bin[48], indices, sizeof(indices));
+    memcpy(&bin[60], times, sizeof(times));
+    memcpy(&bin[68], translations, sizeof(translations));
+    memcpy(&bin[96], inverseBind.M, sizeof(inverseBind.M));
+    return bin;
+}
+
+bool AddZipEntry(zipFile zip, const char* name, const void* data, const size_t size) {
+    zip_fileinfo info;
+    memset(&info, 0, sizeof(info));
+    return zipOpenNewFileInZip(
+               zip, name, &info, nullptr, 0, nullptr, 0, nullptr, Z_DEFLATED, 6) == ZIP_OK &&
+        zipWriteInFileInZip(zip, data, static_cast<unsigned>(size)) == ZIP_OK &&
+        zipCloseFileInZip(zip) == ZIP_OK;
+}
+
+bool ReadWholeFile(const char* path, std::vector<uint8_t>& buffer) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    buffer.resize(static_cast<size_t>(ftell(f)));
+    fseek(f, 0, SEEK_SET);
+    const bool ok = fread(buffer.data(), 1, buffer.size(), f) == buffer.size();
+    fclose(f);
+    return ok;
+}
+
+// Loads the model through a cache on cachePath, the way the async loader does.
+ModelFile* LoadCached(
+    const char* fileName,
+    const std::vector<uint8_t>& source,
+    const ModelGlPrograms& programs,
+    const char* cachePath,
+    bool& wasCooked,
+    const MaterialParms& materialParms = MaterialParms()) {
+    ModelGeometryCache cache;
+    cache.Open(
+        cachePath,
+        ModelGeometryCache::HashContent(source.data(), source.size()),
+        ModelGeometryCache::GetGeometryOptions(materialParms));
+    wasCooked = cache.IsCooked();
+    ModelLoadContext context;
+    context.Cache = &cache;
+    ModelFile* model = LoadModelFileFromMemory(
+        fileName,
+        source.data(),
+        static_cast<int>(source.size()),
+        programs,
+        materialParms,
+        nullptr,
+        context);
+    cache.Finish(model != nullptr);
+    return model;
+}
+
+template <typename _type_>
+int IndexOf(const _type_* element, const std::vector<_type_>& elements) {
+    return (element == nullptr) ? -1 : static_cast<int>(element - elements.data());
+}
+
+bool MatricesNear(const Matrix4f& a, const Matrix4f& b) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (fabsf(a.M[i][j] - b.M[i][j]) > 1e-5f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Everything a cooked load has to rebuild, compared by value and by index.
+void CheckSameModel(const ModelFile& a, const ModelFile& b) {
+    HOST_CHECK_EQ(a.Buffers.size(), b.Buffers.size());
+    for (size_t i = 0; i < a.Buffers.size() && i < b.Buffers.size(); i++) {
+        HOST_CHECK_EQ(a.Buffers[i].byteLength, b.Buffers[i].byteLength);
+        HOST_CHECK(
+            memcmp(a.Buffers[i].bufferData, b.Buffers[i].bufferData, a.Buffers[i].byteLength) ==
+            0);
+    }
+    HOST_CHECK_EQ(a.BufferViews.size(), b.BufferViews.size());
+    HOST_CHECK_EQ(a.Accessors.size(), b.Accessors.size());
+    for (size_t i = 0; i < a.Accessors.size() && i < b.Accessors.size(); i++) {
+        HOST_CHECK_EQ(a.Accessors[i].count, b.Accessors[i].count);
+        HOST_CHECK_EQ(
+            IndexOf(a.Accessors[i].bufferView, a.BufferViews),
+            IndexOf(b.Accessors[i].bufferView, b.BufferViews));
+    }
+
+    HOST_CHECK_EQ(a.Textures.size(), b.Textures.size());
+    for (size_t i = 0; i < a.Textures.size() && i < b.Textures.size(); i++) {
+        HOST_CHECK(a.Textures[i].name == b.Textures[i].name);
+        HOST_CHECK(b.Textures[i].texid.texture != 0);
+        HOST_CHECK_EQ(a.Textures[i].texid.Width, b.Textures[i].texid.Width);
+        HOST_CHECK_EQ(a.Textures[i].texid.Height, b.Textures[i].texid.Height);
+    }
+    HOST_CHECK_EQ(a.Samplers.size(), b.Samplers.size());
+    for (size_t i = 0; i < a.Samplers.size() && i < b.Samplers.size(); i++) {
+        HOST_CHECK_EQ(a.Samplers[i].wrapS, b.Samplers[i].wrapS);
+        HOST_CHECK_EQ(a.Samplers[i].wrapT, b.Samplers[i].wrapT);
+    }
+    HOST_CHECK_EQ(a.TextureWrappers.size(), b.TextureWrappers.size());
+    for (size_t i = 0; i < a.TextureWrappers.size() && i < b.TextureWrappers.size(); i++) {
+        HOST_CHECK_EQ(
+            IndexOf(a.TextureWrappers[i].image, a.Textures),
+            IndexOf(b.TextureWrappers[i].image, b.Textures));
+        HOST_CHECK_EQ(
+            IndexOf(a.TextureWrappers[i].sampler, a.Samplers),
+            IndexOf(b.TextureWrappers[i].sampler, b.Samplers));
+    }
+    HOST_CHECK_EQ(a.Materials.size(), b.Materials.size());
+    for (size_t i = 0; i < a.Materials.size() && i < b.Materials.size(); i++) {
+        const ModelMaterial& ma = a.Materials[i];
+        const ModelMaterial& mb = b.Materials[i];
+        HOST_CHECK(ma.name == mb.name);
+        HOST_CHECK_EQ(
+            IndexOf(ma.baseColorTextureWrapper, a.TextureWrappers),
+            IndexOf(mb.baseColorTextureWrapper, b.TextureWrappers));
+        HOST_CHECK(ma.emmisiveFactor == mb.emmisiveFactor);
+        HOST_CHECK_EQ(ma.metallicFactor, mb.metallicFactor);
+        HOST_CHECK_EQ(ma.roughnessFactor, mb.roughnessFactor);
+        HOST_CHECK_EQ(ma.alphaMode, mb.alphaMode);
+        HOST_CHECK_EQ(ma.doubleSided, mb.doubleSided);
+    }
+
+    HOST_CHECK_EQ(a.Models.size(), b.Models.size());
+    for (size_t i = 0; i < a.Models.size() && i < b.Models.size(); i++) {
+        HOST_CHECK(a.Models[i].name == b.Models[i].name);
+        HOST_CHECK(a.Models[i].weights == b.Models[i].weights);
+        HOST_CHECK_EQ(a.Models[i].surfaces.size(), b.Models[i].surfaces.size());
+        for (size_t j = 0; j < a.Models[i].surfaces.size() && j < b.Models[i].surfaces.size();
+             j++) {
+            const ModelSurface& sa = a.Models[i].surfaces[j];
+            const ModelSurface& sb = b.Models[i].surfaces[j];
+            HOST_CHECK_EQ(IndexOf(sa.material, a.Materials), IndexOf(sb.material, b.Materials));
+            HOST_CHECK(sa.surfaceDef.surfaceName == sb.surfaceDef.surfaceName);
+            const GlGeometry& ga = sa.surfaceDef.geo;
+            const GlGeometry& gb = sb.surfaceDef.geo;
+            HOST_CHECK(gb.vertexArrayObject != 0);
+            HOST_CHECK_EQ(ga.vertexCount, gb.vertexCount);
+            HOST_CHECK_EQ(ga.indexCount, gb.indexCount);
+            HOST_CHECK(ga.localBounds.GetMins() == gb.localBounds.GetMins());
+            HOST_CHECK(ga.localBounds.GetMaxs() == gb.localBounds.GetMaxs());
+            const ovrGraphicsCommand& ca = sa.surfaceDef.graphicsCommand;
+            const ovrGraphicsCommand& cb = sb.surfaceDef.graphicsCommand;
+            HOST_CHECK_EQ(ca.GpuState.blendEnable, cb.GpuState.blendEnable);
+            HOST_CHECK_EQ(ca.GpuState.depthMaskEnable, cb.GpuState.depthMaskEnable);
+            HOST_CHECK_EQ(ca.GpuState.cullEnable, cb.GpuState.cullEnable);
+            HOST_CHECK_EQ(ca.Textures[0].Width, cb.Textures[0].Width);
+        }
+    }
+    HOST_CHECK_EQ(a.Cameras.size(), b.Cameras.size());
+    for (size_t i = 0; i < a.Cameras.size() && i < b.Cameras.size(); i++) {
+        HOST_CHECK_EQ(a.Cameras[i].perspective.fovDegreesX, b.Cameras[i].perspective.fovDegreesX);
+        HOST_CHECK_EQ(a.Cameras[i].perspective.farZ, b.Cameras[i].perspective.farZ);
+    }
+
+    HOST_CHECK_EQ(a.Nodes.size(), b.Nodes.size());
+    for (size_t i = 0; i < a.Nodes.size() && i < b.Nodes.size(); i++) {
+        const ModelNode& na = a.Nodes[i];
+        const ModelNode& nb = b.Nodes[i];
+        HOST_CHECK(na.name == nb.name);
+        HOST_CHECK(na.children == nb.children);
+        HOST_CHECK_EQ(na.parentIndex, nb.parentIndex);
+        HOST_CHECK_EQ(na.skinIndex, nb.skinIndex);
+        HOST_CHECK_EQ(IndexOf(na.camera, a.Cameras), IndexOf(nb.camera, b.Cameras));
+        HOST_CHECK_EQ(
+            IndexOf<Model>(na.model, a.Models), IndexOf<Model>(nb.model, b.Models));
+        HOST_CHECK(MatricesNear(na.GetLocalTransform(), nb.GetLocalTransform()));
+        HOST_CHECK(MatricesNear(na.GetGlobalTransform(), nb.GetGlobalTransform()));
+    }
+
+    HOST_CHECK_EQ(a.Animations.size(), b.Animations.size());
+    for (size_t i = 0; i < a.Animations.size() && i < b.Animations.size(); i++) {
+        const ModelAnimation& aa = a.Animations[i];
+        const ModelAnimation& ab = b.Animations[i];
+        HOST_CHECK(aa.name == ab.name);
+        HOST_CHECK_EQ(aa.samplers.size(), ab.samplers.size());
+        for (size_t j = 0; j < aa.samplers.size() && j < ab.samplers.size(); j++) {
+            HOST_CHECK_EQ(
+                IndexOf(aa.samplers[j].input, a.Accessors),
+                IndexOf(ab.samplers[j].input, b.Accessors));
+            HOST_CHECK_EQ(
+                IndexOf(aa.samplers[j].output, a.Accessors),
+                IndexOf(ab.samplers[j].output, b.Accessors));
+            HOST_CHECK_EQ(aa.samplers[j].timeLineIndex, ab.samplers[j].timeLineIndex);
+        }
+        HOST_CHECK_EQ(aa.channels.size(), ab.channels.size());
+        for (size_t j = 0; j < aa.channels.size() && j < ab.channels.size(); j++) {
+            HOST_CHECK_EQ(aa.channels[j].nodeIndex, ab.channels[j].nodeIndex);
+            HOST_CHECK_EQ(aa.channels[j].path, ab.channels[j].path);
+            HOST_CHECK_EQ(
+                IndexOf(aa.channels[j].sampler, aa.samplers),
+                IndexOf(ab.channels[j].sampler, ab.samplers));
+        }
+    }
+    HOST_CHECK_EQ(a.AnimationTimeLines.size(), b.AnimationTimeLines.size());
+    for (size_t i = 0; i < a.AnimationTimeLines.size() && i < b.AnimationTimeLines.size(); i++) {
+        HOST_CHECK_EQ(a.AnimationTimeLines[i].sampleCount, b.AnimationTimeLines[i].sampleCount);
+        HOST_CHECK_EQ(a.AnimationTimeLines[i].rcpStep, b.AnimationTimeLines[i].rcpStep);
+    }
+    HOST_CHECK_EQ(a.animationStartTime, b.animationStartTime);
+    HOST_CHECK_EQ(a.animationEndTime, b.animationEndTime);
+
+    HOST_CHECK_EQ(a.Skins.size(), b.Skins.size());
+    for (size_t i = 0; i < a.Skins.size() && i < b.Skins.size(); i++) {
+        HOST_CHECK(a.Skins[i].jointIndexes == b.Skins[i].jointIndexes);
+        HOST_CHECK_EQ(a.Skins[i].inverseBindMatrices.size(), b.Skins[i].inverseBindMatrices.size());
+        for (size_t j = 0; j < a.Skins[i].inverseBindMatrices.size() &&
+             j < b.Skins[i].inverseBindMatrices.size();
+             j++) {
+            HOST_CHECK(
+                MatricesNear(a.Skins[i].inverseBindMatrices[j], b.Skins[i].inverseBindMatrices[j]));
+        }
+    }
+    HOST_CHECK_EQ(a.SubScenes.size(), b.SubScenes.size());
+    for (size_t i = 0; i < a.SubScenes.size() && i < b.SubScenes.size(); i++) {
+        HOST_CHECK(a.SubScenes[i].name == b.SubScenes[i].name);
+        HOST_CHECK(a.SubScenes[i].nodes == b.SubScenes[i].nodes);
+        HOST_CHECK_EQ(a.SubScenes[i].visible, b.SubScenes[i].visible);
+    }
+}
+
+// Loads the model from its source and cooked, checks both give the same model, and returns the
+// seconds per load of each.
+void CheckCookedLoad(
+    const char* fileName,
+    const std::vector<uint8_t>& source,
+    const ModelGlPrograms& programs,
+    const char* cachePath,
+    const int iterations,
+    double& sourceSeconds,
+    double& cookedSeconds) {
+    remove(cachePath);
+    bool wasCooked = true;
+    double start = HostTestSeconds();
+    ModelFile* fromSource = LoadCached(fileName, source, programs, cachePath, wasCooked);
+    HOST_CHECK(fromSource != nullptr);
+    HOST_CHECK(!wasCooked);
+    ModelFile* cooked = LoadCached(fileName, source, programs, cachePath, wasCooked);
+    HOST_CHECK(cooked != nullptr);
+    HOST_CHECK(wasCooked);
+    if (fromSource != nullptr && cooked != nullptr) {
+        CheckSameModel(*fromSource, *cooked);
+    }
+    delete fromSource;
+    delete cooked;
+
+    // timed without the cache, then from the cooked file
+    start = HostTestSeconds();
+    for (int i = 0; i < iterations; i++) {
+        delete LoadModelFileFromMemory(
+            fileName, source.data(), static_cast<int>(source.size()), programs, MaterialParms());
+    }
+    sourceSeconds = (HostTestSeconds() - start) / iterations;
+    start = HostTestSeconds();
+    for (int i = 0; i < iterations; i++) {
+        delete LoadCached(fileName, source, programs, cachePath, wasCooked);
+    }
+    cookedSeconds = (HostTestSeconds() - start) / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = HostTestQuick(argc, argv) ? 5 : 200;
+    ovrHostGui gui;
+    GlProgram program;
+    const ModelGlPrograms programs(&program);
+
+    // the synthetic scene, zipped the way .gltf.ovrscene files are
+    const char* const scenePath = "ModelCacheTest.gltf.ovrscene";
+    const char* const sceneCache = "ModelCacheTest.gltf.ovrscene.cooked";
+    {
+        const std::vector<uint8_t> bin = MakeSceneBin();
+        zipFile zip = zipOpen(scenePath, APPEND_STATUS_CREATE);
+        HOST_CHECK(zip != nullptr);
+        HOST_CHECK(AddZipEntry(zip, "scene.gltf", SCENE_GLTF, strlen(SCENE_GLTF)));
+        HOST_CHECK(AddZipEntry(zip, "scene.bin", bin.data(), bin.size()));
+        HOST_CHECK(zipClose(zip, nullptr) == ZIP_OK);
+    }
+    std::vector<uint8_t> scene;
+    HOST_CHECK(ReadWholeFile(scenePath, scene));
+    double sourceSeconds = 0.0;
+    double cookedSeconds = 0.0;
+    CheckCookedLoad(
+        scenePath, scene, programs, sceneCache, iterations, sourceSeconds, cookedSeconds);
+    printf(
+        "scene     : source %.1f us, cooked %.1f us\n",
+        sourceSeconds * 1e6,
+        cookedSeconds * 1e6);
+
+    // the scene is what the JSON describes
+    bool wasCooked = false;
+    ModelFile* model = LoadCached(scenePath, scene, programs, sceneCache, wasCooked);
+    HOST_CHECK(model != nullptr && wasCooked);
+    if (model != nullptr) {
+        HOST_CHECK_EQ(model->Nodes.size(), 4u);
+        HOST_CHECK_EQ(model->Models.size(), 2u);
+        HOST_CHECK_EQ(model->Models[1].surfaces.size(), 2u);
+        // the primitive without a material gets the default one at the end
+        HOST_CHECK(model->Models[1].surfaces[1].material == &model->Materials.back());
+        HOST_CHECK(model->Nodes[1].model == &model->Models[0]);
+        HOST_CHECK(model->Nodes[3].camera == &model->Cameras[0]);
+        HOST_CHECK_EQ(model->Nodes[2].parentIndex, 0);
+        HOST_CHECK_NEAR(model->Nodes[2].GetGlobalTransform().GetTranslation().y, 1.0, 1e-6);
+        HOST_CHECK_NEAR(model->animationStartTime, 0.5, 1e-6);
+        HOST_CHECK_NEAR(model->animationEndTime, 2.5, 1e-6);
+        HOST_CHECK(model->SubScenes[0].visible && !model->SubScenes[1].visible);
+        HOST_CHECK_NEAR(model->Skins[0].inverseBindMatrices[0].GetTranslation().z, 3.0, 1e-6);
+        const ovrGraphicsCommand& textured =
+            model->Models[0].surfaces[0].surfaceDef.graphicsCommand;
+        HOST_CHECK_EQ(textured.GpuState.blendEnable, ovrGpuState::BLEND_ENABLE);
+        HOST_CHECK(!textured.GpuState.cullEnable);
+        HOST_CHECK(textured.Textures[0].texture != 0);
+    }
+    delete model;
+
+    // a damaged description fails the load and removes the file, and the next load cooks again
+    FILE* f = fopen(sceneCache, "r+b");
+    HOST_CHECK(f != nullptr);
+    if (f != nullptr) {
+        ModelGeometryCache::ovrHeader header;
+        HOST_CHECK(fread(&header, sizeof(header), 1, f) == 1);
+        HOST_CHECK(header.SceneSize > 0);
+        const uint32_t badCount = 0xFFFFFFFF;
+        fseek(f, static_cast<long>(header.SceneOffset), SEEK_SET);
+        fwrite(&badCount, sizeof(badCount), 1, f);
+        fclose(f);
+    }
+    model = LoadCached(scenePath, scene, programs, sceneCache, wasCooked);
+    HOST_CHECK(wasCooked && model == nullptr);
+    delete model;
+    model = LoadCached(scenePath, scene, programs, sceneCache, wasCooked);
+    HOST_CHECK(!wasCooked && model != nullptr);
+    delete model;
+    remove(scenePath);
+    remove(sceneCache);
+
+    // the controller, with its texture
+    std::vector<uint8_t> controller;
+    HOST_CHECK(gui.FileSys->ReadFile(CONTROLLER_URI, controller));
+    const char* const controllerCache = "ModelCacheTest.controller.cooked";
+    CheckCookedLoad(
+        CONTROLLER_URI,
+        controller,
+        programs,
+        controllerCache,
+        iterations,
+        sourceSeconds,
+        cookedSeconds);
+    printf(
+        "controller: source %.1f us, cooked %.1f us\n",
+        sourceSeconds * 1e6,
+        cookedSeconds * 1e6);
+
+    // a file cooked with full float vertices is not used for a compact load, which cooks again
+    MaterialParms compact;
+    compact.CompactVertices = true;
+    model = LoadCached(CONTROLLER_URI, controller, programs, controllerCache, wasCooked, compact);
+    HOST_CHECK(!wasCooked && model != nullptr);
+    delete model;
+    model = LoadCached(CONTROLLER_URI, controller, programs, controllerCache, wasCooked, compact);
+    HOST_CHECK(wasCooked && model != nullptr);
+    delete model;
+    model = LoadCached(CONTROLLER_URI, controller, programs, controllerCache, wasCooked);
+    HOST_CHECK(!wasCooked && model != nullptr);
+    delete model;
+    remove(controllerCache);
+
+    return HOST_TEST_RESULT();
+}
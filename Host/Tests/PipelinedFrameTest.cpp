@@ -0,0 +1,331 @@
+/************************************************************************************
+
+Filename    :   PipelinedFrameTest.cpp
+Content     :   Runs ovrAppl serially and with pipelined frames against the stand-in VrApi's
+                vsync, and checks what each frame is rendered with and how often vsync is missed
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "Appl.h"
+#include "HostApp.h"
+#include "HostVrApi.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace OVRFW;
+
+namespace {
+
+// Each half of the frame takes most of a 72 Hz vsync interval, so the two only fit when they
+// overlap. With jitter, each half either sleeps anywhere up to that long, or keeps the CPU busy
+// for a moment, as a light frame does.
+double SimSeconds = 0.009;
+double RenderSeconds = 0.009;
+bool Jitter = false;
+
+struct ovrSimulatedFrame {
+    double DisplayTime = 0.0;
+    float HeadX = 0.0f;
+    std::thread::id Thread;
+    double Start = 0.0;
+    double End = 0.0;
+    bool Rendered = false;
+    std::thread::id RenderThread;
+    double RenderStart = 0.0;
+    double RenderEnd = 0.0;
+};
+
+struct ovrRunResult {
+    int NumSimulated = 0;
+    int NumRendered = 0;
+    // a rendered frame whose input, tracking or snapshot didn't come from its own simulation
+    int NumMismatched = 0;
+    int NumRenderedTwice = 0;
+    int NumNotSimulated = 0;
+    // rendering that ran while the next frame was being simulated on another thread
+    int NumOverlapped = 0;
+    int NumSimOnMainThread = 0;
+    ovrHostVrApiStats Stats;
+};
+
+// A head that says in its position when it was predicted for, and two remotes.
+void ScriptedTracking(const double timeInSeconds, ovrHostTracking& tracking) {
+    tracking.HeadPose.Orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+    tracking.HeadPose.Position = {static_cast<float>(fmod(timeInSeconds, 100.0)), 1.6f, 0.0f};
+    for (int hand = 0; hand < 2; hand++) {
+        ovrHostRemote& remote = tracking.Remotes[hand];
+        remote.Connected = true;
+        remote.Pose.Orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+        remote.Pose.Position = {hand * 1.0f, 1.2f, -0.35f};
+    }
+}
+
+void Sleep(const double seconds, std::mt19937& rng) {
+    const double jitter = Jitter ? std::uniform_real_distribution<double>(-1.0, 1.0)(rng) : 1.0;
+    if (jitter > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds * jitter));
+        return;
+    }
+    for (const double end = HostTestSeconds() + 0.0005; HostTestSeconds() < end;) {
+    }
+}
+
+//==============================================================
+// ovrPipelineTestAppl
+// Stamps every frame it simulates and checks that the renderer gets the same frame back, from
+// the start of AppRenderFrame() to its end, while the next one may be simulated alongside.
+class ovrPipelineTestAppl : public ovrAppl {
+   public:
+    ovrPipelineTestAppl(ovrRunResult& result)
+        : ovrAppl(0, 0, 0, 0, true /* useMultiView */), Result(result) {}
+
+    virtual ovrApplFrameOut AppFrame(const ovrApplFrameIn& in) override {
+        ovrSimulatedFrame frame;
+        frame.DisplayTime = in.PredictedDisplayTime;
+        // not Tracking, which belongs to the frame being rendered
+        frame.HeadX = in.HeadPose.Translation.x;
+        frame.Thread = std::this_thread::get_id();
+        frame.Start = HostTestSeconds();
+        Sleep(SimSeconds, SimRng);
+        frame.End = HostTestSeconds();
+
+        std::lock_guard<std::mutex> lock(Mutex);
+        Frames[in.FrameIndex] = frame;
+        Result.NumSimulated++;
+        return ovrApplFrameOut();
+    }
+
+    virtual void AppRenderFrame(const ovrApplFrameIn& in, ovrRendererOutput& out) override {
+        const int64_t frameIndex = in.FrameIndex;
+        const double start = HostTestSeconds();
+        int numMismatched = CheckFrame(in) ? 0 : 1;
+        Sleep(RenderSeconds, RenderRng);
+        // by now the next frame has been simulated into the other slot
+        numMismatched += in.FrameIndex == frameIndex && CheckFrame(in) ? 0 : 1;
+        const double end = HostTestSeconds();
+
+        std::lock_guard<std::mutex> lock(Mutex);
+        Result.NumRendered++;
+        Result.NumMismatched += numMismatched > 0 ? 1 : 0;
+        const auto frame = Frames.find(frameIndex);
+        if (frame == Frames.end()) {
+            Result.NumNotSimulated++;
+            return;
+        }
+        Result.NumRenderedTwice += frame->second.Rendered ? 1 : 0;
+        frame->second.Rendered = true;
+        frame->second.RenderThread = std::this_thread::get_id();
+        frame->second.RenderStart = start;
+        frame->second.RenderEnd = end;
+        Result.NumSimOnMainThread += frame->second.Thread == std::this_thread::get_id() ? 1 : 0;
+    }
+
+    // Once the app has stopped, counts the frames rendered while the next one was simulated on
+    // another thread.
+    void CountOverlaps() {
+        for (auto it = Frames.begin(); it != Frames.end(); ++it) {
+            const ovrSimulatedFrame& frame = it->second;
+            const auto next = Frames.find(it->first + 1);
+            if (frame.Rendered && next != Frames.end() &&
+                next->second.Thread != frame.RenderThread &&
+                next->second.Start < frame.RenderEnd && next->second.End > frame.RenderStart) {
+                Result.NumOverlapped++;
+            }
+        }
+    }
+
+   private:
+    ovrRunResult& Result;
+    std::mt19937 SimRng;
+    std::mt19937 RenderRng;
+    std::mutex Mutex;
+    std::map<int64_t, ovrSimulatedFrame> Frames;
+
+    bool CheckFrame(const ovrApplFrameIn& in) {
+        ovrSimulatedFrame frame;
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            const auto it = Frames.find(in.FrameIndex);
+            if (it == Frames.end()) {
+                return false;
+            }
+            frame = it->second;
+        }
+        // the head tracking this frame was simulated with
+        bool ok = in.PredictedDisplayTime == frame.DisplayTime &&
+            Tracking.HeadPose.TimeInSeconds == frame.DisplayTime &&
+            Tracking.HeadPose.Pose.Position.x == frame.HeadX &&
+            frame.HeadX == static_cast<float>(fmod(frame.DisplayTime, 100.0));
+        // the snapshot was captured for this frame, with the remotes predicted to its display
+        ok = ok && in.Input != nullptr && in.Input->GetDisplayTime() == frame.DisplayTime &&
+            in.Input->GetNumDevices() == 2;
+        for (int i = 0; ok && i < in.Input->GetNumDevices(); i++) {
+            const ovrInputDeviceSnapshot& device = in.Input->GetDevice(i);
+            ok = device.TrackingValid &&
+                device.Tracking.HeadPose.TimeInSeconds == frame.DisplayTime;
+        }
+        return ok;
+    }
+};
+
+// Predicts and submits frames in the order a pipelined loop can, at set points of the vsync
+// interval: frame 3 is predicted a vsync after frame 2 and before frame 2 is submitted, so it is
+// clamped to two vsyncs from then rather than following frame 2, and frame 4 is predicted once
+// frame 2 is in. Frame 4 must still get a later display time than frame 3.
+void TestPredictionAhead() {
+    ovrHostVrApi::SetWaitForVsync(false);
+    ovrHostVrApi::ResetStats();
+    ovrModeParms parms = {};
+    ovrMobile* ovr = vrapi_EnterVrMode(&parms);
+    const double start = vrapi_GetTimeInSeconds();
+    const double period = 1.0 / ovrHostVrApi::GetRefreshRate();
+    const auto submit = [ovr](const long long frameIndex, const double displayTime) {
+        ovrSubmitFrameDescription2 frameDesc = {};
+        frameDesc.SwapInterval = 1;
+        frameDesc.FrameIndex = frameIndex;
+        frameDesc.DisplayTime = displayTime;
+        vrapi_SubmitFrame2(ovr, &frameDesc);
+    };
+    const auto sleepUntil = [start, period](const double vsyncs) {
+        std::this_thread::sleep_for(
+            std::chrono::duration<double>(start + vsyncs * period - vrapi_GetTimeInSeconds()));
+    };
+
+    double displayTimes[5] = {};
+    displayTimes[1] = vrapi_GetPredictedDisplayTime(ovr, 1);
+    submit(1, displayTimes[1]);
+    sleepUntil(2.5);
+    displayTimes[2] = vrapi_GetPredictedDisplayTime(ovr, 2);
+    sleepUntil(3.5);
+    displayTimes[3] = vrapi_GetPredictedDisplayTime(ovr, 3);
+    submit(2, displayTimes[2]);
+    displayTimes[4] = vrapi_GetPredictedDisplayTime(ovr, 4);
+    submit(3, displayTimes[3]);
+    submit(4, displayTimes[4]);
+    printf(
+        "predicted ahead: frames 1-4 at vsyncs %.0f %.0f %.0f %.0f\n",
+        (displayTimes[1] - start) / period,
+        (displayTimes[2] - start) / period,
+        (displayTimes[3] - start) / period,
+        (displayTimes[4] - start) / period);
+    for (int i = 2; i <= 4; i++) {
+        HOST_CHECK(displayTimes[i] > displayTimes[i - 1]);
+    }
+    HOST_CHECK_EQ(ovrHostVrApi::GetStats().FrameIndexRegressions, 0);
+
+    vrapi_LeaveVrMode(ovr);
+    ovrHostVrApi::SetWaitForVsync(true);
+}
+
+bool Pipelined = false;
+ovrRunResult* RunResult = nullptr;
+
+ovrRunResult RunFrames(const bool pipelined, const uint64_t frames, const bool pauseHalfway) {
+    ovrRunResult result;
+    Pipelined = pipelined;
+    RunResult = &result;
+    ovrHostVrApi::ResetStats();
+
+    ovrHostApp app;
+    if (pauseHalfway) {
+        // leaving VR mode drops the frame simulated for the old session
+        app.AddCommand(frames / 2, APP_CMD_PAUSE);
+        app.AddCommand(frames / 2, APP_CMD_RESUME);
+    }
+    app.ExitAfterFrames(frames);
+    app.Run();
+
+    result.Stats = ovrHostVrApi::GetStats();
+    RunResult = nullptr;
+    return result;
+}
+
+void Report(const char* name, const ovrRunResult& result) {
+    printf(
+        "%s: %d simulated, %d rendered, %d overlapped, %d missed vsyncs, %d mismatched\n",
+        name,
+        result.NumSimulated,
+        result.NumRendered,
+        result.NumOverlapped,
+        result.Stats.MissedVsyncs,
+        result.NumMismatched);
+}
+
+} // namespace
+
+void android_main(struct android_app* app) {
+    ovrPipelineTestAppl appl(*RunResult);
+    appl.SetPipelinedFrames(Pipelined);
+    appl.Run(app);
+    appl.CountOverlaps();
+}
+
+int main(int, char**) {
+    ovrHostVrApi::SetRefreshRate(72.0f);
+    ovrHostVrApi::SetRemoteCount(2);
+    ovrHostVrApi::SetTrackingSource(ScriptedTracking);
+    const uint64_t frames = 120;
+
+    TestPredictionAhead();
+
+    // serially the two halves don't fit in a vsync interval
+    const ovrRunResult serial = RunFrames(false, frames, false);
+    Report("serial", serial);
+    HOST_CHECK(serial.Stats.SubmittedFrames >= frames);
+    HOST_CHECK_EQ(serial.NumMismatched, 0);
+    HOST_CHECK_EQ(serial.NumOverlapped, 0);
+    HOST_CHECK_EQ(serial.NumSimOnMainThread, serial.NumRendered);
+    HOST_CHECK_EQ(serial.Stats.FrameIndexRegressions, 0);
+    HOST_CHECK(serial.Stats.MissedVsyncs > static_cast<int>(frames / 2));
+
+    // pipelined, every frame is rendered with what it was simulated with, on another thread,
+    // while the next one is simulated
+    const ovrRunResult pipelined = RunFrames(true, frames, false);
+    Report("pipelined", pipelined);
+    HOST_CHECK(pipelined.Stats.SubmittedFrames >= frames);
+    HOST_CHECK_EQ(pipelined.NumMismatched, 0);
+    HOST_CHECK_EQ(pipelined.NumNotSimulated, 0);
+    HOST_CHECK_EQ(pipelined.NumRenderedTwice, 0);
+    HOST_CHECK_EQ(pipelined.NumSimOnMainThread, 0);
+    HOST_CHECK_EQ(pipelined.Stats.FrameIndexRegressions, 0);
+    HOST_CHECK(pipelined.NumOverlapped >= pipelined.NumRendered - 2);
+    // loose enough for a loaded machine
+    HOST_CHECK(pipelined.Stats.MissedVsyncs < static_cast<int>(frames / 4));
+    HOST_CHECK(pipelined.Stats.MissedVsyncs < serial.Stats.MissedVsyncs);
+
+    // a session that ends and starts again doesn't render the frame simulated for the old one
+    const ovrRunResult resumed = RunFrames(true, frames, true);
+    Report("pipelined, paused and resumed", resumed);
+    HOST_CHECK(resumed.Stats.SubmittedFrames >= frames);
+    HOST_CHECK_EQ(resumed.Stats.EnterVrModeCalls, 2);
+    HOST_CHECK_EQ(resumed.NumMismatched, 0);
+    HOST_CHECK_EQ(resumed.NumNotSimulated, 0);
+    HOST_CHECK_EQ(resumed.NumRenderedTwice, 0);
+    HOST_CHECK_EQ(resumed.Stats.FrameIndexRegressions, 0);
+    HOST_CHECK(resumed.NumSimulated > resumed.NumRendered);
+
+    // with uneven frames the next one is predicted sometimes before and sometimes after the one
+    // rendering is submitted, and sometimes a vsync later than that one was; its display time
+    // must still come after it
+    Jitter = true;
+    const ovrRunResult jittered = RunFrames(true, 600, false);
+    Report("pipelined, uneven frames", jittered);
+    HOST_CHECK_EQ(jittered.NumMismatched, 0);
+    HOST_CHECK_EQ(jittered.NumRenderedTwice, 0);
+    HOST_CHECK_EQ(jittered.Stats.FrameIndexRegressions, 0);
+
+    ovrHostVrApi::SetTrackingSource(nullptr);
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,179 @@
+/************************************************************************************
+
+Filename    :   ProgramBinaryCacheTest.cpp
+Content     :   Checks the program binary cache's keys and files, and that programs are built
+                from it until the driver changes
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "NullGl.h"
+
+#include "Render/GlProgram.h"
+#include "Render/GlProgramCache.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+const char* const CACHE_FOLDER = "ProgramBinaryCacheTest.cache";
+
+const char* const VERTEX_SOURCE =
+    "in vec3 Position;\n"
+    "void main() { gl_Position = TransformVertex( vec4( Position, 1.0 ) ); }\n";
+const char* const FRAGMENT_SOURCE =
+    "out lowp vec4 outColor;\n"
+    "void main() { outColor = vec4( 1.0 ); }\n";
+
+bool FileExists(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f != nullptr) {
+        fclose(f);
+    }
+    return f != nullptr;
+}
+
+std::vector<uint8_t> ReadAll(const std::string& path) {
+    std::vector<uint8_t> data;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f != nullptr) {
+        for (int c = fgetc(f); c != EOF; c = fgetc(f)) {
+            data.push_back(static_cast<uint8_t>(c));
+        }
+        fclose(f);
+    }
+    return data;
+}
+
+void WriteAll(const std::string& path, const std::vector<uint8_t>& data) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f != nullptr) {
+        fwrite(data.data(), 1, data.size(), f);
+        fclose(f);
+    }
+}
+
+void RemoveFolder(const char* folder) {
+    DIR* dir = opendir(folder);
+    if (dir != nullptr) {
+        for (dirent* entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                remove((std::string(folder) + "/" + entry->d_name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(folder);
+}
+
+// Builds the test program and returns the stats of the build.
+ovrNullGlStats BuildProgram() {
+    ovrNullGl::ResetStats();
+    GlProgram program = GlProgram::Build(VERTEX_SOURCE, FRAGMENT_SOURCE, nullptr, 0);
+    HOST_CHECK(program.IsValid());
+    GlProgram::Free(program);
+    return ovrNullGl::GetStats();
+}
+
+} // namespace
+
+int main(int, char**) {
+    RemoveFolder(CACHE_FOLDER);
+    mkdir(CACHE_FOLDER, 0755);
+
+    ovrProgramBinaryCache cache;
+    cache.SetDriver("vendor\nrenderer\n1.0\n");
+
+    // keys change with either source, with text moved from one to the other, and with the driver
+    const uint64_t key = cache.MakeKey("vertex", "fragment");
+    HOST_CHECK_EQ(key, cache.MakeKey("vertex", "fragment"));
+    HOST_CHECK(key != cache.MakeKey("vertex2", "fragment"));
+    HOST_CHECK(key != cache.MakeKey("vertex", "fragment2"));
+    HOST_CHECK(cache.MakeKey("ab", "c") != cache.MakeKey("a", "bc"));
+    ovrProgramBinaryCache otherDriver;
+    otherDriver.SetDriver("vendor\nrenderer\n1.1\n");
+    HOST_CHECK(key != otherDriver.MakeKey("vertex", "fragment"));
+
+    // without a folder nothing is stored
+    const std::vector<uint8_t> binary = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    uint32_t format = 0;
+    std::vector<uint8_t> loaded;
+    HOST_CHECK(!cache.IsEnabled());
+    HOST_CHECK(!cache.Store(key, 42, binary.data(), binary.size()));
+    HOST_CHECK(!cache.Load(key, format, loaded));
+
+    // a stored binary comes back with its format, and leaves no temporary file behind
+    cache.SetFolder(CACHE_FOLDER);
+    otherDriver.SetFolder(CACHE_FOLDER);
+    const std::string path = cache.GetPath(key);
+    HOST_CHECK(cache.Store(key, 42, binary.data(), binary.size()));
+    HOST_CHECK(!FileExists(path + ".tmp"));
+    HOST_CHECK(cache.Load(key, format, loaded));
+    HOST_CHECK_EQ(format, uint32_t(42));
+    HOST_CHECK(loaded == binary);
+
+    // nothing else is loaded: an empty binary, another key's file, another driver's file, a
+    // damaged or cut off file, and the damaged ones are removed
+    HOST_CHECK(!cache.Store(key + 1, 42, binary.data(), 0));
+    const std::vector<uint8_t> file = ReadAll(path);
+    HOST_CHECK_EQ(file.size(), sizeof(ovrProgramBinaryCache::ovrHeader) + binary.size());
+    WriteAll(cache.GetPath(key + 1), file);
+    HOST_CHECK(!cache.Load(key + 1, format, loaded));
+    HOST_CHECK(!otherDriver.Load(key, format, loaded));
+    std::vector<uint8_t> damaged = file;
+    damaged.back() ^= 1;
+    WriteAll(path, damaged);
+    HOST_CHECK(!cache.Load(key, format, loaded));
+    HOST_CHECK(!FileExists(path));
+    damaged = file;
+    damaged.pop_back();
+    WriteAll(path, damaged);
+    HOST_CHECK(!cache.Load(key, format, loaded));
+    HOST_CHECK(!FileExists(path));
+
+    // the first build compiles and stores the binary, later ones load it
+    GlProgram::SetBinaryCacheFolder(CACHE_FOLDER);
+    ovrNullGlStats stats = BuildProgram();
+    HOST_CHECK_EQ(stats.ShaderCompiles, 2);
+    HOST_CHECK_EQ(stats.ProgramLinks, 1);
+    stats = BuildProgram();
+    HOST_CHECK_EQ(stats.ShaderCompiles, 0);
+    HOST_CHECK_EQ(stats.ProgramLinks, 0);
+    HOST_CHECK_EQ(stats.ProgramBinaryLoads, 1);
+
+    // a driver update that keeps its version strings rejects the binary; it is compiled again
+    // and the new binary replaces it
+    ovrNullGl::SetDriverVersion(2);
+    stats = BuildProgram();
+    HOST_CHECK_EQ(stats.ProgramBinaryRejects, 1);
+    HOST_CHECK_EQ(stats.ShaderCompiles, 2);
+    HOST_CHECK_EQ(stats.ProgramLinks, 1);
+    stats = BuildProgram();
+    HOST_CHECK_EQ(stats.ProgramBinaryLoads, 1);
+    HOST_CHECK_EQ(stats.ProgramBinaryRejects, 0);
+    HOST_CHECK_EQ(stats.ShaderCompiles, 0);
+
+    // deferred builds use the cache as well
+    ovrNullGl::ResetStats();
+    GlProgram deferred =
+        GlProgram::BuildDeferred(nullptr, VERTEX_SOURCE, nullptr, FRAGMENT_SOURCE, nullptr, 0);
+    HOST_CHECK(GlProgram::FinishBuild(deferred));
+    HOST_CHECK_EQ(ovrNullGl::GetStats().ProgramBinaryLoads, 1);
+    HOST_CHECK_EQ(ovrNullGl::GetStats().ShaderCompiles, 0);
+    GlProgram::Free(deferred);
+
+    GlProgram::SetBinaryCacheFolder("");
+    RemoveFolder(CACHE_FOLDER);
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,99 @@
+/************************************************************************************
+
+Filename    :   RadixSortTest.cpp
+Content     :   Checks the menu surface radix sort against std::sort
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "GUI/VRMenuSort.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+// Keys built the way VRMenuMgrLocal::Finish builds them. distanceGroups > 0 makes runs of
+// submissions share a distance, as objects sharing a DistanceIndex do.
+std::vector<SurfSort> MakeKeys(std::mt19937& rng, const int count, const int distanceGroups) {
+    std::uniform_real_distribution<float> distance(0.0f, 100.0f);
+    std::vector<SurfSort> keys(count);
+    float distSq = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        if (distanceGroups <= 0 || i % distanceGroups == 0) {
+            const float d = distance(rng);
+            distSq = d * d;
+        }
+        uint32_t bits;
+        memcpy(&bits, &distSq, sizeof(bits));
+        keys[i].Key = (static_cast<int64_t>(bits) << 32ULL) | (count - i);
+    }
+    return keys;
+}
+
+bool SortsLikeStdSort(std::vector<SurfSort> keys) {
+    std::vector<SurfSort> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    std::vector<SurfSort> scratch;
+    RadixSortKeys(keys, scratch);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i].Key != expected[i].Key) {
+            fprintf(stderr, "%zu keys: mismatch at %zu\n", keys.size(), i);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int, char**) {
+    std::mt19937 rng(1234);
+
+    // nothing to sort
+    std::vector<SurfSort> keys;
+    std::vector<SurfSort> scratch;
+    RadixSortKeys(keys, scratch);
+    HOST_CHECK(keys.empty());
+    HOST_CHECK(SortsLikeStdSort(MakeKeys(rng, 1, 0)));
+
+    // every digit but the index bytes is shared, so most passes are skipped
+    HOST_CHECK(SortsLikeStdSort(MakeKeys(rng, 500, 500)));
+
+    // already sorted and reversed input
+    std::vector<SurfSort> sorted = MakeKeys(rng, 1000, 0);
+    std::sort(sorted.begin(), sorted.end());
+    HOST_CHECK(SortsLikeStdSort(sorted));
+    std::reverse(sorted.begin(), sorted.end());
+    HOST_CHECK(SortsLikeStdSort(sorted));
+
+    // sizes around the digit boundaries of the submission index, with and without shared
+    // distances; 70000 needs a third index byte
+    const int counts[] = {2, 3, 255, 256, 257, 2000, 65535, 65536, 70000};
+    for (const int count : counts) {
+        HOST_CHECK(SortsLikeStdSort(MakeKeys(rng, count, 0)));
+        HOST_CHECK(SortsLikeStdSort(MakeKeys(rng, count, 7)));
+    }
+
+    // the first key is the furthest surface, and ties go to the earliest submission
+    keys = MakeKeys(rng, 64, 8);
+    RadixSortKeys(keys, scratch);
+    for (size_t i = 1; i < keys.size(); ++i) {
+        const uint32_t prevDist = static_cast<uint64_t>(keys[i - 1].Key) >> 32;
+        const uint32_t dist = static_cast<uint64_t>(keys[i].Key) >> 32;
+        HOST_CHECK(prevDist >= dist);
+        if (prevDist == dist) {
+            HOST_CHECK((keys[i - 1].Key & 0xFFFFFFFF) > (keys[i].Key & 0xFFFFFFFF));
+        }
+    }
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,138 @@
+/************************************************************************************
+
+Filename    :   ReflectionParseBenchmark.cpp
+Content     :   Times reflection type lookups and menu parsing against the linear walks
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostJni.h"
+
+#include "GUI/Reflection.h"
+#include "GUI/ReflectionData.h"
+#include "GUI/VRMenuObject.h"
+#include "Locale/OVR_Locale.h"
+
+#include <string>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+// How FindTypeInfo looked a type up before the index: a strcmp walk over the list.
+ovrTypeInfo const* LinearFindTypeInfo(char const* typeName) {
+    for (int i = 0; TypeInfoList[i].TypeName != nullptr; i++) {
+        if (strcmp(TypeInfoList[i].TypeName, typeName) == 0) {
+            return &TypeInfoList[i];
+        }
+    }
+    return nullptr;
+}
+
+// A panel like the app's, with a surface and font parms per item.
+std::vector<uint8_t> MakeMenuFile(const int itemCount) {
+    std::string text = "itemParms\n{\n";
+    for (int i = 0; i < itemCount; i++) {
+        const std::string name = "item_" + std::to_string(i);
+        text += "\tVRMenuObjectParms\n\t{\n";
+        text += "\t\tType = VRMENU_STATIC;\n";
+        text += "\t\tName = \"" + name + "\";\n";
+        text += "\t\tText = \"" + name + "\";\n";
+        text += "\t\tSurfaceParms\n\t\t{\n\t\t\tVRMenuSurfaceParms\n\t\t\t{\n";
+        text += "\t\t\t\tSurfaceName = \"" + name + "\";\n";
+        text += "\t\t\t}\n\t\t}\n";
+        text += "\t\tFontParms\n\t\t{\n";
+        text += "\t\t\tScale = 0.5;\n\t\t\tWrapWidth = 1.2;\n\t\t\tMultiLine = true;\n";
+        text += "\t\t}\n";
+        text += "\t}\n";
+    }
+    text += "}\n";
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = HostTestQuick(argc, argv);
+    const int lookupPasses = quick ? 200 : 20000;
+    const int parsePasses = quick ? 3 : 100;
+    const int itemCount = 256;
+
+    ovrReflection* refl = ovrReflection::Create();
+    JNIEnv* env = nullptr;
+    ovrHostJni::GetVm()->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
+    ovrLocale* locale = ovrLocale::Create(*env, ovrHostJni::GetActivity(), "default");
+
+    // the indices must find what the linear walks find
+    int typeCount = 0;
+    for (int i = 0; TypeInfoList[i].TypeName != nullptr; i++) {
+        const ovrTypeInfo& type = TypeInfoList[i];
+        HOST_CHECK(
+            refl->FindTypeInfo(type.TypeName) ==
+            LinearFindTypeInfo(type.TypeName));
+        for (int m = 0; type.MemberInfo != nullptr && type.MemberInfo[m].MemberName != nullptr;
+             m++) {
+            HOST_CHECK(
+                refl->FindMemberReflectionInfoRecursive(&type, type.MemberInfo[m].MemberName) ==
+                refl->FindMemberReflectionInfo(type.MemberInfo, type.MemberInfo[m].MemberName));
+        }
+        typeCount++;
+    }
+    HOST_CHECK(refl->FindTypeInfo("NoSuchType") == nullptr);
+
+    volatile uintptr_t sink = 0;
+    double start = HostTestSeconds();
+    for (int pass = 0; pass < lookupPasses; pass++) {
+        for (int i = 0; i < typeCount; i++) {
+            sink += reinterpret_cast<uintptr_t>(refl->FindTypeInfo(TypeInfoList[i].TypeName));
+        }
+    }
+    const double indexedSeconds = HostTestSeconds() - start;
+
+    start = HostTestSeconds();
+    for (int pass = 0; pass < lookupPasses; pass++) {
+        for (int i = 0; i < typeCount; i++) {
+            sink += reinterpret_cast<uintptr_t>(
+                LinearFindTypeInfo(TypeInfoList[i].TypeName));
+        }
+    }
+    const double linearSeconds = HostTestSeconds() - start;
+
+    const double lookups = static_cast<double>(lookupPasses) * typeCount;
+    printf(
+        "type lookups (%d types): indexed %.1f ns, linear %.1f ns\n",
+        typeCount,
+        indexedSeconds * 1e9 / lookups,
+        linearSeconds * 1e9 / lookups);
+
+    const std::vector<uint8_t> file = MakeMenuFile(itemCount);
+    start = HostTestSeconds();
+    for (int pass = 0; pass < parsePasses; pass++) {
+        std::vector<VRMenuObjectParms const*> itemParms;
+        const ovrParseResult result =
+            VRMenuObject::ParseItemParms(*refl, *locale, "benchmark", file, itemParms);
+        HOST_CHECK(result);
+        HOST_CHECK_EQ(itemParms.size(), static_cast<size_t>(itemCount));
+        if (pass == 0 && itemParms.size() == static_cast<size_t>(itemCount)) {
+            HOST_CHECK(itemParms[itemCount - 1]->Name == "item_255");
+            HOST_CHECK_EQ(itemParms[0]->SurfaceParms.size(), 1u);
+            HOST_CHECK_NEAR(itemParms[0]->FontParms.Scale, 0.5, 1e-6);
+        }
+        DeletePointerArray(itemParms);
+    }
+    const double parseSeconds = HostTestSeconds() - start;
+    printf(
+        "menu parse (%d items, %zu bytes): %.3f ms\n",
+        itemCount,
+        file.size(),
+        parseSeconds * 1e3 / parsePasses);
+
+    ovrLocale::Destroy(locale);
+    ovrReflection::Destroy(refl);
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,169 @@
+/************************************************************************************
+
+Filename    :   SpscQueueBenchmark.cpp
+Content     :   Times pushing and popping through the single producer, single consumer queues,
+                on the lock free path and through the overflow, and the latency between threads
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "OVR_Lockless.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace OVR;
+using namespace OVRFW;
+
+namespace {
+
+const int CAPACITY = 256;
+
+// The size of an input event.
+struct ovrBenchItem {
+    int64_t TimeNanos = 0;
+    int32_t Value = 0;
+    int32_t Action = 0;
+};
+
+int64_t NowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Pushes batch items and pops them again, one at a time or all at once as a frame takes its
+// events, rounds times over. Returns ns per item pushed and popped.
+template <typename _queue_, typename _push_>
+double TimeBatches(
+    _queue_& queue,
+    const _push_& push,
+    const int batch,
+    const int rounds,
+    const bool popAll) {
+    ovrBenchItem item;
+    std::vector<ovrBenchItem> items;
+    int64_t sum = 0;
+    const double start = HostTestSeconds();
+    for (int round = 0; round < rounds; round++) {
+        for (int i = 0; i < batch; i++) {
+            item.Value = i;
+            push(queue, item);
+        }
+        if (popAll) {
+            items.clear();
+            queue.PopAll(items);
+            for (const ovrBenchItem& popped : items) {
+                sum += popped.Value;
+            }
+            continue;
+        }
+        while (queue.Pop(item)) {
+            sum += item.Value;
+        }
+    }
+    const double seconds = HostTestSeconds() - start;
+    HOST_CHECK_EQ(sum, static_cast<int64_t>(rounds) * batch * (batch - 1) / 2);
+    return seconds * 1e9 / (static_cast<double>(batch) * rounds);
+}
+
+// The producer pushes a time stamped item every interval while the consumer polls; returns the
+// push to pop latencies in microseconds.
+template <typename _queue_, typename _push_>
+std::vector<double> MeasureLatency(const _push_& push, const int count) {
+    _queue_ queue;
+    std::atomic<bool> done(false);
+    std::thread producer([&queue, &push, &done, count]() {
+        ovrBenchItem item;
+        for (int i = 0; i < count; i++) {
+            item.TimeNanos = NowNanos();
+            item.Value = i;
+            push(queue, item);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        done = true;
+    });
+
+    std::vector<double> latencies;
+    latencies.reserve(count);
+    ovrBenchItem item;
+    for (;;) {
+        const bool finished = done;
+        while (queue.Pop(item)) {
+            latencies.push_back((NowNanos() - item.TimeNanos) * 1e-3);
+        }
+        if (finished) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    producer.join();
+    HOST_CHECK_EQ(static_cast<int>(latencies.size()), count);
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+double Percentile(const std::vector<double>& sorted, const double p) {
+    return sorted.empty() ? 0.0 : sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = HostTestQuick(argc, argv);
+    const int rounds = quick ? 2000 : 50000;
+
+    typedef LocklessSpscQueue<ovrBenchItem, CAPACITY> ovrRing;
+    typedef LocklessSpscOverflowQueue<ovrBenchItem, CAPACITY> ovrOverflowRing;
+    const auto pushRing = [](ovrRing& queue, const ovrBenchItem& item) {
+        HOST_CHECK(queue.Push(item));
+    };
+    const auto pushOverflow = [](ovrOverflowRing& queue, const ovrBenchItem& item) {
+        queue.Push(item);
+    };
+
+    // batches that fit in the ring, then ones four times its size
+    ovrRing ring;
+    ovrOverflowRing overflowRing;
+    for (const bool popAll : {false, true}) {
+        const double ringNs = TimeBatches(ring, pushRing, CAPACITY / 2, rounds, popAll);
+        const double fastNs = TimeBatches(overflowRing, pushOverflow, CAPACITY / 2, rounds, popAll);
+        HOST_CHECK_EQ(overflowRing.TakeNumOverflowed(), 0);
+        const double slowNs =
+            TimeBatches(overflowRing, pushOverflow, CAPACITY * 4, rounds / 8, popAll);
+        HOST_CHECK_EQ(overflowRing.TakeNumOverflowed(), CAPACITY * 3 * (rounds / 8));
+        printf(
+            "push + %s: ring %.1f ns, overflow queue %.1f ns, through the overflow %.1f ns "
+            "(batches of %d)\n",
+            popAll ? "pop all" : "pop",
+            ringNs,
+            fastNs,
+            slowNs,
+            CAPACITY * 4);
+    }
+
+    // between threads, as from the input callback to the frame loop
+    const int count = quick ? 2000 : 20000;
+    const std::vector<double> ringLatency = MeasureLatency<ovrRing>(pushRing, count);
+    const std::vector<double> overflowLatency =
+        MeasureLatency<ovrOverflowRing>(pushOverflow, count);
+    printf(
+        "latency: ring p50 %.1f us p99 %.1f us, overflow queue p50 %.1f us p99 %.1f us\n",
+        Percentile(ringLatency, 0.5),
+        Percentile(ringLatency, 0.99),
+        Percentile(overflowLatency, 0.5),
+        Percentile(overflowLatency, 0.99));
+    // loose enough for a loaded machine
+    HOST_CHECK(Percentile(overflowLatency, 0.5) < 5000.0);
+
+    return HOST_TEST_RESULT();
+}
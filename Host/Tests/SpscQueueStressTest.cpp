@@ -0,0 +1,209 @@
+/************************************************************************************
+
+Filename    :   SpscQueueStressTest.cpp
+Content     :   Pushes and pops through the single producer, single consumer queues from one
+                and from two threads and checks that every item arrives once and in order
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "OVR_Lockless.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace OVR;
+using namespace OVRFW;
+
+namespace {
+
+// Large enough that a torn copy would show up as a mismatch between the fields.
+struct ovrStressItem {
+    uint32_t Sequence = 0;
+    uint32_t Check = 0;
+    uint64_t Padding[3] = {};
+
+    static ovrStressItem Make(const uint32_t sequence) {
+        ovrStressItem item;
+        item.Sequence = sequence;
+        item.Check = sequence * 2654435761u;
+        for (uint64_t& p : item.Padding) {
+            p = sequence;
+        }
+        return item;
+    }
+    bool IsValid() const {
+        return Check == Sequence * 2654435761u && Padding[0] == Sequence &&
+            Padding[2] == Sequence;
+    }
+};
+
+void TestSingleThreaded() {
+    // everything past the ring goes to the overflow and comes back in order
+    LocklessSpscOverflowQueue<int, 8> queue;
+    for (int i = 0; i < 1000; i++) {
+        queue.Push(i);
+    }
+    HOST_CHECK_EQ(queue.GetCount(), 1000);
+    HOST_CHECK_EQ(queue.TakeNumOverflowed(), 992);
+    HOST_CHECK_EQ(queue.TakeNumOverflowed(), 0);
+    int numWrong = 0;
+    int value = 0;
+    for (int i = 0; i < 1000; i++) {
+        numWrong += (queue.Pop(value) && value == i) ? 0 : 1;
+    }
+    HOST_CHECK_EQ(numWrong, 0);
+    HOST_CHECK(!queue.Pop(value));
+    HOST_CHECK_EQ(queue.GetCount(), 0);
+
+    // random pushes and pops against a reference queue, through overflow and back
+    std::mt19937 rng(1234);
+    std::deque<int> reference;
+    int next = 0;
+    numWrong = 0;
+    for (int step = 0; step < 100000; step++) {
+        if (rng() % 100 < 52) {
+            queue.Push(next);
+            reference.push_back(next++);
+        } else if (queue.Pop(value)) {
+            numWrong += (!reference.empty() && reference.front() == value) ? 0 : 1;
+            if (!reference.empty()) {
+                reference.pop_front();
+            }
+        } else {
+            numWrong += reference.empty() ? 0 : 1;
+        }
+        numWrong += queue.GetCount() == static_cast<int>(reference.size()) ? 0 : 1;
+    }
+    HOST_CHECK_EQ(numWrong, 0);
+    HOST_CHECK(queue.TakeNumOverflowed() > 0);
+
+    // taking everything at once, with part of the overflow already popped, or none of it
+    std::vector<int> items;
+    queue.PopAll(items);
+    HOST_CHECK(std::equal(items.begin(), items.end(), reference.begin(), reference.end()));
+    for (const int popped : {0, 3, 600}) {
+        for (int i = 0; i < 1000; i++) {
+            queue.Push(next++);
+        }
+        const int first = next - 1000;
+        numWrong = 0;
+        for (int i = 0; i < popped; i++) {
+            numWrong += (queue.Pop(value) && value == first + i) ? 0 : 1;
+        }
+        queue.PopAll(items);
+        numWrong += static_cast<int>(items.size()) == 1000 - popped ? 0 : 1;
+        for (size_t i = 0; i < items.size(); i++) {
+            numWrong += items[i] == first + popped + static_cast<int>(i) ? 0 : 1;
+        }
+        HOST_CHECK_EQ(numWrong, 0);
+        HOST_CHECK_EQ(queue.GetCount(), 0);
+        queue.PopAll(items);
+        HOST_CHECK(items.empty());
+    }
+}
+
+// The producer pushes in random bursts, the consumer pops with random stalls, so the queue
+// keeps going into and out of overflow while both threads work on it. pop replaces its vector
+// with what it took.
+template <typename _queue_, typename _push_, typename _pop_>
+void RunTwoThreads(const char* name, const uint32_t count, const _push_& push, const _pop_& pop) {
+    _queue_ queue;
+    std::thread producer([&queue, &push, count]() {
+        std::mt19937 rng(42);
+        for (uint32_t i = 0; i < count; i++) {
+            push(queue, ovrStressItem::Make(i));
+            if (rng() % 1024 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::mt19937 rng(7);
+    uint32_t expected = 0;
+    int numInvalid = 0;
+    int numOutOfOrder = 0;
+    std::vector<ovrStressItem> items;
+    const double start = HostTestSeconds();
+    while (expected < count && HostTestSeconds() < start + 60.0) {
+        pop(queue, items);
+        if (items.empty()) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (const ovrStressItem& item : items) {
+            numInvalid += item.IsValid() ? 0 : 1;
+            numOutOfOrder += item.Sequence == expected ? 0 : 1;
+            expected = item.Sequence + 1;
+        }
+        if (rng() % 4096 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    const double seconds = HostTestSeconds() - start;
+    producer.join();
+
+    HOST_CHECK_EQ(expected, count);
+    HOST_CHECK_EQ(numInvalid, 0);
+    HOST_CHECK_EQ(numOutOfOrder, 0);
+    pop(queue, items);
+    HOST_CHECK(items.empty());
+    printf("%s: %u items in %.3f s\n", name, count, seconds);
+}
+
+} // namespace
+
+int main(int, char**) {
+    const uint32_t count = 500000;
+
+    TestSingleThreaded();
+
+    typedef LocklessSpscQueue<ovrStressItem, 16> ovrRing;
+    typedef LocklessSpscOverflowQueue<ovrStressItem, 16> ovrOverflowRing;
+    const auto popOne = [](auto& queue, std::vector<ovrStressItem>& items) {
+        items.clear();
+        ovrStressItem item;
+        if (queue.Pop(item)) {
+            items.push_back(item);
+        }
+    };
+
+    // the plain ring, with the producer retrying while it is full
+    const auto pushRing = [](ovrRing& queue, const ovrStressItem& item) {
+        while (!queue.Push(item)) {
+            std::this_thread::yield();
+        }
+    };
+    RunTwoThreads<ovrRing>("ring", count, pushRing, popOne);
+    RunTwoThreads<ovrRing>(
+        "ring, all at once",
+        count,
+        pushRing,
+        [](ovrRing& queue, std::vector<ovrStressItem>& items) {
+            items.clear();
+            queue.PopAll(items);
+        });
+
+    // the overflow queue never makes the producer wait
+    const auto pushOverflow = [](ovrOverflowRing& queue, const ovrStressItem& item) {
+        queue.Push(item);
+    };
+    RunTwoThreads<ovrOverflowRing>("ring with overflow", count, pushOverflow, popOne);
+    RunTwoThreads<ovrOverflowRing>(
+        "ring with overflow, all at once",
+        count,
+        pushOverflow,
+        [](ovrOverflowRing& queue, std::vector<ovrStressItem>& items) { queue.PopAll(items); });
+
+    return HOST_TEST_RESULT();
+}
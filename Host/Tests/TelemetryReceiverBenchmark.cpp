@@ -0,0 +1,285 @@
+/************************************************************************************
+
+Filename    :   TelemetryReceiverBenchmark.cpp
+Content     :   Feeds the telemetry receiver from a stand-in robot and measures what gets
+                through, what the round trip is and what is dropped when the render side stalls
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "TeleopLoopback.h"
+
+#include "TelemetryReceiver.h"
+#include "TeleopSender.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+const int RATE_HZ = 250;
+const int DISPLAY_HZ = 72;
+
+// The receiver binds the port itself, so ask the kernel for one that is free now.
+int FindFreePort() {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    socklen_t length = sizeof(address);
+    int port = 0;
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+        getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0) {
+        port = ntohs(address.sin_port);
+    }
+    close(fd);
+    return port;
+}
+
+void Sleep(const int milliseconds) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+// Sends datagrams to the receiver as the robot would.
+class ovrTelemetryRobot {
+   public:
+    explicit ovrTelemetryRobot(const int port) : Socket(socket(AF_INET, SOCK_DGRAM, 0)) {
+        Address.sin_family = AF_INET;
+        Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        Address.sin_port = htons(static_cast<uint16_t>(port));
+    }
+    ~ovrTelemetryRobot() {
+        close(Socket);
+    }
+
+    bool Send(const uint32_t sequence) {
+        ovrTeleopTelemetry telemetry = {};
+        telemetry.Sequence = sequence;
+        telemetry.BatteryVolts = 12.0f;
+        telemetry.NumServos = 2;
+        uint8_t buffer[TELEMETRY_WIRE_MAX_PACKET_SIZE];
+        return SendBytes(buffer, TelemetryEncode(telemetry, buffer, sizeof(buffer)));
+    }
+    bool SendBytes(const uint8_t* buffer, const int size) {
+        const sockaddr* to = reinterpret_cast<const sockaddr*>(&Address);
+        return sendto(Socket, buffer, size, 0, to, sizeof(Address)) == size;
+    }
+
+   private:
+    int Socket;
+    sockaddr_in Address = {};
+};
+
+// Sends the sequence numbers in order and returns the newest one the render side sees.
+uint32_t SendAndDrain(
+    ovrTelemetryRobot& robot,
+    ovrTelemetryReceiver& receiver,
+    const std::vector<uint32_t>& sequences) {
+    for (const uint32_t sequence : sequences) {
+        robot.Send(sequence);
+    }
+    Sleep(30);
+    ovrTelemetrySample sample;
+    return receiver.GetLatest(sample) ? sample.Telemetry.Sequence : 0;
+}
+
+void TestSequencing() {
+    const int port = FindFreePort();
+    ovrTelemetryReceiver receiver;
+    HOST_CHECK(receiver.Start(port, nullptr));
+    Sleep(30); // the receiver thread binds the port
+    ovrTelemetryRobot robot(port);
+
+    HOST_CHECK_EQ(SendAndDrain(robot, receiver, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}), 10u);
+    ovrTelemetryReceiverStats stats = receiver.GetStats();
+    HOST_CHECK_EQ(stats.PacketsReceived, 10u);
+
+    // a late datagram is dropped, not shown
+    HOST_CHECK_EQ(SendAndDrain(robot, receiver, {5, 11}), 11u);
+    stats = receiver.GetStats();
+    HOST_CHECK_EQ(stats.PacketsOutOfOrder, 1u);
+    HOST_CHECK_EQ(stats.SequenceRestarts, 0u);
+
+    // a robot restarting after a long run numbers from 1 again, far behind the window
+    HOST_CHECK_EQ(SendAndDrain(robot, receiver, {1000, 1, 2}), 2u);
+    stats = receiver.GetStats();
+    HOST_CHECK_EQ(stats.PacketsOutOfOrder, 0u);
+    HOST_CHECK_EQ(stats.SequenceRestarts, 1u);
+
+    // a robot restarting after a short run is inside the window, but went quiet first
+    HOST_CHECK_EQ(SendAndDrain(robot, receiver, {3, 4, 5}), 5u);
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(ovrTelemetryReceiver::RESTART_SILENCE_MICROS + 100000));
+    HOST_CHECK_EQ(SendAndDrain(robot, receiver, {1, 2}), 2u);
+    stats = receiver.GetStats();
+    HOST_CHECK_EQ(stats.PacketsOutOfOrder, 0u);
+    HOST_CHECK_EQ(stats.SequenceRestarts, 1u);
+
+    // sequence numbers wrap; a new session starts without a sequence to compare with
+    receiver.Stop();
+    HOST_CHECK(receiver.Start(port, nullptr));
+    Sleep(30);
+    HOST_CHECK_EQ(SendAndDrain(robot, receiver, {0xfffffffeu, 0xffffffffu, 0u, 1u}), 1u);
+    stats = receiver.GetStats();
+    HOST_CHECK_EQ(stats.PacketsOutOfOrder, 0u);
+    HOST_CHECK_EQ(stats.SequenceRestarts, 0u);
+
+    const uint8_t junk[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    robot.SendBytes(junk, sizeof(junk));
+    Sleep(30);
+    HOST_CHECK_EQ(receiver.GetStats().PacketsMalformed, 1u);
+    receiver.Stop();
+}
+
+// Teleop sender -> stand-in robot -> telemetry receiver -> sender acknowledgements, with the
+// render side draining once a frame. The robot restarts once it has numbered well past the
+// reorder window, with no pause, so only the jump back tells the receiver.
+void RunClosedLoop(const double seconds) {
+    const int port = FindFreePort();
+    ovrTeleopLoopback robot;
+    HOST_CHECK(robot.Start());
+    robot.SetTelemetryPort(port, 1);
+    ovrTeleopSender sender;
+    ovrTelemetryReceiver receiver;
+    HOST_CHECK(receiver.Start(port, &sender));
+    Sleep(30);
+    HOST_CHECK(sender.Start("127.0.0.1", robot.GetPort(), RATE_HZ));
+
+    ovrTeleopState state;
+    state.HeadPose.Pose.Orientation.w = 1.0f;
+    std::vector<double> roundTrips;
+    int sentAtRestart = -1;
+    ovrTelemetrySample sample;
+    const double start = HostTestSeconds();
+    for (double now = start; now < start + seconds; now = HostTestSeconds()) {
+        state.HeadPose.Pose.Position.x = static_cast<float>(now - start);
+        state.HeadPose.TimeInSeconds = ovrTeleopSender::GetTimeMicros() * 1e-6;
+        state.PoseTime = state.HeadPose.TimeInSeconds;
+        sender.SetState(state);
+        if (receiver.GetLatest(sample) && sample.RoundTripSeconds >= 0.0) {
+            roundTrips.push_back(sample.RoundTripSeconds * 1e3);
+        }
+        if (sentAtRestart < 0 &&
+            static_cast<uint32_t>(robot.GetNumTelemetrySent()) >
+                2 * ovrTelemetryReceiver::REORDER_WINDOW) {
+            sentAtRestart = robot.GetNumTelemetrySent();
+            robot.RestartTelemetry();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(1000000 / DISPLAY_HZ));
+    }
+    sender.Stop();
+    Sleep(50);
+    robot.Stop();
+    receiver.GetLatest(sample);
+    receiver.Stop();
+
+    const ovrTelemetryReceiverStats stats = receiver.GetStats();
+    const int telemetrySent = robot.GetNumTelemetrySent();
+    const std::vector<ovrTeleopLoopbackPacket> packets = robot.GetPackets();
+    int numDeltas = 0;
+    for (const ovrTeleopLoopbackPacket& packet : packets) {
+        numDeltas += packet.Header.Delta ? 1 : 0;
+    }
+
+    // nothing is lost on loopback, and a frame's worth of telemetry fits in the queue
+    HOST_CHECK(sentAtRestart > 0);
+    HOST_CHECK_EQ(stats.PacketsReceived, static_cast<uint32_t>(telemetrySent));
+    HOST_CHECK_EQ(stats.PacketsMalformed, 0u);
+    HOST_CHECK_EQ(stats.PacketsDropped, 0u);
+    HOST_CHECK_EQ(stats.PacketsOutOfOrder, 0u);
+    // the restarted robot is followed, not ignored
+    HOST_CHECK_EQ(stats.SequenceRestarts, 1u);
+    const int sinceRestart = telemetrySent - sentAtRestart;
+    HOST_CHECK(static_cast<int>(sample.Telemetry.Sequence) >= sinceRestart - 1);
+    HOST_CHECK(static_cast<int>(sample.Telemetry.Sequence) <= sinceRestart + 1);
+    // acknowledgements reach the sender, which then sends deltas
+    HOST_CHECK(numDeltas > static_cast<int>(packets.size()) / 2);
+    HOST_CHECK(!roundTrips.empty());
+    std::sort(roundTrips.begin(), roundTrips.end());
+    const double p50 = roundTrips.empty() ? 0.0 : roundTrips[roundTrips.size() / 2];
+    // loose enough for a loaded machine
+    HOST_CHECK(p50 < 5.0);
+
+    printf(
+        "closed loop: %d teleop packets (%d deltas), %d telemetry, round trip p50 %.3f ms, "
+        "max %.3f ms\n",
+        static_cast<int>(packets.size()),
+        numDeltas,
+        telemetrySent,
+        p50,
+        roundTrips.empty() ? 0.0 : roundTrips.back());
+}
+
+// The robot sends as fast as it can while the render side drains only every stallMs.
+void RunFlood(const double seconds, const int stallMs) {
+    const int port = FindFreePort();
+    ovrTelemetryReceiver receiver;
+    HOST_CHECK(receiver.Start(port, nullptr));
+    Sleep(30);
+    ovrTelemetryRobot robot(port);
+
+    std::atomic<bool> done(false);
+    int numDrains = 0;
+    std::thread render([&receiver, &done, &numDrains, stallMs]() {
+        ovrTelemetrySample sample;
+        while (!done) {
+            numDrains += receiver.GetLatest(sample) ? 1 : 0;
+            Sleep(stallMs);
+        }
+    });
+
+    uint32_t sent = 0;
+    const double start = HostTestSeconds();
+    while (HostTestSeconds() < start + seconds) {
+        for (int i = 0; i < 64; i++) {
+            sent += robot.Send(sent + 1) ? 1 : 0;
+        }
+        // leave the receiver thread some of the CPU on a single core
+        std::this_thread::yield();
+    }
+    Sleep(50);
+    done = true;
+    render.join();
+    receiver.Stop();
+    const ovrTelemetryReceiverStats stats = receiver.GetStats();
+
+    // everything is counted once: received packets are either queued or dropped, and what the
+    // socket buffer couldn't hold never arrives
+    HOST_CHECK(stats.PacketsReceived > 0);
+    HOST_CHECK(stats.PacketsReceived <= sent);
+    HOST_CHECK_EQ(stats.PacketsMalformed, 0u);
+    HOST_CHECK_EQ(stats.PacketsOutOfOrder, 0u);
+    HOST_CHECK(stats.PacketsDropped < stats.PacketsReceived);
+    HOST_CHECK(numDrains > 0);
+
+    printf(
+        "flood, draining every %d ms: %u sent, %.0f k packets/s received, %.1f%% lost in the "
+        "socket, %.1f%% dropped from the queue\n",
+        stallMs,
+        sent,
+        stats.PacketsReceived / seconds * 1e-3,
+        100.0 * (sent - stats.PacketsReceived) / sent,
+        100.0 * stats.PacketsDropped / stats.PacketsReceived);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = HostTestQuick(argc, argv);
+
+    TestSequencing();
+    RunClosedLoop(quick ? 1.0 : 5.0);
+    RunFlood(quick ? 0.2 : 2.0, 1);
+    RunFlood(quick ? 0.2 : 2.0, 1000 / DISPLAY_HZ);
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,183 @@
+/************************************************************************************
+
+Filename    :   TeleopLoopback.h
+Content     :   A UDP receiver on the loopback interface that decodes teleop packets and records
+                when each one arrived, and can answer with telemetry as the robot does, for the
+                teleop tests
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TeleopProtocol.h"
+#include "TeleopSender.h"
+
+namespace OVRFW {
+
+struct ovrTeleopLoopbackPacket {
+    ovrTeleopWireHeader Header;
+    ovrTeleopWireState State;
+    uint32_t ReceiveTimeMicros; // low 32 bits of CLOCK_MONOTONIC, as the send time
+    int Size;
+};
+
+//==============================================================
+// ovrTeleopLoopback
+// Binds 127.0.0.1 on a free port and decodes everything sent to it on a thread of its own.
+// With SetTelemetryPort() it stands in for the robot, acknowledging teleop packets in telemetry
+// sent to that port.
+class ovrTeleopLoopback {
+   public:
+    ovrTeleopLoopback()
+        : Socket(-1),
+          Port(0),
+          Running(false),
+          NumMalformed(0),
+          TelemetryPort(0),
+          TelemetryInterval(1),
+          TelemetrySequence(0),
+          NumTelemetrySent(0) {}
+    ~ovrTeleopLoopback() {
+        Stop();
+    }
+
+    bool Start() {
+        Socket = socket(AF_INET, SOCK_DGRAM, 0);
+        if (Socket < 0) {
+            return false;
+        }
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        // a timeout so the thread notices Stop()
+        timeval timeout = {0, 10000};
+        setsockopt(Socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        if (bind(Socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            getsockname(Socket, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            close(Socket);
+            Socket = -1;
+            return false;
+        }
+        Port = ntohs(address.sin_port);
+        Running = true;
+        Thread = std::thread(&ovrTeleopLoopback::ReceiveThread, this);
+        return true;
+    }
+
+    void Stop() {
+        Running = false;
+        if (Thread.joinable()) {
+            Thread.join();
+        }
+        if (Socket >= 0) {
+            close(Socket);
+            Socket = -1;
+        }
+    }
+
+    int GetPort() const {
+        return Port;
+    }
+
+    std::vector<ovrTeleopLoopbackPacket> GetPackets() const {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return Packets;
+    }
+    int GetNumMalformed() const {
+        return NumMalformed;
+    }
+
+    // Sends telemetry acknowledging every interval-th teleop packet to 127.0.0.1:port, or
+    // stops when port is 0.
+    void SetTelemetryPort(const int port, const int interval) {
+        TelemetryInterval = interval > 0 ? interval : 1;
+        TelemetryPort = port;
+    }
+    // Numbers the telemetry from 1 again, as a restarted robot does.
+    void RestartTelemetry() {
+        TelemetrySequence = 0;
+    }
+    int GetNumTelemetrySent() const {
+        return NumTelemetrySent;
+    }
+
+   private:
+    int Socket;
+    int Port;
+    std::thread Thread;
+    std::atomic<bool> Running;
+    std::atomic<int> NumMalformed;
+    mutable std::mutex Mutex;
+    std::vector<ovrTeleopLoopbackPacket> Packets;
+    ovrTeleopDecoder Decoder;
+    std::atomic<int> TelemetryPort;
+    std::atomic<int> TelemetryInterval;
+    std::atomic<uint32_t> TelemetrySequence;
+    std::atomic<int> NumTelemetrySent;
+
+    void SendTelemetry(const ovrTeleopLoopbackPacket& packet) {
+        ovrTeleopTelemetry telemetry = {};
+        telemetry.Sequence = ++TelemetrySequence;
+        telemetry.AckedSequence = packet.Header.Sequence;
+        telemetry.AckedSendTimeMicros = packet.Header.SendTimeMicros;
+        telemetry.AckHoldMicros =
+            static_cast<uint32_t>(ovrTeleopSender::GetTimeMicros()) - packet.ReceiveTimeMicros;
+        telemetry.BatteryVolts = 12.0f;
+        telemetry.BatteryPercent = 80;
+        uint8_t buffer[TELEMETRY_WIRE_MAX_PACKET_SIZE];
+        const int size = TelemetryEncode(telemetry, buffer, sizeof(buffer));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(TelemetryPort));
+        const sockaddr* to = reinterpret_cast<const sockaddr*>(&address);
+        if (sendto(Socket, buffer, size, 0, to, sizeof(address)) == size) {
+            NumTelemetrySent++;
+        }
+    }
+
+    void ReceiveThread() {
+        uint8_t buffer[1500];
+        while (Running) {
+            const ssize_t size = recv(Socket, buffer, sizeof(buffer), 0);
+            if (size <= 0) {
+                continue;
+            }
+            ovrTeleopLoopbackPacket packet;
+            packet.ReceiveTimeMicros = static_cast<uint32_t>(ovrTeleopSender::GetTimeMicros());
+            packet.Size = static_cast<int>(size);
+            if (Decoder.Decode(buffer, packet.Size, packet.Header, packet.State) !=
+                TELEOP_DECODE_OK) {
+                NumMalformed++;
+                continue;
+            }
+            int numPackets = 0;
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                Packets.push_back(packet);
+                numPackets = static_cast<int>(Packets.size());
+            }
+            if (TelemetryPort != 0 && numPackets % TelemetryInterval == 0) {
+                SendTelemetry(packet);
+            }
+        }
+    }
+};
+
+} // namespace OVRFW
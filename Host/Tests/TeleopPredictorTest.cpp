@@ -0,0 +1,172 @@
+/************************************************************************************
+
+Filename    :   TeleopPredictorTest.cpp
+Content     :   Replays synthetic pose traces through the teleop predictor and checks how much
+                closer it gets to where the body is when the robot acts
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "TeleopPredictor.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <random>
+
+#include "OVR_Math.h"
+
+using namespace OVRFW;
+using OVR::Quatf;
+using OVR::Vector3f;
+
+namespace {
+
+const double PI = 3.14159265358979;
+const double SAMPLE_HZ = 72.0;
+const double SEND_HZ = 250.0;
+const double HORIZON_SECONDS = 0.08;
+
+// Head yaw swinging +/- 60 degrees at 1 Hz, with its exact derivatives.
+ovrRigidBodyPosef YawTrace(const double t, const double noise) {
+    const double amplitude = 60.0 * PI / 180.0;
+    const double w = 2.0 * PI;
+    const float yaw = static_cast<float>(amplitude * sin(w * t));
+    ovrRigidBodyPosef pose = {};
+    pose.Pose.Orientation = Quatf(Vector3f(0.0f, 1.0f, 0.0f), yaw);
+    pose.AngularVelocity = {0.0f, static_cast<float>(amplitude * w * cos(w * t) + noise), 0.0f};
+    pose.AngularAcceleration = {0.0f, static_cast<float>(-amplitude * w * w * sin(w * t)), 0.0f};
+    pose.TimeInSeconds = t;
+    return pose;
+}
+
+// A hand reaching 0.3 m forward and back at 0.5 Hz.
+ovrRigidBodyPosef ReachTrace(const double t) {
+    const double amplitude = 0.3;
+    const double w = PI;
+    ovrRigidBodyPosef pose = {};
+    pose.Pose.Orientation.w = 1.0f;
+    pose.Pose.Position = {0.0f, 1.0f, static_cast<float>(-amplitude * sin(w * t))};
+    pose.LinearVelocity = {0.0f, 0.0f, static_cast<float>(-amplitude * w * cos(w * t))};
+    pose.LinearAcceleration = {0.0f, 0.0f, static_cast<float>(amplitude * w * w * sin(w * t))};
+    pose.TimeInSeconds = t;
+    return pose;
+}
+
+float AngleDegrees(const ovrQuatf& a, const ovrQuatf& b) {
+    const float dot = fabsf(Quatf(a).Dot(Quatf(b)));
+    return 2.0f * acosf(std::min(dot, 1.0f)) * 57.29578f;
+}
+
+// Runs the trace as the sender does: poses arrive at the display rate, packets go out at the
+// send rate and are predicted HORIZON_SECONDS past the send time. Returns the mean error of
+// the unpredicted and predicted poses against the trace at the target time.
+template <typename _trace_, typename _error_>
+void Replay(
+    const _trace_& trace,
+    const _error_& error,
+    const ovrTeleopPredictionParms& parms,
+    double& meanUnpredicted,
+    double& meanPredicted) {
+    ovrTeleopPredictor predictor;
+    double sumUnpredicted = 0.0;
+    double sumPredicted = 0.0;
+    int count = 0;
+    for (int i = 0; i < static_cast<int>(10.0 * SEND_HZ); i++) {
+        const double sendTime = 1.0 + i / SEND_HZ;
+        const ovrRigidBodyPosef sample = trace(floor(sendTime * SAMPLE_HZ) / SAMPLE_HZ);
+        const double target = sendTime + HORIZON_SECONDS;
+        const ovrRigidBodyPosef predicted = predictor.Predict(sample, target, parms);
+        const ovrRigidBodyPosef actual = trace(target);
+        sumUnpredicted += error(sample, actual);
+        sumPredicted += error(predicted, actual);
+        count++;
+    }
+    meanUnpredicted = sumUnpredicted / count;
+    meanPredicted = sumPredicted / count;
+}
+
+} // namespace
+
+int main(int, char**) {
+    const ovrTeleopPredictionParms parms;
+    const auto angleError = [](const ovrRigidBodyPosef& a, const ovrRigidBodyPosef& b) {
+        return AngleDegrees(a.Pose.Orientation, b.Pose.Orientation);
+    };
+    const auto positionError = [](const ovrRigidBodyPosef& a, const ovrRigidBodyPosef& b) {
+        return (Vector3f(a.Pose.Position) - Vector3f(b.Pose.Position)).Length() * 1000.0f;
+    };
+
+    // head yaw, 80 ms ahead
+    double unpredicted = 0.0;
+    double predicted = 0.0;
+    Replay([](double t) { return YawTrace(t, 0.0); }, angleError, parms, unpredicted, predicted);
+    printf("yaw: %.1f degrees unpredicted, %.1f predicted\n", unpredicted, predicted);
+    // the samples are up to a display frame old, which adds to the 19 degrees of the horizon
+    HOST_CHECK(unpredicted > 19.0 && unpredicted < 22.0);
+    HOST_CHECK(predicted < 5.0);
+
+    // noisy tracking velocities are filtered, so they cost little extra
+    std::mt19937 rng(1234);
+    std::normal_distribution<double> noise(0.0, 0.5);
+    double noisyPredicted = 0.0;
+    Replay(
+        [&rng, &noise](double t) { return YawTrace(t, noise(rng)); },
+        angleError,
+        parms,
+        unpredicted,
+        noisyPredicted);
+    printf("noisy yaw: %.1f degrees predicted\n", noisyPredicted);
+    HOST_CHECK(noisyPredicted < predicted + 1.5);
+
+    // a reaching hand
+    Replay(ReachTrace, positionError, parms, unpredicted, predicted);
+    printf("reach: %.1f mm unpredicted, %.1f predicted\n", unpredicted, predicted);
+    HOST_CHECK(predicted < unpredicted * 0.3);
+
+    // disabled, the pose passes through
+    {
+        ovrTeleopPredictionParms disabled;
+        disabled.Enabled = false;
+        ovrTeleopPredictor predictor;
+        const ovrRigidBodyPosef pose = YawTrace(1.1, 0.0);
+        const ovrRigidBodyPosef out = predictor.Predict(pose, 1.2, disabled);
+        HOST_CHECK_EQ(out.TimeInSeconds, pose.TimeInSeconds);
+        HOST_CHECK_EQ(AngleDegrees(out.Pose.Orientation, pose.Pose.Orientation), 0.0f);
+    }
+
+    // the horizon is capped, and the pose says for when it is
+    {
+        ovrTeleopPredictor predictor;
+        ovrRigidBodyPosef pose = {};
+        pose.Pose.Orientation.w = 1.0f;
+        pose.LinearVelocity = {1.0f, 0.0f, 0.0f};
+        pose.TimeInSeconds = 5.0;
+        const ovrRigidBodyPosef out = predictor.Predict(pose, 6.0, parms);
+        HOST_CHECK_NEAR(out.TimeInSeconds, 5.0 + parms.MaxPredictionSeconds, 1e-9);
+        HOST_CHECK_NEAR(out.Pose.Position.x, parms.MaxPredictionSeconds, 1e-5);
+        // a target in the past leaves the pose alone
+        HOST_CHECK_EQ(predictor.Predict(pose, 4.0, parms).Pose.Position.x, 0.0f);
+    }
+
+    // braking stops the motion where it would stop instead of reversing it
+    {
+        ovrTeleopPredictionParms full = parms;
+        full.AccelerationScale = 1.0f;
+        ovrTeleopPredictor predictor;
+        ovrRigidBodyPosef pose = {};
+        pose.Pose.Orientation.w = 1.0f;
+        pose.LinearVelocity = {1.0f, 0.0f, 0.0f};
+        pose.LinearAcceleration = {-50.0f, 0.0f, 0.0f}; // stops after 20 ms, 1 cm on
+        pose.TimeInSeconds = 2.0;
+        const ovrRigidBodyPosef out = predictor.Predict(pose, 2.1, full);
+        HOST_CHECK_NEAR(out.Pose.Position.x, 0.01, 1e-5);
+    }
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,122 @@
+/************************************************************************************
+
+Filename    :   TeleopProtocolBenchmark.cpp
+Content     :   Times encoding and decoding teleop keyframes and deltas
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+
+#include "TeleopProtocol.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <random>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+// A head and two controllers moving a little every packet, as at 250 Hz.
+std::vector<ovrTeleopWireState> MakeStates(const int count) {
+    std::mt19937 rng(1234);
+    std::vector<ovrTeleopWireState> states(count);
+    ovrTeleopWireState state;
+    TeleopClearWireState(state);
+    state.Connected = TELEOP_WIRE_FLAG_CONNECTED_MASK;
+    for (int i = 0; i < count; i++) {
+        const float yaw = i * 0.002f;
+        const float q[4] = {0.0f, sinf(yaw), 0.0f, cosf(yaw)};
+        state.Head.Orientation = TeleopQuantizeOrientation(q);
+        state.Head.Position[0] = static_cast<int16_t>(i % 200);
+        for (ovrTeleopWireController& c : state.Controllers) {
+            c.Pose.Orientation = TeleopQuantizeOrientation(q);
+            c.Pose.Position[rng() % 3] += static_cast<int16_t>(rng() % 5) - 2;
+            if (rng() % 16 == 0) {
+                c.IndexTrigger = static_cast<uint8_t>(rng());
+            }
+        }
+        states[i] = state;
+    }
+    return states;
+}
+
+// Encodes and decodes every state, acknowledging each packet right away when deltas is set.
+// Returns the bytes encoded.
+int64_t RunStream(
+    const std::vector<ovrTeleopWireState>& states,
+    const bool deltas,
+    double& encodeSeconds,
+    double& decodeSeconds) {
+    ovrTeleopEncoder encoder;
+    ovrTeleopDecoder decoder;
+    std::vector<uint8_t> packets(states.size() * TELEOP_WIRE_MAX_PACKET_SIZE);
+    std::vector<int> sizes(states.size());
+    int64_t bytes = 0;
+    int numFailed = 0;
+
+    // acknowledging is part of the sender's work per packet, so it is timed with the encode
+    double start = HostTestSeconds();
+    for (size_t i = 0; i < states.size(); i++) {
+        if (deltas && i > 0) {
+            encoder.Acknowledge(static_cast<uint32_t>(i));
+        }
+        sizes[i] = encoder.Encode(
+            states[i],
+            static_cast<uint32_t>(i),
+            0,
+            &packets[i * TELEOP_WIRE_MAX_PACKET_SIZE],
+            TELEOP_WIRE_MAX_PACKET_SIZE);
+        bytes += sizes[i];
+    }
+    encodeSeconds = HostTestSeconds() - start;
+
+    start = HostTestSeconds();
+    ovrTeleopWireHeader header;
+    ovrTeleopWireState decoded;
+    for (size_t i = 0; i < states.size(); i++) {
+        numFailed += decoder.Decode(
+                         &packets[i * TELEOP_WIRE_MAX_PACKET_SIZE], sizes[i], header, decoded) !=
+                TELEOP_DECODE_OK
+            ? 1
+            : 0;
+    }
+    decodeSeconds = HostTestSeconds() - start;
+
+    HOST_CHECK_EQ(numFailed, 0);
+    HOST_CHECK(TeleopDiffWireState(decoded, states.back()) == 0);
+    return bytes;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int count = HostTestQuick(argc, argv) ? 100000 : 5000000;
+    const std::vector<ovrTeleopWireState> states = MakeStates(count);
+
+    for (const bool deltas : {false, true}) {
+        double encodeSeconds = 0.0;
+        double decodeSeconds = 0.0;
+        const int64_t bytes = RunStream(states, deltas, encodeSeconds, decodeSeconds);
+        if (deltas) {
+            // the poses change every packet, the controls rarely
+            HOST_CHECK(bytes < static_cast<int64_t>(count) * 56);
+        }
+        printf(
+            "%s: %.1f bytes per packet, encode %.0f ns (%.2f M packets/s), decode %.0f ns "
+            "(%.2f M packets/s)\n",
+            deltas ? "deltas" : "keyframes",
+            static_cast<double>(bytes) / count,
+            encodeSeconds * 1e9 / count,
+            count / encodeSeconds * 1e-6,
+            decodeSeconds * 1e9 / count,
+            count / decodeSeconds * 1e-6);
+    }
+
+    return HOST_TEST_RESULT();
+}
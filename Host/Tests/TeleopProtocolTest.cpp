@@ -0,0 +1,483 @@
+/************************************************************************************
+
+Filename    :   TeleopProtocolTest.cpp
+Content     :   Round trips and fuzzes the teleop and telemetry wire formats, and checks that the
+                sender's sequence numbers carry on when it is restarted
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "TeleopLoopback.h"
+
+#include "TeleopProtocol.h"
+#include "TeleopSender.h"
+
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+// header, head and both controllers
+const int KEYFRAME_SIZE = 18 + 10 + 2 * 18;
+
+typedef std::vector<uint8_t> Packet;
+
+bool SameState(const ovrTeleopWireState& a, const ovrTeleopWireState& b) {
+    return a.Connected == b.Connected && TeleopDiffWireState(a, b) == 0;
+}
+
+uint32_t RandomOrientation(std::mt19937& rng) {
+    std::normal_distribution<float> normal;
+    const float q[4] = {normal(rng), normal(rng), normal(rng), normal(rng)};
+    return TeleopQuantizeOrientation(q);
+}
+
+void RandomPose(std::mt19937& rng, ovrTeleopWirePose& pose) {
+    for (int i = 0; i < 3; i++) {
+        pose.Position[i] = static_cast<int16_t>(rng());
+    }
+    pose.Orientation = RandomOrientation(rng);
+}
+
+ovrTeleopWireState RandomState(std::mt19937& rng) {
+    ovrTeleopWireState state;
+    TeleopClearWireState(state);
+    state.Connected = rng() & TELEOP_WIRE_FLAG_CONNECTED_MASK;
+    RandomPose(rng, state.Head);
+    for (ovrTeleopWireController& c : state.Controllers) {
+        RandomPose(rng, c.Pose);
+        c.IndexTrigger = static_cast<uint8_t>(rng());
+        c.GripTrigger = static_cast<uint8_t>(rng());
+        c.Joystick[0] = static_cast<int8_t>(rng());
+        c.Joystick[1] = static_cast<int8_t>(rng());
+        c.Buttons = static_cast<uint16_t>(rng());
+        c.Touches = static_cast<uint16_t>(rng());
+    }
+    return state;
+}
+
+// The next state of an operator: the head always moves, the rest now and then.
+void Walk(std::mt19937& rng, ovrTeleopWireState& state) {
+    state.Head.Position[rng() % 3] += static_cast<int16_t>(rng() % 5) - 2;
+    state.Head.Orientation = RandomOrientation(rng);
+    for (ovrTeleopWireController& c : state.Controllers) {
+        if (rng() % 2 == 0) {
+            c.Pose.Position[rng() % 3] += static_cast<int16_t>(rng() % 9) - 4;
+            c.Pose.Orientation = RandomOrientation(rng);
+        }
+        if (rng() % 8 == 0) {
+            c.IndexTrigger = static_cast<uint8_t>(rng());
+        }
+        if (rng() % 32 == 0) {
+            c.Buttons ^= 1 << (rng() % 16);
+        }
+    }
+}
+
+Packet Encode(ovrTeleopEncoder& encoder, const ovrTeleopWireState& state, const uint32_t time) {
+    Packet packet(TELEOP_WIRE_MAX_PACKET_SIZE);
+    const int size =
+        encoder.Encode(state, time, -1234, packet.data(), static_cast<int>(packet.size()));
+    packet.resize(size);
+    return packet;
+}
+
+ovrTeleopDecodeResult Decode(ovrTeleopDecoder& decoder, const Packet& packet) {
+    ovrTeleopWireHeader header;
+    ovrTeleopWireState state;
+    return decoder.Decode(packet.data(), static_cast<int>(packet.size()), header, state);
+}
+
+// Streams count states through a channel that drops loss of the packets and delivers the rest
+// up to maxDelay steps late, with the receiver acknowledging the newest packet it decoded two
+// steps later. Checks every decoded state and returns the number of deltas with a missing base.
+int StreamStates(
+    std::mt19937& rng,
+    const int count,
+    const double loss,
+    const int maxDelay,
+    int& numDeltas,
+    double& meanDeltaSize) {
+    ovrTeleopEncoder encoder;
+    ovrTeleopDecoder decoder;
+    std::vector<ovrTeleopWireState> sent(1);
+    std::vector<std::pair<int, Packet>> inFlight;
+    std::deque<uint32_t> acks;
+    std::uniform_real_distribution<double> uniform;
+    uint32_t newest = 0;
+    int numMissingBase = 0;
+    int numWrong = 0;
+    int64_t deltaBytes = 0;
+    numDeltas = 0;
+
+    ovrTeleopWireState state = RandomState(rng);
+    for (int step = 0; step < count || !inFlight.empty(); step++) {
+        if (step < count) {
+            Walk(rng, state);
+            sent.push_back(state);
+            const Packet packet = Encode(encoder, state, step);
+            if ((packet[3] & TELEOP_WIRE_FLAG_DELTA) != 0) {
+                numDeltas++;
+                deltaBytes += packet.size();
+            }
+            if (uniform(rng) >= loss) {
+                const int arrival = step + static_cast<int>(rng() % (maxDelay + 1));
+                inFlight.push_back(std::make_pair(arrival, packet));
+            }
+        }
+        for (size_t i = 0; i < inFlight.size();) {
+            if (inFlight[i].first > step) {
+                i++;
+                continue;
+            }
+            ovrTeleopWireHeader header;
+            ovrTeleopWireState decoded;
+            const Packet& packet = inFlight[i].second;
+            const ovrTeleopDecodeResult result = decoder.Decode(
+                packet.data(), static_cast<int>(packet.size()), header, decoded);
+            if (result == TELEOP_DECODE_OK) {
+                numWrong += SameState(decoded, sent[header.Sequence]) ? 0 : 1;
+                newest = std::max(newest, header.Sequence);
+            } else {
+                numMissingBase += (result == TELEOP_DECODE_MISSING_BASE) ? 1 : 0;
+                numWrong += (result == TELEOP_DECODE_MALFORMED) ? 1 : 0;
+            }
+            inFlight.erase(inFlight.begin() + i);
+        }
+        acks.push_back(newest);
+        if (acks.size() > 2) {
+            if (acks.front() != 0) {
+                encoder.Acknowledge(acks.front());
+            }
+            acks.pop_front();
+        }
+    }
+    HOST_CHECK_EQ(numWrong, 0);
+    meanDeltaSize = numDeltas > 0 ? static_cast<double>(deltaBytes) / numDeltas : 0.0;
+    return numMissingBase;
+}
+
+ovrTeleopTelemetry RandomTelemetry(std::mt19937& rng) {
+    ovrTeleopTelemetry t;
+    memset(&t, 0, sizeof(t));
+    t.Sequence = rng();
+    t.AckedSequence = rng();
+    t.AckedSendTimeMicros = rng();
+    t.AckHoldMicros = rng() % 100000;
+    t.BatteryVolts = (rng() % 25000) * 0.001f;
+    t.BatteryPercent = static_cast<uint8_t>(rng() % 101);
+    t.WifiRssi = static_cast<int8_t>(-(rng() % 100));
+    t.TeleopPacketsReceived = rng();
+    t.TeleopPacketsLost = rng();
+    t.NumServos = rng() % (TELEMETRY_MAX_SERVOS + 1);
+    for (int i = 0; i < t.NumServos; i++) {
+        t.ServoPositionDegrees[i] = (static_cast<int>(rng() % 36000) - 18000) * 0.01f;
+        t.ServoCurrentAmps[i] = (rng() % 5000) * 0.001f;
+    }
+    t.NumMotors = rng() % (TELEMETRY_MAX_MOTORS + 1);
+    for (int i = 0; i < t.NumMotors; i++) {
+        t.MotorTemperatureCelsius[i] = (rng() % 1000) * 0.1f;
+    }
+    return t;
+}
+
+} // namespace
+
+int main(int, char**) {
+    std::mt19937 rng(1234);
+
+    // quantization stays within half a step, and orientations within a quarter degree
+    {
+        float maxAngle = 0.0f;
+        std::normal_distribution<float> normal;
+        for (int i = 0; i < 100000; i++) {
+            float q[4] = {normal(rng), normal(rng), normal(rng), normal(rng)};
+            const float length = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            for (float& c : q) {
+                c /= length;
+            }
+            float r[4];
+            TeleopDequantizeOrientation(TeleopQuantizeOrientation(q), r);
+            const float dot = fabsf(q[0] * r[0] + q[1] * r[1] + q[2] * r[2] + q[3] * r[3]);
+            maxAngle = std::max(maxAngle, 2.0f * acosf(std::min(dot, 1.0f)) * 57.29578f);
+
+            const float meters = (static_cast<int>(rng() % 60000) - 30000) * 0.001003f;
+            // half a millimeter, and float rounding at 30 m
+            const float position = TeleopDequantizePosition(TeleopQuantizePosition(meters));
+            HOST_CHECK_NEAR(position, meters, 5e-4 + 4e-6);
+            const float unit = (rng() % 10001) * 1e-4f;
+            HOST_CHECK_NEAR(TeleopDequantizeUnit(TeleopQuantizeUnit(unit)), unit, 0.5 / 255 + 1e-6);
+            const float axis = unit * 2.0f - 1.0f;
+            HOST_CHECK_NEAR(
+                TeleopDequantizeSigned(TeleopQuantizeSigned(axis)), axis, 0.5 / 127 + 1e-6);
+        }
+        HOST_CHECK(maxAngle < 0.25f);
+        printf("worst orientation error %.3f degrees\n", maxAngle);
+
+        // out of range values clamp
+        HOST_CHECK_EQ(TeleopQuantizePosition(100.0f), int16_t(32767));
+        HOST_CHECK_EQ(TeleopQuantizeUnit(-1.0f), uint8_t(0));
+        HOST_CHECK_EQ(TeleopQuantizeSigned(2.0f), int8_t(127));
+        const float zero[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float identity[4];
+        TeleopDequantizeOrientation(TeleopQuantizeOrientation(zero), identity);
+        HOST_CHECK_NEAR(identity[3], 1.0, 1e-6);
+
+        // every ovrButton and ovrTouch bit the format carries comes back
+        uint32_t buttonMask = TELEOP_WIRE_BUTTON_JOYSTICK;
+        for (const uint32_t b : TeleopWireButtons) {
+            buttonMask |= b;
+        }
+        for (int i = 0; i < 10000; i++) {
+            const uint32_t buttons = rng();
+            const uint32_t touches = rng();
+            uint16_t wireButtons;
+            uint16_t wireTouches;
+            TeleopPackInput(buttons, touches, wireButtons, wireTouches);
+            uint32_t unpackedButtons;
+            uint32_t unpackedTouches;
+            TeleopUnpackInput(wireButtons, wireTouches, unpackedButtons, unpackedTouches);
+            HOST_CHECK_EQ(unpackedButtons, buttons & buttonMask);
+            HOST_CHECK_EQ(unpackedTouches, touches & TELEOP_WIRE_TOUCH_MASK);
+        }
+    }
+
+    // keyframes carry everything, and come back exactly
+    {
+        ovrTeleopEncoder encoder;
+        ovrTeleopDecoder decoder;
+        int numWrong = 0;
+        for (uint32_t i = 1; i <= 10000; i++) {
+            const ovrTeleopWireState state = RandomState(rng);
+            const Packet packet = Encode(encoder, state, i * 4000);
+            HOST_CHECK_EQ(static_cast<int>(packet.size()), KEYFRAME_SIZE);
+            ovrTeleopWireHeader header;
+            ovrTeleopWireState decoded;
+            const bool ok = decoder.Decode(
+                                packet.data(), static_cast<int>(packet.size()), header, decoded) ==
+                    TELEOP_DECODE_OK &&
+                SameState(decoded, state) && !header.Delta && header.Sequence == i &&
+                header.SendTimeMicros == i * 4000 && header.PoseTimeOffsetMicros == -1234;
+            numWrong += ok ? 0 : 1;
+        }
+        HOST_CHECK_EQ(numWrong, 0);
+    }
+
+    // deltas over a lossy link, in order and reordered; a delta only fails when its base was
+    // pushed out of the receiver's history by a packet that overtook it
+    {
+        int numDeltas = 0;
+        double meanDeltaSize = 0.0;
+        HOST_CHECK_EQ(StreamStates(rng, 20000, 0.1, 0, numDeltas, meanDeltaSize), 0);
+        HOST_CHECK(numDeltas > 15000);
+        // every pose moves in most packets, so what deltas save is mostly the controls
+        HOST_CHECK(meanDeltaSize < KEYFRAME_SIZE - 8);
+        printf("%d deltas, %.1f bytes on average\n", numDeltas, meanDeltaSize);
+        const int numMissingBase = StreamStates(rng, 20000, 0.1, 3, numDeltas, meanDeltaSize);
+        HOST_CHECK(numMissingBase < 200);
+    }
+
+    // a restarted receiver gets a keyframe within the history, without any acknowledgement
+    {
+        ovrTeleopEncoder encoder;
+        ovrTeleopDecoder decoder;
+        ovrTeleopWireState state = RandomState(rng);
+        for (int i = 0; i < 10; i++) {
+            Walk(rng, state);
+            const Packet packet = Encode(encoder, state, i);
+            HOST_CHECK_EQ(Decode(decoder, packet), TELEOP_DECODE_OK);
+            encoder.Acknowledge(i + 1);
+        }
+        decoder.Reset();
+        int numLost = 0;
+        for (; numLost < 100; numLost++) {
+            Walk(rng, state);
+            if (Decode(decoder, Encode(encoder, state, 0)) == TELEOP_DECODE_OK) {
+                break;
+            }
+        }
+        HOST_CHECK(numLost < ovrTeleopWireHistory::HISTORY_SIZE);
+
+        // acknowledging a packet that was never sent changes nothing
+        encoder.Reset();
+        encoder.Acknowledge(5);
+        Packet packet = Encode(encoder, state, 0);
+        HOST_CHECK_EQ((packet[3] & TELEOP_WIRE_FLAG_DELTA), 0);
+    }
+
+    // a reset encoder goes on from the sequence it is given, and never uses 0
+    {
+        ovrTeleopEncoder encoder;
+        ovrTeleopDecoder decoder;
+        ovrTeleopWireHeader header;
+        ovrTeleopWireState decoded;
+        const ovrTeleopWireState state = RandomState(rng);
+        encoder.Reset(1000);
+        Packet packet = Encode(encoder, state, 0);
+        decoder.Decode(packet.data(), static_cast<int>(packet.size()), header, decoded);
+        HOST_CHECK_EQ(header.Sequence, uint32_t(1000));
+        HOST_CHECK_EQ(encoder.GetNextSequence(), uint32_t(1001));
+        encoder.Reset(0xFFFFFFFF);
+        Encode(encoder, state, 0);
+        HOST_CHECK_EQ(encoder.GetNextSequence(), uint32_t(1));
+        encoder.Reset(0);
+        HOST_CHECK_EQ(encoder.GetNextSequence(), uint32_t(1));
+    }
+
+    // damaged packets never decode: cut short, extended, with a wrong magic, version or mask;
+    // random damage doesn't crash the decoder or spoil its history
+    {
+        ovrTeleopEncoder encoder;
+        ovrTeleopDecoder decoder;
+        ovrTeleopWireState state = RandomState(rng);
+        const Packet keyframe = Encode(encoder, state, 0);
+        HOST_CHECK_EQ(Decode(decoder, keyframe), TELEOP_DECODE_OK);
+        encoder.Acknowledge(1);
+        Walk(rng, state);
+        const Packet delta = Encode(encoder, state, 0);
+        HOST_CHECK((delta[3] & TELEOP_WIRE_FLAG_DELTA) != 0);
+        int numDecoded = 0;
+        for (const Packet& valid : {keyframe, delta}) {
+            for (size_t size = 0; size < valid.size(); size++) {
+                const Packet cut(valid.begin(), valid.begin() + size);
+                numDecoded += Decode(decoder, cut) == TELEOP_DECODE_OK ? 1 : 0;
+            }
+            Packet extended = valid;
+            extended.push_back(0);
+            numDecoded += Decode(decoder, extended) == TELEOP_DECODE_OK ? 1 : 0;
+            for (const int byte : {0, 1, 2}) {
+                Packet wrong = valid;
+                wrong[byte] ^= 0x10;
+                numDecoded += Decode(decoder, wrong) == TELEOP_DECODE_OK ? 1 : 0;
+            }
+        }
+        Packet badMask = keyframe;
+        badMask[17] |= 0x80;
+        numDecoded += Decode(decoder, badMask) == TELEOP_DECODE_OK ? 1 : 0;
+        HOST_CHECK_EQ(numDecoded, 0);
+
+        for (int i = 0; i < 200000; i++) {
+            Packet fuzzed = (rng() % 2 == 0) ? keyframe : delta;
+            switch (rng() % 4) {
+                case 0:
+                    fuzzed[rng() % fuzzed.size()] ^= static_cast<uint8_t>(1 << (rng() % 8));
+                    break;
+                case 1:
+                    fuzzed[4 + rng() % (fuzzed.size() - 4)] = static_cast<uint8_t>(rng());
+                    break;
+                case 2:
+                    fuzzed.resize(rng() % (TELEOP_WIRE_MAX_PACKET_SIZE * 2));
+                    break;
+                default:
+                    for (size_t j = 4; j < fuzzed.size(); j++) {
+                        fuzzed[j] = static_cast<uint8_t>(rng());
+                    }
+                    break;
+            }
+            Decode(decoder, fuzzed);
+        }
+        ovrTeleopWireHeader header;
+        ovrTeleopWireState decoded;
+        Walk(rng, state);
+        encoder.Reset(1000000);
+        const Packet after = Encode(encoder, state, 0);
+        HOST_CHECK_EQ(
+            decoder.Decode(after.data(), static_cast<int>(after.size()), header, decoded),
+            TELEOP_DECODE_OK);
+        HOST_CHECK(SameState(decoded, state));
+    }
+
+    // telemetry round trips to its wire precision, and damaged packets don't decode
+    {
+        int numWrong = 0;
+        for (int i = 0; i < 10000; i++) {
+            const ovrTeleopTelemetry t = RandomTelemetry(rng);
+            uint8_t buffer[TELEMETRY_WIRE_MAX_PACKET_SIZE];
+            const int size = TelemetryEncode(t, buffer, sizeof(buffer));
+            HOST_CHECK_EQ(size, 32 + t.NumServos * 4 + t.NumMotors * 2);
+            ovrTeleopTelemetry d;
+            if (!TelemetryDecode(buffer, size, d)) {
+                numWrong++;
+                continue;
+            }
+            bool ok = d.Sequence == t.Sequence && d.AckedSequence == t.AckedSequence &&
+                d.AckedSendTimeMicros == t.AckedSendTimeMicros &&
+                d.AckHoldMicros == t.AckHoldMicros &&
+                fabsf(d.BatteryVolts - t.BatteryVolts) < 1e-3f &&
+                d.BatteryPercent == t.BatteryPercent && d.WifiRssi == t.WifiRssi &&
+                d.TeleopPacketsReceived == t.TeleopPacketsReceived &&
+                d.TeleopPacketsLost == t.TeleopPacketsLost && d.NumServos == t.NumServos &&
+                d.NumMotors == t.NumMotors;
+            for (int j = 0; j < t.NumServos; j++) {
+                ok = ok && fabsf(d.ServoPositionDegrees[j] - t.ServoPositionDegrees[j]) < 0.006f &&
+                    fabsf(d.ServoCurrentAmps[j] - t.ServoCurrentAmps[j]) < 6e-4f;
+            }
+            for (int j = 0; j < t.NumMotors; j++) {
+                const float error = d.MotorTemperatureCelsius[j] - t.MotorTemperatureCelsius[j];
+                ok = ok && fabsf(error) < 0.06f;
+            }
+            numWrong += ok ? 0 : 1;
+
+            for (int cut = 0; cut < size; cut++) {
+                numWrong += TelemetryDecode(buffer, cut, d) ? 1 : 0;
+            }
+            buffer[0] ^= 1;
+            numWrong += TelemetryDecode(buffer, size, d) ? 1 : 0;
+        }
+        HOST_CHECK_EQ(numWrong, 0);
+        for (int i = 0; i < 100000; i++) {
+            uint8_t buffer[TELEMETRY_WIRE_MAX_PACKET_SIZE + 8];
+            for (uint8_t& b : buffer) {
+                b = static_cast<uint8_t>(rng());
+            }
+            buffer[0] = static_cast<uint8_t>(TELEMETRY_WIRE_MAGIC);
+            buffer[1] = static_cast<uint8_t>(TELEMETRY_WIRE_MAGIC >> 8);
+            buffer[2] = TELEMETRY_WIRE_VERSION;
+            ovrTeleopTelemetry d;
+            TelemetryDecode(buffer, static_cast<int>(rng() % sizeof(buffer)), d);
+        }
+    }
+
+    // a sender that is stopped and started again goes on with its sequence numbers, so the
+    // robot doesn't drop the resumed stream as old packets
+    {
+        ovrTeleopLoopback loopback;
+        HOST_CHECK(loopback.Start());
+        ovrTeleopSender sender;
+        ovrTeleopState state;
+        state.HeadPose.Pose.Orientation.w = 1.0f;
+        for (int run = 0; run < 2; run++) {
+            HOST_CHECK(sender.Start("127.0.0.1", loopback.GetPort(), 250));
+            const double end = HostTestSeconds() + 0.1;
+            while (HostTestSeconds() < end) {
+                state.HeadPose.TimeInSeconds = ovrTeleopSender::GetTimeMicros() * 1e-6;
+                state.PoseTime = state.HeadPose.TimeInSeconds;
+                sender.SetState(state);
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            sender.Stop();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        loopback.Stop();
+        const std::vector<ovrTeleopLoopbackPacket> packets = loopback.GetPackets();
+        HOST_CHECK(packets.size() > 20);
+        int numGaps = 0;
+        for (size_t i = 1; i < packets.size(); i++) {
+            numGaps += (packets[i].Header.Sequence != packets[i - 1].Header.Sequence + 1) ? 1 : 0;
+        }
+        HOST_CHECK_EQ(numGaps, 0);
+    }
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,137 @@
+/************************************************************************************
+
+Filename    :   TeleopSenderBenchmark.cpp
+Content     :   Streams teleop packets to a loopback receiver and measures the send jitter and
+                the latency from send to receive
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "TeleopLoopback.h"
+
+#include "TeleopSender.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+const int RATE_HZ = 250;
+const int DISPLAY_HZ = 72;
+
+double Percentile(std::vector<double> values, const double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+}
+
+double Mean(const std::vector<double>& values) {
+    double sum = 0.0;
+    for (const double v : values) {
+        sum += v;
+    }
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = HostTestQuick(argc, argv) ? 0.5 : 5.0;
+
+    ovrTeleopLoopback loopback;
+    HOST_CHECK(loopback.Start());
+    ovrTeleopSender sender;
+    HOST_CHECK(!sender.Start("127.0.0.1", 0, RATE_HZ));
+    HOST_CHECK(sender.Start("127.0.0.1", loopback.GetPort(), RATE_HZ));
+
+    // the render loop publishes at the display rate, the sender sends at its own
+    ovrTeleopState state;
+    state.HeadPose.Pose.Orientation.w = 1.0f;
+    state.HeadPose.Pose.Position = {0.1f, 1.6f, -0.2f};
+    const double end = HostTestSeconds() + seconds;
+    while (HostTestSeconds() < end) {
+        state.HeadPose.TimeInSeconds = ovrTeleopSender::GetTimeMicros() * 1e-6;
+        state.PoseTime = state.HeadPose.TimeInSeconds;
+        sender.SetState(state);
+        std::this_thread::sleep_for(std::chrono::microseconds(1000000 / DISPLAY_HZ));
+    }
+    sender.Stop();
+    HOST_CHECK(!sender.IsRunning());
+    const ovrTeleopSenderStats stats = sender.GetStats();
+    // the last datagrams are still on their way
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    loopback.Stop();
+
+    // every packet sent arrives, in order, as it was sent
+    const std::vector<ovrTeleopLoopbackPacket> packets = loopback.GetPackets();
+    HOST_CHECK(!packets.empty());
+    HOST_CHECK_EQ(loopback.GetNumMalformed(), 0);
+    HOST_CHECK_EQ(static_cast<uint32_t>(packets.size()), stats.PacketsSent);
+    HOST_CHECK_EQ(stats.SendErrors, uint32_t(0));
+    int numGaps = 0;
+    for (size_t i = 1; i < packets.size(); i++) {
+        numGaps += (packets[i].Header.Sequence != packets[i - 1].Header.Sequence + 1) ? 1 : 0;
+    }
+    HOST_CHECK_EQ(numGaps, 0);
+    if (!packets.empty()) {
+        const ovrTeleopWireState& last = packets.back().State;
+        HOST_CHECK_EQ(last.Head.Position[0], int16_t(100));
+        HOST_CHECK_EQ(last.Head.Position[1], int16_t(1600));
+        HOST_CHECK_EQ(last.Head.Position[2], int16_t(-200));
+        HOST_CHECK_EQ(last.Connected, uint8_t(0));
+    }
+
+    // the sender keeps its rate whatever the display rate, apart from ticks it had to skip
+    const double expected = seconds * RATE_HZ;
+    HOST_CHECK(stats.PacketsSent + stats.MissedTicks > expected * 0.8);
+    HOST_CHECK(stats.PacketsSent + stats.MissedTicks < expected * 1.2);
+
+    std::vector<double> latencies;
+    std::vector<double> arrivalJitter;
+    for (size_t i = 0; i < packets.size(); i++) {
+        const uint32_t received = packets[i].ReceiveTimeMicros;
+        const uint32_t sent = packets[i].Header.SendTimeMicros;
+        latencies.push_back(static_cast<int32_t>(received - sent) * 1e-3);
+        if (i > 0) {
+            const uint32_t previous = packets[i - 1].ReceiveTimeMicros;
+            const int32_t interval = static_cast<int32_t>(received - previous);
+            arrivalJitter.push_back(abs(interval - 1000000 / RATE_HZ) * 1e-3);
+        }
+    }
+    // loose enough for a loaded machine; on an idle one both are well under a millisecond
+    HOST_CHECK(Percentile(latencies, 0.5) >= 0.0);
+    HOST_CHECK(Percentile(latencies, 0.5) < 5.0);
+    HOST_CHECK(stats.MeanJitterSeconds < 0.002);
+
+    printf(
+        "%u packets at %d Hz, %u missed ticks, %u bytes\n"
+        "send jitter: mean %.3f ms, max %.3f ms\n"
+        "arrival jitter: mean %.3f ms, p99 %.3f ms\n"
+        "latency: mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+        stats.PacketsSent,
+        RATE_HZ,
+        stats.MissedTicks,
+        stats.BytesSent,
+        stats.MeanJitterSeconds * 1e3,
+        stats.MaxJitterSeconds * 1e3,
+        Mean(arrivalJitter),
+        Percentile(arrivalJitter, 0.99),
+        Mean(latencies),
+        Percentile(latencies, 0.5),
+        Percentile(latencies, 0.99),
+        Percentile(latencies, 1.0));
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,160 @@
+/************************************************************************************
+
+Filename    :   TextureDecodeBenchmark.cpp
+Content     :   Times decoding images with their mip chains on one thread and spread over the
+                loader pool, and checks that no texture load generates its mips on the GPU
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostGui.h"
+#include "NullGl.h"
+
+#include "AsyncLoader.h"
+#include "Render/GlTexture.h"
+
+#include <stdio.h>
+#include <memory>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+// An uncompressed 32 bit .tga, top row first, with pixel( x, y ) giving RGBA.
+template <typename _pixel_>
+std::vector<uint8_t> MakeTga(const int width, const int height, const _pixel_& pixel) {
+    std::vector<uint8_t> tga(18, 0);
+    tga[2] = 2; // uncompressed true color
+    tga[12] = static_cast<uint8_t>(width);
+    tga[13] = static_cast<uint8_t>(width >> 8);
+    tga[14] = static_cast<uint8_t>(height);
+    tga[15] = static_cast<uint8_t>(height >> 8);
+    tga[16] = 32;
+    tga[17] = 0x28; // top left origin, 8 alpha bits
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const uint32_t rgba = pixel(x, y);
+            tga.push_back(static_cast<uint8_t>(rgba >> 16));
+            tga.push_back(static_cast<uint8_t>(rgba >> 8));
+            tga.push_back(static_cast<uint8_t>(rgba));
+            tga.push_back(static_cast<uint8_t>(rgba >> 24));
+        }
+    }
+    return tga;
+}
+
+// Stands in for a photo: not flat, so the filter has real work to do.
+uint32_t NoisePixel(const int x, const int y) {
+    uint32_t h = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u;
+    h ^= h >> 13;
+    return h | 0xFF000000u;
+}
+
+double DecodeAll(
+    const std::vector<std::vector<uint8_t>>& images,
+    const TextureFlags_t& flags,
+    ovrAsyncLoader* loader) {
+    std::vector<std::unique_ptr<ovrDecodedTexture>> decoded(images.size());
+    auto decode = [&images, &flags, &decoded](int i) {
+        decoded[i].reset(new ovrDecodedTexture());
+        HOST_CHECK(DecodeTextureBuffer(
+            "image.tga", images[i].data(), images[i].size(), flags, *decoded[i]));
+    };
+    const double start = HostTestSeconds();
+    if (loader != nullptr) {
+        loader->ParallelFor(static_cast<int>(images.size()), decode);
+    } else {
+        for (int i = 0; i < static_cast<int>(images.size()); i++) {
+            decode(i);
+        }
+    }
+    const double seconds = HostTestSeconds() - start;
+    for (const std::unique_ptr<ovrDecodedTexture>& d : decoded) {
+        HOST_CHECK(d != nullptr && d->NumLevels > 1);
+    }
+    return seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = HostTestQuick(argc, argv);
+    const int size = quick ? 256 : 2048;
+    const int numImages = quick ? 4 : 16;
+
+    ovrHostGui gui;
+
+    // the synchronous load uploads the CPU built levels, the same as the decoded path
+    const std::vector<uint8_t> noise = MakeTga(size, size, NoisePixel);
+    ovrNullGl::ResetStats();
+    int width = 0;
+    int height = 0;
+    GlTexture texture = LoadTextureFromBuffer(
+        "noise.tga", noise.data(), noise.size(), TextureFlags_t(), width, height);
+    HOST_CHECK(texture.texture != 0);
+    HOST_CHECK_EQ(width, size);
+    int numLevels = 1;
+    while ((size >> (numLevels - 1)) > 1) {
+        numLevels++;
+    }
+    HOST_CHECK_EQ(ovrNullGl::GetStats().TextureUploads, numLevels);
+    HOST_CHECK_EQ(ovrNullGl::GetStats().GenerateMipmapCalls, 0);
+    HOST_CHECK_EQ(
+        ovrNullGl::GetStats().TextureBytes,
+        static_cast<int64_t>(GetTextureMemorySize(Texture_RGBA, size, size, numLevels, 1)));
+    DeleteTexture(texture);
+
+    // unless there are no mips to build
+    ovrNullGl::ResetStats();
+    texture = LoadTextureFromBuffer(
+        "noise.tga", noise.data(), noise.size(), TEXTUREFLAG_NO_MIPMAPS, width, height);
+    HOST_CHECK_EQ(ovrNullGl::GetStats().TextureUploads, 1);
+    HOST_CHECK_EQ(ovrNullGl::GetStats().GenerateMipmapCalls, 0);
+    DeleteTexture(texture);
+
+    // sRGB color is averaged in linear space: half black, half white is 188, not 128
+    const std::vector<uint8_t> split =
+        MakeTga(2, 2, [](int x, int) { return x == 0 ? 0xFF000000u : 0xFFFFFFFFu; });
+    for (const bool srgb : {false, true}) {
+        ovrDecodedTexture decoded;
+        HOST_CHECK(DecodeTextureBuffer(
+            "split.tga",
+            split.data(),
+            split.size(),
+            srgb ? TextureFlags_t(TEXTUREFLAG_USE_SRGB) : TextureFlags_t(),
+            decoded));
+        HOST_CHECK_EQ(decoded.NumLevels, 2);
+        if (decoded.NumLevels == 2) {
+            const uint8_t* level1 = decoded.Pixels + 2 * 2 * 4;
+            HOST_CHECK_EQ(static_cast<int>(level1[0]), srgb ? 188 : 128);
+            HOST_CHECK_EQ(static_cast<int>(level1[3]), 255);
+        }
+    }
+
+    // decoding a model's images on one thread, and on the loader pool
+    std::vector<std::vector<uint8_t>> images(numImages, noise);
+    ovrAsyncLoader loader;
+    loader.Init(4);
+    const double serialSeconds = DecodeAll(images, TextureFlags_t(), nullptr);
+    const double parallelSeconds = DecodeAll(images, TextureFlags_t(), &loader);
+    const double srgbSeconds = DecodeAll(images, TEXTUREFLAG_USE_SRGB, &loader);
+    loader.Shutdown();
+
+    printf(
+        "%d %dx%d images with mips: %.1f ms on one thread, %.1f ms on the pool (%.1fx), "
+        "%.1f ms sRGB\n",
+        numImages,
+        size,
+        size,
+        serialSeconds * 1000.0,
+        parallelSeconds * 1000.0,
+        serialSeconds / parallelSeconds,
+        srgbSeconds * 1000.0);
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,265 @@
+/************************************************************************************
+
+Filename    :   TextureResidencyTest.cpp
+Content     :   Checks the residency policy against a fake allocator, that the texture
+                manager drops mip levels without reading or decoding the file again, and
+                that menu surfaces release the textures they load
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostGui.h"
+#include "NullGl.h"
+
+#include "GUI/VRMenuMgr.h"
+#include "GUI/VRMenuObject.h"
+#include "OVR_FileSys.h"
+#include "Render/TextureManager.h"
+#include "Render/TextureResidency.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace OVRFW;
+
+namespace {
+
+//==============================================================
+// ovrFakeAllocator
+// Textures of any size, that shrink to a quarter for each dropped level down to MinSize.
+class ovrFakeAllocator : public ovrTextureResidencyAllocator {
+   public:
+    explicit ovrFakeAllocator(size_t const minSize) : MinSize(minSize) {}
+
+    virtual void EvictTexture(int const id) override {
+        Log.push_back("evict" + std::to_string(id));
+    }
+    virtual size_t DropTopMip(int const id) override {
+        if (Sizes[id] / 4 < MinSize) {
+            Log.push_back("refuse" + std::to_string(id));
+            return 0;
+        }
+        Sizes[id] /= 4;
+        Log.push_back("drop" + std::to_string(id));
+        return Sizes[id];
+    }
+
+    size_t MinSize;
+    std::unordered_map<int, size_t> Sizes;
+    std::vector<std::string> Log;
+};
+
+//==============================================================
+// ovrMemoryFileSys
+// Serves files from memory and counts the reads.
+class ovrMemoryFileSys : public ovrFileSys {
+   public:
+    virtual ovrStream* OpenStream(char const*, ovrStreamMode const) override {
+        return nullptr;
+    }
+    virtual void CloseStream(ovrStream*&) override {}
+    virtual bool ReadFile(char const* uri, std::vector<uint8_t>& outBuffer) override {
+        NumReads++;
+        auto it = Files.find(uri);
+        if (it == Files.end()) {
+            return false;
+        }
+        outBuffer = it->second;
+        return true;
+    }
+    virtual bool FileExists(char const* uri) override {
+        return Files.find(uri) != Files.end();
+    }
+    virtual bool GetLocalPathForURI(char const*, std::string&) override {
+        return false;
+    }
+
+    std::unordered_map<std::string, std::vector<uint8_t>> Files;
+    int NumReads = 0;
+};
+
+// An uncompressed 32 bit .tga of one color.
+std::vector<uint8_t> MakeTga(const int size) {
+    std::vector<uint8_t> tga(18, 0);
+    tga[2] = 2; // uncompressed true color
+    tga[12] = static_cast<uint8_t>(size);
+    tga[13] = static_cast<uint8_t>(size >> 8);
+    tga[14] = static_cast<uint8_t>(size);
+    tga[15] = static_cast<uint8_t>(size >> 8);
+    tga[16] = 32;
+    tga[17] = 0x28; // top left origin, 8 alpha bits
+    tga.resize(tga.size() + size * size * 4, 0x80);
+    return tga;
+}
+
+size_t ChainSize(const int size) {
+    int numLevels = 1;
+    while ((size >> (numLevels - 1)) > 1) {
+        numLevels++;
+    }
+    return GetTextureMemorySize(Texture_RGBA, size, size, numLevels);
+}
+
+} // namespace
+
+int main(int, char**) {
+    // without a budget nothing is done
+    {
+        ovrFakeAllocator allocator(100);
+        ovrTextureResidency residency;
+        for (int id = 0; id < 4; id++) {
+            allocator.Sizes[id] = 1000;
+            residency.Add(id, 1000);
+        }
+        residency.Enforce(allocator);
+        HOST_CHECK(allocator.Log.empty());
+        HOST_CHECK_EQ(residency.GetResidentBytes(), size_t(4000));
+    }
+
+    // unreferenced textures are evicted least recently used first, then referenced ones drop
+    // levels, least recently used first, until they can't
+    {
+        ovrFakeAllocator allocator(100);
+        ovrTextureResidency residency;
+        for (int id = 0; id < 4; id++) {
+            allocator.Sizes[id] = 1000;
+            residency.Add(id, 1000);
+        }
+        residency.AddRef(0);
+        HOST_CHECK_EQ(residency.GetRefCount(0), 2);
+        residency.Release(1);
+        residency.Release(3);
+        residency.Touch(1);
+        residency.SetBudget(2500);
+        residency.Enforce(allocator);
+        std::vector<std::string> expected = {"evict3", "evict1"};
+        HOST_CHECK(allocator.Log == expected);
+        HOST_CHECK_EQ(residency.GetNumResident(), 2);
+        HOST_CHECK_EQ(residency.GetResidentBytes(), size_t(2000));
+
+        // 0 was referenced again after 2 was added, so 2 goes first
+        allocator.Log.clear();
+        residency.SetBudget(1000);
+        residency.Enforce(allocator);
+        expected = {"drop2", "drop0"};
+        HOST_CHECK(allocator.Log == expected);
+        HOST_CHECK_EQ(residency.GetResidentBytes(), size_t(500));
+
+        allocator.Log.clear();
+        residency.SetBudget(300);
+        residency.Enforce(allocator);
+        expected = {"refuse2", "refuse0"};
+        HOST_CHECK(allocator.Log == expected);
+        HOST_CHECK_EQ(residency.GetResidentBytes(), size_t(500));
+
+        // a refused texture is not asked again
+        allocator.Log.clear();
+        residency.Enforce(allocator);
+        HOST_CHECK(allocator.Log.empty());
+
+        // until its last reference goes
+        residency.Release(2);
+        residency.Enforce(allocator);
+        expected = {"evict2"};
+        HOST_CHECK(allocator.Log == expected);
+        HOST_CHECK_EQ(residency.GetResidentBytes(), size_t(250));
+    }
+
+    // the texture manager drops levels from the ones it kept at load time
+    {
+        ovrMemoryFileSys fileSys;
+        const int size = 256;
+        fileSys.Files["a.tga"] = MakeTga(size);
+        fileSys.Files["b.tga"] = MakeTga(size);
+        fileSys.Files["c.tga"] = MakeTga(size);
+        const size_t full = ChainSize(size);
+
+        // the levels kept to drop to count against the budget, so with room for one texture
+        // and its kept levels, plus the second one dropped once and its kept levels
+        const size_t budget = full + 2 * ChainSize(size / 2) + ChainSize(size / 4);
+        ovrTextureManager* manager = ovrTextureManager::Create();
+        manager->Init();
+        manager->SetMemoryBudget(budget);
+        const textureHandle_t a = manager->LoadTexture(fileSys, "a.tga");
+        HOST_CHECK_EQ(manager->GetResidentBytes(), full + ChainSize(size / 2));
+        ovrNullGl::ResetStats();
+        const textureHandle_t b = manager->LoadTexture(fileSys, "b.tga");
+        HOST_CHECK_EQ(manager->GetGlTexture(a).Width, size / 2);
+        HOST_CHECK_EQ(manager->GetGlTexture(b).Width, size);
+        HOST_CHECK_EQ(manager->GetResidentBytes(), budget);
+        // b's levels and a's remaining ones, with nothing read again
+        HOST_CHECK_EQ(ovrNullGl::GetStats().TextureUploads, 9 + 8);
+        HOST_CHECK_EQ(fileSys.NumReads, 2);
+
+        // down to the minimum size
+        manager->SetMemoryBudget(ChainSize(size / 4));
+        HOST_CHECK_EQ(manager->GetGlTexture(a).Width, 64);
+        HOST_CHECK_EQ(manager->GetGlTexture(b).Width, 64);
+        HOST_CHECK_EQ(manager->GetResidentBytes(), 2 * ChainSize(64));
+        HOST_CHECK_EQ(fileSys.NumReads, 2);
+
+        // a texture loaded without a budget keeps no levels, so it can only be evicted
+        manager->SetMemoryBudget(0);
+        const textureHandle_t c = manager->LoadTexture(fileSys, "c.tga");
+        manager->SetMemoryBudget(ChainSize(size / 4));
+        HOST_CHECK_EQ(manager->GetGlTexture(c).Width, size);
+        manager->ReleaseTexture(c);
+        manager->SetMemoryBudget(ChainSize(size / 4));
+        HOST_CHECK(!manager->GetTextureHandle("c.tga").IsValid());
+        HOST_CHECK_EQ(manager->GetResidentBytes(), 2 * ChainSize(64));
+        HOST_CHECK_EQ(fileSys.NumReads, 3);
+
+        manager->Shutdown();
+        ovrTextureManager::Destroy(manager);
+    }
+
+    // a menu surface holds a reference to its texture until it is freed
+    {
+        const char* const IMAGE_URI = "apk://font/res/raw/loading_indicator.png";
+        ovrHostGui gui;
+        OvrVRMenuMgr& menuMgr = gui.GuiSys->GetVRMenuMgr();
+        ovrTextureManager& manager = gui.GuiSys->GetTextureManager();
+        auto createItem = [&]() {
+            VRMenuSurfaceParms surfParms(
+                "item",
+                IMAGE_URI,
+                SURFACE_TEXTURE_DIFFUSE,
+                nullptr,
+                SURFACE_TEXTURE_MAX,
+                nullptr,
+                SURFACE_TEXTURE_MAX);
+            VRMenuObjectParms parms(
+                VRMENU_STATIC,
+                std::vector<VRMenuComponent*>(),
+                surfParms,
+                "",
+                OVR::Posef(),
+                OVR::Vector3f(1.0f),
+                VRMenuFontParms(),
+                VRMenuId_t(),
+                VRMenuObjectFlags_t(),
+                VRMenuObjectInitFlags_t());
+            return menuMgr.CreateObject(parms);
+        };
+        const menuHandle_t first = createItem();
+        const menuHandle_t second = createItem();
+        const textureHandle_t texture = manager.GetTextureHandle(IMAGE_URI);
+        HOST_CHECK(texture.IsValid());
+
+        menuMgr.FreeObject(first);
+        manager.SetMemoryBudget(1);
+        HOST_CHECK(manager.GetTextureHandle(IMAGE_URI) == texture);
+
+        menuMgr.FreeObject(second);
+        manager.SetMemoryBudget(1);
+        HOST_CHECK(!manager.GetTextureHandle(IMAGE_URI).IsValid());
+        manager.SetMemoryBudget(0);
+    }
+
+    return HOST_TEST_RESULT();
+}
@@ -0,0 +1,199 @@
+/************************************************************************************
+
+Filename    :   VRMenuBatcherTest.cpp
+Content     :   Checks menu surface batching and how batches are uploaded
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "NullGl.h"
+
+#include "GUI/VRMenuBatcher.h"
+
+#include <vector>
+
+using namespace OVRFW;
+using OVR::Matrix4f;
+using OVR::Vector2f;
+using OVR::Vector3f;
+using OVR::Vector4f;
+
+namespace {
+
+// A surface drawn with program and texture; the GL names are never looked up.
+struct ovrTestSurface {
+    ovrTestSurface(const unsigned program, const unsigned texture) {
+        SurfaceDef.graphicsCommand.Program.Program = program;
+        SurfaceDef.graphicsCommand.Program.numTextureBindings = 1;
+        SurfaceDef.graphicsCommand.Textures[0] = GlTexture(texture, GL_TEXTURE_2D, 64, 64);
+        for (int i = 0; i < 4; i++) {
+            const float x = static_cast<float>(i & 1);
+            const float y = static_cast<float>(i >> 1);
+            Attribs.position.push_back(Vector3f(x, y, 0.0f));
+            Attribs.uv0.push_back(Vector2f(x, y));
+            Attribs.color.push_back(Vector4f(1.0f));
+        }
+        Indices = {0, 1, 2, 2, 1, 3};
+    }
+
+    VRMenuBatchSource Source() const {
+        VRMenuBatchSource source;
+        source.SurfaceDef = &SurfaceDef;
+        source.Attribs = &Attribs;
+        source.Indices = &Indices;
+        return source;
+    }
+
+    ovrSurfaceDef SurfaceDef;
+    VertexAttribs Attribs;
+    std::vector<TriangleIndex> Indices;
+};
+
+void AddSurface(
+    std::vector<ovrDrawSurface>& surfaceList,
+    std::vector<VRMenuBatchSource>& sources,
+    ovrTestSurface const& surface,
+    VRMenuBatchSource const& source,
+    const float x) {
+    surfaceList.push_back(
+        ovrDrawSurface(Matrix4f::Translation(Vector3f(x, 0.0f, 0.0f)), &surface.SurfaceDef));
+    sources.push_back(source);
+}
+
+} // namespace
+
+int main(int, char**) {
+    ovrTestSurface a(1, 10);
+    ovrTestSurface sameAsA(1, 10);
+    ovrTestSurface otherTexture(1, 11);
+    ovrTestSurface otherProgram(2, 10);
+
+    // merge decisions
+    HOST_CHECK(VRMenuBatcher::CanMerge(a.Source(), sameAsA.Source()));
+    HOST_CHECK(!VRMenuBatcher::CanMerge(a.Source(), otherTexture.Source()));
+    HOST_CHECK(!VRMenuBatcher::CanMerge(a.Source(), otherProgram.Source()));
+    VRMenuBatchSource tinted = sameAsA.Source();
+    tinted.Color = Vector4f(0.5f);
+    HOST_CHECK(!VRMenuBatcher::CanMerge(a.Source(), tinted));
+    VRMenuBatchSource unbatchable = a.Source();
+    unbatchable.SurfaceDef = nullptr;
+    HOST_CHECK(!VRMenuBatcher::CanMerge(a.Source(), unbatchable));
+    HOST_CHECK(!VRMenuBatcher::CanMerge(unbatchable, a.Source()));
+
+    // five surfaces: a run of three, then one on its own, then one that can't be batched
+    std::vector<ovrDrawSurface> surfaceList;
+    std::vector<VRMenuBatchSource> sources;
+    AddSurface(surfaceList, sources, a, a.Source(), 0.0f);
+    AddSurface(surfaceList, sources, sameAsA, sameAsA.Source(), 2.0f);
+    AddSurface(surfaceList, sources, a, a.Source(), 4.0f);
+    AddSurface(surfaceList, sources, otherTexture, otherTexture.Source(), 6.0f);
+    AddSurface(surfaceList, sources, a, unbatchable, 8.0f);
+    HOST_CHECK_EQ(VRMenuBatcher::FindRunEnd(sources, 0), 3u);
+    HOST_CHECK_EQ(VRMenuBatcher::FindRunEnd(sources, 3), 4u);
+    HOST_CHECK_EQ(VRMenuBatcher::FindRunEnd(sources, 4), 5u);
+
+    ovrNullGl::ResetStats();
+    VRMenuBatcher batcher;
+    std::vector<ovrDrawSurface> merged = surfaceList;
+    batcher.Merge(merged, 0, sources);
+    HOST_CHECK_EQ(batcher.GetNumBatches(), 1);
+    HOST_CHECK_EQ(merged.size(), 3u);
+    if (merged.size() == 3u) {
+        // the batch is drawn untransformed, in the place of the run, with the vertices moved
+        GlGeometry const& geo = merged[0].surface->geo;
+        HOST_CHECK(merged[0].modelMatrix == Matrix4f::Identity());
+        HOST_CHECK_EQ(geo.vertexCount, 12);
+        HOST_CHECK_EQ(geo.indexCount, 18);
+        HOST_CHECK_NEAR(geo.localBounds.GetMins().x, 0.0, 1e-6);
+        HOST_CHECK_NEAR(geo.localBounds.GetMaxs().x, 5.0, 1e-6);
+        HOST_CHECK(merged[1].surface == &otherTexture.SurfaceDef);
+        HOST_CHECK(merged[2].surface == &a.SurfaceDef);
+        HOST_CHECK_NEAR(merged[2].modelMatrix.GetTranslation().x, 8.0, 1e-6);
+    }
+
+    VertexAttribs attribs;
+    std::vector<TriangleIndex> indices;
+    VRMenuBatcher::AppendTransformed(
+        a.Source(), Matrix4f::Translation(Vector3f(0, 0, 0)), attribs, indices);
+    VRMenuBatcher::AppendTransformed(
+        a.Source(), Matrix4f::Translation(Vector3f(0, 0, -1)), attribs, indices);
+    HOST_CHECK_NEAR(attribs.position[5].z, -1.0, 1e-6);
+    HOST_CHECK_EQ(indices[6], 4);
+
+    // the batch is rewritten every frame, so it is streamed into buffers that are orphaned and
+    // refilled rather than given a new static store each time
+    const int frames = 10;
+    for (int frame = 1; frame < frames; frame++) {
+        merged = surfaceList;
+        batcher.Merge(merged, 0, sources);
+    }
+    const ovrNullGlStats stats = ovrNullGl::GetStats();
+    HOST_CHECK_EQ(stats.StaticBufferStores, 0);
+    HOST_CHECK_EQ(stats.BufferSubDataCalls, 2 * frames);
+    GlGeometry const& geo = merged[0].surface->geo;
+    GLsizeiptr vertexStore = 0;
+    GLenum usage = 0;
+    HOST_CHECK(ovrNullGl::GetBufferStore(geo.vertexBuffer, vertexStore, usage));
+    HOST_CHECK_EQ(usage, static_cast<GLenum>(GL_STREAM_DRAW));
+    GLsizeiptr indexStore = 0;
+    HOST_CHECK(ovrNullGl::GetBufferStore(geo.indexBuffer, indexStore, usage));
+    HOST_CHECK_EQ(usage, static_cast<GLenum>(GL_STREAM_DRAW));
+    HOST_CHECK_EQ(indexStore, static_cast<GLsizeiptr>(18 * sizeof(TriangleIndex)));
+
+    // a smaller batch reuses the store instead of shrinking it
+    std::vector<ovrDrawSurface> shortList(surfaceList.begin(), surfaceList.begin() + 2);
+    std::vector<VRMenuBatchSource> shortSources(sources.begin(), sources.begin() + 2);
+    batcher.Merge(shortList, 0, shortSources);
+    HOST_CHECK_EQ(shortList.size(), 1u);
+    HOST_CHECK_EQ(shortList[0].surface->geo.vertexCount, 8);
+    GLsizeiptr store = 0;
+    HOST_CHECK(ovrNullGl::GetBufferStore(geo.vertexBuffer, store, usage));
+    HOST_CHECK_EQ(store, vertexStore);
+    // and packs its vertices into the same memory
+    const uint8_t* packed = geo.streamPacked.data();
+    merged = surfaceList;
+    batcher.Merge(merged, 0, sources);
+    HOST_CHECK(geo.streamPacked.data() == packed);
+
+    // with known geometry versions, a run that hasn't changed keeps its batch; moving a surface
+    // or rebuilding its geometry builds the batch again
+    std::vector<VRMenuBatchSource> versioned = sources;
+    for (size_t i = 0; i < versioned.size(); i++) {
+        versioned[i].GeometryVersion = static_cast<uint32_t>(i + 1);
+    }
+    int numStreamed = 0;
+    auto mergeFrame = [&](std::vector<ovrDrawSurface> const& list,
+                          std::vector<VRMenuBatchSource> const& frameSources) {
+        const int before = ovrNullGl::GetStats().BufferSubDataCalls;
+        merged = list;
+        batcher.Merge(merged, 0, frameSources);
+        numStreamed += (ovrNullGl::GetStats().BufferSubDataCalls - before) / 2;
+        return batcher.GetNumKeptBatches();
+    };
+    HOST_CHECK_EQ(mergeFrame(surfaceList, versioned), 0);
+    HOST_CHECK_EQ(mergeFrame(surfaceList, versioned), 1);
+    HOST_CHECK_EQ(mergeFrame(surfaceList, versioned), 1);
+    HOST_CHECK_EQ(numStreamed, 1);
+    HOST_CHECK_EQ(merged.size(), 3u);
+    HOST_CHECK_EQ(merged[0].surface->geo.indexCount, 18);
+    std::vector<ovrDrawSurface> moved = surfaceList;
+    moved[1].modelMatrix = Matrix4f::Translation(Vector3f(2.0f, 1.0f, 0.0f));
+    HOST_CHECK_EQ(mergeFrame(moved, versioned), 0);
+    HOST_CHECK_NEAR(merged[0].surface->geo.localBounds.GetMaxs().y, 2.0, 1e-6);
+    HOST_CHECK_EQ(mergeFrame(moved, versioned), 1);
+    std::vector<VRMenuBatchSource> rebuilt = versioned;
+    rebuilt[2].GeometryVersion = 100;
+    HOST_CHECK_EQ(mergeFrame(moved, rebuilt), 0);
+    HOST_CHECK_EQ(mergeFrame(moved, rebuilt), 1);
+    HOST_CHECK_EQ(numStreamed, 3);
+    // a version of 0 is never trusted
+    HOST_CHECK_EQ(mergeFrame(surfaceList, sources), 0);
+    HOST_CHECK_EQ(mergeFrame(surfaceList, sources), 0);
+
+    batcher.Shutdown();
+    return HOST_TEST_RESULT();
+}
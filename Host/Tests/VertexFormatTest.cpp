@@ -0,0 +1,275 @@
+/************************************************************************************
+
+Filename    :   VertexFormatTest.cpp
+Content     :   Round trips vertex attributes through the compact encodings and reports their size
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "HostTest.h"
+#include "HostGui.h"
+#include "NullGl.h"
+
+#include "Model/ModelFile.h"
+#include "Render/GlGeometry.h"
+#include "Render/GlProgram.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace OVRFW;
+using OVR::Vector2f;
+using OVR::Vector3f;
+using OVR::Vector4f;
+using OVR::Vector4i;
+
+namespace {
+
+const char* const CONTROLLER_URI = "apk:///assets/oculusQuest_oculusTouch_Left.gltf.ovrscene";
+
+float DecodeHalf(const uint16_t h) {
+    const float sign = (h & 0x8000) ? -1.0f : 1.0f;
+    const int exponent = (h >> 10) & 0x1F;
+    const int mantissa = h & 0x03FF;
+    if (exponent == 0) {
+        return sign * ldexpf(static_cast<float>(mantissa), -24);
+    }
+    return sign * ldexpf(static_cast<float>(mantissa | 0x0400), exponent - 25);
+}
+
+// Reads back component c of attribute a of vertex i the way GL would.
+float DecodeComponent(
+    const std::vector<uint8_t>& vertices,
+    const int stride,
+    const GlVertexAttribute& a,
+    const size_t i,
+    const int c) {
+    const uint8_t* v = vertices.data() + i * stride + a.offset;
+    switch (a.glType) {
+        case GL_HALF_FLOAT: {
+            uint16_t h;
+            memcpy(&h, v + c * sizeof(h), sizeof(h));
+            return DecodeHalf(h);
+        }
+        case GL_INT_2_10_10_10_REV: {
+            uint32_t packed;
+            memcpy(&packed, v, sizeof(packed));
+            int32_t value = static_cast<int32_t>((packed >> (c * 10)) & 0x3FF);
+            if (value & 0x200) {
+                value -= 0x400;
+            }
+            return fmaxf(-1.0f, static_cast<float>(value) / 511.0f);
+        }
+        case GL_UNSIGNED_BYTE:
+            return a.normalized ? v[c] / 255.0f : static_cast<float>(v[c]);
+        case GL_INT: {
+            int32_t value;
+            memcpy(&value, v + c * sizeof(value), sizeof(value));
+            return static_cast<float>(value);
+        }
+        default: {
+            float value;
+            memcpy(&value, v + c * sizeof(value), sizeof(value));
+            return value;
+        }
+    }
+}
+
+const GlVertexAttribute* FindAttribute(
+    const std::vector<GlVertexAttribute>& attributes,
+    const uint32_t location) {
+    for (const GlVertexAttribute& a : attributes) {
+        if (a.location == location) {
+            return &a;
+        }
+    }
+    return nullptr;
+}
+
+// The largest difference between the source values and what the packed vertices decode to.
+template <typename _attrib_type_>
+float MaxError(
+    const std::vector<_attrib_type_>& source,
+    const int components,
+    const std::vector<uint8_t>& vertices,
+    const int stride,
+    const std::vector<GlVertexAttribute>& attributes,
+    const uint32_t location) {
+    const GlVertexAttribute* a = FindAttribute(attributes, location);
+    HOST_CHECK(a != nullptr);
+    if (a == nullptr) {
+        return INFINITY;
+    }
+    float maxError = 0.0f;
+    for (size_t i = 0; i < source.size(); i++) {
+        for (int c = 0; c < components; c++) {
+            const float error = fabsf(DecodeComponent(vertices, stride, *a, i, c) - source[i][c]);
+            maxError = fmaxf(maxError, error);
+        }
+    }
+    return maxError;
+}
+
+// A unit sphere with everything a skinned, vertex colored surface has.
+VertexAttribs MakeSphere(const int rings, const int segments) {
+    VertexAttribs attribs;
+    for (int r = 0; r <= rings; r++) {
+        const float theta = static_cast<float>(M_PI) * r / rings;
+        for (int s = 0; s <= segments; s++) {
+            const float phi = 2.0f * static_cast<float>(M_PI) * s / segments;
+            const Vector3f n(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+            // not on a power of two grid, so the halves do round
+            const float u = static_cast<float>(s) / (segments + 0.5f);
+            const float v = static_cast<float>(r) / (rings + 0.5f);
+            attribs.position.push_back(n);
+            attribs.normal.push_back(n);
+            attribs.tangent.push_back(Vector3f(-sinf(phi), 0.0f, cosf(phi)));
+            attribs.color.push_back(Vector4f(u, v, 1.0f - u, 1.0f));
+            attribs.uv0.push_back(Vector2f(u, v));
+            attribs.jointIndices.push_back(Vector4i(r % 40, s % 40, 0, 1));
+            attribs.jointWeights.push_back(Vector4f(0.5f * u, 0.5f * (1.0f - u), 0.25f, 0.25f));
+        }
+    }
+    return attribs;
+}
+
+// Sums the vertex and index stores of all the model's surfaces.
+void GetStoreSizes(const ModelFile& model, int64_t& vertexBytes, int64_t& indexBytes) {
+    vertexBytes = 0;
+    indexBytes = 0;
+    for (const Model& m : model.Models) {
+        for (const ModelSurface& surface : m.surfaces) {
+            GLsizeiptr size = 0;
+            GLenum usage = 0;
+            if (ovrNullGl::GetBufferStore(surface.surfaceDef.geo.vertexBuffer, size, usage)) {
+                vertexBytes += size;
+            }
+            if (ovrNullGl::GetBufferStore(surface.surfaceDef.geo.indexBuffer, size, usage)) {
+                indexBytes += size;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int, char**) {
+    ovrHostGui gui;
+
+    // every attribute of the sphere fits a compact encoding
+    const VertexAttribs sphere = MakeSphere(32, 64);
+    const GlVertexFormat format = GlVertexFormat::ChooseCompact(sphere);
+    HOST_CHECK_EQ(format.position, VERTEX_ENCODING_HALF);
+    HOST_CHECK_EQ(format.normal, VERTEX_ENCODING_SNORM_10_10_10_2);
+    HOST_CHECK_EQ(format.tangent, VERTEX_ENCODING_SNORM_10_10_10_2);
+    HOST_CHECK_EQ(format.color, VERTEX_ENCODING_UNORM8);
+    HOST_CHECK_EQ(format.uv0, VERTEX_ENCODING_HALF);
+    HOST_CHECK_EQ(format.jointIndices, VERTEX_ENCODING_UINT8);
+    HOST_CHECK_EQ(format.jointWeights, VERTEX_ENCODING_UNORM8);
+
+    std::vector<uint8_t> floatVertices;
+    std::vector<GlVertexAttribute> floatAttributes;
+    int floatStride = 0;
+    HOST_CHECK(GlGeometry::PackInterleavedVertices(
+        sphere, GlVertexFormat(), floatVertices, floatAttributes, floatStride));
+    std::vector<uint8_t> vertices;
+    std::vector<GlVertexAttribute> attributes;
+    int stride = 0;
+    HOST_CHECK(GlGeometry::PackInterleavedVertices(sphere, format, vertices, attributes, stride));
+    HOST_CHECK_EQ(vertices.size(), sphere.position.size() * stride);
+
+    // each value comes back within the tolerance its encoding was chosen for
+    auto maxError = [&vertices, stride, &attributes](
+                        const auto& source, const int components, const uint32_t location) {
+        return MaxError(source, components, vertices, stride, attributes, location);
+    };
+    const float positionError = maxError(sphere.position, 3, VERTEX_ATTRIBUTE_LOCATION_POSITION);
+    const float normalError = maxError(sphere.normal, 3, VERTEX_ATTRIBUTE_LOCATION_NORMAL);
+    const float tangentError = maxError(sphere.tangent, 3, VERTEX_ATTRIBUTE_LOCATION_TANGENT);
+    const float colorError = maxError(sphere.color, 4, VERTEX_ATTRIBUTE_LOCATION_COLOR);
+    const float uvError = maxError(sphere.uv0, 2, VERTEX_ATTRIBUTE_LOCATION_UV0);
+    const float jointError =
+        maxError(sphere.jointIndices, 4, VERTEX_ATTRIBUTE_LOCATION_JOINT_INDICES);
+    const float weightError =
+        maxError(sphere.jointWeights, 4, VERTEX_ATTRIBUTE_LOCATION_JOINT_WEIGHTS);
+    HOST_CHECK(positionError <= 0.0005f);
+    HOST_CHECK(normalError <= 0.5f / 511.0f + 1e-6f);
+    HOST_CHECK(tangentError <= 0.5f / 511.0f + 1e-6f);
+    HOST_CHECK(colorError <= 0.5f / 255.0f + 1e-6f);
+    HOST_CHECK(uvError <= 1.0f / 4096.0f);
+    HOST_CHECK_EQ(jointError, 0.0f);
+    HOST_CHECK(weightError <= 0.5f / 255.0f + 1e-6f);
+    // the float layout is exact
+    HOST_CHECK_EQ(
+        MaxError(
+            sphere.position,
+            3,
+            floatVertices,
+            floatStride,
+            floatAttributes,
+            VERTEX_ATTRIBUTE_LOCATION_POSITION),
+        0.0f);
+
+    // values a compact encoding would lose stay floats
+    VertexAttribs far = sphere;
+    for (Vector3f& p : far.position) {
+        p *= 3000.0f;
+    }
+    for (Vector4f& c : far.color) {
+        c.w = 2.0f;
+    }
+    const GlVertexFormat farFormat = GlVertexFormat::ChooseCompact(far);
+    HOST_CHECK_EQ(farFormat.position, VERTEX_ENCODING_FLOAT);
+    HOST_CHECK_EQ(farFormat.color, VERTEX_ENCODING_FLOAT);
+    HOST_CHECK_EQ(farFormat.normal, VERTEX_ENCODING_SNORM_10_10_10_2);
+
+    printf(
+        "sphere    : %d bytes per vertex as floats, %d compact (%.0f%%)\n",
+        floatStride,
+        stride,
+        100.0 * stride / floatStride);
+    printf(
+        "max error : position %g normal %g tangent %g color %g uv %g weight %g\n",
+        positionError,
+        normalError,
+        tangentError,
+        colorError,
+        uvError,
+        weightError);
+    HOST_CHECK(stride * 2 < floatStride);
+
+    // what the controller's buffers take with each layout
+    GlProgram program;
+    const ModelGlPrograms programs(&program);
+    MaterialParms floatParms;
+    MaterialParms compactParms;
+    compactParms.CompactVertices = true;
+    ModelFile* floatModel = LoadModelFile(*gui.FileSys, CONTROLLER_URI, programs, floatParms);
+    ModelFile* compactModel = LoadModelFile(*gui.FileSys, CONTROLLER_URI, programs, compactParms);
+    HOST_CHECK(floatModel != nullptr && compactModel != nullptr);
+    if (floatModel != nullptr && compactModel != nullptr) {
+        int64_t floatVertexBytes = 0;
+        int64_t floatIndexBytes = 0;
+        int64_t compactVertexBytes = 0;
+        int64_t compactIndexBytes = 0;
+        GetStoreSizes(*floatModel, floatVertexBytes, floatIndexBytes);
+        GetStoreSizes(*compactModel, compactVertexBytes, compactIndexBytes);
+        printf(
+            "controller: %lld vertex bytes as floats, %lld compact (%.0f%%), %lld index bytes\n",
+            static_cast<long long>(floatVertexBytes),
+            static_cast<long long>(compactVertexBytes),
+            100.0 * compactVertexBytes / floatVertexBytes,
+            static_cast<long long>(compactIndexBytes));
+        HOST_CHECK(compactVertexBytes < floatVertexBytes);
+        HOST_CHECK_EQ(compactIndexBytes, floatIndexBytes);
+    }
+    delete floatModel;
+    delete compactModel;
+
+    return HOST_TEST_RESULT();
+}
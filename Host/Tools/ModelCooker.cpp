@@ -0,0 +1,114 @@
+/************************************************************************************
+
+Filename    :   ModelCooker.cpp
+Content     :   Cooks a model ahead of time, the way the app's loader cooks it on first use
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+// model_cooker [--compact] [--optimize] [--srgb] <source model> <cooked file>
+//
+// Loads the model against the null GL and writes the cooked file a ModelGeometryCache would
+// write for it. The options are the MaterialParms the app loads the model with, which change
+// the cooked geometry. The cooked file can be placed where ovrVrInput::GetModelCachePath()
+// looks for it, so the first load on the device is already a cooked one.
+
+#include "HostAndroid.h"
+
+#include "Model/ModelCache.h"
+#include "Model/ModelFile.h"
+#include "Render/GlProgram.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace OVRFW;
+
+static bool ReadWholeFile(const char* path, std::vector<uint8_t>& buffer) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    bool ok = fseek(f, 0, SEEK_END) == 0;
+    const long length = ok ? ftell(f) : -1;
+    ok = ok && length > 0 && fseek(f, 0, SEEK_SET) == 0;
+    if (ok) {
+        buffer.resize(static_cast<size_t>(length));
+        ok = fread(buffer.data(), 1, buffer.size(), f) == buffer.size();
+    }
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    ovrHostAndroid::SetLogPriority(ANDROID_LOG_WARN);
+    MaterialParms materialParms;
+    materialParms.UseSrgbTextureFormats = false;
+    const char* paths[2] = {};
+    int numPaths = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--compact") == 0) {
+            materialParms.CompactVertices = true;
+        } else if (strcmp(argv[i], "--optimize") == 0) {
+            materialParms.OptimizeMeshes = true;
+        } else if (strcmp(argv[i], "--srgb") == 0) {
+            materialParms.UseSrgbTextureFormats = true;
+        } else if (numPaths < 2) {
+            paths[numPaths++] = argv[i];
+        } else {
+            numPaths = 0;
+            break;
+        }
+    }
+    if (numPaths != 2) {
+        fprintf(
+            stderr,
+            "usage: model_cooker [--compact] [--optimize] [--srgb] <source model> <cooked file>\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> source;
+    if (!ReadWholeFile(paths[0], source)) {
+        fprintf(stderr, "model_cooker: could not read '%s'\n", paths[0]);
+        return 1;
+    }
+
+    // an existing file is always rebuilt, even if it matches
+    remove(paths[1]);
+    ModelGeometryCache cache;
+    cache.Open(
+        paths[1],
+        ModelGeometryCache::HashContent(source.data(), source.size()),
+        ModelGeometryCache::GetGeometryOptions(materialParms));
+    ModelLoadContext context;
+    context.Cache = &cache;
+
+    // the programs are only copied into the surfaces
+    GlProgram program;
+    const ModelGlPrograms programs(&program);
+    ModelFile* model = LoadModelFileFromMemory(
+        paths[0],
+        source.data(),
+        static_cast<int>(source.size()),
+        programs,
+        materialParms,
+        nullptr,
+        context);
+    const bool loaded = model != nullptr;
+    cache.Finish(loaded);
+    delete model;
+
+    FILE* cooked = loaded ? fopen(paths[1], "rb") : nullptr;
+    if (cooked == nullptr) {
+        fprintf(stderr, "model_cooker: could not cook '%s'\n", paths[0]);
+        return 1;
+    }
+    fseek(cooked, 0, SEEK_END);
+    printf("model_cooker: '%s' -> '%s', %ld bytes\n", paths[0], paths[1], ftell(cooked));
+    fclose(cooked);
+    return 0;
+}
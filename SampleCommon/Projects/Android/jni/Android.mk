@@ -16,10 +16,13 @@ LOCAL_C_INCLUDES := \
   $(LOCAL_PATH)/../../../../1stParty/OVR/Include \
   $(LOCAL_PATH)/../../../../1stParty/utilities/include \
   $(LOCAL_PATH)/../../../../3rdParty/stb/src \
+  $(LOCAL_PATH)/../../../../3rdParty/zstd/src \
 
 LOCAL_CFLAGS += -Wno-invalid-offsetof
 
 LOCAL_SRC_FILES := \
+  ../../../Src/AsyncLoader.cpp \
+  ../../../Src/FrameTimings.cpp \
   ../../../Src/GUI/ActionComponents.cpp \
   ../../../Src/GUI/AnimComponents.cpp \
   ../../../Src/GUI/CollisionPrimitive.cpp \
@@ -35,6 +38,8 @@ LOCAL_SRC_FILES := \
   ../../../Src/GUI/VRMenuComponent.cpp \
   ../../../Src/GUI/VRMenuEvent.cpp \
   ../../../Src/GUI/VRMenuEventHandler.cpp \
+  ../../../Src/GUI/VRMenuHitBvh.cpp \
+  ../../../Src/GUI/VRMenuBatcher.cpp \
   ../../../Src/GUI/VRMenuMgr.cpp \
   ../../../Src/GUI/VRMenuObject.cpp \
   ../../../Src/Input/ArmModel.cpp \
@@ -46,12 +51,14 @@ LOCAL_SRC_FILES := \
   ../../../Src/Locale/OVR_Locale.cpp \
   ../../../Src/Locale/tinyxml2.cpp \
   ../../../Src/Misc/Log.c \
+  ../../../Src/Model/ModelCache.cpp \
   ../../../Src/Model/ModelCollision.cpp \
   ../../../Src/Model/ModelFile_glTF.cpp \
   ../../../Src/Model/ModelFile_OvrScene.cpp \
   ../../../Src/Model/ModelFile.cpp \
   ../../../Src/Model/ModelRender.cpp \
   ../../../Src/Model/ModelTrace.cpp \
+  ../../../Src/Model/ModelUploads.cpp \
   ../../../Src/Model/SceneView.cpp \
   ../../../Src/OVR_BinaryFile2.cpp \
   ../../../Src/OVR_FileSys.cpp \
@@ -71,8 +78,10 @@ LOCAL_SRC_FILES := \
   ../../../Src/Render/GlBuffer.cpp \
   ../../../Src/Render/GlGeometry.cpp \
   ../../../Src/Render/GlProgram.cpp \
+  ../../../Src/Render/GlProgramCache.cpp \
   ../../../Src/Render/GlSetup.cpp \
   ../../../Src/Render/GlTexture.cpp \
+  ../../../Src/Render/MeshOptimizer.cpp \
   ../../../Src/Render/PanelRenderer.cpp \
   ../../../Src/Render/ParticleSystem.cpp	\
   ../../../Src/Render/PointList.cpp \
@@ -81,9 +90,10 @@ LOCAL_SRC_FILES := \
   ../../../Src/Render/SurfaceTexture.cpp \
   ../../../Src/Render/TextureAtlas.cpp \
   ../../../Src/Render/TextureManager.cpp \
+  ../../../Src/Render/TextureResidency.cpp \
   ../../../Src/System.cpp \
 
-LOCAL_STATIC_LIBRARIES += minizip stb android_native_app_glue
+LOCAL_STATIC_LIBRARIES += minizip stb zstd android_native_app_glue
 
 # start building based on everything since CLEAR_VARS
 include $(BUILD_STATIC_LIBRARY)
@@ -91,3 +101,4 @@ include $(BUILD_STATIC_LIBRARY)
 $(call import-module,android/native_app_glue)
 $(call import-module,3rdParty/minizip/build/android/jni)
 $(call import-module,3rdParty/stb/build/android/jni)
+$(call import-module,3rdParty/zstd/build/android/jni)
@@ -0,0 +1,292 @@
+/************************************************************************************
+
+Filename    :   AsyncLoader.cpp
+Content     :   Loader threads for the CPU side of asset loading, plus a bounded queue of GPU
+                uploads drained on the GL thread under a per-frame time budget.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "AsyncLoader.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "Misc/Log.h"
+
+namespace OVRFW {
+
+static double GetLoaderTimeInSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+//==============================
+// ovrGpuUploadQueue::ovrGpuUploadQueue
+ovrGpuUploadQueue::ovrGpuUploadQueue(int const capacity)
+    : Capacity(std::max(capacity, 1)), Closed(false) {}
+
+//==============================
+// ovrGpuUploadQueue::Post
+bool ovrGpuUploadQueue::Post(ovrGpuUpload&& upload) {
+    return PostSteps([upload]() {
+        upload();
+        return true;
+    });
+}
+
+//==============================
+// ovrGpuUploadQueue::PostSteps
+bool ovrGpuUploadQueue::PostSteps(ovrGpuUploadSteps&& steps) {
+    std::unique_lock<std::mutex> lock(Mutex);
+    NotFull.wait(lock, [this] { return Closed || static_cast<int>(Uploads.size()) < Capacity; });
+    if (Closed) {
+        return false;
+    }
+    Uploads.push_back(std::move(steps));
+    return true;
+}
+
+//==============================
+// ovrGpuUploadQueue::Drain
+int ovrGpuUploadQueue::Drain(double const budgetSeconds) {
+    double const startTime = GetLoaderTimeInSeconds();
+    int numRun = 0;
+    for (;;) {
+        ovrGpuUploadSteps steps;
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Uploads.empty()) {
+                break;
+            }
+            steps = std::move(Uploads.front());
+            Uploads.pop_front();
+        }
+
+        // run outside the lock so loader threads can keep posting
+        bool const finished = steps();
+        numRun++;
+        if (finished) {
+            NotFull.notify_one();
+        } else {
+            // not counted as room, the next Drain() picks it up where it stopped
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (!Closed) {
+                Uploads.push_front(std::move(steps));
+            }
+        }
+
+        if (GetLoaderTimeInSeconds() - startTime >= budgetSeconds) {
+            break;
+        }
+    }
+    return numRun;
+}
+
+//==============================
+// ovrGpuUploadQueue::Close
+void ovrGpuUploadQueue::Close() {
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Closed = true;
+        Uploads.clear();
+    }
+    NotFull.notify_all();
+}
+
+//==============================
+// ovrGpuUploadQueue::Open
+void ovrGpuUploadQueue::Open() {
+    std::lock_guard<std::mutex> lock(Mutex);
+    Closed = false;
+}
+
+//==============================
+// ovrGpuUploadQueue::GetNumQueued
+int ovrGpuUploadQueue::GetNumQueued() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return static_cast<int>(Uploads.size());
+}
+
+//==============================
+// ovrAsyncLoader::ovrAsyncLoader
+ovrAsyncLoader::ovrAsyncLoader(int const uploadQueueSize)
+    : Stopping(false), UploadQueue(uploadQueueSize), NumPending(0) {}
+
+//==============================
+// ovrAsyncLoader::~ovrAsyncLoader
+ovrAsyncLoader::~ovrAsyncLoader() {
+    Shutdown();
+}
+
+//==============================
+// ovrAsyncLoader::Init
+void ovrAsyncLoader::Init(int const numThreads) {
+    assert(Threads.empty());
+
+    int count = numThreads;
+    if (count <= 0) {
+        // leave cores for the main and render threads
+        int const numCores = static_cast<int>(std::thread::hardware_concurrency());
+        count = std::min(std::max(numCores - 2, 1), 4);
+    }
+
+    UploadQueue.Open();
+    Stopping = false;
+    for (int i = 0; i < count; ++i) {
+        Threads.emplace_back(&ovrAsyncLoader::ThreadFunction, this);
+    }
+    ALOG("ovrAsyncLoader: started %i loader threads", count);
+}
+
+//==============================
+// ovrAsyncLoader::Shutdown
+void ovrAsyncLoader::Shutdown() {
+    if (Threads.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(JobMutex);
+        Stopping = true;
+        Jobs.clear();
+        Helpers.clear();
+    }
+    JobReady.notify_all();
+    // unblocks any thread waiting for room in the upload queue
+    UploadQueue.Close();
+
+    for (std::thread& t : Threads) {
+        t.join();
+    }
+    Threads.clear();
+    NumPending = 0;
+}
+
+//==============================
+// ovrAsyncLoader::Load
+void ovrAsyncLoader::Load(ovrLoadJob&& job) {
+    LoadInSteps([job]() -> ovrGpuUploadSteps {
+        ovrGpuUpload upload = job();
+        if (!upload) {
+            return ovrGpuUploadSteps();
+        }
+        return [upload]() {
+            upload();
+            return true;
+        };
+    });
+}
+
+//==============================
+// ovrAsyncLoader::LoadInSteps
+void ovrAsyncLoader::LoadInSteps(ovrSteppedLoadJob&& job) {
+    NumPending++;
+    {
+        std::lock_guard<std::mutex> lock(JobMutex);
+        Jobs.push_back(std::move(job));
+    }
+    JobReady.notify_one();
+}
+
+//==============================
+// ovrAsyncLoader::ParallelFor
+void ovrAsyncLoader::ParallelFor(int const count, const std::function<void(int)>& job) {
+    // shared with the helpers, which may only get to run after this returns
+    struct ovrParallelFor {
+        std::atomic<int> Next{0};
+        std::mutex Mutex;
+        std::condition_variable Done;
+        int NumDone = 0;
+    };
+    std::shared_ptr<ovrParallelFor> state = std::make_shared<ovrParallelFor>();
+    const std::function<void(int)>* jobPtr = &job;
+    auto work = [state, jobPtr, count]() {
+        // job is only touched for items that are still to do, so the caller is still waiting
+        int numRun = 0;
+        for (int i = state->Next++; i < count; i = state->Next++) {
+            (*jobPtr)(i);
+            numRun++;
+        }
+        if (numRun > 0) {
+            std::lock_guard<std::mutex> lock(state->Mutex);
+            state->NumDone += numRun;
+            if (state->NumDone == count) {
+                state->Done.notify_all();
+            }
+        }
+    };
+
+    int const numHelpers = std::min(static_cast<int>(Threads.size()), count - 1);
+    if (numHelpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(JobMutex);
+            for (int i = 0; i < numHelpers; ++i) {
+                Helpers.push_back(work);
+            }
+        }
+        JobReady.notify_all();
+    }
+
+    // the calling thread takes a share instead of waiting idle
+    work();
+    std::unique_lock<std::mutex> lock(state->Mutex);
+    state->Done.wait(lock, [&state, count] { return state->NumDone >= count; });
+}
+
+//==============================
+// ovrAsyncLoader::Update
+int ovrAsyncLoader::Update(double const budgetSeconds) {
+    return UploadQueue.Drain(budgetSeconds);
+}
+
+//==============================
+// ovrAsyncLoader::ThreadFunction
+void ovrAsyncLoader::ThreadFunction() {
+    for (;;) {
+        ovrSteppedLoadJob job;
+        std::function<void()> helper;
+        {
+            std::unique_lock<std::mutex> lock(JobMutex);
+            JobReady.wait(
+                lock, [this] { return Stopping || !Helpers.empty() || !Jobs.empty(); });
+            if (Stopping) {
+                return;
+            }
+            // helpers first, they speed up a load that is already running
+            if (!Helpers.empty()) {
+                helper = std::move(Helpers.front());
+                Helpers.pop_front();
+            } else {
+                job = std::move(Jobs.front());
+                Jobs.pop_front();
+            }
+        }
+        if (helper) {
+            helper();
+            continue;
+        }
+
+        ovrGpuUploadSteps steps = job();
+        if (!steps) {
+            NumPending--;
+            continue;
+        }
+
+        // the load only counts as finished once its last step has run on the GL thread
+        std::atomic<int>* numPending = &NumPending;
+        UploadQueue.PostSteps([steps, numPending]() {
+            if (!steps()) {
+                return false;
+            }
+            (*numPending)--;
+            return true;
+        });
+    }
+}
+
+} // namespace OVRFW
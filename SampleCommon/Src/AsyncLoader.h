@@ -0,0 +1,128 @@
+/************************************************************************************
+
+Filename    :   AsyncLoader.h
+Content     :   Loader threads for the CPU side of asset loading, plus a bounded queue of GPU
+                uploads drained on the GL thread under a per-frame time budget.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OVRFW {
+
+// Work that has to run on the thread that owns the GL context: creating buffers and textures,
+// and handing the finished asset to the application.
+typedef std::function<void()> ovrGpuUpload;
+
+// GL work that is split up so it can be spread over frames. Each call does one bounded piece,
+// such as one buffer or one texture, and returns true once the last piece is done.
+typedef std::function<bool()> ovrGpuUploadSteps;
+
+// The CPU stage of a load: file reads, decompression, parsing and decoding. Runs on a loader
+// thread and returns the upload that finishes the asset, or an empty function if there is
+// nothing left to do on the GL thread.
+typedef std::function<ovrGpuUpload()> ovrLoadJob;
+
+// A load job whose GL work is done in steps.
+typedef std::function<ovrGpuUploadSteps()> ovrSteppedLoadJob;
+
+//==============================================================
+// ovrGpuUploadQueue
+// Bounded queue between the loader threads and the GL thread. Loader threads block in Post()
+// while the queue is full, so decoded data waiting for the GPU can't grow without limit.
+// Nothing in here touches GL; the queued functions are the only GL code.
+class ovrGpuUploadQueue {
+   public:
+    explicit ovrGpuUploadQueue(int const capacity);
+
+    // Called from any thread. Blocks while the queue is full. Returns false, dropping the upload,
+    // if the queue has been closed.
+    bool Post(ovrGpuUpload&& upload);
+    // Same for an upload done in steps. It keeps its place at the front of the queue until its
+    // last step is done, and only then frees its slot.
+    bool PostSteps(ovrGpuUploadSteps&& steps);
+
+    // Called on the GL thread. Runs queued uploads, one step at a time, until the queue is empty
+    // or budgetSeconds has passed. At least one step is run per call so loading always makes
+    // progress. Returns the number of steps run.
+    int Drain(double const budgetSeconds);
+
+    // Releases any blocked Post() calls and drops everything still queued.
+    void Close();
+    // Re-opens a closed queue.
+    void Open();
+
+    int GetNumQueued() const;
+
+   private:
+    mutable std::mutex Mutex;
+    std::condition_variable NotFull;
+    std::deque<ovrGpuUploadSteps> Uploads;
+    int const Capacity;
+    bool Closed;
+};
+
+//==============================================================
+// ovrAsyncLoader
+// Runs load jobs on a small pool of loader threads. Each job's upload is posted to the upload
+// queue, which the application drains once per frame on the GL thread by calling Update().
+class ovrAsyncLoader {
+   public:
+    static int const DEFAULT_UPLOAD_QUEUE_SIZE = 16;
+
+    explicit ovrAsyncLoader(int const uploadQueueSize = DEFAULT_UPLOAD_QUEUE_SIZE);
+    ~ovrAsyncLoader();
+
+    // numThreads <= 0 picks a count based on the number of cores.
+    void Init(int const numThreads = 0);
+    // Stops the loader threads. Jobs and uploads that have not run yet are dropped.
+    void Shutdown();
+
+    // Called from any thread.
+    void Load(ovrLoadJob&& job);
+    void LoadInSteps(ovrSteppedLoadJob&& job);
+
+    // Runs job( 0 ) .. job( count - 1 ) on the calling thread and on any loader threads that are
+    // idle, and returns once all of them are done. For splitting one load job's CPU work, such as
+    // decoding a model's images, across the pool. Safe to call from a load job: the calling
+    // thread works through the items itself, so it never waits for a loader thread to free up.
+    void ParallelFor(int const count, const std::function<void(int)>& job);
+
+    // Called once per frame on the GL thread. Returns the number of upload steps run.
+    int Update(double const budgetSeconds);
+
+    // Number of loads that have been requested but not finished on the GL thread yet.
+    int GetNumPending() const {
+        return NumPending.load();
+    }
+    bool IsIdle() const {
+        return GetNumPending() == 0;
+    }
+
+   private:
+    std::vector<std::thread> Threads;
+    std::mutex JobMutex;
+    std::condition_variable JobReady;
+    std::deque<ovrSteppedLoadJob> Jobs;
+    // ParallelFor() work, run before any new load job
+    std::deque<std::function<void()>> Helpers;
+    bool Stopping;
+    ovrGpuUploadQueue UploadQueue;
+    std::atomic<int> NumPending;
+
+    void ThreadFunction();
+};
+
+} // namespace OVRFW
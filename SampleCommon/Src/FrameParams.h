@@ -18,7 +18,10 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 namespace OVRFW {
 
+class ovrInputSnapshot;
+
 struct ovrKeyEvent {
+    ovrKeyEvent() = default;
     ovrKeyEvent(const int32_t keyCode, const int32_t action, const double t)
         : KeyCode(keyCode), Action(action), Time(t) {}
     int32_t KeyCode = 0;
@@ -27,6 +30,7 @@ struct ovrKeyEvent {
 };
 
 struct ovrTouchEvent {
+    ovrTouchEvent() = default;
     ovrTouchEvent(const int32_t action, const int32_t x_, const int32_t y_, const double t)
         : Action(action), x(x_), y(y_), Time(t) {}
     int32_t Action = 0;
@@ -84,6 +88,9 @@ struct ovrApplFrameIn {
     /// Key/Touch android events
     std::vector<ovrKeyEvent> KeyEvents;
     std::vector<ovrTouchEvent> TouchEvents;
+    /// All input devices as captured at the start of the frame; the fields above are derived
+    /// from it. Owned by the application and valid until this frame has been rendered.
+    const ovrInputSnapshot* Input = nullptr;
 
     /// Convenience APIs
     static const int kButtonA = 0x00000001;
@@ -124,7 +131,7 @@ class ovrApplFrameOut {
 };
 
 struct ovrRendererOutput {
-    FrameMatrices FrameMatrices; // view and projection transforms
+    OVRFW::FrameMatrices FrameMatrices; // view and projection transforms
     std::vector<ovrDrawSurface> Surfaces; // list of surfaces to render
 };
 
@@ -0,0 +1,149 @@
+/*******************************************************************************
+
+Filename    :   FrameTimings.cpp
+Content     :   Per-phase CPU timings of the frame loop
+Created     :   October 18, 2026
+Authors     :
+Language    :   C++
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*******************************************************************************/
+
+#include "FrameTimings.h"
+
+#include <stdio.h>
+
+#include "System.h"
+
+namespace OVRFW {
+
+ovrFrameTimings::ovrFrameTimings(const char* name, const double reportIntervalSeconds)
+    : Name(name),
+      ReportIntervalSeconds(reportIntervalSeconds),
+      LastReportTime(0.0),
+      FrameStartTime(0.0),
+      PhaseStartTime(0.0),
+      NumPhases(0) {
+    Clear();
+}
+
+//==============================
+// ovrFrameTimings::Clear
+void ovrFrameTimings::Clear() {
+    NumFrames = 0;
+    FrameTotalSeconds = 0.0;
+    FrameMaxSeconds = 0.0;
+    for (int i = 0; i < NumPhases; ++i) {
+        Phases[i].TotalSeconds = 0.0;
+        Phases[i].MaxSeconds = 0.0;
+        Phases[i].FrameSeconds = 0.0;
+    }
+}
+
+//==============================
+// ovrFrameTimings::FindPhase
+int ovrFrameTimings::FindPhase(const char* phase) {
+    for (int i = 0; i < NumPhases; ++i) {
+        if (Phases[i].Name == phase) {
+            return i;
+        }
+    }
+    if (NumPhases == MAX_PHASES) {
+        return -1;
+    }
+    ovrPhase& p = Phases[NumPhases];
+    p.Name = phase;
+    p.TotalSeconds = 0.0;
+    p.MaxSeconds = 0.0;
+    p.FrameSeconds = 0.0;
+    return NumPhases++;
+}
+
+//==============================
+// ovrFrameTimings::BeginFrame
+void ovrFrameTimings::BeginFrame() {
+    FrameStartTime = GetTimeInSeconds();
+    PhaseStartTime = FrameStartTime;
+    if (LastReportTime == 0.0) {
+        LastReportTime = FrameStartTime;
+    }
+}
+
+//==============================
+// ovrFrameTimings::EndPhase
+void ovrFrameTimings::EndPhase(const char* phase) {
+    const double now = GetTimeInSeconds();
+    const int index = FindPhase(phase);
+    if (index >= 0) {
+        Phases[index].FrameSeconds += now - PhaseStartTime;
+    }
+    PhaseStartTime = now;
+}
+
+//==============================
+// ovrFrameTimings::EndFrame
+void ovrFrameTimings::EndFrame() {
+    const double now = GetTimeInSeconds();
+    const double frameSeconds = now - FrameStartTime;
+    NumFrames++;
+    FrameTotalSeconds += frameSeconds;
+    FrameMaxSeconds = frameSeconds > FrameMaxSeconds ? frameSeconds : FrameMaxSeconds;
+    for (int i = 0; i < NumPhases; ++i) {
+        ovrPhase& p = Phases[i];
+        p.TotalSeconds += p.FrameSeconds;
+        p.MaxSeconds = p.FrameSeconds > p.MaxSeconds ? p.FrameSeconds : p.MaxSeconds;
+        p.FrameSeconds = 0.0;
+    }
+    if (ReportIntervalSeconds > 0.0 && now - LastReportTime >= ReportIntervalSeconds) {
+        Report();
+        LastReportTime = now;
+    }
+}
+
+//==============================
+// ovrFrameTimings::GetMeanMilliseconds
+double ovrFrameTimings::GetMeanMilliseconds(const int phase) const {
+    if (NumFrames == 0) {
+        return 0.0;
+    }
+    const double total = phase < 0 ? FrameTotalSeconds : Phases[phase].TotalSeconds;
+    return total * 1000.0 / NumFrames;
+}
+
+//==============================
+// ovrFrameTimings::GetMaxMilliseconds
+double ovrFrameTimings::GetMaxMilliseconds(const int phase) const {
+    return (phase < 0 ? FrameMaxSeconds : Phases[phase].MaxSeconds) * 1000.0;
+}
+
+//==============================
+// ovrFrameTimings::Report
+void ovrFrameTimings::Report() {
+    if (NumFrames == 0) {
+        return;
+    }
+    // one line, so the phases of a report can't be interleaved with other output
+    char line[1024];
+    int length = snprintf(
+        line,
+        sizeof(line),
+        "%s: %i frames, mean/max ms: frame %.2f/%.2f",
+        Name,
+        NumFrames,
+        GetMeanMilliseconds(-1),
+        GetMaxMilliseconds(-1));
+    for (int i = 0; i < NumPhases && length > 0 && length < (int)sizeof(line); ++i) {
+        length += snprintf(
+            line + length,
+            sizeof(line) - length,
+            ", %s %.2f/%.2f",
+            Phases[i].Name,
+            GetMeanMilliseconds(i),
+            GetMaxMilliseconds(i));
+    }
+    ALOG("%s", line);
+    Clear();
+}
+
+} // namespace OVRFW
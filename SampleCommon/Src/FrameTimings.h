@@ -0,0 +1,86 @@
+/*******************************************************************************
+
+Filename    :   FrameTimings.h
+Content     :   Per-phase CPU timings of the frame loop
+Created     :   October 18, 2026
+Authors     :
+Language    :   C++
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*******************************************************************************/
+
+#pragma once
+
+namespace OVRFW {
+
+//==============================================================
+// ovrFrameTimings
+// Splits each frame into named phases and accumulates the wall clock time spent in each, so the
+// cost of a change to one part of the frame can be read directly instead of inferred from the
+// total. A frame is timed as:
+//
+//   timings.BeginFrame();
+//   ... input ...
+//   timings.EndPhase("input");
+//   ... scene ...
+//   timings.EndPhase("scene");
+//   timings.EndFrame();
+//
+// Phase names must be string literals, or otherwise outlive the timings, since phases are
+// identified by pointer. Every ReportIntervalSeconds the mean and maximum of each phase are
+// logged and the statistics start over; the same numbers are available through the accessors
+// for anything that wants to report them another way.
+//
+// The overhead is one clock read per phase.
+class ovrFrameTimings {
+   public:
+    static const int MAX_PHASES = 16;
+
+    explicit ovrFrameTimings(const char* name, const double reportIntervalSeconds = 10.0);
+
+    void BeginFrame();
+    // Ends the phase that started at the previous BeginFrame() or EndPhase() call.
+    void EndPhase(const char* phase);
+    void EndFrame();
+
+    // Statistics since the last report, in milliseconds. Phase -1 is the whole frame.
+    int GetNumPhases() const {
+        return NumPhases;
+    }
+    const char* GetPhaseName(const int phase) const {
+        return phase < 0 ? "frame" : Phases[phase].Name;
+    }
+    int GetNumFrames() const {
+        return NumFrames;
+    }
+    double GetMeanMilliseconds(const int phase) const;
+    double GetMaxMilliseconds(const int phase) const;
+
+    // Logs the statistics and starts new ones.
+    void Report();
+
+   private:
+    struct ovrPhase {
+        const char* Name;
+        double TotalSeconds;
+        double MaxSeconds;
+        double FrameSeconds; // this frame's time, a phase may be ended more than once a frame
+    };
+
+    const char* Name;
+    double ReportIntervalSeconds;
+    double LastReportTime;
+    double FrameStartTime;
+    double PhaseStartTime;
+    int NumFrames;
+    double FrameTotalSeconds;
+    double FrameMaxSeconds;
+    int NumPhases;
+    ovrPhase Phases[MAX_PHASES];
+
+    int FindPhase(const char* phase);
+    void Clear();
+};
+
+} // namespace OVRFW
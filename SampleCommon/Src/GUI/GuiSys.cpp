@@ -897,14 +897,16 @@ HitTestResult OvrGuiSysLocal::TestRayIntersection(const Vector3f& start, const V
         if (curMenu == nullptr) {
             continue;
         }
-        VRMenuObject* root = GetVRMenuMgr().ToObject(curMenu->GetRootHandle());
-        if (root == nullptr) {
-            continue;
-        }
 
         HitTestResult r;
-        menuHandle_t hitHandle = root->HitTest(
-            *this, curMenu->GetMenuPose(), start, dir, ContentFlags_t(CONTENT_SOLID), r);
+        menuHandle_t hitHandle = curMenu->HitBvh.HitTest(
+            *this,
+            curMenu->GetRootHandle(),
+            curMenu->GetMenuPose(),
+            start,
+            dir,
+            ContentFlags_t(CONTENT_SOLID),
+            r);
         if (hitHandle.IsValid() && r.t < result.t) {
             result = r;
             result.RayStart = start;
@@ -18,6 +18,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "OVR_TypesafeNumber.h"
 
 #include <alloca.h>
+#include <algorithm>
 #include <cstdlib> // for strtoll
 
 namespace OVRFW {
@@ -726,11 +727,102 @@ void ovrReflection::Shutdown() {
 
 void ovrReflection::AddTypeInfoList(ovrTypeInfo const* list) {
     TypeInfoLists.push_back(list);
+    BuildIndices();
+}
+
+static bool TypeInfoNameLess(ovrTypeInfo const* a, ovrTypeInfo const* b) {
+    return OVR::OVR_strcmp(a->TypeName, b->TypeName) < 0;
+}
+
+static bool MemberInfoNameLess(ovrMemberInfo const* a, ovrMemberInfo const* b) {
+    return OVR::OVR_strcmp(a->MemberName, b->MemberName) < 0;
+}
+
+void ovrReflection::BuildIndices() {
+    // gather every type in list order so that a stable sort keeps the first definition of a
+    // name first, matching the precedence of the old linear search
+    std::vector<ovrTypeInfo const*> sorted;
+    for (ovrTypeInfo const* list : TypeInfoLists) {
+        for (int i = 0; list[i].TypeName != nullptr; ++i) {
+            sorted.push_back(&list[i]);
+        }
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), TypeInfoNameLess);
+
+    TypeIndex.clear();
+    TypeIndex.reserve(sorted.size());
+    for (ovrTypeInfo const* ti : sorted) {
+        if (!TypeIndex.empty() &&
+            OVR::OVR_strcmp(TypeIndex.back().TypeInfo->TypeName, ti->TypeName) == 0) {
+            continue; // shadowed by a type in an earlier list
+        }
+        ovrTypeIndexEntry entry;
+        entry.TypeInfo = ti;
+        TypeIndex.push_back(entry);
+    }
+
+    // flatten members up the inheritance chain now that all type names can be resolved
+    for (ovrTypeIndexEntry& entry : TypeIndex) {
+        int depth = 0; // guards against a malformed, cyclic parent chain
+        for (ovrTypeInfo const* ti = entry.TypeInfo; ti != nullptr && depth < 64; ++depth) {
+            if (ti->MemberInfo != nullptr) {
+                for (int i = 0; ti->MemberInfo[i].MemberName != nullptr; ++i) {
+                    entry.Members.push_back(&ti->MemberInfo[i]);
+                }
+            }
+            ovrTypeIndexEntry const* parent = FindTypeIndexEntry(ti->ParentTypeName);
+            ti = parent != nullptr ? parent->TypeInfo : nullptr;
+        }
+        std::stable_sort(entry.Members.begin(), entry.Members.end(), MemberInfoNameLess);
+        entry.Members.erase(
+            std::unique(
+                entry.Members.begin(),
+                entry.Members.end(),
+                [](ovrMemberInfo const* a, ovrMemberInfo const* b) {
+                    return OVR::OVR_strcmp(a->MemberName, b->MemberName) == 0;
+                }),
+            entry.Members.end());
+    }
+}
+
+ovrReflection::ovrTypeIndexEntry const* ovrReflection::FindTypeIndexEntry(
+    char const* typeName) const {
+    if (typeName == nullptr || typeName[0] == '\0') {
+        return nullptr;
+    }
+
+    auto it = std::lower_bound(
+        TypeIndex.begin(),
+        TypeIndex.end(),
+        typeName,
+        [](ovrTypeIndexEntry const& e, char const* name) {
+            return OVR::OVR_strcmp(e.TypeInfo->TypeName, name) < 0;
+        });
+    if (it == TypeIndex.end() || OVR::OVR_strcmp(it->TypeInfo->TypeName, typeName) != 0) {
+        return nullptr;
+    }
+    return &(*it);
 }
 
 ovrMemberInfo const* ovrReflection::FindMemberReflectionInfoRecursive(
     ovrTypeInfo const* objectTypeInfo,
     const char* memberName) {
+    ovrTypeIndexEntry const* entry = FindTypeIndexEntry(objectTypeInfo->TypeName);
+    if (entry != nullptr && entry->TypeInfo == objectTypeInfo) {
+        auto it = std::lower_bound(
+            entry->Members.begin(),
+            entry->Members.end(),
+            memberName,
+            [](ovrMemberInfo const* m, char const* name) {
+                return OVR::OVR_strcmp(m->MemberName, name) < 0;
+            });
+        if (it == entry->Members.end() || OVR::OVR_strcmp((*it)->MemberName, memberName) != 0) {
+            return nullptr;
+        }
+        return *it;
+    }
+
+    // the type isn't in the index (e.g. it was shadowed by an earlier list), so walk it
     ovrMemberInfo const* arrayOfMemberType = objectTypeInfo->MemberInfo;
     for (int i = 0; arrayOfMemberType[i].MemberName != nullptr; ++i) {
         if (!OVR::OVR_strcmp(arrayOfMemberType[i].MemberName, memberName)) {
@@ -766,12 +858,9 @@ ovrTypeInfo const* ovrReflection::FindTypeInfo(char const* typeName) {
         return nullptr;
     }
 
-    for (int i = 0; i < static_cast<int>(TypeInfoLists.size()); ++i) {
-        // ALOG( "FindTypeInfo searching for %s ...", typeName );
-        ovrTypeInfo const* ti = StaticFindTypeInfo(TypeInfoLists[i], typeName);
-        if (ti != nullptr) {
-            return ti;
-        }
+    ovrTypeIndexEntry const* entry = FindTypeIndexEntry(typeName);
+    if (entry != nullptr) {
+        return entry->TypeInfo;
     }
     ALOG("FindTypeInfo for '%s' could not be found! ERROR", typeName);
     assert(false);
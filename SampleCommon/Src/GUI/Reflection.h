@@ -265,6 +265,8 @@ class ovrReflection {
     void Init();
     void Shutdown();
     // Add an additional list of types. The list must be terminated by a a
+    // null TypeName. Adding a list rebuilds the sorted type and member indices, so lists
+    // should be added once at init rather than during parsing.
     void AddTypeInfoList(ovrTypeInfo const* list);
 
     ovrMemberInfo const* FindMemberReflectionInfoRecursive(
@@ -284,7 +286,19 @@ class ovrReflection {
     static ovrTypeInfo const* StaticFindTypeInfo(ovrTypeInfo const* list, char const* typeName);
 
    private:
+    // One entry per unique type name, sorted by name so lookups are a binary search instead
+    // of a linear walk over every list. Members holds the type's own members followed by
+    // all inherited members, also sorted by name, with derived members shadowing parents.
+    struct ovrTypeIndexEntry {
+        ovrTypeInfo const* TypeInfo;
+        std::vector<ovrMemberInfo const*> Members;
+    };
+
+    void BuildIndices();
+    ovrTypeIndexEntry const* FindTypeIndexEntry(char const* typeName) const;
+
     std::vector<ovrTypeInfo const*> TypeInfoLists;
+    std::vector<ovrTypeIndexEntry> TypeIndex;
     std::vector<ovrReflectionOverload*> Overloads;
 
     // can only be allocated and deleted by ovrReflection::Create and ovrReflection::Destroy
@@ -26,6 +26,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "VRMenuObject.h"
 #include "SoundLimiter.h"
 #include "GazeCursor.h"
+#include "VRMenuHitBvh.h"
 
 namespace OVRFW {
 
@@ -237,6 +238,8 @@ class VRMenu {
     bool ComponentsInitialized; // true if init message has been sent to components
     bool PostInitialized; // true if post init was run
 
+    VRMenuHitBvh HitBvh; // accelerates OvrGuiSys::TestRayIntersection() against this menu
+
    private:
     // return true to continue with normal initialization (adding items) or false to skip.
     virtual bool Init_Impl(
@@ -0,0 +1,221 @@
+/************************************************************************************
+
+Filename    :   VRMenuBatcher.cpp
+Content     :   Merges consecutive compatible menu surfaces into a single draw.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#include "VRMenuBatcher.h"
+
+#include <algorithm>
+
+using OVR::Matrix4f;
+
+namespace OVRFW {
+
+static bool GpuStatesMatch(ovrGpuState const& a, ovrGpuState const& b) {
+    return a.blendMode == b.blendMode && a.blendSrc == b.blendSrc && a.blendDst == b.blendDst &&
+        a.blendSrcAlpha == b.blendSrcAlpha && a.blendDstAlpha == b.blendDstAlpha &&
+        a.blendModeAlpha == b.blendModeAlpha && a.depthFunc == b.depthFunc &&
+        a.frontFace == b.frontFace && a.polygonMode == b.polygonMode &&
+        a.blendEnable == b.blendEnable && a.depthEnable == b.depthEnable &&
+        a.depthMaskEnable == b.depthMaskEnable &&
+        a.colorMaskEnable[0] == b.colorMaskEnable[0] &&
+        a.colorMaskEnable[1] == b.colorMaskEnable[1] &&
+        a.colorMaskEnable[2] == b.colorMaskEnable[2] &&
+        a.colorMaskEnable[3] == b.colorMaskEnable[3] &&
+        a.polygonOffsetEnable == b.polygonOffsetEnable && a.cullEnable == b.cullEnable &&
+        a.lineWidth == b.lineWidth && a.depthRange[0] == b.depthRange[0] &&
+        a.depthRange[1] == b.depthRange[1];
+}
+
+//==============================
+// VRMenuBatcher::VRMenuBatcher
+VRMenuBatcher::VRMenuBatcher() : NumBatches(0), NumKeptBatches(0) {}
+
+//==============================
+// VRMenuBatcher::CanMerge
+bool VRMenuBatcher::CanMerge(VRMenuBatchSource const& a, VRMenuBatchSource const& b) {
+    if (a.SurfaceDef == nullptr || b.SurfaceDef == nullptr) {
+        return false;
+    }
+
+    ovrGraphicsCommand const& ga = a.SurfaceDef->graphicsCommand;
+    ovrGraphicsCommand const& gb = b.SurfaceDef->graphicsCommand;
+    if (ga.Program.Program != gb.Program.Program) {
+        return false;
+    }
+    int const numTextures =
+        std::min(ga.Program.numTextureBindings, static_cast<int>(ovrGraphicsCommand::MAX_TEXTURES));
+    for (int i = 0; i < numTextures; ++i) {
+        if (ga.Textures[i].texture != gb.Textures[i].texture ||
+            ga.Textures[i].target != gb.Textures[i].target) {
+            return false;
+        }
+    }
+    if (!GpuStatesMatch(ga.GpuState, gb.GpuState)) {
+        return false;
+    }
+
+    return a.Color == b.Color && a.ClipUVs == b.ClipUVs && a.OffsetUVs == b.OffsetUVs &&
+        a.ColorTableOffset == b.ColorTableOffset;
+}
+
+//==============================
+// VRMenuBatcher::FindRunEnd
+size_t VRMenuBatcher::FindRunEnd(
+    std::vector<VRMenuBatchSource> const& sources,
+    size_t const first) {
+    VRMenuBatchSource const& head = sources[first];
+    if (head.SurfaceDef == nullptr) {
+        return first + 1;
+    }
+
+    size_t numVertices = head.Attribs->position.size();
+    size_t end = first + 1;
+    for (; end < sources.size(); ++end) {
+        if (!CanMerge(head, sources[end])) {
+            break;
+        }
+        numVertices += sources[end].Attribs->position.size();
+        if (numVertices > static_cast<size_t>(GlGeometry::GetMaxGeometryVertices())) {
+            break;
+        }
+    }
+    return end;
+}
+
+//==============================
+// VRMenuBatcher::AppendTransformed
+void VRMenuBatcher::AppendTransformed(
+    VRMenuBatchSource const& source,
+    Matrix4f const& modelMatrix,
+    VertexAttribs& attribs,
+    std::vector<TriangleIndex>& indices) {
+    VertexAttribs const& in = *source.Attribs;
+    size_t const base = attribs.position.size();
+    size_t const count = in.position.size();
+
+    attribs.position.resize(base + count);
+    for (size_t i = 0; i < count; ++i) {
+        attribs.position[base + i] = modelMatrix.Transform(in.position[i]);
+    }
+    attribs.uv0.insert(attribs.uv0.end(), in.uv0.begin(), in.uv0.end());
+    attribs.uv1.insert(attribs.uv1.end(), in.uv1.begin(), in.uv1.end());
+    attribs.color.insert(attribs.color.end(), in.color.begin(), in.color.end());
+
+    std::vector<TriangleIndex> const& inIndices = *source.Indices;
+    size_t const firstIndex = indices.size();
+    indices.resize(firstIndex + inIndices.size());
+    for (size_t i = 0; i < inIndices.size(); ++i) {
+        indices[firstIndex + i] = static_cast<TriangleIndex>(base + inIndices[i]);
+    }
+}
+
+//==============================
+// VRMenuBatcher::AllocBatch
+VRMenuBatcher::ovrBatch& VRMenuBatcher::AllocBatch() {
+    if (NumBatches >= static_cast<int>(Batches.size())) {
+        Batches.emplace_back();
+        Batches.back().SurfaceDef.reset(new ovrSurfaceDef());
+#if defined(OVR_BUILD_DEBUG)
+        Batches.back().SurfaceDef->surfaceName = "VRMenuBatch";
+#endif
+    }
+    return Batches[NumBatches++];
+}
+
+//==============================
+// VRMenuBatcher::IsBatchCurrent
+bool VRMenuBatcher::IsBatchCurrent(
+    ovrBatch const& batch,
+    std::vector<ovrDrawSurface> const& surfaceList,
+    size_t const first,
+    size_t const end,
+    VRMenuBatchSource const* sources) {
+    if (batch.Keys.size() != end - first) {
+        return false;
+    }
+    for (size_t i = first; i < end; ++i) {
+        ovrBatchKey const& key = batch.Keys[i - first];
+        uint32_t const version = sources[i - first].GeometryVersion;
+        if (version == 0 || key.GeometryVersion != version ||
+            !(key.ModelMatrix == surfaceList[i].modelMatrix)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//==============================
+// VRMenuBatcher::Merge
+void VRMenuBatcher::Merge(
+    std::vector<ovrDrawSurface>& surfaceList,
+    size_t const first,
+    std::vector<VRMenuBatchSource> const& sources) {
+    NumBatches = 0;
+    NumKeptBatches = 0;
+
+    size_t out = first;
+    size_t i = first;
+    while (i < surfaceList.size()) {
+        size_t const end = first + FindRunEnd(sources, i - first);
+        if (end - i < 2) {
+            surfaceList[out++] = surfaceList[i++];
+            continue;
+        }
+
+        ovrBatch& batch = AllocBatch();
+        ovrSurfaceDef& def = *batch.SurfaceDef;
+        if (IsBatchCurrent(batch, surfaceList, i, end, &sources[i - first])) {
+            NumKeptBatches++;
+        } else {
+            batch.Attribs.position.resize(0);
+            batch.Attribs.uv0.resize(0);
+            batch.Attribs.uv1.resize(0);
+            batch.Attribs.color.resize(0);
+            batch.Indices.resize(0);
+            batch.Keys.resize(0);
+            bool keep = true;
+            for (size_t j = i; j < end; ++j) {
+                VRMenuBatchSource const& source = sources[j - first];
+                AppendTransformed(source, surfaceList[j].modelMatrix, batch.Attribs, batch.Indices);
+                keep = keep && source.GeometryVersion != 0;
+                ovrBatchKey const key = {source.GeometryVersion, surfaceList[j].modelMatrix};
+                batch.Keys.push_back(key);
+            }
+            if (!keep) {
+                batch.Keys.resize(0);
+            }
+            def.geo.Stream(batch.Attribs, batch.Indices);
+        }
+
+        // the uniform data still points at the first surface's values, which every surface in
+        // the run shares
+        def.graphicsCommand = surfaceList[i].surface->graphicsCommand;
+
+        surfaceList[out].modelMatrix = Matrix4f::Identity();
+        surfaceList[out].surface = &def;
+        out++;
+        i = end;
+    }
+    surfaceList.resize(out);
+}
+
+//==============================
+// VRMenuBatcher::Shutdown
+void VRMenuBatcher::Shutdown() {
+    for (ovrBatch& batch : Batches) {
+        batch.SurfaceDef->geo.Free();
+    }
+    Batches.clear();
+    NumBatches = 0;
+    NumKeptBatches = 0;
+}
+
+} // namespace OVRFW
@@ -0,0 +1,130 @@
+/************************************************************************************
+
+Filename    :   VRMenuBatcher.h
+Content     :   Merges consecutive compatible menu surfaces into a single draw.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "OVR_Math.h"
+
+#include "Render/GlGeometry.h"
+#include "Render/SurfaceRender.h"
+
+namespace OVRFW {
+
+//==============================================================
+// VRMenuBatchSource
+// Everything the batcher needs to know about one surface submitted for drawing. A source with
+// a null SurfaceDef is never merged with anything.
+struct VRMenuBatchSource {
+    VRMenuBatchSource()
+        : SurfaceDef(nullptr),
+          Attribs(nullptr),
+          Indices(nullptr),
+          GeometryVersion(0),
+          Color(1.0f),
+          ClipUVs(0.0f, 0.0f, 1.0f, 1.0f),
+          OffsetUVs(0.0f),
+          ColorTableOffset(0.0f) {}
+
+    ovrSurfaceDef const* SurfaceDef; // program, textures and gpu state
+    VertexAttribs const* Attribs; // vertices in the surface's local space
+    std::vector<TriangleIndex> const* Indices;
+    // changes whenever Attribs and Indices do, so a batch built from the same versions and model
+    // matrices as on the last frame can be kept as it is; 0 if unknown, which is never kept
+    uint32_t GeometryVersion;
+    // uniform values - these must match exactly, since a batch is drawn with one set of uniforms
+    OVR::Vector4f Color;
+    OVR::Vector4f ClipUVs;
+    OVR::Vector2f OffsetUVs;
+    OVR::Vector2f ColorTableOffset;
+};
+
+//==============================================================
+// VRMenuBatcher
+// Runs of consecutive surfaces in the sorted draw list that share a program, textures, gpu
+// state and uniform values are pre-transformed into a single streamed vertex buffer and drawn
+// with an identity model matrix. Because only neighbors in the sorted list are merged, the
+// draw order (and therefore blending) is unchanged.
+//
+// A batch whose surfaces have the same geometry versions and model matrices as the batch in
+// the same place on the last frame keeps that batch's vertices and buffers, so a menu that
+// isn't moving isn't transformed or uploaded again.
+//
+// The merge decisions and vertex generation are static and do not touch GL.
+class VRMenuBatcher {
+   public:
+    VRMenuBatcher();
+
+    // Returns true if b can be drawn in the same batch as a.
+    static bool CanMerge(VRMenuBatchSource const& a, VRMenuBatchSource const& b);
+
+    // Returns the index one past the last source that can be merged with sources[first]. A
+    // result of first + 1 means the source is drawn on its own.
+    static size_t FindRunEnd(std::vector<VRMenuBatchSource> const& sources, size_t const first);
+
+    // Appends the source's vertices, transformed by modelMatrix, and its re-based indices.
+    static void AppendTransformed(
+        VRMenuBatchSource const& source,
+        OVR::Matrix4f const& modelMatrix,
+        VertexAttribs& attribs,
+        std::vector<TriangleIndex>& indices);
+
+    // Replaces each mergeable run in surfaceList[first..] with one batched draw surface.
+    // sources[i] describes surfaceList[first + i].
+    void Merge(
+        std::vector<ovrDrawSurface>& surfaceList,
+        size_t const first,
+        std::vector<VRMenuBatchSource> const& sources);
+
+    // Frees the batch geometry. Must be called on the GL thread.
+    void Shutdown();
+
+    int GetNumBatches() const {
+        return NumBatches;
+    }
+    // number of batches this frame that were kept from the last one
+    int GetNumKeptBatches() const {
+        return NumKeptBatches;
+    }
+
+   private:
+    // what a batch's vertices were built from, per surface
+    struct ovrBatchKey {
+        uint32_t GeometryVersion;
+        OVR::Matrix4f ModelMatrix;
+    };
+
+    struct ovrBatch {
+        // the draw list keeps pointers to this, so it must not move when Batches grows
+        std::unique_ptr<ovrSurfaceDef> SurfaceDef;
+        VertexAttribs Attribs;
+        std::vector<TriangleIndex> Indices;
+        std::vector<ovrBatchKey> Keys; // empty if the batch can't be kept
+    };
+
+    std::vector<ovrBatch> Batches; // only grows, so geometry is reused from frame to frame
+    int NumBatches; // number of batches used this frame
+    int NumKeptBatches;
+
+    ovrBatch& AllocBatch();
+    // Returns true if batch was built from exactly the given run of surfaces.
+    static bool IsBatchCurrent(
+        ovrBatch const& batch,
+        std::vector<ovrDrawSurface> const& surfaceList,
+        size_t const first,
+        size_t const end,
+        VRMenuBatchSource const* sources);
+};
+
+} // namespace OVRFW
@@ -0,0 +1,240 @@
+/************************************************************************************
+
+Filename    :   VRMenuHitBvh.cpp
+Content     :   Bounding volume hierarchy used to accelerate ray hit tests against a menu.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#include "VRMenuHitBvh.h"
+
+#include <algorithm>
+
+#include "GuiSys.h"
+#include "VRMenuMgr.h"
+
+using OVR::Bounds3f;
+using OVR::Posef;
+using OVR::Vector3f;
+
+namespace OVRFW {
+
+// VRMenuObject::IntersectRayBounds() accepts rays that start this close to an object's bounds,
+// so leaf bounds must be grown by at least this much to never reject a hit.
+static float const HIT_BOUNDS_EPSILON = 0.1f;
+
+static bool RayHitsBounds(
+    Vector3f const& start,
+    Vector3f const& rcpDir,
+    Bounds3f const& bounds) {
+    if (bounds.Contains(start)) {
+        return true;
+    }
+    float tMin = 0.0f;
+    float tMax = MATH_FLOAT_HUGE_NUMBER;
+    for (int axis = 0; axis < 3; ++axis) {
+        float const s = (bounds.b[0][axis] - start[axis]) * rcpDir[axis];
+        float const t = (bounds.b[1][axis] - start[axis]) * rcpDir[axis];
+        tMin = std::max(tMin, std::min(s, t));
+        tMax = std::min(tMax, std::max(s, t));
+    }
+    return tMax >= tMin;
+}
+
+//==============================
+// VRMenuHitBvh::VRMenuHitBvh
+VRMenuHitBvh::VRMenuHitBvh() : BuiltChangeCounter(0), IsValid(false) {}
+
+//==============================
+// VRMenuHitBvh::Collect_r
+void VRMenuHitBvh::Collect_r(
+    OvrGuiSys const& guiSys,
+    VRMenuObject const* obj,
+    Posef const& parentPose,
+    Vector3f const& parentScale) {
+    // same pruning as VRMenuObject::HitTest_r
+    if (obj->GetFlags() & VRMENUOBJECT_DONT_RENDER) {
+        return;
+    }
+    if (obj->GetFlags() & VRMENUOBJECT_DONT_HIT_ALL) {
+        return;
+    }
+
+    Posef modelPose;
+    Vector3f scale;
+    VRMenuObject::TransformByParentPose(
+        parentPose, parentScale, obj->GetLocalPose(), obj->GetLocalScale(), modelPose, scale);
+
+    // GetLocalBounds() includes surfaces, the collision primitive and text, which covers
+    // everything VRMenuObject::HitTestSelf() can hit.
+    Bounds3f const localBounds = obj->GetLocalBounds(guiSys.GetDefaultFont()) * parentScale;
+    Bounds3f const expanded = Bounds3f::Expand(
+        localBounds, Vector3f(-HIT_BOUNDS_EPSILON), Vector3f(HIT_BOUNDS_EPSILON));
+
+    ovrLeaf leaf;
+    leaf.Handle = obj->GetHandle();
+    leaf.ModelPose = modelPose;
+    leaf.ParentScale = parentScale;
+    leaf.Bounds = Bounds3f::Transform(modelPose, expanded);
+    leaf.Center = leaf.Bounds.GetCenter();
+    leaf.Order = static_cast<int>(Leaves.size());
+    Leaves.push_back(leaf);
+
+    OvrVRMenuMgr const& menuMgr = guiSys.GetVRMenuMgr();
+    for (int i = 0; i < obj->NumChildren(); ++i) {
+        VRMenuObject const* child = menuMgr.ToObject(obj->GetChildHandleForIndex(i));
+        if (child != nullptr) {
+            Collect_r(guiSys, child, modelPose, scale);
+        }
+    }
+}
+
+//==============================
+// VRMenuHitBvh::BuildNode_r
+int VRMenuHitBvh::BuildNode_r(int const first, int const count, int const depth) {
+    int const nodeIndex = static_cast<int>(Nodes.size());
+    Nodes.emplace_back();
+
+    Bounds3f bounds(Bounds3f::Init);
+    Bounds3f centers(Bounds3f::Init);
+    for (int i = first; i < first + count; ++i) {
+        bounds = Bounds3f::Union(bounds, Leaves[i].Bounds);
+        centers.AddPoint(Leaves[i].Center);
+    }
+    Nodes[nodeIndex].Bounds = bounds;
+
+    if (count <= MAX_LEAVES_PER_NODE || depth >= MAX_DEPTH - 1) {
+        Nodes[nodeIndex].FirstLeaf = first;
+        Nodes[nodeIndex].Count = count;
+        Nodes[nodeIndex].RightChild = -1;
+        return nodeIndex;
+    }
+
+    // median split along the axis with the largest spread of leaf centers
+    Vector3f const spread = centers.GetSize();
+    int axis = 0;
+    if (spread.y > spread[axis]) {
+        axis = 1;
+    }
+    if (spread.z > spread[axis]) {
+        axis = 2;
+    }
+    int const half = count / 2;
+    std::nth_element(
+        Leaves.begin() + first,
+        Leaves.begin() + first + half,
+        Leaves.begin() + first + count,
+        [axis](ovrLeaf const& a, ovrLeaf const& b) { return a.Center[axis] < b.Center[axis]; });
+
+    BuildNode_r(first, half, depth + 1);
+    int const right = BuildNode_r(first + half, count - half, depth + 1);
+
+    // Nodes may have been reallocated by the recursion
+    Nodes[nodeIndex].FirstLeaf = -1;
+    Nodes[nodeIndex].Count = 0;
+    Nodes[nodeIndex].RightChild = right;
+    return nodeIndex;
+}
+
+//==============================
+// VRMenuHitBvh::Build
+void VRMenuHitBvh::Build(OvrGuiSys const& guiSys, menuHandle_t const rootHandle) {
+    Leaves.resize(0);
+    Nodes.resize(0);
+
+    VRMenuObject const* root = guiSys.GetVRMenuMgr().ToObject(rootHandle);
+    if (root != nullptr) {
+        // leaves are built in menu space, so the root's parent pose is identity
+        Collect_r(guiSys, root, Posef::Identity(), Vector3f(1.0f));
+    }
+    if (!Leaves.empty()) {
+        BuildNode_r(0, static_cast<int>(Leaves.size()), 0);
+    }
+
+    BuiltRootHandle = rootHandle;
+    BuiltChangeCounter = root != nullptr ? root->GetSubtreeChangeCounter() : 0;
+    IsValid = true;
+}
+
+//==============================
+// VRMenuHitBvh::HitTest
+menuHandle_t VRMenuHitBvh::HitTest(
+    OvrGuiSys const& guiSys,
+    menuHandle_t const rootHandle,
+    Posef const& menuPose,
+    Vector3f const& rayStart,
+    Vector3f const& rayDir,
+    ContentFlags_t const testContents,
+    HitTestResult& result) {
+    VRMenuObject const* root = guiSys.GetVRMenuMgr().ToObject(rootHandle);
+    if (!IsValid || BuiltRootHandle != rootHandle ||
+        (root != nullptr && BuiltChangeCounter != root->GetSubtreeChangeCounter())) {
+        Build(guiSys, rootHandle);
+    }
+    if (Nodes.empty()) {
+        return result.HitHandle;
+    }
+
+    // bring the ray into menu space
+    Vector3f const menuStart = menuPose.Rotation.Inverted().Rotate(rayStart - menuPose.Translation);
+    Vector3f const menuDir = menuPose.Rotation.Inverted().Rotate(rayDir).Normalized();
+    Vector3f rcpDir;
+    for (int axis = 0; axis < 3; ++axis) {
+        rcpDir[axis] = (fabsf(menuDir[axis]) > MATH_FLOAT_SMALLEST_NON_DENORMAL)
+            ? (1.0f / menuDir[axis])
+            : MATH_FLOAT_HUGE_NUMBER;
+    }
+
+    OvrVRMenuMgr const& menuMgr = guiSys.GetVRMenuMgr();
+    int bestOrder = -1;
+
+    int stack[MAX_DEPTH + 1];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        int const nodeIndex = stack[--stackSize];
+        ovrNode const& node = Nodes[nodeIndex];
+        if (!RayHitsBounds(menuStart, rcpDir, node.Bounds)) {
+            continue;
+        }
+        if (node.Count == 0) {
+            stack[stackSize++] = node.RightChild;
+            stack[stackSize++] = nodeIndex + 1;
+            continue;
+        }
+
+        for (int i = node.FirstLeaf; i < node.FirstLeaf + node.Count; ++i) {
+            ovrLeaf const& leaf = Leaves[i];
+            if (!RayHitsBounds(menuStart, rcpDir, leaf.Bounds)) {
+                continue;
+            }
+            VRMenuObject const* obj = menuMgr.ToObject(leaf.Handle);
+            if (obj == nullptr) {
+                continue;
+            }
+
+            Vector3f const localStart =
+                leaf.ModelPose.Rotation.Inverted().Rotate(menuStart - leaf.ModelPose.Translation);
+            Vector3f const localDir = leaf.ModelPose.Rotation.Inverted().Rotate(menuDir);
+
+            HitTestResult r;
+            bool const hit =
+                obj->HitTestSelf(guiSys, leaf.ParentScale, localStart, localDir, testContents, r);
+            if (!hit) {
+                continue;
+            }
+            if (bestOrder < 0 || r.t < result.t || (r.t == result.t && leaf.Order < bestOrder)) {
+                result = r;
+                bestOrder = leaf.Order;
+            }
+        }
+    }
+
+    return result.HitHandle;
+}
+
+} // namespace OVRFW
@@ -0,0 +1,90 @@
+/************************************************************************************
+
+Filename    :   VRMenuHitBvh.h
+Content     :   Bounding volume hierarchy used to accelerate ray hit tests against a menu.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "OVR_Math.h"
+
+#include "VRMenuObject.h"
+
+namespace OVRFW {
+
+class OvrGuiSys;
+
+//==============================================================
+// VRMenuHitBvh
+// Flattened AABB tree over every hit-testable object in a single menu. Boxes are stored in
+// the menu's local space so moving the menu does not invalidate the tree; the tree is rebuilt
+// lazily on the next query whenever the root's VRMenuObject::GetSubtreeChangeCounter() has
+// moved on since the last build. Results match VRMenuObject::HitTest(): the closest hit wins
+// and ties go to the object that comes first in a depth-first walk of the hierarchy.
+class VRMenuHitBvh {
+   public:
+    VRMenuHitBvh();
+
+    // Forces a rebuild on the next query.
+    void Invalidate() {
+        IsValid = false;
+    }
+
+    // Tests a world-space ray against the menu rooted at rootHandle.
+    menuHandle_t HitTest(
+        OvrGuiSys const& guiSys,
+        menuHandle_t const rootHandle,
+        OVR::Posef const& menuPose,
+        OVR::Vector3f const& rayStart,
+        OVR::Vector3f const& rayDir,
+        ContentFlags_t const testContents,
+        HitTestResult& result);
+
+    int GetNumObjects() const {
+        return static_cast<int>(Leaves.size());
+    }
+
+   private:
+    struct ovrLeaf {
+        menuHandle_t Handle;
+        OVR::Posef ModelPose; // menu-space pose of the object
+        OVR::Vector3f ParentScale; // accumulated scale of the object's parent
+        OVR::Bounds3f Bounds; // conservative menu-space bounds
+        OVR::Vector3f Center; // center of Bounds, used when splitting
+        int Order; // depth-first order in the hierarchy, used to break ties
+    };
+
+    struct ovrNode {
+        OVR::Bounds3f Bounds;
+        int FirstLeaf; // first leaf when Count > 0
+        int Count; // number of leaves, or 0 for an interior node
+        int RightChild; // the left child always immediately follows its parent
+    };
+
+    static int const MAX_LEAVES_PER_NODE = 4;
+    static int const MAX_DEPTH = 64;
+
+    std::vector<ovrLeaf> Leaves;
+    std::vector<ovrNode> Nodes;
+    menuHandle_t BuiltRootHandle;
+    std::uint32_t BuiltChangeCounter;
+    bool IsValid;
+
+    void Build(OvrGuiSys const& guiSys, menuHandle_t const rootHandle);
+    void Collect_r(
+        OvrGuiSys const& guiSys,
+        VRMenuObject const* obj,
+        OVR::Posef const& parentPose,
+        OVR::Vector3f const& parentScale);
+    int BuildNode_r(int const first, int const count, int const depth);
+};
+
+} // namespace OVRFW
@@ -12,11 +12,14 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 #include "VRMenuMgr.h"
 
+#include <algorithm>
+
 #include "Render/DebugLines.h"
 #include "Render/BitmapFont.h"
 #include "Misc/Log.h"
 
 #include "VRMenuObject.h"
+#include "VRMenuSort.h"
 #include "GuiSys.h"
 
 #include "OVR_Lexer2.h"
@@ -275,23 +278,10 @@ static bool HandleComponentsAreValid(int const index, std::uint32_t const id) {
     return true;
 }
 
-//==============================================================
-// SurfSort
-class SurfSort {
-   public:
-    int64_t Key;
-
-    bool operator<(SurfSort const& other) const {
-        return Key - other.Key > 0; // inverted because we want to render furthest-to-closest
-    }
-};
-
 //==============================================================
 // VRMenuMgrLocal
 class VRMenuMgrLocal : public OvrVRMenuMgr {
    public:
-    static int const MAX_SUBMITTED = 256;
-
     VRMenuMgrLocal(OvrGuiSys& guiSys);
     virtual ~VRMenuMgrLocal();
 
@@ -328,6 +318,10 @@ class VRMenuMgrLocal : public OvrVRMenuMgr {
 
     virtual GlProgram const* GetGUIGlProgram(eGUIProgramType const programType) const;
 
+    virtual void SetReuseSurfaceList(bool const reuse) {
+        ReuseSurfaceList = reuse;
+    }
+
     static VRMenuMgrLocal& ToLocal(OvrVRMenuMgr& menuMgr) {
         return *(VRMenuMgrLocal*)&menuMgr;
     }
@@ -345,7 +339,7 @@ class VRMenuMgrLocal : public OvrVRMenuMgr {
     void ExecutePendingComponentDeletions();
 
     void CondenseList();
-    void SubmitForRenderingRecursive(
+    bool SubmitForRenderingRecursive(
         OvrGuiSys& guiSys,
         Matrix4f const& centerViewMatrix,
         VRMenuRenderFlags_t const& flags,
@@ -354,10 +348,13 @@ class VRMenuMgrLocal : public OvrVRMenuMgr {
         Vector4f const& parentColor,
         Vector3f const& parentScale,
         Bounds3f& cullBounds,
-        SubmittedMenuObject* submitted,
-        int const maxIndices,
+        std::vector<SubmittedMenuObject>& submitted,
         int& curIndex,
         int const distanceIndex) const;
+    void SetSubmitted(
+        std::vector<SubmittedMenuObject>& submitted,
+        int const curIndex,
+        SubmittedMenuObject const& sub) const;
 
     //--------------------------------------------------------------
     // private members
@@ -372,13 +369,31 @@ class VRMenuMgrLocal : public OvrVRMenuMgr {
 
     bool Initialized; // true if Init has been called
 
-    SubmittedMenuObject Submitted[MAX_SUBMITTED]; // all objects that have been submitted for
-                                                  // rendering on the current frame
+    std::vector<SubmittedMenuObject> Submitted; // all objects that have been submitted for
+                                                // rendering on the current frame. Only grows, so
+                                                // entries are reused from frame to frame.
     std::vector<SurfSort>
         SortKeys; // sort key consisting of distance from view and submission index
+    std::vector<SurfSort> SortScratch; // ping-pong buffer for the radix sort in Finish()
+    std::vector<VRMenuBatchSource> BatchSources; // one per draw surface added this frame
+    VRMenuBatcher Batcher; // merges compatible neighbors in the sorted draw list
     int NumSubmitted; // number of currently submitted menu objects
     mutable int NumToRender; // number of submitted objects to render
 
+    // The surface list from the last AppendSurfaceList(), reused while the submissions are the
+    // same as on the frame it was built for. Submitted is overwritten in place, so a change is
+    // noticed as each entry is written.
+    bool ReuseSurfaceList;
+    mutable bool SubmissionChanged; // an entry differs from the last frame's
+    std::uint32_t SubmittedChangeCounters; // sum of the submitted roots' subtree change counters
+    std::uint32_t LastSubmittedChangeCounters;
+    Matrix4f SortViewMatrix; // the view matrix SortKeys were computed with
+    std::uint32_t SubmissionSerial; // incremented when the submissions change or objects are freed
+    std::uint32_t CachedSerial; // SubmissionSerial when CachedSurfaces was built
+    std::uint32_t CachedSurfaceChangeCounter; // VRMenuSurface::GetChangeCounter() at that time
+    Matrix4f CachedViewMatrix;
+    std::vector<ovrDrawSurface> CachedSurfaces;
+
     GlProgram GUIProgramDiffuseOnly; // has a diffuse only
     GlProgram GUIProgramDiffuseAlphaDiscard; // diffuse, but discard fragments with 0 alpha
     GlProgram GUIProgramDiffusePlusAdditive; // has a diffuse and an additive
@@ -467,7 +482,18 @@ void VRMenuMgrLocal::DebugWordWrap(void* appPtr, const char* parms) {
 //==================================
 // VRMenuMgrLocal::VRMenuMgrLocal
 VRMenuMgrLocal::VRMenuMgrLocal(OvrGuiSys& guiSys)
-    : GuiSys(guiSys), CurrentId(0), Initialized(false), NumSubmitted(0), NumToRender(0) {}
+    : GuiSys(guiSys),
+      CurrentId(0),
+      Initialized(false),
+      NumSubmitted(0),
+      NumToRender(0),
+      ReuseSurfaceList(true),
+      SubmissionChanged(true),
+      SubmittedChangeCounters(0),
+      LastSubmittedChangeCounters(0),
+      SubmissionSerial(1),
+      CachedSerial(0),
+      CachedSurfaceChangeCounter(0) {}
 
 //==================================
 // VRMenuMgrLocal::~VRMenuMgrLocal
@@ -637,6 +663,10 @@ void VRMenuMgrLocal::Shutdown() {
     GlProgram::Free(GUIProgramDiffuseColorRampTarget);
     GlProgram::Free(GUIProgramAlphaDiffuse);
 
+    Batcher.Shutdown();
+    CachedSurfaces.clear();
+    CachedSerial = 0;
+
     Initialized = false;
 }
 
@@ -671,7 +701,7 @@ menuHandle_t VRMenuMgrLocal::CreateObject(VRMenuObjectParms const& parms) {
     menuHandle_t handle = ComposeHandle(index, id);
     // ALOG( "VRMenuMgrLocal::CreateObject - handle is %llu", handle.Get() );
 
-    VRMenuObject* obj = new VRMenuObject(parms, handle);
+    VRMenuObject* obj = new VRMenuObject(*this, parms, handle);
     if (obj == NULL) {
         ALOGW("VRMenuMgrLocal::CreateObject - failed to allocate menu object!");
         assert(
@@ -722,6 +752,8 @@ void VRMenuMgrLocal::FreeObject(menuHandle_t const handle) {
     obj->FreeChildren(*this);
 
     delete obj;
+    // the last surface list may point at it
+    SubmissionSerial++;
 
     // empty the slot
     ObjectList[index] = NULL;
@@ -809,12 +841,43 @@ static void LogBounds( const char * name, char const * prefix, Bounds3f const &
 }
 */
 
+//==============================
+// SubmissionsMatch
+static bool SubmissionsMatch(SubmittedMenuObject const& a, SubmittedMenuObject const& b) {
+    return a.Handle == b.Handle && a.SurfaceIndex == b.SurfaceIndex &&
+        a.DistanceIndex == b.DistanceIndex && a.Pose.Translation == b.Pose.Translation &&
+        a.Pose.Rotation == b.Pose.Rotation && a.Scale == b.Scale && a.Color == b.Color &&
+        a.ColorTableOffset == b.ColorTableOffset && a.SkipAdditivePass == b.SkipAdditivePass &&
+        a.Flags.GetValue() == b.Flags.GetValue() && a.Offsets == b.Offsets &&
+        a.ClipUVs == b.ClipUVs && a.OffsetUVs == b.OffsetUVs &&
+        a.FadeDirection == b.FadeDirection && a.SurfaceName == b.SurfaceName &&
+        a.LocalBounds.GetMins() == b.LocalBounds.GetMins() &&
+        a.LocalBounds.GetMaxs() == b.LocalBounds.GetMaxs();
+}
+
+//==============================
+// VRMenuMgrLocal::SetSubmitted
+// Writes a submission over the last frame's at the same index, noting whether it differs.
+void VRMenuMgrLocal::SetSubmitted(
+    std::vector<SubmittedMenuObject>& submitted,
+    int const curIndex,
+    SubmittedMenuObject const& sub) const {
+    if (curIndex >= static_cast<int>(submitted.size())) {
+        submitted.resize(curIndex + 1);
+        SubmissionChanged = true;
+    } else if (!SubmissionChanged && !SubmissionsMatch(submitted[curIndex], sub)) {
+        SubmissionChanged = true;
+    }
+    submitted[curIndex] = sub;
+}
+
 /// OVR_PERF_ACCUMULATOR( SubmitForRenderingRecursive_DrawText3D );
 /// OVR_PERF_ACCUMULATOR( SubmitForRenderingRecursive_submit );
 
 //==============================
 // VRMenuMgrLocal::SubmitForRenderingRecursive
-void VRMenuMgrLocal::SubmitForRenderingRecursive(
+// Returns true if the object's cull bounds may differ from the last submission.
+bool VRMenuMgrLocal::SubmitForRenderingRecursive(
     OvrGuiSys& guiSys,
     Matrix4f const& centerViewMatrix,
     VRMenuRenderFlags_t const& flags,
@@ -823,46 +886,56 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive(
     Vector4f const& parentColor,
     Vector3f const& parentScale,
     Bounds3f& cullBounds,
-    SubmittedMenuObject* submitted,
-    int const maxIndices,
+    std::vector<SubmittedMenuObject>& submitted,
     int& curIndex,
     int const distanceIndex) const {
-    if (curIndex >= maxIndices) {
-        // If this happens we're probably not correctly clearing the submitted surfaces each frame
-        // OR we've got a LOT of surfaces.
-        ALOG("maxIndices = %i, curIndex = %i", maxIndices, curIndex);
-        /// assert_WITH_TAG( curIndex < maxIndices, "VrMenu" );
-        return;
-    }
+    assert(obj != NULL);
+
+    VRMenuObject::ovrWorldTransform& wt = obj->WorldTransform;
 
     // check if this object is hidden
     VRMenuObjectFlags_t const oFlags = obj->GetFlags();
     if (oFlags & VRMENUOBJECT_DONT_RENDER) {
-        return;
+        // hidden objects don't contribute to their parent's cull bounds
+        cullBounds.Clear();
+        bool const wasVisible = wt.IsValid;
+        wt.IsValid = false;
+        return wasVisible;
     }
 
-    Posef const& localPose = obj->GetLocalPose();
-    Vector3f const& localScale = obj->GetLocalScale();
-    Vector4f const& localColor = obj->GetColor();
-    Posef curModelPose;
-    Vector4f curColor;
-    Vector3f scale;
-
-    VRMenuObject::TransformByParent(
-        parentModelPose,
-        parentScale,
-        parentColor,
-        localPose,
-        localScale,
-        localColor,
-        oFlags,
-        curModelPose,
-        scale,
-        curColor);
+    // Static subtrees reuse the world transform and bounds computed on a previous frame. The
+    // comparison against the parent's values means a change anywhere up the hierarchy (or the
+    // menu itself moving) propagates down without needing per-object parent links.
+    bool const transformChanged = obj->WorldTransformDirty || !wt.IsValid ||
+        !(wt.ParentPose.Translation == parentModelPose.Translation) ||
+        !(wt.ParentPose.Rotation == parentModelPose.Rotation) ||
+        !(wt.ParentScale == parentScale) || !(wt.ParentColor == parentColor);
+    if (transformChanged) {
+        VRMenuObject::TransformByParent(
+            parentModelPose,
+            parentScale,
+            parentColor,
+            obj->GetLocalPose(),
+            obj->GetLocalScale(),
+            obj->GetColor(),
+            oFlags,
+            wt.ModelPose,
+            wt.Scale,
+            wt.Color);
+        wt.ParentPose = parentModelPose;
+        wt.ParentScale = parentScale;
+        wt.ParentColor = parentColor;
+        wt.LocalBounds = obj->GetLocalBounds(guiSys.GetDefaultFont()) * parentScale;
+        wt.IsValid = true;
+        obj->WorldTransformDirty = false;
+    }
 
-    assert(obj != NULL);
+    Posef curModelPose = wt.ModelPose;
+    Vector4f const curColor = wt.Color;
+    Vector3f const scale = wt.Scale;
 
-    cullBounds = obj->GetLocalBounds(guiSys.GetDefaultFont()) * parentScale;
+    cullBounds = wt.LocalBounds;
+    bool cullBoundsChanged = transformChanged;
 
     int submissionIndex = -1;
     if (obj->GetType() != VRMENU_CONTAINER) // containers never render, but their children may
@@ -928,7 +1001,7 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive(
             for (int i = 0; i < static_cast<int>(surfaces.size()); ++i) {
                 VRMenuSurface const& surf = surfaces[i];
                 if (surf.IsRenderable()) {
-                    SubmittedMenuObject& sub = submitted[curIndex];
+                    SubmittedMenuObject sub;
                     sub.SurfaceIndex = i;
                     sub.DistanceIndex = distanceIndex >= 0 ? distanceIndex : curIndex;
                     sub.Pose = itemPose;
@@ -947,6 +1020,7 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive(
                     sub.SurfaceName = surf.GetName();
 #endif
                     sub.LocalBounds = cullBounds;
+                    SetSubmitted(submitted, curIndex, sub);
                     curIndex++;
                 }
             }
@@ -995,14 +1069,16 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive(
                 // invalid surface so that the text surface will be added to the surface list in
                 // BuildDrawSurface
                 if (curIndex - submissionIndex == 0) {
-                    SubmittedMenuObject& sub = submitted[curIndex];
+                    SubmittedMenuObject sub;
                     sub.SurfaceIndex = -1;
+                    sub.DistanceIndex = distanceIndex >= 0 ? distanceIndex : curIndex;
                     sub.Pose = itemPose;
                     sub.Scale = scale;
                     sub.Flags = rFlags;
                     sub.Handle = obj->GetHandle();
                     sub.Color = parentColor;
                     sub.LocalBounds = cullBounds;
+                    SetSubmitted(submitted, curIndex, sub);
                     curIndex++;
                 }
             } else {
@@ -1071,7 +1147,7 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive(
             }
 
             Bounds3f childCullBounds;
-            SubmitForRenderingRecursive(
+            bool const childChanged = SubmitForRenderingRecursive(
                 guiSys,
                 centerViewMatrix,
                 flags,
@@ -1081,14 +1157,21 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive(
                 scale,
                 childCullBounds,
                 submitted,
-                maxIndices,
                 curIndex,
                 di);
 
-            Posef pose = child->GetLocalPose();
-            pose.Translation = pose.Translation * scale;
-            childCullBounds = Bounds3f::Transform(pose, childCullBounds);
-            cullBounds = Bounds3f::Union(cullBounds, childCullBounds);
+            VRMenuObject::ovrWorldTransform& childWt = child->WorldTransform;
+            if (childChanged) {
+                if (childCullBounds.IsInverted()) {
+                    childWt.ParentCullBounds = childCullBounds;
+                } else {
+                    Posef pose = child->GetLocalPose();
+                    pose.Translation = pose.Translation * scale;
+                    childWt.ParentCullBounds = Bounds3f::Transform(pose, childCullBounds);
+                }
+                cullBoundsChanged = true;
+            }
+            cullBounds = Bounds3f::Union(cullBounds, childWt.ParentCullBounds);
         }
     }
 
@@ -1165,6 +1248,8 @@ void VRMenuMgrLocal::SubmitForRenderingRecursive(
                 obj->GetSurfaces()[0].GetName().c_str());
         }
     }
+
+    return cullBoundsChanged;
 }
 
 //==============================
@@ -1177,15 +1262,13 @@ void VRMenuMgrLocal::SubmitForRendering(
     Posef const& worldPose,
     VRMenuRenderFlags_t const& flags) {
     // ALOG( "VRMenuMgrLocal::SubmitForRendering" );
-    if (NumSubmitted >= MAX_SUBMITTED) {
-        ALOGW("Too many menu objects submitted!");
-        return;
-    }
     VRMenuObject* obj = static_cast<VRMenuObject*>(ToObject(handle));
     if (obj == NULL) {
         return;
     }
 
+    SubmittedChangeCounters += obj->GetSubtreeChangeCounter();
+
     Bounds3f cullBounds;
     SubmitForRenderingRecursive(
         guiSys,
@@ -1197,7 +1280,6 @@ void VRMenuMgrLocal::SubmitForRendering(
         Vector3f(1.0f),
         cullBounds,
         Submitted,
-        MAX_SUBMITTED,
         NumSubmitted,
         -1);
 
@@ -1211,10 +1293,25 @@ void VRMenuMgrLocal::Finish(Matrix4f const& viewMatrix) {
     // free any deleted component objects
     ExecutePendingComponentDeletions();
 
+    // the same entries as last frame, from roots that haven't changed, sort the same way
+    bool const unchanged = ReuseSurfaceList && !SubmissionChanged && NumSubmitted == NumToRender &&
+        SubmittedChangeCounters == LastSubmittedChangeCounters && viewMatrix == SortViewMatrix;
+    if (!unchanged) {
+        SubmissionSerial++;
+    }
+    SubmissionChanged = false;
+    LastSubmittedChangeCounters = SubmittedChangeCounters;
+    SubmittedChangeCounters = 0;
+
     if (NumSubmitted == 0) {
         NumToRender = 0;
         return;
     }
+    if (unchanged) {
+        NumSubmitted = 0;
+        return;
+    }
+    SortViewMatrix = viewMatrix;
 
     Matrix4f invViewMatrix = viewMatrix.Inverted(); // if the view is never scaled or sheared we
                                                     // could use Transposed() here instead
@@ -1238,7 +1335,7 @@ void VRMenuMgrLocal::Finish(Matrix4f const& viewMatrix) {
              i); // invert i because we want items submitted sooner to be considered "further away"
     }
 
-    std::sort(SortKeys.begin(), SortKeys.end());
+    RadixSortKeys(SortKeys, SortScratch);
 
     NumToRender = NumSubmitted;
     NumSubmitted = 0;
@@ -1253,6 +1350,26 @@ void VRMenuMgrLocal::AppendSurfaceList(
         return;
     }
 
+    size_t const firstSurface = surfaceList.size();
+    std::uint32_t const surfaceChangeCounter = VRMenuSurface::GetChangeCounter();
+    if (ReuseSurfaceList && CachedSerial == SubmissionSerial &&
+        CachedSurfaceChangeCounter == surfaceChangeCounter &&
+        CachedViewMatrix == centerViewMatrix) {
+        surfaceList.insert(surfaceList.end(), CachedSurfaces.begin(), CachedSurfaces.end());
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        if (ShowStats) {
+            ALOG(
+                "VRMenuMgr: reused the last %i draws for %i submitted surfaces",
+                static_cast<int>(CachedSurfaces.size()),
+                NumToRender);
+        }
+        return;
+    }
+
+    Vector3f const viewPos = centerViewMatrix.Inverted().GetTranslation();
+
+    BatchSources.resize(0);
+
     for (int i = 0; i < NumToRender; ++i) {
         int idx = abs(static_cast<int>(SortKeys[i].Key & 0xFFFFFFFF) - NumToRender);
         SubmittedMenuObject const& cur = Submitted[idx];
@@ -1266,9 +1383,6 @@ void VRMenuMgrLocal::AppendSurfaceList(
 
             Matrix4f transform(cur.Pose.Rotation);
             if (cur.Flags & VRMENU_RENDER_BILLBOARD) {
-                Matrix4f invViewMatrix = centerViewMatrix.Inverted();
-                Vector3f viewPos = invViewMatrix.GetTranslation();
-
                 Vector3f normal = viewPos - cur.Pose.Translation;
                 Vector3f up(0.0f, 1.0f, 0.0f);
                 float length = normal.Length();
@@ -1293,6 +1407,7 @@ void VRMenuMgrLocal::AppendSurfaceList(
             // ovrSurfaceDef? We still need to sort for now but ideally SurfaceRenderer
             // would sort all surfaces before rendering.
 
+            size_t const surfaceIndex = surfaceList.size();
             obj->BuildDrawSurface(
                 *this,
                 transform,
@@ -1307,13 +1422,31 @@ void VRMenuMgrLocal::AppendSurfaceList(
                 cur.Flags,
                 cur.LocalBounds,
                 surfaceList);
+
+            // the text surface, if any, is never batched
+            BatchSources.resize(surfaceList.size() - firstSurface);
+            if (cur.SurfaceIndex >= 0) {
+                obj->GetSurface(cur.SurfaceIndex)
+                    .GetBatchSource(BatchSources[surfaceIndex - firstSurface]);
+            }
         }
     }
 
+    Batcher.Merge(surfaceList, firstSurface, BatchSources);
+
+    CachedSurfaces.assign(surfaceList.begin() + firstSurface, surfaceList.end());
+    CachedSerial = SubmissionSerial;
+    CachedSurfaceChangeCounter = surfaceChangeCounter;
+    CachedViewMatrix = centerViewMatrix;
+
     glDisable(GL_POLYGON_OFFSET_FILL);
 
     if (ShowStats) {
-        ALOG("VRMenuMgr: submitted %i surfaces", NumToRender);
+        ALOG(
+            "VRMenuMgr: submitted %i surfaces, %i draws after batching (%i batches)",
+            NumToRender,
+            static_cast<int>(surfaceList.size() - firstSurface),
+            Batcher.GetNumBatches());
     }
 }
 
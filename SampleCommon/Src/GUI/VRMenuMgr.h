@@ -64,6 +64,11 @@ class OvrVRMenuMgr {
 
     virtual GlProgram const* GetGUIGlProgram(eGUIProgramType const programType) const = 0;
 
+    // While the same surfaces are submitted in the same places and none of them has changed,
+    // AppendSurfaceList() appends the list it built on the last frame instead of building it
+    // again. On by default; turning it off is only useful to measure what it saves.
+    virtual void SetReuseSurfaceList(bool const reuse) = 0;
+
    private:
     // Called only from VRMenuObject.
     virtual void AddComponentToDeletionList(
@@ -91,7 +91,8 @@ const float VRMenuSurface::Z_BOUNDS = 0.05f;
 
 //==============================
 // VRMenuSurfaceTexture::VRMenuSurfaceTexture::
-VRMenuSurfaceTexture::VRMenuSurfaceTexture() : Type(SURFACE_TEXTURE_MAX), OwnsTexture(false) {}
+VRMenuSurfaceTexture::VRMenuSurfaceTexture()
+    : Type(SURFACE_TEXTURE_MAX), OwnsTexture(false), TextureManager(nullptr) {}
 
 //==============================
 // VRMenuSurfaceTexture::LoadTexture
@@ -108,9 +109,9 @@ bool VRMenuSurfaceTexture::LoadTexture(
 
     if (imageName != NULL && imageName[0] != '\0') {
 #if defined(USE_TEXTURE_MANAGER)
-        textureHandle_t const h =
-            guiSys.GetTextureManager().LoadTexture(guiSys.GetFileSys(), imageName);
-        Texture = guiSys.GetTextureManager().GetGlTexture(h);
+        TextureManager = &guiSys.GetTextureManager();
+        TextureHandle = TextureManager->LoadTexture(guiSys.GetFileSys(), imageName);
+        Texture = TextureManager->GetGlTexture(TextureHandle);
 #else
         std::vector<uint8_t> buffer;
         if (guiSys.GetFileSys().ReadFile(imageName, buffer)) {
@@ -128,9 +129,10 @@ bool VRMenuSurfaceTexture::LoadTexture(
 
     if (!Texture.IsValid() && allowDefault) {
 #if defined(USE_TEXTURE_MANAGER)
-        textureHandle_t const h =
-            guiSys.GetTextureManager().LoadTexture("<default>", uiDefaultTgaData, uiDefaultTgaSize);
-        Texture = guiSys.GetTextureManager().GetGlTexture(h);
+        TextureManager = &guiSys.GetTextureManager();
+        TextureHandle =
+            TextureManager->LoadTexture("<default>", uiDefaultTgaData, uiDefaultTgaSize);
+        Texture = TextureManager->GetGlTexture(TextureHandle);
 #else
         int w;
         int h;
@@ -173,6 +175,12 @@ void VRMenuSurfaceTexture::Free() {
         if (OwnsTexture) {
             DeleteTexture(Texture);
         }
+        // a released texture may be evicted, so it must not be drawn any more
+        if (TextureHandle.IsValid()) {
+            TextureManager->ReleaseTexture(TextureHandle);
+            TextureHandle = textureHandle_t();
+            Texture = GlTexture();
+        }
         Type = SURFACE_TEXTURE_MAX;
         OwnsTexture = false;
     }
@@ -194,10 +202,14 @@ static void PrintBounds( const char * name, char const * prefix, Bounds3f const
 }
 #endif
 
+// incremented by every VRMenuSurface::Unbind(), and never 0 once a surface has geometry
+static std::uint32_t SurfaceChangeCounter = 0;
+
 //==============================
 // VRMenuSurface::VRMenuSurface
 VRMenuSurface::VRMenuSurface()
-    : Color(1.0f)
+    : GeometryVersion(0),
+      Color(1.0f)
       //, TextureDims( 0, 0 )
       //, Dims( 0.0f, 0.0f )
       //, Anchors( 0.0f, 0.0f, 1.0f
@@ -211,7 +223,11 @@ VRMenuSurface::VRMenuSurface()
       ,
       Contents(CONTENT_SOLID),
       Visible(true),
-      ProgramType(PROGRAM_MAX) {}
+      ProgramType(PROGRAM_MAX),
+      BoundSurface(nullptr),
+      BoundProgram(nullptr),
+      BoundProgramId(0),
+      BoundProgramType(PROGRAM_MAX) {}
 
 //==============================
 // VRMenuSurface::~VRMenuSurface
@@ -219,6 +235,21 @@ VRMenuSurface::~VRMenuSurface() {
     Free();
 }
 
+//==============================
+// VRMenuSurface::GetChangeCounter
+std::uint32_t VRMenuSurface::GetChangeCounter() {
+    return SurfaceChangeCounter;
+}
+
+//==============================
+// VRMenuSurface::Unbind
+void VRMenuSurface::Unbind() {
+    BoundSurface = nullptr;
+    if (++SurfaceChangeCounter == 0) {
+        ++SurfaceChangeCounter;
+    }
+}
+
 //==============================
 // VRMenuSurface::CreateImageGeometry
 //
@@ -340,6 +371,34 @@ void VRMenuSurface::CreateImageGeometry(
     } else {
         SurfaceDef.geo.Update(attribs);
     }
+
+    GeoAttribs = std::move(attribs);
+    GeoIndices = std::move(indices);
+    // the batcher keeps transformed copies keyed on this, so every new geometry gets a new value
+    Unbind();
+    GeometryVersion = SurfaceChangeCounter;
+}
+
+//==============================
+// VRMenuSurface::GetBatchSource
+bool VRMenuSurface::GetBatchSource(VRMenuBatchSource& outSource) const {
+    outSource = VRMenuBatchSource();
+    // the fade is computed from model-space positions, which batching replaces
+    if (FadeDirection.x != 0.0f || FadeDirection.y != 0.0f || FadeDirection.z != 0.0f) {
+        return false;
+    }
+    if (GeoAttribs.position.empty() || BoundSurface != this) {
+        return false;
+    }
+    outSource.SurfaceDef = &SurfaceDef;
+    outSource.Attribs = &GeoAttribs;
+    outSource.Indices = &GeoIndices;
+    outSource.GeometryVersion = GeometryVersion;
+    outSource.Color = Color;
+    outSource.ClipUVs = ClipUVs;
+    outSource.OffsetUVs = OffsetUVs;
+    outSource.ColorTableOffset = ColorTableOffset;
+    return true;
 }
 
 //==============================
@@ -394,8 +453,8 @@ void VRMenuObject::BuildDrawSurface(
 
 //==============================
 // VRMenuSurface::BuildDrawSurface
-// TODO: Ideally the materialDef only needs to be set up once unless it's been changed, but
-// some menu items can have their surfaces changed on the fly (such as background-loaded thumbnails)
+// The graphics command is only rebound when the surface's textures or program change (for
+// instance background-loaded thumbnails); otherwise only the per-frame uniform values are updated.
 void VRMenuSurface::BuildDrawSurface(
     OvrVRMenuMgr const& menuMgr,
     Matrix4f const& modelMatrix,
@@ -433,8 +492,6 @@ void VRMenuSurface::BuildDrawSurface(
         return;
     }
 
-    gc.Program = *program;
-
     /// Update local parameters
     Color = color;
     FadeDirection = fadeDirection;
@@ -442,6 +499,21 @@ void VRMenuSurface::BuildDrawSurface(
     OffsetUVs = offsetUVs;
     ColorTableOffset = colorTableOffset;
 
+    // The uniform bindings point at this surface's members, so they only need to be rebuilt if
+    // the textures, program or render flags changed, or if the surface was copied (e.g. when the
+    // owning object's surface array grows).
+    if (BoundSurface == this && BoundProgram == program && BoundProgramId == program->Program &&
+        BoundProgramType == pt && BoundFlags.GetValue() == flags.GetValue()) {
+        return;
+    }
+    BoundSurface = this;
+    BoundProgram = program;
+    BoundProgramId = program->Program;
+    BoundProgramType = pt;
+    BoundFlags = flags;
+
+    gc.Program = *program;
+
     /// uniform binding - match the uniforms to what they were setup in VRMenuMgrLocal::Init
     int additiveIndex = IndexForTextureType(SURFACE_TEXTURE_ADDITIVE, 1);
     int diffuseIndex = IndexForTextureType(SURFACE_TEXTURE_DIFFUSE, 1);
@@ -827,6 +899,7 @@ void VRMenuSurface::CreateFromSurfaceParms(OvrGuiSys& guiSys, VRMenuSurfaceParms
     }
 
     SetTextureSampling(ProgramType);
+    Unbind();
 
     /// OVR_PERF_ACCUMULATE( CreateFromSurfaceParms );
 }
@@ -869,6 +942,7 @@ void VRMenuSurface::Free() {
     for (int i = 0; i < VRMENUSURFACE_IMAGE_MAX; ++i) {
         Textures[i].Free();
     }
+    Unbind();
 }
 
 //==============================
@@ -907,6 +981,7 @@ void VRMenuSurface::LoadTexture(
         return;
     }
     Textures[textureIndex].LoadTexture(guiSys, type, imageName, true);
+    Unbind();
 }
 
 //==============================
@@ -923,6 +998,7 @@ void VRMenuSurface::LoadTexture(
         return;
     }
     Textures[textureIndex].LoadTexture(type, texId, width, height);
+    Unbind();
 }
 
 //==============================
@@ -943,7 +1019,10 @@ void VRMenuSurface::SetOwnership(int const index, bool const isOwner) {
 
 //==================================
 // VRMenuObject::VRMenuObject
-VRMenuObject::VRMenuObject(VRMenuObjectParms const& parms, menuHandle_t const handle)
+VRMenuObject::VRMenuObject(
+    OvrVRMenuMgr const& menuMgr,
+    VRMenuObjectParms const& parms,
+    menuHandle_t const handle)
     : Type(parms.Type),
       Handle(handle),
       Id(parms.Id),
@@ -970,8 +1049,14 @@ VRMenuObject::VRMenuObject(VRMenuObjectParms const& parms, menuHandle_t const ha
       MinsBoundsExpand(0.0f),
       MaxsBoundsExpand(0.0f),
       TextMetrics(),
-      TextSurface(nullptr) {
+      CachedLocalBoundsFont(nullptr),
+      LocalBoundsDirty(true),
+      WorldTransformDirty(true),
+      TextSurface(nullptr),
+      MenuMgr(&menuMgr),
+      SubtreeChangeCounter(0) {
     CullBounds.Clear();
+    CachedLocalBounds.Clear();
 }
 
 //==================================
@@ -1042,6 +1127,7 @@ void VRMenuObject::FreeChildren(OvrVRMenuMgr& menuMgr) {
         menuMgr.FreeObject(Children[i]);
     }
     Children.resize(0);
+    MarkChanged();
     // NOTE! bounds will be incorrect now until submitted for rendering
 }
 
@@ -1067,6 +1153,17 @@ bool VRMenuObject::IsDescendant(OvrVRMenuMgr& menuMgr, menuHandle_t const handle
     return false;
 }
 
+//==============================
+// VRMenuObject::MarkChanged
+void VRMenuObject::MarkChanged() {
+    LocalBoundsDirty = true;
+    WorldTransformDirty = true;
+    // the change is counted up to the menu's root, whose hit BVH then knows to rebuild
+    for (VRMenuObject* obj = this; obj != nullptr; obj = MenuMgr->ToObject(obj->ParentHandle)) {
+        obj->SubtreeChangeCounter++;
+    }
+}
+
 //==============================
 // VRMenuObject::AddChild
 void VRMenuObject::AddChild(OvrVRMenuMgr& menuMgr, menuHandle_t const handle) {
@@ -1076,6 +1173,7 @@ void VRMenuObject::AddChild(OvrVRMenuMgr& menuMgr, menuHandle_t const handle) {
     if (child != NULL) {
         child->SetParentHandle(this->Handle);
     }
+    MarkChanged();
     // NOTE: bounds will be incorrect until submitted for rendering
 }
 
@@ -1085,6 +1183,12 @@ void VRMenuObject::RemoveChild(OvrVRMenuMgr& menuMgr, menuHandle_t const handle)
     for (int i = 0; i < static_cast<int>(Children.size()); ++i) {
         if (Children[i] == handle) {
             Children.erase(Children.cbegin() + i);
+            // a detached child no longer counts its changes against this tree
+            VRMenuObject* child = menuMgr.ToObject(handle);
+            if (child != NULL) {
+                child->SetParentHandle(menuHandle_t());
+            }
+            MarkChanged();
             return;
         }
     }
@@ -1097,6 +1201,7 @@ void VRMenuObject::FreeChild(OvrVRMenuMgr& menuMgr, menuHandle_t const handle) {
         menuHandle_t childHandle = Children[i];
         if (childHandle == handle) {
             Children.erase(Children.cbegin() + i);
+            MarkChanged();
             menuMgr.FreeObject(childHandle);
             return;
         }
@@ -1198,7 +1303,9 @@ bool VRMenuObject::IntersectRay(
     return result.TriIndex >= 0;
 }
 
-static void TransformByParentPose(
+//==============================
+// VRMenuObject::TransformByParentPose
+void VRMenuObject::TransformByParentPose(
     Posef const& parentPose,
     Vector3f const& parentScale,
     Posef const& localPose,
@@ -1212,64 +1319,14 @@ static void TransformByParentPose(
 }
 
 //==============================
-// VRMenuObject::HitTest_r
-bool VRMenuObject::HitTest_r(
+// VRMenuObject::HitTestSelf
+bool VRMenuObject::HitTestSelf(
     OvrGuiSys const& guiSys,
-    Posef const& parentPose,
     Vector3f const& parentScale,
-    Vector3f const& rayStart,
-    Vector3f const& rayDir,
+    Vector3f const& localStart,
+    Vector3f const& localDir,
     ContentFlags_t const testContents,
     HitTestResult& result) const {
-    if (Flags & VRMENUOBJECT_DONT_RENDER) {
-        return false;
-    }
-
-    if (Flags & VRMENUOBJECT_DONT_HIT_ALL) {
-        return false;
-    }
-
-    // transform ray into local space
-    Vector3f scale;
-    Posef modelPose;
-    TransformByParentPose(parentPose, parentScale, LocalPose, GetLocalScale(), modelPose, scale);
-
-    Vector3f localStart = modelPose.Rotation.Inverted().Rotate(rayStart - modelPose.Translation);
-    Vector3f localDir = modelPose.Rotation.Inverted().Rotate(rayDir).Normalized();
-    /*
-        LOG_WITH_TAG( "Spam", "Hit test vs '%s', start: (%.2f, %.2f, %.2f ) cull bounds( %.2f, %.2f,
-       %.2f ) -> ( %.2f, %.2f, %.2f )", GetText().c_str(), localStart.x, localStart.y, localStart.z,
-                CullBounds.b[0].x, CullBounds.b[0].y, CullBounds.b[0].z,
-                CullBounds.b[1].x, CullBounds.b[1].y, CullBounds.b[1].z );
-    */
-    // test against cull bounds if we have children  ... otherwise cullBounds == localBounds
-    if (Children.size() > 0) {
-        if (CullBounds.IsInverted()) {
-            ALOG("CullBounds are inverted!!");
-            return false;
-        }
-        float cullT0;
-        float cullT1;
-        // any contents will hit cull bounds
-        ContentFlags_t allContents(OVR::ALL_BITS);
-        bool hitCullBounds = IntersectRayBounds(
-            localStart,
-            localDir,
-            CullBounds.GetMins(),
-            CullBounds.GetMaxs(),
-            allContents,
-            cullT0,
-            cullT1);
-
-        //        LOG_WITH_TAG( "Spam", "Cull hit = %s, t0 = %.2f t1 = %.2f", hitCullBounds ? "true"
-        //        : "false", cullT0, cullT1 );
-
-        if (!hitCullBounds) {
-            return false;
-        }
-    }
-
-    // test against self first, if not a container
     if (GetContents() & testContents) {
         if (Flags & VRMENUOBJECT_BOUND_ALL) {
             // local bounds are the union of surface bounds and text bounds
@@ -1333,6 +1390,69 @@ bool VRMenuObject::HitTest_r(
             }
         }
     }
+    return result.HitHandle.IsValid();
+}
+
+//==============================
+// VRMenuObject::HitTest_r
+bool VRMenuObject::HitTest_r(
+    OvrGuiSys const& guiSys,
+    Posef const& parentPose,
+    Vector3f const& parentScale,
+    Vector3f const& rayStart,
+    Vector3f const& rayDir,
+    ContentFlags_t const testContents,
+    HitTestResult& result) const {
+    if (Flags & VRMENUOBJECT_DONT_RENDER) {
+        return false;
+    }
+
+    if (Flags & VRMENUOBJECT_DONT_HIT_ALL) {
+        return false;
+    }
+
+    // transform ray into local space
+    Vector3f scale;
+    Posef modelPose;
+    TransformByParentPose(parentPose, parentScale, LocalPose, GetLocalScale(), modelPose, scale);
+
+    Vector3f localStart = modelPose.Rotation.Inverted().Rotate(rayStart - modelPose.Translation);
+    Vector3f localDir = modelPose.Rotation.Inverted().Rotate(rayDir).Normalized();
+    /*
+        LOG_WITH_TAG( "Spam", "Hit test vs '%s', start: (%.2f, %.2f, %.2f ) cull bounds( %.2f, %.2f,
+       %.2f ) -> ( %.2f, %.2f, %.2f )", GetText().c_str(), localStart.x, localStart.y, localStart.z,
+                CullBounds.b[0].x, CullBounds.b[0].y, CullBounds.b[0].z,
+                CullBounds.b[1].x, CullBounds.b[1].y, CullBounds.b[1].z );
+    */
+    // test against cull bounds if we have children  ... otherwise cullBounds == localBounds
+    if (Children.size() > 0) {
+        if (CullBounds.IsInverted()) {
+            ALOG("CullBounds are inverted!!");
+            return false;
+        }
+        float cullT0;
+        float cullT1;
+        // any contents will hit cull bounds
+        ContentFlags_t allContents(OVR::ALL_BITS);
+        bool hitCullBounds = IntersectRayBounds(
+            localStart,
+            localDir,
+            CullBounds.GetMins(),
+            CullBounds.GetMaxs(),
+            allContents,
+            cullT0,
+            cullT1);
+
+        //        LOG_WITH_TAG( "Spam", "Cull hit = %s, t0 = %.2f t1 = %.2f", hitCullBounds ? "true"
+        //        : "false", cullT0, cullT1 );
+
+        if (!hitCullBounds) {
+            return false;
+        }
+    }
+
+    // test against self first, if not a container
+    HitTestSelf(guiSys, parentScale, localStart, localDir, testContents, result);
 
     // test against children
     for (int i = 0; i < static_cast<int>(Children.size()); ++i) {
@@ -1367,6 +1487,17 @@ menuHandle_t VRMenuObject::HitTest(
 //==============================
 // VRMenuObject::GetLocalBounds
 Bounds3f VRMenuObject::GetLocalBounds(BitmapFont const& font) const {
+    if (LocalBoundsDirty || CachedLocalBoundsFont != &font) {
+        CachedLocalBounds = CalcLocalBounds(font);
+        CachedLocalBoundsFont = &font;
+        LocalBoundsDirty = false;
+    }
+    return CachedLocalBounds;
+}
+
+//==============================
+// VRMenuObject::CalcLocalBounds
+Bounds3f VRMenuObject::CalcLocalBounds(BitmapFont const& font) const {
     Bounds3f bounds;
     bounds.Clear();
     Vector3f const localScale = GetLocalScale();
@@ -1750,6 +1881,7 @@ Vector4f const& VRMenuObject::GetColor() const {
 // VRMenuObject::SetColor
 void VRMenuObject::SetColor(Vector4f const& c) {
     Color = c;
+    WorldTransformDirty = true;
 }
 
 void VRMenuObject::SetVisible(bool visible) {
@@ -1758,6 +1890,7 @@ void VRMenuObject::SetVisible(bool visible) {
     } else {
         Flags |= VRMenuObjectFlags_t(VRMENUOBJECT_DONT_RENDER);
     }
+    MarkChanged();
 }
 
 //==============================
@@ -1969,6 +2102,7 @@ void VRMenuObject::RegenerateSurfaceGeometry(
     }
 
     Surfaces[surfaceIndex].RegenerateSurfaceGeometry();
+    MarkChanged();
 }
 
 //==============================
@@ -1993,6 +2127,7 @@ void VRMenuObject::SetSurfaceDims(int const surfaceIndex, Vector2f const& dims)
     }
 
     Surfaces[surfaceIndex].SetDims(dims);
+    MarkChanged();
 }
 
 //==============================
@@ -2017,6 +2152,7 @@ void VRMenuObject::SetSurfaceBorder(int const surfaceIndex, Vector4f const& bord
     }
 
     Surfaces[surfaceIndex].SetBorder(border);
+    MarkChanged();
 }
 
 //==============================
@@ -2024,6 +2160,7 @@ void VRMenuObject::SetSurfaceBorder(int const surfaceIndex, Vector4f const& bord
 void VRMenuObject::SetLocalBoundsExpand(Vector3f const mins, Vector3f const& maxs) {
     MinsBoundsExpand = mins;
     MaxsBoundsExpand = maxs;
+    MarkChanged();
 }
 
 //==============================
@@ -2033,6 +2170,7 @@ void VRMenuObject::SetCollisionPrimitive(OvrCollisionPrimitive* c) {
         delete CollisionPrimitive;
     }
     CollisionPrimitive = c;
+    MarkChanged();
 }
 
 //==============================
@@ -2094,6 +2232,7 @@ Vector4f const& VRMenuObject::GetSurfaceColor(int const surfaceIndex) const {
 void VRMenuObject::SetSurfaceVisible(int const surfaceIndex, bool const v) {
     VRMenuSurface& surf = Surfaces[surfaceIndex];
     surf.SetVisible(v);
+    MarkChanged();
 }
 
 //==============================
@@ -2114,6 +2253,7 @@ int VRMenuObject::NumSurfaces() const {
 int VRMenuObject::AllocSurface() {
     int newIndex = static_cast<int>(Surfaces.size());
     Surfaces.emplace_back(VRMenuSurface());
+    MarkChanged();
     return newIndex;
 }
 
@@ -2125,6 +2265,7 @@ void VRMenuObject::CreateFromSurfaceParms(
     VRMenuSurfaceParms const& parms) {
     VRMenuSurface& surf = Surfaces[surfaceIndex];
     surf.CreateFromSurfaceParms(guiSys, parms);
+    MarkChanged();
 }
 
 //==============================
@@ -2132,6 +2273,7 @@ void VRMenuObject::CreateFromSurfaceParms(
 void VRMenuObject::SetText(char const* text) {
     Text = text;
     TextDirty = true;
+    MarkChanged();
 }
 
 //==============================
@@ -2143,6 +2285,7 @@ void VRMenuObject::SetTextWordWrapped(
     FontParms.WrapWidth = widthInMeters;
     SetText(text);
     font.WordWrapText(Text, widthInMeters, FontParms.Scale);
+    MarkChanged();
 }
 
 //==============================
@@ -20,9 +20,11 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 
 #include "Render/Egl.h" // GLuint
 #include "Render/BitmapFont.h" // HorizontalJustification & VerticalJustification
+#include "Render/TextureManager.h" // textureHandle_t
 #include "Misc/Log.h"
 
 #include "CollisionPrimitive.h"
+#include "VRMenuBatcher.h"
 
 #include "OVR_Lexer2.h" // ovrLexer
 
@@ -691,6 +693,10 @@ class VRMenuSurfaceTexture {
     GlTexture Texture;
     eSurfaceTextureType Type; // specifies how this image is used for rendering
     bool OwnsTexture; // if true, free texture on a reload or deconstruct
+    // the texture manager's reference to the texture, if it was loaded from an image, released
+    // on a reload or deconstruct so the manager's budget can evict it
+    ovrTextureManager* TextureManager;
+    textureHandle_t TextureHandle;
 };
 
 //==============================================================
@@ -855,10 +861,21 @@ class VRMenuSurface {
         return Tris;
     }
 
+    // Describes the surface as it was last built by BuildDrawSurface() for VRMenuBatcher.
+    // Returns false (and leaves outSource unmergeable) if the surface can't be batched.
+    bool GetBatchSource(VRMenuBatchSource& outSource) const;
+
+    // Returns a counter that is incremented whenever any surface's geometry, textures or program
+    // change. The menu manager reuses its last surface list only while this is unchanged.
+    static std::uint32_t GetChangeCounter();
+
    private:
     VRMenuSurfaceTexture Textures[VRMENUSURFACE_IMAGE_MAX];
     // GlGeometry						Geo;				// VBO for this surface
     OvrTriCollisionPrimitive Tris; // per-poly collision object
+    VertexAttribs GeoAttribs; // CPU copy of the geometry, used for batching
+    std::vector<TriangleIndex> GeoIndices;
+    uint32_t GeometryVersion; // unique to each CreateImageGeometry() call, 0 before the first
     OVR::Vector4f Color; // Color, modulated with object color
     OVR::Vector2i TextureDims; // texture width and height
     OVR::Vector2f Dims; // width and height
@@ -877,7 +894,16 @@ class VRMenuSurface {
 
     mutable ovrSurfaceDef SurfaceDef;
 
+    // state SurfaceDef's graphics command was last bound with in BuildDrawSurface()
+    VRMenuSurface const* BoundSurface; // nullptr forces a rebind
+    GlProgram const* BoundProgram;
+    GLuint BoundProgramId;
+    eGUIProgramType BoundProgramType;
+    VRMenuRenderFlags_t BoundFlags;
+
    private:
+    // Makes the next BuildDrawSurface() bind the graphics command again, and counts the change.
+    void Unbind();
     void CreateImageGeometry(
         int const textureWidth,
         int const textureHeight,
@@ -933,6 +959,7 @@ class VRMenuObject {
    public:
     friend class VRMenuMgr;
     friend class VRMenuMgrLocal;
+    friend class VRMenuHitBvh;
 
     class ovrRecursionFunctor {
        public:
@@ -985,6 +1012,14 @@ class VRMenuObject {
         ContentFlags_t const testContents,
         HitTestResult& result) const;
 
+    // Returns a counter that is incremented whenever this object or any of its descendants
+    // changes in a way that can affect hit testing (pose, scale, flags, contents, surfaces, text
+    // or hierarchy). A menu's hit BVH compares its root's counter against the one it was built
+    // with, so changes to other menus don't rebuild it.
+    std::uint32_t GetSubtreeChangeCounter() const {
+        return SubtreeChangeCounter;
+    }
+
     //--------------------------------------------------------------
     // components
     //--------------------------------------------------------------
@@ -1039,12 +1074,15 @@ class VRMenuObject {
     }
     void SetFlags(VRMenuObjectFlags_t const& flags) {
         Flags = flags;
+        MarkChanged();
     }
     void AddFlags(VRMenuObjectFlags_t const& flags) {
         Flags |= flags;
+        MarkChanged();
     }
     void RemoveFlags(VRMenuObjectFlags_t const& flags) {
         Flags &= ~flags;
+        MarkChanged();
     }
 
     void ModifyFlags(bool const add, VRMenuObjectFlags_t const& flags) {
@@ -1088,22 +1126,26 @@ class VRMenuObject {
     }
     void SetLocalPose(OVR::Posef const& pose) {
         LocalPose = pose;
+        MarkChanged();
     }
     OVR::Vector3f const& GetLocalPosition() const {
         return LocalPose.Translation;
     }
     void SetLocalPosition(OVR::Vector3f const& pos) {
         LocalPose.Translation = pos;
+        MarkChanged();
     }
     OVR::Quatf const& GetLocalRotation() const {
         return LocalPose.Rotation;
     }
     void SetLocalRotation(OVR::Quatf const& rot) {
         LocalPose.Rotation = rot;
+        MarkChanged();
     }
     OVR::Vector3f GetLocalScale() const;
     void SetLocalScale(OVR::Vector3f const& scale) {
         LocalScale = scale;
+        MarkChanged();
     }
 
     OVR::Posef const& GetHilightPose() const {
@@ -1111,28 +1153,33 @@ class VRMenuObject {
     }
     void SetHilightPose(OVR::Posef const& pose) {
         HilightPose = pose;
+        MarkChanged();
     }
     float GetHilightScale() const {
         return HilightScale;
     }
     void SetHilightScale(float const s) {
         HilightScale = s;
+        MarkChanged();
     }
 
     void SetTextLocalPose(OVR::Posef const& pose) {
         TextLocalPose = pose;
+        MarkChanged();
     }
     OVR::Posef const& GetTextLocalPose() const {
         return TextLocalPose;
     }
     void SetTextLocalPosition(OVR::Vector3f const& pos) {
         TextLocalPose.Translation = pos;
+        MarkChanged();
     }
     OVR::Vector3f const& GetTextLocalPosition() const {
         return TextLocalPose.Translation;
     }
     void SetTextLocalRotation(OVR::Quatf const& rot) {
         TextLocalPose.Rotation = rot;
+        MarkChanged();
     }
     OVR::Quatf const& GetTextLocalRotation() const {
         return TextLocalPose.Rotation;
@@ -1143,6 +1190,7 @@ class VRMenuObject {
     }
     void SetTextLocalScale(OVR::Vector3f const& scale) {
         TextLocalScale = scale;
+        MarkChanged();
     }
 
     void SetLocalBoundsExpand(OVR::Vector3f const mins, OVR::Vector3f const& maxs);
@@ -1187,6 +1235,7 @@ class VRMenuObject {
 
     void SetFontParms(VRMenuFontParms const& fontParms) {
         FontParms = fontParms;
+        MarkChanged();
     }
     VRMenuFontParms const& GetFontParms() const {
         return FontParms;
@@ -1277,17 +1326,17 @@ class VRMenuObject {
     }
     void SetContents(ContentFlags_t const c) {
         Contents = c;
+        MarkChanged();
     }
 
     //--------------------------------------------------------------
     // surfaces (non-virtual)
     //--------------------------------------------------------------
+    // Surfaces are only read from outside; changes go through the SetSurface* methods, which
+    // invalidate the cached bounds, world transform and hit BVH.
     VRMenuSurface const& GetSurface(int const s) const {
         return Surfaces[s];
     }
-    VRMenuSurface& GetSurface(int const s) {
-        return Surfaces[s];
-    }
     std::vector<VRMenuSurface> const& GetSurfaces() const {
         return Surfaces;
     }
@@ -1384,6 +1433,31 @@ class VRMenuObject {
     mutable OVR::Bounds3f
         CullBounds; // bounds of this object and all its children in the local space of its parent
     mutable textMetrics_t TextMetrics; // cached metrics for the text
+    mutable OVR::Bounds3f CachedLocalBounds; // result of GetLocalBounds() while !LocalBoundsDirty
+    mutable BitmapFont const* CachedLocalBoundsFont; // font CachedLocalBounds was computed with
+    mutable bool LocalBoundsDirty; // if true, recalculate local bounds
+
+    // World transform and bounds from the last VRMenuMgrLocal::SubmitForRenderingRecursive(),
+    // reused while the parent's inputs are unchanged and WorldTransformDirty is false.
+    struct ovrWorldTransform {
+        ovrWorldTransform()
+            : LocalBounds(OVR::Bounds3f::Init),
+              ParentCullBounds(OVR::Bounds3f::Init),
+              IsValid(false) {}
+
+        OVR::Posef ParentPose;
+        OVR::Vector3f ParentScale;
+        OVR::Vector4f ParentColor;
+        OVR::Posef ModelPose;
+        OVR::Vector3f Scale;
+        OVR::Vector4f Color;
+        OVR::Bounds3f LocalBounds; // GetLocalBounds() scaled by ParentScale
+        OVR::Bounds3f ParentCullBounds; // CullBounds transformed into the parent's space
+        bool IsValid;
+    };
+
+    mutable ovrWorldTransform WorldTransform;
+    mutable bool WorldTransformDirty; // set when local pose, scale, color or flags change
 
     struct ovrTextSurface {
         ovrSurfaceDef SurfaceDef;
@@ -1392,9 +1466,15 @@ class VRMenuObject {
 
     mutable ovrTextSurface* TextSurface;
 
+    OvrVRMenuMgr const* MenuMgr; // resolves the parent handle when a change is propagated
+    std::uint32_t SubtreeChangeCounter; // see GetSubtreeChangeCounter()
+
    private:
     // only VRMenuMgrLocal static methods can construct and destruct a menu object.
-    VRMenuObject(VRMenuObjectParms const& parms, menuHandle_t const handle);
+    VRMenuObject(
+        OvrVRMenuMgr const& menuMgr,
+        VRMenuObjectParms const& parms,
+        menuHandle_t const handle);
     ~VRMenuObject();
 
     bool IntersectRayBounds(
@@ -1418,6 +1498,29 @@ class VRMenuObject {
         ContentFlags_t const testContents,
         HitTestResult& result) const;
 
+    // Tests the ray against this object only, ignoring children. The ray must already be in the
+    // object's local space and the direction must be normalized.
+    bool HitTestSelf(
+        OvrGuiSys const& guiSys,
+        OVR::Vector3f const& parentScale,
+        OVR::Vector3f const& localStart,
+        OVR::Vector3f const& localDir,
+        ContentFlags_t const testContents,
+        HitTestResult& result) const;
+
+    // Combines a local pose and scale with the parent's, as done during hit testing.
+    static void TransformByParentPose(
+        OVR::Posef const& parentPose,
+        OVR::Vector3f const& parentScale,
+        OVR::Posef const& localPose,
+        OVR::Vector3f const& localScale,
+        OVR::Posef& outPose,
+        OVR::Vector3f& outScale);
+
+    void MarkChanged();
+
+    OVR::Bounds3f CalcLocalBounds(BitmapFont const& font) const;
+
     int GetComponentIndex(VRMenuComponent* component) const;
 
     void FreeTextSurface() const;
@@ -0,0 +1,76 @@
+/************************************************************************************
+
+Filename    :   VRMenuSort.h
+Content     :   Sort keys and the radix sort used to order submitted menu surfaces.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+
+*************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace OVRFW {
+
+//==============================================================
+// SurfSort
+class SurfSort {
+   public:
+    int64_t Key;
+
+    bool operator<(SurfSort const& other) const {
+        return Key - other.Key > 0; // inverted because we want to render furthest-to-closest
+    }
+};
+
+//==============================
+// RadixSortKeys
+// Sorts keys in the same order as std::sort with SurfSort::operator<, i.e. descending Key, using
+// an LSD radix sort over 8-bit digits. Keys are always non-negative (positive float bits in the
+// high word, submission index in the low word). Digits that are the same for every key, such as
+// the unused high bytes of the submission index, are skipped.
+inline void RadixSortKeys(std::vector<SurfSort>& keys, std::vector<SurfSort>& scratch) {
+    int const count = static_cast<int>(keys.size());
+    if (count < 2) {
+        return;
+    }
+    scratch.resize(count);
+
+    SurfSort* src = keys.data();
+    SurfSort* dst = scratch.data();
+    for (int shift = 0; shift < 64; shift += 8) {
+        int histogram[256] = {};
+        for (int i = 0; i < count; ++i) {
+            histogram[(static_cast<uint64_t>(src[i].Key) >> shift) & 0xFF]++;
+        }
+        int const firstDigit = (static_cast<uint64_t>(src[0].Key) >> shift) & 0xFF;
+        if (histogram[firstDigit] == count) {
+            continue;
+        }
+
+        // descending, so the highest digit goes first
+        int offset = 0;
+        for (int d = 255; d >= 0; --d) {
+            int const n = histogram[d];
+            histogram[d] = offset;
+            offset += n;
+        }
+        for (int i = 0; i < count; ++i) {
+            int const digit = (static_cast<uint64_t>(src[i].Key) >> shift) & 0xFF;
+            dst[histogram[digit]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != keys.data()) {
+        std::copy(src, src + count, keys.data());
+    }
+}
+
+} // namespace OVRFW
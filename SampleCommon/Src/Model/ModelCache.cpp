@@ -0,0 +1,436 @@
+/************************************************************************************
+
+Filename    :   ModelCache.cpp
+Content     :   Cooked models, mapped from disk and handed straight to GL.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "ModelCache.h"
+#include "ModelDef.h"
+#include "ModelUploads.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Misc/Log.h"
+
+using OVR::Bounds3f;
+using OVR::Vector3f;
+
+namespace OVRFW {
+
+static_assert(sizeof(ModelGeometryCache::ovrHeader) % ModelGeometryCache::ALIGNMENT == 0, "");
+static_assert(sizeof(ModelGeometryCache::ovrSurface) % ModelGeometryCache::ALIGNMENT == 0, "");
+
+static uint64_t AlignCookedOffset(const uint64_t offset) {
+    const uint64_t mask = ModelGeometryCache::ALIGNMENT - 1;
+    return (offset + mask) & ~mask;
+}
+
+//==============================
+// ModelGeometryCache::ModelGeometryCache
+ModelGeometryCache::ModelGeometryCache()
+    : ContentHash(0), GeometryOptions(0), Cooked(false), NextSurface(0), RecordFailed(false) {}
+
+//==============================
+// ModelGeometryCache::~ModelGeometryCache
+ModelGeometryCache::~ModelGeometryCache() {
+    View.Close();
+    File.Close();
+}
+
+//==============================
+// ModelGeometryCache::GetSurfaceFlags
+uint32_t ModelGeometryCache::GetSurfaceFlags(const VertexAttribs& attribs) {
+    uint32_t flags = 0;
+    if (attribs.jointIndices.size() == attribs.position.size() &&
+        attribs.jointWeights.size() == attribs.position.size()) {
+        flags |= SURFACE_FLAG_SKINNED;
+    }
+    if (attribs.color.size() > 0) {
+        flags |= SURFACE_FLAG_VERTEX_COLOR;
+    }
+    return flags;
+}
+
+//==============================
+// ModelGeometryCache::HashContent
+uint64_t ModelGeometryCache::HashContent(const void* data, const size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+//==============================
+// ModelGeometryCache::GetGeometryOptions
+uint32_t ModelGeometryCache::GetGeometryOptions(const MaterialParms& materialParms) {
+    uint32_t options = 0;
+    if (materialParms.CompactVertices) {
+        options |= GEOMETRY_OPTION_COMPACT_VERTICES;
+    }
+    if (materialParms.OptimizeMeshes) {
+        options |= GEOMETRY_OPTION_OPTIMIZE_MESHES;
+        if (materialParms.Transparent) {
+            options |= GEOMETRY_OPTION_OPTIMIZE_TRANSPARENT;
+        }
+    }
+    return options;
+}
+
+//==============================
+// ModelGeometryCache::Open
+void ModelGeometryCache::Open(
+    const char* cachePath,
+    const uint64_t contentHash,
+    const uint32_t geometryOptions) {
+    CachePath = cachePath;
+    ContentHash = contentHash;
+    GeometryOptions = geometryOptions;
+    NextSurface = 0;
+    Recorded.clear();
+    RecordedScene.clear();
+    RecordFailed = false;
+
+    Cooked = MapCookedFile();
+    if (!Cooked) {
+        View.Close();
+        File.Close();
+    }
+}
+
+//==============================
+// ModelGeometryCache::MapCookedFile
+bool ModelGeometryCache::MapCookedFile() {
+    if (!File.OpenRead(CachePath.c_str(), true)) {
+        return false;
+    }
+    if (File.GetLength() < sizeof(ovrHeader) || !View.Open(&File) ||
+        View.MapView() == nullptr) {
+        ALOGW("ModelGeometryCache: could not map '%s'", CachePath.c_str());
+        return false;
+    }
+
+    const ovrHeader* header = reinterpret_cast<const ovrHeader*>(View.GetFront());
+    if (header->Magic != MAGIC || header->Version != VERSION ||
+        header->IndexSize != sizeof(TriangleIndex) || header->FileSize != File.GetLength()) {
+        ALOG("ModelGeometryCache: '%s' is from another version, re-cooking", CachePath.c_str());
+        return false;
+    }
+    if (header->ContentHash != ContentHash) {
+        ALOG("ModelGeometryCache: '%s' is stale, re-cooking", CachePath.c_str());
+        return false;
+    }
+    if (header->GeometryOptions != GeometryOptions) {
+        ALOG(
+            "ModelGeometryCache: '%s' was cooked with options 0x%x, not 0x%x, re-cooking",
+            CachePath.c_str(),
+            header->GeometryOptions,
+            GeometryOptions);
+        return false;
+    }
+
+    // never trust offsets from disk
+    const uint64_t fileSize = header->FileSize;
+    const uint64_t tableSize = uint64_t(header->NumSurfaces) * sizeof(ovrSurface);
+    if (header->SurfacesOffset % ALIGNMENT != 0 || header->SurfacesOffset + tableSize > fileSize) {
+        ALOGW("ModelGeometryCache: '%s' has a bad surface table", CachePath.c_str());
+        return false;
+    }
+    const ovrSurface* surfaces =
+        reinterpret_cast<const ovrSurface*>(View.GetFront() + header->SurfacesOffset);
+    for (uint32_t i = 0; i < header->NumSurfaces; i++) {
+        const ovrSurface& s = surfaces[i];
+        const uint64_t vertexSize = uint64_t(s.VertexCount) * s.VertexStride;
+        const uint64_t indexSize = uint64_t(s.IndexCount) * s.IndexSize;
+        if ((s.IndexSize != sizeof(TriangleIndex) && s.IndexSize != sizeof(TriangleIndex32)) ||
+            s.VertexOffset % ALIGNMENT != 0 || s.IndexOffset % ALIGNMENT != 0 ||
+            s.VertexOffset + vertexSize > fileSize || s.IndexOffset + indexSize > fileSize ||
+            s.NumAttributes > MAX_ATTRIBUTES) {
+            ALOGW("ModelGeometryCache: '%s' has a bad surface %u", CachePath.c_str(), i);
+            return false;
+        }
+    }
+    if (header->SceneOffset > fileSize || header->SceneSize > fileSize - header->SceneOffset) {
+        ALOGW("ModelGeometryCache: '%s' has a bad scene description", CachePath.c_str());
+        return false;
+    }
+
+    ALOG("ModelGeometryCache: mapped '%s', %u surfaces", CachePath.c_str(), header->NumSurfaces);
+    return true;
+}
+
+//==============================
+// ModelGeometryCache::CreateNextSurface
+bool ModelGeometryCache::CreateNextSurface(
+    GlGeometry& geo,
+    uint32_t& flags,
+    ModelGpuUploads* uploads) {
+    if (!Cooked) {
+        return false;
+    }
+    const uint8_t* front = View.GetFront();
+    const ovrHeader* header = reinterpret_cast<const ovrHeader*>(front);
+    if (NextSurface >= static_cast<int>(header->NumSurfaces)) {
+        // the loader produces more surfaces than were cooked, so drop the file and cook it again
+        // on the next load
+        ALOGW("ModelGeometryCache: '%s' is missing surfaces, removing", CachePath.c_str());
+        remove(CachePath.c_str());
+        Cooked = false;
+        RecordFailed = true;
+        return false;
+    }
+    const ovrSurface& s =
+        reinterpret_cast<const ovrSurface*>(front + header->SurfacesOffset)[NextSurface++];
+
+    const Bounds3f bounds(
+        Vector3f(s.BoundsMin[0], s.BoundsMin[1], s.BoundsMin[2]),
+        Vector3f(s.BoundsMax[0], s.BoundsMax[1], s.BoundsMax[2]));
+    const unsigned indexType =
+        (s.IndexSize == sizeof(TriangleIndex32)) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    if (uploads != nullptr) {
+        uploads->CreateInterleavedGeometry(
+            geo,
+            front + s.VertexOffset,
+            s.VertexCount,
+            s.VertexStride,
+            s.Attributes,
+            s.NumAttributes,
+            front + s.IndexOffset,
+            s.IndexCount,
+            bounds,
+            indexType);
+    } else {
+        geo.CreateInterleaved(
+            front + s.VertexOffset,
+            s.VertexCount,
+            s.VertexStride,
+            s.Attributes,
+            s.NumAttributes,
+            front + s.IndexOffset,
+            s.IndexCount,
+            bounds,
+            indexType);
+    }
+    flags = s.Flags;
+    return true;
+}
+
+//==============================
+// ModelGeometryCache::AddSurface
+void ModelGeometryCache::AddSurface(
+    const VertexAttribs& attribs,
+    const std::vector<TriangleIndex32>& indices,
+    const GlGeometry& geo,
+    const GlVertexFormat& format) {
+    if (RecordFailed) {
+        return;
+    }
+
+    std::vector<uint8_t> vertices;
+    std::vector<GlVertexAttribute> attributes;
+    int vertexStride = 0;
+    if (!GlGeometry::PackInterleavedVertices(attribs, format, vertices, attributes, vertexStride)) {
+        ALOGW("ModelGeometryCache: attribute counts differ, not cooking '%s'", CachePath.c_str());
+        RecordFailed = true;
+        return;
+    }
+    // AddInterleavedSurface() expects the indices at the width geo uses
+    std::vector<TriangleIndex> narrow;
+    if (geo.indexType != GL_UNSIGNED_INT) {
+        narrow.assign(indices.begin(), indices.end());
+    }
+    AddInterleavedSurface(
+        vertices.data(),
+        static_cast<int>(attribs.position.size()),
+        vertexStride,
+        attributes.data(),
+        static_cast<int>(attributes.size()),
+        narrow.empty() ? static_cast<const void*>(indices.data()) : narrow.data(),
+        static_cast<int>(indices.size()),
+        geo,
+        GetSurfaceFlags(attribs));
+}
+
+//==============================
+// ModelGeometryCache::AddInterleavedSurface
+void ModelGeometryCache::AddInterleavedSurface(
+    const void* vertices,
+    const int numVertices,
+    const int vertexStride,
+    const GlVertexAttribute* attributes,
+    const int numAttributes,
+    const void* indices,
+    const int numIndices,
+    const GlGeometry& geo,
+    const uint32_t flags) {
+    if (RecordFailed) {
+        return;
+    }
+    if (numAttributes > MAX_ATTRIBUTES) {
+        RecordFailed = true;
+        return;
+    }
+
+    Recorded.emplace_back();
+    ovrRecordedSurface& r = Recorded.back();
+    ovrSurface& s = r.Surface;
+    memset(&s, 0, sizeof(s));
+
+    s.VertexCount = static_cast<uint32_t>(numVertices);
+    s.VertexStride = static_cast<uint32_t>(vertexStride);
+    s.IndexCount = static_cast<uint32_t>(numIndices);
+    s.IndexSize = (geo.indexType == GL_UNSIGNED_INT) ? sizeof(TriangleIndex32)
+                                                     : sizeof(TriangleIndex);
+    s.NumAttributes = static_cast<uint32_t>(numAttributes);
+    s.Flags = flags;
+    memcpy(s.Attributes, attributes, numAttributes * sizeof(attributes[0]));
+    for (int i = 0; i < 3; i++) {
+        s.BoundsMin[i] = geo.localBounds.b[0][i];
+        s.BoundsMax[i] = geo.localBounds.b[1][i];
+    }
+
+    const uint8_t* v = static_cast<const uint8_t*>(vertices);
+    r.Vertices.assign(v, v + (size_t)numVertices * vertexStride);
+    const uint8_t* indexBytes = static_cast<const uint8_t*>(indices);
+    r.Indices.assign(indexBytes, indexBytes + (size_t)numIndices * s.IndexSize);
+}
+
+//==============================
+// ModelGeometryCache::WriteCookedFile
+bool ModelGeometryCache::WriteCookedFile() const {
+    ovrHeader header;
+    memset(&header, 0, sizeof(header));
+    header.Magic = MAGIC;
+    header.Version = VERSION;
+    header.ContentHash = ContentHash;
+    header.GeometryOptions = GeometryOptions;
+    header.IndexSize = sizeof(TriangleIndex);
+    header.NumSurfaces = static_cast<uint32_t>(Recorded.size());
+    header.SurfacesOffset = AlignCookedOffset(sizeof(ovrHeader));
+
+    // lay out the data sections
+    std::vector<ovrSurface> surfaces(Recorded.size());
+    uint64_t offset = header.SurfacesOffset + surfaces.size() * sizeof(ovrSurface);
+    for (size_t i = 0; i < Recorded.size(); i++) {
+        surfaces[i] = Recorded[i].Surface;
+        surfaces[i].VertexOffset = AlignCookedOffset(offset);
+        offset = surfaces[i].VertexOffset + Recorded[i].Vertices.size();
+        surfaces[i].IndexOffset = AlignCookedOffset(offset);
+        offset = surfaces[i].IndexOffset + Recorded[i].Indices.size();
+    }
+    header.SceneOffset = (RecordedScene.size() > 0) ? AlignCookedOffset(offset) : 0;
+    header.SceneSize = RecordedScene.size();
+    if (header.SceneSize > 0) {
+        offset = header.SceneOffset + header.SceneSize;
+    }
+    header.FileSize = offset;
+
+    // write to a temporary file and rename it, so a partially written file is never mapped
+    const std::string tempPath = CachePath + ".tmp";
+    FILE* f = fopen(tempPath.c_str(), "wb");
+    if (f == nullptr) {
+        ALOGW("ModelGeometryCache: could not create '%s'", tempPath.c_str());
+        return false;
+    }
+
+    static const uint8_t padding[ALIGNMENT] = {};
+    uint64_t written = 0;
+    auto writeAt = [&](const uint64_t at, const void* data, const size_t size) {
+        bool ok = true;
+        if (at > written) {
+            ok = fwrite(padding, 1, at - written, f) == at - written;
+        }
+        if (ok && size > 0) {
+            ok = fwrite(data, 1, size, f) == size;
+        }
+        written = at + size;
+        return ok;
+    };
+
+    bool ok = writeAt(0, &header, sizeof(header));
+    ok = ok &&
+        writeAt(header.SurfacesOffset, surfaces.data(), surfaces.size() * sizeof(ovrSurface));
+    for (size_t i = 0; ok && i < Recorded.size(); i++) {
+        const ovrRecordedSurface& r = Recorded[i];
+        ok = ok && writeAt(surfaces[i].VertexOffset, r.Vertices.data(), r.Vertices.size());
+        ok = ok && writeAt(surfaces[i].IndexOffset, r.Indices.data(), r.Indices.size());
+    }
+    ok = ok && writeAt(header.SceneOffset, RecordedScene.data(), RecordedScene.size());
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok || rename(tempPath.c_str(), CachePath.c_str()) != 0) {
+        ALOGW("ModelGeometryCache: failed to write '%s'", CachePath.c_str());
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    ALOG(
+        "ModelGeometryCache: cooked '%s', %u surfaces, %llu byte scene, %llu bytes",
+        CachePath.c_str(),
+        header.NumSurfaces,
+        (unsigned long long)header.SceneSize,
+        (unsigned long long)header.FileSize);
+    return true;
+}
+
+//==============================
+// ModelGeometryCache::Finish
+void ModelGeometryCache::Finish(const bool loadSucceeded) {
+    if (Cooked) {
+        const ovrHeader* header = reinterpret_cast<const ovrHeader*>(View.GetFront());
+        if (!RecordFailed && NextSurface != static_cast<int>(header->NumSurfaces)) {
+            // the loader no longer produces the surfaces that were cooked
+            ALOGW("ModelGeometryCache: '%s' has unused surfaces, removing", CachePath.c_str());
+            remove(CachePath.c_str());
+        }
+    } else if (loadSucceeded && !RecordFailed && !CachePath.empty()) {
+        WriteCookedFile();
+    }
+
+    View.Close();
+    File.Close();
+    Cooked = false;
+    Recorded.clear();
+    RecordedScene.clear();
+}
+
+//==============================
+// ModelGeometryCache::Invalidate
+void ModelGeometryCache::Invalidate() {
+    ALOGW("ModelGeometryCache: '%s' could not be used, removing", CachePath.c_str());
+    remove(CachePath.c_str());
+    RecordFailed = true;
+}
+
+//==============================
+// ModelGeometryCache::GetScene
+bool ModelGeometryCache::GetScene(const uint8_t*& data, size_t& size) {
+    if (!Cooked) {
+        return false;
+    }
+    const ovrHeader* header = reinterpret_cast<const ovrHeader*>(View.GetFront());
+    if (header->SceneSize == 0) {
+        return false;
+    }
+    data = View.GetFront() + header->SceneOffset;
+    size = static_cast<size_t>(header->SceneSize);
+    return true;
+}
+
+//==============================
+// ModelGeometryCache::SetScene
+void ModelGeometryCache::SetScene(std::vector<uint8_t>&& scene) {
+    if (!Cooked) {
+        RecordedScene = std::move(scene);
+    }
+}
+
+} // namespace OVRFW
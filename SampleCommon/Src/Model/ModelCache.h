@@ -0,0 +1,283 @@
+/************************************************************************************
+
+Filename    :   ModelCache.h
+Content     :   Cooked models, mapped from disk and handed straight to GL.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "OVR_MappedFile.h"
+
+#include "Render/GlGeometry.h"
+
+namespace OVRFW {
+
+class ModelGpuUploads;
+struct MaterialParms;
+
+//==============================================================
+// ModelGeometryCache
+// The first time a model is loaded with a cache, the model loaders record every surface's
+// geometry as an interleaved vertex buffer and an index buffer, and the cache writes them to a
+// cooked file next to a hash of the source file. Later loads of the same source map the cooked
+// file and create each surface's buffers directly from the mapping, skipping the accessor reads
+// and attribute packing.
+//
+// A loader can also store the rest of the model, everything but the images, as a scene
+// description. The glTF loaders do, and rebuild cooked models from it without parsing the JSON;
+// see ModelFile_glTF.cpp for its contents.
+//
+// Cooked file layout, all sections 16 byte aligned:
+//	header | surface table | surface 0 vertices | surface 0 indices | ... | scene description
+// A cooked file is only used if its version, index size, content hash and geometry options
+// match, so a changed source file, loader or MaterialParms is rebuilt on the next load.
+class ModelGeometryCache {
+   public:
+    static const uint32_t MAGIC = ('O' << 0) | ('V' << 8) | ('C' << 16) | ('M' << 24);
+    static const uint32_t VERSION = 7;
+    static const uint32_t ALIGNMENT = 16;
+    static const int MAX_ATTRIBUTES = 9;
+
+    // what the loaders need to know about a surface's attributes to pick its program
+    static const uint32_t SURFACE_FLAG_SKINNED = 1 << 0;
+    static const uint32_t SURFACE_FLAG_VERTEX_COLOR = 1 << 1;
+
+    // the MaterialParms that change the cooked geometry
+    static const uint32_t GEOMETRY_OPTION_COMPACT_VERTICES = 1 << 0;
+    static const uint32_t GEOMETRY_OPTION_OPTIMIZE_MESHES = 1 << 1;
+    // optimized without the overdraw pass, which reorders the triangles of opaque surfaces only
+    static const uint32_t GEOMETRY_OPTION_OPTIMIZE_TRANSPARENT = 1 << 2;
+
+    struct ovrHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint64_t ContentHash;
+        uint32_t IndexSize; // sizeof( TriangleIndex ) when cooked
+        uint32_t NumSurfaces;
+        uint64_t SurfacesOffset;
+        uint64_t FileSize;
+        uint64_t SceneOffset;
+        uint64_t SceneSize;
+        uint32_t GeometryOptions; // GEOMETRY_OPTION_* bits the file was cooked with
+        uint32_t Reserved;
+    };
+
+    struct ovrSurface {
+        uint64_t VertexOffset;
+        uint64_t IndexOffset;
+        uint32_t VertexCount;
+        uint32_t VertexStride;
+        uint32_t IndexCount;
+        uint32_t NumAttributes;
+        uint32_t Flags;
+        float BoundsMin[3];
+        float BoundsMax[3];
+        uint32_t IndexSize; // sizeof( TriangleIndex ) or sizeof( TriangleIndex32 )
+        GlVertexAttribute Attributes[MAX_ATTRIBUTES];
+    };
+
+    ModelGeometryCache();
+    ~ModelGeometryCache();
+
+    static uint32_t GetSurfaceFlags(const VertexAttribs& attribs);
+
+    // 64 bit FNV-1a hash of the source file, used to detect stale cooked files.
+    static uint64_t HashContent(const void* data, const size_t length);
+    // The GEOMETRY_OPTION_* bits for a load with these parms.
+    static uint32_t GetGeometryOptions(const MaterialParms& materialParms);
+
+    // Maps the cooked file at cachePath if it was cooked from content with this hash and with
+    // these geometry options, otherwise starts recording so Finish() can write a new one.
+    void Open(const char* cachePath, const uint64_t contentHash, const uint32_t geometryOptions);
+    // Writes the recorded surfaces if the load succeeded, then unmaps the cooked file.
+    void Finish(const bool loadSucceeded);
+    // Removes a cooked file the loader could not use, so the next load cooks it again.
+    void Invalidate();
+
+    bool IsCooked() const {
+        return Cooked;
+    }
+
+    // Creates the next surface's geometry and returns its SURFACE_FLAG_* bits from the cooked
+    // file. Returns false if the surface has to be read from the source, in which case it should
+    // be recorded with AddSurface(). With uploads the geometry is only recorded, and the cooked
+    // file has to stay mapped, i.e. Finish() can't be called, until the uploads are done.
+    bool CreateNextSurface(GlGeometry& geo, uint32_t& flags, ModelGpuUploads* uploads = nullptr);
+    // Records a surface read from the source. geo is the geometry that was created from it, with
+    // the attributes encoded as in format; the indices are stored at the width geo uses.
+    void AddSurface(
+        const VertexAttribs& attribs,
+        const std::vector<TriangleIndex32>& indices,
+        const GlGeometry& geo,
+        const GlVertexFormat& format);
+    // Records a surface that was created with GlGeometry::CreateInterleaved().
+    void AddInterleavedSurface(
+        const void* vertices,
+        const int numVertices,
+        const int vertexStride,
+        const GlVertexAttribute* attributes,
+        const int numAttributes,
+        const void* indices,
+        const int numIndices,
+        const GlGeometry& geo,
+        const uint32_t flags);
+
+    // The scene description of the cooked file, or false if it has none.
+    bool GetScene(const uint8_t*& data, size_t& size);
+    // Records the scene description to write with the surfaces.
+    void SetScene(std::vector<uint8_t>&& scene);
+
+   private:
+    struct ovrRecordedSurface {
+        ovrSurface Surface;
+        std::vector<uint8_t> Vertices;
+        std::vector<uint8_t> Indices;
+    };
+
+    std::string CachePath;
+    uint64_t ContentHash;
+    uint32_t GeometryOptions;
+
+    // reading
+    MappedFile File;
+    MappedView View;
+    bool Cooked;
+    int NextSurface;
+
+    // recording
+    std::vector<ovrRecordedSurface> Recorded;
+    std::vector<uint8_t> RecordedScene;
+    bool RecordFailed;
+
+    bool MapCookedFile();
+    bool WriteCookedFile() const;
+};
+
+//==============================================================
+// ModelCacheWriter
+// Appends values to a scene description. Only for types that can be copied as bytes; the
+// description is read back by the same build, so there is no byte order or padding to fix.
+class ModelCacheWriter {
+   public:
+    explicit ModelCacheWriter(std::vector<uint8_t>& out) : Out(out) {}
+
+    template <typename _type_>
+    void Write(const _type_& value) {
+        static_assert(std::is_trivially_copyable<_type_>::value, "");
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        Out.insert(Out.end(), bytes, bytes + sizeof(value));
+    }
+    template <typename _type_>
+    void WriteArray(const std::vector<_type_>& values) {
+        static_assert(std::is_trivially_copyable<_type_>::value, "");
+        Write(static_cast<uint32_t>(values.size()));
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+        Out.insert(Out.end(), bytes, bytes + values.size() * sizeof(_type_));
+    }
+    void WriteString(const std::string& value) {
+        WriteBytes(value.data(), value.size());
+    }
+    void WriteBytes(const void* data, const size_t size) {
+        Write(static_cast<uint32_t>(size));
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        Out.insert(Out.end(), bytes, bytes + size);
+    }
+
+   private:
+    std::vector<uint8_t>& Out;
+};
+
+//==============================================================
+// ModelCacheReader
+// Reads what a ModelCacheWriter wrote. Reading past the end, or a count that can't fit in what is
+// left, fails the reader, and everything read after that is zero or empty.
+class ModelCacheReader {
+   public:
+    ModelCacheReader(const uint8_t* data, const size_t size)
+        : Data(data), Size(size), Offset(0), Failed(false) {}
+
+    template <typename _type_>
+    void Read(_type_& value) {
+        static_assert(std::is_trivially_copyable<_type_>::value, "");
+        if (!Take(&value, sizeof(value))) {
+            memset(static_cast<void*>(&value), 0, sizeof(value));
+        }
+    }
+    template <typename _type_>
+    _type_ Read() {
+        _type_ value;
+        Read(value);
+        return value;
+    }
+    template <typename _type_>
+    void ReadArray(std::vector<_type_>& values) {
+        static_assert(std::is_trivially_copyable<_type_>::value, "");
+        values.resize(ReadCount(sizeof(_type_)));
+        if (!Take(values.data(), values.size() * sizeof(_type_))) {
+            values.clear();
+        }
+    }
+    std::string ReadString() {
+        size_t size = 0;
+        const uint8_t* bytes = ReadBytes(size);
+        return std::string(reinterpret_cast<const char*>(bytes), size);
+    }
+    // Returns the bytes in place, they are not copied.
+    const uint8_t* ReadBytes(size_t& size) {
+        size = ReadCount(1);
+        const uint8_t* bytes = Data + Offset;
+        Offset += size;
+        return bytes;
+    }
+    // A count of elements that take at least elementSize bytes each.
+    uint32_t ReadCount(const size_t elementSize) {
+        const uint32_t count = Read<uint32_t>();
+        if (uint64_t(count) * elementSize > Size - Offset) {
+            Failed = true;
+            return 0;
+        }
+        return count;
+    }
+
+    bool IsAtEnd() const {
+        return !Failed && Offset == Size;
+    }
+    bool HasFailed() const {
+        return Failed;
+    }
+    // For values that were read but make no sense.
+    void Fail() {
+        Failed = true;
+    }
+
+   private:
+    const uint8_t* Data;
+    size_t Size;
+    size_t Offset;
+    bool Failed;
+
+    bool Take(void* out, const size_t bytes) {
+        if (Failed || bytes > Size - Offset) {
+            Failed = true;
+            return false;
+        }
+        if (bytes > 0) {
+            memcpy(out, Data + Offset, bytes);
+        }
+        Offset += bytes;
+        return true;
+    }
+};
+
+} // namespace OVRFW
@@ -31,13 +31,17 @@ struct MaterialParms {
           EnableDiffuseAniso(false),
           EnableEmissiveLodClamp(true),
           Transparent(false),
-          PolygonOffset(false) {}
+          PolygonOffset(false),
+          CompactVertices(false),
+          OptimizeMeshes(false) {}
 
     bool UseSrgbTextureFormats; // use sRGB textures
     bool EnableDiffuseAniso; // enable anisotropic filtering on the diffuse texture
     bool EnableEmissiveLodClamp; // enable LOD clamp on the emissive texture to avoid light bleeding
     bool Transparent; // surfaces with this material flag need to render in a transparent pass
     bool PolygonOffset; // render with polygon offset enabled
+    bool CompactVertices; // store vertex attributes in the smallest encoding that fits the data
+    bool OptimizeMeshes; // reorder triangles and vertices for the vertex cache and overdraw
 };
 
 enum ModelJointAnimation {
@@ -104,7 +108,13 @@ class ModelAccessor {
           count(0),
           type(ACCESSOR_UNKNOWN),
           minMaxSet(false),
-          normalized(false) {
+          normalized(false),
+          sparseCount(0),
+          sparseIndicesBufferView(nullptr),
+          sparseIndicesByteOffset(0),
+          sparseIndicesComponentType(0),
+          sparseValuesBufferView(nullptr),
+          sparseValuesByteOffset(0) {
         memset(intMin, 0, sizeof(int) * MAX_MODEL_ACCESSOR_COMPONENT_SIZE);
         memset(intMax, 0, sizeof(int) * MAX_MODEL_ACCESSOR_COMPONENT_SIZE);
         memset(floatMin, 0, sizeof(float) * MAX_MODEL_ACCESSOR_COMPONENT_SIZE);
@@ -129,7 +139,15 @@ class ModelAccessor {
     float floatMin[MAX_MODEL_ACCESSOR_COMPONENT_SIZE];
     float floatMax[MAX_MODEL_ACCESSOR_COMPONENT_SIZE];
     bool normalized;
-    // #TODO: implement Sparse Accessors
+    // Sparse accessors replace sparseCount elements of the data above, at the indices listed in
+    // the first view, with the tightly packed values in the second. Only vertex attributes and
+    // indices apply them.
+    int sparseCount;
+    const ModelBufferView* sparseIndicesBufferView;
+    size_t sparseIndicesByteOffset;
+    int sparseIndicesComponentType;
+    const ModelBufferView* sparseValuesBufferView;
+    size_t sparseValuesByteOffset;
 };
 
 struct ModelTexture {
@@ -526,7 +544,7 @@ struct ModelGlPrograms {
 
 struct ModelGeo {
     std::vector<OVR::Vector3f> positions;
-    std::vector<TriangleIndex> indices;
+    std::vector<TriangleIndex32> indices;
 };
 
 } // namespace OVRFW
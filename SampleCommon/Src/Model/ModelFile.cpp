@@ -14,11 +14,17 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "PackageFiles.h"
 #include "OVR_FileSys.h"
 #include "OVR_MappedFile.h"
+#include "AsyncLoader.h"
+#include "ModelCache.h"
+#include "ModelUploads.h"
 
 #include "OVR_Std.h"
 
 #include "Misc/Log.h"
 
+#include <algorithm>
+#include <memory>
+
 using OVR::Bounds3f;
 using OVR::Matrix4f;
 using OVR::Quatf;
@@ -130,20 +136,37 @@ void LoadModelFileTexture(
     const char* textureName,
     const char* buffer,
     const int size,
-    const MaterialParms& materialParms) {
+    const MaterialParms& materialParms,
+    const ModelLoadContext& context) {
     ModelTexture tex;
     tex.name = textureName;
     tex.name = tex.name.substr(0, tex.name.rfind("."));
-    int width;
-    int height;
-    tex.texid = LoadTextureFromBuffer(
-        textureName,
-        (const uint8_t*)buffer,
-        size,
-        (materialParms.UseSrgbTextureFormats ? TextureFlags_t(TEXTUREFLAG_USE_SRGB)
-                                             : TextureFlags_t()),
-        width,
-        height);
+    const TextureFlags_t flags = materialParms.UseSrgbTextureFormats
+        ? TextureFlags_t(TEXTUREFLAG_USE_SRGB)
+        : TextureFlags_t();
+    const ovrDecodedTexture* decoded = (context.DecodedTextures != nullptr)
+        ? context.DecodedTextures->Find(textureName)
+        : nullptr;
+    if (context.Uploads != nullptr) {
+        if (decoded != nullptr) {
+            tex.texid = context.Uploads->CreateTexture(*decoded);
+        } else {
+            // a failed decode still records the texture, the upload creates the default one
+            std::unique_ptr<ovrDecodedTexture> decodedHere(new ovrDecodedTexture());
+            DecodeTextureBuffer(
+                textureName, (const uint8_t*)buffer, size, flags, *decodedHere);
+            tex.texid = context.Uploads->CreateTexture(std::move(decodedHere));
+        }
+    } else {
+        int width;
+        int height;
+        if (decoded != nullptr) {
+            tex.texid = CreateTextureFromDecoded(*decoded, width, height);
+        } else {
+            tex.texid = LoadTextureFromBuffer(
+                textureName, (const uint8_t*)buffer, size, flags, width, height);
+        }
+    }
 
     // ALOG( ( tex.texid.target == GL_TEXTURE_CUBE_MAP ) ? "GL_TEXTURE_CUBE_MAP: %s" :
     // "GL_TEXTURE_2D: %s", textureName );
@@ -151,12 +174,36 @@ void LoadModelFileTexture(
     // file name metadata for enabling clamp mode
     // Used for sky sides in Tuscany.
     if (strstr(textureName, "_c.")) {
-        MakeTextureClamped(tex.texid);
+        ModifyModelTexture(context, tex.texid, MakeTextureClamped);
     }
 
     model.Textures.push_back(tex);
 }
 
+void ModifyModelTexture(
+    const ModelLoadContext& context,
+    const GlTexture& texture,
+    const std::function<void(GlTexture)>& modify) {
+    if (context.Uploads != nullptr) {
+        context.Uploads->ModifyTexture(texture, modify);
+    } else {
+        modify(texture);
+    }
+}
+
+void CreateModelGeometry(
+    const ModelLoadContext& context,
+    GlGeometry& geo,
+    const VertexAttribs& attribs,
+    const std::vector<TriangleIndex32>& indices,
+    const GlVertexFormat& format) {
+    if (context.Uploads != nullptr) {
+        context.Uploads->CreateGeometry(geo, attribs, indices, format);
+    } else {
+        geo.Create(attribs, indices, format);
+    }
+}
+
 static ModelFile* LoadZippedModelFile(
     unzFile zfp,
     const char* fileName,
@@ -164,7 +211,8 @@ static ModelFile* LoadZippedModelFile(
     const int fileDataLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo = nullptr) {
+    ModelGeo* outModelGeo = nullptr,
+    const ModelLoadContext& context = ModelLoadContext()) {
     // LOGCPUTIME( "LoadZippedModelFile" );
 
     ModelFile* modelFilePtr = new ModelFile;
@@ -185,7 +233,8 @@ static ModelFile* LoadZippedModelFile(
             fileDataLength,
             programs,
             materialParms,
-            outModelGeo);
+            outModelGeo,
+            context);
     } else {
         loaded = LoadModelFile_OvrScene(
             modelFilePtr,
@@ -195,11 +244,16 @@ static ModelFile* LoadZippedModelFile(
             fileDataLength,
             programs,
             materialParms,
-            outModelGeo);
+            outModelGeo,
+            context);
     }
 
     if (!loaded) {
         ALOGW("Error: failed to load %s", fileName);
+        if (context.Uploads != nullptr) {
+            // nothing recorded for the model will be created
+            context.Uploads->Discard(*modelFilePtr);
+        }
         delete modelFilePtr;
         modelFilePtr = nullptr;
     }
@@ -341,20 +395,111 @@ static unzFile open_opaque(zlib_mmap_opaque& zlib_opaque, const char* fileName)
     return unzOpen2(fileName, &zlib_file_funcs);
 }
 
+//-----------------------------------------------------------------------------
+//	Decoded model images
+//-----------------------------------------------------------------------------
+
+static bool IsDecodedImageEntry(const char* entryName) {
+    const size_t entryLength = strlen(entryName);
+    if (entryLength >= 5 && OVR::OVR_stricmp(&entryName[entryLength - 5], ".ktx2") == 0) {
+        return true;
+    }
+    // assume a 3 character extension, as the scene loaders do
+    const char* extension = (entryLength >= 4) ? &entryName[entryLength - 4] : entryName;
+    return OVR::OVR_stricmp(extension, ".png") == 0 || OVR::OVR_stricmp(extension, ".jpg") == 0 ||
+        OVR::OVR_stricmp(extension, ".tga") == 0 || OVR::OVR_stricmp(extension, ".bmp") == 0;
+}
+
+//==============================
+// ModelDecodedTextures::DecodeZipImages
+void ModelDecodedTextures::DecodeZipImages(
+    const char* fileName,
+    const uint8_t* fileData,
+    const int fileDataLength,
+    const TextureFlags_t& flags,
+    ovrAsyncLoader* loader) {
+    Textures.clear();
+
+    zlib_mmap_opaque zlib_opaque;
+    mem_set_opaque(zlib_opaque, fileData, fileDataLength);
+    unzFile zfp = open_opaque(zlib_opaque, fileName);
+    if (!zfp) {
+        return;
+    }
+
+    // inflating has to walk the zip in order, the decodes don't
+    std::vector<std::string> names;
+    std::vector<std::vector<uint8_t>> buffers;
+    for (int ret = unzGoToFirstFile(zfp); ret == UNZ_OK; ret = unzGoToNextFile(zfp)) {
+        unz_file_info finfo;
+        char entryName[256];
+        unzGetCurrentFileInfo(zfp, &finfo, entryName, sizeof(entryName), nullptr, 0, nullptr, 0);
+        if (!IsDecodedImageEntry(entryName) || unzOpenCurrentFile(zfp) != UNZ_OK) {
+            continue;
+        }
+        const int size = finfo.uncompressed_size;
+        std::vector<uint8_t> buffer(size);
+        if (unzReadCurrentFile(zfp, buffer.data(), size) != size) {
+            ALOGW("Failed to read %s from %s", entryName, fileName);
+            unzCloseCurrentFile(zfp);
+            continue;
+        }
+        unzCloseCurrentFile(zfp);
+        names.push_back(entryName);
+        buffers.push_back(std::move(buffer));
+    }
+    unzClose(zfp);
+
+    Textures.resize(names.size());
+    auto decode = [this, &names, &buffers, &flags](int i) {
+        std::unique_ptr<ovrDecodedTexture> decoded(new ovrDecodedTexture());
+        if (DecodeTextureBuffer(
+                names[i].c_str(), buffers[i].data(), buffers[i].size(), flags, *decoded)) {
+            Textures[i] = std::move(decoded);
+        }
+    };
+    if (loader != nullptr) {
+        loader->ParallelFor(static_cast<int>(names.size()), decode);
+    } else {
+        for (int i = 0; i < static_cast<int>(names.size()); i++) {
+            decode(i);
+        }
+    }
+    // failed decodes are left to LoadModelFileTexture() so they log and get the default texture
+    Textures.erase(std::remove(Textures.begin(), Textures.end(), nullptr), Textures.end());
+    ALOG(
+        "ModelDecodedTextures: decoded %zu of %zu images in %s",
+        Textures.size(),
+        names.size(),
+        fileName);
+}
+
+//==============================
+// ModelDecodedTextures::Find
+const ovrDecodedTexture* ModelDecodedTextures::Find(const char* entryName) const {
+    for (const std::unique_ptr<ovrDecodedTexture>& decoded : Textures) {
+        if (OVR::OVR_stricmp(decoded->FileName.c_str(), entryName) == 0) {
+            return decoded.get();
+        }
+    }
+    return nullptr;
+}
+
 ModelFile* LoadModelFileFromMemory(
     const char* fileName,
     const void* buffer,
     int bufferLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo) {
+    ModelGeo* outModelGeo,
+    const ModelLoadContext& context) {
     // Open the .ModelFile file as a zip.
     ALOG("LoadModelFileFromMemory %s %i", fileName, bufferLength);
 
     // Determine wether it's a glb binary file, or if it is a zipped up ovrscene.
     if (strstr(fileName, ".glb") != nullptr) {
         return LoadModelFile_glB(
-            fileName, (char*)buffer, bufferLength, programs, materialParms, outModelGeo);
+            fileName, (char*)buffer, bufferLength, programs, materialParms, outModelGeo, context);
     }
 
     zlib_mmap_opaque zlib_opaque;
@@ -370,7 +515,14 @@ ModelFile* LoadModelFileFromMemory(
     ALOG("LoadModelFileFromMemory zfp = %p", zfp);
 
     return LoadZippedModelFile(
-        zfp, fileName, (char*)buffer, bufferLength, programs, materialParms, outModelGeo);
+        zfp,
+        fileName,
+        (char*)buffer,
+        bufferLength,
+        programs,
+        materialParms,
+        outModelGeo,
+        context);
 }
 
 ModelFile* LoadModelFile(
@@ -447,6 +599,104 @@ ModelFile* LoadModelFile(
     return scene;
 }
 
+// Everything a model load hands from the loader thread to the GL thread. A load that is dropped
+// before its uploads are done, e.g. because the loader shut down, frees the model without
+// touching GL objects that were never created.
+struct ovrModelAsyncLoad {
+    ovrModelAsyncLoad() : Model(nullptr) {}
+    ~ovrModelAsyncLoad() {
+        if (Model != nullptr) {
+            Uploads.Discard(*Model);
+            delete Model;
+        }
+    }
+
+    // the recorded uploads point into the model and the cooked geometry
+    ModelGeometryCache Cache;
+    ModelDecodedTextures DecodedTextures;
+    ModelGpuUploads Uploads;
+    ModelFile* Model;
+};
+
+void LoadModelFileAsync(
+    ovrAsyncLoader& loader,
+    ovrFileSys& fileSys,
+    const char* uri,
+    const ModelGlPrograms& programs,
+    const MaterialParms& materialParms,
+    std::function<void(ModelFile* model)> onLoaded,
+    const char* cachePath) {
+    ovrAsyncLoader* loaderPtr = &loader;
+    ovrFileSys* fs = &fileSys;
+    std::string const uriString = uri;
+    std::string const cachePathString = (cachePath != nullptr) ? cachePath : "";
+    loader.LoadInSteps([loaderPtr,
+                        fs,
+                        uriString,
+                        cachePathString,
+                        programs,
+                        materialParms,
+                        onLoaded]() -> ovrGpuUploadSteps {
+        // shared so the steps stay copyable for std::function
+        std::shared_ptr<ovrModelAsyncLoad> load = std::make_shared<ovrModelAsyncLoad>();
+        std::vector<uint8_t> buffer;
+        if (!fs->ReadFile(uriString.c_str(), buffer)) {
+            ALOGW("Failed to load model uri '%s'", uriString.c_str());
+            buffer.clear();
+        }
+        if (!buffer.empty()) {
+            if (!cachePathString.empty()) {
+                load->Cache.Open(
+                    cachePathString.c_str(),
+                    ModelGeometryCache::HashContent(buffer.data(), buffer.size()),
+                    ModelGeometryCache::GetGeometryOptions(materialParms));
+            }
+            // decode the images of glTF scenes spread over several threads
+            if (strstr(uriString.c_str(), ".gltf.ovrscene") != nullptr) {
+                load->DecodedTextures.DecodeZipImages(
+                    uriString.c_str(),
+                    buffer.data(),
+                    static_cast<int>(buffer.size()),
+                    (materialParms.UseSrgbTextureFormats ? TextureFlags_t(TEXTUREFLAG_USE_SRGB)
+                                                         : TextureFlags_t()),
+                    loaderPtr);
+            }
+
+            // parse, inflate and pack here; the GL work is only recorded
+            ModelLoadContext context;
+            context.Uploads = &load->Uploads;
+            context.DecodedTextures = &load->DecodedTextures;
+            context.Cache = cachePathString.empty() ? nullptr : &load->Cache;
+            load->Model = LoadModelFileFromMemory(
+                uriString.c_str(),
+                buffer.data(),
+                static_cast<int>(buffer.size()),
+                programs,
+                materialParms,
+                nullptr,
+                context);
+            if (!load->Cache.IsCooked()) {
+                // a new cooked file is written from copies, so it can be written here
+                load->Cache.Finish(load->Model != nullptr);
+            }
+        }
+
+        // one texture or buffer per step, so the upload budget can split a model over frames
+        return [load, onLoaded]() {
+            if (load->Model != nullptr && !load->Uploads.UploadNext(*load->Model)) {
+                return false;
+            }
+            if (load->Cache.IsCooked()) {
+                load->Cache.Finish(load->Model != nullptr);
+            }
+            ModelFile* model = load->Model;
+            load->Model = nullptr;
+            onLoaded(model);
+            return true;
+        };
+    });
+}
+
 uint8_t* ModelAccessor::BufferData() const {
     if (bufferView == nullptr || bufferView->buffer == nullptr ||
         bufferView->buffer->bufferData == nullptr) {
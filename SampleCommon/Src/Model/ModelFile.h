@@ -13,8 +13,30 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "ModelDef.h"
 #include "OVR_FileSys.h"
 
+#include <functional>
+
 namespace OVRFW {
 
+class ModelGpuUploads;
+class ModelDecodedTextures;
+class ModelGeometryCache;
+
+//==============================================================
+// ModelLoadContext
+// State of one model load that the loaders are handed explicitly, rather than finding it in
+// thread locals.
+struct ModelLoadContext {
+    ModelLoadContext() : Uploads(nullptr), DecodedTextures(nullptr), Cache(nullptr) {}
+
+    // If set, textures and buffers are recorded here instead of created, so the load can run on
+    // a thread without a GL context. The model can't be drawn until the uploads are done.
+    ModelGpuUploads* Uploads;
+    // Images already decoded on a loader thread, used instead of decoding them again.
+    const ModelDecodedTextures* DecodedTextures;
+    // If set, the model is created from this cache's cooked file, or recorded into it.
+    ModelGeometryCache* Cache;
+};
+
 // A ModelFile is the in-memory representation of a digested model file.
 // It should be imutable in normal circumstances, but it is ok to load
 // and modify a model for a particular task, such as changing materials.
@@ -74,7 +96,8 @@ ModelFile* LoadModelFileFromMemory(
     int bufferLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo = nullptr);
+    ModelGeo* outModelGeo = nullptr,
+    const ModelLoadContext& context = ModelLoadContext());
 
 // Returns nullptr if there is an error loading the file
 ModelFile* LoadModelFile(
@@ -102,4 +125,21 @@ ModelFile* LoadModelFile(
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms);
 
+// Reads, parses and decodes the file on one of the loader's threads, recording its textures and
+// buffers in a ModelGpuUploads. The GL thread then creates them one per upload step as the loader
+// is updated, so the loader's frame budget can spread a model over several frames, and passes
+// the finished model to onLoaded (nullptr on error).
+// The programs must stay valid until onLoaded has been called.
+// If cachePath is set, the model is cooked to that file on the first load and created straight
+// from the mapped file on later loads, see ModelGeometryCache. glTF models are cooked whole,
+// .ovrscene models only their surface geometry.
+void LoadModelFileAsync(
+    class ovrAsyncLoader& loader,
+    class ovrFileSys& fileSys,
+    const char* uri,
+    const ModelGlPrograms& programs,
+    const MaterialParms& materialParms,
+    std::function<void(ModelFile* model)> onLoaded,
+    const char* cachePath = nullptr);
+
 } // namespace OVRFW
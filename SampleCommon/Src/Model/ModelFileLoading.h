@@ -13,6 +13,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "ModelFile.h"
 
 #include <math.h>
+#include <memory>
 #include <vector>
 
 #include "OVR_Math.h"
@@ -31,12 +32,51 @@ void CalculateTransformFromRTS(
     const OVR::Vector3f translation,
     const OVR::Vector3f scale);
 
+//==============================================================
+// ModelDecodedTextures
+// The images of a zipped model, decoded with their mip chains on a loader thread so that
+// LoadModelFileTexture() only has to upload them on the GL thread.
+class ModelDecodedTextures {
+   public:
+    // Decodes every stb_image and .ktx2 entry in the zip, spread over the loader's threads with
+    // ovrAsyncLoader::ParallelFor(), or on the calling thread without a loader.
+    void DecodeZipImages(
+        const char* fileName,
+        const uint8_t* fileData,
+        const int fileDataLength,
+        const TextureFlags_t& flags,
+        ovrAsyncLoader* loader);
+
+    // Returns the decoded image for the zip entry, or nullptr if it was not decoded.
+    const ovrDecodedTexture* Find(const char* entryName) const;
+
+   private:
+    std::vector<std::unique_ptr<ovrDecodedTexture>> Textures;
+};
+
+// Uses the image in context.DecodedTextures if there is one, otherwise decodes the buffer here.
+// With context.Uploads the texture is only recorded, and model gets a placeholder for it.
 void LoadModelFileTexture(
     ModelFile& model,
     const char* textureName,
     const char* buffer,
     const int size,
-    const MaterialParms& materialParms);
+    const MaterialParms& materialParms,
+    const ModelLoadContext& context);
+
+// Runs modify on a texture of the model now, or once it is created if the load is recorded.
+void ModifyModelTexture(
+    const ModelLoadContext& context,
+    const GlTexture& texture,
+    const std::function<void(GlTexture)>& modify);
+
+// Creates geo, or records it if the load is recorded.
+void CreateModelGeometry(
+    const ModelLoadContext& context,
+    GlGeometry& geo,
+    const VertexAttribs& attribs,
+    const std::vector<TriangleIndex32>& indices,
+    const GlVertexFormat& format);
 
 bool LoadModelFile_OvrScene(
     ModelFile* modelPtr,
@@ -46,7 +86,8 @@ bool LoadModelFile_OvrScene(
     const int fileDataLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo = NULL);
+    ModelGeo* outModelGeo = NULL,
+    const ModelLoadContext& context = ModelLoadContext());
 
 bool LoadModelFile_glTF_OvrScene(
     ModelFile* modelFilePtr,
@@ -56,7 +97,8 @@ bool LoadModelFile_glTF_OvrScene(
     const int fileDataLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo = NULL);
+    ModelGeo* outModelGeo = NULL,
+    const ModelLoadContext& context = ModelLoadContext());
 
 ModelFile* LoadModelFile_glB(
     const char* fileName,
@@ -64,6 +106,7 @@ ModelFile* LoadModelFile_glB(
     const int fileDataLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo = NULL);
+    ModelGeo* outModelGeo = NULL,
+    const ModelLoadContext& context = ModelLoadContext());
 
 } // namespace OVRFW
@@ -10,6 +10,9 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 *************************************************************************************/
 
 #include "ModelFileLoading.h"
+#include "ModelCache.h"
+#include "ModelUploads.h"
+#include "Render/MeshOptimizer.h"
 
 #include "Render/GlGeometry.h"
 
@@ -50,10 +53,17 @@ bool LoadModelFile_OvrScene_Json(
     const int modelsBinLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo) {
+    ModelGeo* outModelGeo,
+    const ModelLoadContext& context) {
     ALOG("parsing %s", modelFile.FileName.c_str());
     OVR_UNUSED(modelsJsonLength);
 
+    // the cache only stores what GlGeometry needs, so loads that want the source geometry back
+    // always read it, and geometry moved by a GlGeometry::TransformScope is never stored
+    ModelGeometryCache* const geometryCache =
+        (outModelGeo == nullptr && !GlGeometry::TransformScope::IsEnabled()) ? context.Cache
+                                                                             : nullptr;
+
     const BinaryReader bin((const std::uint8_t*)modelsBin, modelsBinLength);
 
     if (modelsBin != nullptr && bin.ReadUInt32() != 0x6272766F) {
@@ -138,19 +148,25 @@ bool LoadModelFile_OvrScene_Json(
                             ALOG("texture %s defaulted", name.c_str());
                             // Create a default texture.
                             LoadModelFileTexture(
-                                modelFile, name.c_str(), nullptr, 0, materialParms);
+                                modelFile, name.c_str(), nullptr, 0, materialParms, context);
                         }
                         glTextures.push_back(modelFile.Textures[i].texid);
 
                         const std::string usage = texture.GetChildStringByName("usage");
                         if (usage == "diffuse") {
                             if (materialParms.EnableDiffuseAniso == true) {
-                                MakeTextureAniso(modelFile.Textures[i].texid, 2.0f);
+                                ModifyModelTexture(
+                                    context, modelFile.Textures[i].texid, [](GlTexture texid) {
+                                        MakeTextureAniso(texid, 2.0f);
+                                    });
                             }
                         } else if (usage == "emissive") {
                             if (materialParms.EnableEmissiveLodClamp == true) {
                                 // LOD clamp lightmap textures to avoid light bleeding
-                                MakeTextureLodClamped(modelFile.Textures[i].texid, 1);
+                                ModifyModelTexture(
+                                    context, modelFile.Textures[i].texid, [](GlTexture texid) {
+                                        MakeTextureLodClamped(texid, 1);
+                                    });
                             }
                         }
                         /*
@@ -315,111 +331,155 @@ bool LoadModelFile_OvrScene_Json(
                             modelSurface.surfaceDef.geo.localBounds,
                             surface.GetChildStringByName("bounds").c_str());
 
-                        TriangleIndex indexOffset = 0;
+                        TriangleIndex32 indexOffset = 0;
                         if (outModelGeo != nullptr) {
                             indexOffset =
-                                static_cast<TriangleIndex>((*outModelGeo).positions.size());
+                                static_cast<TriangleIndex32>((*outModelGeo).positions.size());
                         }
-                        //
-                        // Vertices
-                        //
 
+                        // surfaces found in the geometry cache are created straight from the
+                        // cooked buffers, everything else is read from the source
                         VertexAttribs attribs;
+                        std::vector<TriangleIndex32> indices;
+                        uint32_t surfaceFlags = 0;
+                        if (geometryCache == nullptr ||
+                            !geometryCache->CreateNextSurface(
+                                modelSurface.surfaceDef.geo, surfaceFlags, context.Uploads)) {
+                            //
+                            // Vertices
+                            //
+
+                            const OVR::JsonReader vertices(surface.GetChildByName("vertices"));
+                            if (vertices.IsObject()) {
+                                const int vertexCount = std::min<int>(
+                                    vertices.GetChildInt32ByName("vertexCount"),
+                                    GlGeometry::GetMaxGeometryVertices32());
+                                // ALOG( "%5d vertices", vertexCount );
+
+                                ReadModelArray(
+                                    attribs.position,
+                                    vertices.GetChildStringByName("position").c_str(),
+                                    bin,
+                                    vertexCount);
+                                ReadModelArray(
+                                    attribs.normal,
+                                    vertices.GetChildStringByName("normal").c_str(),
+                                    bin,
+                                    vertexCount);
+                                ReadModelArray(
+                                    attribs.tangent,
+                                    vertices.GetChildStringByName("tangent").c_str(),
+                                    bin,
+                                    vertexCount);
+                                ReadModelArray(
+                                    attribs.binormal,
+                                    vertices.GetChildStringByName("binormal").c_str(),
+                                    bin,
+                                    vertexCount);
+                                ReadModelArray(
+                                    attribs.color,
+                                    vertices.GetChildStringByName("color").c_str(),
+                                    bin,
+                                    vertexCount);
+                                ReadModelArray(
+                                    attribs.uv0,
+                                    vertices.GetChildStringByName("uv0").c_str(),
+                                    bin,
+                                    vertexCount);
+                                ReadModelArray(
+                                    attribs.uv1,
+                                    vertices.GetChildStringByName("uv1").c_str(),
+                                    bin,
+                                    vertexCount);
+                                ReadModelArray(
+                                    attribs.jointIndices,
+                                    vertices.GetChildStringByName("jointIndices").c_str(),
+                                    bin,
+                                    vertexCount);
+                                ReadModelArray(
+                                    attribs.jointWeights,
+                                    vertices.GetChildStringByName("jointWeights").c_str(),
+                                    bin,
+                                    vertexCount);
+
+                                if (outModelGeo != nullptr) {
+                                    for (int i = 0; i < static_cast<int>(attribs.position.size());
+                                         ++i) {
+                                        (*outModelGeo).positions.push_back(attribs.position[i]);
+                                    }
+                                }
+                            }
 
-                        const OVR::JsonReader vertices(surface.GetChildByName("vertices"));
-                        if (vertices.IsObject()) {
-                            const int vertexCount = std::min<int>(
-                                vertices.GetChildInt32ByName("vertexCount"),
-                                GlGeometry::GetMaxGeometryVertices());
-                            // ALOG( "%5d vertices", vertexCount );
-
-                            ReadModelArray(
-                                attribs.position,
-                                vertices.GetChildStringByName("position").c_str(),
-                                bin,
-                                vertexCount);
-                            ReadModelArray(
-                                attribs.normal,
-                                vertices.GetChildStringByName("normal").c_str(),
-                                bin,
-                                vertexCount);
-                            ReadModelArray(
-                                attribs.tangent,
-                                vertices.GetChildStringByName("tangent").c_str(),
-                                bin,
-                                vertexCount);
-                            ReadModelArray(
-                                attribs.binormal,
-                                vertices.GetChildStringByName("binormal").c_str(),
-                                bin,
-                                vertexCount);
-                            ReadModelArray(
-                                attribs.color,
-                                vertices.GetChildStringByName("color").c_str(),
-                                bin,
-                                vertexCount);
-                            ReadModelArray(
-                                attribs.uv0,
-                                vertices.GetChildStringByName("uv0").c_str(),
-                                bin,
-                                vertexCount);
-                            ReadModelArray(
-                                attribs.uv1,
-                                vertices.GetChildStringByName("uv1").c_str(),
-                                bin,
-                                vertexCount);
-                            ReadModelArray(
-                                attribs.jointIndices,
-                                vertices.GetChildStringByName("jointIndices").c_str(),
-                                bin,
-                                vertexCount);
-                            ReadModelArray(
-                                attribs.jointWeights,
-                                vertices.GetChildStringByName("jointWeights").c_str(),
-                                bin,
-                                vertexCount);
+                            //
+                            // Triangles
+                            //
+
+                            const OVR::JsonReader triangles(surface.GetChildByName("triangles"));
+                            if (triangles.IsObject()) {
+                                const int indexCount = std::min<int>(
+                                    triangles.GetChildInt32ByName("indexCount"),
+                                    GlGeometry::GetMaxGeometryIndices());
+                                // ALOG( "%5d indices", indexCount );
+
+                                // surfaces with more vertices than 16 bit indices can address
+                                // are exported with 32 bit indices
+                                if (attribs.position.size() >
+                                    (size_t)GlGeometry::GetMaxGeometryVertices()) {
+                                    ReadModelArray(
+                                        indices,
+                                        triangles.GetChildStringByName("indices").c_str(),
+                                        bin,
+                                        indexCount);
+                                } else {
+                                    std::vector<TriangleIndex> narrow;
+                                    ReadModelArray(
+                                        narrow,
+                                        triangles.GetChildStringByName("indices").c_str(),
+                                        bin,
+                                        indexCount);
+                                    indices.assign(narrow.begin(), narrow.end());
+                                }
+                            }
 
                             if (outModelGeo != nullptr) {
-                                for (int i = 0; i < static_cast<int>(attribs.position.size());
-                                     ++i) {
-                                    (*outModelGeo).positions.push_back(attribs.position[i]);
+                                for (int i = 0; i < static_cast<int>(indices.size()); ++i) {
+                                    (*outModelGeo).indices.push_back(indices[i] + indexOffset);
                                 }
                             }
-                        }
 
-                        //
-                        // Triangles
-                        //
-
-                        std::vector<TriangleIndex> indices;
-
-                        const OVR::JsonReader triangles(surface.GetChildByName("triangles"));
-                        if (triangles.IsObject()) {
-                            const int indexCount = std::min<int>(
-                                triangles.GetChildInt32ByName("indexCount"),
-                                GlGeometry::GetMaxGeometryIndices());
-                            // ALOG( "%5d indices", indexCount );
+                            //
+                            // Setup geometry, textures and render programs now that the vertex
+                            // attributes are known.
+                            //
+
+                            if (materialParms.OptimizeMeshes && outModelGeo == nullptr) {
+                                // blended surfaces have to keep their triangle order
+                                const bool opaque = (materialType == MATERIAL_TYPE_OPAQUE ||
+                                                     materialType == MATERIAL_TYPE_PERFORATED) &&
+                                    !materialParms.Transparent;
+                                OptimizeMesh(
+                                    attribs,
+                                    indices,
+                                    opaque,
+                                    modelSurface.surfaceDef.surfaceName.c_str());
+                            }
 
-                            ReadModelArray(
+                            const GlVertexFormat vertexFormat = materialParms.CompactVertices
+                                ? GlVertexFormat::ChooseCompact(attribs)
+                                : GlVertexFormat();
+                            CreateModelGeometry(
+                                context,
+                                modelSurface.surfaceDef.geo,
+                                attribs,
                                 indices,
-                                triangles.GetChildStringByName("indices").c_str(),
-                                bin,
-                                indexCount);
-                        }
-
-                        if (outModelGeo != nullptr) {
-                            for (int i = 0; i < static_cast<int>(indices.size()); ++i) {
-                                (*outModelGeo).indices.push_back(indices[i] + indexOffset);
+                                vertexFormat);
+                            surfaceFlags = ModelGeometryCache::GetSurfaceFlags(attribs);
+                            if (geometryCache != nullptr) {
+                                geometryCache->AddSurface(
+                                    attribs, indices, modelSurface.surfaceDef.geo, vertexFormat);
                             }
                         }
 
-                        //
-                        // Setup geometry, textures and render programs now that the vertex
-                        // attributes are known.
-                        //
-
-                        modelSurface.surfaceDef.geo.Create(attribs, indices);
-
                         const char* materialTypeString = "opaque";
                         OVR_UNUSED(
                             materialTypeString); // we'll get warnings if the LOGV's compile out
@@ -459,8 +519,7 @@ bool LoadModelFile_OvrScene_Json(
                         }
 
                         const bool skinned =
-                            (attribs.jointIndices.size() == attribs.position.size() &&
-                             attribs.jointWeights.size() == attribs.position.size());
+                            (surfaceFlags & ModelGeometryCache::SURFACE_FLAG_SKINNED) != 0;
 
                         if (diffuseTextureIndex >= 0 &&
                             diffuseTextureIndex < static_cast<int>(glTextures.size())) {
@@ -540,7 +599,8 @@ bool LoadModelFile_OvrScene_Json(
                                     LOGV("%s diffuse only material", materialTypeString);
                                 }
                             }
-                        } else if (attribs.color.size() > 0) {
+                        } else if (
+                            (surfaceFlags & ModelGeometryCache::SURFACE_FLAG_VERTEX_COLOR) != 0) {
                             // vertex color material
                             if (skinned) {
                                 if (programs.ProgSkinnedVertexColor == nullptr) {
@@ -743,7 +803,8 @@ bool LoadModelFile_OvrScene(
     const int fileDataLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo) {
+    ModelGeo* outModelGeo,
+    const ModelLoadContext& context) {
     // LOGCPUTIME( "LoadModelFile_OvrScene" );
 
     ModelFile& model = *modelPtr;
@@ -805,7 +866,7 @@ bool LoadModelFile_OvrScene(
         } else if (
             OVR::OVR_stricmp(extension, ".pvr") == 0 || OVR::OVR_stricmp(extension, ".ktx") == 0) {
             // only support .pvr and .ktx containers for now
-            LoadModelFileTexture(model, entryName, buffer, size, materialParms);
+            LoadModelFileTexture(model, entryName, buffer, size, materialParms, context);
         } else {
             // ignore other files
             LOGV("Ignoring %s", entryName);
@@ -830,7 +891,8 @@ bool LoadModelFile_OvrScene(
             modelsBinLength,
             programs,
             materialParms,
-            outModelGeo);
+            outModelGeo,
+            context);
     }
 
     if (modelsJson < fileData || modelsJson > fileData + fileDataLength) {
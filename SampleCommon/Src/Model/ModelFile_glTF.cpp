@@ -10,6 +10,9 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 *************************************************************************************/
 
 #include "ModelFileLoading.h"
+#include "ModelCache.h"
+#include "ModelUploads.h"
+#include "Render/MeshOptimizer.h"
 
 #include "OVR_Std.h"
 #include "OVR_JSON.h"
@@ -18,6 +21,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Misc/Log.h"
 #include "OVR_BinaryFile2.h"
 
+#include <limits>
 #include <unordered_map>
 
 using OVR::Bounds3f;
@@ -115,6 +119,53 @@ static void ParseFloatArray(float* elements, const int count, OVR::JsonReader ar
     }
 }
 
+// Writes the values of a sparse accessor over the elements they replace. out holds the
+// accessor's count elements of elementSize bytes. Returns false if the sparse data is out of
+// range.
+static bool ApplySparseAccessor(const ModelAccessor& accessor, uint8_t* out, size_t elementSize) {
+    if (accessor.sparseCount <= 0) {
+        return true;
+    }
+    const ModelBufferView* indexView = accessor.sparseIndicesBufferView;
+    const ModelBufferView* valueView = accessor.sparseValuesBufferView;
+    const size_t indexSize = (accessor.sparseIndicesComponentType == GL_UNSIGNED_INT)
+        ? sizeof(uint32_t)
+        : (accessor.sparseIndicesComponentType == GL_UNSIGNED_SHORT) ? sizeof(uint16_t)
+                                                                      : sizeof(uint8_t);
+    const size_t count = static_cast<size_t>(accessor.sparseCount);
+    const size_t indexEnd = accessor.sparseIndicesByteOffset + count * indexSize;
+    const size_t valueEnd = accessor.sparseValuesByteOffset + count * elementSize;
+    if (indexView == nullptr || valueView == nullptr || indexView->byteLength < indexEnd ||
+        indexView->buffer->byteLength < indexView->byteOffset + indexEnd ||
+        valueView->byteLength < valueEnd ||
+        valueView->buffer->byteLength < valueView->byteOffset + valueEnd) {
+        ALOGW("Error: sparse accessor %s requesting too much data", accessor.name.c_str());
+        return false;
+    }
+    const uint8_t* indices =
+        indexView->buffer->bufferData + indexView->byteOffset + accessor.sparseIndicesByteOffset;
+    const uint8_t* values =
+        valueView->buffer->bufferData + valueView->byteOffset + accessor.sparseValuesByteOffset;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t index = 0;
+        if (indexSize == sizeof(uint32_t)) {
+            memcpy(&index, indices + i * indexSize, sizeof(uint32_t));
+        } else if (indexSize == sizeof(uint16_t)) {
+            uint16_t narrow;
+            memcpy(&narrow, indices + i * indexSize, sizeof(uint16_t));
+            index = narrow;
+        } else {
+            index = indices[i];
+        }
+        if (index >= static_cast<uint32_t>(accessor.count)) {
+            ALOGW("Error: sparse accessor %s index %u out of range", accessor.name.c_str(), index);
+            return false;
+        }
+        memcpy(out + index * elementSize, values + i * elementSize, elementSize);
+    }
+    return true;
+}
+
 template <typename _type_>
 bool ReadSurfaceDataFromAccessor(
     std::vector<_type_>& out,
@@ -178,46 +229,1111 @@ bool ReadSurfaceDataFromAccessor(
 
         const size_t offset = accessor->byteOffset + accessor->bufferView->byteOffset;
         const size_t copySize = accessor->count * sizeof(out[0]);
+        // a strided read only needs a full stride between elements, not after the last one
+        const size_t readSize = (readStride > 0 && accessor->count > 0)
+            ? (accessor->count - 1) * readStride + sizeof(out[0])
+            : copySize;
 
-        if (accessor->bufferView->buffer->byteLength < (offset + copySize) ||
-            accessor->bufferView->byteLength < (copySize)) {
+        if (accessor->bufferView->buffer->byteLength < (offset + readSize) ||
+            accessor->bufferView->byteLength < (accessor->byteOffset + readSize)) {
             ALOGW(
                 "Error: accessor requesting too much data in gltfPrimitive %d %d %d",
                 index,
                 (int)accessor->bufferView->byteLength,
-                (int)(offset + copySize));
+                (int)(offset + readSize));
             loaded = false;
         }
 
-        if (loaded) {
+        if (loaded && accessor->count > 0) {
             out.resize(accessor->count);
 
-            // #TODO this doesn't seem to be working, figure out why.
-            if (false && readStride > 0) {
-                for (int i = 0; i < count; i++) {
-                    memcpy(
-                        &out[i],
-                        accessor->bufferView->buffer->bufferData + offset + (readStride * i),
-                        sizeof(out[0]));
+            const uint8_t* data = accessor->bufferView->buffer->bufferData + offset;
+            if (readStride > 0) {
+                for (int i = 0; i < accessor->count; i++) {
+                    memcpy(&out[i], data + (readStride * i), sizeof(out[0]));
                 }
             } else {
-                memcpy(&out[0], accessor->bufferView->buffer->bufferData + offset, copySize);
+                memcpy(&out[0], data, copySize);
             }
+            loaded = ApplySparseAccessor(
+                *accessor, reinterpret_cast<uint8_t*>(out.data()), sizeof(out[0]));
         }
     }
 
     return loaded;
 }
 
+// Reads a float attribute stored as normalized unsigned integers, scaled to [0, 1].
+template <typename _component_type_, typename _type_>
+static bool ReadNormalizedAccessor(
+    std::vector<_type_>& out,
+    const ModelAccessor& accessor,
+    const ModelAccessorType type,
+    const int count) {
+    const size_t components = sizeof(_type_) / sizeof(float);
+    const size_t elementSize = components * sizeof(_component_type_);
+    const size_t stride = (accessor.bufferView->byteStride > 0)
+        ? static_cast<size_t>(accessor.bufferView->byteStride)
+        : elementSize;
+    const size_t offset = accessor.byteOffset + accessor.bufferView->byteOffset;
+    const size_t readSize =
+        (accessor.count > 0) ? (accessor.count - 1) * stride + elementSize : 0;
+    if (accessor.type != type || (count >= 0 && accessor.count != count) ||
+        stride < elementSize || accessor.bufferView->buffer->byteLength < offset + readSize ||
+        accessor.bufferView->byteLength < accessor.byteOffset + readSize) {
+        ALOGW("Error: Invalid normalized accessor %s on gltfPrimitive", accessor.name.c_str());
+        return false;
+    }
+
+    std::vector<_component_type_> packed(accessor.count * components);
+    const uint8_t* data = accessor.bufferView->buffer->bufferData + offset;
+    for (int i = 0; i < accessor.count; i++) {
+        memcpy(&packed[i * components], data + stride * i, elementSize);
+    }
+    if (!ApplySparseAccessor(accessor, reinterpret_cast<uint8_t*>(packed.data()), elementSize)) {
+        return false;
+    }
+    out.resize(accessor.count);
+    float* values = reinterpret_cast<float*>(out.data());
+    const float scale = 1.0f / static_cast<float>(std::numeric_limits<_component_type_>::max());
+    for (size_t i = 0; i < packed.size(); i++) {
+        values[i] = static_cast<float>(packed[i]) * scale;
+    }
+    return true;
+}
+
+// Reads a float vertex attribute. Texture coordinates, colors and weights may also be stored
+// as normalized unsigned bytes or shorts.
+template <typename _type_>
+static bool ReadFloatAttribute(
+    std::vector<_type_>& out,
+    ModelFile& modelFile,
+    const int index,
+    const ModelAccessorType type,
+    const int count) {
+    if (index >= 0 && index < static_cast<int>(modelFile.Accessors.size())) {
+        const ModelAccessor& accessor = modelFile.Accessors[index];
+        if (accessor.normalized && accessor.componentType == GL_UNSIGNED_BYTE) {
+            return ReadNormalizedAccessor<uint8_t>(out, accessor, type, count);
+        }
+        if (accessor.normalized && accessor.componentType == GL_UNSIGNED_SHORT) {
+            return ReadNormalizedAccessor<uint16_t>(out, accessor, type, count);
+        }
+    }
+    return ReadSurfaceDataFromAccessor(out, modelFile, index, type, GL_FLOAT, count);
+}
+
+// Joint indices are stored as four components of any type, and may be interleaved with other
+// attributes.
+template <typename _component_type_>
+static void ReadJointIndices(std::vector<OVR::Vector4i>& out, const ModelAccessor& acc) {
+    const int stride = (acc.bufferView->byteStride > 0) ? acc.bufferView->byteStride
+                                                        : (int)(4 * sizeof(_component_type_));
+    const uint8_t* data = acc.BufferData();
+    out.resize(acc.count);
+    for (int i = 0; i < acc.count; i++) {
+        const _component_type_* joint =
+            reinterpret_cast<const _component_type_*>(data + (size_t)stride * i);
+        out[i].x = (int)joint[0];
+        out[i].y = (int)joint[1];
+        out[i].z = (int)joint[2];
+        out[i].w = (int)joint[3];
+    }
+}
+
+// Reads 8 or 16 bit indices, widened so they can be handled like 32 bit indices.
+template <typename _type_>
+static void ReadIndices(
+    std::vector<TriangleIndex32>& indices,
+    ModelFile& modelFile,
+    const int index,
+    const int componentType) {
+    std::vector<_type_> narrow;
+    ReadSurfaceDataFromAccessor(narrow, modelFile, index, ACCESSOR_SCALAR, componentType, -1);
+    indices.assign(narrow.begin(), narrow.end());
+}
+
+// Reads the vertex attributes and indices of a glTF primitive. Sets loaded to false on errors,
+// but still returns whatever could be read.
+static void ReadPrimitiveGeometry(
+    ModelFile& modelFile,
+    const OVR::JsonReader& primitive,
+    const OVR::JsonReader& attributes,
+    ovrSurfaceDef& surfaceDef,
+    VertexAttribs& attribs,
+    std::vector<TriangleIndex32>& indices,
+    bool& loaded) {
+    { // POSITION and BOUNDS
+        const int positionIndex = attributes.GetChildInt32ByName("POSITION", -1);
+        if (positionIndex < 0) {
+            ALOGW("Error: Invalid position index on gltfPrimitive");
+            loaded = false;
+        }
+
+        loaded = ReadSurfaceDataFromAccessor(
+            attribs.position, modelFile, positionIndex, ACCESSOR_VEC3, GL_FLOAT, -1);
+
+        const ModelAccessor* positionAccessor = &modelFile.Accessors[positionIndex];
+        if (positionAccessor == nullptr) {
+            ALOGW("Error: Invalid positionAccessor on surface %s", surfaceDef.surfaceName.c_str());
+            loaded = false;
+        } else if (!positionAccessor->minMaxSet) {
+            ALOGW(
+                "Error: no min and max set on positionAccessor on surface %s",
+                surfaceDef.surfaceName.c_str());
+            loaded = false;
+        } else {
+            Vector3f min;
+            min.x = positionAccessor->floatMin[0];
+            min.y = positionAccessor->floatMin[1];
+            min.z = positionAccessor->floatMin[2];
+            surfaceDef.geo.localBounds.AddPoint(min);
+
+            Vector3f max;
+            max.x = positionAccessor->floatMax[0];
+            max.y = positionAccessor->floatMax[1];
+            max.z = positionAccessor->floatMax[2];
+            surfaceDef.geo.localBounds.AddPoint(max);
+        }
+    }
+
+    const int numVertices = static_cast<int>(attribs.position.size());
+    if (loaded) {
+        loaded = ReadSurfaceDataFromAccessor(
+            attribs.normal,
+            modelFile,
+            attributes.GetChildInt32ByName("NORMAL", -1),
+            ACCESSOR_VEC3,
+            GL_FLOAT,
+            numVertices);
+    }
+    // #TODO:  we have tangent as a vec3, the spec has it as a vec4.
+    // so we will have to one off the loading of it.
+    if (loaded) {
+        loaded = ReadSurfaceDataFromAccessor(
+            attribs.tangent,
+            modelFile,
+            attributes.GetChildInt32ByName("TANGENT", -1),
+            ACCESSOR_VEC3,
+            GL_FLOAT,
+            numVertices);
+    }
+    if (loaded) {
+        loaded = ReadSurfaceDataFromAccessor(
+            attribs.binormal,
+            modelFile,
+            attributes.GetChildInt32ByName("BINORMAL", -1),
+            ACCESSOR_VEC3,
+            GL_FLOAT,
+            numVertices);
+    }
+    if (loaded) {
+        loaded = ReadFloatAttribute(
+            attribs.color,
+            modelFile,
+            attributes.GetChildInt32ByName("COLOR", -1),
+            ACCESSOR_VEC4,
+            numVertices);
+    }
+    if (loaded) {
+        loaded = ReadFloatAttribute(
+            attribs.uv0,
+            modelFile,
+            attributes.GetChildInt32ByName("TEXCOORD_0", -1),
+            ACCESSOR_VEC2,
+            numVertices);
+    }
+    if (loaded) {
+        loaded = ReadFloatAttribute(
+            attribs.uv1,
+            modelFile,
+            attributes.GetChildInt32ByName("TEXCOORD_1", -1),
+            ACCESSOR_VEC2,
+            numVertices);
+    }
+    // #TODO:  TEXCOORD_2 is in the gltf spec, but we only support 2 uv sets. support more uv
+    // coordinates, skipping for now.
+    // if ( loaded ) { loaded = ReadSurfaceDataFromAccessor( attribs.uv2, modelFile,
+    // attributes.GetChildInt32ByName( "TEXCOORD_2", -1 ), ACCESSOR_VEC2, GL_FLOAT, static_cast<
+    // int >( attribs.position.size() ) ); }
+    // #TODO: get weights of type unsigned_byte and unsigned_short working.
+    if (loaded) {
+        loaded = ReadFloatAttribute(
+            attribs.jointWeights,
+            modelFile,
+            attributes.GetChildInt32ByName("WEIGHTS_0", -1),
+            ACCESSOR_VEC4,
+            numVertices);
+    }
+    // WEIGHT_0 can be either GL_UNSIGNED_SHORT or GL_BYTE
+    if (loaded) {
+        int jointIndex = attributes.GetChildInt32ByName("JOINTS_0", -1);
+        if (jointIndex >= 0 && jointIndex < static_cast<int>(modelFile.Accessors.size())) {
+            const ModelAccessor& acc = modelFile.Accessors[jointIndex];
+            if (acc.componentType == GL_UNSIGNED_SHORT) {
+                ReadJointIndices<unsigned short>(attribs.jointIndices, acc);
+            } else if (acc.componentType == GL_BYTE) {
+                ReadJointIndices<uint8_t>(attribs.jointIndices, acc);
+            } else if (acc.componentType == GL_FLOAT) {
+                // not officially in spec, but it's what our exporter spits out.
+                ReadJointIndices<float>(attribs.jointIndices, acc);
+            } else {
+                ALOGW(
+                    "invalid component type %d on joints_0 accessor on model %s",
+                    acc.componentType,
+                    modelFile.FileName.c_str());
+                loaded = false;
+            }
+
+            /// List unique joints
+            std::unordered_map<int, size_t> uniqueJoints;
+            for (const auto& index : attribs.jointIndices) {
+                for (int i = 0; i < 4; ++i) {
+                    int jointID = index[i];
+                    auto it = uniqueJoints.find(jointID);
+                    if (it == uniqueJoints.end()) {
+                        uniqueJoints[jointID] = 1u;
+                    } else {
+                        uniqueJoints[jointID] = uniqueJoints[jointID] + 1;
+                    }
+                }
+            }
+            /// print them
+            ALOGW("Enumerating skinning joints:");
+            for (const auto& u : uniqueJoints) {
+                ALOGW(" - joint: %02d count: %llu", u.first, u.second);
+            }
+        }
+    }
+
+    // TRIANGLES
+    const int indicesIndex = primitive.GetChildInt32ByName("indices", -1);
+    if (indicesIndex < 0 || indicesIndex >= static_cast<int>(modelFile.Accessors.size())) {
+        ALOGW("Error: Invalid indices index on gltfPrimitive");
+        loaded = false;
+    }
+
+    const int indexComponentType =
+        loaded ? modelFile.Accessors[indicesIndex].componentType : GL_UNSIGNED_SHORT;
+    if (indexComponentType == GL_UNSIGNED_INT) {
+        if (loaded) {
+            ReadSurfaceDataFromAccessor(
+                indices, modelFile, indicesIndex, ACCESSOR_SCALAR, GL_UNSIGNED_INT, -1);
+        }
+    } else if (indexComponentType == GL_UNSIGNED_SHORT) {
+        if (loaded) {
+            ReadIndices<uint16_t>(indices, modelFile, indicesIndex, GL_UNSIGNED_SHORT);
+        }
+    } else if (indexComponentType == GL_UNSIGNED_BYTE) {
+        if (loaded) {
+            ReadIndices<uint8_t>(indices, modelFile, indicesIndex, GL_UNSIGNED_BYTE);
+        }
+    } else {
+        ALOGW("Error: componentType %d is not supported for indices", indexComponentType);
+        loaded = false;
+    }
+
+    if (loaded && attribs.position.size() > (size_t)GlGeometry::GetMaxGeometryVertices32()) {
+        ALOGW(
+            "Error: %d vertices on surface %s, the limit is %d",
+            static_cast<int>(attribs.position.size()),
+            surfaceDef.surfaceName.c_str(),
+            GlGeometry::GetMaxGeometryVertices32());
+        loaded = false;
+    }
+}
+
+// glTF attributes that can be handed to GL as they are stored.
+struct ovrInterleavedAttribute {
+    const char* name;
+    int location;
+    ModelAccessorType type;
+    int components;
+};
+
+static const ovrInterleavedAttribute InterleavedAttributes[] = {
+    {"POSITION", VERTEX_ATTRIBUTE_LOCATION_POSITION, ACCESSOR_VEC3, 3},
+    {"NORMAL", VERTEX_ATTRIBUTE_LOCATION_NORMAL, ACCESSOR_VEC3, 3},
+    {"TANGENT", VERTEX_ATTRIBUTE_LOCATION_TANGENT, ACCESSOR_VEC3, 3},
+    {"BINORMAL", VERTEX_ATTRIBUTE_LOCATION_BINORMAL, ACCESSOR_VEC3, 3},
+    {"COLOR", VERTEX_ATTRIBUTE_LOCATION_COLOR, ACCESSOR_VEC4, 4},
+    {"TEXCOORD_0", VERTEX_ATTRIBUTE_LOCATION_UV0, ACCESSOR_VEC2, 2},
+    {"TEXCOORD_1", VERTEX_ATTRIBUTE_LOCATION_UV1, ACCESSOR_VEC2, 2},
+};
+
+// If all the attributes of a primitive are float attributes interleaved in a single bufferView,
+// creates the geometry straight from the source buffer, without reading the attributes into
+// VertexAttribs and packing them again. Returns false, without touching the geometry, if the
+// primitive doesn't qualify. Skinned primitives, sparse or normalized accessors and geometry
+// under a GlGeometry::TransformScope always take the regular path, which handles them. With
+// uploads the geometry is only recorded; the model owns the source buffers, so they outlive
+// the upload.
+static bool CreateInterleavedPrimitiveGeometry(
+    ModelFile& modelFile,
+    const OVR::JsonReader& primitive,
+    const OVR::JsonReader& attributes,
+    GlGeometry& geo,
+    ModelGeometryCache* geometryCache,
+    ModelGpuUploads* uploads,
+    uint32_t& surfaceFlags) {
+    // the source data goes to GL untouched, so nothing can be transformed
+    if (GlGeometry::TransformScope::IsEnabled()) {
+        return false;
+    }
+    const int numAccessors = static_cast<int>(modelFile.Accessors.size());
+    if (attributes.GetChildInt32ByName("JOINTS_0", -1) >= 0 ||
+        attributes.GetChildInt32ByName("WEIGHTS_0", -1) >= 0) {
+        return false;
+    }
+
+    const int positionIndex = attributes.GetChildInt32ByName("POSITION", -1);
+    if (positionIndex < 0 || positionIndex >= numAccessors) {
+        return false;
+    }
+    const ModelAccessor& position = modelFile.Accessors[positionIndex];
+    const ModelBufferView* view = position.bufferView;
+    if (view == nullptr || view->buffer == nullptr || view->buffer->bufferData == nullptr ||
+        view->byteStride <= 0 || !position.minMaxSet || position.count <= 0 ||
+        position.count > GlGeometry::GetMaxGeometryVertices32()) {
+        return false;
+    }
+    const int stride = view->byteStride;
+    const size_t vertexSize = (size_t)position.count * stride;
+    if (view->byteLength < vertexSize || view->buffer->byteLength < view->byteOffset + vertexSize) {
+        return false;
+    }
+
+    GlVertexAttribute layout[ModelGeometryCache::MAX_ATTRIBUTES];
+    int numAttributes = 0;
+    uint32_t flags = 0;
+    for (const ovrInterleavedAttribute& a : InterleavedAttributes) {
+        const int index = attributes.GetChildInt32ByName(a.name, -1);
+        if (index < 0) {
+            continue;
+        }
+        if (index >= numAccessors) {
+            return false;
+        }
+        const ModelAccessor& acc = modelFile.Accessors[index];
+        const size_t size = a.components * sizeof(float);
+        if (acc.bufferView != view || acc.type != a.type || acc.componentType != GL_FLOAT ||
+            acc.normalized || acc.sparseCount > 0 || acc.count != position.count ||
+            acc.byteOffset + size > (size_t)stride) {
+            return false;
+        }
+        GlVertexAttribute& attribute = layout[numAttributes++];
+        attribute.location = a.location;
+        attribute.glType = GL_FLOAT;
+        attribute.components = static_cast<uint16_t>(a.components);
+        attribute.normalized = 0;
+        attribute.offset = static_cast<uint32_t>(acc.byteOffset);
+        if (a.location == VERTEX_ATTRIBUTE_LOCATION_COLOR) {
+            flags |= ModelGeometryCache::SURFACE_FLAG_VERTEX_COLOR;
+        }
+    }
+
+    // indices have to be tightly packed to be used in place
+    const int indicesIndex = primitive.GetChildInt32ByName("indices", -1);
+    if (indicesIndex < 0 || indicesIndex >= numAccessors) {
+        return false;
+    }
+    const ModelAccessor& indexAccessor = modelFile.Accessors[indicesIndex];
+    const ModelBufferView* indexView = indexAccessor.bufferView;
+    const int indexComponentSize = (indexAccessor.componentType == GL_UNSIGNED_INT)
+        ? (int)sizeof(TriangleIndex32)
+        : (int)sizeof(TriangleIndex);
+    const size_t indexSize = (size_t)indexAccessor.count * indexComponentSize;
+    if (indexView == nullptr || indexView->buffer == nullptr ||
+        indexView->buffer->bufferData == nullptr || indexAccessor.type != ACCESSOR_SCALAR ||
+        indexAccessor.sparseCount > 0 ||
+        (indexAccessor.componentType != GL_UNSIGNED_SHORT &&
+         indexAccessor.componentType != GL_UNSIGNED_INT) ||
+        // 32 bit indices are only kept for geometry that needs them
+        (indexAccessor.componentType == GL_UNSIGNED_INT &&
+         position.count <= GlGeometry::GetMaxGeometryVertices()) ||
+        (indexView->byteStride != 0 && indexView->byteStride != indexComponentSize) ||
+        indexView->byteLength < indexAccessor.byteOffset + indexSize ||
+        indexView->buffer->byteLength <
+            indexView->byteOffset + indexAccessor.byteOffset + indexSize) {
+        return false;
+    }
+
+    const Bounds3f bounds(
+        Vector3f(position.floatMin[0], position.floatMin[1], position.floatMin[2]),
+        Vector3f(position.floatMax[0], position.floatMax[1], position.floatMax[2]));
+    const uint8_t* vertices = view->buffer->bufferData + view->byteOffset;
+    const void* indices = indexAccessor.BufferData();
+    if (uploads != nullptr) {
+        uploads->CreateInterleavedGeometry(
+            geo,
+            vertices,
+            position.count,
+            stride,
+            layout,
+            numAttributes,
+            indices,
+            indexAccessor.count,
+            bounds,
+            static_cast<unsigned>(indexAccessor.componentType));
+    } else {
+        geo.CreateInterleaved(
+            vertices,
+            position.count,
+            stride,
+            layout,
+            numAttributes,
+            indices,
+            indexAccessor.count,
+            bounds,
+            static_cast<unsigned>(indexAccessor.componentType));
+    }
+    if (geometryCache != nullptr) {
+        geometryCache->AddInterleavedSurface(
+            vertices,
+            position.count,
+            stride,
+            layout,
+            numAttributes,
+            indices,
+            indexAccessor.count,
+            geo,
+            flags);
+    }
+    surfaceFlags = flags;
+    return true;
+}
+
+// Sets up the GPU state, textures and program of a surface from its material.
+static void CreateGltfSurfaceCommand(
+    ModelSurface& surface,
+    const bool skinned,
+    const ModelGlPrograms& programs,
+    const MaterialParms& materialParms) {
+    const ModelMaterial* material = surface.material;
+    ovrGraphicsCommand& command = surface.surfaceDef.graphicsCommand;
+    if (material->alphaMode == ALPHA_MODE_MASK) {
+        // #TODO: implement ALPHA_MODE_MASK if we need it.
+        // Just blend because alpha testing is rather expensive.
+        ALOGW("gltfAlphaMode ALPHA_MODE_MASK requested, doing ALPHA_MODE_BLEND instead");
+        command.GpuState.blendEnable = ovrGpuState::BLEND_ENABLE;
+        command.GpuState.depthMaskEnable = false;
+        command.GpuState.blendSrc = GL_SRC_ALPHA;
+        command.GpuState.blendDst = GL_ONE_MINUS_SRC_ALPHA;
+    } else if (material->alphaMode == ALPHA_MODE_BLEND || materialParms.Transparent) {
+        if (materialParms.Transparent && material->alphaMode != ALPHA_MODE_BLEND) {
+            ALOGW(
+                "gltfAlphaMode is %d but treating at ALPHA_MODE_BLEND due to materialParms.Transparent",
+                material->alphaMode);
+        }
+        command.GpuState.blendEnable = ovrGpuState::BLEND_ENABLE;
+        command.GpuState.depthMaskEnable = false;
+        command.GpuState.blendSrc = GL_SRC_ALPHA;
+        command.GpuState.blendDst = GL_ONE_MINUS_SRC_ALPHA;
+    }
+    // #TODO: GLTF doesn't have a concept of an ADDITIVE mode. maybe it should?
+    // else if ( material->alphaMode == MATERIAL_TYPE_ADDITIVE )
+    //{
+    //	command.GpuState.blendEnable = ovrGpuState::BLEND_ENABLE;
+    //	command.GpuState.depthMaskEnable = false;
+    //	command.GpuState.blendSrc = GL_ONE;
+    //	command.GpuState.blendDst = GL_ONE;
+    //}
+    else if (material->alphaMode == ALPHA_MODE_OPAQUE) {
+        // default GpuState;
+    }
+
+    if (material->baseColorTextureWrapper != nullptr) {
+        command.Textures[0] = material->baseColorTextureWrapper->image->texid;
+
+        if (material->emissiveTextureWrapper != nullptr) {
+            if (programs.ProgBaseColorEmissivePBR == nullptr) {
+                ALOGE_FAIL("No ProgBaseColorEmissivePBR set");
+            }
+            command.Textures[1] = material->emissiveTextureWrapper->image->texid;
+
+            if (skinned) {
+                if (programs.ProgSkinnedBaseColorEmissivePBR == nullptr) {
+                    ALOGE_FAIL("No ProgSkinnedBaseColorEmissivePBR set");
+                }
+
+                command.Program = *programs.ProgSkinnedBaseColorEmissivePBR;
+                surface.surfaceDef.surfaceName = "ProgSkinnedBaseColorEmissivePBR";
+            } else {
+                command.Program = *programs.ProgBaseColorEmissivePBR;
+                surface.surfaceDef.surfaceName = "ProgBaseColorEmissivePBR";
+            }
+        } else {
+            if (skinned) {
+                if (programs.ProgSkinnedBaseColorPBR == nullptr) {
+                    ALOGE_FAIL("No ProgSkinnedBaseColorPBR set");
+                }
+                command.Program = *programs.ProgSkinnedBaseColorPBR;
+                surface.surfaceDef.surfaceName = "ProgSkinnedBaseColorPBR";
+            } else {
+                if (programs.ProgBaseColorPBR == nullptr) {
+                    ALOGE_FAIL("No ProgBaseColorPBR set");
+                }
+                command.Program = *programs.ProgBaseColorPBR;
+                surface.surfaceDef.surfaceName = "ProgBaseColorPBR";
+            }
+        }
+    } else {
+        if (skinned) {
+            if (programs.ProgSkinnedSimplePBR == nullptr) {
+                ALOGE_FAIL("No ProgSkinnedSimplePBR set");
+            }
+            command.Program = *programs.ProgSkinnedSimplePBR;
+            surface.surfaceDef.surfaceName = "ProgSkinnedSimplePBR";
+        } else {
+            if (programs.ProgSimplePBR == nullptr) {
+                ALOGE_FAIL("No ProgSimplePBR set");
+            }
+            command.Program = *programs.ProgSimplePBR;
+            surface.surfaceDef.surfaceName = "ProgSimplePBR";
+        }
+    }
+
+    if (materialParms.PolygonOffset) {
+        command.GpuState.polygonOffsetEnable = true;
+    }
+
+    if (material->doubleSided) {
+        command.GpuState.cullEnable = false;
+    }
+}
+
+//==============================================================
+// glTF scene descriptions
+// Cooking a glTF model stores what the JSON loader builds, apart from the images and the
+// geometry the cache keeps itself, as the cooked file's scene description. Pointers between the
+// model's arrays are stored as indices, -1 for none. Cooked loads read the description instead
+// of parsing the JSON, and only go back to the zip or glB data for the images.
+
+enum ovrGltfImageSourceType {
+    GLTF_IMAGE_SOURCE_DEFAULT,
+    GLTF_IMAGE_SOURCE_ZIP_ENTRY,
+    GLTF_IMAGE_SOURCE_BUFFER_VIEW
+};
+
+// Where the loader found the image of a ModelTexture.
+struct ovrGltfImageSource {
+    ovrGltfImageSource(
+        const ovrGltfImageSourceType type,
+        const std::string& name,
+        const int bufferView)
+        : Type(type), Name(name), BufferView(bufferView) {}
+
+    ovrGltfImageSourceType Type;
+    std::string Name; // as passed to LoadModelFileTexture()
+    int BufferView;
+};
+
+static ModelGeometryCache* GetGltfGeometryCache(
+    const ModelGeo* outModelGeo,
+    const ModelLoadContext& context) {
+    // the cache only stores what GlGeometry needs, so loads that want the source geometry back
+    // always read it, and geometry moved by a GlGeometry::TransformScope is never stored
+    if (outModelGeo != nullptr || GlGeometry::TransformScope::IsEnabled()) {
+        return nullptr;
+    }
+    return context.Cache;
+}
+
+template <typename _type_>
+static int32_t GltfIndexOf(const _type_* element, const std::vector<_type_>& elements) {
+    return (element == nullptr) ? -1 : static_cast<int32_t>(element - elements.data());
+}
+
+// Reads an index into an array of count elements; -1 is only allowed if optional.
+static int32_t ReadGltfIndex(ModelCacheReader& reader, const size_t count, const bool optional) {
+    const int32_t index = reader.Read<int32_t>();
+    if (index < (optional ? -1 : 0) || index >= static_cast<int32_t>(count)) {
+        reader.Fail();
+        return -1;
+    }
+    return index;
+}
+
+template <typename _type_>
+static _type_* ReadGltfElement(ModelCacheReader& reader, std::vector<_type_>& elements) {
+    const int32_t index = ReadGltfIndex(reader, elements.size(), true);
+    return (index < 0) ? nullptr : &elements[index];
+}
+
+static void WriteGltfScene(
+    const ModelFile& modelFile,
+    const std::vector<ovrGltfImageSource>& imageSources,
+    ModelGeometryCache& cache) {
+    if (imageSources.size() != modelFile.Textures.size()) {
+        // only the geometry is cooked
+        return;
+    }
+    std::vector<uint8_t> scene;
+    ModelCacheWriter writer(scene);
+
+    writer.Write(static_cast<uint32_t>(modelFile.Buffers.size()));
+    for (const ModelBuffer& buffer : modelFile.Buffers) {
+        writer.WriteString(buffer.name);
+        writer.WriteBytes(buffer.bufferData, buffer.byteLength);
+    }
+    writer.Write(static_cast<uint32_t>(modelFile.BufferViews.size()));
+    for (const ModelBufferView& view : modelFile.BufferViews) {
+        writer.WriteString(view.name);
+        writer.Write(GltfIndexOf(view.buffer, modelFile.Buffers));
+        writer.Write(static_cast<uint64_t>(view.byteOffset));
+        writer.Write(static_cast<uint64_t>(view.byteLength));
+        writer.Write(view.byteStride);
+        writer.Write(view.target);
+    }
+    writer.Write(static_cast<uint32_t>(modelFile.Accessors.size()));
+    for (const ModelAccessor& accessor : modelFile.Accessors) {
+        writer.WriteString(accessor.name);
+        writer.Write(GltfIndexOf(accessor.bufferView, modelFile.BufferViews));
+        writer.Write(static_cast<uint64_t>(accessor.byteOffset));
+        writer.Write(accessor.componentType);
+        writer.Write(accessor.count);
+        writer.Write(accessor.type);
+        writer.Write(accessor.minMaxSet);
+        writer.Write(accessor.intMin);
+        writer.Write(accessor.intMax);
+        writer.Write(accessor.floatMin);
+        writer.Write(accessor.floatMax);
+        writer.Write(accessor.normalized);
+        writer.Write(accessor.sparseCount);
+        writer.Write(GltfIndexOf(accessor.sparseIndicesBufferView, modelFile.BufferViews));
+        writer.Write(static_cast<uint64_t>(accessor.sparseIndicesByteOffset));
+        writer.Write(accessor.sparseIndicesComponentType);
+        writer.Write(GltfIndexOf(accessor.sparseValuesBufferView, modelFile.BufferViews));
+        writer.Write(static_cast<uint64_t>(accessor.sparseValuesByteOffset));
+    }
+
+    writer.Write(static_cast<uint32_t>(imageSources.size()));
+    for (const ovrGltfImageSource& source : imageSources) {
+        writer.Write(source.Type);
+        writer.WriteString(source.Name);
+        writer.Write(static_cast<int32_t>(source.BufferView));
+    }
+    writer.Write(static_cast<uint32_t>(modelFile.Samplers.size()));
+    for (const ModelSampler& sampler : modelFile.Samplers) {
+        writer.WriteString(sampler.name);
+        writer.Write(sampler.magFilter);
+        writer.Write(sampler.minFilter);
+        writer.Write(sampler.wrapS);
+        writer.Write(sampler.wrapT);
+    }
+    writer.Write(static_cast<uint32_t>(modelFile.TextureWrappers.size()));
+    for (const ModelTextureWrapper& wrapper : modelFile.TextureWrappers) {
+        writer.WriteString(wrapper.name);
+        writer.Write(GltfIndexOf(wrapper.image, modelFile.Textures));
+        writer.Write(GltfIndexOf(wrapper.sampler, modelFile.Samplers));
+    }
+    writer.Write(static_cast<uint32_t>(modelFile.Materials.size()));
+    for (const ModelMaterial& material : modelFile.Materials) {
+        const std::vector<ModelTextureWrapper>& wrappers = modelFile.TextureWrappers;
+        writer.WriteString(material.name);
+        writer.Write(GltfIndexOf(material.baseColorTextureWrapper, wrappers));
+        writer.Write(GltfIndexOf(material.metallicRoughnessTextureWrapper, wrappers));
+        writer.Write(GltfIndexOf(material.normalTextureWrapper, wrappers));
+        writer.Write(GltfIndexOf(material.occlusionTextureWrapper, wrappers));
+        writer.Write(GltfIndexOf(material.emissiveTextureWrapper, wrappers));
+        writer.Write(material.baseColorFactor);
+        writer.Write(material.emmisiveFactor);
+        writer.Write(material.metallicFactor);
+        writer.Write(material.roughnessFactor);
+        writer.Write(material.alphaCutoff);
+        writer.Write(material.alphaMode);
+        writer.Write(material.normalTexCoord);
+        writer.Write(material.normalScale);
+        writer.Write(material.occlusionTexCoord);
+        writer.Write(material.occlusionStrength);
+        writer.Write(material.doubleSided);
+    }
+
+    // the surface geometry is the cache's, in the same order
+    writer.Write(static_cast<uint32_t>(modelFile.Models.size()));
+    for (const Model& model : modelFile.Models) {
+        writer.WriteString(model.name);
+        writer.WriteArray(model.weights);
+        writer.Write(static_cast<uint32_t>(model.surfaces.size()));
+        for (const ModelSurface& surface : model.surfaces) {
+            writer.Write(GltfIndexOf(surface.material, modelFile.Materials));
+        }
+    }
+    writer.Write(static_cast<uint32_t>(modelFile.Cameras.size()));
+    for (const ModelCamera& camera : modelFile.Cameras) {
+        writer.WriteString(camera.name);
+        writer.Write(camera.type);
+        writer.Write(camera.perspective);
+        writer.Write(camera.orthographic);
+    }
+    writer.Write(static_cast<uint32_t>(modelFile.Nodes.size()));
+    for (const ModelNode& node : modelFile.Nodes) {
+        writer.WriteString(node.name);
+        writer.WriteString(node.jointName);
+        writer.Write(node.rotation);
+        writer.Write(node.translation);
+        writer.Write(node.scale);
+        writer.WriteArray(node.children);
+        writer.Write(static_cast<int32_t>(node.parentIndex));
+        writer.Write(static_cast<int32_t>(node.skinIndex));
+        writer.Write(GltfIndexOf(node.camera, modelFile.Cameras));
+        writer.Write(GltfIndexOf(node.model, modelFile.Models));
+    }
+
+    writer.Write(static_cast<uint32_t>(modelFile.Animations.size()));
+    for (const ModelAnimation& animation : modelFile.Animations) {
+        writer.WriteString(animation.name);
+        writer.Write(static_cast<uint32_t>(animation.samplers.size()));
+        for (const ModelAnimationSampler& sampler : animation.samplers) {
+            writer.Write(GltfIndexOf(sampler.input, modelFile.Accessors));
+            writer.Write(GltfIndexOf(sampler.output, modelFile.Accessors));
+            writer.Write(static_cast<int32_t>(sampler.timeLineIndex));
+            writer.Write(sampler.interpolation);
+        }
+        writer.Write(static_cast<uint32_t>(animation.channels.size()));
+        for (const ModelAnimationChannel& channel : animation.channels) {
+            writer.Write(static_cast<int32_t>(channel.nodeIndex));
+            writer.Write(GltfIndexOf(channel.sampler, animation.samplers));
+            writer.Write(channel.path);
+        }
+    }
+    writer.Write(static_cast<uint32_t>(modelFile.AnimationTimeLines.size()));
+    for (const ModelAnimationTimeLine& timeLine : modelFile.AnimationTimeLines) {
+        writer.Write(GltfIndexOf(timeLine.accessor, modelFile.Accessors));
+    }
+    writer.Write(modelFile.animationStartTime);
+    writer.Write(modelFile.animationEndTime);
+
+    writer.Write(static_cast<uint32_t>(modelFile.Skins.size()));
+    for (const ModelSkin& skin : modelFile.Skins) {
+        writer.WriteString(skin.name);
+        writer.Write(static_cast<int32_t>(skin.skeletonRootIndex));
+        writer.WriteArray(skin.jointIndexes);
+        writer.Write(GltfIndexOf(skin.inverseBindMatricesAccessor, modelFile.Accessors));
+        writer.WriteArray(skin.inverseBindMatrices);
+    }
+    writer.Write(static_cast<uint32_t>(modelFile.SubScenes.size()));
+    for (const ModelSubScene& subScene : modelFile.SubScenes) {
+        writer.WriteString(subScene.name);
+        writer.WriteArray(subScene.nodes);
+        writer.Write(subScene.visible);
+    }
+
+    cache.SetScene(std::move(scene));
+}
+
+// Loads the image of a texture from where the source load found it.
+static void LoadGltfImage(
+    ModelFile& modelFile,
+    const ovrGltfImageSource& source,
+    unzFile zfp,
+    const char* fileData,
+    const int fileDataLength,
+    const MaterialParms& materialParms,
+    const ModelLoadContext& context) {
+    const char* const name = source.Name.c_str();
+    if (source.Type == GLTF_IMAGE_SOURCE_BUFFER_VIEW) {
+        const ModelBufferView& view = modelFile.BufferViews[source.BufferView];
+        LoadModelFileTexture(
+            modelFile,
+            name,
+            (const char*)(view.buffer->bufferData + view.byteOffset),
+            (int)view.byteLength,
+            materialParms,
+            context);
+    } else if (
+        source.Type == GLTF_IMAGE_SOURCE_ZIP_ENTRY && zfp != nullptr &&
+        (context.DecodedTextures == nullptr || context.DecodedTextures->Find(name) == nullptr)) {
+        int bufferLength = 0;
+        uint8_t* buffer =
+            ReadFileBufferFromZipFile(zfp, name, bufferLength, (const uint8_t*)fileData);
+        LoadModelFileTexture(
+            modelFile, name, (const char*)buffer, bufferLength, materialParms, context);
+        // stored entries are read in place
+        if (buffer != nullptr &&
+            (buffer < (const uint8_t*)fileData ||
+             buffer >= (const uint8_t*)fileData + fileDataLength)) {
+            delete[] buffer;
+        }
+    } else {
+        // default images, and images that were decoded on the loader threads
+        LoadModelFileTexture(modelFile, name, nullptr, 0, materialParms, context);
+    }
+}
+
+// Rebuilds a model from its scene description and the cooked geometry. zfp is the zip the
+// images are in, if they are in one; fileData is the zip or glB file.
+static bool ReadGltfScene(
+    ModelFile& modelFile,
+    const uint8_t* scene,
+    const size_t sceneSize,
+    ModelGeometryCache& cache,
+    unzFile zfp,
+    const char* fileData,
+    const int fileDataLength,
+    const ModelGlPrograms& programs,
+    const MaterialParms& materialParms,
+    const ModelLoadContext& context) {
+    ModelCacheReader reader(scene, sceneSize);
+
+    // the arrays are sized before they are filled, so pointers into them stay valid
+    modelFile.Buffers.resize(reader.ReadCount(sizeof(uint32_t) * 2));
+    for (ModelBuffer& buffer : modelFile.Buffers) {
+        buffer.name = reader.ReadString();
+        size_t byteLength = 0;
+        const uint8_t* bytes = reader.ReadBytes(byteLength);
+        // aligned, and zero terminated like the source buffers
+        buffer.byteLength = byteLength;
+        buffer.bufferData = (uint8_t*)(new float[byteLength / 4 + 1]);
+        memcpy(buffer.bufferData, bytes, byteLength);
+        buffer.bufferData[byteLength] = '\0';
+    }
+    modelFile.BufferViews.resize(reader.ReadCount(sizeof(uint32_t)));
+    for (ModelBufferView& view : modelFile.BufferViews) {
+        view.name = reader.ReadString();
+        view.buffer = ReadGltfElement(reader, modelFile.Buffers);
+        view.byteOffset = static_cast<size_t>(reader.Read<uint64_t>());
+        view.byteLength = static_cast<size_t>(reader.Read<uint64_t>());
+        reader.Read(view.byteStride);
+        reader.Read(view.target);
+        if (view.buffer == nullptr || view.byteOffset > view.buffer->byteLength ||
+            view.byteLength > view.buffer->byteLength - view.byteOffset) {
+            reader.Fail();
+        }
+    }
+    modelFile.Accessors.resize(reader.ReadCount(sizeof(uint32_t)));
+    for (ModelAccessor& accessor : modelFile.Accessors) {
+        accessor.name = reader.ReadString();
+        accessor.bufferView = ReadGltfElement(reader, modelFile.BufferViews);
+        accessor.byteOffset = static_cast<size_t>(reader.Read<uint64_t>());
+        reader.Read(accessor.componentType);
+        reader.Read(accessor.count);
+        reader.Read(accessor.type);
+        reader.Read(accessor.minMaxSet);
+        reader.Read(accessor.intMin);
+        reader.Read(accessor.intMax);
+        reader.Read(accessor.floatMin);
+        reader.Read(accessor.floatMax);
+        reader.Read(accessor.normalized);
+        reader.Read(accessor.sparseCount);
+        accessor.sparseIndicesBufferView = ReadGltfElement(reader, modelFile.BufferViews);
+        accessor.sparseIndicesByteOffset = static_cast<size_t>(reader.Read<uint64_t>());
+        reader.Read(accessor.sparseIndicesComponentType);
+        accessor.sparseValuesBufferView = ReadGltfElement(reader, modelFile.BufferViews);
+        accessor.sparseValuesByteOffset = static_cast<size_t>(reader.Read<uint64_t>());
+    }
+
+    std::vector<ovrGltfImageSource> imageSources;
+    const uint32_t numImages = reader.ReadCount(sizeof(uint32_t));
+    for (uint32_t i = 0; i < numImages && !reader.HasFailed(); i++) {
+        const ovrGltfImageSourceType type = reader.Read<ovrGltfImageSourceType>();
+        const std::string name = reader.ReadString();
+        const int32_t bufferView = reader.Read<int32_t>();
+        if ((type == GLTF_IMAGE_SOURCE_BUFFER_VIEW &&
+             (bufferView < 0 || bufferView >= static_cast<int>(modelFile.BufferViews.size()))) ||
+            type < GLTF_IMAGE_SOURCE_DEFAULT || type > GLTF_IMAGE_SOURCE_BUFFER_VIEW) {
+            reader.Fail();
+        }
+        imageSources.emplace_back(type, name, bufferView);
+    }
+    if (reader.HasFailed()) {
+        return false;
+    }
+    for (const ovrGltfImageSource& source : imageSources) {
+        LoadGltfImage(modelFile, source, zfp, fileData, fileDataLength, materialParms, context);
+    }
+
+    modelFile.Samplers.resize(reader.ReadCount(sizeof(uint32_t)));
+    for (ModelSampler& sampler : modelFile.Samplers) {
+        sampler.name = reader.ReadString();
+        reader.Read(sampler.magFilter);
+        reader.Read(sampler.minFilter);
+        reader.Read(sampler.wrapS);
+        reader.Read(sampler.wrapT);
+    }
+    modelFile.TextureWrappers.resize(reader.ReadCount(sizeof(uint32_t)));
+    for (ModelTextureWrapper& wrapper : modelFile.TextureWrappers) {
+        wrapper.name = reader.ReadString();
+        wrapper.image = ReadGltfElement(reader, modelFile.Textures);
+        wrapper.sampler = ReadGltfElement(reader, modelFile.Samplers);
+    }
+    modelFile.Materials.resize(reader.ReadCount(sizeof(uint32_t)));
+    for (ModelMaterial& material : modelFile.Materials) {
+        std::vector<ModelTextureWrapper>& wrappers = modelFile.TextureWrappers;
+        material.name = reader.ReadString();
+        material.baseColorTextureWrapper = ReadGltfElement(reader, wrappers);
+        material.metallicRoughnessTextureWrapper = ReadGltfElement(reader, wrappers);
+        material.normalTextureWrapper = ReadGltfElement(reader, wrappers);
+        material.occlusionTextureWrapper = ReadGltfElement(reader, wrappers);
+        material.emissiveTextureWrapper = ReadGltfElement(reader, wrappers);
+        reader.Read(material.baseColorFactor);
+        reader.Read(material.emmisiveFactor);
+        reader.Read(material.metallicFactor);
+        reader.Read(material.roughnessFactor);
+        reader.Read(material.alphaCutoff);
+        reader.Read(material.alphaMode);
+        reader.Read(material.normalTexCoord);
+        reader.Read(material.normalScale);
+        reader.Read(material.occlusionTexCoord);
+        reader.Read(material.occlusionStrength);
+        reader.Read(material.doubleSided);
+        if (material.baseColorTextureWrapper != nullptr &&
+            material.baseColorTextureWrapper->image == nullptr) {
+            reader.Fail();
+        }
+    }
+
+    modelFile.Models.resize(reader.ReadCount(sizeof(uint32_t) * 3));
+    for (Model& model : modelFile.Models) {
+        model.name = reader.ReadString();
+        reader.ReadArray(model.weights);
+        model.surfaces.resize(reader.ReadCount(sizeof(int32_t)));
+        for (ModelSurface& surface : model.surfaces) {
+            const int32_t material =
+                ReadGltfIndex(reader, modelFile.Materials.size(), false);
+            if (reader.HasFailed()) {
+                return false;
+            }
+            surface.material = &modelFile.Materials[material];
+            uint32_t surfaceFlags = 0;
+            if (!cache.CreateNextSurface(surface.surfaceDef.geo, surfaceFlags, context.Uploads)) {
+                return false;
+            }
+            const bool skinned = (surfaceFlags & ModelGeometryCache::SURFACE_FLAG_SKINNED) != 0;
+            CreateGltfSurfaceCommand(surface, skinned, programs, materialParms);
+        }
+    }
+    modelFile.Cameras.resize(reader.ReadCount(sizeof(uint32_t)));
+    for (ModelCamera& camera : modelFile.Cameras) {
+        camera.name = reader.ReadString();
+        reader.Read(camera.type);
+        reader.Read(camera.perspective);
+        reader.Read(camera.orthographic);
+    }
+    modelFile.Nodes.resize(reader.ReadCount(sizeof(uint32_t) * 2));
+    for (ModelNode& node : modelFile.Nodes) {
+        const size_t numNodes = modelFile.Nodes.size();
+        node.name = reader.ReadString();
+        node.jointName = reader.ReadString();
+        reader.Read(node.rotation);
+        reader.Read(node.translation);
+        reader.Read(node.scale);
+        reader.ReadArray(node.children);
+        for (const int child : node.children) {
+            if (child < 0 || child >= static_cast<int>(numNodes)) {
+                reader.Fail();
+            }
+        }
+        node.parentIndex = ReadGltfIndex(reader, numNodes, true);
+        node.skinIndex = reader.Read<int32_t>();
+        node.camera = ReadGltfElement(reader, modelFile.Cameras);
+        node.model = ReadGltfElement(reader, modelFile.Models);
+
+        Matrix4f localTransform;
+        CalculateTransformFromRTS(&localTransform, node.rotation, node.translation, node.scale);
+        node.SetLocalTransform(localTransform);
+    }
+
+    modelFile.Animations.resize(reader.ReadCount(sizeof(uint32_t) * 3));
+    for (ModelAnimation& animation : modelFile.Animations) {
+        animation.name = reader.ReadString();
+        animation.samplers.resize(reader.ReadCount(sizeof(int32_t) * 4));
+        for (ModelAnimationSampler& sampler : animation.samplers) {
+            sampler.input = ReadGltfElement(reader, modelFile.Accessors);
+            sampler.output = ReadGltfElement(reader, modelFile.Accessors);
+            sampler.timeLineIndex = reader.Read<int32_t>();
+            reader.Read(sampler.interpolation);
+            if (sampler.input == nullptr || sampler.output == nullptr) {
+                reader.Fail();
+            }
+        }
+        animation.channels.resize(reader.ReadCount(sizeof(int32_t) * 3));
+        for (ModelAnimationChannel& channel : animation.channels) {
+            channel.nodeIndex = ReadGltfIndex(reader, modelFile.Nodes.size(), true);
+            channel.sampler = ReadGltfElement(reader, animation.samplers);
+            reader.Read(channel.path);
+            if (channel.sampler == nullptr) {
+                reader.Fail();
+            }
+        }
+    }
+    modelFile.AnimationTimeLines.resize(reader.ReadCount(sizeof(int32_t)));
+    for (ModelAnimationTimeLine& timeLine : modelFile.AnimationTimeLines) {
+        const ModelAccessor* accessor = ReadGltfElement(reader, modelFile.Accessors);
+        // Initialize() reads the sample times from the buffer
+        if (accessor == nullptr || accessor->count <= 0 || accessor->bufferView == nullptr ||
+            accessor->byteOffset + accessor->count * sizeof(float) >
+                accessor->bufferView->byteLength) {
+            reader.Fail();
+            break;
+        }
+        timeLine.Initialize(accessor);
+    }
+    reader.Read(modelFile.animationStartTime);
+    reader.Read(modelFile.animationEndTime);
+    for (const ModelAnimation& animation : modelFile.Animations) {
+        for (const ModelAnimationSampler& sampler : animation.samplers) {
+            if (sampler.timeLineIndex < 0 ||
+                sampler.timeLineIndex >= static_cast<int>(modelFile.AnimationTimeLines.size())) {
+                reader.Fail();
+            }
+        }
+    }
+
+    modelFile.Skins.resize(reader.ReadCount(sizeof(uint32_t) * 3));
+    for (ModelSkin& skin : modelFile.Skins) {
+        skin.name = reader.ReadString();
+        skin.skeletonRootIndex = reader.Read<int32_t>();
+        reader.ReadArray(skin.jointIndexes);
+        for (const int joint : skin.jointIndexes) {
+            if (joint < 0 || joint >= static_cast<int>(modelFile.Nodes.size())) {
+                reader.Fail();
+            }
+        }
+        skin.inverseBindMatricesAccessor = ReadGltfElement(reader, modelFile.Accessors);
+        reader.ReadArray(skin.inverseBindMatrices);
+    }
+    for (const ModelNode& node : modelFile.Nodes) {
+        if (node.skinIndex < -1 || node.skinIndex >= static_cast<int>(modelFile.Skins.size())) {
+            reader.Fail();
+        }
+    }
+    modelFile.SubScenes.resize(reader.ReadCount(sizeof(uint32_t) * 2));
+    for (ModelSubScene& subScene : modelFile.SubScenes) {
+        subScene.name = reader.ReadString();
+        reader.ReadArray(subScene.nodes);
+        for (const int node : subScene.nodes) {
+            if (node < 0 || node >= static_cast<int>(modelFile.Nodes.size())) {
+                reader.Fail();
+            }
+        }
+        reader.Read(subScene.visible);
+    }
+    if (!reader.IsAtEnd()) {
+        return false;
+    }
+
+    // Calculate the nodes global transforms;
+    for (const ModelSubScene& subScene : modelFile.SubScenes) {
+        for (const int node : subScene.nodes) {
+            modelFile.Nodes[node].RecalculateGlobalTransform(modelFile);
+        }
+    }
+    return true;
+}
+
 // Requires the buffers and images to already be loaded in the model
 bool LoadModelFile_glTF_Json(
     ModelFile& modelFile,
     const char* modelsJson,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo) {
+    ModelGeo* outModelGeo,
+    const ModelLoadContext& context) {
     ALOG("LoadModelFile_glTF_Json parsing %s", modelFile.FileName.c_str());
 
+    ModelGeometryCache* const geometryCache = GetGltfGeometryCache(outModelGeo, context);
+
     // LOGCPUTIME( "LoadModelFile_glTF_Json" );
 
     bool loaded = true;
@@ -324,6 +1440,48 @@ bool LoadModelFile_glTF_Json(
                                 newGltfAccessor.minMaxSet = true;
                             }
 
+                            const OVR::JsonReader sparse(accessor.GetChildByName("sparse"));
+                            if (loaded && sparse.IsObject()) {
+                                const OVR::JsonReader sparseIndices(
+                                    sparse.GetChildByName("indices"));
+                                const OVR::JsonReader sparseValues(
+                                    sparse.GetChildByName("values"));
+                                const int numViews = static_cast<int>(modelFile.BufferViews.size());
+                                const int indicesView = sparseIndices.IsObject()
+                                    ? sparseIndices.GetChildInt32ByName("bufferView", -1)
+                                    : -1;
+                                const int valuesView = sparseValues.IsObject()
+                                    ? sparseValues.GetChildInt32ByName("bufferView", -1)
+                                    : -1;
+                                newGltfAccessor.sparseCount = sparse.GetChildInt32ByName("count");
+                                newGltfAccessor.sparseIndicesComponentType =
+                                    sparseIndices.IsObject()
+                                    ? sparseIndices.GetChildInt32ByName("componentType")
+                                    : 0;
+                                if (newGltfAccessor.sparseCount <= 0 ||
+                                    newGltfAccessor.sparseCount > newGltfAccessor.count ||
+                                    indicesView < 0 || indicesView >= numViews ||
+                                    valuesView < 0 || valuesView >= numViews ||
+                                    (newGltfAccessor.sparseIndicesComponentType !=
+                                         GL_UNSIGNED_BYTE &&
+                                     newGltfAccessor.sparseIndicesComponentType !=
+                                         GL_UNSIGNED_SHORT &&
+                                     newGltfAccessor.sparseIndicesComponentType !=
+                                         GL_UNSIGNED_INT)) {
+                                    ALOGW("Error: Invalid sparse in gltfAccessor");
+                                    loaded = false;
+                                } else {
+                                    newGltfAccessor.sparseIndicesBufferView =
+                                        &modelFile.BufferViews[indicesView];
+                                    newGltfAccessor.sparseIndicesByteOffset =
+                                        sparseIndices.GetChildInt32ByName("byteOffset");
+                                    newGltfAccessor.sparseValuesBufferView =
+                                        &modelFile.BufferViews[valuesView];
+                                    newGltfAccessor.sparseValuesByteOffset =
+                                        sparseValues.GetChildInt32ByName("byteOffset");
+                                }
+                            }
+
                             newGltfAccessor.bufferView = &modelFile.BufferViews[bufferView];
                             modelFile.Accessors.push_back(newGltfAccessor);
 
@@ -589,11 +1747,11 @@ bool LoadModelFile_glTF_Json(
                             modelFile.Materials.push_back(newGltfMaterial);
                         }
                     }
-                    // Add a default material at the end of the list for primitives with an
-                    // unspecified material.
-                    ModelMaterial defaultmaterial;
-                    modelFile.Materials.push_back(defaultmaterial);
                 }
+                // Add a default material at the end of the list for primitives with an
+                // unspecified material, also when the file has no materials at all.
+                ModelMaterial defaultmaterial;
+                modelFile.Materials.push_back(defaultmaterial);
             } // END MATERIALS
 
             if (loaded) { // MODELS (gltf mesh)
@@ -668,402 +1826,97 @@ bool LoadModelFile_glTF_Json(
                                         loaded = false;
                                     }
 
-                                    TriangleIndex outGeoIndexOffset = 0;
+                                    TriangleIndex32 outGeoIndexOffset = 0;
                                     if (outModelGeo != nullptr) {
-                                        outGeoIndexOffset = static_cast<TriangleIndex>(
+                                        outGeoIndexOffset = static_cast<TriangleIndex32>(
                                             (*outModelGeo).positions.size());
                                     }
 
                                     // VERTICES
                                     VertexAttribs attribs;
-
-                                    { // POSITION and BOUNDS
-                                        const int positionIndex =
-                                            attributes.GetChildInt32ByName("POSITION", -1);
-                                        if (positionIndex < 0) {
-                                            ALOGW("Error: Invalid position index on gltfPrimitive");
-                                            loaded = false;
-                                        }
-
-                                        loaded = ReadSurfaceDataFromAccessor(
-                                            attribs.position,
-                                            modelFile,
-                                            positionIndex,
-                                            ACCESSOR_VEC3,
-                                            GL_FLOAT,
-                                            -1);
-
-                                        const ModelAccessor* positionAccessor =
-                                            &modelFile.Accessors[positionIndex];
-                                        if (positionAccessor == nullptr) {
-                                            ALOGW(
-                                                "Error: Invalid positionAccessor on surface %s",
-                                                newGltfSurface.surfaceDef.surfaceName.c_str());
-                                            loaded = false;
-                                        } else if (!positionAccessor->minMaxSet) {
-                                            ALOGW(
-                                                "Error: no min and max set on positionAccessor on surface %s",
-                                                newGltfSurface.surfaceDef.surfaceName.c_str());
-                                            loaded = false;
-                                        } else {
-                                            Vector3f min;
-                                            min.x = positionAccessor->floatMin[0];
-                                            min.y = positionAccessor->floatMin[1];
-                                            min.z = positionAccessor->floatMin[2];
-                                            newGltfSurface.surfaceDef.geo.localBounds.AddPoint(min);
-
-                                            Vector3f max;
-                                            max.x = positionAccessor->floatMax[0];
-                                            max.y = positionAccessor->floatMax[1];
-                                            max.z = positionAccessor->floatMax[2];
-                                            newGltfSurface.surfaceDef.geo.localBounds.AddPoint(max);
-                                        }
-                                    }
-
-                                    const int numVertices =
-                                        static_cast<int>(attribs.position.size());
-                                    if (loaded) {
-                                        loaded = ReadSurfaceDataFromAccessor(
-                                            attribs.normal,
-                                            modelFile,
-                                            attributes.GetChildInt32ByName("NORMAL", -1),
-                                            ACCESSOR_VEC3,
-                                            GL_FLOAT,
-                                            numVertices);
-                                    }
-                                    // #TODO:  we have tangent as a vec3, the spec has it as a vec4.
-                                    // so we will have to one off the loading of it.
-                                    if (loaded) {
-                                        loaded = ReadSurfaceDataFromAccessor(
-                                            attribs.tangent,
-                                            modelFile,
-                                            attributes.GetChildInt32ByName("TANGENT", -1),
-                                            ACCESSOR_VEC3,
-                                            GL_FLOAT,
-                                            numVertices);
-                                    }
-                                    if (loaded) {
-                                        loaded = ReadSurfaceDataFromAccessor(
-                                            attribs.binormal,
-                                            modelFile,
-                                            attributes.GetChildInt32ByName("BINORMAL", -1),
-                                            ACCESSOR_VEC3,
-                                            GL_FLOAT,
-                                            numVertices);
-                                    }
-                                    if (loaded) {
-                                        loaded = ReadSurfaceDataFromAccessor(
-                                            attribs.color,
+                                    std::vector<TriangleIndex32> indices;
+                                    uint32_t surfaceFlags = 0;
+                                    // cooked geometry first, then source data that can be uploaded
+                                    // as it is, and finally reading the attributes one by one.
+                                    // Compact and optimized meshes differ from the source data,
+                                    // so they always take the last path.
+                                    bool created = geometryCache != nullptr &&
+                                        geometryCache->CreateNextSurface(
+                                            newGltfSurface.surfaceDef.geo,
+                                            surfaceFlags,
+                                            context.Uploads);
+                                    if (!created && loaded && outModelGeo == nullptr &&
+                                        !materialParms.CompactVertices &&
+                                        !materialParms.OptimizeMeshes) {
+                                        created = CreateInterleavedPrimitiveGeometry(
                                             modelFile,
-                                            attributes.GetChildInt32ByName("COLOR", -1),
-                                            ACCESSOR_VEC4,
-                                            GL_FLOAT,
-                                            numVertices);
+                                            primitive,
+                                            attributes,
+                                            newGltfSurface.surfaceDef.geo,
+                                            geometryCache,
+                                            context.Uploads,
+                                            surfaceFlags);
                                     }
-                                    if (loaded) {
-                                        loaded = ReadSurfaceDataFromAccessor(
-                                            attribs.uv0,
+                                    if (!created) {
+                                        ReadPrimitiveGeometry(
                                             modelFile,
-                                            attributes.GetChildInt32ByName("TEXCOORD_0", -1),
-                                            ACCESSOR_VEC2,
-                                            GL_FLOAT,
-                                            numVertices);
-                                    }
-                                    if (loaded) {
-                                        loaded = ReadSurfaceDataFromAccessor(
-                                            attribs.uv1,
-                                            modelFile,
-                                            attributes.GetChildInt32ByName("TEXCOORD_1", -1),
-                                            ACCESSOR_VEC2,
-                                            GL_FLOAT,
-                                            numVertices);
-                                    }
-                                    // #TODO:  TEXCOORD_2 is in the gltf spec, but we only support 2
-                                    // uv sets. support more uv coordinates, skipping for now.
-                                    // if ( loaded ) { loaded = ReadSurfaceDataFromAccessor(
-                                    // attribs.uv2, modelFile, attributes.GetChildInt32ByName(
-                                    // "TEXCOORD_2", -1 ), ACCESSOR_VEC2, GL_FLOAT, static_cast< int
-                                    // >( attribs.position.size() ) ); }
-                                    // #TODO: get weights of type unsigned_byte and unsigned_short
-                                    // working.
-                                    if (loaded) {
-                                        loaded = ReadSurfaceDataFromAccessor(
-                                            attribs.jointWeights,
-                                            modelFile,
-                                            attributes.GetChildInt32ByName("WEIGHTS_0", -1),
-                                            ACCESSOR_VEC4,
-                                            GL_FLOAT,
-                                            numVertices);
-                                    }
-                                    // WEIGHT_0 can be either GL_UNSIGNED_SHORT or GL_BYTE
-                                    if (loaded) {
-                                        int jointIndex =
-                                            attributes.GetChildInt32ByName("JOINTS_0", -1);
-                                        if (jointIndex >= 0 &&
-                                            jointIndex <
-                                                static_cast<int>(modelFile.Accessors.size())) {
-                                            ModelAccessor& acc = modelFile.Accessors[jointIndex];
-                                            if (acc.componentType == GL_UNSIGNED_SHORT) {
-                                                attribs.jointIndices.resize(acc.count);
-                                                for (int accIndex = 0; accIndex < acc.count;
-                                                     accIndex++) {
-                                                    attribs.jointIndices[accIndex].x =
-                                                        (int)((unsigned short*)(acc.BufferData()))
-                                                            [accIndex * 4 + 0];
-                                                    attribs.jointIndices[accIndex].y =
-                                                        (int)((unsigned short*)(acc.BufferData()))
-                                                            [accIndex * 4 + 1];
-                                                    attribs.jointIndices[accIndex].z =
-                                                        (int)((unsigned short*)(acc.BufferData()))
-                                                            [accIndex * 4 + 2];
-                                                    attribs.jointIndices[accIndex].w =
-                                                        (int)((unsigned short*)(acc.BufferData()))
-                                                            [accIndex * 4 + 3];
-                                                }
-                                            } else if (acc.componentType == GL_BYTE) {
-                                                attribs.jointIndices.resize(acc.count);
-                                                for (int accIndex = 0; accIndex < acc.count;
-                                                     accIndex++) {
-                                                    attribs.jointIndices[accIndex].x =
-                                                        (int)((uint8_t*)(acc.BufferData()))
-                                                            [accIndex * 4 + 0];
-                                                    attribs.jointIndices[accIndex].y =
-                                                        (int)((uint8_t*)(acc.BufferData()))
-                                                            [accIndex * 4 + 1];
-                                                    attribs.jointIndices[accIndex].z =
-                                                        (int)((uint8_t*)(acc.BufferData()))
-                                                            [accIndex * 4 + 2];
-                                                    attribs.jointIndices[accIndex].w =
-                                                        (int)((uint8_t*)(acc.BufferData()))
-                                                            [accIndex * 4 + 3];
-                                                }
-                                            } else if (
-                                                acc.componentType ==
-                                                GL_FLOAT) { // not officially in spec, but it's what
-                                                            // our exporter spits out.
-                                                attribs.jointIndices.resize(acc.count);
-                                                for (int accIndex = 0; accIndex < acc.count;
-                                                     accIndex++) {
-                                                    attribs.jointIndices[accIndex].x =
-                                                        (int)((float*)(acc.BufferData()))
-                                                            [accIndex * 4 + 0];
-                                                    attribs.jointIndices[accIndex].y =
-                                                        (int)((float*)(acc.BufferData()))
-                                                            [accIndex * 4 + 1];
-                                                    attribs.jointIndices[accIndex].z =
-                                                        (int)((float*)(acc.BufferData()))
-                                                            [accIndex * 4 + 2];
-                                                    attribs.jointIndices[accIndex].w =
-                                                        (int)((float*)(acc.BufferData()))
-                                                            [accIndex * 4 + 3];
-                                                }
-                                            } else {
-                                                ALOGW(
-                                                    "invalid component type %d on joints_0 accessor on model %s",
-                                                    acc.componentType,
-                                                    modelFile.FileName.c_str());
-                                                loaded = false;
-                                            }
-
-                                            /// List unique joints
-                                            std::unordered_map<int, size_t> uniqueJoints;
-                                            for (const auto& index : attribs.jointIndices) {
-                                                for (int i = 0; i < 4; ++i) {
-                                                    int jointID = index[i];
-                                                    auto it = uniqueJoints.find(jointID);
-                                                    if (it == uniqueJoints.end()) {
-                                                        uniqueJoints[jointID] = 1u;
-                                                    } else {
-                                                        uniqueJoints[jointID] =
-                                                            uniqueJoints[jointID] + 1;
-                                                    }
-                                                }
-                                            }
-                                            /// print them
-                                            ALOGW("Enumerating skinning joints:");
-                                            for (const auto& u : uniqueJoints) {
-                                                ALOGW(
-                                                    " - joint: %02d count: %llu",
-                                                    u.first,
-                                                    u.second);
-                                            }
+                                            primitive,
+                                            attributes,
+                                            newGltfSurface.surfaceDef,
+                                            attribs,
+                                            indices,
+                                            loaded);
+                                        if (materialParms.OptimizeMeshes && loaded &&
+                                            outModelGeo == nullptr) {
+                                            // blended surfaces have to keep their triangle order
+                                            const bool opaque =
+                                                newGltfSurface.material != nullptr &&
+                                                newGltfSurface.material->alphaMode ==
+                                                    ALPHA_MODE_OPAQUE &&
+                                                !materialParms.Transparent;
+                                            OptimizeMesh(
+                                                attribs,
+                                                indices,
+                                                opaque,
+                                                newGltfSurface.surfaceDef.surfaceName.c_str());
                                         }
-                                    }
-
-                                    // TRIANGLES
-                                    std::vector<TriangleIndex> indices;
-                                    const int indicesIndex =
-                                        primitive.GetChildInt32ByName("indices", -1);
-                                    if (indicesIndex < 0 ||
-                                        indicesIndex >=
-                                            static_cast<int>(modelFile.Accessors.size())) {
-                                        ALOGW("Error: Invalid indices index on gltfPrimitive");
-                                        loaded = false;
-                                    }
-
-                                    if (modelFile.Accessors[indicesIndex].componentType !=
-                                        GL_UNSIGNED_SHORT) {
-                                        ALOGW(
-                                            "Error: Currently, only componentType of %d supported for indices, %d requested",
-                                            GL_UNSIGNED_SHORT,
-                                            modelFile.Accessors[indicesIndex].componentType);
-                                        loaded = false;
-                                    }
-
-                                    if (loaded) {
-                                        ReadSurfaceDataFromAccessor(
+                                        const GlVertexFormat vertexFormat =
+                                            materialParms.CompactVertices
+                                            ? GlVertexFormat::ChooseCompact(attribs)
+                                            : GlVertexFormat();
+                                        CreateModelGeometry(
+                                            context,
+                                            newGltfSurface.surfaceDef.geo,
+                                            attribs,
                                             indices,
-                                            modelFile,
-                                            primitive.GetChildInt32ByName("indices", -1),
-                                            ACCESSOR_SCALAR,
-                                            GL_UNSIGNED_SHORT,
-                                            -1);
+                                            vertexFormat);
+                                        surfaceFlags = ModelGeometryCache::GetSurfaceFlags(attribs);
+                                        if (geometryCache != nullptr) {
+                                            geometryCache->AddSurface(
+                                                attribs,
+                                                indices,
+                                                newGltfSurface.surfaceDef.geo,
+                                                vertexFormat);
+                                        }
                                     }
 
-                                    newGltfSurface.surfaceDef.geo.Create(attribs, indices);
-
                                     bool skinned =
-                                        (attribs.jointIndices.size() == attribs.position.size() &&
-                                         attribs.jointWeights.size() == attribs.position.size());
+                                        (surfaceFlags & ModelGeometryCache::SURFACE_FLAG_SKINNED) !=
+                                        0;
 
                                     if (outModelGeo != nullptr) {
+                                        outModelGeo->positions.insert(
+                                            outModelGeo->positions.end(),
+                                            attribs.position.begin(),
+                                            attribs.position.end());
                                         for (int i = 0; i < static_cast<int>(indices.size()); ++i) {
                                             (*outModelGeo)
                                                 .indices.push_back(indices[i] + outGeoIndexOffset);
                                         }
                                     }
 
-                                    // CREATE COMMAND BUFFERS.
-                                    if (newGltfSurface.material->alphaMode == ALPHA_MODE_MASK) {
-                                        // #TODO: implement ALPHA_MODE_MASK if we need it.
-                                        // Just blend because alpha testing is rather expensive.
-                                        ALOGW(
-                                            "gltfAlphaMode ALPHA_MODE_MASK requested, doing ALPHA_MODE_BLEND instead");
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .blendEnable = ovrGpuState::BLEND_ENABLE;
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .depthMaskEnable = false;
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .blendSrc = GL_SRC_ALPHA;
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .blendDst = GL_ONE_MINUS_SRC_ALPHA;
-                                    } else if (
-                                        newGltfSurface.material->alphaMode == ALPHA_MODE_BLEND ||
-                                        materialParms.Transparent) {
-                                        if (materialParms.Transparent &&
-                                            newGltfSurface.material->alphaMode !=
-                                                ALPHA_MODE_BLEND) {
-                                            ALOGW(
-                                                "gltfAlphaMode is %d but treating at ALPHA_MODE_BLEND due to materialParms.Transparent",
-                                                newGltfSurface.material->alphaMode);
-                                        }
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .blendEnable = ovrGpuState::BLEND_ENABLE;
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .depthMaskEnable = false;
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .blendSrc = GL_SRC_ALPHA;
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .blendDst = GL_ONE_MINUS_SRC_ALPHA;
-                                    }
-                                    // #TODO: GLTF doesn't have a concept of an ADDITIVE mode. maybe
-                                    // it should?
-                                    // else if ( newGltfSurface.material->alphaMode ==
-                                    // MATERIAL_TYPE_ADDITIVE )
-                                    //{
-                                    //	newGltfSurface.surfaceDef.graphicsCommand.GpuState.blendEnable
-                                    //= ovrGpuState::BLEND_ENABLE;
-                                    //	newGltfSurface.surfaceDef.graphicsCommand.GpuState.depthMaskEnable
-                                    //= false;
-                                    //	newGltfSurface.surfaceDef.graphicsCommand.GpuState.blendSrc
-                                    //= GL_ONE;
-                                    //	newGltfSurface.surfaceDef.graphicsCommand.GpuState.blendDst
-                                    //= GL_ONE;
-                                    //}
-                                    else if (
-                                        newGltfSurface.material->alphaMode == ALPHA_MODE_OPAQUE) {
-                                        // default GpuState;
-                                    }
-
-                                    if (newGltfSurface.material->baseColorTextureWrapper !=
-                                        nullptr) {
-                                        newGltfSurface.surfaceDef.graphicsCommand.Textures[0] =
-                                            newGltfSurface.material->baseColorTextureWrapper->image
-                                                ->texid;
-
-                                        if (newGltfSurface.material->emissiveTextureWrapper !=
-                                            nullptr) {
-                                            if (programs.ProgBaseColorEmissivePBR == nullptr) {
-                                                ALOGE_FAIL("No ProgBaseColorEmissivePBR set");
-                                            }
-                                            newGltfSurface.surfaceDef.graphicsCommand.Textures[1] =
-                                                newGltfSurface.material->emissiveTextureWrapper
-                                                    ->image->texid;
-
-                                            if (skinned) {
-                                                if (programs.ProgSkinnedBaseColorEmissivePBR ==
-                                                    nullptr) {
-                                                    ALOGE_FAIL(
-                                                        "No ProgSkinnedBaseColorEmissivePBR set");
-                                                }
-
-                                                newGltfSurface.surfaceDef.graphicsCommand.Program =
-                                                    *programs.ProgSkinnedBaseColorEmissivePBR;
-                                                newGltfSurface.surfaceDef.surfaceName =
-                                                    "ProgSkinnedBaseColorEmissivePBR";
-                                            } else {
-                                                newGltfSurface.surfaceDef.graphicsCommand.Program =
-                                                    *programs.ProgBaseColorEmissivePBR;
-                                                newGltfSurface.surfaceDef.surfaceName =
-                                                    "ProgBaseColorEmissivePBR";
-                                            }
-                                        } else {
-                                            if (skinned) {
-                                                if (programs.ProgSkinnedBaseColorPBR == nullptr) {
-                                                    ALOGE_FAIL("No ProgSkinnedBaseColorPBR set");
-                                                }
-                                                newGltfSurface.surfaceDef.graphicsCommand.Program =
-                                                    *programs.ProgSkinnedBaseColorPBR;
-                                                newGltfSurface.surfaceDef.surfaceName =
-                                                    "ProgSkinnedBaseColorPBR";
-                                            } else {
-                                                if (programs.ProgBaseColorPBR == nullptr) {
-                                                    ALOGE_FAIL("No ProgBaseColorPBR set");
-                                                }
-                                                newGltfSurface.surfaceDef.graphicsCommand.Program =
-                                                    *programs.ProgBaseColorPBR;
-                                                newGltfSurface.surfaceDef.surfaceName =
-                                                    "ProgBaseColorPBR";
-                                            }
-                                        }
-                                    } else {
-                                        if (skinned) {
-                                            if (programs.ProgSkinnedSimplePBR == nullptr) {
-                                                ALOGE_FAIL("No ProgSkinnedSimplePBR set");
-                                            }
-                                            newGltfSurface.surfaceDef.graphicsCommand.Program =
-                                                *programs.ProgSkinnedSimplePBR;
-                                            newGltfSurface.surfaceDef.surfaceName =
-                                                "ProgSkinnedSimplePBR";
-                                        } else {
-                                            if (programs.ProgSimplePBR == nullptr) {
-                                                ALOGE_FAIL("No ProgSimplePBR set");
-                                            }
-                                            newGltfSurface.surfaceDef.graphicsCommand.Program =
-                                                *programs.ProgSimplePBR;
-                                            newGltfSurface.surfaceDef.surfaceName = "ProgSimplePBR";
-                                        }
-                                    }
-
-                                    if (materialParms.PolygonOffset) {
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .polygonOffsetEnable = true;
-                                    }
-
-                                    if (newGltfSurface.material->doubleSided) {
-                                        newGltfSurface.surfaceDef.graphicsCommand.GpuState
-                                            .cullEnable = false;
-                                    }
+                                    CreateGltfSurfaceCommand(
+                                        newGltfSurface, skinned, programs, materialParms);
                                     newGltfModel.surfaces.push_back(newGltfSurface);
                                 }
                             } // END SURFACES
@@ -1813,9 +2666,33 @@ bool LoadModelFile_glTF_OvrScene(
     const int fileDataLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo) {
+    ModelGeo* outModelGeo,
+    const ModelLoadContext& context) {
     ModelFile& modelFile = *modelFilePtr;
 
+    ModelGeometryCache* const geometryCache = GetGltfGeometryCache(outModelGeo, context);
+    const uint8_t* scene = nullptr;
+    size_t sceneSize = 0;
+    if (geometryCache != nullptr && geometryCache->GetScene(scene, sceneSize)) {
+        // cooked, the .gltf is never inflated
+        if (!ReadGltfScene(
+                modelFile,
+                scene,
+                sceneSize,
+                *geometryCache,
+                zfp,
+                fileData,
+                fileDataLength,
+                programs,
+                materialParms,
+                context)) {
+            geometryCache->Invalidate();
+            return false;
+        }
+        return true;
+    }
+    std::vector<ovrGltfImageSource> imageSources;
+
     // Since we are doing a zip file, we are going to parse through the zip file many times to find
     // the different data points.
     const char* gltfJson = nullptr;
@@ -1985,7 +2862,9 @@ bool LoadModelFile_glTF_OvrScene(
                                     "Loading images from bufferView currently unsupported, defaulting image");
                                 // Create a default texture.
                                 LoadModelFileTexture(
-                                    modelFile, "DefaultImage", nullptr, 0, materialParms);
+                                    modelFile, "DefaultImage", nullptr, 0, materialParms, context);
+                                imageSources.emplace_back(
+                                    GLTF_IMAGE_SOURCE_DEFAULT, "DefaultImage", -1);
                             } else {
                                 // check to make sure the image is ktx.
                                 if (OVR::OVR_stricmp(uri.c_str() + (uri.length() - 4), ".ktx") !=
@@ -2006,7 +2885,10 @@ bool LoadModelFile_glTF_OvrScene(
                                         imageName,
                                         (const char*)buffer,
                                         bufferLength,
-                                        materialParms);
+                                        materialParms,
+                                        context);
+                                    imageSources.emplace_back(
+                                        GLTF_IMAGE_SOURCE_ZIP_ENTRY, imageName, -1);
                                 } else {
                                     int bufferLength = 0;
                                     uint8_t* buffer = ReadFileBufferFromZipFile(
@@ -2018,7 +2900,10 @@ bool LoadModelFile_glTF_OvrScene(
                                         imageName,
                                         (const char*)buffer,
                                         bufferLength,
-                                        materialParms);
+                                        materialParms,
+                                        context);
+                                    imageSources.emplace_back(
+                                        GLTF_IMAGE_SOURCE_ZIP_ENTRY, imageName, -1);
                                 }
                             }
                         }
@@ -2033,7 +2918,11 @@ bool LoadModelFile_glTF_OvrScene(
 
         if (loaded) {
             loaded =
-                LoadModelFile_glTF_Json(modelFile, gltfJson, programs, materialParms, outModelGeo);
+                LoadModelFile_glTF_Json(
+                    modelFile, gltfJson, programs, materialParms, outModelGeo, context);
+        }
+        if (loaded && geometryCache != nullptr) {
+            WriteGltfScene(modelFile, imageSources, *geometryCache);
         }
     }
 
@@ -2050,7 +2939,8 @@ ModelFile* LoadModelFile_glB(
     const int fileDataLength,
     const ModelGlPrograms& programs,
     const MaterialParms& materialParms,
-    ModelGeo* outModelGeo) {
+    ModelGeo* outModelGeo,
+    const ModelLoadContext& context) {
     // LOGCPUTIME( "LoadModelFile_glB" );
 
     ModelFile* modelFilePtr = new ModelFile;
@@ -2059,6 +2949,34 @@ ModelFile* LoadModelFile_glB(
     modelFile.FileName = fileName;
     modelFile.UsingSrgbTextures = materialParms.UseSrgbTextureFormats;
 
+    ModelGeometryCache* const geometryCache = GetGltfGeometryCache(outModelGeo, context);
+    const uint8_t* scene = nullptr;
+    size_t sceneSize = 0;
+    if (geometryCache != nullptr && geometryCache->GetScene(scene, sceneSize)) {
+        // cooked, the JSON chunk is never parsed
+        if (!ReadGltfScene(
+                modelFile,
+                scene,
+                sceneSize,
+                *geometryCache,
+                nullptr,
+                fileData,
+                fileDataLength,
+                programs,
+                materialParms,
+                context)) {
+            ALOGW("Error: failed to load %s", fileName);
+            geometryCache->Invalidate();
+            if (context.Uploads != nullptr) {
+                context.Uploads->Discard(*modelFilePtr);
+            }
+            delete modelFilePtr;
+            return nullptr;
+        }
+        return modelFilePtr;
+    }
+    std::vector<ovrGltfImageSource> imageSources;
+
     bool loaded = true;
 
     uint32_t fileDataIndex = 0;
@@ -2291,14 +3209,26 @@ ModelFile* LoadModelFile_glB(
                                         "DefualtImage.png",
                                         (const char*)imageBuffer,
                                         imageBufferLength,
-                                        materialParms);
+                                        materialParms,
+                                        context);
+                                    imageSources.emplace_back(
+                                        GLTF_IMAGE_SOURCE_BUFFER_VIEW,
+                                        "DefualtImage.png",
+                                        bufferView);
 
                                 } else {
                                     ALOGW(
                                         "Loading images from othen then bufferView currently unsupported in glBfd, defaulting image");
                                     // Create a default texture.
                                     LoadModelFileTexture(
-                                        modelFile, "DefaultImage", nullptr, 0, materialParms);
+                                        modelFile,
+                                        "DefaultImage",
+                                        nullptr,
+                                        0,
+                                        materialParms,
+                                        context);
+                                    imageSources.emplace_back(
+                                        GLTF_IMAGE_SOURCE_DEFAULT, "DefaultImage", -1);
                                 }
                             }
                         }
@@ -2311,7 +3241,11 @@ ModelFile* LoadModelFile_glB(
 
         if (loaded) {
             loaded =
-                LoadModelFile_glTF_Json(modelFile, gltfJson, programs, materialParms, outModelGeo);
+                LoadModelFile_glTF_Json(
+                    modelFile, gltfJson, programs, materialParms, outModelGeo, context);
+        }
+        if (loaded && geometryCache != nullptr) {
+            WriteGltfScene(modelFile, imageSources, *geometryCache);
         }
     }
 
@@ -2319,6 +3253,10 @@ ModelFile* LoadModelFile_glB(
 
     if (!loaded) {
         ALOGW("Error: failed to load %s", fileName);
+        if (context.Uploads != nullptr) {
+            // nothing recorded for the model will be created
+            context.Uploads->Discard(*modelFilePtr);
+        }
         delete modelFilePtr;
         modelFilePtr = nullptr;
     }
@@ -0,0 +1,261 @@
+/************************************************************************************
+
+Filename    :   ModelUploads.cpp
+Content     :   GL work of a model load, recorded on a loader thread and run on the GL thread.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "ModelUploads.h"
+
+#include <string.h>
+
+#include "ModelFile.h"
+
+#include "Misc/Log.h"
+
+using OVR::Bounds3f;
+using OVR::Vector3f;
+
+namespace OVRFW {
+
+//==============================
+// ModelGpuUploads::ModelGpuUploads
+ModelGpuUploads::ModelGpuUploads() : NextTexture(0), NextGeometry(0) {}
+
+//==============================
+// ModelGpuUploads::~ModelGpuUploads
+ModelGpuUploads::~ModelGpuUploads() {}
+
+//==============================
+// ModelGpuUploads::CreateGeometry
+void ModelGpuUploads::CreateGeometry(
+    GlGeometry& geo,
+    const VertexAttribs& attribs,
+    const std::vector<TriangleIndex32>& indices,
+    const GlVertexFormat& format) {
+    std::unique_ptr<ovrPendingGeometry> pending(new ovrPendingGeometry());
+    ovrPendingGeometry& p = *pending;
+
+    // the same choices GlGeometry::Create() makes
+    p.NumVertices = static_cast<int>(attribs.position.size());
+    p.NumIndices = static_cast<int>(indices.size());
+    p.IndexType = (p.NumVertices <= GlGeometry::GetMaxGeometryVertices()) ? GL_UNSIGNED_SHORT
+                                                                          : GL_UNSIGNED_INT;
+    p.Bounds = Bounds3f(Bounds3f::Init);
+    for (const Vector3f& position : attribs.position) {
+        p.Bounds.AddPoint(position);
+    }
+
+    p.Transformed = GlGeometry::TransformScope::IsEnabled();
+    if (p.Transformed) {
+        p.Transform = GlGeometry::TransformScope::GetTransform();
+    }
+    if (!p.Transformed &&
+        GlGeometry::PackInterleavedVertices(
+            attribs, format, p.OwnedVertices, p.Attributes, p.VertexStride)) {
+        p.Vertices = p.OwnedVertices.data();
+        if (p.IndexType == GL_UNSIGNED_SHORT) {
+            p.OwnedIndices.resize(indices.size() * sizeof(TriangleIndex));
+            TriangleIndex* narrow = reinterpret_cast<TriangleIndex*>(p.OwnedIndices.data());
+            for (size_t i = 0; i < indices.size(); i++) {
+                narrow[i] = static_cast<TriangleIndex>(indices[i]);
+            }
+        } else {
+            p.OwnedIndices.resize(indices.size() * sizeof(TriangleIndex32));
+            memcpy(p.OwnedIndices.data(), indices.data(), p.OwnedIndices.size());
+        }
+        p.Indices = p.OwnedIndices.data();
+    } else {
+        p.Planar = true;
+        p.Attribs = attribs;
+        p.Indices32 = indices;
+        p.Format = format;
+    }
+
+    Geometry.push_back(std::move(pending));
+    geo.vertexCount = p.NumVertices;
+    geo.indexCount = p.NumIndices;
+    geo.indexType = p.IndexType;
+    geo.localBounds = p.Bounds;
+    geo.vertexArrayObject = 0;
+    geo.indexBuffer = 0;
+    geo.vertexBuffer = static_cast<unsigned>(Geometry.size());
+}
+
+//==============================
+// ModelGpuUploads::CreateInterleavedGeometry
+void ModelGpuUploads::CreateInterleavedGeometry(
+    GlGeometry& geo,
+    const void* vertices,
+    const int numVertices,
+    const int vertexStride,
+    const GlVertexAttribute* attributes,
+    const int numAttributes,
+    const void* indices,
+    const int numIndices,
+    const Bounds3f& bounds,
+    const unsigned glIndexType) {
+    std::unique_ptr<ovrPendingGeometry> pending(new ovrPendingGeometry());
+    ovrPendingGeometry& p = *pending;
+    p.Vertices = vertices;
+    p.NumVertices = numVertices;
+    p.VertexStride = vertexStride;
+    p.Attributes.assign(attributes, attributes + numAttributes);
+    p.Indices = indices;
+    p.NumIndices = numIndices;
+    p.Bounds = bounds;
+    p.IndexType = glIndexType;
+
+    Geometry.push_back(std::move(pending));
+    geo.vertexCount = numVertices;
+    geo.indexCount = numIndices;
+    geo.indexType = glIndexType;
+    geo.localBounds = bounds;
+    geo.vertexArrayObject = 0;
+    geo.indexBuffer = 0;
+    geo.vertexBuffer = static_cast<unsigned>(Geometry.size());
+}
+
+//==============================
+// ModelGpuUploads::AddTexture
+GlTexture ModelGpuUploads::AddTexture(std::unique_ptr<ovrPendingTexture> pending) {
+    const ovrDecodedTexture& decoded = *pending->Decoded;
+    Textures.push_back(std::move(pending));
+    return GlTexture(static_cast<unsigned>(Textures.size()), 0, decoded.Width, decoded.Height);
+}
+
+//==============================
+// ModelGpuUploads::CreateTexture
+GlTexture ModelGpuUploads::CreateTexture(const ovrDecodedTexture& decoded) {
+    std::unique_ptr<ovrPendingTexture> pending(new ovrPendingTexture());
+    pending->Decoded = &decoded;
+    return AddTexture(std::move(pending));
+}
+
+//==============================
+// ModelGpuUploads::CreateTexture
+GlTexture ModelGpuUploads::CreateTexture(std::unique_ptr<ovrDecodedTexture> decoded) {
+    std::unique_ptr<ovrPendingTexture> pending(new ovrPendingTexture());
+    pending->Decoded = decoded.get();
+    pending->Owned = std::move(decoded);
+    return AddTexture(std::move(pending));
+}
+
+//==============================
+// ModelGpuUploads::ModifyTexture
+void ModelGpuUploads::ModifyTexture(
+    const GlTexture& texture,
+    const std::function<void(GlTexture)>& modify) {
+    if (!IsPlaceholder(texture) || texture.texture > Textures.size()) {
+        modify(texture);
+        return;
+    }
+    Textures[texture.texture - 1]->Modifiers.push_back(modify);
+}
+
+//==============================
+// ModelGpuUploads::UploadNext
+bool ModelGpuUploads::UploadNext(ModelFile& model) {
+    // textures first, they are usually the bigger uploads
+    if (NextTexture < static_cast<int>(Textures.size())) {
+        ovrPendingTexture& p = *Textures[NextTexture++];
+        int width = 0;
+        int height = 0;
+        p.Created = CreateTextureFromDecoded(*p.Decoded, width, height);
+        for (const std::function<void(GlTexture)>& modify : p.Modifiers) {
+            modify(p.Created);
+        }
+        // the pixels are on the GPU now
+        p.Owned.reset();
+    } else if (NextGeometry < static_cast<int>(Geometry.size())) {
+        ovrPendingGeometry& p = *Geometry[NextGeometry++];
+        if (p.Planar) {
+            GlGeometry::TransformScope scope(p.Transform, p.Transformed);
+            p.Created.Create(p.Attribs, p.Indices32, p.Format);
+            p.Attribs = VertexAttribs();
+            p.Indices32.clear();
+        } else {
+            p.Created.CreateInterleaved(
+                p.Vertices,
+                p.NumVertices,
+                p.VertexStride,
+                p.Attributes.data(),
+                static_cast<int>(p.Attributes.size()),
+                p.Indices,
+                p.NumIndices,
+                p.Bounds,
+                p.IndexType);
+            p.OwnedVertices.clear();
+            p.OwnedVertices.shrink_to_fit();
+            p.OwnedIndices.clear();
+            p.OwnedIndices.shrink_to_fit();
+        }
+    }
+
+    if (GetNumRemaining() > 0) {
+        return false;
+    }
+    ResolvePlaceholders(model);
+    return true;
+}
+
+//==============================
+// ModelGpuUploads::ResolvePlaceholders
+void ModelGpuUploads::ResolvePlaceholders(ModelFile& model) const {
+    auto resolveTexture = [this](GlTexture& texture) {
+        if (IsPlaceholder(texture) && texture.texture <= Textures.size()) {
+            texture = Textures[texture.texture - 1]->Created;
+        }
+    };
+    for (ModelTexture& texture : model.Textures) {
+        resolveTexture(texture.texid);
+    }
+    for (Model& m : model.Models) {
+        for (ModelSurface& surface : m.surfaces) {
+            ovrGraphicsCommand& gc = surface.surfaceDef.graphicsCommand;
+            for (int i = 0; i < ovrGraphicsCommand::MAX_TEXTURES; i++) {
+                resolveTexture(gc.Textures[i]);
+            }
+            GlGeometry& geo = surface.surfaceDef.geo;
+            if (IsPlaceholder(geo) && geo.vertexBuffer <= Geometry.size()) {
+                // keep what the loaders set after recording, such as the primitive type
+                const unsigned primitiveType = geo.primitiveType;
+                geo = Geometry[geo.vertexBuffer - 1]->Created;
+                geo.primitiveType = primitiveType;
+            }
+        }
+    }
+}
+
+//==============================
+// ModelGpuUploads::Discard
+void ModelGpuUploads::Discard(ModelFile& model) {
+    for (ModelTexture& texture : model.Textures) {
+        texture.texid = GlTexture();
+    }
+    for (Model& m : model.Models) {
+        for (ModelSurface& surface : m.surfaces) {
+            for (int i = 0; i < ovrGraphicsCommand::MAX_TEXTURES; i++) {
+                surface.surfaceDef.graphicsCommand.Textures[i] = GlTexture();
+            }
+            surface.surfaceDef.geo = GlGeometry();
+        }
+    }
+    Textures.clear();
+    Geometry.clear();
+    NextTexture = 0;
+    NextGeometry = 0;
+}
+
+//==============================
+// ModelGpuUploads::GetNumRemaining
+int ModelGpuUploads::GetNumRemaining() const {
+    return static_cast<int>(Textures.size()) - NextTexture + static_cast<int>(Geometry.size()) -
+        NextGeometry;
+}
+
+} // namespace OVRFW
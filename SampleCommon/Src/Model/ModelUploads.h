@@ -0,0 +1,145 @@
+/************************************************************************************
+
+Filename    :   ModelUploads.h
+Content     :   GL work of a model load, recorded on a loader thread and run on the GL thread.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "OVR_Math.h"
+
+#include "Render/GlGeometry.h"
+#include "Render/GlTexture.h"
+
+namespace OVRFW {
+
+class ModelFile;
+
+//==============================================================
+// ModelGpuUploads
+// Lets a model load run off the GL thread. The loaders parse, inflate, decode and pack everything
+// on the loader thread, and record each texture and vertex buffer here instead of creating it.
+// They get placeholders back that they can copy into surfaces like real textures and geometry.
+// UploadNext() then creates one texture or buffer per call on the GL thread, so the upload can be
+// spread over frames, and once everything exists it swaps the placeholders in the model for the
+// real objects.
+//
+// A placeholder texture has a non-zero name and no target; placeholder geometry has a non-zero
+// vertex buffer and no vertex array object. Neither can be drawn.
+class ModelGpuUploads {
+   public:
+    ModelGpuUploads();
+    ~ModelGpuUploads();
+
+    ModelGpuUploads(const ModelGpuUploads&) = delete;
+    ModelGpuUploads& operator=(const ModelGpuUploads&) = delete;
+
+    // Records geo.Create( attribs, indices, format ). The vertices are packed and the indices
+    // narrowed here; geo gets the counts, index type and bounds the created geometry will have.
+    void CreateGeometry(
+        GlGeometry& geo,
+        const VertexAttribs& attribs,
+        const std::vector<TriangleIndex32>& indices,
+        const GlVertexFormat& format);
+    // Records geo.CreateInterleaved(). The data is not copied, so it has to stay valid until
+    // UploadNext() has returned true.
+    void CreateInterleavedGeometry(
+        GlGeometry& geo,
+        const void* vertices,
+        const int numVertices,
+        const int vertexStride,
+        const GlVertexAttribute* attributes,
+        const int numAttributes,
+        const void* indices,
+        const int numIndices,
+        const OVR::Bounds3f& bounds,
+        const unsigned glIndexType);
+
+    // Records CreateTextureFromDecoded( decoded ). The image is not copied, so it has to stay
+    // valid until UploadNext() has returned true.
+    GlTexture CreateTexture(const ovrDecodedTexture& decoded);
+    // Same, for an image the uploads own from here on.
+    GlTexture CreateTexture(std::unique_ptr<ovrDecodedTexture> decoded);
+    // Runs modify on the texture once it has been created, e.g. to set its sampler state. A
+    // texture that is not a placeholder is modified right away.
+    void ModifyTexture(const GlTexture& texture, const std::function<void(GlTexture)>& modify);
+
+    // Called on the GL thread. Creates the next recorded texture or geometry. Returns true once
+    // everything has been created and the model's textures and surfaces point at it.
+    bool UploadNext(ModelFile& model);
+    // Drops what has not been uploaded and clears the model's textures and geometry, so deleting
+    // the model doesn't free objects that were never created. Objects that were created are
+    // left to the GL context; this is only for shutting down with loads in flight.
+    void Discard(ModelFile& model);
+
+    int GetNumRemaining() const;
+
+    static bool IsPlaceholder(const GlTexture& texture) {
+        return texture.target == 0 && texture.texture != 0;
+    }
+    static bool IsPlaceholder(const GlGeometry& geo) {
+        return geo.vertexArrayObject == 0 && geo.vertexBuffer != 0;
+    }
+
+   private:
+    struct ovrPendingTexture {
+        const ovrDecodedTexture* Decoded;
+        std::unique_ptr<ovrDecodedTexture> Owned;
+        std::vector<std::function<void(GlTexture)>> Modifiers;
+        GlTexture Created;
+    };
+
+    struct ovrPendingGeometry {
+        ovrPendingGeometry()
+            : Vertices(nullptr),
+              NumVertices(0),
+              VertexStride(0),
+              Indices(nullptr),
+              NumIndices(0),
+              IndexType(0),
+              Planar(false),
+              Transformed(false) {}
+
+        // interleaved data, either borrowed or in OwnedVertices / OwnedIndices
+        const void* Vertices;
+        int NumVertices;
+        int VertexStride;
+        std::vector<GlVertexAttribute> Attributes;
+        const void* Indices;
+        int NumIndices;
+        OVR::Bounds3f Bounds;
+        unsigned IndexType;
+        std::vector<uint8_t> OwnedVertices;
+        std::vector<uint8_t> OwnedIndices;
+
+        // attributes that can't be interleaved, or that a GlGeometry::TransformScope was
+        // transforming, are kept for GlGeometry::Create() on the GL thread
+        bool Planar;
+        bool Transformed;
+        OVR::Matrix4f Transform;
+        VertexAttribs Attribs;
+        std::vector<TriangleIndex32> Indices32;
+        GlVertexFormat Format;
+
+        GlGeometry Created;
+    };
+
+    std::vector<std::unique_ptr<ovrPendingTexture>> Textures;
+    std::vector<std::unique_ptr<ovrPendingGeometry>> Geometry;
+    int NextTexture;
+    int NextGeometry;
+
+    GlTexture AddTexture(std::unique_ptr<ovrPendingTexture> pending);
+    void ResolvePlaceholders(ModelFile& model) const;
+};
+
+} // namespace OVRFW
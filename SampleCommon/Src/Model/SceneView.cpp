@@ -540,8 +540,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
     ModelGlPrograms programs;
 
     if (!LoadedPrograms) {
-        ProgVertexColor = OVRFW::GlProgram::Build(
-            VertexColorVertexShaderSrc, VertexColorFragmentShaderSrc, nullptr, 0);
+        // Start all of the programs before finishing any, so a driver with
+        // GL_KHR_parallel_shader_compile can compile them concurrently.
+        ProgVertexColor = OVRFW::GlProgram::BuildDeferred(
+            nullptr, VertexColorVertexShaderSrc, nullptr, VertexColorFragmentShaderSrc, nullptr, 0);
 
         {
             OVRFW::ovrProgramParm uniformParms[] = {
@@ -550,8 +552,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"Texture0", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgSingleTexture = OVRFW::GlProgram::Build(
+            ProgSingleTexture = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 SingleTextureVertexShaderSrc,
+                nullptr,
                 SingleTextureFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -565,8 +569,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"Texture1", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgLightMapped = OVRFW::GlProgram::Build(
+            ProgLightMapped = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 LightMappedVertexShaderSrc,
+                nullptr,
                 LightMappedFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -584,8 +590,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"Texture4", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgReflectionMapped = OVRFW::GlProgram::Build(
+            ProgReflectionMapped = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 ReflectionMappedVertexShaderSrc,
+                nullptr,
                 ReflectionMappedFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -598,8 +606,13 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"BaseColorFactor", OVRFW::ovrProgramParmType::FLOAT_VECTOR4},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgSimplePBR = OVRFW::GlProgram::Build(
-                SimplePBRVertexShaderSrc, SimplePBRFragmentShaderSrc, uniformParms, uniformCount);
+            ProgSimplePBR = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
+                SimplePBRVertexShaderSrc,
+                nullptr,
+                SimplePBRFragmentShaderSrc,
+                uniformParms,
+                uniformCount);
         }
 
         {
@@ -610,8 +623,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"BaseColorTexture", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgBaseColorPBR = OVRFW::GlProgram::Build(
+            ProgBaseColorPBR = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 SimplePBRVertexShaderSrc,
+                nullptr,
                 BaseColorPBRFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -627,8 +642,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"Texture1", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgBaseColorEmissivePBR = OVRFW::GlProgram::Build(
+            ProgBaseColorEmissivePBR = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 SimplePBRVertexShaderSrc,
+                nullptr,
                 BaseColorEmissivePBRFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -641,8 +658,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 /// Fragment
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgSkinnedVertexColor = OVRFW::GlProgram::Build(
+            ProgSkinnedVertexColor = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 VertexColorSkinned1VertexShaderSrc,
+                nullptr,
                 VertexColorFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -656,8 +675,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"Texture0", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgSkinnedSingleTexture = OVRFW::GlProgram::Build(
+            ProgSkinnedSingleTexture = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 SingleTextureSkinned1VertexShaderSrc,
+                nullptr,
                 SingleTextureFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -672,8 +693,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"Texture1", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgSkinnedLightMapped = OVRFW::GlProgram::Build(
+            ProgSkinnedLightMapped = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 LightMappedSkinned1VertexShaderSrc,
+                nullptr,
                 LightMappedFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -692,8 +715,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"Texture4", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgSkinnedReflectionMapped = OVRFW::GlProgram::Build(
+            ProgSkinnedReflectionMapped = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 ReflectionMappedSkinned1VertexShaderSrc,
+                nullptr,
                 ReflectionMappedFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -707,8 +732,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"BaseColorFactor", OVRFW::ovrProgramParmType::FLOAT_VECTOR4},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgSkinnedSimplePBR = OVRFW::GlProgram::Build(
+            ProgSkinnedSimplePBR = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 SimplePBRSkinned1VertexShaderSrc,
+                nullptr,
                 SimplePBRFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -723,8 +750,10 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"BaseColorTexture", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgSkinnedBaseColorPBR = OVRFW::GlProgram::Build(
+            ProgSkinnedBaseColorPBR = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 SimplePBRSkinned1VertexShaderSrc,
+                nullptr,
                 BaseColorPBRFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
@@ -741,13 +770,35 @@ ModelGlPrograms OvrSceneView::GetDefaultGLPrograms() {
                 {"Texture1", OVRFW::ovrProgramParmType::TEXTURE_SAMPLED},
             };
             const int uniformCount = sizeof(uniformParms) / sizeof(OVRFW::ovrProgramParm);
-            ProgSkinnedBaseColorEmissivePBR = OVRFW::GlProgram::Build(
+            ProgSkinnedBaseColorEmissivePBR = OVRFW::GlProgram::BuildDeferred(
+                nullptr,
                 SimplePBRSkinned1VertexShaderSrc,
+                nullptr,
                 BaseColorEmissivePBRFragmentShaderSrc,
                 uniformParms,
                 uniformCount);
         }
 
+        OVRFW::GlProgram* deferred[] = {
+            &ProgVertexColor,
+            &ProgSingleTexture,
+            &ProgLightMapped,
+            &ProgReflectionMapped,
+            &ProgSimplePBR,
+            &ProgBaseColorPBR,
+            &ProgBaseColorEmissivePBR,
+            &ProgSkinnedVertexColor,
+            &ProgSkinnedSingleTexture,
+            &ProgSkinnedLightMapped,
+            &ProgSkinnedReflectionMapped,
+            &ProgSkinnedSimplePBR,
+            &ProgSkinnedBaseColorPBR,
+            &ProgSkinnedBaseColorEmissivePBR,
+        };
+        for (OVRFW::GlProgram* program : deferred) {
+            OVRFW::GlProgram::FinishBuild(*program);
+        }
+
         LoadedPrograms = true;
     }
 
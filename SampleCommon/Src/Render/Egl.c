@@ -57,6 +57,18 @@ void EglInitExtensions() {
 
         glExtensions.EXT_texture_filter_anisotropic =
             strstr(allExtensions, "GL_EXT_texture_filter_anisotropic");
+
+        glExtensions.KHR_parallel_shader_compile =
+            strstr(allExtensions, "GL_KHR_parallel_shader_compile");
+    }
+
+    if (glExtensions.KHR_parallel_shader_compile) {
+        PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR_ =
+            (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)GetExtensionProc("glMaxShaderCompilerThreadsKHR");
+        if (glMaxShaderCompilerThreadsKHR_ != NULL) {
+            // let the driver pick the number of compiler threads
+            glMaxShaderCompilerThreadsKHR_(0xFFFFFFFF);
+        }
     }
 
     eglCreateSyncKHR_ = (PFNEGLCREATESYNCKHRPROC)GetExtensionProc("eglCreateSyncKHR");
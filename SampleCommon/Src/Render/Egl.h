@@ -103,6 +103,13 @@ typedef void(GL_APIENTRY* PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVRPROC)(
 #define GL_SAMPLER_EXTERNAL_OES 0x8D66
 #endif /* GL_OES_EGL_image_external */
 
+#ifndef GL_KHR_parallel_shader_compile
+#define GL_KHR_parallel_shader_compile 1
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+typedef void(GL_APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+#endif /* GL_KHR_parallel_shader_compile */
+
 typedef struct ovrEgl_s {
     EGLint MajorVersion;
     EGLint MinorVersion;
@@ -117,6 +124,7 @@ typedef struct {
     bool multi_view; // GL_OVR_multiview, GL_OVR_multiview2
     bool EXT_texture_border_clamp; // GL_EXT_texture_border_clamp, GL_OES_texture_border_clamp
     bool EXT_texture_filter_anisotropic; // GL_EXT_texture_filter_anisotropic
+    bool KHR_parallel_shader_compile; // GL_KHR_parallel_shader_compile
 } OpenGLExtensions_t;
 
 extern OpenGLExtensions_t glExtensions;
@@ -20,6 +20,10 @@ using OVR::Vector4f;
 //#include "OVR_GlUtils.h"
 #include "Misc/Log.h"
 
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
 /*
  * These are all built inside VertexArrayObjects, so no GL state other
  * than the VAO binding should be disturbed.
@@ -42,8 +46,12 @@ GlGeometry::TransformScope::~TransformScope() {
     enableGeometryTransfom = wasEnabled;
     geometryTransfom = previousTransform;
 }
-
-unsigned GlGeometry::IndexType = (sizeof(TriangleIndex) == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+bool GlGeometry::TransformScope::IsEnabled() {
+    return enableGeometryTransfom;
+}
+OVR::Matrix4f GlGeometry::TransformScope::GetTransform() {
+    return geometryTransfom;
+}
 
 template <typename _attrib_type_>
 void PackVertexAttribute(
@@ -67,9 +75,181 @@ void PackVertexAttribute(
     }
 }
 
+static uint16_t FloatToHalf(const float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    const uint32_t sign = (x >> 16) & 0x8000;
+    const uint32_t floatExponent = (x >> 23) & 0xFF;
+    uint32_t mantissa = x & 0x007FFFFF;
+    if (floatExponent == 0xFF) {
+        // infinity or NaN
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x0200 : 0));
+    }
+    const int exponent = static_cast<int>(floatExponent) - 127 + 15;
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+    if (exponent <= 0) {
+        // denormal, or too small for a half
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x00800000;
+        const int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1) {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x00001000) {
+        // round to nearest, a carry correctly moves into the exponent
+        half++;
+    }
+    return static_cast<uint16_t>(half);
+}
+
+static float HalfToFloat(const uint16_t h) {
+    const float sign = (h & 0x8000) ? -1.0f : 1.0f;
+    const int exponent = (h >> 10) & 0x1F;
+    const int mantissa = h & 0x03FF;
+    if (exponent == 0) {
+        return sign * ldexpf(static_cast<float>(mantissa), -24);
+    }
+    if (exponent == 31) {
+        return (mantissa != 0) ? NAN : sign * INFINITY;
+    }
+    return sign * ldexpf(static_cast<float>(mantissa | 0x0400), exponent - 25);
+}
+
+template <typename _attrib_type_>
+static const float* FloatData(const std::vector<_attrib_type_>& attrib) {
+    return reinterpret_cast<const float*>(attrib.data());
+}
+
+static bool FitsHalf(const float* values, const size_t count, const float tolerance) {
+    for (size_t i = 0; i < count; i++) {
+        // written so NaNs fail
+        if (!(fabsf(HalfToFloat(FloatToHalf(values[i])) - values[i]) <= tolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool InRange(const float* values, const size_t count, const float min, const float max) {
+    for (size_t i = 0; i < count; i++) {
+        if (!(values[i] >= min && values[i] <= max)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int GetEncodedSize(const GlVertexEncoding encoding, const int components) {
+    switch (encoding) {
+        case VERTEX_ENCODING_HALF:
+            return ((components + 1) & ~1) * sizeof(uint16_t);
+        case VERTEX_ENCODING_SNORM_10_10_10_2:
+        case VERTEX_ENCODING_UNORM8:
+        case VERTEX_ENCODING_UINT8:
+            return 4;
+        default:
+            return components * 4;
+    }
+}
+
+static void EncodeVertexValues(
+    const GlVertexEncoding encoding,
+    const float* values,
+    const int components,
+    uint8_t* out) {
+    switch (encoding) {
+        case VERTEX_ENCODING_HALF: {
+            uint16_t half[4] = {0, 0, 0, 0};
+            for (int c = 0; c < components; c++) {
+                half[c] = FloatToHalf(values[c]);
+            }
+            memcpy(out, half, GetEncodedSize(encoding, components));
+            break;
+        }
+        case VERTEX_ENCODING_SNORM_10_10_10_2: {
+            uint32_t packed = 0;
+            for (int c = 0; c < components && c < 3; c++) {
+                const float v = std::max(-1.0f, std::min(1.0f, values[c]));
+                const int32_t i = static_cast<int32_t>(roundf(v * 511.0f));
+                packed |= (static_cast<uint32_t>(i) & 0x3FF) << (c * 10);
+            }
+            memcpy(out, &packed, sizeof(packed));
+            break;
+        }
+        case VERTEX_ENCODING_UNORM8:
+            for (int c = 0; c < 4; c++) {
+                const float v = (c < components) ? values[c] : 0.0f;
+                out[c] = static_cast<uint8_t>(std::max(0.0f, std::min(1.0f, v)) * 255.0f + 0.5f);
+            }
+            break;
+        default:
+            memcpy(out, values, components * sizeof(float));
+            break;
+    }
+}
+
+bool GlVertexFormat::IsFloat() const {
+    return position == VERTEX_ENCODING_FLOAT && normal == VERTEX_ENCODING_FLOAT &&
+        tangent == VERTEX_ENCODING_FLOAT && binormal == VERTEX_ENCODING_FLOAT &&
+        color == VERTEX_ENCODING_FLOAT && uv0 == VERTEX_ENCODING_FLOAT &&
+        uv1 == VERTEX_ENCODING_FLOAT && jointIndices == VERTEX_ENCODING_FLOAT &&
+        jointWeights == VERTEX_ENCODING_FLOAT;
+}
+
+GlVertexFormat GlVertexFormat::ChooseCompact(
+    const VertexAttribs& attribs,
+    const float positionTolerance,
+    const float uvTolerance) {
+    GlVertexFormat format;
+    if (FitsHalf(FloatData(attribs.position), attribs.position.size() * 3, positionTolerance)) {
+        format.position = VERTEX_ENCODING_HALF;
+    }
+    // shaders normalize the interpolated vectors anyway, so only the range matters
+    if (InRange(FloatData(attribs.normal), attribs.normal.size() * 3, -1.0f, 1.0f)) {
+        format.normal = VERTEX_ENCODING_SNORM_10_10_10_2;
+    }
+    if (InRange(FloatData(attribs.tangent), attribs.tangent.size() * 3, -1.0f, 1.0f)) {
+        format.tangent = VERTEX_ENCODING_SNORM_10_10_10_2;
+    }
+    if (InRange(FloatData(attribs.binormal), attribs.binormal.size() * 3, -1.0f, 1.0f)) {
+        format.binormal = VERTEX_ENCODING_SNORM_10_10_10_2;
+    }
+    if (InRange(FloatData(attribs.color), attribs.color.size() * 4, 0.0f, 1.0f)) {
+        format.color = VERTEX_ENCODING_UNORM8;
+    }
+    if (FitsHalf(FloatData(attribs.uv0), attribs.uv0.size() * 2, uvTolerance)) {
+        format.uv0 = VERTEX_ENCODING_HALF;
+    }
+    if (FitsHalf(FloatData(attribs.uv1), attribs.uv1.size() * 2, uvTolerance)) {
+        format.uv1 = VERTEX_ENCODING_HALF;
+    }
+    bool smallJointIndices = true;
+    for (const OVR::Vector4i& j : attribs.jointIndices) {
+        for (int c = 0; c < 4; c++) {
+            smallJointIndices &= (j[c] >= 0 && j[c] <= 255);
+        }
+    }
+    if (smallJointIndices) {
+        format.jointIndices = VERTEX_ENCODING_UINT8;
+    }
+    if (InRange(FloatData(attribs.jointWeights), attribs.jointWeights.size() * 4, 0.0f, 1.0f)) {
+        format.jointWeights = VERTEX_ENCODING_UNORM8;
+    }
+    return format;
+}
+
 void GlGeometry::Create(const VertexAttribs& attribs, const std::vector<TriangleIndex>& indices) {
     vertexCount = attribs.position.size();
     indexCount = indices.size();
+    indexType = GL_UNSIGNED_SHORT;
 
     const bool t = enableGeometryTransfom;
 
@@ -155,14 +335,250 @@ void GlGeometry::Create(const VertexAttribs& attribs, const std::vector<Triangle
     }
 }
 
-void GlGeometry::Update(const VertexAttribs& attribs, const bool updateBounds) {
-    vertexCount = attribs.position.size();
+void GlGeometry::Create(
+    const VertexAttribs& attribs,
+    const std::vector<TriangleIndex>& indices,
+    const GlVertexFormat& format) {
+    std::vector<uint8_t> vertices;
+    std::vector<GlVertexAttribute> attributes;
+    int vertexStride = 0;
+    if (format.IsFloat() || enableGeometryTransfom ||
+        !PackInterleavedVertices(attribs, format, vertices, attributes, vertexStride)) {
+        Create(attribs, indices);
+        return;
+    }
+
+    Bounds3f bounds(Bounds3f::Init);
+    for (const Vector3f& p : attribs.position) {
+        bounds.AddPoint(p);
+    }
+    CreateInterleaved(
+        vertices.data(),
+        static_cast<int>(attribs.position.size()),
+        vertexStride,
+        attributes.data(),
+        static_cast<int>(attributes.size()),
+        indices.data(),
+        static_cast<int>(indices.size()),
+        bounds);
+}
+
+void GlGeometry::Create(
+    const VertexAttribs& attribs,
+    const std::vector<TriangleIndex32>& indices,
+    const GlVertexFormat& format) {
+    if (attribs.position.size() <= static_cast<size_t>(MAX_GEOMETRY_VERTICES)) {
+        // half the index memory and bandwidth
+        const std::vector<TriangleIndex> narrow(indices.begin(), indices.end());
+        Create(attribs, narrow, format);
+        return;
+    }
+
+    Create(attribs, std::vector<TriangleIndex>(), format);
 
     glBindVertexArray(vertexArrayObject);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(
+        GL_ELEMENT_ARRAY_BUFFER,
+        indices.size() * sizeof(indices[0]),
+        indices.data(),
+        GL_STATIC_DRAW);
+    glBindVertexArray(0);
 
+    indexCount = indices.size();
+    indexType = GL_UNSIGNED_INT;
+}
+
+void GlGeometry::CreateInterleaved(
+    const void* vertices,
+    const int numVertices,
+    const int vertexStride,
+    const GlVertexAttribute* attributes,
+    const int numAttributes,
+    const void* indices,
+    const int numIndices,
+    const Bounds3f& bounds,
+    const unsigned glIndexType) {
+    vertexCount = numVertices;
+    indexCount = numIndices;
+    indexType = glIndexType;
+
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &indexBuffer);
+    glGenVertexArrays(1, &vertexArrayObject);
+    glBindVertexArray(vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
 
-    std::vector<uint8_t> packed;
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * vertexStride, vertices, GL_STATIC_DRAW);
+
+    static const int locations[] = {
+        VERTEX_ATTRIBUTE_LOCATION_POSITION,
+        VERTEX_ATTRIBUTE_LOCATION_NORMAL,
+        VERTEX_ATTRIBUTE_LOCATION_TANGENT,
+        VERTEX_ATTRIBUTE_LOCATION_BINORMAL,
+        VERTEX_ATTRIBUTE_LOCATION_COLOR,
+        VERTEX_ATTRIBUTE_LOCATION_UV0,
+        VERTEX_ATTRIBUTE_LOCATION_UV1,
+        VERTEX_ATTRIBUTE_LOCATION_JOINT_INDICES,
+        VERTEX_ATTRIBUTE_LOCATION_JOINT_WEIGHTS};
+    for (const int location : locations) {
+        glDisableVertexAttribArray(location);
+    }
+    for (int i = 0; i < numAttributes; i++) {
+        const GlVertexAttribute& a = attributes[i];
+        glEnableVertexAttribArray(a.location);
+        glVertexAttribPointer(
+            a.location,
+            a.components,
+            a.glType,
+            a.normalized != 0,
+            vertexStride,
+            (void*)(size_t)a.offset);
+    }
+
+    const size_t indexSize =
+        (indexType == GL_UNSIGNED_INT) ? sizeof(TriangleIndex32) : sizeof(TriangleIndex);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * indexSize, indices, GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+
+    for (const int location : locations) {
+        glDisableVertexAttribArray(location);
+    }
+
+    localBounds = bounds;
+}
+
+bool GlGeometry::PackInterleavedVertices(
+    const VertexAttribs& attribs,
+    const GlVertexFormat& format,
+    std::vector<uint8_t>& vertices,
+    std::vector<GlVertexAttribute>& attributes,
+    int& vertexStride) {
+    struct ovrSourceAttribute {
+        const float* values;
+        size_t count;
+        uint32_t location;
+        int components;
+        GlVertexEncoding encoding;
+    };
+    // same attributes, in the same order, as Create(); joint indices are ints and handled below
+    const ovrSourceAttribute sources[] = {
+        {FloatData(attribs.position),
+         attribs.position.size(),
+         VERTEX_ATTRIBUTE_LOCATION_POSITION,
+         3,
+         format.position},
+        {FloatData(attribs.normal),
+         attribs.normal.size(),
+         VERTEX_ATTRIBUTE_LOCATION_NORMAL,
+         3,
+         format.normal},
+        {FloatData(attribs.tangent),
+         attribs.tangent.size(),
+         VERTEX_ATTRIBUTE_LOCATION_TANGENT,
+         3,
+         format.tangent},
+        {FloatData(attribs.binormal),
+         attribs.binormal.size(),
+         VERTEX_ATTRIBUTE_LOCATION_BINORMAL,
+         3,
+         format.binormal},
+        {FloatData(attribs.color),
+         attribs.color.size(),
+         VERTEX_ATTRIBUTE_LOCATION_COLOR,
+         4,
+         format.color},
+        {FloatData(attribs.uv0), attribs.uv0.size(), VERTEX_ATTRIBUTE_LOCATION_UV0, 2, format.uv0},
+        {FloatData(attribs.uv1), attribs.uv1.size(), VERTEX_ATTRIBUTE_LOCATION_UV1, 2, format.uv1},
+        {nullptr,
+         attribs.jointIndices.size(),
+         VERTEX_ATTRIBUTE_LOCATION_JOINT_INDICES,
+         4,
+         format.jointIndices},
+        {FloatData(attribs.jointWeights),
+         attribs.jointWeights.size(),
+         VERTEX_ATTRIBUTE_LOCATION_JOINT_WEIGHTS,
+         4,
+         format.jointWeights},
+    };
+
+    const size_t numVertices = attribs.position.size();
+    attributes.clear();
+    vertexStride = 0;
+    for (const ovrSourceAttribute& source : sources) {
+        if (source.count == 0) {
+            continue;
+        }
+        if (source.count != numVertices) {
+            return false;
+        }
+        const bool jointIndices = (source.location == VERTEX_ATTRIBUTE_LOCATION_JOINT_INDICES);
+        GlVertexAttribute a;
+        a.location = source.location;
+        a.components = static_cast<uint16_t>(source.components);
+        a.normalized = 0;
+        a.offset = static_cast<uint32_t>(vertexStride);
+        switch (source.encoding) {
+            case VERTEX_ENCODING_HALF:
+                a.glType = GL_HALF_FLOAT;
+                break;
+            case VERTEX_ENCODING_SNORM_10_10_10_2:
+                // the packed type always has four components
+                a.glType = GL_INT_2_10_10_10_REV;
+                a.components = 4;
+                a.normalized = 1;
+                break;
+            case VERTEX_ENCODING_UNORM8:
+                a.glType = GL_UNSIGNED_BYTE;
+                a.components = 4;
+                a.normalized = 1;
+                break;
+            case VERTEX_ENCODING_UINT8:
+                a.glType = GL_UNSIGNED_BYTE;
+                a.components = 4;
+                break;
+            default:
+                a.glType = jointIndices ? GL_INT : GL_FLOAT;
+                break;
+        }
+        attributes.push_back(a);
+        vertexStride += GetEncodedSize(source.encoding, source.components);
+    }
+
+    vertices.resize(numVertices * vertexStride);
+    for (size_t a = 0, s = 0; a < attributes.size(); s++) {
+        const ovrSourceAttribute& source = sources[s];
+        if (source.count == 0) {
+            continue;
+        }
+        const GlVertexAttribute& attribute = attributes[a++];
+        uint8_t* out = vertices.data() + attribute.offset;
+        if (source.values == nullptr) {
+            for (size_t i = 0; i < numVertices; i++, out += vertexStride) {
+                const OVR::Vector4i& j = attribs.jointIndices[i];
+                if (source.encoding == VERTEX_ENCODING_UINT8) {
+                    for (int c = 0; c < 4; c++) {
+                        out[c] = static_cast<uint8_t>(j[c]);
+                    }
+                } else {
+                    memcpy(out, &j, sizeof(j));
+                }
+            }
+            continue;
+        }
+        for (size_t i = 0; i < numVertices; i++, out += vertexStride) {
+            EncodeVertexValues(
+                source.encoding, source.values + i * source.components, source.components, out);
+        }
+    }
+    return true;
+}
+
+// Packs the attributes one after another, as Create() does without a transform, and points the
+// bound VAO's attributes at them.
+static void PackPlanarVertices(std::vector<uint8_t>& packed, const VertexAttribs& attribs) {
     PackVertexAttribute(packed, attribs.position, VERTEX_ATTRIBUTE_LOCATION_POSITION, GL_FLOAT, 3);
     PackVertexAttribute(packed, attribs.normal, VERTEX_ATTRIBUTE_LOCATION_NORMAL, GL_FLOAT, 3);
     PackVertexAttribute(packed, attribs.tangent, VERTEX_ATTRIBUTE_LOCATION_TANGENT, GL_FLOAT, 3);
@@ -174,6 +590,33 @@ void GlGeometry::Update(const VertexAttribs& attribs, const bool updateBounds) {
         packed, attribs.jointIndices, VERTEX_ATTRIBUTE_LOCATION_JOINT_INDICES, GL_INT, 4);
     PackVertexAttribute(
         packed, attribs.jointWeights, VERTEX_ATTRIBUTE_LOCATION_JOINT_WEIGHTS, GL_FLOAT, 4);
+}
+
+// Orphans the bound buffer's store and writes data at the start of a fresh one, so the driver
+// doesn't have to wait for draws still reading the old contents. The store only grows.
+static void StreamBufferData(
+    const GLenum target,
+    const size_t size,
+    const void* data,
+    size_t& storeSize) {
+    if (size > storeSize) {
+        storeSize = std::max(size, storeSize + storeSize / 2);
+    }
+    glBufferData(target, storeSize, nullptr, GL_STREAM_DRAW);
+    if (size > 0) {
+        glBufferSubData(target, 0, size, data);
+    }
+}
+
+void GlGeometry::Update(const VertexAttribs& attribs, const bool updateBounds) {
+    vertexCount = attribs.position.size();
+
+    glBindVertexArray(vertexArrayObject);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+
+    std::vector<uint8_t> packed;
+    PackPlanarVertices(packed, attribs);
 
     glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(packed[0]), packed.data(), GL_STATIC_DRAW);
 
@@ -185,6 +628,46 @@ void GlGeometry::Update(const VertexAttribs& attribs, const bool updateBounds) {
     }
 }
 
+void GlGeometry::Stream(
+    const VertexAttribs& attribs,
+    const std::vector<TriangleIndex>& indices,
+    const bool updateBounds) {
+    if (vertexArrayObject == 0) {
+        glGenBuffers(1, &vertexBuffer);
+        glGenBuffers(1, &indexBuffer);
+        glGenVertexArrays(1, &vertexArrayObject);
+        vertexStoreSize = 0;
+        indexStoreSize = 0;
+    }
+    vertexCount = attribs.position.size();
+    indexCount = indices.size();
+    indexType = GL_UNSIGNED_SHORT;
+
+    glBindVertexArray(vertexArrayObject);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    streamPacked.resize(0);
+    PackPlanarVertices(streamPacked, attribs);
+    StreamBufferData(GL_ARRAY_BUFFER, streamPacked.size(), streamPacked.data(), vertexStoreSize);
+
+    // the VAO is bound, so this binding is part of its state
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    StreamBufferData(
+        GL_ELEMENT_ARRAY_BUFFER,
+        indices.size() * sizeof(indices[0]),
+        indices.data(),
+        indexStoreSize);
+
+    glBindVertexArray(0);
+
+    if (updateBounds) {
+        localBounds.Clear();
+        for (int i = 0; i < vertexCount; i++) {
+            localBounds.AddPoint(attribs.position[i]);
+        }
+    }
+}
+
 void GlGeometry::Free() {
     glDeleteVertexArrays(1, &vertexArrayObject);
     glDeleteBuffers(1, &indexBuffer);
@@ -195,6 +678,9 @@ void GlGeometry::Free() {
     vertexArrayObject = 0;
     vertexCount = 0;
     indexCount = 0;
+    vertexStoreSize = 0;
+    indexStoreSize = 0;
+    std::vector<uint8_t>().swap(streamPacked);
 
     localBounds.Clear();
 }
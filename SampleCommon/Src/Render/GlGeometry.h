@@ -30,6 +30,62 @@ struct VertexAttribs {
 };
 
 typedef uint16_t TriangleIndex;
+// Indices for geometry with more vertices than 16 bit indices can address.
+typedef uint32_t TriangleIndex32;
+
+// One attribute of an interleaved vertex buffer. Plain data so it can be stored as-is in cooked
+// model files.
+struct GlVertexAttribute {
+    uint32_t location; // VERTEX_ATTRIBUTE_LOCATION_*
+    uint32_t glType; // GL_FLOAT, GL_INT, GL_HALF_FLOAT, GL_INT_2_10_10_10_REV, GL_UNSIGNED_BYTE
+    uint16_t components;
+    uint16_t normalized; // fixed point values are read as [0,1] or [-1,1] floats
+    uint32_t offset; // byte offset of the attribute inside a vertex
+};
+
+// How a vertex attribute is stored in the vertex buffer. The shaders see floats either way.
+enum GlVertexEncoding : uint8_t {
+    VERTEX_ENCODING_FLOAT, // 32 bit floats, or 32 bit ints for joint indices
+    VERTEX_ENCODING_HALF, // 16 bit floats, padded to an even number of components
+    VERTEX_ENCODING_SNORM_10_10_10_2, // three signed normalized 10 bit values, for unit vectors
+    VERTEX_ENCODING_UNORM8, // four unsigned normalized bytes, for values in [0,1]
+    VERTEX_ENCODING_UINT8 // four unsigned bytes, for joint indices up to 255
+};
+
+// Encoding of each attribute in VertexAttribs. The default is the full float layout.
+struct GlVertexFormat {
+    GlVertexFormat()
+        : position(VERTEX_ENCODING_FLOAT),
+          normal(VERTEX_ENCODING_FLOAT),
+          tangent(VERTEX_ENCODING_FLOAT),
+          binormal(VERTEX_ENCODING_FLOAT),
+          color(VERTEX_ENCODING_FLOAT),
+          uv0(VERTEX_ENCODING_FLOAT),
+          uv1(VERTEX_ENCODING_FLOAT),
+          jointIndices(VERTEX_ENCODING_FLOAT),
+          jointWeights(VERTEX_ENCODING_FLOAT) {}
+
+    bool IsFloat() const;
+
+    // Picks the smallest encoding for each attribute that represents all of its values: half
+    // floats for positions and texture coordinates if every value survives the round trip within
+    // the tolerance, 10:10:10:2 for normals, tangents and binormals, bytes for colors, weights and
+    // joint indices that are in range. Anything else stays float.
+    static GlVertexFormat ChooseCompact(
+        const VertexAttribs& attribs,
+        const float positionTolerance = 0.0005f,
+        const float uvTolerance = 1.0f / 4096.0f);
+
+    GlVertexEncoding position;
+    GlVertexEncoding normal;
+    GlVertexEncoding tangent;
+    GlVertexEncoding binormal;
+    GlVertexEncoding color;
+    GlVertexEncoding uv0;
+    GlVertexEncoding uv1;
+    GlVertexEncoding jointIndices;
+    GlVertexEncoding jointWeights;
+};
 
 class GlGeometry {
    public:
@@ -38,24 +94,63 @@ class GlGeometry {
           indexBuffer(0),
           vertexArrayObject(0),
           primitiveType(0x0004 /* GL_TRIANGLES */),
+          indexType(0x1403 /* GL_UNSIGNED_SHORT */),
           vertexCount(0),
           indexCount(0),
-          localBounds(OVR::Bounds3f::Init) {}
+          localBounds(OVR::Bounds3f::Init),
+          vertexStoreSize(0),
+          indexStoreSize(0) {}
 
     GlGeometry(const VertexAttribs& attribs, const std::vector<TriangleIndex>& indices)
         : vertexBuffer(0),
           indexBuffer(0),
           vertexArrayObject(0),
           primitiveType(0x0004 /* GL_TRIANGLES */),
+          indexType(0x1403 /* GL_UNSIGNED_SHORT */),
           vertexCount(0),
           indexCount(0),
-          localBounds(OVR::Bounds3f::Init) {
+          localBounds(OVR::Bounds3f::Init),
+          vertexStoreSize(0),
+          indexStoreSize(0) {
         Create(attribs, indices);
     }
 
     // Create the VAO and vertex and index buffers from arrays of data.
     void Create(const VertexAttribs& attribs, const std::vector<TriangleIndex>& indices);
+    // Same, with the attributes encoded as in format and interleaved. Under a TransformScope, or
+    // with an all float format, this is the same as the plain Create().
+    void Create(
+        const VertexAttribs& attribs,
+        const std::vector<TriangleIndex>& indices,
+        const GlVertexFormat& format);
+    // Same, for geometry that may have more than MAX_GEOMETRY_VERTICES vertices. The indices are
+    // stored as 16 bits if the vertices fit, otherwise as 32 bits; indexType tells which.
+    void Create(
+        const VertexAttribs& attribs,
+        const std::vector<TriangleIndex32>& indices,
+        const GlVertexFormat& format = GlVertexFormat());
+    // Create the VAO and vertex and index buffers from an already interleaved vertex buffer, such
+    // as one mapped straight from a cooked model file. The data is handed to GL without any
+    // per-vertex work, so the bounds have to be supplied. indices are TriangleIndex values, or
+    // TriangleIndex32 values if glIndexType is GL_UNSIGNED_INT.
+    void CreateInterleaved(
+        const void* vertices,
+        const int numVertices,
+        const int vertexStride,
+        const GlVertexAttribute* attributes,
+        const int numAttributes,
+        const void* indices,
+        const int numIndices,
+        const OVR::Bounds3f& bounds,
+        const unsigned glIndexType = 0x1403 /* GL_UNSIGNED_SHORT */);
     void Update(const VertexAttribs& attribs, const bool updateBounds = true);
+    // Uploads both the vertices and the indices, for geometry that is rebuilt every frame. The
+    // buffers are GL_STREAM_DRAW and are created on the first call; each call orphans them and
+    // writes the new data with glBufferSubData, and they are only reallocated to grow.
+    void Stream(
+        const VertexAttribs& attribs,
+        const std::vector<TriangleIndex>& indices,
+        const bool updateBounds = true);
 
     // Free the buffers and VAO, assuming that they are strictly for this geometry.
     // We could save some overhead by packing an entire model into a single buffer, but
@@ -63,24 +158,43 @@ class GlGeometry {
     // This is not in the destructor to allow objects of this class to be passed by value.
     void Free();
 
+    // Encodes the attributes as in format into a single interleaved vertex buffer, and fills in
+    // the attribute layout for CreateInterleaved(). Returns false if the attributes don't all have
+    // one value per position, which only the planar layout of Create() can handle.
+    static bool PackInterleavedVertices(
+        const VertexAttribs& attribs,
+        const GlVertexFormat& format,
+        std::vector<uint8_t>& vertices,
+        std::vector<GlVertexAttribute>& attributes,
+        int& vertexStride);
+
    public:
     static constexpr int32_t MAX_GEOMETRY_VERTICES = 1 << (sizeof(TriangleIndex) * 8);
+    // limit for geometry created from TriangleIndex32 indices
+    static constexpr int32_t MAX_GEOMETRY_VERTICES_32 = 16 * 1024 * 1024;
     static constexpr int32_t MAX_GEOMETRY_INDICES = 1024 * 1024 * 3;
 
     static constexpr inline int32_t GetMaxGeometryVertices() {
         return MAX_GEOMETRY_VERTICES;
     }
+    static constexpr inline int32_t GetMaxGeometryVertices32() {
+        return MAX_GEOMETRY_VERTICES_32;
+    }
     static constexpr inline int32_t GetMaxGeometryIndices() {
         return MAX_GEOMETRY_INDICES;
     }
 
-    static unsigned IndexType; // GL_UNSIGNED_SHORT, GL_UNSIGNED_INT, etc.
-
     class TransformScope {
        public:
         TransformScope(const OVR::Matrix4f m, bool enableTransfom = true);
         ~TransformScope();
 
+        // True while a scope has enabled the transform, in which case Create() does not upload
+        // the attributes it was given unchanged.
+        static bool IsEnabled();
+        // The transform Create() applies while IsEnabled().
+        static OVR::Matrix4f GetTransform();
+
        private:
         OVR::Matrix4f previousTransform;
         bool wasEnabled;
@@ -104,9 +218,15 @@ class GlGeometry {
     unsigned indexBuffer;
     unsigned vertexArrayObject;
     unsigned primitiveType; // GL_TRIANGLES / GL_LINES / GL_POINTS / etc
+    unsigned indexType; // GL_UNSIGNED_SHORT, GL_UNSIGNED_INT
     int vertexCount;
     int indexCount;
     OVR::Bounds3f localBounds;
+    // sizes of the buffer stores allocated by Stream()
+    size_t vertexStoreSize;
+    size_t indexStoreSize;
+    // Stream() packs the vertices here, so the memory is reused from one call to the next
+    std::vector<uint8_t> streamPacked;
 };
 
 // Build it in a -1 to 1 range, which will be scaled to the appropriate
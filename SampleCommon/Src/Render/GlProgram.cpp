@@ -10,6 +10,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 *************************************************************************************/
 
 #include "GlProgram.h"
+#include "GlProgramCache.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -20,6 +21,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "OVR_Std.h"
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace OVRFW {
 static bool UseMultiview = false;
@@ -93,8 +96,10 @@ static const char* FindShaderVersionEnd(const char* src) {
     return src;
 }
 
-static GLuint
-CompileShader(GLenum shaderType, const char* directives, const char* src, GLint programVersion) {
+// The complete text handed to glShaderSource(): version, directives, the implicit header and
+// the source.
+static std::string
+MakeShaderSource(GLenum shaderType, const char* directives, const char* src, GLint programVersion) {
     assert(programVersion >= 300);
 
     const char* postVersion = FindShaderVersionEnd(src);
@@ -121,8 +126,45 @@ CompileShader(GLenum shaderType, const char* directives, const char* src, GLint
     }
 
     srcString.append(postVersion);
+    return srcString;
+}
+
+static void LogShaderError(GLenum shaderType, GLuint shader, const char* src) {
+    ALOGW(
+        "Compiling %s shader: ****** failed ******\n",
+        shaderType == GL_VERTEX_SHADER ? "vertex" : "fragment");
+    GLchar msg[1024];
+    const char* sp = src;
+    int charCount = 0;
+    int line = 0;
+    do {
+        if (*sp != '\n') {
+            msg[charCount++] = *sp;
+            msg[charCount] = 0;
+        }
+        if (*sp == 0 || *sp == '\n' || charCount == 1023) {
+            charCount = 0;
+            line++;
+            ALOGW("%03d  %s", line, msg);
+            msg[0] = 0;
+            if (*sp != '\n') {
+                line--;
+            }
+        }
+        sp++;
+    } while (*sp != 0);
+    if (charCount != 0) {
+        line++;
+        ALOGW("%03d  %s", line, msg);
+    }
+    glGetShaderInfoLog(shader, sizeof(msg), 0, msg);
+    ALOGW("%s\n", msg);
+}
 
-    src = srcString.c_str();
+// With checkStatus false the compile status is not queried, so a driver that compiles in the
+// background is not waited on; errors show up when the program is linked.
+static GLuint CompileShader(GLenum shaderType, const std::string& srcString, bool checkStatus) {
+    const char* src = srcString.c_str();
 
     GLuint shader = glCreateShader(shaderType);
 
@@ -133,101 +175,104 @@ CompileShader(GLenum shaderType, const char* directives, const char* src, GLint
     glShaderSource(shader, numSources, srcs, 0);
     glCompileShader(shader);
 
+    if (!checkStatus) {
+        return shader;
+    }
+
     GLint r;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &r);
     if (r == GL_FALSE) {
-        ALOGW(
-            "Compiling %s shader: ****** failed ******\n",
-            shaderType == GL_VERTEX_SHADER ? "vertex" : "fragment");
-        GLchar msg[1024];
-        const char* sp = src;
-        int charCount = 0;
-        int line = 0;
-        do {
-            if (*sp != '\n') {
-                msg[charCount++] = *sp;
-                msg[charCount] = 0;
-            }
-            if (*sp == 0 || *sp == '\n' || charCount == 1023) {
-                charCount = 0;
-                line++;
-                ALOGW("%03d  %s", line, msg);
-                msg[0] = 0;
-                if (*sp != '\n') {
-                    line--;
-                }
-            }
-            sp++;
-        } while (*sp != 0);
-        if (charCount != 0) {
-            line++;
-            ALOGW("%03d  %s", line, msg);
-        }
-        glGetShaderInfoLog(shader, sizeof(msg), 0, msg);
-        ALOGW("%s\n", msg);
+        LogShaderError(shaderType, shader, src);
         glDeleteShader(shader);
         return 0;
     }
     return shader;
 }
 
-GlProgram GlProgram::Build(
-    const char* vertexSrc,
-    const char* fragmentSrc,
-    const ovrProgramParm* parms,
-    const int numParms,
-    const int requestedProgramVersion,
-    bool abortOnError) {
-    return Build(
-        NULL, vertexSrc, NULL, fragmentSrc, parms, numParms, requestedProgramVersion, abortOnError);
-}
+static ovrProgramBinaryCache ProgramBinaryCache;
 
-GlProgram GlProgram::Build(
+// What FinishProgram() needs to know about a program that was started.
+struct ovrStartedProgram {
+    ovrStartedProgram() : CacheKey(0), FromBinary(false) {}
+
+    std::vector<ovrProgramParm> Parms;
+    std::string VertexSource;
+    std::string FragmentSource;
+    uint64_t CacheKey; // 0 if the binary cache is disabled
+    bool FromBinary;
+};
+
+// Programs from BuildDeferred() that have not been finished yet. Only used on the GL thread.
+static std::unordered_map<unsigned int, ovrStartedProgram> PendingPrograms;
+
+// Creates the program from the binary cache, or compiles the shaders and starts linking it.
+static bool StartProgram(
+    GlProgram& p,
+    ovrStartedProgram& started,
     const char* vertexDirectives,
     const char* vertexSrc,
     const char* fragmentDirectives,
     const char* fragmentSrc,
-    const ovrProgramParm* parms,
-    const int numParms,
-    const int requestedProgramVersion,
-    bool abortOnError) {
-    GlProgram p;
+    const int programVersion,
+    const bool deferred,
+    const bool abortOnError) {
+    started.VertexSource =
+        MakeShaderSource(GL_VERTEX_SHADER, vertexDirectives, vertexSrc, programVersion);
+    started.FragmentSource =
+        MakeShaderSource(GL_FRAGMENT_SHADER, fragmentDirectives, fragmentSrc, programVersion);
 
     //--------------------------
-    // Compile and Create the Program
+    // Try the Binary Cache
     //--------------------------
 
-    int programVersion = requestedProgramVersion;
-    if (programVersion < GLSL_PROGRAM_VERSION) {
-        ALOGW(
-            "GlProgram: Program GLSL version requested %d, but does not meet required minimum %d",
-            requestedProgramVersion,
-            GLSL_PROGRAM_VERSION);
+    if (ProgramBinaryCache.IsEnabled()) {
+        started.CacheKey = ProgramBinaryCache.MakeKey(
+            started.VertexSource.c_str(), started.FragmentSource.c_str());
+        uint32_t binaryFormat = 0;
+        std::vector<uint8_t> binary;
+        if (ProgramBinaryCache.Load(started.CacheKey, binaryFormat, binary)) {
+            p.Program = glCreateProgram();
+            glProgramBinary(
+                p.Program, binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+            GLint linkStatus = GL_FALSE;
+            glGetProgramiv(p.Program, GL_LINK_STATUS, &linkStatus);
+            if (linkStatus != GL_FALSE) {
+                started.FromBinary = true;
+                return true;
+            }
+            // drivers may reject binaries from an earlier driver that reported the same version
+            glDeleteProgram(p.Program);
+            p.Program = 0;
+            ProgramBinaryCache.Remove(started.CacheKey);
+        }
     }
 
-    p.VertexShader = CompileShader(GL_VERTEX_SHADER, vertexDirectives, vertexSrc, programVersion);
+    //--------------------------
+    // Compile and Create the Program
+    //--------------------------
+
+    p.VertexShader = CompileShader(GL_VERTEX_SHADER, started.VertexSource, !deferred);
     if (p.VertexShader == 0) {
-        Free(p);
+        GlProgram::Free(p);
         ALOG(
             "GlProgram: CompileShader GL_VERTEX_SHADER program failed: \n```%s\n```\n\n",
             vertexSrc);
         if (abortOnError) {
             ALOGE_FAIL("Failed to compile vertex shader");
         }
-        return GlProgram();
+        return false;
     }
 
-    p.FragmentShader =
-        CompileShader(GL_FRAGMENT_SHADER, fragmentDirectives, fragmentSrc, programVersion);
+    p.FragmentShader = CompileShader(GL_FRAGMENT_SHADER, started.FragmentSource, !deferred);
     if (p.FragmentShader == 0) {
-        Free(p);
+        GlProgram::Free(p);
         ALOG(
             "GlProgram: CompileShader GL_FRAGMENT_SHADER program failed: \n```%s\n```\n\n",
             fragmentSrc);
         if (abortOnError) {
             ALOGE_FAIL("Failed to compile fragment shader");
         }
-        return GlProgram();
+        return false;
     }
 
     p.Program = glCreateProgram();
@@ -253,19 +298,59 @@ GlProgram GlProgram::Build(
     // Link Program
     //--------------------------
 
+    if (started.CacheKey != 0) {
+        glProgramParameteri(p.Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(p.Program);
+    return true;
+}
 
-    GLint linkStatus;
-    glGetProgramiv(p.Program, GL_LINK_STATUS, &linkStatus);
-    if (linkStatus == GL_FALSE) {
-        GLchar msg[1024];
-        glGetProgramInfoLog(p.Program, sizeof(msg), 0, msg);
-        Free(p);
-        ALOG("GlProgram: Linking program failed: %s\n", msg);
-        if (abortOnError) {
-            ALOGE_FAIL("Failed to link program");
+// Checks the link, stores the binary if it was compiled, and resolves the uniforms. Frees the
+// program if it failed to link.
+static bool FinishProgram(
+    GlProgram& p,
+    const ovrStartedProgram& started,
+    const ovrProgramParm* parms,
+    const int numParms,
+    const bool abortOnError) {
+    if (!started.FromBinary) {
+        GLint linkStatus;
+        glGetProgramiv(p.Program, GL_LINK_STATUS, &linkStatus);
+        if (linkStatus == GL_FALSE) {
+            // deferred builds don't check the compile status up front
+            GLint compileStatus = GL_TRUE;
+            glGetShaderiv(p.VertexShader, GL_COMPILE_STATUS, &compileStatus);
+            if (compileStatus == GL_FALSE) {
+                LogShaderError(GL_VERTEX_SHADER, p.VertexShader, started.VertexSource.c_str());
+            }
+            glGetShaderiv(p.FragmentShader, GL_COMPILE_STATUS, &compileStatus);
+            if (compileStatus == GL_FALSE) {
+                LogShaderError(
+                    GL_FRAGMENT_SHADER, p.FragmentShader, started.FragmentSource.c_str());
+            }
+
+            GLchar msg[1024];
+            glGetProgramInfoLog(p.Program, sizeof(msg), 0, msg);
+            GlProgram::Free(p);
+            ALOG("GlProgram: Linking program failed: %s\n", msg);
+            if (abortOnError) {
+                ALOGE_FAIL("Failed to link program");
+            }
+            return false;
+        }
+
+        if (started.CacheKey != 0) {
+            GLint binaryLength = 0;
+            glGetProgramiv(p.Program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+            if (binaryLength > 0) {
+                std::vector<uint8_t> binary(binaryLength);
+                GLenum binaryFormat = 0;
+                glGetProgramBinary(
+                    p.Program, binaryLength, &binaryLength, &binaryFormat, binary.data());
+                ProgramBinaryCache.Store(
+                    started.CacheKey, binaryFormat, binary.data(), binaryLength);
+            }
         }
-        return GlProgram();
     }
 
     //--------------------------
@@ -341,13 +426,132 @@ GlProgram GlProgram::Build(
     }
 
     glUseProgram(0);
+    return true;
+}
+
+GlProgram GlProgram::Build(
+    const char* vertexSrc,
+    const char* fragmentSrc,
+    const ovrProgramParm* parms,
+    const int numParms,
+    const int requestedProgramVersion,
+    bool abortOnError) {
+    return Build(
+        NULL, vertexSrc, NULL, fragmentSrc, parms, numParms, requestedProgramVersion, abortOnError);
+}
 
+GlProgram GlProgram::Build(
+    const char* vertexDirectives,
+    const char* vertexSrc,
+    const char* fragmentDirectives,
+    const char* fragmentSrc,
+    const ovrProgramParm* parms,
+    const int numParms,
+    const int requestedProgramVersion,
+    bool abortOnError) {
+    GlProgram p;
+
+    int programVersion = requestedProgramVersion;
+    if (programVersion < GLSL_PROGRAM_VERSION) {
+        ALOGW(
+            "GlProgram: Program GLSL version requested %d, but does not meet required minimum %d",
+            requestedProgramVersion,
+            GLSL_PROGRAM_VERSION);
+    }
+
+    ovrStartedProgram started;
+    if (!StartProgram(
+            p,
+            started,
+            vertexDirectives,
+            vertexSrc,
+            fragmentDirectives,
+            fragmentSrc,
+            programVersion,
+            false,
+            abortOnError) ||
+        !FinishProgram(p, started, parms, numParms, abortOnError)) {
+        return GlProgram();
+    }
+    return p;
+}
+
+GlProgram GlProgram::BuildDeferred(
+    const char* vertexDirectives,
+    const char* vertexSrc,
+    const char* fragmentDirectives,
+    const char* fragmentSrc,
+    const ovrProgramParm* parms,
+    const int numParms,
+    const int requestedProgramVersion) {
+    GlProgram p;
+
+    ovrStartedProgram started;
+    if (!StartProgram(
+            p,
+            started,
+            vertexDirectives,
+            vertexSrc,
+            fragmentDirectives,
+            fragmentSrc,
+            requestedProgramVersion,
+            true,
+            false)) {
+        return GlProgram();
+    }
+    // the parms arrays are often on the caller's stack
+    started.Parms.assign(parms, parms + numParms);
+    PendingPrograms[p.Program] = std::move(started);
     return p;
 }
 
+bool GlProgram::IsBuildComplete(const GlProgram& program) {
+    if (!glExtensions.KHR_parallel_shader_compile ||
+        PendingPrograms.find(program.Program) == PendingPrograms.end()) {
+        return true;
+    }
+    GLint completed = GL_TRUE;
+    glGetProgramiv(program.Program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed != GL_FALSE;
+}
+
+bool GlProgram::FinishBuild(GlProgram& program, bool abortOnError) {
+    auto it = PendingPrograms.find(program.Program);
+    if (it == PendingPrograms.end()) {
+        return program.IsValid();
+    }
+    ovrStartedProgram started = std::move(it->second);
+    PendingPrograms.erase(it);
+
+    if (!FinishProgram(
+            program,
+            started,
+            started.Parms.data(),
+            static_cast<int>(started.Parms.size()),
+            abortOnError)) {
+        program = GlProgram();
+        return false;
+    }
+    return true;
+}
+
+void GlProgram::SetBinaryCacheFolder(const char* folder) {
+    std::string driver;
+    const char* strings[] = {(const char*)glGetString(GL_VENDOR),
+                             (const char*)glGetString(GL_RENDERER),
+                             (const char*)glGetString(GL_VERSION)};
+    for (const char* str : strings) {
+        driver += (str != nullptr) ? str : "";
+        driver += '\n';
+    }
+    ProgramBinaryCache.SetDriver(driver.c_str());
+    ProgramBinaryCache.SetFolder(folder);
+}
+
 void GlProgram::Free(GlProgram& prog) {
     glUseProgram(0);
     if (prog.Program != 0) {
+        PendingPrograms.erase(prog.Program);
         glDeleteProgram(prog.Program);
     }
     if (prog.VertexShader != 0) {
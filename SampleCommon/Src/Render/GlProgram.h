@@ -131,6 +131,29 @@ struct GlProgram {
         const int programVersion = GLSL_PROGRAM_VERSION, // minimum requirement
         bool abortOnError = true);
 
+    // Compiles and starts linking the program without waiting for the driver. Call FinishBuild()
+    // before the program is used; with GL_KHR_parallel_shader_compile the driver compiles on its
+    // own threads, so starting a batch of programs and then finishing them overlaps the work.
+    // The parms are copied.
+    static GlProgram BuildDeferred(
+        const char* vertexDirectives,
+        const char* vertexSrc,
+        const char* fragmentDirectives,
+        const char* fragmentSrc,
+        const ovrProgramParm* parms,
+        const int numParms,
+        const int programVersion = GLSL_PROGRAM_VERSION);
+    // True if FinishBuild() will not block. Always true without GL_KHR_parallel_shader_compile.
+    static bool IsBuildComplete(const GlProgram& program);
+    // Checks the link and resolves the uniforms of a program from BuildDeferred(). Frees the
+    // program and returns false if it failed.
+    static bool FinishBuild(GlProgram& program, bool abortOnError = true);
+
+    // Linked program binaries are stored in this folder and loaded by later builds of the same
+    // sources, skipping compilation. Must be called with the GL context current, since the
+    // binaries are only reused with the driver that produced them.
+    static void SetBinaryCacheFolder(const char* folder);
+
     static void Free(GlProgram& program);
 
     static void SetUseMultiview(const bool useMultiview_);
@@ -0,0 +1,170 @@
+/************************************************************************************
+
+Filename    :   GlProgramCache.cpp
+Content     :   On-disk cache of linked program binaries.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "GlProgramCache.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Misc/Log.h"
+
+namespace OVRFW {
+
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+//==============================
+// ovrProgramBinaryCache::ovrProgramBinaryCache
+ovrProgramBinaryCache::ovrProgramBinaryCache() : DriverHash(FNV_OFFSET_BASIS) {}
+
+//==============================
+// ovrProgramBinaryCache::SetFolder
+void ovrProgramBinaryCache::SetFolder(const char* folder) {
+    Folder = (folder != nullptr) ? folder : "";
+    if (!Folder.empty() && Folder.back() != '/') {
+        Folder += '/';
+    }
+}
+
+//==============================
+// ovrProgramBinaryCache::SetDriver
+void ovrProgramBinaryCache::SetDriver(const char* driver) {
+    DriverHash = Hash(driver, FNV_OFFSET_BASIS);
+}
+
+//==============================
+// ovrProgramBinaryCache::Hash
+uint64_t ovrProgramBinaryCache::Hash(const void* data, const size_t length, uint64_t hash) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+//==============================
+// ovrProgramBinaryCache::Hash
+uint64_t ovrProgramBinaryCache::Hash(const char* str, uint64_t hash) {
+    if (str != nullptr) {
+        hash = Hash(str, strlen(str), hash);
+    }
+    // terminate every string so moving text from one shader to the other changes the key
+    const uint8_t separator = 0;
+    return Hash(&separator, 1, hash);
+}
+
+//==============================
+// ovrProgramBinaryCache::MakeKey
+uint64_t ovrProgramBinaryCache::MakeKey(const char* vertexSource, const char* fragmentSource)
+    const {
+    uint64_t key = Hash(&DriverHash, sizeof(DriverHash), FNV_OFFSET_BASIS);
+    const uint32_t version = VERSION;
+    key = Hash(&version, sizeof(version), key);
+    key = Hash(vertexSource, key);
+    key = Hash(fragmentSource, key);
+    return key;
+}
+
+//==============================
+// ovrProgramBinaryCache::GetPath
+std::string ovrProgramBinaryCache::GetPath(const uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".glbin", key);
+    return Folder + name;
+}
+
+//==============================
+// ovrProgramBinaryCache::Load
+bool ovrProgramBinaryCache::Load(
+    const uint64_t key,
+    uint32_t& binaryFormat,
+    std::vector<uint8_t>& binary) const {
+    if (!IsEnabled()) {
+        return false;
+    }
+    const std::string path = GetPath(key);
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == nullptr) {
+        return false;
+    }
+
+    ovrHeader header;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 && header.Magic == MAGIC &&
+        header.Version == VERSION && header.Key == key && header.DriverHash == DriverHash &&
+        header.BinarySize > 0;
+    if (ok) {
+        binary.resize(header.BinarySize);
+        ok = fread(binary.data(), 1, binary.size(), f) == binary.size() &&
+            Hash(binary.data(), binary.size(), FNV_OFFSET_BASIS) == header.BinaryHash;
+    }
+    fclose(f);
+
+    if (!ok) {
+        ALOGW("ovrProgramBinaryCache: removing stale or damaged '%s'", path.c_str());
+        remove(path.c_str());
+        binary.clear();
+        return false;
+    }
+    binaryFormat = header.BinaryFormat;
+    return true;
+}
+
+//==============================
+// ovrProgramBinaryCache::Store
+bool ovrProgramBinaryCache::Store(
+    const uint64_t key,
+    const uint32_t binaryFormat,
+    const void* binary,
+    const size_t binarySize) const {
+    if (!IsEnabled() || binary == nullptr || binarySize == 0 || binarySize > UINT32_MAX) {
+        return false;
+    }
+
+    ovrHeader header;
+    memset(&header, 0, sizeof(header));
+    header.Magic = MAGIC;
+    header.Version = VERSION;
+    header.Key = key;
+    header.DriverHash = DriverHash;
+    header.BinaryHash = Hash(binary, binarySize, FNV_OFFSET_BASIS);
+    header.BinaryFormat = binaryFormat;
+    header.BinarySize = static_cast<uint32_t>(binarySize);
+
+    // write to a temporary file and rename it, so a partially written file is never loaded
+    const std::string path = GetPath(key);
+    const std::string tempPath = path + ".tmp";
+    FILE* f = fopen(tempPath.c_str(), "wb");
+    if (f == nullptr) {
+        ALOGW("ovrProgramBinaryCache: can't write '%s'", tempPath.c_str());
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+        fwrite(binary, 1, binarySize, f) == binarySize;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tempPath.c_str(), path.c_str()) != 0) {
+        ALOGW("ovrProgramBinaryCache: failed to write '%s'", path.c_str());
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+//==============================
+// ovrProgramBinaryCache::Remove
+void ovrProgramBinaryCache::Remove(const uint64_t key) const {
+    if (IsEnabled()) {
+        remove(GetPath(key).c_str());
+    }
+}
+
+} // namespace OVRFW
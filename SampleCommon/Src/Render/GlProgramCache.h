@@ -0,0 +1,78 @@
+/************************************************************************************
+
+Filename    :   GlProgramCache.h
+Content     :   On-disk cache of linked program binaries.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace OVRFW {
+
+//==============================================================
+// ovrProgramBinaryCache
+// Stores the binaries of linked programs, one file per program, so later launches can hand them
+// to glProgramBinary() instead of compiling. A program's key hashes everything that goes into
+// its shader sources together with the driver, so changed shaders or a driver update simply
+// miss. A binary the driver rejects anyway is removed by the caller. Nothing in here touches
+// GL.
+//
+// File layout: header | binary
+class ovrProgramBinaryCache {
+   public:
+    static const uint32_t MAGIC = ('O' << 0) | ('V' << 8) | ('P' << 16) | ('B' << 24);
+    static const uint32_t VERSION = 1;
+
+    struct ovrHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint64_t Key;
+        uint64_t DriverHash;
+        uint64_t BinaryHash;
+        uint32_t BinaryFormat;
+        uint32_t BinarySize;
+    };
+
+    ovrProgramBinaryCache();
+
+    // An empty folder disables the cache.
+    void SetFolder(const char* folder);
+    // Identifies the driver, for instance GL_VENDOR, GL_RENDERER and GL_VERSION joined.
+    void SetDriver(const char* driver);
+
+    bool IsEnabled() const {
+        return !Folder.empty();
+    }
+
+    // Key for a program linked from these shaders. The sources are the complete text handed to
+    // glShaderSource(), including the version line, directives and headers.
+    uint64_t MakeKey(const char* vertexSource, const char* fragmentSource) const;
+
+    bool Load(const uint64_t key, uint32_t& binaryFormat, std::vector<uint8_t>& binary) const;
+    bool Store(
+        const uint64_t key,
+        const uint32_t binaryFormat,
+        const void* binary,
+        const size_t binarySize) const;
+    void Remove(const uint64_t key) const;
+
+    std::string GetPath(const uint64_t key) const;
+
+    // 64 bit FNV-1a, continuing from hash.
+    static uint64_t Hash(const void* data, const size_t length, uint64_t hash);
+    static uint64_t Hash(const char* str, uint64_t hash);
+
+   private:
+    std::string Folder;
+    uint64_t DriverHash;
+};
+
+} // namespace OVRFW
@@ -19,6 +19,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Misc/Log.h"
 #include "CompilerUtils.h"
 #include "PackageFiles.h"
+#include "AsyncLoader.h"
 #include "stb_image.h"
 
 //#define OVR_USE_PERF_TIMER
@@ -32,8 +33,12 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include <algorithm>
 #include <fstream>
 #include <locale>
+#include <memory>
 #include <cmath>
 
+#include <zlib.h>
+#include <zstd.h>
+
 #define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
 #define GL_COMPRESSED_RGBA_ASTC_5x4_KHR 0x93B1
 #define GL_COMPRESSED_RGBA_ASTC_5x5_KHR 0x93B2
@@ -203,7 +208,8 @@ static void ScanFilePath(const char* url, const char** pfilename, const char** p
 static std::string GetExtension(const std::string& s) {
     const char* ext = nullptr;
     ScanFilePath(s.c_str(), nullptr, &ext);
-    return std::string(ext);
+    // names like "DefaultImage" have no extension
+    return (ext != nullptr) ? std::string(ext) : std::string();
 }
 
 namespace OVRFW {
@@ -1406,6 +1412,311 @@ GlTexture LoadTextureKTX(
     return GlTexture(0, 0, 0);
 }
 
+/*
+
+KTX2 Container Format
+
+Byte[12] identifier
+std::uint32_t vkFormat
+std::uint32_t typeSize
+std::uint32_t pixelWidth
+std::uint32_t pixelHeight
+std::uint32_t pixelDepth
+std::uint32_t layerCount
+std::uint32_t faceCount
+std::uint32_t levelCount
+std::uint32_t supercompressionScheme
+
+std::uint32_t dfdByteOffset
+std::uint32_t dfdByteLength
+std::uint32_t kvdByteOffset
+std::uint32_t kvdByteLength
+std::uint64_t sgdByteOffset
+std::uint64_t sgdByteLength
+
+for each mipmap_level in max( 1, levelCount )
+    std::uint64_t byteOffset
+    std::uint64_t byteLength
+    std::uint64_t uncompressedByteLength
+end
+
+data format descriptor, key/value data and supercompression global data
+
+for each mipmap_level in max( 1, levelCount ), smallest level first
+    for each face in faceCount
+        Byte data[format-specific-number-of-bytes]
+    end
+end
+
+Unlike KTX1 there is no per level imageSize, and each level can be supercompressed on its own.
+
+*/
+
+#pragma pack(1)
+struct OVR_KTX2_HEADER {
+    std::uint8_t identifier[12];
+    std::uint32_t vkFormat;
+    std::uint32_t typeSize;
+    std::uint32_t pixelWidth;
+    std::uint32_t pixelHeight;
+    std::uint32_t pixelDepth;
+    std::uint32_t layerCount;
+    std::uint32_t faceCount;
+    std::uint32_t levelCount;
+    std::uint32_t supercompressionScheme;
+    std::uint32_t dfdByteOffset;
+    std::uint32_t dfdByteLength;
+    std::uint32_t kvdByteOffset;
+    std::uint32_t kvdByteLength;
+    std::uint64_t sgdByteOffset;
+    std::uint64_t sgdByteLength;
+};
+
+struct OVR_KTX2_LEVEL {
+    std::uint64_t byteOffset;
+    std::uint64_t byteLength;
+    std::uint64_t uncompressedByteLength;
+};
+#pragma pack()
+
+static const std::uint32_t KTX2_SUPERCOMPRESSION_NONE = 0;
+static const std::uint32_t KTX2_SUPERCOMPRESSION_BASIS_LZ = 1;
+static const std::uint32_t KTX2_SUPERCOMPRESSION_ZSTD = 2;
+static const std::uint32_t KTX2_SUPERCOMPRESSION_ZLIB = 3;
+
+// Maps the Vulkan formats the GL ES 3 path can upload to texture formats.
+static bool Ktx2VkFormatToTextureFormat(
+    const std::uint32_t vkFormat,
+    eTextureFormat& format,
+    bool& useSrgbFormat) {
+    // VK_FORMAT_ASTC_4x4_UNORM_BLOCK .. VK_FORMAT_ASTC_12x12_SRGB_BLOCK alternate UNORM and SRGB
+    // in the same block size order as eTextureFormat
+    if (vkFormat >= 157 && vkFormat <= 184) {
+        const int index = (vkFormat - 157) >> 1;
+        const int numAstcFormats = (Texture_ASTC_SRGB_4x4 - Texture_ASTC_Start) >> 8;
+        useSrgbFormat = ((vkFormat - 157) & 1) != 0;
+        format = static_cast<eTextureFormat>(
+            Texture_ASTC_Start + ((index + (useSrgbFormat ? numAstcFormats : 0)) << 8));
+        return true;
+    }
+    switch (vkFormat) {
+        case 23: // VK_FORMAT_R8G8B8_UNORM
+        case 29: // VK_FORMAT_R8G8B8_SRGB
+            format = Texture_RGB;
+            useSrgbFormat = (vkFormat == 29);
+            return true;
+        case 37: // VK_FORMAT_R8G8B8A8_UNORM
+        case 43: // VK_FORMAT_R8G8B8A8_SRGB
+            format = Texture_RGBA;
+            useSrgbFormat = (vkFormat == 43);
+            return true;
+        case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        case 148: // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+            format = Texture_ETC2_RGB;
+            useSrgbFormat = (vkFormat == 148);
+            return true;
+        case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+        case 152: // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+            format = Texture_ETC2_RGBA;
+            useSrgbFormat = (vkFormat == 152);
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Validates a KTX2 file and unpacks its levels, largest first with the faces of each level back
+// to back, which is the layout CreateGlTexture() and CreateGlCubeTexture() take. zstd and zlib
+// supercompressed levels are inflated. Basis Universal payloads are not supported, they need a
+// transcoder. This does not touch GL, so it can run on a loader thread.
+// The result must be released with free().
+static unsigned char* UnpackKTX2(
+    const char* fileName,
+    const unsigned char* buffer,
+    const size_t bufferLength,
+    const bool noMipMaps,
+    eTextureFormat& format,
+    bool& useSrgbFormat,
+    int& width,
+    int& height,
+    int& numFaces,
+    int& numLevels,
+    size_t& dataSize) {
+    width = 0;
+    height = 0;
+
+    if (bufferLength < sizeof(OVR_KTX2_HEADER)) {
+        ALOG("%s: Invalid KTX2 file", fileName);
+        return nullptr;
+    }
+
+    const char fileIdentifier[12] = {
+        '\xAB', 'K', 'T', 'X', ' ', '2', '0', '\xBB', '\r', '\n', '\x1A', '\n'};
+
+    const OVR_KTX2_HEADER& header = *(const OVR_KTX2_HEADER*)buffer;
+    if (memcmp(header.identifier, fileIdentifier, sizeof(fileIdentifier)) != 0) {
+        ALOG("%s: Invalid KTX2 file", fileName);
+        return nullptr;
+    }
+    if (header.vkFormat == 0 || header.supercompressionScheme == KTX2_SUPERCOMPRESSION_BASIS_LZ) {
+        // ETC1S and UASTC payloads have to be transcoded to a GPU format first
+        ALOG("%s: KTX2 file holds a Basis Universal payload, which is not supported", fileName);
+        return nullptr;
+    }
+    if (header.supercompressionScheme != KTX2_SUPERCOMPRESSION_NONE &&
+        header.supercompressionScheme != KTX2_SUPERCOMPRESSION_ZSTD &&
+        header.supercompressionScheme != KTX2_SUPERCOMPRESSION_ZLIB) {
+        ALOG(
+            "%s: KTX2 file has unsupported supercompression scheme %d",
+            fileName,
+            header.supercompressionScheme);
+        return nullptr;
+    }
+    // no support for 3D textures or texture arrays
+    if (header.pixelDepth > 1 || header.layerCount > 1) {
+        ALOG(
+            "%s: KTX2 file has unsupported depth %d or layer count %d",
+            fileName,
+            header.pixelDepth,
+            header.layerCount);
+        return nullptr;
+    }
+    if (header.faceCount != 1 && header.faceCount != 6) {
+        ALOG("%s: KTX2 file has unsupported number of faces %d", fileName, header.faceCount);
+        return nullptr;
+    }
+    if (!Ktx2VkFormatToTextureFormat(header.vkFormat, format, useSrgbFormat)) {
+        ALOG("%s: KTX2 file has unsupported vkFormat %d", fileName, header.vkFormat);
+        return nullptr;
+    }
+    if (header.pixelWidth < 1 || header.pixelWidth > 32768 || header.pixelHeight < 1 ||
+        header.pixelHeight > 32768) {
+        ALOG("%s: Invalid KTX2 size (%dx%d)", fileName, header.pixelWidth, header.pixelHeight);
+        return nullptr;
+    }
+
+    const std::uint32_t levelCount = std::max<std::uint32_t>(header.levelCount, 1u);
+    if (levelCount > 16 ||
+        sizeof(OVR_KTX2_HEADER) + levelCount * sizeof(OVR_KTX2_LEVEL) > bufferLength) {
+        ALOG("%s: Invalid KTX2 level index", fileName);
+        return nullptr;
+    }
+    const OVR_KTX2_LEVEL* levels = (const OVR_KTX2_LEVEL*)(buffer + sizeof(OVR_KTX2_HEADER));
+
+    width = header.pixelWidth;
+    height = header.pixelHeight;
+    numFaces = header.faceCount;
+    numLevels = noMipMaps ? 1 : levelCount;
+
+    // the expected size of every level follows from the format, check the file against it
+    dataSize = 0;
+    for (int i = 0, w = width, h = height; i < numLevels; i++) {
+        dataSize += GetOvrTextureSize(format, w, h) * numFaces;
+        w = std::max(w >> 1, 1);
+        h = std::max(h >> 1, 1);
+    }
+
+    unsigned char* data = static_cast<unsigned char*>(malloc(dataSize));
+    if (data == nullptr) {
+        return nullptr;
+    }
+    unsigned char* dst = data;
+    for (int i = 0, w = width, h = height; i < numLevels; i++) {
+        const size_t levelSize = GetOvrTextureSize(format, w, h) * numFaces;
+        const OVR_KTX2_LEVEL& level = levels[i];
+        bool valid = level.byteOffset <= bufferLength &&
+            level.byteLength <= bufferLength - level.byteOffset;
+        if (valid && header.supercompressionScheme == KTX2_SUPERCOMPRESSION_ZLIB) {
+            uLongf inflatedSize = static_cast<uLongf>(levelSize);
+            valid = level.uncompressedByteLength == levelSize &&
+                uncompress(
+                    dst,
+                    &inflatedSize,
+                    buffer + level.byteOffset,
+                    static_cast<uLong>(level.byteLength)) == Z_OK &&
+                inflatedSize == levelSize;
+        } else if (valid && header.supercompressionScheme == KTX2_SUPERCOMPRESSION_ZSTD) {
+            const size_t decompressedSize =
+                ZSTD_decompress(dst, levelSize, buffer + level.byteOffset, level.byteLength);
+            valid = level.uncompressedByteLength == levelSize &&
+                !ZSTD_isError(decompressedSize) && decompressedSize == levelSize;
+        } else if (valid) {
+            valid = level.byteLength == levelSize;
+            if (valid) {
+                memcpy(dst, buffer + level.byteOffset, levelSize);
+            }
+        }
+        if (!valid) {
+            ALOG("%s: KTX2 level %d is invalid", fileName, i);
+            free(data);
+            width = 0;
+            height = 0;
+            return nullptr;
+        }
+        dst += levelSize;
+        w = std::max(w >> 1, 1);
+        h = std::max(h >> 1, 1);
+    }
+    return data;
+}
+
+GlTexture LoadTextureKTX2(
+    const char* fileName,
+    const unsigned char* buffer,
+    const int bufferLength,
+    bool useSrgbFormat,
+    bool noMipMaps,
+    int& width,
+    int& height) {
+    eTextureFormat format = Texture_None;
+    bool srgbFormat = false;
+    int numFaces = 1;
+    int numLevels = 1;
+    size_t dataSize = 0;
+    unsigned char* data = UnpackKTX2(
+        fileName,
+        buffer,
+        bufferLength,
+        noMipMaps,
+        format,
+        srgbFormat,
+        width,
+        height,
+        numFaces,
+        numLevels,
+        dataSize);
+    if (data == nullptr) {
+        return GlTexture(0, 0, 0);
+    }
+
+    GlTexture texId;
+    if (numFaces == 6) {
+        texId = CreateGlCubeTexture(
+            fileName,
+            format,
+            width,
+            height,
+            data,
+            dataSize,
+            numLevels,
+            useSrgbFormat || srgbFormat,
+            false);
+    } else {
+        texId = CreateGlTexture(
+            fileName,
+            format,
+            width,
+            height,
+            data,
+            dataSize,
+            numLevels,
+            useSrgbFormat || srgbFormat,
+            false);
+    }
+    free(data);
+    return texId;
+}
+
 unsigned char* LoadImageToRGBABuffer(
     const char* fileName,
     const unsigned char* inBuffer,
@@ -1445,6 +1756,185 @@ static int MipLevelsForSize(int width, int height) {
     return levels;
 }
 
+static bool IsStbImageExtension(const std::string& ext) {
+    return ext == ".jpg" || ext == ".tga" || ext == ".png" || ext == ".bmp" || ext == ".psd" ||
+        ext == ".gif" || ext == ".hdr" || ext == ".pic";
+}
+
+// Uncompressed files loaded by stb_image. The result must be released with free().
+static unsigned char* DecodeStbImage(
+    const uint8_t* buffer,
+    size_t bufferSize,
+    const TextureFlags_t& flags,
+    int& width,
+    int& height) {
+    int comp;
+    stbi_uc* image = stbi_load_from_memory(buffer, bufferSize, &width, &height, &comp, 4);
+    if (image == NULL) {
+        ALOG("stbi_load_from_memory() failed!");
+        width = 0;
+        height = 0;
+        return NULL;
+    }
+    // Optionally outline the border alpha.
+    if (flags & TEXTUREFLAG_ALPHA_BORDER) {
+        for (int i = 0; i < width; i++) {
+            image[i * 4 + 3] = 0;
+            image[((height - 1) * width + i) * 4 + 3] = 0;
+        }
+        for (int i = 0; i < height; i++) {
+            image[i * width * 4 + 3] = 0;
+            image[(i * width + width - 1) * 4 + 3] = 0;
+        }
+    }
+    return image;
+}
+
+// Lookup tables for filtering sRGB images in linear space.
+static const int LINEAR_TO_SRGB_TABLE_SIZE = 16384;
+struct ovrSrgbTables {
+    ovrSrgbTables() {
+        for (int i = 0; i < 256; i++) {
+            const float c = i / 255.0f;
+            ToLinear[i] = (c <= 0.04045f) ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i < LINEAR_TO_SRGB_TABLE_SIZE; i++) {
+            const float l = i / float(LINEAR_TO_SRGB_TABLE_SIZE - 1);
+            const float c = (l <= 0.0031308f) ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+            ToSrgb[i] = static_cast<uint8_t>(std::min(std::max(c, 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+    }
+
+    float ToLinear[256];
+    uint8_t ToSrgb[LINEAR_TO_SRGB_TABLE_SIZE];
+};
+
+static const ovrSrgbTables& GetSrgbTables() {
+    static const ovrSrgbTables tables;
+    return tables;
+}
+
+// 2x2 box filter from one RGBA8 level to the next. Odd sizes repeat the last row or column.
+// Color is averaged in linear space for sRGB images, alpha is always linear.
+static void DownsampleRGBA(
+    const uint8_t* src,
+    const int srcWidth,
+    const int srcHeight,
+    uint8_t* dst,
+    const int dstWidth,
+    const int dstHeight,
+    const bool srgb) {
+    const ovrSrgbTables* tables = srgb ? &GetSrgbTables() : nullptr;
+    for (int y = 0; y < dstHeight; y++) {
+        const uint8_t* row0 = src + std::min(y * 2, srcHeight - 1) * srcWidth * 4;
+        const uint8_t* row1 = src + std::min(y * 2 + 1, srcHeight - 1) * srcWidth * 4;
+        uint8_t* out = dst + y * dstWidth * 4;
+        for (int x = 0; x < dstWidth; x++) {
+            const int x0 = std::min(x * 2, srcWidth - 1) * 4;
+            const int x1 = std::min(x * 2 + 1, srcWidth - 1) * 4;
+            if (tables != nullptr) {
+                for (int c = 0; c < 3; c++) {
+                    const float* toLinear = tables->ToLinear;
+                    const float l = toLinear[row0[x0 + c]] + toLinear[row0[x1 + c]] +
+                        toLinear[row1[x0 + c]] + toLinear[row1[x1 + c]];
+                    out[x * 4 + c] =
+                        tables->ToSrgb[int(l * (0.25f * (LINEAR_TO_SRGB_TABLE_SIZE - 1)) + 0.5f)];
+                }
+                out[x * 4 + 3] = static_cast<uint8_t>(
+                    (row0[x0 + 3] + row0[x1 + 3] + row1[x0 + 3] + row1[x1 + 3] + 2) >> 2);
+            } else {
+                for (int c = 0; c < 4; c++) {
+                    out[x * 4 + c] = static_cast<uint8_t>(
+                        (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+                }
+            }
+        }
+    }
+}
+
+// Appends the full mip chain to an RGBA8 image allocated with malloc(). Returns the number of
+// levels in pixels, which is 1 if the chain could not be allocated.
+static int BuildRGBAMipChain(
+    unsigned char*& pixels,
+    const int width,
+    const int height,
+    const bool srgb) {
+    const int numLevels = MipLevelsForSize(width, height);
+    size_t chainSize = 0;
+    for (int i = 0, w = width, h = height; i < numLevels; i++) {
+        chainSize += GetOvrTextureSize(Texture_RGBA, w, h);
+        w = std::max(w >> 1, 1);
+        h = std::max(h >> 1, 1);
+    }
+    unsigned char* chain = static_cast<unsigned char*>(realloc(pixels, chainSize));
+    if (chain == nullptr) {
+        return 1;
+    }
+    pixels = chain;
+
+    unsigned char* src = chain;
+    for (int i = 1, w = width, h = height; i < numLevels; i++) {
+        unsigned char* dst = src + GetOvrTextureSize(Texture_RGBA, w, h);
+        const int nextWidth = std::max(w >> 1, 1);
+        const int nextHeight = std::max(h >> 1, 1);
+        DownsampleRGBA(src, w, h, dst, nextWidth, nextHeight, srgb);
+        src = dst;
+        w = nextWidth;
+        h = nextHeight;
+    }
+    return numLevels;
+}
+
+// Builds the mip chain in place, so image has to come from malloc(), and uploads every level.
+static GlTexture CreateRGBATextureWithMipmaps(
+    const char* fileName,
+    unsigned char*& image,
+    const int width,
+    const int height,
+    const TextureFlags_t& flags) {
+    // box filtered on the CPU like DecodeTextureBuffer(), the synchronous and loader thread
+    // paths give the same levels and neither calls glGenerateMipmap()
+    const int numLevels = (flags & TEXTUREFLAG_NO_MIPMAPS)
+        ? 1
+        : BuildRGBAMipChain(image, width, height, (flags & TEXTUREFLAG_USE_SRGB) != 0);
+    return CreateGlTexture(
+        fileName,
+        Texture_RGBA,
+        width,
+        height,
+        image,
+        GetTextureMemorySize(Texture_RGBA, width, height, numLevels, 1),
+        numLevels,
+        flags & TEXTUREFLAG_USE_SRGB,
+        false);
+}
+
+// Create a default texture if a load failed
+static GlTexture CreateDefaultTexture(const char* fileName, const TextureFlags_t& flags) {
+    ALOGW("Failed to load %s", fileName);
+    if ((flags & TEXTUREFLAG_NO_DEFAULT) != 0) {
+        return GlTexture();
+    }
+    static uint8_t defaultTexture[8 * 8 * 3] = {
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 64,  64,  64,  64,  64,
+        64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  255, 255, 255,
+        255, 255, 255, 64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,
+        64,  64,  64,  64,  64,  255, 255, 255, 255, 255, 255, 64,  64,  64,  64,  64,
+        64,  255, 255, 255, 255, 255, 255, 64,  64,  64,  64,  64,  64,  255, 255, 255,
+        255, 255, 255, 64,  64,  64,  64,  64,  64,  255, 255, 255, 255, 255, 255, 64,
+        64,  64,  64,  64,  64,  255, 255, 255, 255, 255, 255, 64,  64,  64,  64,  64,
+        64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  255, 255, 255,
+        255, 255, 255, 64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,
+        64,  64,  64,  64,  64,  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255};
+    GlTexture texId = LoadRGBTextureFromMemory(defaultTexture, 8, 8, flags & TEXTUREFLAG_USE_SRGB);
+#if defined(OVR_BUILD_DEBUG)
+    ALOG("FAILD to load '%s' -> using default via LoadRGBTextureFromMemory", fileName);
+#endif
+    return texId;
+}
+
 GlTexture LoadTextureFromBuffer(
     const char* fileName,
     const uint8_t* buffer,
@@ -1471,44 +1961,11 @@ GlTexture LoadTextureFromBuffer(
             buffer == nullptr ? 0 : buffer,
             static_cast<int>(bufferSize));
 #endif
-    } else if (
-        ext == ".jpg" || ext == ".tga" || ext == ".png" || ext == ".bmp" || ext == ".psd" ||
-        ext == ".gif" || ext == ".hdr" || ext == ".pic") {
-        // Uncompressed files loaded by stb_image
-        int comp;
-        stbi_uc* image = stbi_load_from_memory(buffer, bufferSize, &width, &height, &comp, 4);
+    } else if (IsStbImageExtension(ext)) {
+        unsigned char* image = DecodeStbImage(buffer, bufferSize, flags, width, height);
         if (image != NULL) {
-            // Optionally outline the border alpha.
-            if (flags & TEXTUREFLAG_ALPHA_BORDER) {
-                for (int i = 0; i < width; i++) {
-                    image[i * 4 + 3] = 0;
-                    image[((height - 1) * width + i) * 4 + 3] = 0;
-                }
-                for (int i = 0; i < height; i++) {
-                    image[i * width * 4 + 3] = 0;
-                    image[(i * width + width - 1) * 4 + 3] = 0;
-                }
-            }
-
-            const size_t dataSize = GetOvrTextureSize(Texture_RGBA, width, height);
-            texId = CreateGlTexture(
-                fileName,
-                Texture_RGBA,
-                width,
-                height,
-                image,
-                dataSize,
-                (flags & TEXTUREFLAG_NO_MIPMAPS) ? 1 : MipLevelsForSize(width, height),
-                flags & TEXTUREFLAG_USE_SRGB,
-                false);
+            texId = CreateRGBATextureWithMipmaps(fileName, image, width, height, flags);
             free(image);
-            if (!(flags & TEXTUREFLAG_NO_MIPMAPS)) {
-                glBindTexture(texId.target, texId.texture);
-                glGenerateMipmap(texId.target);
-                glTexParameteri(texId.target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            }
-        } else {
-            ALOG("stbi_load_from_memory() failed!");
         }
     } else if (ext == ".pvr") {
         texId = LoadTexturePVR(
@@ -1528,6 +1985,15 @@ GlTexture LoadTextureFromBuffer(
             (flags & TEXTUREFLAG_NO_MIPMAPS),
             width,
             height);
+    } else if (ext == ".ktx2") {
+        texId = LoadTextureKTX2(
+            fileName,
+            buffer,
+            bufferSize,
+            (flags & TEXTUREFLAG_USE_SRGB),
+            (flags & TEXTUREFLAG_NO_MIPMAPS),
+            width,
+            height);
     } else if (ext == ".astc") {
         texId = LoadASTCTextureFromMemory(buffer, bufferSize, 4, flags & TEXTUREFLAG_USE_SRGB);
     } else if (ext == ".pkm") {
@@ -1536,28 +2002,8 @@ GlTexture LoadTextureFromBuffer(
         ALOG("unsupported file extension '%s', for file '%s'", ext.c_str(), fileName);
     }
 
-    // Create a default texture if the load failed
     if (texId.texture == 0) {
-        ALOGW("Failed to load %s", fileName);
-        if ((flags & TEXTUREFLAG_NO_DEFAULT) == 0) {
-            static uint8_t defaultTexture[8 * 8 * 3] = {
-                255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 64,  64,  64,  64,  64,
-                64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  255, 255, 255,
-                255, 255, 255, 64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,
-                64,  64,  64,  64,  64,  255, 255, 255, 255, 255, 255, 64,  64,  64,  64,  64,
-                64,  255, 255, 255, 255, 255, 255, 64,  64,  64,  64,  64,  64,  255, 255, 255,
-                255, 255, 255, 64,  64,  64,  64,  64,  64,  255, 255, 255, 255, 255, 255, 64,
-                64,  64,  64,  64,  64,  255, 255, 255, 255, 255, 255, 64,  64,  64,  64,  64,
-                64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  255, 255, 255,
-                255, 255, 255, 64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,  64,
-                64,  64,  64,  64,  64,  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255};
-            texId = LoadRGBTextureFromMemory(defaultTexture, 8, 8, flags & TEXTUREFLAG_USE_SRGB);
-#if defined(OVR_BUILD_DEBUG)
-            ALOG("FAILD to load '%s' -> using default via LoadRGBTextureFromMemory", fileName);
-#endif
-        }
+        texId = CreateDefaultTexture(fileName, flags);
     }
 #if defined(OVR_BUILD_DEBUG)
     else {
@@ -1568,6 +2014,200 @@ GlTexture LoadTextureFromBuffer(
     return texId;
 }
 
+ovrDecodedTexture::~ovrDecodedTexture() {
+    free(Pixels);
+}
+
+bool DecodeTextureBuffer(
+    const char* fileName,
+    const uint8_t* buffer,
+    size_t bufferSize,
+    const TextureFlags_t& flags,
+    ovrDecodedTexture& outDecoded) {
+    outDecoded.FileName = fileName != nullptr ? fileName : "";
+    outDecoded.Flags = flags;
+    if (fileName == nullptr || buffer == nullptr || bufferSize < 1) {
+        return false;
+    }
+
+    std::string ext = GetExtension(fileName);
+    auto& loc = std::use_facet<std::ctype<char>>(std::locale());
+    loc.tolower(&ext[0], &ext[0] + ext.length());
+
+    if (IsStbImageExtension(ext)) {
+        outDecoded.Pixels =
+            DecodeStbImage(buffer, bufferSize, flags, outDecoded.Width, outDecoded.Height);
+        if (outDecoded.Pixels == nullptr) {
+            return false;
+        }
+        // building the mips here keeps glGenerateMipmap() off the GL thread
+        outDecoded.NumLevels = (flags & TEXTUREFLAG_NO_MIPMAPS)
+            ? 1
+            : BuildRGBAMipChain(
+                  outDecoded.Pixels,
+                  outDecoded.Width,
+                  outDecoded.Height,
+                  (flags & TEXTUREFLAG_USE_SRGB) != 0);
+        return true;
+    }
+    if (ext == ".ktx2") {
+        // inflating supercompressed levels is the expensive part, do it here
+        bool srgbFormat = false;
+        size_t dataSize = 0;
+        outDecoded.Pixels = UnpackKTX2(
+            fileName,
+            buffer,
+            bufferSize,
+            (flags & TEXTUREFLAG_NO_MIPMAPS) != 0,
+            outDecoded.Format,
+            srgbFormat,
+            outDecoded.Width,
+            outDecoded.Height,
+            outDecoded.NumFaces,
+            outDecoded.NumLevels,
+            dataSize);
+        if (srgbFormat) {
+            outDecoded.Flags |= TEXTUREFLAG_USE_SRGB;
+        }
+        return outDecoded.Pixels != nullptr;
+    }
+    outDecoded.FileData.assign(buffer, buffer + bufferSize);
+    return true;
+}
+
+GlTexture CreateTextureFromDecoded(const ovrDecodedTexture& decoded, int& width, int& height) {
+    const char* fileName = decoded.FileName.c_str();
+    if (decoded.Pixels != nullptr) {
+        width = decoded.Width;
+        height = decoded.Height;
+        const size_t dataSize = GetTextureMemorySize(
+            decoded.Format, width, height, decoded.NumLevels, decoded.NumFaces);
+        // all levels in one go
+        const bool useSrgbFormat = (decoded.Flags & TEXTUREFLAG_USE_SRGB) != 0;
+        GlTexture texId;
+        if (decoded.NumFaces == 6) {
+            texId = CreateGlCubeTexture(
+                fileName,
+                decoded.Format,
+                width,
+                height,
+                decoded.Pixels,
+                dataSize,
+                decoded.NumLevels,
+                useSrgbFormat,
+                false);
+        } else {
+            texId = CreateGlTexture(
+                fileName,
+                decoded.Format,
+                width,
+                height,
+                decoded.Pixels,
+                dataSize,
+                decoded.NumLevels,
+                useSrgbFormat,
+                false);
+        }
+        if (texId.texture == 0) {
+            texId = CreateDefaultTexture(fileName, decoded.Flags);
+        }
+        return texId;
+    }
+    // container formats, and failed decodes which fall through to the default texture
+    return LoadTextureFromBuffer(fileName, decoded.FileData, decoded.Flags, width, height);
+}
+
+bool ReplaceTextureLevels(GlTexture& texture, const ovrDecodedTexture& decoded, int firstLevel) {
+    if (texture.texture == 0 || texture.target != GL_TEXTURE_2D || decoded.Pixels == nullptr ||
+        decoded.NumFaces != 1 || firstLevel < 0 || firstLevel >= decoded.NumLevels) {
+        return false;
+    }
+
+    GLenum glFormat;
+    GLenum glInternalFormat;
+    if (!TextureFormatToGlFormat(
+            decoded.Format,
+            (decoded.Flags & TEXTUREFLAG_USE_SRGB) != 0,
+            glFormat,
+            glInternalFormat)) {
+        return false;
+    }
+
+    const unsigned char* level = decoded.Pixels;
+    int w = decoded.Width;
+    int h = decoded.Height;
+    for (int i = 0; i < firstLevel; i++) {
+        level += GetOvrTextureSize(decoded.Format, w, h);
+        w = std::max(w >> 1, 1);
+        h = std::max(h >> 1, 1);
+    }
+    const int width = w;
+    const int height = h;
+
+    // the new level 0 redefines the size; the old smallest level is left beyond MAX_LEVEL
+    const int numLevels = decoded.NumLevels - firstLevel;
+    glBindTexture(GL_TEXTURE_2D, texture.texture);
+    for (int i = 0; i < numLevels; i++) {
+        const int32_t mipSize = GetOvrTextureSize(decoded.Format, w, h);
+        if (IsCompressedFormat(decoded.Format)) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, i, glInternalFormat, w, h, 0, mipSize, level);
+        } else {
+            glTexImage2D(
+                GL_TEXTURE_2D, i, glInternalFormat, w, h, 0, glFormat, GL_UNSIGNED_BYTE, level);
+        }
+        level += mipSize;
+        w = std::max(w >> 1, 1);
+        h = std::max(h >> 1, 1);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels - 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    GLCheckErrorsWithTitle("ReplaceTextureLevels");
+
+    texture.Width = width;
+    texture.Height = height;
+    return true;
+}
+
+size_t GetTextureMemorySize(
+    const eTextureFormat format,
+    const int width,
+    const int height,
+    const int numLevels,
+    const int numFaces) {
+    size_t size = 0;
+    for (int i = 0, w = width, h = height; i < numLevels; i++) {
+        size += GetOvrTextureSize(format, w, h);
+        w = std::max(w >> 1, 1);
+        h = std::max(h >> 1, 1);
+    }
+    return size * numFaces;
+}
+
+void LoadTextureFromUriAsync(
+    ovrAsyncLoader& loader,
+    ovrFileSys& fileSys,
+    const char* uri,
+    const TextureFlags_t& flags,
+    std::function<void(GlTexture texture, int width, int height)> onLoaded) {
+    ovrFileSys* fs = &fileSys;
+    std::string const uriString = uri;
+    loader.Load([fs, uriString, flags, onLoaded]() -> ovrGpuUpload {
+        // shared so the upload stays copyable for std::function
+        std::shared_ptr<ovrDecodedTexture> decoded = std::make_shared<ovrDecodedTexture>();
+        std::vector<uint8_t> buffer;
+        if (!fs->ReadFile(uriString.c_str(), buffer)) {
+            ALOGW("LoadTextureFromUriAsync - failed to read '%s'", uriString.c_str());
+        }
+        DecodeTextureBuffer(uriString.c_str(), buffer.data(), buffer.size(), flags, *decoded);
+        return [decoded, onLoaded]() {
+            int width = 0;
+            int height = 0;
+            GlTexture texture = CreateTextureFromDecoded(*decoded, width, height);
+            onLoaded(texture, width, height);
+        };
+    });
+}
+
 GlTexture LoadTextureFromOtherApplicationPackage(
     void* zipFile,
     const char* nameInZip,
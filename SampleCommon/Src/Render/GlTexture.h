@@ -16,6 +16,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Egl.h"
 #include "OVR_FileSys.h"
 
+#include <functional>
+#include <string>
 #include <vector>
 
 // Explicitly using unsigned instead of GLUint / GLenum to avoid including GL headers
@@ -212,6 +214,66 @@ inline GlTexture LoadTextureFromBuffer(
     return LoadTextureFromBuffer(fileName, buffer.data(), buffer.size(), flags, width, height);
 }
 
+// Image data decoded by DecodeTextureBuffer(), ready to be handed to CreateTextureFromDecoded().
+// stb_image formats are decoded to RGBA8 along with their full mip chain, unless
+// TEXTUREFLAG_NO_MIPMAPS is set, and .ktx2 files are unpacked to their GPU format. The other
+// container formats (.ktx, .pvr, .astc) already hold GPU-ready data, so their file contents are
+// kept as-is.
+class ovrDecodedTexture {
+   public:
+    ovrDecodedTexture()
+        : Pixels(nullptr), Format(Texture_RGBA), Width(0), Height(0), NumFaces(1), NumLevels(0) {}
+    ~ovrDecodedTexture();
+
+    ovrDecodedTexture(const ovrDecodedTexture&) = delete;
+    ovrDecodedTexture& operator=(const ovrDecodedTexture&) = delete;
+
+    std::string FileName;
+    TextureFlags_t Flags;
+    unsigned char* Pixels; // levels back to back, or nullptr if decoded on upload
+    eTextureFormat Format;
+    int Width;
+    int Height;
+    int NumFaces;
+    int NumLevels;
+    std::vector<uint8_t> FileData; // file contents for formats decoded on upload
+};
+
+// The CPU half of LoadTextureFromBuffer(). Does not touch GL, so it can run on a loader thread.
+// Returns false if the image could not be decoded; CreateTextureFromDecoded() then creates the
+// default texture, as LoadTextureFromBuffer() would.
+bool DecodeTextureBuffer(
+    const char* fileName,
+    const uint8_t* buffer,
+    size_t bufferSize,
+    const TextureFlags_t& flags,
+    ovrDecodedTexture& outDecoded);
+
+// The GL half of LoadTextureFromBuffer(). Must be called on the GL thread.
+GlTexture CreateTextureFromDecoded(const ovrDecodedTexture& decoded, int& width, int& height);
+
+// Re-creates a 2D texture from levels firstLevel and down of the decoded image, keeping the GL
+// texture name so existing users of it see the smaller texture. Returns false if the decoded
+// image does not have those levels.
+bool ReplaceTextureLevels(GlTexture& texture, const ovrDecodedTexture& decoded, int firstLevel);
+
+// GPU memory used by numLevels levels of a texture, starting at width x height.
+size_t GetTextureMemorySize(
+    const eTextureFormat format,
+    const int width,
+    const int height,
+    const int numLevels,
+    const int numFaces = 1);
+
+// Reads and decodes the texture on one of the loader's threads, then creates it on the GL thread
+// the next time the loader is updated and passes it to onLoaded.
+void LoadTextureFromUriAsync(
+    class ovrAsyncLoader& loader,
+    class ovrFileSys& fileSys,
+    const char* uri,
+    const TextureFlags_t& flags,
+    std::function<void(GlTexture texture, int width, int height)> onLoaded);
+
 // Returns 0 if the file is not found.
 // For a file placed in the project assets folder, nameInZip would be
 // something like "assets/cube.pvr".
@@ -0,0 +1,391 @@
+/************************************************************************************
+
+Filename    :   MeshOptimizer.cpp
+Content     :   Load time triangle and vertex reordering for the post-transform vertex cache,
+                overdraw and vertex fetch.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "MeshOptimizer.h"
+
+#include <math.h>
+#include <algorithm>
+#include <numeric>
+
+#include "Misc/Log.h"
+
+using OVR::Vector3f;
+
+namespace OVRFW {
+
+// Cache size the triangle scores are tuned for. Larger than the actual hardware caches on
+// purpose, the order degrades gracefully on smaller ones.
+static const int FORSYTH_CACHE_SIZE = 32;
+static const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+static const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+static const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+static const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+static float ForsythVertexScore(const int cachePosition, const int remainingTriangles) {
+    if (remainingTriangles == 0) {
+        // no triangle left to pick through this vertex
+        return -1.0f;
+    }
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // used by the last triangle, which gets a fixed score so the next triangle doesn't
+            // simply continue a strip
+            score = FORSYTH_LAST_TRIANGLE_SCORE;
+        } else {
+            const float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = powf(1.0f - (cachePosition - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+        }
+    }
+    // favor vertices with few triangles left, so lone triangles don't get stranded
+    score += FORSYTH_VALENCE_BOOST_SCALE *
+        powf(static_cast<float>(remainingTriangles), -FORSYTH_VALENCE_BOOST_POWER);
+    return score;
+}
+
+static bool IndicesInRange(const std::vector<TriangleIndex32>& indices, const int numVertices) {
+    for (const TriangleIndex32 index : indices) {
+        if (index >= static_cast<TriangleIndex32>(numVertices)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename _attrib_type_>
+static bool HasValuePerVertex(const std::vector<_attrib_type_>& attrib, const size_t numVertices) {
+    return attrib.empty() || attrib.size() == numVertices;
+}
+
+template <typename _attrib_type_>
+static void RemapAttribute(
+    std::vector<_attrib_type_>& attrib,
+    const std::vector<TriangleIndex32>& newToOld) {
+    if (attrib.empty()) {
+        return;
+    }
+    std::vector<_attrib_type_> remapped(newToOld.size());
+    for (size_t i = 0; i < newToOld.size(); i++) {
+        remapped[i] = attrib[newToOld[i]];
+    }
+    attrib.swap(remapped);
+}
+
+//==============================
+// AnalyzeVertexCache
+ovrVertexCacheStats AnalyzeVertexCache(
+    const std::vector<TriangleIndex32>& indices,
+    const int numVertices,
+    const int cacheSize) {
+    ovrVertexCacheStats stats;
+    if (indices.size() < 3 || numVertices <= 0) {
+        return stats;
+    }
+
+    // a vertex is in the FIFO if fewer than cacheSize vertices were added after it
+    std::vector<int> addedAt(numVertices, -cacheSize);
+    int numAdded = 0;
+    for (const TriangleIndex32 index : indices) {
+        if (index >= static_cast<TriangleIndex32>(numVertices)) {
+            continue;
+        }
+        if (numAdded - addedAt[index] >= cacheSize) {
+            addedAt[index] = numAdded++;
+        }
+    }
+
+    stats.VerticesTransformed = numAdded;
+    stats.Acmr = static_cast<float>(numAdded) / static_cast<float>(indices.size() / 3);
+    stats.Atvr = static_cast<float>(numAdded) / static_cast<float>(numVertices);
+    return stats;
+}
+
+//==============================
+// OptimizeVertexCache
+void OptimizeVertexCache(std::vector<TriangleIndex32>& indices, const int numVertices) {
+    const int numTriangles = static_cast<int>(indices.size() / 3);
+    if (numTriangles < 2 || numVertices <= 0 || !IndicesInRange(indices, numVertices)) {
+        return;
+    }
+
+    // the triangles using each vertex; the first remainingTriangles[v] entries of each list are
+    // the ones that have not been emitted yet
+    std::vector<int> remainingTriangles(numVertices, 0);
+    for (int i = 0; i < numTriangles * 3; i++) {
+        remainingTriangles[indices[i]]++;
+    }
+    std::vector<int> firstTriangle(numVertices + 1, 0);
+    for (int v = 0; v < numVertices; v++) {
+        firstTriangle[v + 1] = firstTriangle[v] + remainingTriangles[v];
+    }
+    std::vector<int> vertexTriangles(numTriangles * 3);
+    {
+        std::vector<int> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (int i = 0; i < numTriangles * 3; i++) {
+            vertexTriangles[fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<int> cachePosition(numVertices, -1);
+    std::vector<float> vertexScores(numVertices);
+    for (int v = 0; v < numVertices; v++) {
+        vertexScores[v] = ForsythVertexScore(-1, remainingTriangles[v]);
+    }
+    std::vector<float> triangleScores(numTriangles);
+    std::vector<bool> emitted(numTriangles, false);
+    int bestTriangle = 0;
+    for (int t = 0; t < numTriangles; t++) {
+        triangleScores[t] = vertexScores[indices[t * 3 + 0]] + vertexScores[indices[t * 3 + 1]] +
+            vertexScores[indices[t * 3 + 2]];
+        if (triangleScores[t] > triangleScores[bestTriangle]) {
+            bestTriangle = t;
+        }
+    }
+
+    std::vector<TriangleIndex32> optimized;
+    optimized.reserve(indices.size());
+    int cache[FORSYTH_CACHE_SIZE + 3];
+    int cacheCount = 0;
+    int nextUnemitted = 0;
+
+    for (int numEmitted = 0; numEmitted < numTriangles; numEmitted++) {
+        if (bestTriangle < 0) {
+            // nothing in the cache leads to a remaining triangle, continue with the first one
+            // left in the original order
+            while (emitted[nextUnemitted]) {
+                nextUnemitted++;
+            }
+            bestTriangle = nextUnemitted;
+        }
+        const int t = bestTriangle;
+        emitted[t] = true;
+
+        int newCache[FORSYTH_CACHE_SIZE + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; k++) {
+            const TriangleIndex32 v = indices[t * 3 + k];
+            optimized.push_back(v);
+
+            int* list = &vertexTriangles[firstTriangle[v]];
+            for (int j = 0; j < remainingTriangles[v]; j++) {
+                if (list[j] == t) {
+                    list[j] = list[remainingTriangles[v] - 1];
+                    break;
+                }
+            }
+            remainingTriangles[v]--;
+
+            // degenerate triangles use a vertex more than once
+            if (std::find(newCache, newCache + newCount, static_cast<int>(v)) ==
+                newCache + newCount) {
+                newCache[newCount++] = v;
+            }
+        }
+        // the triangle's vertices move to the front, everything else shifts back
+        const int numTriangleVertices = newCount;
+        for (int i = 0; i < cacheCount; i++) {
+            if (std::find(newCache, newCache + numTriangleVertices, cache[i]) ==
+                newCache + numTriangleVertices) {
+                newCache[newCount++] = cache[i];
+            }
+        }
+        for (int i = 0; i < newCount; i++) {
+            cachePosition[newCache[i]] = (i < FORSYTH_CACHE_SIZE) ? i : -1;
+        }
+
+        // rescore everything whose cache position changed, including evicted vertices
+        for (int i = 0; i < newCount; i++) {
+            const int v = newCache[i];
+            vertexScores[v] = ForsythVertexScore(cachePosition[v], remainingTriangles[v]);
+        }
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < newCount; i++) {
+            const int v = newCache[i];
+            const int* list = &vertexTriangles[firstTriangle[v]];
+            for (int j = 0; j < remainingTriangles[v]; j++) {
+                const int tri = list[j];
+                triangleScores[tri] = vertexScores[indices[tri * 3 + 0]] +
+                    vertexScores[indices[tri * 3 + 1]] + vertexScores[indices[tri * 3 + 2]];
+                if (cachePosition[v] >= 0 && triangleScores[tri] > bestScore) {
+                    bestScore = triangleScores[tri];
+                    bestTriangle = tri;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+
+    indices.swap(optimized);
+}
+
+//==============================
+// OptimizeOverdraw
+void OptimizeOverdraw(
+    std::vector<TriangleIndex32>& indices,
+    const std::vector<Vector3f>& positions,
+    const float threshold) {
+    const int numTriangles = static_cast<int>(indices.size() / 3);
+    const int numVertices = static_cast<int>(positions.size());
+    if (numTriangles < 2 || !IndicesInRange(indices, numVertices)) {
+        return;
+    }
+
+    // Split the triangles into clusters where the vertex cache order jumps to another part of
+    // the mesh, which shows up as a triangle that misses the cache on all of its vertices.
+    // Reordering the clusters only costs cache misses at the cluster boundaries.
+    const int cacheSize = 16;
+    std::vector<int> addedAt(numVertices, -cacheSize);
+    int numAdded = 0;
+    std::vector<int> clusterStarts;
+    for (int t = 0; t < numTriangles; t++) {
+        int misses = 0;
+        for (int k = 0; k < 3; k++) {
+            const TriangleIndex32 v = indices[t * 3 + k];
+            if (numAdded - addedAt[v] >= cacheSize) {
+                addedAt[v] = numAdded++;
+                misses++;
+            }
+        }
+        if (t == 0 || misses == 3) {
+            clusterStarts.push_back(t);
+        }
+    }
+    const int numClusters = static_cast<int>(clusterStarts.size());
+    if (numClusters < 2) {
+        return;
+    }
+    clusterStarts.push_back(numTriangles);
+
+    Vector3f meshCentroid(0.0f);
+    for (const Vector3f& p : positions) {
+        meshCentroid += p;
+    }
+    meshCentroid /= static_cast<float>(numVertices);
+
+    // clusters that face away from the center of the mesh are likely in front of the rest of it
+    std::vector<float> sortKeys(numClusters);
+    for (int c = 0; c < numClusters; c++) {
+        Vector3f centroid(0.0f);
+        Vector3f normal(0.0f);
+        float area = 0.0f;
+        for (int t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+            const Vector3f& p0 = positions[indices[t * 3 + 0]];
+            const Vector3f& p1 = positions[indices[t * 3 + 1]];
+            const Vector3f& p2 = positions[indices[t * 3 + 2]];
+            const Vector3f n = (p1 - p0).Cross(p2 - p0);
+            const float triangleArea = n.Length();
+            centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+            normal += n;
+            area += triangleArea;
+        }
+        const float normalLength = normal.Length();
+        sortKeys[c] = (area > 0.0f && normalLength > 0.0f)
+            ? (centroid / area - meshCentroid).Dot(normal / normalLength)
+            : 0.0f;
+    }
+
+    std::vector<int> order(numClusters);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](const int a, const int b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    std::vector<TriangleIndex32> sorted;
+    sorted.reserve(indices.size());
+    for (const int c : order) {
+        sorted.insert(
+            sorted.end(),
+            indices.begin() + clusterStarts[c] * 3,
+            indices.begin() + clusterStarts[c + 1] * 3);
+    }
+
+    const float acmr = AnalyzeVertexCache(indices, numVertices).Acmr;
+    const float sortedAcmr = AnalyzeVertexCache(sorted, numVertices).Acmr;
+    if (sortedAcmr <= acmr * threshold) {
+        indices.swap(sorted);
+    }
+}
+
+//==============================
+// OptimizeVertexFetch
+void OptimizeVertexFetch(VertexAttribs& attribs, std::vector<TriangleIndex32>& indices) {
+    const size_t numVertices = attribs.position.size();
+    if (numVertices == 0 || !HasValuePerVertex(attribs.normal, numVertices) ||
+        !HasValuePerVertex(attribs.tangent, numVertices) ||
+        !HasValuePerVertex(attribs.binormal, numVertices) ||
+        !HasValuePerVertex(attribs.color, numVertices) ||
+        !HasValuePerVertex(attribs.uv0, numVertices) ||
+        !HasValuePerVertex(attribs.uv1, numVertices) ||
+        !HasValuePerVertex(attribs.jointIndices, numVertices) ||
+        !HasValuePerVertex(attribs.jointWeights, numVertices) ||
+        !IndicesInRange(indices, static_cast<int>(numVertices))) {
+        return;
+    }
+
+    const TriangleIndex32 unused = ~TriangleIndex32(0);
+    std::vector<TriangleIndex32> oldToNew(numVertices, unused);
+    std::vector<TriangleIndex32> newToOld;
+    newToOld.reserve(numVertices);
+    for (TriangleIndex32& index : indices) {
+        if (oldToNew[index] == unused) {
+            oldToNew[index] = static_cast<TriangleIndex32>(newToOld.size());
+            newToOld.push_back(index);
+        }
+        index = oldToNew[index];
+    }
+
+    RemapAttribute(attribs.position, newToOld);
+    RemapAttribute(attribs.normal, newToOld);
+    RemapAttribute(attribs.tangent, newToOld);
+    RemapAttribute(attribs.binormal, newToOld);
+    RemapAttribute(attribs.color, newToOld);
+    RemapAttribute(attribs.uv0, newToOld);
+    RemapAttribute(attribs.uv1, newToOld);
+    RemapAttribute(attribs.jointIndices, newToOld);
+    RemapAttribute(attribs.jointWeights, newToOld);
+}
+
+//==============================
+// OptimizeMesh
+void OptimizeMesh(
+    VertexAttribs& attribs,
+    std::vector<TriangleIndex32>& indices,
+    const bool optimizeOverdraw,
+    const char* name) {
+    if (indices.size() < 3 || attribs.position.empty()) {
+        return;
+    }
+    const ovrVertexCacheStats before =
+        AnalyzeVertexCache(indices, static_cast<int>(attribs.position.size()));
+
+    OptimizeVertexCache(indices, static_cast<int>(attribs.position.size()));
+    if (optimizeOverdraw) {
+        OptimizeOverdraw(indices, attribs.position);
+    }
+    OptimizeVertexFetch(attribs, indices);
+
+    const ovrVertexCacheStats after =
+        AnalyzeVertexCache(indices, static_cast<int>(attribs.position.size()));
+    ALOG(
+        "OptimizeMesh: %s, %d triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+        name,
+        static_cast<int>(indices.size() / 3),
+        before.Acmr,
+        after.Acmr,
+        before.Atvr,
+        after.Atvr);
+}
+
+} // namespace OVRFW
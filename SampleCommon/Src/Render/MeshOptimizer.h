@@ -0,0 +1,62 @@
+/************************************************************************************
+
+Filename    :   MeshOptimizer.h
+Content     :   Load time triangle and vertex reordering for the post-transform vertex cache,
+                overdraw and vertex fetch.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "GlGeometry.h"
+
+namespace OVRFW {
+
+// Post-transform vertex cache efficiency of an index list, measured with a FIFO cache.
+struct ovrVertexCacheStats {
+    ovrVertexCacheStats() : VerticesTransformed(0), Acmr(0.0f), Atvr(0.0f) {}
+
+    int VerticesTransformed;
+    float Acmr; // average cache miss ratio: transformed vertices per triangle, 0.5 at best
+    float Atvr; // average transformed vertex ratio: transformed vertices per vertex, 1.0 at best
+};
+
+// Simulates a FIFO vertex cache of cacheSize entries over the triangle list.
+ovrVertexCacheStats AnalyzeVertexCache(
+    const std::vector<TriangleIndex32>& indices,
+    const int numVertices,
+    const int cacheSize = 16);
+
+// Reorders the triangles so vertices are reused while they are still in the post-transform
+// cache, using Tom Forsyth's linear-speed vertex cache optimization. Does not change the
+// triangles themselves or their winding.
+void OptimizeVertexCache(std::vector<TriangleIndex32>& indices, const int numVertices);
+
+// Reorders runs of triangles produced by OptimizeVertexCache() so outward facing parts of the
+// mesh are drawn first, which lets early depth testing reject more of what is drawn after them.
+// The new order is only kept if it raises the ACMR by less than the threshold factor.
+void OptimizeOverdraw(
+    std::vector<TriangleIndex32>& indices,
+    const std::vector<OVR::Vector3f>& positions,
+    const float threshold = 1.05f);
+
+// Renumbers the vertices in the order the triangles first use them, so vertex fetches walk the
+// vertex buffer linearly. Vertices no triangle uses are dropped. Does nothing if the attributes
+// don't all have one value per position.
+void OptimizeVertexFetch(VertexAttribs& attribs, std::vector<TriangleIndex32>& indices);
+
+// Runs the vertex cache, optional overdraw and vertex fetch passes on a triangle list and logs
+// the ACMR and ATVR before and after.
+void OptimizeMesh(
+    VertexAttribs& attribs,
+    std::vector<TriangleIndex32>& indices,
+    const bool optimizeOverdraw,
+    const char* name);
+
+} // namespace OVRFW
@@ -398,13 +398,13 @@ ovrDrawCounters ovrSurfaceRender::RenderSurfaceList(
 
         if (LogRenderSurfaces) {
             ALOG(
-                "Drawing %s vao=%d vb=%d primitive=0x%04x indexCount=%d IndexType=0x%04x ",
+                "Drawing %s vao=%d vb=%d primitive=0x%04x indexCount=%d indexType=0x%04x ",
                 surfaceDef.surfaceName.c_str(),
                 surfaceDef.geo.vertexArrayObject,
                 surfaceDef.geo.vertexBuffer,
                 surfaceDef.geo.primitiveType,
                 surfaceDef.geo.indexCount,
-                surfaceDef.geo.IndexType);
+                surfaceDef.geo.indexType);
         }
 
         // Bind all the vertex and element arrays
@@ -415,14 +415,14 @@ ovrDrawCounters ovrSurfaceRender::RenderSurfaceList(
                 GL(glDrawElementsInstanced(
                     surfaceDef.geo.primitiveType,
                     surfaceDef.geo.indexCount,
-                    surfaceDef.geo.IndexType,
+                    surfaceDef.geo.indexType,
                     NULL,
                     surfaceDef.numInstances));
             } else {
                 GL(glDrawElements(
                     surfaceDef.geo.primitiveType,
                     surfaceDef.geo.indexCount,
-                    surfaceDef.geo.IndexType,
+                    surfaceDef.geo.indexType,
                     NULL));
             }
         }
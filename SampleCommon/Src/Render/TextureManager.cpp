@@ -13,9 +13,14 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #define __STDC_FORMAT_MACROS 1
 
 #include "TextureManager.h"
+#include "TextureResidency.h"
 
 #include "Misc/Log.h"
 
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
@@ -43,12 +48,46 @@ void ovrManagedTexture::Free() {
 // ovrTextureManagerImpl
 //==============================================================================================
 
+// GPU memory a decoded texture uses once it is created.
+static size_t GetDecodedTextureSize(ovrDecodedTexture const& decoded) {
+    if (decoded.Pixels != nullptr) {
+        return GetTextureMemorySize(
+            decoded.Format, decoded.Width, decoded.Height, decoded.NumLevels, decoded.NumFaces);
+    }
+    // .ktx, .pvr and .astc payloads are uploaded as they are
+    return decoded.FileData.size();
+}
+
+// Copies the levels below the top level of a decoded 2D image into a new image: what is left
+// once the top level is dropped.
+static std::unique_ptr<ovrDecodedTexture> CopyLowerLevels(ovrDecodedTexture const& decoded) {
+    size_t const topSize = GetTextureMemorySize(decoded.Format, decoded.Width, decoded.Height, 1);
+    std::unique_ptr<ovrDecodedTexture> lower(new ovrDecodedTexture());
+    lower->FileName = decoded.FileName;
+    lower->Flags = decoded.Flags;
+    lower->Format = decoded.Format;
+    lower->Width = std::max(decoded.Width >> 1, 1);
+    lower->Height = std::max(decoded.Height >> 1, 1);
+    lower->NumLevels = decoded.NumLevels - 1;
+    size_t const lowerSize =
+        GetTextureMemorySize(lower->Format, lower->Width, lower->Height, lower->NumLevels);
+    lower->Pixels = static_cast<unsigned char*>(malloc(lowerSize));
+    if (lower->Pixels == nullptr) {
+        return nullptr;
+    }
+    memcpy(lower->Pixels, decoded.Pixels + topSize, lowerSize);
+    return lower;
+}
+
 //==============================================================
 // ovrTextureManagerImpl
-class ovrTextureManagerImpl : public ovrTextureManager {
+class ovrTextureManagerImpl : public ovrTextureManager, public ovrTextureResidencyAllocator {
    public:
     friend class ovrTextureManager;
 
+    // textures don't drop mips below this size
+    static int const MIN_STREAMED_TEXTURE_SIZE = 64;
+
     virtual void Init() OVR_OVERRIDE;
     virtual void Shutdown() OVR_OVERRIDE;
 
@@ -78,8 +117,13 @@ class ovrTextureManagerImpl : public ovrTextureManager {
         ovrTextureFilter const filterType = FILTER_DEFAULT,
         ovrTextureWrap const wrapType = WRAP_DEFAULT) OVR_OVERRIDE;
 
+    virtual void ReleaseTexture(textureHandle_t const handle) OVR_OVERRIDE;
     virtual void FreeTexture(textureHandle_t const handle) OVR_OVERRIDE;
 
+    virtual void SetMemoryBudget(size_t const budgetBytes) OVR_OVERRIDE;
+    virtual size_t GetMemoryBudget() const OVR_OVERRIDE;
+    virtual size_t GetResidentBytes() const OVR_OVERRIDE;
+
     virtual ovrManagedTexture GetTexture(textureHandle_t const handle) const OVR_OVERRIDE;
     virtual GlTexture GetGlTexture(textureHandle_t const handle) const OVR_OVERRIDE;
 
@@ -89,10 +133,29 @@ class ovrTextureManagerImpl : public ovrTextureManager {
     virtual void PrintStats() const OVR_OVERRIDE;
 
    private:
+    // the levels a texture is re-created from when it drops its top mip level, kept from the
+    // load so dropping a level is only an upload
+    struct ovrStreamingSource {
+        std::unique_ptr<ovrDecodedTexture> LowerLevels;
+    };
+
+    // CPU memory the kept levels use.
+    static size_t GetLowerLevelsSize(ovrStreamingSource const& source) {
+        return source.LowerLevels != nullptr ? GetDecodedTextureSize(*source.LowerLevels) : 0;
+    }
+
+    // Only 2D images decoded to pixels whose second level is not below the minimum size.
+    static bool CanStream(ovrDecodedTexture const& decoded) {
+        return decoded.Pixels != nullptr && decoded.NumFaces == 1 && decoded.NumLevels > 1 &&
+            std::min(decoded.Width, decoded.Height) / 2 >= MIN_STREAMED_TEXTURE_SIZE;
+    }
+
     std::vector<ovrManagedTexture> Textures;
+    std::vector<ovrStreamingSource> StreamingSources;
     std::vector<int> FreeTextures;
     bool Initialized;
     std::unordered_map<std::string, int> UriHash;
+    mutable ovrTextureResidency Residency;
 
     mutable int NumUriLoads;
     mutable int NumActualUriLoads;
@@ -111,6 +174,11 @@ class ovrTextureManagerImpl : public ovrTextureManager {
     int FindTextureIndex(int const iconId) const;
     int IndexForHandle(textureHandle_t const handle) const;
     textureHandle_t AllocTexture();
+    void FreeTextureIndex(int const idx);
+
+    // ovrTextureResidencyAllocator
+    virtual void EvictTexture(int const id) OVR_OVERRIDE;
+    virtual size_t DropTopMip(int const id) OVR_OVERRIDE;
 
     static void SetTextureWrapping(GlTexture& tex, ovrTextureWrap const wrapType);
     static void SetTextureFiltering(GlTexture& tex, ovrTextureFilter const filterType);
@@ -145,13 +213,15 @@ void ovrTextureManagerImpl::Init() {
 //==============================
 // ovrTextureManagerImpl::
 void ovrTextureManagerImpl::Shutdown() {
-    for (auto& texture : Textures) {
-        if (texture.IsValid()) {
-            texture.Free();
+    for (int i = 0; i < static_cast<int>(Textures.size()); ++i) {
+        if (Textures[i].IsValid()) {
+            Textures[i].Free();
         }
+        Residency.Remove(i);
     }
 
     Textures.resize(0);
+    StreamingSources.resize(0);
     FreeTextures.resize(0);
     UriHash.clear();
 
@@ -226,12 +296,22 @@ textureHandle_t ovrTextureManagerImpl::LoadTexture(
 
     int idx = FindTextureIndex(uri);
     if (idx >= 0) {
+        Residency.AddRef(idx);
         return Textures[idx].GetHandle();
     }
 
+    // decode before creating so the texture's format and levels are known for the budget
+    std::vector<uint8_t> buffer;
+    if (!fileSys.ReadFile(uri, buffer)) {
+        ALOG("LoadTextureFromUri( '%s' ) failed!", uri);
+        return textureHandle_t();
+    }
+    ovrDecodedTexture decoded;
+    DecodeTextureBuffer(
+        uri, buffer.data(), buffer.size(), TextureFlags_t(TEXTUREFLAG_NO_DEFAULT), decoded);
     int w;
     int h;
-    GlTexture tex = LoadTextureFromUri(fileSys, uri, TextureFlags_t(TEXTUREFLAG_NO_DEFAULT), w, h);
+    GlTexture tex = CreateTextureFromDecoded(decoded, w, h);
     if (!tex.IsValid()) {
         ALOG("LoadTextureFromUri( '%s' ) failed!", uri);
         return textureHandle_t();
@@ -244,9 +324,18 @@ textureHandle_t ovrTextureManagerImpl::LoadTexture(
 
         idx = IndexForHandle(handle);
         Textures[idx] = ovrManagedTexture(handle, uri, tex);
+        // the lower levels cost a quarter of the texture's size in CPU memory, so they are only
+        // kept when there is a budget to drop levels for
+        if (Residency.GetBudget() != 0 && CanStream(decoded)) {
+            StreamingSources[idx].LowerLevels = CopyLowerLevels(decoded);
+        }
         UriHash[std::string(uri)] = idx;
 
         NumActualUriLoads++;
+
+        Residency.Add(
+            idx, GetDecodedTextureSize(decoded) + GetLowerLevelsSize(StreamingSources[idx]));
+        Residency.Enforce(*this);
     }
 
     return handle;
@@ -266,19 +355,21 @@ textureHandle_t ovrTextureManagerImpl::LoadTexture(
 
     int idx = FindTextureIndex(uri);
     if (idx >= 0) {
+        Residency.AddRef(idx);
         return Textures[idx].GetHandle();
     }
 
     int width = 0;
     int height = 0;
     // NOTE: buffer ownership handled by caller
-    GlTexture tex = LoadTextureFromBuffer(
+    ovrDecodedTexture decoded;
+    DecodeTextureBuffer(
         uri,
         static_cast<uint8_t const*>(buffer),
         bufferSize,
         TextureFlags_t(TEXTUREFLAG_NO_DEFAULT),
-        width,
-        height);
+        decoded);
+    GlTexture tex = CreateTextureFromDecoded(decoded, width, height);
 
     if (!tex.IsValid()) {
         ALOG(
@@ -303,6 +394,9 @@ textureHandle_t ovrTextureManagerImpl::LoadTexture(
         }
 
         NumActualBufferLoads++;
+
+        Residency.Add(idx, GetDecodedTextureSize(decoded));
+        Residency.Enforce(*this);
     }
 
     return handle;
@@ -328,6 +422,7 @@ textureHandle_t ovrTextureManagerImpl::LoadRGBATexture(
 
     int idx = FindTextureIndex(uri);
     if (idx >= 0) {
+        Residency.AddRef(idx);
         return Textures[idx].GetHandle();
     }
 
@@ -356,6 +451,9 @@ textureHandle_t ovrTextureManagerImpl::LoadRGBATexture(
             UriHash[std::string(uri)] = idx;
         }
         NumActualBufferLoads++;
+
+        Residency.Add(idx, GetTextureMemorySize(Texture_RGBA, imageWidth, imageHeight, 1));
+        Residency.Enforce(*this);
     }
     return handle;
 }
@@ -378,6 +476,7 @@ textureHandle_t ovrTextureManagerImpl::LoadRGBATexture(
 
     int idx = FindTextureIndex(iconId);
     if (idx >= 0) {
+        Residency.AddRef(idx);
         return Textures[idx].GetHandle();
     }
 
@@ -402,6 +501,9 @@ textureHandle_t ovrTextureManagerImpl::LoadRGBATexture(
         Textures[idx] = ovrManagedTexture(handle, iconId, tex);
 
         NumActualBufferLoads++;
+
+        Residency.Add(idx, GetTextureMemorySize(Texture_RGBA, imageWidth, imageHeight, 1));
+        Residency.Enforce(*this);
     }
     return handle;
 }
@@ -413,6 +515,7 @@ ovrManagedTexture ovrTextureManagerImpl::GetTexture(textureHandle_t const handle
     if (idx < 0) {
         return ovrManagedTexture();
     }
+    Residency.Touch(idx);
     return Textures[idx];
 }
 
@@ -423,22 +526,91 @@ GlTexture ovrTextureManagerImpl::GetGlTexture(textureHandle_t const handle) cons
     if (idx < 0) {
         return GlTexture();
     }
+    Residency.Touch(idx);
     return Textures[idx].GetTexture();
 }
 
+//==============================
+// ovrTextureManagerImpl::ReleaseTexture
+void ovrTextureManagerImpl::ReleaseTexture(textureHandle_t const handle) {
+    int idx = IndexForHandle(handle);
+    if (idx >= 0) {
+        Residency.Release(idx);
+    }
+}
+
 //==============================
 // ovrTextureManagerImpl::FreeTexture
 void ovrTextureManagerImpl::FreeTexture(textureHandle_t const handle) {
     int idx = IndexForHandle(handle);
     if (idx >= 0) {
-        if (Textures[idx].GetUri().empty()) {
-            UriHash.erase(Textures[idx].GetUri());
-        }
-        Textures[idx].Free();
-        FreeTextures.push_back(idx);
+        Residency.Remove(idx);
+        FreeTextureIndex(idx);
     }
 }
 
+//==============================
+// ovrTextureManagerImpl::FreeTextureIndex
+void ovrTextureManagerImpl::FreeTextureIndex(int const idx) {
+    // an evicted texture must not be found by its uri any more
+    if (!Textures[idx].GetUri().empty()) {
+        UriHash.erase(Textures[idx].GetUri());
+    }
+    Textures[idx].Free();
+    StreamingSources[idx] = ovrStreamingSource();
+    FreeTextures.push_back(idx);
+}
+
+//==============================
+// ovrTextureManagerImpl::SetMemoryBudget
+void ovrTextureManagerImpl::SetMemoryBudget(size_t const budgetBytes) {
+    Residency.SetBudget(budgetBytes);
+    Residency.Enforce(*this);
+}
+
+//==============================
+// ovrTextureManagerImpl::GetMemoryBudget
+size_t ovrTextureManagerImpl::GetMemoryBudget() const {
+    return Residency.GetBudget();
+}
+
+//==============================
+// ovrTextureManagerImpl::GetResidentBytes
+size_t ovrTextureManagerImpl::GetResidentBytes() const {
+    return Residency.GetResidentBytes();
+}
+
+//==============================
+// ovrTextureManagerImpl::EvictTexture
+void ovrTextureManagerImpl::EvictTexture(int const id) {
+    ALOG("ovrTextureManager: evicting '%s'", Textures[id].GetUri().c_str());
+    FreeTextureIndex(id);
+}
+
+//==============================
+// ovrTextureManagerImpl::DropTopMip
+size_t ovrTextureManagerImpl::DropTopMip(int const id) {
+    ovrStreamingSource& source = StreamingSources[id];
+    if (source.LowerLevels == nullptr) {
+        return 0;
+    }
+
+    // the levels that are kept come from the load, not from reading back the GL texture
+    ovrDecodedTexture const& lower = *source.LowerLevels;
+    GlTexture tex = Textures[id].GetTexture();
+    if (!ReplaceTextureLevels(tex, lower, 0)) {
+        source.LowerLevels.reset();
+        return 0;
+    }
+    size_t const size = GetDecodedTextureSize(lower);
+    std::string const uri = Textures[id].GetUri();
+    Textures[id] = ovrManagedTexture(Textures[id].GetHandle(), uri.c_str(), tex);
+    source.LowerLevels = CanStream(lower) ? CopyLowerLevels(lower) : nullptr;
+
+    ALOG("ovrTextureManager: '%s' dropped to %i x %i", uri.c_str(), tex.Width, tex.Height);
+    return size + GetLowerLevelsSize(source);
+}
+
 //==============================
 // ovrTextureManagerImpl::FindTextureIndex
 int ovrTextureManagerImpl::FindTextureIndex(char const* uri) const {
@@ -501,11 +673,13 @@ textureHandle_t ovrTextureManagerImpl::AllocTexture() {
         int idx = FreeTextures[static_cast<int>(FreeTextures.size()) - 1];
         FreeTextures.pop_back();
         Textures[idx] = ovrManagedTexture();
+        StreamingSources[idx] = ovrStreamingSource();
         return textureHandle_t(idx);
     }
 
     int idx = static_cast<int>(Textures.size());
     Textures.push_back(ovrManagedTexture());
+    StreamingSources.push_back(ovrStreamingSource());
 
     return textureHandle_t(idx);
 }
@@ -543,6 +717,10 @@ void ovrTextureManagerImpl::PrintStats() const {
 
     ALOG("NumSearches: %i", NumSearches);
     ALOG("NumCompares: %i", NumCompares);
+
+    ALOG("NumResident:   %i", Residency.GetNumResident());
+    ALOG("ResidentBytes: %zu", Residency.GetResidentBytes());
+    ALOG("MemoryBudget:  %zu", Residency.GetBudget());
 }
 
 //==============================================================================================
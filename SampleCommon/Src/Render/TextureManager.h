@@ -110,8 +110,25 @@ class ovrTextureManager {
         ovrTextureFilter const filterType = FILTER_DEFAULT,
         ovrTextureWrap const wrapType = WRAP_DEFAULT) = 0;
 
+    // Every LoadTexture*() call takes a reference to the texture it returns, including calls that
+    // find it already loaded. A released texture without references stays loaded, so the next
+    // load of it is free, until the memory budget needs the space.
+    virtual void ReleaseTexture(textureHandle_t const handle) = 0;
+    // Frees the texture right away, whatever its references.
     virtual void FreeTexture(textureHandle_t const handle) = 0;
 
+    // Memory the managed textures may use, as counted by GetResidentBytes(). When a load goes
+    // over it, textures without references are evicted least recently used first, then textures
+    // loaded from a uri drop their top mip levels. 0, the default, means no budget. Only uri
+    // textures loaded while a budget is set can drop levels: they keep a CPU copy of the levels
+    // below their top one, a quarter of their size, so that dropping a level does not read or
+    // decode the file again.
+    virtual void SetMemoryBudget(size_t const budgetBytes) = 0;
+    virtual size_t GetMemoryBudget() const = 0;
+    // Memory used by the managed textures: their GPU memory, from their formats, sizes and mip
+    // levels, plus the CPU copies of the levels kept for dropping the top one.
+    virtual size_t GetResidentBytes() const = 0;
+
     virtual ovrManagedTexture GetTexture(textureHandle_t const handle) const = 0;
     virtual GlTexture GetGlTexture(textureHandle_t const handle) const = 0;
 
@@ -0,0 +1,170 @@
+/************************************************************************************
+
+Filename    :   TextureResidency.cpp
+Content     :   Memory budget and LRU residency policy for managed textures.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "TextureResidency.h"
+
+#include <assert.h>
+#include <algorithm>
+
+#include "Misc/Log.h"
+
+namespace OVRFW {
+
+//==============================
+// ovrTextureResidency::ovrTextureResidency
+ovrTextureResidency::ovrTextureResidency()
+    : Budget(0), ResidentBytes(0), NumResident(0), UseCounter(0) {}
+
+//==============================
+// ovrTextureResidency::SetBudget
+void ovrTextureResidency::SetBudget(size_t const budgetBytes) {
+    Budget = budgetBytes;
+}
+
+//==============================
+// ovrTextureResidency::Add
+void ovrTextureResidency::Add(int const id, size_t const sizeInBytes) {
+    assert(id >= 0);
+    if (id >= static_cast<int>(Entries.size())) {
+        Entries.resize(id + 1);
+    }
+    Remove(id);
+
+    ovrEntry& entry = Entries[id];
+    entry.SizeInBytes = sizeInBytes;
+    entry.RefCount = 1;
+    entry.LastUse = ++UseCounter;
+    entry.Resident = true;
+    entry.CanDropMip = true;
+    ResidentBytes += sizeInBytes;
+    NumResident++;
+}
+
+//==============================
+// ovrTextureResidency::Remove
+void ovrTextureResidency::Remove(int const id) {
+    if (id < 0 || id >= static_cast<int>(Entries.size()) || !Entries[id].Resident) {
+        return;
+    }
+    ResidentBytes -= Entries[id].SizeInBytes;
+    NumResident--;
+    Entries[id] = ovrEntry();
+}
+
+//==============================
+// ovrTextureResidency::AddRef
+void ovrTextureResidency::AddRef(int const id) {
+    if (id >= 0 && id < static_cast<int>(Entries.size()) && Entries[id].Resident) {
+        Entries[id].RefCount++;
+        Entries[id].LastUse = ++UseCounter;
+    }
+}
+
+//==============================
+// ovrTextureResidency::Release
+void ovrTextureResidency::Release(int const id) {
+    if (id >= 0 && id < static_cast<int>(Entries.size()) && Entries[id].Resident) {
+        assert(Entries[id].RefCount > 0);
+        Entries[id].RefCount = std::max(Entries[id].RefCount - 1, 0);
+    }
+}
+
+//==============================
+// ovrTextureResidency::GetRefCount
+int ovrTextureResidency::GetRefCount(int const id) const {
+    if (id < 0 || id >= static_cast<int>(Entries.size())) {
+        return 0;
+    }
+    return Entries[id].RefCount;
+}
+
+//==============================
+// ovrTextureResidency::Touch
+void ovrTextureResidency::Touch(int const id) {
+    if (id >= 0 && id < static_cast<int>(Entries.size()) && Entries[id].Resident) {
+        Entries[id].LastUse = ++UseCounter;
+    }
+}
+
+//==============================
+// ovrTextureResidency::GetLeastRecentlyUsed
+void ovrTextureResidency::GetLeastRecentlyUsed(std::vector<int>& ids) const {
+    ids.clear();
+    for (int i = 0; i < static_cast<int>(Entries.size()); ++i) {
+        if (Entries[i].Resident) {
+            ids.push_back(i);
+        }
+    }
+    std::sort(ids.begin(), ids.end(), [this](int const a, int const b) {
+        return Entries[a].LastUse < Entries[b].LastUse;
+    });
+}
+
+//==============================
+// ovrTextureResidency::Enforce
+void ovrTextureResidency::Enforce(ovrTextureResidencyAllocator& allocator) {
+    if (!IsOverBudget()) {
+        return;
+    }
+
+    std::vector<int> ids;
+    GetLeastRecentlyUsed(ids);
+
+    // textures nobody uses are only kept around as a cache
+    int numEvicted = 0;
+    for (int i = 0; i < static_cast<int>(ids.size()) && IsOverBudget(); ++i) {
+        int const id = ids[i];
+        if (Entries[id].RefCount == 0) {
+            Remove(id);
+            allocator.EvictTexture(id);
+            numEvicted++;
+        }
+    }
+
+    // then trade resolution for memory, one level at a time so the least recently used textures
+    // give up the most
+    int numDropped = 0;
+    for (bool dropped = true; dropped && IsOverBudget();) {
+        dropped = false;
+        for (int i = 0; i < static_cast<int>(ids.size()) && IsOverBudget(); ++i) {
+            ovrEntry& entry = Entries[ids[i]];
+            if (!entry.Resident || !entry.CanDropMip) {
+                continue;
+            }
+            size_t const newSize = allocator.DropTopMip(ids[i]);
+            if (newSize == 0 || newSize >= entry.SizeInBytes) {
+                entry.CanDropMip = false;
+                continue;
+            }
+            ResidentBytes -= entry.SizeInBytes - newSize;
+            entry.SizeInBytes = newSize;
+            dropped = true;
+            numDropped++;
+        }
+    }
+
+    if (numEvicted > 0 || numDropped > 0) {
+        ALOG(
+            "ovrTextureResidency: evicted %i textures, dropped %i mip levels, %zu of %zu bytes resident",
+            numEvicted,
+            numDropped,
+            ResidentBytes,
+            Budget);
+    }
+    if (IsOverBudget()) {
+        ALOGW(
+            "ovrTextureResidency: %zu bytes of referenced textures exceed the %zu byte budget",
+            ResidentBytes,
+            Budget);
+    }
+}
+
+} // namespace OVRFW
@@ -0,0 +1,96 @@
+/************************************************************************************
+
+Filename    :   TextureResidency.h
+Content     :   Memory budget and LRU residency policy for managed textures.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OVRFW {
+
+//==============================================================
+// ovrTextureResidencyAllocator
+// The GL side of the residency policy, implemented by the texture manager.
+class ovrTextureResidencyAllocator {
+   public:
+    virtual ~ovrTextureResidencyAllocator() {}
+
+    // Deletes the texture. Only called for textures nobody holds a reference to.
+    virtual void EvictTexture(int const id) = 0;
+    // Re-creates the texture without its largest mip level and returns its new size in bytes,
+    // or 0 if the texture can't give up another level.
+    virtual size_t DropTopMip(int const id) = 0;
+};
+
+//==============================================================
+// ovrTextureResidency
+// Tracks the size, references and last use of every managed texture and decides what has to
+// go when the textures exceed the memory budget. Textures without references are evicted
+// least recently used first; if that is not enough, referenced textures give up their top mip
+// levels, again least recently used first. Nothing in here touches GL, all changes go through
+// the allocator.
+class ovrTextureResidency {
+   public:
+    ovrTextureResidency();
+
+    // 0 means no budget.
+    void SetBudget(size_t const budgetBytes);
+    size_t GetBudget() const {
+        return Budget;
+    }
+    size_t GetResidentBytes() const {
+        return ResidentBytes;
+    }
+    int GetNumResident() const {
+        return NumResident;
+    }
+
+    // Starts tracking a texture with one reference. ids are small indices, such as the texture
+    // manager's handles.
+    void Add(int const id, size_t const sizeInBytes);
+    // Stops tracking a texture that was freed by its owner.
+    void Remove(int const id);
+
+    void AddRef(int const id);
+    void Release(int const id);
+    int GetRefCount(int const id) const;
+
+    // Marks the texture as used now.
+    void Touch(int const id);
+
+    // Evicts and drops mips until the resident textures fit the budget, or nothing else can be
+    // done.
+    void Enforce(ovrTextureResidencyAllocator& allocator);
+
+   private:
+    struct ovrEntry {
+        ovrEntry() : SizeInBytes(0), RefCount(0), LastUse(0), Resident(false), CanDropMip(false) {}
+
+        size_t SizeInBytes;
+        int RefCount;
+        uint64_t LastUse;
+        bool Resident;
+        bool CanDropMip; // cleared once the allocator refuses to drop another level
+    };
+
+    std::vector<ovrEntry> Entries;
+    size_t Budget;
+    size_t ResidentBytes;
+    int NumResident;
+    uint64_t UseCounter;
+
+    bool IsOverBudget() const {
+        return Budget != 0 && ResidentBytes > Budget;
+    }
+    void GetLeastRecentlyUsed(std::vector<int>& ids) const;
+};
+
+} // namespace OVRFW
@@ -26,6 +26,9 @@ LOCAL_SRC_FILES := \
   ../../../Src/Input/HandMaskRenderer.cpp \
   ../../../Src/Input/HandModel.cpp \
   ../../../Src/Input/HandRenderer.cpp \
+  ../../../Src/Input/Haptics.cpp \
+  ../../../Src/Input/InputRecording.cpp \
+  ../../../Src/Input/InputSnapshot.cpp \
   ../../../Src/Platform/Android/Android.cpp \
   ../../../Src/Render/Framebuffer.c \
   ../../../Src/SurfaceRenderApp.cpp \
@@ -22,6 +22,7 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include <android/native_window_jni.h>
 
 #include <memory>
+#include <cstring>
 
 #include "VrApi_SystemUtils.h"
 
@@ -128,6 +129,7 @@ void ovrAppl::GetClockLevels(int32_t& cpuLevel, int& gpuLevel) const {
 bool ovrAppl::Init(const ovrAppContext* context, const ovrInitParms* initParms) {
     ALOGV("ovrAppl::Init");
     Context = context;
+    FrameContext = context;
     const ovrJava* java = reinterpret_cast<const ovrJava*>(context->ContextForVrApi());
 
     int32_t result = VRAPI_INITIALIZE_SUCCESS;
@@ -185,6 +187,7 @@ bool ovrAppl::AppInit(const ovrAppContext* /* context */) {
 
 void ovrAppl::Shutdown(const ovrAppContext* context) {
     Context = nullptr;
+    FrameContext = nullptr;
     AppShutdown(context);
 
     for (int eye = 0; eye < NumFramebuffers; eye++) {
@@ -279,7 +282,7 @@ void ovrAppl::HandleLifecycle(const ovrAppContext* context) {
         }
     } else {
         if (SessionObject != nullptr) {
-            // TODO: if separate render thread, wait on render thread before leaving VR mode
+            // with pipelined frames the simulation thread is idle here, see PipelinedFrame()
             AppPaused(context);
 
             ALOGV("eglGetCurrentSurface( EGL_DRAW ) = %p", eglGetCurrentSurface(EGL_DRAW));
@@ -287,6 +290,8 @@ void ovrAppl::HandleLifecycle(const ovrAppContext* context) {
 
             vrapi_LeaveVrMode(SessionObject);
             SessionObject = nullptr;
+            // a frame simulated for the session that ended is never rendered
+            PipelineFrameReady = false;
 
             ALOGV("eglGetCurrentSurface( EGL_DRAW ) = %p", eglGetCurrentSurface(EGL_DRAW));
         }
@@ -505,18 +510,38 @@ ovrApplFrameOut ovrAppl::Frame(ovrApplFrameIn& frameIn) {
         vrapi_LocateTrackingSpace(SessionObject, VRAPI_TRACKING_SPACE_LOCAL);
 
     frameIn.FrameIndex = FrameIndex;
+    // VrApi predicts from how far the index is ahead of the last submitted frame, so a frame
+    // simulated while the previous one is still rendering is predicted one frame further out
     frameIn.PredictedDisplayTime = vrapi_GetPredictedDisplayTime(SessionObject, FrameIndex);
     frameIn.RealTimeInSeconds = vrapi_GetTimeInSeconds();
 
-    Tracking = vrapi_GetPredictedTracking2(SessionObject, frameIn.PredictedDisplayTime);
-    frameIn.HeadPose = Tracking.HeadPose.Pose;
-    frameIn.Eye[0].ViewMatrix = Tracking.Eye[0].ViewMatrix;
-    frameIn.Eye[1].ViewMatrix = Tracking.Eye[1].ViewMatrix;
-    frameIn.Eye[0].ProjectionMatrix = Tracking.Eye[0].ProjectionMatrix;
-    frameIn.Eye[1].ProjectionMatrix = Tracking.Eye[1].ProjectionMatrix;
+    ovrTracking2& tracking = FrameTracking[FrameSlot(FrameIndex)];
+    tracking = vrapi_GetPredictedTracking2(SessionObject, frameIn.PredictedDisplayTime);
+    // a recording being played back replaces the head tracking here and the input in
+    // HandleVRInputEvents(), and shows as if it were predicted for this frame
+    if (InputRecordReader.IsOpen()) {
+        const void* record = InputRecordReader.GetRecord(InputPlaybackFrame);
+        if (record != nullptr) {
+            // the mapping isn't necessarily aligned for the record
+            memcpy(&InputRecord, record, sizeof(InputRecord));
+            tracking = InputRecord.HeadTracking;
+            tracking.HeadPose.TimeInSeconds = frameIn.PredictedDisplayTime;
+        } else {
+            ALOG("Frame: input playback ended after %i frames", InputPlaybackFrame);
+            StopInputPlayback();
+        }
+    }
+    if (!PipelinedFrames) {
+        Tracking = tracking;
+    }
+    frameIn.HeadPose = tracking.HeadPose.Pose;
+    frameIn.Eye[0].ViewMatrix = tracking.Eye[0].ViewMatrix;
+    frameIn.Eye[1].ViewMatrix = tracking.Eye[1].ViewMatrix;
+    frameIn.Eye[0].ProjectionMatrix = tracking.Eye[0].ProjectionMatrix;
+    frameIn.Eye[1].ProjectionMatrix = tracking.Eye[1].ProjectionMatrix;
     frameIn.EyeHeight = vrapi_GetEyeHeight(&eyeLevelTrackingPose, &trackingPose);
-    frameIn.IPD = vrapi_GetInterpupillaryDistance(&Tracking);
-    const ovrJava* java = reinterpret_cast<const ovrJava*>(Context->ContextForVrApi());
+    frameIn.IPD = vrapi_GetInterpupillaryDistance(&tracking);
+    const ovrJava* java = reinterpret_cast<const ovrJava*>(FrameContext->ContextForVrApi());
     frameIn.RecenterCount = vrapi_GetSystemStatusInt(java, VRAPI_SYS_STATUS_RECENTER_COUNT);
 
     static double LastPredictedDisplayTime = frameIn.PredictedDisplayTime;
@@ -529,16 +554,14 @@ ovrApplFrameOut ovrAppl::Frame(ovrApplFrameIn& frameIn) {
     // VrApi Events event queue must be processed with regular frequency.
     HandleVrApiEvents(frameIn);
 
-    // copy input from the pending lists into the frame input
-    {
-        std::lock_guard<std::mutex> lock(KeyEventMutex);
-        frameIn.KeyEvents = PendingKeyEvents;
-        PendingKeyEvents.clear();
-    }
-    {
-        std::lock_guard<std::mutex> lock(TouchEventMutex);
-        frameIn.TouchEvents = PendingTouchEvents;
-        PendingTouchEvents.clear();
+    // hand the pending input over to the frame input in one batch; the input callback keeps
+    // pushing while we drain, anything it adds after this point goes to the next frame
+    PendingKeyEvents.PopAll(frameIn.KeyEvents);
+    PendingTouchEvents.PopAll(frameIn.TouchEvents);
+    const int overflowedInputEvents =
+        PendingKeyEvents.TakeNumOverflowed() + PendingTouchEvents.TakeNumOverflowed();
+    if (overflowedInputEvents > 0) {
+        ALOGW("Frame: %i input events overflowed the pending queues", overflowedInputEvents);
     }
 
     // VR input
@@ -581,6 +604,9 @@ ovrApplFrameOut ovrAppl::Frame(ovrApplFrameIn& frameIn) {
 }
 
 void ovrAppl::RenderFrame(const ovrApplFrameIn& in) {
+    // the tracking this frame was simulated with; Frame() may already be on the next one
+    Tracking = FrameTracking[FrameSlot(in.FrameIndex)];
+
     ovrRendererOutput out = {};
     // default the Projection for each eye to whatever the input frame has,
     // but let the application override this
@@ -597,8 +623,8 @@ void ovrAppl::RenderFrame(const ovrApplFrameIn& in) {
     ovrSubmitFrameDescription2 frameDesc = {};
     frameDesc.Flags = FrameFlags;
     frameDesc.SwapInterval = 1;
-    frameDesc.FrameIndex = GetFrameIndex();
-    frameDesc.DisplayTime = GetDisplayTime();
+    frameDesc.FrameIndex = in.FrameIndex;
+    frameDesc.DisplayTime = in.PredictedDisplayTime;
     frameDesc.LayerCount = NumLayers;
     frameDesc.Layers = layerPtrs;
 
@@ -756,17 +782,13 @@ void ovrAppl::AppHandleVrApiEvent(const ovrEventHeader* event) {
 }
 
 void ovrAppl::AddKeyEvent(const int32_t keyCode, const int32_t action) {
-    // lock while we push back the event because we could be copying events into
-    // the event buffer when the OS calls back the input handler
-    std::lock_guard<std::mutex> lock(KeyEventMutex);
-    PendingKeyEvents.push_back(ovrKeyEvent(keyCode, action, GetTimeInSeconds()));
+    // lock free unless the frame loop stalls long enough to fill the queue; then the events go
+    // to the queue's overflow under a lock, in order, and the next frame reports how many did
+    PendingKeyEvents.Push(ovrKeyEvent(keyCode, action, GetTimeInSeconds()));
 }
 
 void ovrAppl::AddTouchEvent(const int32_t action, const int32_t x, const int32_t y) {
-    // lock while we push back the event because we could be copying events into
-    // the event buffer when the OS calls back the input handler
-    std::lock_guard<std::mutex> lock(TouchEventMutex);
-    PendingTouchEvents.push_back(ovrTouchEvent(action, x, y, GetTimeInSeconds()));
+    PendingTouchEvents.Push(ovrTouchEvent(action, x, y, GetTimeInSeconds()));
 }
 
 void ovrAppl::HandleVRInputEvents(ovrApplFrameIn& in) {
@@ -775,61 +797,59 @@ void ovrAppl::HandleVRInputEvents(ovrApplFrameIn& in) {
     in.AllButtons = 0u;
     in.AllTouches = 0u;
 
-    const ovrJava* java = reinterpret_cast<const ovrJava*>(Context->ContextForVrApi());
+    const ovrJava* java = reinterpret_cast<const ovrJava*>(FrameContext->ContextForVrApi());
 
     // Track mount status
     in.HeadsetIsMounted = (vrapi_GetSystemStatusInt(java, VRAPI_SYS_STATUS_MOUNTED) != VRAPI_FALSE);
 
-    // Enumerate input devices
-    for (ovrDeviceID deviceIndex = 0;; deviceIndex++) {
-        ovrInputCapabilityHeader capsHeader;
-
-        if (vrapi_EnumerateInputDevices(GetSessionObject(), deviceIndex, &capsHeader) < 0) {
-            break; // no more devices
+    // Read all input devices once; everything else this frame works from the snapshot. With
+    // pipelined frames the previous frame may still be rendering from the other slot, so this
+    // slot starts from a copy of it to keep the cached device capabilities.
+    ovrInputSnapshot& snapshot = InputSnapshots[FrameSlot(in.FrameIndex)];
+    if (PipelinedFrames) {
+        snapshot = InputSnapshots[FrameSlot(in.FrameIndex - 1)];
+    }
+    if (InputRecordReader.IsOpen()) {
+        snapshot.Restore(InputRecord, in.PredictedDisplayTime);
+        InputPlaybackFrame++;
+    } else {
+        snapshot.Capture(GetSessionObject(), java, in.PredictedDisplayTime);
+        if (InputRecordWriter.IsOpen()) {
+            snapshot.Save(InputRecord);
+            InputRecord.HeadTracking = FrameTracking[FrameSlot(in.FrameIndex)];
+            if (!InputRecordWriter.Append(&InputRecord)) {
+                ALOGW("HandleVRInputEvents: input recording failed");
+            }
         }
+    }
+    in.Input = &snapshot;
 
-        /// deviceID is not the same as deviceIndex!
-        ovrDeviceID deviceID = capsHeader.DeviceID;
-        if (deviceID == ovrDeviceIdType_Invalid) {
-            ALOGV("HandleVRInputEvents - Invalid deviceID for deviceIndex=%u", deviceIndex);
-            assert(deviceID != ovrDeviceIdType_Invalid);
+    for (int i = 0; i < snapshot.GetNumDevices(); ++i) {
+        const ovrInputDeviceSnapshot& device = snapshot.GetDevice(i);
+        // Focus on remotes for now
+        if (device.Header.Type != ovrControllerType_TrackedRemote || !device.StateValid) {
             continue;
         }
-
-        // Focus on remotes for now
-        if (capsHeader.Type == ovrControllerType_TrackedRemote) {
-            ovrInputTrackedRemoteCapabilities remoteCaps;
-            remoteCaps.Header = capsHeader;
-            if (ovrSuccess ==
-                vrapi_GetInputDeviceCapabilities(GetSessionObject(), &remoteCaps.Header)) {
-                bool isLeft = (remoteCaps.ControllerCapabilities & ovrControllerCaps_LeftHand) != 0;
-                bool isRight =
-                    (remoteCaps.ControllerCapabilities & ovrControllerCaps_RightHand) != 0;
-
-                ovrInputStateTrackedRemote state;
-                state.Header.ControllerType = ovrControllerType_TrackedRemote;
-
-                if (ovrSuccess ==
-                    vrapi_GetCurrentInputState(GetSessionObject(), deviceID, &state.Header)) {
-                    if (isLeft) {
-                        in.LeftRemoteTracked = true;
-                        in.LeftRemoteJoystick = state.Joystick;
-                        in.LeftRemoteIndexTrigger = state.IndexTrigger;
-                        in.LeftRemoteGripTrigger = state.GripTrigger;
-                        in.AllButtons |= state.Buttons;
-                        in.AllTouches |= state.Touches;
-                    }
-                    if (isRight) {
-                        in.RightRemoteTracked = true;
-                        in.RightRemoteJoystick = state.Joystick;
-                        in.RightRemoteIndexTrigger = state.IndexTrigger;
-                        in.RightRemoteGripTrigger = state.GripTrigger;
-                        in.AllButtons |= state.Buttons;
-                        in.AllTouches |= state.Touches;
-                    }
-                }
+        const ovrInputStateTrackedRemote& state = device.RemoteState;
+        if (device.IsLeftHand()) {
+            in.LeftRemoteTracked = true;
+            in.LeftRemoteJoystick = state.Joystick;
+            in.LeftRemoteIndexTrigger = state.IndexTrigger;
+            in.LeftRemoteGripTrigger = state.GripTrigger;
+            if (device.TrackingValid) {
+                in.LeftRemotePose = device.Tracking.HeadPose.Pose;
+            }
+        } else {
+            in.RightRemoteTracked = true;
+            in.RightRemoteJoystick = state.Joystick;
+            in.RightRemoteIndexTrigger = state.IndexTrigger;
+            in.RightRemoteGripTrigger = state.GripTrigger;
+            if (device.TrackingValid) {
+                in.RightRemotePose = device.Tracking.HeadPose.Pose;
             }
         }
+        in.AllButtons |= state.Buttons;
+        in.AllTouches |= state.Touches;
     }
 
     // Delta from last frame
@@ -841,6 +861,38 @@ void ovrAppl::HandleVRInputEvents(ovrApplFrameIn& in) {
     LastFrameHeadsetIsMounted = in.HeadsetIsMounted;
 }
 
+bool ovrAppl::StartInputRecording(const char* path, const bool compress) {
+    StopInputPlayback();
+    if (!InputRecordWriter.Open(path, sizeof(ovrInputFrameRecord), compress)) {
+        return false;
+    }
+    ALOG("StartInputRecording: recording input to '%s'", path);
+    return true;
+}
+
+void ovrAppl::StopInputRecording() {
+    if (InputRecordWriter.IsOpen()) {
+        ALOG("StopInputRecording: %i frames recorded", InputRecordWriter.GetNumRecords());
+    }
+    InputRecordWriter.Close();
+}
+
+bool ovrAppl::StartInputPlayback(const char* path) {
+    StopInputRecording();
+    if (!InputRecordReader.Open(path, sizeof(ovrInputFrameRecord)) ||
+        InputRecordReader.GetNumRecords() == 0) {
+        InputRecordReader.Close();
+        return false;
+    }
+    InputPlaybackFrame = 0;
+    ALOG("StartInputPlayback: playing %i frames", InputRecordReader.GetNumRecords());
+    return true;
+}
+
+void ovrAppl::StopInputPlayback() {
+    InputRecordReader.Close();
+}
+
 void ovrAppl::Run(struct android_app* app) {
     ALOGV("----------------------------------------------------------------");
     ALOGV("android_main()");
@@ -860,6 +912,10 @@ void ovrAppl::Run(struct android_app* app) {
 
     bool exitApp = false;
 
+    if (PipelinedFrames) {
+        StartSimThread();
+    }
+
     // main loop
     while (app->destroyRequested == 0) {
         for (;;) {
@@ -883,6 +939,11 @@ void ovrAppl::Run(struct android_app* app) {
             continue;
         }
 
+        if (PipelinedFrames) {
+            exitApp = PipelinedFrame().ExitApp;
+            continue;
+        }
+
         OVRFW::ovrApplFrameIn frameIn;
         OVRFW::ovrApplFrameOut frameOut = Frame(frameIn);
         RenderFrame(frameIn);
@@ -890,6 +951,7 @@ void ovrAppl::Run(struct android_app* app) {
         exitApp = frameOut.ExitApp;
     }
 
+    StopSimThread();
     Shutdown(ctx.get());
     ctx->Shutdown();
 
@@ -898,4 +960,102 @@ void ovrAppl::Run(struct android_app* app) {
     ALOGV("----------------------------------------------------------------");
 }
 
+//==============================
+// ovrAppl::PipelinedFrame
+// Renders the frame simulated during the previous call while the simulation thread runs Frame()
+// for the next one. Returns once both are done, so the main loop can handle lifecycle changes
+// between calls without racing the simulation thread.
+ovrApplFrameOut ovrAppl::PipelinedFrame() {
+    if (!PipelineFrameReady) {
+        // first frame of a session, there is nothing to render alongside it
+        StartSimFrame(PipelineFrames[PipelineCurrent]);
+        PipelineFrameOut = FinishSimFrame();
+        PipelineFrameReady = true;
+    }
+    const ovrApplFrameOut frameOut = PipelineFrameOut;
+
+    StartSimFrame(PipelineFrames[PipelineCurrent ^ 1]);
+    RenderFrame(PipelineFrames[PipelineCurrent]);
+    PipelineFrameOut = FinishSimFrame();
+
+    PipelineCurrent ^= 1;
+    return frameOut;
+}
+
+//==============================
+// ovrAppl::StartSimThread
+void ovrAppl::StartSimThread() {
+    SimExit = false;
+    SimFrameIn = nullptr;
+    PipelineFrameReady = false;
+    FrameContext = &SimContext;
+    SimThread = std::thread(&ovrAppl::SimThreadFunction, this);
+}
+
+//==============================
+// ovrAppl::StopSimThread
+void ovrAppl::StopSimThread() {
+    if (!SimThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(SimMutex);
+        SimExit = true;
+    }
+    SimCondition.notify_all();
+    SimThread.join();
+    FrameContext = Context;
+}
+
+//==============================
+// ovrAppl::SimThreadFunction
+void ovrAppl::SimThreadFunction() {
+    // the VrApi calls in Frame() need a JNIEnv attached to this thread
+    const ovrJava* java = reinterpret_cast<const ovrJava*>(Context->ContextForVrApi());
+    SimContext.Init(java->Vm, java->ActivityObject, "OVR::Sim");
+
+    for (;;) {
+        ovrApplFrameIn* in = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(SimMutex);
+            SimCondition.wait(lock, [this] { return SimExit || SimFrameIn != nullptr; });
+            if (SimExit) {
+                break;
+            }
+            in = SimFrameIn;
+        }
+
+        // start from a clean frame, as the serial loop does with its local
+        *in = ovrApplFrameIn();
+        const ovrApplFrameOut out = Frame(*in);
+
+        {
+            std::lock_guard<std::mutex> lock(SimMutex);
+            SimFrameOut = out;
+            SimFrameIn = nullptr;
+        }
+        SimCondition.notify_all();
+    }
+
+    SimContext.Shutdown();
+}
+
+//==============================
+// ovrAppl::StartSimFrame
+void ovrAppl::StartSimFrame(ovrApplFrameIn& in) {
+    {
+        std::lock_guard<std::mutex> lock(SimMutex);
+        SimFrameIn = &in;
+    }
+    SimCondition.notify_all();
+}
+
+//==============================
+// ovrAppl::FinishSimFrame
+ovrApplFrameOut ovrAppl::FinishSimFrame() {
+    std::unique_lock<std::mutex> lock(SimMutex);
+    SimCondition.wait(lock, [this] { return SimFrameIn == nullptr; });
+    return SimFrameOut;
+}
+
 } // namespace OVRFW
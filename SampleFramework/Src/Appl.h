@@ -14,19 +14,25 @@ Copyright:  Copyright (c) Facebook Technologies, LLC and its affiliates. All rig
 
 #include <cstdint>
 #include <vector>
-#include <mutex>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #include "VrApi.h"
 #include "VrApi_Helpers.h"
 #include "VrApi_Input.h"
 
 #include "OVR_Math.h"
+#include "OVR_Lockless.h"
 
 #include "System.h"
 #include "FrameParams.h"
 #include "OVR_FileSys.h"
 
+#include "Input/InputRecording.h"
+#include "Input/InputSnapshot.h"
 #include "Platform/Android/Android.h"
 #include <android_native_app_glue.h>
 #include <android/keycodes.h>
@@ -95,10 +101,11 @@ class ovrAppl {
     // Called once per frame to allow the application to render eye buffers.
     void RenderFrame(const ovrApplFrameIn& in);
 
-    // Called from the OS callback when a key event occurs.
+    // Called from the OS callback when a key event occurs. The pending events are a single
+    // producer queue, so this must always be called from the same thread.
     void AddKeyEvent(const int32_t keyCode, const int32_t action);
 
-    // Called from the OS callback when a touch event occurs.
+    // Called from the OS callback when a touch event occurs. Same threading rule as AddKeyEvent.
     void AddTouchEvent(const int32_t action, const int32_t x, const int32_t y);
 
     // Handle VrApi system events.
@@ -127,6 +134,31 @@ class ovrAppl {
         RunWhilePaused = b;
     }
 
+    // Called before Run() to simulate the next frame on a separate thread while the current one
+    // renders. AppFrame() then runs on the simulation thread and AppRenderFrame() on the main
+    // thread, at the same time and for consecutive frames, so any state they share must be
+    // synchronized by the application. AppRenderFrame() should use in.FrameIndex and
+    // in.PredictedDisplayTime rather than GetFrameIndex() and GetDisplayTime(), which belong to
+    // the frame being simulated, and AppFrame() should use in.HeadPose and in.Eye rather than
+    // Tracking, which belongs to the frame being rendered. The predicted display time accounts
+    // for the extra frame.
+    void SetPipelinedFrames(bool b) {
+        PipelinedFrames = b;
+    }
+
+    // Records every frame's input snapshot and head tracking to path, streaming it to disk as it
+    // goes, until StopInputRecording(). Call from AppFrame().
+    bool StartInputRecording(const char* path, const bool compress = true);
+    void StopInputRecording();
+    // Replays a recording made by StartInputRecording() in place of the live input and head
+    // tracking, one recorded frame per frame, then goes back to the live ones. Call from
+    // AppFrame(); the recording takes over from the next frame.
+    bool StartInputPlayback(const char* path);
+    void StopInputPlayback();
+    bool IsPlayingInput() const {
+        return InputRecordReader.IsOpen();
+    }
+
    protected:
     //============================
     // protected interface
@@ -151,6 +183,12 @@ class ovrAppl {
         return DisplayTime;
     }
 
+    // The context for VrApi and JNI calls made from AppFrame(). It differs from GetContext()
+    // when frames are pipelined, since each thread needs its own JNIEnv.
+    const OVRFW::ovrAppContext* GetFrameContext() const {
+        return FrameContext;
+    }
+
     int GetNumFramebuffers() const {
         return NumFramebuffers;
     }
@@ -233,17 +271,53 @@ class ovrAppl {
     uint32_t LastFrameAllButtons = 0u;
     uint32_t LastFrameAllTouches = 0u;
     bool LastFrameHeadsetIsMounted = true;
+    // per frame slot, so a pipelined frame can be rendered while the next one is simulated
+    ovrInputSnapshot InputSnapshots[2];
+    ovrTracking2 FrameTracking[2];
+    // input recording and playback, on the thread that runs Frame()
+    ovrInputRecordWriter InputRecordWriter;
+    ovrInputRecordReader InputRecordReader;
+    int InputPlaybackFrame = 0;
+    ovrInputFrameRecord InputRecord;
 
     bool UseMultiView;
     std::unique_ptr<ovrFramebuffer> Framebuffer[VRAPI_FRAME_LAYER_EYE_MAX];
     int NumFramebuffers;
 
-    std::mutex KeyEventMutex;
-    std::vector<ovrKeyEvent> PendingKeyEvents;
-    std::mutex TouchEventMutex;
-    std::vector<ovrTouchEvent> PendingTouchEvents;
+    // events from the OS input callback, drained into the frame input by Frame(); beyond this
+    // many, they wait in the queue's overflow
+    static const int MAX_PENDING_KEY_EVENTS = 256;
+    static const int MAX_PENDING_TOUCH_EVENTS = 256;
+    OVR::LocklessSpscOverflowQueue<ovrKeyEvent, MAX_PENDING_KEY_EVENTS> PendingKeyEvents;
+    OVR::LocklessSpscOverflowQueue<ovrTouchEvent, MAX_PENDING_TOUCH_EVENTS> PendingTouchEvents;
     bool IsAppFocused = false;
     bool RunWhilePaused = false;
+
+    // pipelined frames, see SetPipelinedFrames()
+    bool PipelinedFrames = false;
+    const OVRFW::ovrAppContext* FrameContext = nullptr;
+    ovrApplFrameIn PipelineFrames[2];
+    ovrApplFrameOut PipelineFrameOut;
+    int PipelineCurrent = 0;
+    bool PipelineFrameReady = false;
+    // the simulation thread runs Frame() on SimFrameIn and clears it when done
+    ovrAndroidContext SimContext;
+    std::thread SimThread;
+    std::mutex SimMutex;
+    std::condition_variable SimCondition;
+    ovrApplFrameIn* SimFrameIn = nullptr;
+    ovrApplFrameOut SimFrameOut;
+    bool SimExit = false;
+
+    int FrameSlot(const uint64_t frameIndex) const {
+        return PipelinedFrames ? static_cast<int>(frameIndex & 1) : 0;
+    }
+    ovrApplFrameOut PipelinedFrame();
+    void StartSimThread();
+    void StopSimThread();
+    void SimThreadFunction();
+    void StartSimFrame(ovrApplFrameIn& in);
+    ovrApplFrameOut FinishSimFrame();
 };
 
 } // namespace OVRFW
@@ -0,0 +1,294 @@
+/************************************************************************************
+
+Filename    :   Haptics.cpp
+Content     :   Buffered haptics for tracked remotes, scheduled ahead of the display time
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+************************************************************************************/
+#include "Haptics.h"
+
+#include <math.h>
+
+namespace OVRFW {
+
+static float ClampIntensity(const float intensity) {
+    return intensity < 0.0f ? 0.0f : (intensity > 1.0f ? 1.0f : intensity);
+}
+
+//==============================
+// ovrVrApiHapticsSink::SubmitBuffer
+bool ovrVrApiHapticsSink::SubmitBuffer(const ovrHapticBuffer& buffer) {
+    return vrapi_SetHapticVibrationBuffer(Ovr, DeviceID, &buffer) == ovrSuccess;
+}
+
+//==============================
+// ovrVrApiHapticsSink::SubmitSimple
+bool ovrVrApiHapticsSink::SubmitSimple(const float intensity) {
+    return vrapi_SetHapticVibrationSimple(Ovr, DeviceID, intensity) == ovrSuccess;
+}
+
+ovrHapticsEngine::ovrHapticsEngine()
+    : Buffered(false),
+      Simple(false),
+      SampleSeconds(0.0),
+      SamplesPerBuffer(0),
+      NextEffectId(0),
+      NumSubmits(0) {
+    Reset();
+}
+
+//==============================
+// ovrHapticsEngine::SetCapabilities
+void ovrHapticsEngine::SetCapabilities(const ovrInputTrackedRemoteCapabilities& caps) {
+    Buffered = (caps.ControllerCapabilities & ovrControllerCaps_HasBufferedHapticVibration) != 0 &&
+        caps.HapticSampleDurationMS > 0 && caps.HapticSamplesMax > 0;
+    Simple = (caps.ControllerCapabilities & ovrControllerCaps_HasSimpleHapticVibration) != 0;
+    SampleSeconds = caps.HapticSampleDurationMS * 0.001;
+    SamplesPerBuffer = 0;
+    if (Buffered) {
+        SamplesPerBuffer = static_cast<int>(ceil(FILL_AHEAD_SECONDS / SampleSeconds));
+        if (SamplesPerBuffer > static_cast<int>(caps.HapticSamplesMax)) {
+            SamplesPerBuffer = static_cast<int>(caps.HapticSamplesMax);
+        }
+        if (SamplesPerBuffer > MAX_SAMPLES) {
+            SamplesPerBuffer = MAX_SAMPLES;
+        }
+    }
+    Reset();
+}
+
+//==============================
+// ovrHapticsEngine::Reset
+void ovrHapticsEngine::Reset() {
+    for (int i = 0; i < HAPTIC_CHANNEL_MAX; ++i) {
+        Targets[i] = 0.0f;
+        Levels[i] = 0.0f;
+    }
+    NumEffects = 0;
+    Queued = false;
+    Resubmit = false;
+    QueuedFrom = 0.0;
+    QueuedUntil = 0.0;
+    LastSimpleTime = 0.0;
+    LastSimpleIntensity = 0.0f;
+}
+
+//==============================
+// ovrHapticsEngine::SetSustained
+void ovrHapticsEngine::SetSustained(const ovrHapticChannel channel, const float intensity) {
+    if (channel >= 0 && channel < HAPTIC_CHANNEL_MAX) {
+        Targets[channel] = ClampIntensity(intensity);
+    }
+}
+
+//==============================
+// ovrHapticsEngine::Play
+int ovrHapticsEngine::Play(
+    const double startTime,
+    const double duration,
+    const float fromIntensity,
+    const float toIntensity,
+    const bool loop) {
+    if (duration <= 0.0 || NumEffects == MAX_EFFECTS) {
+        return -1;
+    }
+    ovrHapticEffect& effect = Effects[NumEffects++];
+    effect.Id = NextEffectId++;
+    // the next buffer would start where the queued samples end, so an effect starting earlier
+    // would lose its beginning, or all of a short one; the queued samples are sent again with it
+    effect.StartTime = startTime;
+    effect.Late = Queued && startTime < QueuedUntil;
+    Resubmit = Resubmit || effect.Late;
+    effect.Duration = duration;
+    effect.FromIntensity = ClampIntensity(fromIntensity);
+    effect.ToIntensity = ClampIntensity(toIntensity);
+    effect.Loop = loop;
+    if (NextEffectId < 0) {
+        NextEffectId = 0;
+    }
+    return effect.Id;
+}
+
+//==============================
+// ovrHapticsEngine::Stop
+void ovrHapticsEngine::Stop(const int effectId) {
+    for (int i = 0; i < NumEffects; ++i) {
+        if (Effects[i].Id == effectId) {
+            Effects[i] = Effects[--NumEffects];
+            return;
+        }
+    }
+}
+
+//==============================
+// ovrHapticsEngine::IsSilent
+bool ovrHapticsEngine::IsSilent() const {
+    if (NumEffects > 0) {
+        return false;
+    }
+    for (int i = 0; i < HAPTIC_CHANNEL_MAX; ++i) {
+        if (Targets[i] > 0.0f || Levels[i] > 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//==============================
+// ovrHapticsEngine::EffectIntensity
+// The strongest effect at time, without the sustained levels.
+float ovrHapticsEngine::EffectIntensity(const double time) const {
+    float intensity = 0.0f;
+    for (int i = 0; i < NumEffects; ++i) {
+        const ovrHapticEffect& effect = Effects[i];
+        double t = time - effect.StartTime;
+        if (t < 0.0) {
+            continue;
+        }
+        if (effect.Loop) {
+            t = fmod(t, effect.Duration);
+        } else if (t >= effect.Duration) {
+            continue;
+        }
+        const float value = effect.FromIntensity +
+            (effect.ToIntensity - effect.FromIntensity) * static_cast<float>(t / effect.Duration);
+        intensity = value > intensity ? value : intensity;
+    }
+    return intensity;
+}
+
+//==============================
+// ovrHapticsEngine::Sample
+// The intensity at time, moving the sustained levels on by seconds first.
+float ovrHapticsEngine::Sample(const double time, const double seconds) {
+    const float maxStep = SLEW_PER_SECOND * static_cast<float>(seconds);
+    float intensity = EffectIntensity(time);
+    for (int i = 0; i < HAPTIC_CHANNEL_MAX; ++i) {
+        const float delta = Targets[i] - Levels[i];
+        Levels[i] += delta > maxStep ? maxStep : (delta < -maxStep ? -maxStep : delta);
+        intensity = Levels[i] > intensity ? Levels[i] : intensity;
+    }
+    return ClampIntensity(intensity);
+}
+
+//==============================
+// ovrHapticsEngine::RemoveFinishedEffects
+void ovrHapticsEngine::RemoveFinishedEffects(const double time) {
+    for (int i = NumEffects - 1; i >= 0; --i) {
+        const ovrHapticEffect& effect = Effects[i];
+        if (!effect.Loop && effect.StartTime + effect.Duration <= time) {
+            Effects[i] = Effects[--NumEffects];
+        }
+    }
+}
+
+//==============================
+// ovrHapticsEngine::Update
+bool ovrHapticsEngine::Update(const double displayTime, ovrHapticsSink& sink) {
+    if (Buffered) {
+        return UpdateBuffered(displayTime, sink);
+    }
+    if (Simple) {
+        return UpdateSimple(displayTime, sink);
+    }
+    return false;
+}
+
+//==============================
+// ovrHapticsEngine::UpdateBuffered
+bool ovrHapticsEngine::UpdateBuffered(const double displayTime, ovrHapticsSink& sink) {
+    // the display time stands in for the playback position, as it is what buffers are timed by
+    if (Queued && !Resubmit && QueuedUntil - displayTime >= REFILL_SECONDS) {
+        return false;
+    }
+    if (!Queued && IsSilent()) {
+        return false;
+    }
+
+    // after a hitch the queue may have run dry, and the gap can't be filled in after the fact
+    double startTime = displayTime;
+    int kept = 0;
+    if (Queued && QueuedUntil > displayTime) {
+        if (Resubmit) {
+            // send the last buffer again from the first sample that hasn't started playing; the
+            // samples before it in that buffer, or in the one before, can't be replaced any more
+            const int offset = displayTime > QueuedFrom
+                ? static_cast<int>(ceil((displayTime - QueuedFrom) / SampleSeconds))
+                : 0;
+            startTime = QueuedFrom + offset * SampleSeconds;
+            kept = offset < SamplesPerBuffer ? SamplesPerBuffer - offset : 0;
+            for (int i = 0; i < kept; ++i) {
+                Samples[i] = Samples[offset + i];
+            }
+        } else {
+            startTime = QueuedUntil;
+        }
+    }
+    for (int i = 0; i < NumEffects; ++i) {
+        ovrHapticEffect& effect = Effects[i];
+        if (effect.Late) {
+            effect.StartTime = effect.StartTime < startTime ? startTime : effect.StartTime;
+            effect.Late = false;
+        }
+    }
+    Resubmit = false;
+
+    // the kept samples already hold the sustained levels, which have moved on past them
+    for (int i = 0; i < kept; ++i) {
+        const float intensity = ClampIntensity(EffectIntensity(startTime + i * SampleSeconds));
+        const uint8_t sample = static_cast<uint8_t>(intensity * 255.0f + 0.5f);
+        Samples[i] = sample > Samples[i] ? sample : Samples[i];
+    }
+    for (int i = kept; i < SamplesPerBuffer; ++i) {
+        const float intensity = Sample(startTime + i * SampleSeconds, SampleSeconds);
+        Samples[i] = static_cast<uint8_t>(intensity * 255.0f + 0.5f);
+    }
+    const double endTime = startTime + SamplesPerBuffer * SampleSeconds;
+    RemoveFinishedEffects(endTime);
+
+    ovrHapticBuffer buffer;
+    buffer.BufferTime = startTime;
+    buffer.NumSamples = SamplesPerBuffer;
+    buffer.HapticBuffer = Samples;
+    buffer.Terminated = IsSilent();
+
+    NumSubmits++;
+    if (!sink.SubmitBuffer(buffer)) {
+        // start over from the display time next frame
+        Queued = false;
+        return true;
+    }
+    Queued = !buffer.Terminated;
+    QueuedFrom = startTime;
+    QueuedUntil = endTime;
+    return true;
+}
+
+//==============================
+// ovrHapticsEngine::UpdateSimple
+bool ovrHapticsEngine::UpdateSimple(const double displayTime, ovrHapticsSink& sink) {
+    const double seconds = LastSimpleTime > 0.0 && displayTime > LastSimpleTime
+        ? displayTime - LastSimpleTime
+        : 0.0;
+    LastSimpleTime = displayTime;
+    const float intensity = Sample(displayTime, seconds);
+    RemoveFinishedEffects(displayTime);
+
+    // small changes are held back, but stopping and full strength are always sent exactly
+    const float delta = fabsf(intensity - LastSimpleIntensity);
+    if (delta == 0.0f ||
+        (delta <= SIMPLE_THRESHOLD && intensity > 0.0f && intensity < 1.0f)) {
+        return false;
+    }
+
+    NumSubmits++;
+    if (sink.SubmitSimple(intensity)) {
+        LastSimpleIntensity = intensity;
+    }
+    return true;
+}
+
+} // namespace OVRFW
@@ -0,0 +1,149 @@
+/************************************************************************************
+
+Filename    :   Haptics.h
+Content     :   Buffered haptics for tracked remotes, scheduled ahead of the display time
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+************************************************************************************/
+#pragma once
+
+#include "VrApi.h"
+#include "VrApi_Input.h"
+
+#include <cstdint>
+
+namespace OVRFW {
+
+//==============================================================
+// ovrHapticsSink
+// Where ovrHapticsEngine sends its output. VrApi accepts at most one call per device and frame,
+// and the engine never makes more than that.
+class ovrHapticsSink {
+   public:
+    virtual ~ovrHapticsSink() {}
+
+    virtual bool SubmitBuffer(const ovrHapticBuffer& buffer) = 0;
+    virtual bool SubmitSimple(const float intensity) = 0;
+};
+
+//==============================================================
+// ovrVrApiHapticsSink
+class ovrVrApiHapticsSink : public ovrHapticsSink {
+   public:
+    ovrVrApiHapticsSink(ovrMobile* ovr, const ovrDeviceID deviceID)
+        : Ovr(ovr), DeviceID(deviceID) {}
+
+    virtual bool SubmitBuffer(const ovrHapticBuffer& buffer) override;
+    virtual bool SubmitSimple(const float intensity) override;
+
+   private:
+    ovrMobile* Ovr;
+    ovrDeviceID DeviceID;
+};
+
+enum ovrHapticChannel {
+    HAPTIC_CHANNEL_INPUT, // driven by the controller's own buttons and triggers
+    HAPTIC_CHANNEL_FORCE, // force feedback from whatever the controller is driving
+    HAPTIC_CHANNEL_MAX
+};
+
+//==============================================================
+// ovrHapticsEngine
+// Mixes sustained levels and timed effects into a single vibration and streams it to a device.
+//
+// Devices with buffered haptics get samples at their native rate, computed up to
+// FILL_AHEAD_SECONDS past the display time, and a new buffer only once less than REFILL_SECONDS
+// of the last one is left to play, so the number of VrApi calls depends on the buffer length
+// rather than the frame rate. Sustained levels are slew limited per sample, which turns level
+// changes that arrive at a low or irregular rate into smooth ramps. Nothing is submitted while
+// there is nothing to play; the last buffer before going quiet is marked terminated.
+//
+// Devices with only simple haptics get the level at the display time, sent when it has changed
+// by more than SIMPLE_THRESHOLD.
+//
+// The output is the strongest of all channels and effects at each sample.
+class ovrHapticsEngine {
+   public:
+    static const int MAX_EFFECTS = 8;
+    static const int MAX_SAMPLES = 256;
+    static constexpr double FILL_AHEAD_SECONDS = 0.05;
+    static constexpr double REFILL_SECONDS = 0.025;
+    static constexpr float SLEW_PER_SECOND = 8.0f;
+    static constexpr float SIMPLE_THRESHOLD = 0.05f;
+
+    ovrHapticsEngine();
+
+    // Selects buffered or simple output from the device's capabilities and resets.
+    void SetCapabilities(const ovrInputTrackedRemoteCapabilities& caps);
+    // Drops all effects and levels without stopping what is already queued on the device.
+    void Reset();
+
+    // Sets the level a channel ramps to and holds, 0 to 1.
+    void SetSustained(const ovrHapticChannel channel, const float intensity);
+
+    // Schedules a linear ramp from one intensity to another. A looping effect restarts its ramp
+    // every duration until stopped. An effect that would start within samples already queued on
+    // the device is mixed into them on the next Update(), from the display time or the start of
+    // the last buffer, whichever is later, so it starts up to REFILL_SECONDS late. Returns an id
+    // for Stop(), or -1 if too many are playing.
+    int Play(
+        const double startTime,
+        const double duration,
+        const float fromIntensity,
+        const float toIntensity,
+        const bool loop = false);
+    void Stop(const int effectId);
+
+    // Called once per frame with the frame's display time. Returns true if it submitted.
+    bool Update(const double displayTime, ovrHapticsSink& sink);
+
+    bool IsPlaying() const {
+        return Queued;
+    }
+    int GetNumSubmits() const {
+        return NumSubmits;
+    }
+
+   private:
+    struct ovrHapticEffect {
+        int Id;
+        double StartTime;
+        double Duration;
+        float FromIntensity;
+        float ToIntensity;
+        bool Loop;
+        bool Late; // starts within the queued samples, which have to be sent again
+    };
+
+    bool Buffered;
+    bool Simple;
+    double SampleSeconds;
+    int SamplesPerBuffer;
+
+    float Targets[HAPTIC_CHANNEL_MAX];
+    float Levels[HAPTIC_CHANNEL_MAX];
+    ovrHapticEffect Effects[MAX_EFFECTS];
+    int NumEffects;
+    int NextEffectId;
+
+    bool Queued; // buffered samples are playing up to QueuedUntil
+    bool Resubmit; // a late effect has to be mixed into the queued samples
+    double QueuedFrom; // the start of the last buffer, which Samples still holds
+    double QueuedUntil;
+    double LastSimpleTime;
+    float LastSimpleIntensity;
+    int NumSubmits;
+    uint8_t Samples[MAX_SAMPLES];
+
+    bool IsSilent() const;
+    float EffectIntensity(const double time) const;
+    float Sample(const double time, const double seconds);
+    void RemoveFinishedEffects(const double time);
+    bool UpdateBuffered(const double displayTime, ovrHapticsSink& sink);
+    bool UpdateSimple(const double displayTime, ovrHapticsSink& sink);
+};
+
+} // namespace OVRFW
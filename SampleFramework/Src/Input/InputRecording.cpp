@@ -0,0 +1,362 @@
+/************************************************************************************
+
+Filename    :   InputRecording.cpp
+Content     :   Append-only input recording files and a memory mapped reader for them
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+************************************************************************************/
+#include "InputRecording.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "Misc/Log.h"
+
+namespace OVRFW {
+
+static const uint32_t RECORDING_MAGIC = ('O' << 0) | ('I' << 8) | ('R' << 16) | ('C' << 24);
+static const uint32_t RECORDING_VERSION = 1;
+static const uint32_t CHUNK_MAGIC = ('C' << 0) | ('H' << 8) | ('N' << 16) | ('K' << 24);
+static const uint32_t CHUNK_FLAG_COMPRESSED = 1u << 0;
+
+static const int FILE_HEADER_SIZE = 3 * 4;
+static const int CHUNK_HEADER_SIZE = 6 * 4;
+
+static void Put32(uint8_t* p, const uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+static uint32_t Get32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+ovrInputRecordWriter::ovrInputRecordWriter()
+    : File(nullptr),
+      RecordSize(0),
+      Compress(false),
+      NumRecords(0),
+      NumChunkRecords(0),
+      Stopping(false),
+      Failed(false) {}
+
+ovrInputRecordWriter::~ovrInputRecordWriter() {
+    Close();
+}
+
+//==============================
+// ovrInputRecordWriter::Open
+bool ovrInputRecordWriter::Open(const char* path, const uint32_t recordSize, const bool compress) {
+    Close();
+    // a chunk's raw size is stored in 32 bits
+    if (recordSize == 0 || recordSize > UINT32_MAX / RECORDS_PER_CHUNK) {
+        return false;
+    }
+    File = fopen(path, "wb");
+    if (File == nullptr) {
+        ALOGW("ovrInputRecordWriter: failed to create '%s'", path);
+        return false;
+    }
+    RecordSize = recordSize;
+    Compress = compress;
+    NumRecords = 0;
+    NumChunkRecords = 0;
+    Chunk.resize(static_cast<size_t>(RecordSize) * RECORDS_PER_CHUNK);
+
+    uint8_t header[FILE_HEADER_SIZE];
+    Put32(header + 0, RECORDING_MAGIC);
+    Put32(header + 4, RECORDING_VERSION);
+    Put32(header + 8, RecordSize);
+    if (fwrite(header, sizeof(header), 1, File) != 1) {
+        ALOGW("ovrInputRecordWriter: failed to write '%s'", path);
+        fclose(File);
+        File = nullptr;
+        return false;
+    }
+
+    Stopping = false;
+    Failed = false;
+    Thread = std::thread(&ovrInputRecordWriter::WriterThread, this);
+    return true;
+}
+
+//==============================
+// ovrInputRecordWriter::Close
+void ovrInputRecordWriter::Close() {
+    if (!Thread.joinable()) {
+        return;
+    }
+    Submit();
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Stopping = true;
+    }
+    Condition.notify_all();
+    Thread.join();
+    fclose(File);
+    File = nullptr;
+    Pending.clear();
+    Spare.clear();
+}
+
+//==============================
+// ovrInputRecordWriter::Append
+bool ovrInputRecordWriter::Append(const void* record) {
+    if (!Thread.joinable()) {
+        return false;
+    }
+    memcpy(Chunk.data() + static_cast<size_t>(NumChunkRecords) * RecordSize, record, RecordSize);
+    NumChunkRecords++;
+    NumRecords++;
+    if (NumChunkRecords == RECORDS_PER_CHUNK) {
+        return Flush();
+    }
+    return true;
+}
+
+//==============================
+// ovrInputRecordWriter::Flush
+bool ovrInputRecordWriter::Flush() {
+    if (!Thread.joinable()) {
+        return false;
+    }
+    if (!Submit()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+//==============================
+// ovrInputRecordWriter::Submit
+bool ovrInputRecordWriter::Submit() {
+    bool failed = false;
+    if (NumChunkRecords > 0) {
+        std::unique_lock<std::mutex> lock(Mutex);
+        Condition.wait(lock, [this] {
+            return Failed || static_cast<int>(Pending.size()) < MAX_PENDING_CHUNKS;
+        });
+        // the writer thread owns the full chunk now; the next one reuses a written buffer
+        Chunk.resize(static_cast<size_t>(NumChunkRecords) * RecordSize);
+        Pending.push_back(std::move(Chunk));
+        if (!Spare.empty()) {
+            Chunk = std::move(Spare.back());
+            Spare.pop_back();
+        }
+        failed = Failed;
+        NumChunkRecords = 0;
+        Chunk.resize(static_cast<size_t>(RecordSize) * RECORDS_PER_CHUNK);
+    } else {
+        std::lock_guard<std::mutex> lock(Mutex);
+        failed = Failed;
+    }
+    Condition.notify_all();
+    return !failed;
+}
+
+//==============================
+// ovrInputRecordWriter::WriteChunk
+bool ovrInputRecordWriter::WriteChunk(
+    const std::vector<uint8_t>& chunk,
+    std::vector<uint8_t>& compressed) {
+    const uint32_t rawSize = static_cast<uint32_t>(chunk.size());
+    const uint8_t* stored = chunk.data();
+    uint32_t storedSize = rawSize;
+    uint32_t flags = 0;
+    if (Compress) {
+        uLongf compressedSize = compressBound(rawSize);
+        compressed.resize(compressedSize);
+        // frames are mostly small changes to the previous one, so the fastest level does well
+        if (compress2(compressed.data(), &compressedSize, chunk.data(), rawSize, Z_BEST_SPEED) ==
+                Z_OK &&
+            compressedSize < rawSize) {
+            stored = compressed.data();
+            storedSize = static_cast<uint32_t>(compressedSize);
+            flags |= CHUNK_FLAG_COMPRESSED;
+        }
+    }
+
+    uint8_t header[CHUNK_HEADER_SIZE];
+    Put32(header + 0, CHUNK_MAGIC);
+    Put32(header + 4, flags);
+    Put32(header + 8, rawSize / RecordSize);
+    Put32(header + 12, rawSize);
+    Put32(header + 16, storedSize);
+    Put32(header + 20, static_cast<uint32_t>(adler32(adler32(0, nullptr, 0), stored, storedSize)));
+    return fwrite(header, sizeof(header), 1, File) == 1 &&
+        fwrite(stored, storedSize, 1, File) == 1 && fflush(File) == 0;
+}
+
+//==============================
+// ovrInputRecordWriter::WriterThread
+void ovrInputRecordWriter::WriterThread() {
+    pthread_setname_np(pthread_self(), "OVR::InputRec");
+
+    std::vector<uint8_t> compressed;
+    std::unique_lock<std::mutex> lock(Mutex);
+    for (;;) {
+        Condition.wait(lock, [this] { return Stopping || !Pending.empty(); });
+        if (Pending.empty()) {
+            break; // stopping, and everything is written
+        }
+        std::vector<uint8_t> chunk = std::move(Pending.front());
+        Pending.pop_front();
+        const bool failed = Failed;
+        lock.unlock();
+        // after a failed write the rest is discarded, so the file ends at the last whole chunk
+        const bool written = !failed && WriteChunk(chunk, compressed);
+        lock.lock();
+        if (!failed && !written) {
+            ALOGW("ovrInputRecordWriter: write failed, recording stopped");
+            Failed = true;
+        }
+        Spare.push_back(std::move(chunk));
+        Condition.notify_all();
+    }
+}
+
+ovrInputRecordReader::ovrInputRecordReader()
+    : Data(nullptr), RecordSize(0), NumRecords(0), CachedChunk(-1) {}
+
+ovrInputRecordReader::~ovrInputRecordReader() {
+    Close();
+}
+
+//==============================
+// ovrInputRecordReader::Open
+bool ovrInputRecordReader::Open(const char* path, const uint32_t recordSize) {
+    Close();
+    // MappedFile::OpenRead() would create a missing file
+    if (access(path, R_OK) != 0 || !File.OpenRead(path, true) || !View.Open(&File)) {
+        ALOGW("ovrInputRecordReader: failed to open '%s'", path);
+        Close();
+        return false;
+    }
+    Data = View.MapView();
+    if (Data == nullptr) {
+        ALOGW("ovrInputRecordReader: failed to map '%s'", path);
+        Close();
+        return false;
+    }
+    const size_t length = File.GetLength();
+    if (length < FILE_HEADER_SIZE || Get32(Data) != RECORDING_MAGIC ||
+        Get32(Data + 4) != RECORDING_VERSION) {
+        ALOGW("ovrInputRecordReader: '%s' is not an input recording", path);
+        Close();
+        return false;
+    }
+    if (Get32(Data + 8) != recordSize) {
+        ALOGW(
+            "ovrInputRecordReader: '%s' has %u byte records, expected %u",
+            path,
+            Get32(Data + 8),
+            recordSize);
+        Close();
+        return false;
+    }
+    RecordSize = recordSize;
+
+    // index the chunks; anything after the first bad header is a partial write
+    size_t offset = FILE_HEADER_SIZE;
+    while (offset + CHUNK_HEADER_SIZE <= length) {
+        const uint8_t* header = Data + offset;
+        ovrChunk chunk;
+        chunk.Offset = offset + CHUNK_HEADER_SIZE;
+        chunk.FirstRecord = NumRecords;
+        chunk.NumRecords = static_cast<int>(Get32(header + 8));
+        chunk.StoredSize = Get32(header + 16);
+        chunk.Checksum = Get32(header + 20);
+        chunk.Compressed = (Get32(header + 4) & CHUNK_FLAG_COMPRESSED) != 0;
+        chunk.Verified = false;
+        const uint32_t rawSize = Get32(header + 12);
+        // in 64 bits, so a corrupt record count can't wrap around to match the raw size
+        if (Get32(header) != CHUNK_MAGIC || chunk.NumRecords <= 0 ||
+            chunk.NumRecords > INT32_MAX - NumRecords ||
+            rawSize != static_cast<uint64_t>(chunk.NumRecords) * RecordSize ||
+            (!chunk.Compressed && chunk.StoredSize != rawSize) ||
+            chunk.StoredSize > length - chunk.Offset) {
+            break;
+        }
+        Chunks.push_back(chunk);
+        NumRecords += chunk.NumRecords;
+        offset = chunk.Offset + chunk.StoredSize;
+    }
+    if (offset != length) {
+        ALOGW(
+            "ovrInputRecordReader: '%s' ends with %zu unreadable bytes", path, length - offset);
+    }
+    return true;
+}
+
+//==============================
+// ovrInputRecordReader::Close
+void ovrInputRecordReader::Close() {
+    View.Close();
+    File.Close();
+    Data = nullptr;
+    RecordSize = 0;
+    NumRecords = 0;
+    Chunks.clear();
+    CachedChunk = -1;
+}
+
+//==============================
+// ovrInputRecordReader::FindChunk
+int ovrInputRecordReader::FindChunk(const int index) const {
+    int low = 0;
+    int high = static_cast<int>(Chunks.size()) - 1;
+    while (low < high) {
+        const int mid = (low + high + 1) / 2;
+        if (Chunks[mid].FirstRecord <= index) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+//==============================
+// ovrInputRecordReader::GetRecord
+const void* ovrInputRecordReader::GetRecord(const int index) {
+    if (index < 0 || index >= NumRecords) {
+        return nullptr;
+    }
+    const int chunkIndex = FindChunk(index);
+    ovrChunk& chunk = Chunks[chunkIndex];
+    const uint8_t* stored = Data + chunk.Offset;
+    if (!chunk.Verified) {
+        if (adler32(adler32(0, nullptr, 0), stored, chunk.StoredSize) != chunk.Checksum) {
+            ALOGW("ovrInputRecordReader: chunk %i is corrupt", chunkIndex);
+            return nullptr;
+        }
+        chunk.Verified = true;
+    }
+
+    const size_t recordOffset = static_cast<size_t>(index - chunk.FirstRecord) * RecordSize;
+    if (!chunk.Compressed) {
+        return stored + recordOffset;
+    }
+    if (CachedChunk != chunkIndex) {
+        const size_t expectedSize = static_cast<size_t>(chunk.NumRecords) * RecordSize;
+        uLongf rawSize = expectedSize;
+        Inflated.resize(expectedSize);
+        if (uncompress(Inflated.data(), &rawSize, stored, chunk.StoredSize) != Z_OK ||
+            rawSize != expectedSize) {
+            ALOGW("ovrInputRecordReader: chunk %i failed to inflate", chunkIndex);
+            CachedChunk = -1;
+            return nullptr;
+        }
+        CachedChunk = chunkIndex;
+    }
+    return Inflated.data() + recordOffset;
+}
+
+} // namespace OVRFW
@@ -0,0 +1,143 @@
+/************************************************************************************
+
+Filename    :   InputRecording.h
+Content     :   Append-only input recording files and a memory mapped reader for them
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+************************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "OVR_MappedFile.h"
+
+/*
+    A recording is a sequence of fixed size records, typically one per frame, stored in
+    chunks so it can be written as it is captured:
+
+        file header     magic "OIRC", version, record size
+        chunk header    magic "CHNK", flags, record count, raw size, stored size, adler32
+        chunk data      the records, zlib compressed if the chunk's flags say so
+        chunk header
+        ...
+
+    All fields are 32 bit little endian. Chunks are only ever appended, so a recording cut
+    short by a crash loses at most the chunk that was being written; the reader stops at the
+    first incomplete or corrupt chunk. The record size in the file header must match the
+    reader's, which catches recordings made with a different build of the record struct.
+*/
+
+namespace OVRFW {
+
+//==============================================================
+// ovrInputRecordWriter
+// Buffers records into chunks and hands each chunk to a writer thread once it is full, so memory
+// use doesn't grow with the length of the recording and the thread appending records, usually
+// the frame loop, never waits for compression or storage. It only waits if storage falls
+// MAX_PENDING_CHUNKS chunks behind.
+class ovrInputRecordWriter {
+   public:
+    static const int RECORDS_PER_CHUNK = 64;
+    static const int MAX_PENDING_CHUNKS = 16;
+
+    ovrInputRecordWriter();
+    ~ovrInputRecordWriter();
+
+    // Creates or truncates the file at path.
+    bool Open(const char* path, const uint32_t recordSize, const bool compress);
+    // Writes any buffered records, waits for the writer thread and closes the file.
+    void Close();
+
+    bool IsOpen() const {
+        return Thread.joinable();
+    }
+    int GetNumRecords() const {
+        return NumRecords;
+    }
+
+    // Returns false and closes the file if a write failed.
+    bool Append(const void* record);
+    // Hands the records buffered so far to the writer thread as a chunk, without waiting for it
+    // to be written. Returns false and closes the file if a write failed.
+    bool Flush();
+
+   private:
+    FILE* File; // the writer thread's once it has started
+    uint32_t RecordSize;
+    bool Compress;
+    int NumRecords;
+    int NumChunkRecords;
+    std::vector<uint8_t> Chunk;
+
+    std::thread Thread;
+    std::mutex Mutex;
+    std::condition_variable Condition;
+    // full chunks waiting to be written, and written ones kept for reuse
+    std::deque<std::vector<uint8_t>> Pending;
+    std::vector<std::vector<uint8_t>> Spare;
+    bool Stopping;
+    bool Failed;
+
+    // Queues the buffered records for the writer thread. Returns false if a write has failed.
+    bool Submit();
+    void WriterThread();
+    bool WriteChunk(const std::vector<uint8_t>& chunk, std::vector<uint8_t>& compressed);
+};
+
+//==============================================================
+// ovrInputRecordReader
+// Maps a recording into memory and returns its records by index. Uncompressed chunks are read
+// in place; a compressed chunk is inflated when one of its records is first asked for, and
+// stays cached until a record from another chunk is.
+class ovrInputRecordReader {
+   public:
+    ovrInputRecordReader();
+    ~ovrInputRecordReader();
+
+    bool Open(const char* path, const uint32_t recordSize);
+    void Close();
+
+    bool IsOpen() const {
+        return Data != nullptr;
+    }
+    int GetNumRecords() const {
+        return NumRecords;
+    }
+
+    // Returns null if index is out of range or its chunk is corrupt. The pointer is valid until
+    // the next call and is not necessarily aligned for the record type, so copy from it.
+    const void* GetRecord(const int index);
+
+   private:
+    struct ovrChunk {
+        size_t Offset; // of the stored data
+        int FirstRecord;
+        int NumRecords;
+        uint32_t StoredSize;
+        uint32_t Checksum;
+        bool Compressed;
+        bool Verified;
+    };
+
+    MappedFile File;
+    MappedView View;
+    const uint8_t* Data;
+    uint32_t RecordSize;
+    int NumRecords;
+    std::vector<ovrChunk> Chunks;
+    int CachedChunk;
+    std::vector<uint8_t> Inflated;
+
+    int FindChunk(const int index) const;
+};
+
+} // namespace OVRFW
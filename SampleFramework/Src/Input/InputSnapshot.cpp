@@ -0,0 +1,213 @@
+/************************************************************************************
+
+Filename    :   InputSnapshot.cpp
+Content     :   The state of all VrApi input devices, captured once per frame
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+************************************************************************************/
+#include "InputSnapshot.h"
+
+#include <string.h>
+
+#include "Misc/Log.h"
+
+namespace OVRFW {
+
+bool ovrInputDeviceSnapshot::IsLeftHand() const {
+    switch (Header.Type) {
+        case ovrControllerType_TrackedRemote:
+            return (RemoteCaps.ControllerCapabilities & ovrControllerCaps_LeftHand) != 0;
+        case ovrControllerType_StandardPointer:
+            return (PointerCaps.ControllerCapabilities & ovrControllerCaps_LeftHand) != 0;
+        case ovrControllerType_Hand:
+            return (HandCaps.HandCapabilities & ovrHandCaps_LeftHand) != 0;
+        default:
+            return false;
+    }
+}
+
+ovrInputSnapshot::ovrInputSnapshot() {
+    Reset();
+}
+
+//==============================
+// ovrInputSnapshot::Reset
+void ovrInputSnapshot::Reset() {
+    DisplayTime = 0.0;
+    DominantHand = VRAPI_HAND_RIGHT;
+    ActiveInputDeviceID = ovrDeviceIdType_Invalid;
+    DeviceChangeCount = 0;
+    NumDevices = 0;
+}
+
+//==============================
+// ovrInputSnapshot::FindDevice
+const ovrInputDeviceSnapshot* ovrInputSnapshot::FindDevice(const ovrDeviceID deviceID) const {
+    for (int i = 0; i < NumDevices; ++i) {
+        if (Devices[i].Header.DeviceID == deviceID) {
+            return &Devices[i];
+        }
+    }
+    return nullptr;
+}
+
+//==============================
+// ovrInputSnapshot::FindRemote
+const ovrInputDeviceSnapshot* ovrInputSnapshot::FindRemote(const bool leftHand) const {
+    for (int i = 0; i < NumDevices; ++i) {
+        const ovrInputDeviceSnapshot& device = Devices[i];
+        if (device.Header.Type == ovrControllerType_TrackedRemote &&
+            device.IsLeftHand() == leftHand) {
+            return &device;
+        }
+    }
+    return nullptr;
+}
+
+//==============================
+// ovrInputSnapshot::QueryCaps
+bool ovrInputSnapshot::QueryCaps(ovrMobile* ovr, ovrInputDeviceSnapshot& device) {
+    ovrInputCapabilityHeader* caps = nullptr;
+    switch (device.Header.Type) {
+        case ovrControllerType_TrackedRemote:
+            device.RemoteCaps.Header = device.Header;
+            caps = &device.RemoteCaps.Header;
+            break;
+        case ovrControllerType_StandardPointer:
+            device.PointerCaps.Header = device.Header;
+            caps = &device.PointerCaps.Header;
+            break;
+        case ovrControllerType_Hand:
+            device.HandCaps.Header = device.Header;
+            caps = &device.HandCaps.Header;
+            break;
+        default:
+            return false;
+    }
+    const ovrResult result = vrapi_GetInputDeviceCapabilities(ovr, caps);
+    if (result != ovrSuccess) {
+        ALOGW("vrapi_GetInputDeviceCapabilities: Error %i for device %u", result, caps->DeviceID);
+        return false;
+    }
+    return true;
+}
+
+//==============================
+// ovrInputSnapshot::Capture
+void ovrInputSnapshot::Capture(ovrMobile* ovr, const ovrJava* java, const double displayTime) {
+    DisplayTime = displayTime;
+    DominantHand = vrapi_GetSystemPropertyInt(java, VRAPI_SYS_PROP_DOMINANT_HAND);
+    int activeInputDeviceID = ovrDeviceIdType_Invalid;
+    vrapi_GetPropertyInt(java, VRAPI_ACTIVE_INPUT_DEVICE_ID, &activeInputDeviceID);
+    ActiveInputDeviceID = static_cast<ovrDeviceID>(activeInputDeviceID);
+
+    // enumerate first; devices already in the snapshot keep their capabilities
+    ovrInputCapabilityHeader headers[MAX_DEVICES];
+    int numHeaders = 0;
+    for (uint32_t deviceIndex = 0; numHeaders < MAX_DEVICES; deviceIndex++) {
+        ovrInputCapabilityHeader& header = headers[numHeaders];
+        if (vrapi_EnumerateInputDevices(ovr, deviceIndex, &header) < 0) {
+            break; // no more devices
+        }
+        if (header.DeviceID == ovrDeviceIdType_Invalid) {
+            continue;
+        }
+        numHeaders++;
+    }
+
+    // drop the devices that disconnected, keeping the order of the rest
+    int numKept = 0;
+    for (int i = 0; i < NumDevices; ++i) {
+        bool found = false;
+        for (int j = 0; j < numHeaders && !found; ++j) {
+            found = headers[j].DeviceID == Devices[i].Header.DeviceID &&
+                headers[j].Type == Devices[i].Header.Type;
+        }
+        if (!found) {
+            DeviceChangeCount++;
+            continue;
+        }
+        if (numKept != i) {
+            Devices[numKept] = Devices[i];
+        }
+        numKept++;
+    }
+    NumDevices = numKept;
+
+    // add the devices that connected
+    for (int i = 0; i < numHeaders; ++i) {
+        if (FindDevice(headers[i].DeviceID) != nullptr) {
+            continue;
+        }
+        ovrInputDeviceSnapshot& device = Devices[NumDevices++];
+        device = {};
+        device.Header = headers[i];
+        DeviceChangeCount++;
+    }
+
+    // the per-frame state
+    for (int i = 0; i < NumDevices; ++i) {
+        ovrInputDeviceSnapshot& device = Devices[i];
+        device.StateValid = false;
+        device.TrackingValid = false;
+        if (!device.CapsValid) {
+            // a device that failed to report its capabilities is retried until it does
+            device.CapsValid = QueryCaps(ovr, device);
+        }
+        if (device.Header.Type != ovrControllerType_TrackedRemote || !device.CapsValid) {
+            continue;
+        }
+        device.RemoteState.Header.ControllerType = ovrControllerType_TrackedRemote;
+        device.StateValid = vrapi_GetCurrentInputState(
+                                ovr, device.Header.DeviceID, &device.RemoteState.Header) ==
+            ovrSuccess;
+        device.TrackingValid = vrapi_GetInputTrackingState(
+                                   ovr, device.Header.DeviceID, displayTime, &device.Tracking) ==
+            ovrSuccess;
+    }
+}
+
+//==============================
+// ovrInputSnapshot::Save
+void ovrInputSnapshot::Save(ovrInputFrameRecord& record) const {
+    memset(&record, 0, sizeof(record));
+    record.DisplayTime = DisplayTime;
+    record.DominantHand = DominantHand;
+    record.ActiveInputDeviceID = ActiveInputDeviceID;
+    record.NumDevices = NumDevices;
+    for (int i = 0; i < NumDevices; ++i) {
+        record.Devices[i] = Devices[i];
+    }
+}
+
+//==============================
+// ovrInputSnapshot::Restore
+void ovrInputSnapshot::Restore(const ovrInputFrameRecord& record, const double displayTime) {
+    const int numDevices = record.NumDevices < 0
+        ? 0
+        : (record.NumDevices > MAX_DEVICES ? MAX_DEVICES : record.NumDevices);
+    // count connects and disconnects as Capture() would
+    for (int i = 0; i < NumDevices; ++i) {
+        bool found = false;
+        for (int j = 0; j < numDevices && !found; ++j) {
+            found = record.Devices[j].Header.DeviceID == Devices[i].Header.DeviceID;
+        }
+        DeviceChangeCount += found ? 0 : 1;
+    }
+    for (int j = 0; j < numDevices; ++j) {
+        DeviceChangeCount += FindDevice(record.Devices[j].Header.DeviceID) == nullptr ? 1 : 0;
+    }
+
+    DisplayTime = displayTime;
+    DominantHand = record.DominantHand;
+    ActiveInputDeviceID = static_cast<ovrDeviceID>(record.ActiveInputDeviceID);
+    NumDevices = numDevices;
+    for (int i = 0; i < NumDevices; ++i) {
+        Devices[i] = record.Devices[i];
+    }
+}
+
+} // namespace OVRFW
@@ -0,0 +1,119 @@
+/************************************************************************************
+
+Filename    :   InputSnapshot.h
+Content     :   The state of all VrApi input devices, captured once per frame
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+************************************************************************************/
+#pragma once
+
+#include "VrApi.h"
+#include "VrApi_Input.h"
+
+#include <cstdint>
+
+namespace OVRFW {
+
+struct ovrInputDeviceSnapshot {
+    // Type and DeviceID, as returned by vrapi_EnumerateInputDevices()
+    ovrInputCapabilityHeader Header;
+    // only the member matching Header.Type is valid, and only if CapsValid is set
+    ovrInputTrackedRemoteCapabilities RemoteCaps;
+    ovrInputStandardPointerCapabilities PointerCaps;
+    ovrInputHandCapabilities HandCaps;
+    bool CapsValid;
+    // tracked remotes only
+    ovrInputStateTrackedRemote RemoteState;
+    bool StateValid;
+    ovrTracking Tracking; // predicted to the frame's display time
+    bool TrackingValid;
+
+    bool IsLeftHand() const;
+};
+
+struct ovrInputFrameRecord;
+
+//==============================================================
+// ovrInputSnapshot
+// Everything the frame needs to know about the input devices, read from VrApi once at the start
+// of the frame so that every consumer sees the same state and the same devices.
+//
+// Device capabilities never change while a device is connected, so they are only queried when
+// a device ID first shows up in the enumeration, and forgotten when it disappears. Enumerating
+// is still needed every frame because VrApi has no connect or disconnect events.
+//
+// Capture() only talks to VrApi through its C entry points, so it can be run against a fake
+// VrApi linked in place of the real one.
+class ovrInputSnapshot {
+   public:
+    static const int MAX_DEVICES = 8;
+
+    ovrInputSnapshot();
+
+    // Forgets all devices, so the next Capture() queries every device's capabilities again.
+    void Reset();
+
+    // Replaces the snapshot with the current state, with tracking predicted to displayTime.
+    void Capture(ovrMobile* ovr, const ovrJava* java, const double displayTime);
+
+    // Copies the snapshot into a record for an input recording. The rest of the record is
+    // zeroed, so records compress well; fill in the head tracking afterwards.
+    void Save(ovrInputFrameRecord& record) const;
+    // Replaces the snapshot with a recorded one, as if it had been captured at displayTime.
+    void Restore(const ovrInputFrameRecord& record, const double displayTime);
+
+    int GetNumDevices() const {
+        return NumDevices;
+    }
+    const ovrInputDeviceSnapshot& GetDevice(const int index) const {
+        return Devices[index];
+    }
+    // Returns null if the device isn't connected.
+    const ovrInputDeviceSnapshot* FindDevice(const ovrDeviceID deviceID) const;
+    // Returns the tracked remote held in the left or right hand, or null if there isn't one.
+    const ovrInputDeviceSnapshot* FindRemote(const bool leftHand) const;
+
+    double GetDisplayTime() const {
+        return DisplayTime;
+    }
+    // VRAPI_HAND_LEFT or VRAPI_HAND_RIGHT
+    int GetDominantHand() const {
+        return DominantHand;
+    }
+    ovrDeviceID GetActiveInputDeviceID() const {
+        return ActiveInputDeviceID;
+    }
+    // Incremented whenever a device connects or disconnects.
+    uint32_t GetDeviceChangeCount() const {
+        return DeviceChangeCount;
+    }
+
+   private:
+    double DisplayTime;
+    int DominantHand;
+    ovrDeviceID ActiveInputDeviceID;
+    uint32_t DeviceChangeCount;
+    int NumDevices;
+    ovrInputDeviceSnapshot Devices[MAX_DEVICES];
+
+    static bool QueryCaps(ovrMobile* ovr, ovrInputDeviceSnapshot& device);
+};
+
+//==============================================================
+// ovrInputFrameRecord
+// One frame of an input recording: the input snapshot and the head tracking it was captured
+// with. Recordings store it as is, so they only replay on builds with the same layout; see
+// Input/InputRecording.h.
+struct ovrInputFrameRecord {
+    double DisplayTime;
+    ovrTracking2 HeadTracking;
+    int32_t DominantHand;
+    uint32_t ActiveInputDeviceID;
+    int32_t NumDevices;
+    ovrInputDeviceSnapshot Devices[ovrInputSnapshot::MAX_DEVICES];
+};
+
+} // namespace OVRFW
@@ -9,6 +9,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 ************************************************************************************/
 #include "SimpleInput.h"
 
+#include <string.h>
+
 namespace OVRFW {
 
 void SimpleInput::Reset() {
@@ -24,18 +26,51 @@ void SimpleInput::Update(ovrMobile* ovr, double displayTimeInSeconds) {
     } else {
         UpdateFromSensors(ovr, displayTimeInSeconds);
         if (isRecording_) {
-            recordedFrames_.push_back(frame_);
+            if (recordWriter_.IsOpen()) {
+                recordWriter_.Append(&frame_);
+            } else {
+                recordedFrames_.push_back(frame_);
+            }
         }
     }
 }
 
+bool SimpleInput::RecordToFile(const char* path, bool compress) {
+    Record();
+    if (!recordWriter_.Open(path, sizeof(Frame), compress)) {
+        isRecording_ = false;
+        return false;
+    }
+    return true;
+}
+
+bool SimpleInput::PlayFromFile(const char* path) {
+    Stop();
+    recordedFrames_.clear();
+    if (!recordReader_.Open(path, sizeof(Frame)) || recordReader_.GetNumRecords() == 0) {
+        recordReader_.Close();
+        return false;
+    }
+    Play();
+    return true;
+}
+
 void SimpleInput::UpdateFromRecording(ovrMobile* ovr, double displayTimeInSeconds) {
-    if (recordedFrames_.size() > 0) {
-        frame_ = recordedFrames_[currentFrame_];
+    if (FrameCount() > 0) {
+        if (recordReader_.IsOpen()) {
+            // the mapping isn't necessarily aligned for Frame
+            const void* record = recordReader_.GetRecord(currentFrame_);
+            if (record != nullptr) {
+                memcpy(&frame_, record, sizeof(frame_));
+            }
+        } else {
+            frame_ = recordedFrames_[currentFrame_];
+        }
+        recordedTimeStamp_ = frame_.timeStamp_;
         frame_.timeStamp_ = displayTimeInSeconds;
         if (!isPaused_) {
             currentFrame_++;
-            int maxFrames = static_cast<int>(recordedFrames_.size() - 1);
+            int maxFrames = static_cast<int>(FrameCount() - 1);
             if (currentFrame_ > maxFrames) {
                 currentFrame_ = maxFrames;
                 Pause();
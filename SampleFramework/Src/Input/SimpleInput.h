@@ -13,6 +13,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "VrApi_Input.h"
 #include "OVR_Math.h"
 
+#include "Input/InputRecording.h"
+
 #include <vector>
 
 namespace OVRFW {
@@ -48,7 +50,8 @@ class SimpleInput {
           isPaused_(false),
           currentFrame_(-1),
           recordStartTime_(0.0),
-          playStartTime_(0.0) {
+          playStartTime_(0.0),
+          recordedTimeStamp_(0.0) {
         Reset();
     }
     ~SimpleInput() = default;
@@ -162,16 +165,22 @@ class SimpleInput {
         return isPaused_;
     }
     bool IsAtEnd() const {
-        return currentFrame_ == static_cast<int>(recordedFrames_.size() - 1);
+        return currentFrame_ == static_cast<int>(FrameCount() - 1);
     }
     int CurrentFrame() const {
         return currentFrame_;
     }
     size_t FrameCount() const {
-        return recordedFrames_.size();
+        return recordReader_.IsOpen() ? recordReader_.GetNumRecords() : recordedFrames_.size();
+    }
+    /// time stamp the current frame was recorded with, while playing
+    double RecordedTimeStamp() const {
+        return recordedTimeStamp_;
     }
     void Record() {
         isPlaying_ = false;
+        recordWriter_.Close();
+        recordReader_.Close();
         recordedFrames_.clear();
         currentFrame_ = 0;
         isRecording_ = true;
@@ -189,13 +198,14 @@ class SimpleInput {
         currentFrame_ = 0;
         isRecording_ = false;
         isPlaying_ = false;
+        recordWriter_.Close();
     }
     void Pause() {
         isPaused_ = true;
     }
     void Step(int delta) {
         currentFrame_ += delta;
-        int maxFrames = static_cast<int>(recordedFrames_.size() - 1);
+        int maxFrames = static_cast<int>(FrameCount() - 1);
         currentFrame_ = (currentFrame_ < maxFrames) ? currentFrame_ : maxFrames;
         currentFrame_ = (currentFrame_ >= 0) ? currentFrame_ : 0;
     }
@@ -203,9 +213,19 @@ class SimpleInput {
         return recordedFrames_;
     }
     void SetRecording(const std::vector<Frame>& recording) {
+        recordReader_.Close();
         recordedFrames_ = recording;
     }
 
+    /// Streaming to and from disk; see InputRecording.h for the format.
+    /// Like Record(), but appends the frames to a file as they are captured instead of keeping
+    /// them in memory, so sessions of any length can be recorded.
+    bool RecordToFile(const char* path, bool compress = true);
+    /// Memory maps a recording made by RecordToFile() and starts playing it. Frames are
+    /// returned one per Update() regardless of the display time, so a replay feeds the same
+    /// frames in the same order every time.
+    bool PlayFromFile(const char* path);
+
    protected:
     void UpdateFromSensors(ovrMobile* ovr, double displayTimeInSeconds);
     void UpdateFromRecording(ovrMobile* ovr, double displayTimeInSeconds);
@@ -227,7 +247,10 @@ class SimpleInput {
     int currentFrame_;
     double recordStartTime_;
     double playStartTime_;
+    double recordedTimeStamp_;
     std::vector<Frame> recordedFrames_;
+    ovrInputRecordWriter recordWriter_;
+    ovrInputRecordReader recordReader_;
 };
 
 } // namespace OVRFW
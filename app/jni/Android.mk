@@ -4,7 +4,8 @@ include $(CLEAR_VARS)
 include $(LOCAL_PATH)/../../cflags.mk
 
 LOCAL_MODULE    := GStreamerModule
-LOCAL_SRC_FILES := gstreamer_bindings.c ControllerGUI.cpp VrInput.cpp main.cpp
+LOCAL_SRC_FILES := gstreamer_bindings.c ControllerGUI.cpp TeleopPredictor.cpp TeleopSender.cpp \
+                   TelemetryReceiver.cpp VrInput.cpp main.cpp
 LOCAL_STATIC_LIBRARIES := sampleframework
 LOCAL_SHARED_LIBRARIES := gstreamer_android vrapi
 LOCAL_LDLIBS := -lEGL -lGLESv3 -landroid -llog -lz
@@ -12,7 +12,18 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "VrInput.h"
 #include "ControllerGUI.h"
 
+#include "GUI/VRMenuMgr.h"
+
 #include <android/keycodes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+using OVR::Posef;
+using OVR::Quatf;
+using OVR::Vector3f;
+using OVR::Vector4f;
 
 namespace OVRFW {
 
@@ -33,9 +44,183 @@ ovrControllerGUI* ovrControllerGUI::Create(ovrVrInput& vrControllerApp) {
         delete menu;
         return nullptr;
     }
+    menu->AddTelemetryLabels(vrControllerApp.GetGuiSys());
     return menu;
 }
 
+//==============================
+// ovrControllerGUI::AddTelemetryLabels
+// The labels are built in code so they don't depend on the panel's reflection data.
+void ovrControllerGUI::AddTelemetryLabels(OvrGuiSys& guiSys) {
+    static const char* names[TELEMETRY_LABEL_MAX] = {
+        "telemetry_battery", "telemetry_servos", "telemetry_motors", "telemetry_network"};
+    static const Vector3f positions[TELEMETRY_LABEL_MAX] = {
+        Vector3f(-0.9f, -0.75f, 0.0f),
+        Vector3f(-0.9f, -0.9f, 0.0f),
+        Vector3f(0.1f, -0.9f, 0.0f),
+        Vector3f(0.1f, -0.75f, 0.0f)};
+
+    const VRMenuFontParms fontParms(false, false, false, false, true, 0.5f, 0.5f, 0.4f);
+    std::vector<VRMenuComponent*> comps;
+    VRMenuObjectParms* parms[TELEMETRY_LABEL_MAX];
+    std::vector<VRMenuObjectParms const*> itemParms;
+    for (int i = 0; i < TELEMETRY_LABEL_MAX; ++i) {
+        parms[i] = new VRMenuObjectParms(
+            VRMENU_STATIC,
+            comps,
+            VRMenuSurfaceParms(names[i]),
+            "",
+            Posef(Quatf(), positions[i]),
+            Vector3f(1.0f),
+            fontParms,
+            VRMenuId_t(TELEMETRY_LABEL_ID_BASE + i),
+            VRMenuObjectFlags_t(VRMENUOBJECT_DONT_HIT_ALL),
+            VRMenuObjectInitFlags_t(VRMENUOBJECT_INIT_FORCE_POSITION));
+        parms[i]->Name = names[i];
+        itemParms.push_back(parms[i]);
+    }
+    AddItems(guiSys, itemParms, GetRootHandle(), false);
+    for (int i = 0; i < TELEMETRY_LABEL_MAX; ++i) {
+        delete parms[i];
+    }
+
+    TelemetryTotals = ovrTelemetryReceiverStats();
+    LastTelemetryUpdateMicros = 0;
+}
+
+//==============================
+// ovrControllerGUI::SetTelemetryLabel
+void ovrControllerGUI::SetTelemetryLabel(
+    OvrGuiSys& guiSys,
+    const ovrTelemetryLabel label,
+    const char* text,
+    const Vector4f& color) {
+    const menuHandle_t handle =
+        HandleForId(guiSys.GetVRMenuMgr(), VRMenuId_t(TELEMETRY_LABEL_ID_BASE + label));
+    VRMenuObject* object = guiSys.GetVRMenuMgr().ToObject(handle);
+    if (object == nullptr) {
+        return;
+    }
+    // setting the text rebuilds its surface, so only do it when it changed
+    if (strcmp(object->GetText().c_str(), text) != 0) {
+        object->SetText(text);
+    }
+    object->SetTextColor(color);
+}
+
+// snprintf() that appends at offset and never overflows, so a label can be built in pieces
+static int AppendText(char* buffer, const int size, const int offset, const char* fmt, ...) {
+    if (offset >= size) {
+        return offset;
+    }
+    va_list args;
+    va_start(args, fmt);
+    const int written = vsnprintf(buffer + offset, size - offset, fmt, args);
+    va_end(args);
+    return written < 0 ? offset : offset + written;
+}
+
+//==============================
+// ovrControllerGUI::UpdateTelemetry
+void ovrControllerGUI::UpdateTelemetry(
+    OvrGuiSys& guiSys,
+    const ovrTelemetrySample* sample,
+    ovrTelemetryReceiver& receiver,
+    const uint64_t nowMicros) {
+    if (nowMicros - LastTelemetryUpdateMicros < TELEMETRY_UPDATE_SECONDS * 1e6) {
+        return;
+    }
+    LastTelemetryUpdateMicros = nowMicros;
+
+    const ovrTelemetryReceiverStats stats = receiver.GetStats();
+    TelemetryTotals.PacketsReceived += stats.PacketsReceived;
+    TelemetryTotals.PacketsMalformed += stats.PacketsMalformed;
+    TelemetryTotals.PacketsDropped += stats.PacketsDropped;
+    TelemetryTotals.PacketsOutOfOrder += stats.PacketsOutOfOrder;
+    TelemetryTotals.SequenceRestarts += stats.SequenceRestarts;
+
+    const Vector4f normalColor(1.0f);
+    const Vector4f warningColor(1.0f, 0.75f, 0.25f, 1.0f);
+    const Vector4f errorColor(1.0f, 0.25f, 0.25f, 1.0f);
+
+    char text[256];
+    if (sample == nullptr) {
+        SetTelemetryLabel(guiSys, TELEMETRY_LABEL_BATTERY, "No telemetry", errorColor);
+        SetTelemetryLabel(guiSys, TELEMETRY_LABEL_SERVOS, "", normalColor);
+        SetTelemetryLabel(guiSys, TELEMETRY_LABEL_MOTORS, "", normalColor);
+        snprintf(text, sizeof(text), "Malformed %u", TelemetryTotals.PacketsMalformed);
+        SetTelemetryLabel(guiSys, TELEMETRY_LABEL_NETWORK, text, normalColor);
+        return;
+    }
+
+    const ovrTeleopTelemetry& telemetry = sample->Telemetry;
+    const double ageSeconds = (nowMicros - sample->ReceiveTimeMicros) * 1e-6;
+    const bool stale = ageSeconds > TELEMETRY_STALE_SECONDS;
+
+    snprintf(
+        text,
+        sizeof(text),
+        "Battery %.1f V %u%%",
+        telemetry.BatteryVolts,
+        static_cast<unsigned>(telemetry.BatteryPercent));
+    SetTelemetryLabel(
+        guiSys,
+        TELEMETRY_LABEL_BATTERY,
+        text,
+        stale ? errorColor : (telemetry.BatteryPercent < 20 ? warningColor : normalColor));
+
+    int length = AppendText(text, sizeof(text), 0, "Servos (deg, A)");
+    for (int i = 0; i < telemetry.NumServos; ++i) {
+        length = AppendText(
+            text,
+            sizeof(text),
+            length,
+            "\n%i: %6.1f %5.2f",
+            i + 1,
+            telemetry.ServoPositionDegrees[i],
+            telemetry.ServoCurrentAmps[i]);
+    }
+    SetTelemetryLabel(
+        guiSys, TELEMETRY_LABEL_SERVOS, text, stale ? errorColor : normalColor);
+
+    length = AppendText(text, sizeof(text), 0, "Motors (C)");
+    float hottest = 0.0f;
+    for (int i = 0; i < telemetry.NumMotors; ++i) {
+        length = AppendText(
+            text, sizeof(text), length, "\n%i: %5.1f", i + 1, telemetry.MotorTemperatureCelsius[i]);
+        hottest = std::max(hottest, telemetry.MotorTemperatureCelsius[i]);
+    }
+    SetTelemetryLabel(
+        guiSys,
+        TELEMETRY_LABEL_MOTORS,
+        text,
+        stale ? errorColor : (hottest > 70.0f ? warningColor : normalColor));
+
+    const uint32_t teleopSent = telemetry.TeleopPacketsReceived + telemetry.TeleopPacketsLost;
+    const float lossPercent =
+        teleopSent > 0 ? 100.0f * telemetry.TeleopPacketsLost / teleopSent : 0.0f;
+    if (stale) {
+        length = AppendText(text, sizeof(text), 0, "Stale %.1f s", ageSeconds);
+    } else if (sample->RoundTripSeconds >= 0.0) {
+        length = AppendText(text, sizeof(text), 0, "RTT %.1f ms", sample->RoundTripSeconds * 1e3);
+    } else {
+        length = AppendText(text, sizeof(text), 0, "RTT -");
+    }
+    AppendText(
+        text,
+        sizeof(text),
+        length,
+        "\nRSSI %i dBm\nLoss %.1f%%\nDropped %u",
+        static_cast<int>(telemetry.WifiRssi),
+        lossPercent,
+        TelemetryTotals.PacketsDropped);
+    SetTelemetryLabel(
+        guiSys,
+        TELEMETRY_LABEL_NETWORK,
+        text,
+        stale ? errorColor : (lossPercent > 5.0f ? warningColor : normalColor));
+}
+
 void ovrControllerGUI::OnItemEvent_Impl(
     OvrGuiSys& guiSys,
     ovrApplFrameIn const& vrFrame,
@@ -14,6 +14,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "GUI/VRMenu.h"
 #include "Appl.h"
 
+#include "TelemetryReceiver.h"
+
 namespace OVRFW {
 
 class ovrVrInput;
@@ -26,15 +28,48 @@ class ovrControllerGUI : public VRMenu {
 
     static ovrControllerGUI* Create(ovrVrInput& vrControllerApp);
 
+    // Shows the robot's telemetry below the controller panel. sample is the newest sample
+    // received, or null if there hasn't been one. Called every frame, but the labels are only
+    // rewritten a few times a second and only when their text changes.
+    void UpdateTelemetry(
+        OvrGuiSys& guiSys,
+        const ovrTelemetrySample* sample,
+        ovrTelemetryReceiver& receiver,
+        const uint64_t nowMicros);
+
    private:
+    enum ovrTelemetryLabel {
+        TELEMETRY_LABEL_BATTERY,
+        TELEMETRY_LABEL_SERVOS,
+        TELEMETRY_LABEL_MOTORS,
+        TELEMETRY_LABEL_NETWORK,
+        TELEMETRY_LABEL_MAX
+    };
+
+    static const int TELEMETRY_LABEL_ID_BASE = 1000;
+    static constexpr double TELEMETRY_UPDATE_SECONDS = 0.1;
+    // telemetry older than this is shown as stale
+    static constexpr double TELEMETRY_STALE_SECONDS = 1.0;
+
     ovrVrInput& VrInputApp;
 
+    uint64_t LastTelemetryUpdateMicros;
+    // receiver counts accumulated since the menu was created
+    ovrTelemetryReceiverStats TelemetryTotals;
+
    private:
     ovrControllerGUI(ovrVrInput& vrControllerApp)
-        : VRMenu(MENU_NAME), VrInputApp(vrControllerApp) {}
+        : VRMenu(MENU_NAME), VrInputApp(vrControllerApp), LastTelemetryUpdateMicros(0) {}
 
     ovrControllerGUI operator=(ovrControllerGUI&) = delete;
 
+    void AddTelemetryLabels(OvrGuiSys& guiSys);
+    void SetTelemetryLabel(
+        OvrGuiSys& guiSys,
+        const ovrTelemetryLabel label,
+        const char* text,
+        const OVR::Vector4f& color);
+
     virtual void OnItemEvent_Impl(
         OvrGuiSys& guiSys,
         ovrApplFrameIn const& vrFrame,
@@ -0,0 +1,193 @@
+/************************************************************************************
+
+Filename    :   TelemetryReceiver.cpp
+Content     :   Receives the robot's telemetry datagrams on a thread of its own and hands them
+                to the render thread through a lock-free queue.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "TelemetryReceiver.h"
+#include "TeleopSender.h"
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Misc/Log.h"
+
+namespace OVRFW {
+
+ovrTelemetryReceiver::ovrTelemetryReceiver()
+    : Port(0),
+      Sender(nullptr),
+      Running(false),
+      PacketsReceived(0),
+      PacketsMalformed(0),
+      PacketsDropped(0),
+      PacketsOutOfOrder(0),
+      SequenceRestarts(0) {}
+
+ovrTelemetryReceiver::~ovrTelemetryReceiver() {
+    Stop();
+}
+
+//==============================
+// ovrTelemetryReceiver::Start
+bool ovrTelemetryReceiver::Start(const int port, ovrTeleopSender* sender) {
+    Stop();
+    if (port <= 0 || port > 65535) {
+        ALOGW("ovrTelemetryReceiver: invalid port %i", port);
+        return false;
+    }
+    Port = port;
+    Sender = sender;
+    Running.store(true);
+    Thread = std::thread(&ovrTelemetryReceiver::ReceiverThread, this);
+    return true;
+}
+
+//==============================
+// ovrTelemetryReceiver::Stop
+void ovrTelemetryReceiver::Stop() {
+    Running.store(false);
+    if (Thread.joinable()) {
+        Thread.join();
+    }
+}
+
+//==============================
+// ovrTelemetryReceiver::GetLatest
+bool ovrTelemetryReceiver::GetLatest(ovrTelemetrySample& sample) {
+    bool received = false;
+    while (Queue.Pop(sample)) {
+        received = true;
+    }
+    return received;
+}
+
+//==============================
+// ovrTelemetryReceiver::GetStats
+ovrTelemetryReceiverStats ovrTelemetryReceiver::GetStats() {
+    ovrTelemetryReceiverStats stats;
+    stats.PacketsReceived = PacketsReceived.exchange(0);
+    stats.PacketsMalformed = PacketsMalformed.exchange(0);
+    stats.PacketsDropped = PacketsDropped.exchange(0);
+    stats.PacketsOutOfOrder = PacketsOutOfOrder.exchange(0);
+    stats.SequenceRestarts = SequenceRestarts.exchange(0);
+    return stats;
+}
+
+//==============================
+// ovrTelemetryReceiver::OpenSocket
+int ovrTelemetryReceiver::OpenSocket() const {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        ALOGW("ovrTelemetryReceiver: socket() failed: %s", strerror(errno));
+        return -1;
+    }
+    const int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(Port));
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+        ALOGW("ovrTelemetryReceiver: bind() to port %i failed: %s", Port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+//==============================
+// ovrTelemetryReceiver::ReceiverThread
+void ovrTelemetryReceiver::ReceiverThread() {
+    pthread_setname_np(pthread_self(), "OVR::Telemetry");
+
+    const int fd = OpenSocket();
+    if (fd < 0) {
+        Running.store(false);
+        return;
+    }
+    ALOG("ovrTelemetryReceiver: listening on port %i", Port);
+
+    // one byte more than the largest valid packet, so oversized datagrams fail to decode
+    uint8_t packet[TELEMETRY_WIRE_MAX_PACKET_SIZE + 1];
+    ovrTelemetrySample sample;
+    bool haveSequence = false;
+    uint32_t lastSequence = 0;
+    uint64_t lastAcceptedMicros = 0;
+
+    while (Running.load(std::memory_order_relaxed)) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, POLL_TIMEOUT_MS) <= 0) {
+            continue;
+        }
+        const ssize_t size = recv(fd, packet, sizeof(packet), 0);
+        if (size <= 0) {
+            continue;
+        }
+        sample.ReceiveTimeMicros = ovrTeleopSender::GetTimeMicros();
+
+        if (!TelemetryDecode(packet, static_cast<int>(size), sample.Telemetry)) {
+            PacketsMalformed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        PacketsReceived.fetch_add(1, std::memory_order_relaxed);
+
+        // A reordered datagram would move the displayed values backwards. Only a short way
+        // back counts as reordered, otherwise a restarted robot would be ignored until its
+        // sequence caught up with the old one.
+        const uint32_t sequence = sample.Telemetry.Sequence;
+        const bool silent =
+            sample.ReceiveTimeMicros - lastAcceptedMicros >= RESTART_SILENCE_MICROS;
+        if (haveSequence && !silent && lastSequence - sequence < REORDER_WINDOW) {
+            PacketsOutOfOrder.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (haveSequence && static_cast<int32_t>(sequence - lastSequence) <= 0) {
+            ALOG("ovrTelemetryReceiver: sequence went back from %u to %u", lastSequence, sequence);
+            SequenceRestarts.fetch_add(1, std::memory_order_relaxed);
+        }
+        haveSequence = true;
+        lastSequence = sequence;
+        lastAcceptedMicros = sample.ReceiveTimeMicros;
+
+        sample.RoundTripSeconds = -1.0;
+        if (sample.Telemetry.AckedSequence != 0) {
+            // the send time is the low 32 bits of the same clock, so wrapping arithmetic works
+            const uint32_t elapsed =
+                static_cast<uint32_t>(sample.ReceiveTimeMicros) -
+                sample.Telemetry.AckedSendTimeMicros - sample.Telemetry.AckHoldMicros;
+            // ignore anything that can't be a real round trip, like a robot echoing a
+            // previous session's packet
+            if (elapsed < 1000000) {
+                sample.RoundTripSeconds = elapsed * 1e-6;
+            }
+            if (Sender != nullptr) {
+                Sender->Acknowledge(sample.Telemetry.AckedSequence);
+                if (sample.RoundTripSeconds >= 0.0) {
+                    Sender->SetRoundTripTime(sample.RoundTripSeconds);
+                }
+            }
+        }
+
+        if (!Queue.Push(sample)) {
+            PacketsDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    close(fd);
+    ALOG("ovrTelemetryReceiver: stopped");
+}
+
+} // namespace OVRFW
@@ -0,0 +1,95 @@
+/************************************************************************************
+
+Filename    :   TelemetryReceiver.h
+Content     :   Receives the robot's telemetry datagrams on a thread of its own and hands them
+                to the render thread through a lock-free queue.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+#include "OVR_Lockless.h"
+
+#include "TeleopProtocol.h"
+
+namespace OVRFW {
+
+class ovrTeleopSender;
+
+struct ovrTelemetrySample {
+    ovrTeleopTelemetry Telemetry;
+    uint64_t ReceiveTimeMicros; // CLOCK_MONOTONIC
+    double RoundTripSeconds; // < 0 if the sample didn't acknowledge a teleop packet
+};
+
+// Receive counts since the last ovrTelemetryReceiver::GetStats() call.
+struct ovrTelemetryReceiverStats {
+    uint32_t PacketsReceived = 0;
+    uint32_t PacketsMalformed = 0;
+    uint32_t PacketsDropped = 0; // the queue was full because the render thread fell behind
+    uint32_t PacketsOutOfOrder = 0;
+    uint32_t SequenceRestarts = 0; // the robot started numbering again
+};
+
+//==============================================================
+// ovrTelemetryReceiver
+// The receiver thread parses each datagram into an ovrTelemetrySample and pushes it onto a
+// single producer, single consumer queue; the render thread drains the queue once a frame with
+// GetLatest(). Neither side ever blocks on the other, and a sample that doesn't fit because the
+// render thread stalled is dropped and counted.
+//
+// Acknowledgements and round trip times are passed to the teleop sender straight from the
+// receiver thread, so they don't wait for a frame.
+class ovrTelemetryReceiver {
+   public:
+    static const int QUEUE_SIZE = 64;
+    // A sequence number up to this far behind the newest is a reordered datagram; further
+    // back, or after a silence this long, the robot has restarted and numbers from 1 again.
+    static const uint32_t REORDER_WINDOW = 64;
+    static const uint64_t RESTART_SILENCE_MICROS = 1000000;
+
+    ovrTelemetryReceiver();
+    ~ovrTelemetryReceiver();
+
+    // Listens on port, on all interfaces. sender may be null.
+    bool Start(const int port, ovrTeleopSender* sender);
+    void Stop();
+
+    // Render thread only. Drains the queue and returns true with the newest sample if anything
+    // arrived since the last call.
+    bool GetLatest(ovrTelemetrySample& sample);
+
+    // Returns the counts gathered since the previous call and starts a new window.
+    ovrTelemetryReceiverStats GetStats();
+
+   private:
+    // how often the receiver thread checks whether it should stop
+    static const int POLL_TIMEOUT_MS = 100;
+
+    OVR::LocklessSpscQueue<ovrTelemetrySample, QUEUE_SIZE> Queue;
+
+    int Port;
+    ovrTeleopSender* Sender;
+
+    std::thread Thread;
+    std::atomic<bool> Running;
+
+    std::atomic<uint32_t> PacketsReceived;
+    std::atomic<uint32_t> PacketsMalformed;
+    std::atomic<uint32_t> PacketsDropped;
+    std::atomic<uint32_t> PacketsOutOfOrder;
+    std::atomic<uint32_t> SequenceRestarts;
+
+    void ReceiverThread();
+    int OpenSocket() const;
+};
+
+} // namespace OVRFW
@@ -0,0 +1,105 @@
+/************************************************************************************
+
+Filename    :   TeleopPredictor.cpp
+Content     :   Extrapolates tracked poses to the time the robot will act on them.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "TeleopPredictor.h"
+
+#include <math.h>
+#include <algorithm>
+
+#include "OVR_Math.h"
+
+using OVR::Quatf;
+using OVR::Vector3f;
+
+namespace OVRFW {
+
+ovrTeleopPredictor::ovrTeleopPredictor() {
+    Reset();
+}
+
+//==============================
+// ovrTeleopPredictor::Reset
+void ovrTeleopPredictor::Reset() {
+    LastPoseTime = 0.0;
+    AngularVelocity = {0.0f, 0.0f, 0.0f};
+    LinearVelocity = {0.0f, 0.0f, 0.0f};
+    AngularAcceleration = {0.0f, 0.0f, 0.0f};
+    LinearAcceleration = {0.0f, 0.0f, 0.0f};
+}
+
+static void Smooth(ovrVector3f& filtered, const ovrVector3f& sample, const float alpha) {
+    filtered.x += (sample.x - filtered.x) * alpha;
+    filtered.y += (sample.y - filtered.y) * alpha;
+    filtered.z += (sample.z - filtered.z) * alpha;
+}
+
+// The displacement after t seconds starting at velocity v with acceleration a, where a
+// deceleration stops the motion instead of reversing it.
+static Vector3f Displacement(const Vector3f& v, const Vector3f& a, const float t) {
+    const float vDotA = v.Dot(a);
+    if (vDotA < 0.0f) {
+        const float stopTime = -v.LengthSq() / vDotA;
+        if (stopTime < t) {
+            // only the part of the acceleration along v slows it down; the rest is dropped
+            // since it would start a new motion that hasn't been measured yet
+            return v * (0.5f * stopTime);
+        }
+    }
+    return v * t + a * (0.5f * t * t);
+}
+
+//==============================
+// ovrTeleopPredictor::Predict
+ovrRigidBodyPosef ovrTeleopPredictor::Predict(
+    const ovrRigidBodyPosef& pose,
+    const double targetTime,
+    const ovrTeleopPredictionParms& parms) {
+    if (!parms.Enabled) {
+        return pose;
+    }
+
+    if (pose.TimeInSeconds != LastPoseTime) {
+        const double elapsed = pose.TimeInSeconds - LastPoseTime;
+        // the first pose, a pose from the past or a long gap restarts the filter
+        const bool restart = LastPoseTime == 0.0 || elapsed < 0.0 || elapsed > 0.5;
+        const float alpha = (restart || parms.SmoothingSeconds <= 0.0)
+            ? 1.0f
+            : static_cast<float>(1.0 - exp(-elapsed / parms.SmoothingSeconds));
+        Smooth(AngularVelocity, pose.AngularVelocity, alpha);
+        Smooth(LinearVelocity, pose.LinearVelocity, alpha);
+        Smooth(AngularAcceleration, pose.AngularAcceleration, alpha);
+        Smooth(LinearAcceleration, pose.LinearAcceleration, alpha);
+        LastPoseTime = pose.TimeInSeconds;
+    }
+
+    const double dt = std::min(targetTime - pose.TimeInSeconds, parms.MaxPredictionSeconds);
+    if (dt <= 0.0) {
+        return pose;
+    }
+    const float t = static_cast<float>(dt);
+
+    const Vector3f rotation = Displacement(
+        Vector3f(AngularVelocity), Vector3f(AngularAcceleration) * parms.AccelerationScale, t);
+    const Vector3f translation = Displacement(
+        Vector3f(LinearVelocity), Vector3f(LinearAcceleration) * parms.AccelerationScale, t);
+
+    // the velocities are in world space, so the rotation is applied on the left
+    ovrRigidBodyPosef predicted = pose;
+    const Quatf orientation =
+        Quatf::FromRotationVector(rotation) * Quatf(pose.Pose.Orientation);
+    predicted.Pose.Orientation = orientation.Normalized();
+    predicted.Pose.Position = Vector3f(pose.Pose.Position) + translation;
+    predicted.TimeInSeconds = pose.TimeInSeconds + dt;
+    predicted.PredictionInSeconds = pose.PredictionInSeconds + dt;
+    return predicted;
+}
+
+} // namespace OVRFW
@@ -0,0 +1,66 @@
+/************************************************************************************
+
+Filename    :   TeleopPredictor.h
+Content     :   Extrapolates tracked poses to the time the robot will act on them.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include "VrApi_Types.h"
+
+namespace OVRFW {
+
+struct ovrTeleopPredictionParms {
+    bool Enabled = true;
+    // time from a command arriving at the robot to the servos reaching it
+    double ActuatorLagSeconds = 0.05;
+    // predictions are never made further ahead than this, whatever the latency
+    double MaxPredictionSeconds = 0.15;
+    // time constant of the low pass filter on the velocities and accelerations; tracking noise
+    // is amplified by the prediction time, so this trades jitter for lag
+    double SmoothingSeconds = 0.02;
+    // 0 extrapolates with the velocity only, 1 with the full measured acceleration
+    float AccelerationScale = 0.5f;
+};
+
+//==============================================================
+// ovrTeleopPredictor
+// Extrapolates one tracked body, the head or a controller, from the time its pose was sampled
+// to a target time, using the velocities and accelerations in ovrRigidBodyPosef. Each call to
+// Predict() with a new pose time first runs the velocities and accelerations through a one pole
+// low pass filter, so a stream of poses arriving faster than they are sampled only filters
+// each sample once.
+//
+// To avoid overshoot, a deceleration only brings the motion to a stop: if the acceleration
+// would reverse the direction of motion before the target time, the pose is extrapolated to
+// where the motion stops and held there. Rotation and translation are handled separately.
+//
+// Does no I/O and reads no clocks, so recorded pose traces can be replayed through it.
+class ovrTeleopPredictor {
+   public:
+    ovrTeleopPredictor();
+
+    void Reset();
+
+    // Returns pose extrapolated from pose.TimeInSeconds to targetTime. The returned pose's
+    // TimeInSeconds is the time it is valid for, which is earlier than targetTime if the
+    // prediction was limited by MaxPredictionSeconds.
+    ovrRigidBodyPosef Predict(
+        const ovrRigidBodyPosef& pose,
+        const double targetTime,
+        const ovrTeleopPredictionParms& parms);
+
+   private:
+    double LastPoseTime;
+    ovrVector3f AngularVelocity;
+    ovrVector3f LinearVelocity;
+    ovrVector3f AngularAcceleration;
+    ovrVector3f LinearAcceleration;
+};
+
+} // namespace OVRFW
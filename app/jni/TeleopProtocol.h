@@ -0,0 +1,747 @@
+/************************************************************************************
+
+Filename    :   TeleopProtocol.h
+Content     :   Quantized binary wire format for the teleop command stream. Header only and
+                free of VrApi and framework dependencies so the robot can decode with it too.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+namespace OVRFW {
+
+//==============================================================
+// Teleop wire format, version 2
+//
+// All values little endian. A packet is a fixed header followed by the fields named in the
+// field mask, in mask bit order:
+//
+//	u16 magic 'WT' | u8 version | u8 flags | u32 sequence | u32 base sequence (delta only)
+//	u32 send time | i32 pose time - send time | u16 field mask | fields...
+//
+// Fields:
+//	pose position       3 x i16, millimeters
+//	pose orientation    u32, smallest three: 2 bit index of the dropped largest component, then
+//	                    3 x 10 bit remaining components scaled from [-1/sqrt(2), 1/sqrt(2)]
+//	controller triggers 2 x u8, index then grip, [0, 1] scaled to 255
+//	controller joystick 2 x i8, x then y, [-1, 1] scaled to 127
+//	controller buttons  u16 packed ovrButton bits, u16 ovrTouch bits with the joystick click
+//	                    in the top bit
+//
+// Times are the low 32 bits of CLOCK_MONOTONIC microseconds.
+//
+// The robot answers on a separate port with telemetry packets, version 1:
+//
+//	u16 magic 'WR' | u8 version | u8 servo count (high nibble) and motor count (low nibble)
+//	u32 sequence | u32 acknowledged teleop sequence, 0 for none
+//	u32 send time of the acknowledged packet, echoed | u32 robot hold time of that packet
+//	u16 battery millivolts | u8 battery percent | i8 Wi-Fi RSSI dBm
+//	u32 teleop packets received | u32 teleop packets lost
+//	per servo: i16 position, centidegrees | u16 current, milliamps
+//	per motor: i16 temperature, decidegrees Celsius
+//
+// The acknowledgement drives the teleop deltas, and the echoed send time minus the hold time
+// gives the round trip time used for prediction.
+//
+// A keyframe carries every field. A delta packet names the sequence of an earlier packet the
+// receiver acknowledged and carries only the fields whose quantized value differs from that
+// packet's state. The values are quantized before they are compared, so unchanged fields
+// cost nothing and the receiver reconstructs the exact state the sender encoded. The encoder
+// only uses acknowledgements recent enough to still be in both sides' history, so a receiver
+// that restarts or loses the acknowledgement path gets keyframes again within a history's
+// worth of packets.
+
+static const uint16_t TELEOP_WIRE_MAGIC = ('W' << 0) | ('T' << 8);
+static const uint8_t TELEOP_WIRE_VERSION = 2;
+static const int TELEOP_WIRE_MAX_CONTROLLERS = 2;
+// delta header, head, controllers
+static const int TELEOP_WIRE_MAX_PACKET_SIZE = 22 + 10 + TELEOP_WIRE_MAX_CONTROLLERS * 18;
+
+// header flags, the low bits are the connected controllers
+static const uint8_t TELEOP_WIRE_FLAG_CONNECTED_MASK = (1 << TELEOP_WIRE_MAX_CONTROLLERS) - 1;
+static const uint8_t TELEOP_WIRE_FLAG_DELTA = 1 << 7;
+
+// field mask bits
+enum ovrTeleopWireField {
+    TELEOP_WIRE_FIELD_HEAD_POSITION = 1 << 0,
+    TELEOP_WIRE_FIELD_HEAD_ORIENTATION = 1 << 1,
+    // per controller, shifted by TELEOP_WIRE_CONTROLLER_FIELD_SHIFT * controller
+    TELEOP_WIRE_FIELD_CONTROLLER_POSITION = 1 << 2,
+    TELEOP_WIRE_FIELD_CONTROLLER_ORIENTATION = 1 << 3,
+    TELEOP_WIRE_FIELD_CONTROLLER_TRIGGERS = 1 << 4,
+    TELEOP_WIRE_FIELD_CONTROLLER_JOYSTICK = 1 << 5,
+    TELEOP_WIRE_FIELD_CONTROLLER_BUTTONS = 1 << 6,
+};
+static const int TELEOP_WIRE_CONTROLLER_FIELD_SHIFT = 5;
+static const uint16_t TELEOP_WIRE_ALL_FIELDS = (1 << (2 + 2 * 5)) - 1;
+
+//==============================================================
+// Quantization
+
+inline int16_t TeleopQuantizePosition(const float meters) {
+    const float mm = roundf(meters * 1000.0f);
+    return static_cast<int16_t>(mm < -32767.0f ? -32767.0f : (mm > 32767.0f ? 32767.0f : mm));
+}
+
+inline float TeleopDequantizePosition(const int16_t mm) {
+    return mm * 0.001f;
+}
+
+// q is x, y, z, w and does not have to be normalized.
+inline uint32_t TeleopQuantizeOrientation(const float q[4]) {
+    const float lengthSq = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+    if (lengthSq <= 0.0f) {
+        return 3u << 30 | 511u << 20 | 511u << 10 | 511u; // identity
+    }
+    int largest = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(q[i]) > fabsf(q[largest])) {
+            largest = i;
+        }
+    }
+    // q and -q are the same rotation, so make the dropped component positive
+    const float scale = (q[largest] < 0.0f ? -1.0f : 1.0f) / sqrtf(lengthSq);
+    uint32_t packed = static_cast<uint32_t>(largest) << 30;
+    int shift = 20;
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) {
+            continue;
+        }
+        // the other three components are within +/- 1/sqrt(2)
+        const float c = q[i] * scale * 1.41421356f;
+        const float v = roundf((c < -1.0f ? -1.0f : (c > 1.0f ? 1.0f : c)) * 511.0f + 511.0f);
+        packed |= static_cast<uint32_t>(v) << shift;
+        shift -= 10;
+    }
+    return packed;
+}
+
+inline void TeleopDequantizeOrientation(const uint32_t packed, float q[4]) {
+    const int largest = static_cast<int>(packed >> 30);
+    float sumSq = 0.0f;
+    int shift = 20;
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) {
+            continue;
+        }
+        const float v = static_cast<float>((packed >> shift) & 1023u);
+        q[i] = (v - 511.0f) * (1.0f / 511.0f) * 0.70710678f;
+        sumSq += q[i] * q[i];
+        shift -= 10;
+    }
+    q[largest] = sqrtf(sumSq < 1.0f ? 1.0f - sumSq : 0.0f);
+}
+
+inline uint8_t TeleopQuantizeUnit(const float v) {
+    return static_cast<uint8_t>(roundf((v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v)) * 255.0f));
+}
+
+inline float TeleopDequantizeUnit(const uint8_t v) {
+    return v * (1.0f / 255.0f);
+}
+
+inline int8_t TeleopQuantizeSigned(const float v) {
+    return static_cast<int8_t>(roundf((v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v)) * 127.0f));
+}
+
+inline float TeleopDequantizeSigned(const int8_t v) {
+    return v * (1.0f / 127.0f);
+}
+
+// The ovrButton bits, in the order they are packed into 16 bits. Values are repeated here so
+// the robot side doesn't need the VrApi headers.
+static const uint32_t TeleopWireButtons[] = {
+    0x00000001, // A
+    0x00000002, // B
+    0x00000004, // RThumb
+    0x00000008, // RShoulder
+    0x00000100, // X
+    0x00000200, // Y
+    0x00000400, // LThumb
+    0x00000800, // LShoulder
+    0x00010000, // Up
+    0x00020000, // Down
+    0x00040000, // Left
+    0x00080000, // Right
+    0x00100000, // Enter
+    0x00200000, // Back
+    0x04000000, // GripTrigger
+    0x20000000, // Trigger
+};
+// ovrButton_Joystick doesn't fit in the packed buttons and goes in the otherwise unused top
+// bit of the touches
+static const uint32_t TELEOP_WIRE_BUTTON_JOYSTICK = 0x80000000;
+static const uint16_t TELEOP_WIRE_TOUCH_JOYSTICK_CLICK = 0x8000;
+static const uint16_t TELEOP_WIRE_TOUCH_MASK = 0x7FFF;
+
+// buttons and touches are ovrButton and ovrTouch bits
+inline void TeleopPackInput(
+    const uint32_t buttons,
+    const uint32_t touches,
+    uint16_t& wireButtons,
+    uint16_t& wireTouches) {
+    wireButtons = 0;
+    for (int i = 0; i < 16; i++) {
+        if ((buttons & TeleopWireButtons[i]) != 0) {
+            wireButtons |= 1 << i;
+        }
+    }
+    wireTouches = static_cast<uint16_t>(touches & TELEOP_WIRE_TOUCH_MASK);
+    if ((buttons & TELEOP_WIRE_BUTTON_JOYSTICK) != 0) {
+        wireTouches |= TELEOP_WIRE_TOUCH_JOYSTICK_CLICK;
+    }
+}
+
+inline void TeleopUnpackInput(
+    const uint16_t wireButtons,
+    const uint16_t wireTouches,
+    uint32_t& buttons,
+    uint32_t& touches) {
+    buttons = 0;
+    for (int i = 0; i < 16; i++) {
+        if ((wireButtons & (1 << i)) != 0) {
+            buttons |= TeleopWireButtons[i];
+        }
+    }
+    if ((wireTouches & TELEOP_WIRE_TOUCH_JOYSTICK_CLICK) != 0) {
+        buttons |= TELEOP_WIRE_BUTTON_JOYSTICK;
+    }
+    touches = wireTouches & TELEOP_WIRE_TOUCH_MASK;
+}
+
+//==============================================================
+// Quantized state
+
+struct ovrTeleopWirePose {
+    int16_t Position[3];
+    uint32_t Orientation;
+};
+
+struct ovrTeleopWireController {
+    ovrTeleopWirePose Pose;
+    uint8_t IndexTrigger;
+    uint8_t GripTrigger;
+    int8_t Joystick[2];
+    uint16_t Buttons; // TeleopPackInput()
+    uint16_t Touches;
+};
+
+struct ovrTeleopWireState {
+    uint8_t Connected; // bit per controller
+    ovrTeleopWirePose Head;
+    ovrTeleopWireController Controllers[TELEOP_WIRE_MAX_CONTROLLERS];
+};
+
+struct ovrTeleopWireHeader {
+    uint32_t Sequence;
+    uint32_t BaseSequence; // only meaningful for delta packets
+    uint32_t SendTimeMicros;
+    int32_t PoseTimeOffsetMicros; // pose time - send time
+    bool Delta;
+};
+
+inline void TeleopClearWireState(ovrTeleopWireState& state) {
+    memset(&state, 0, sizeof(state));
+    const float identity[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    state.Head.Orientation = TeleopQuantizeOrientation(identity);
+    for (int i = 0; i < TELEOP_WIRE_MAX_CONTROLLERS; i++) {
+        state.Controllers[i].Pose.Orientation = state.Head.Orientation;
+    }
+}
+
+// The fields of a that differ from b.
+inline uint16_t TeleopDiffWireState(const ovrTeleopWireState& a, const ovrTeleopWireState& b) {
+    uint16_t mask = 0;
+    if (memcmp(a.Head.Position, b.Head.Position, sizeof(a.Head.Position)) != 0) {
+        mask |= TELEOP_WIRE_FIELD_HEAD_POSITION;
+    }
+    if (a.Head.Orientation != b.Head.Orientation) {
+        mask |= TELEOP_WIRE_FIELD_HEAD_ORIENTATION;
+    }
+    for (int i = 0; i < TELEOP_WIRE_MAX_CONTROLLERS; i++) {
+        const ovrTeleopWireController& ca = a.Controllers[i];
+        const ovrTeleopWireController& cb = b.Controllers[i];
+        uint16_t controllerMask = 0;
+        if (memcmp(ca.Pose.Position, cb.Pose.Position, sizeof(ca.Pose.Position)) != 0) {
+            controllerMask |= TELEOP_WIRE_FIELD_CONTROLLER_POSITION;
+        }
+        if (ca.Pose.Orientation != cb.Pose.Orientation) {
+            controllerMask |= TELEOP_WIRE_FIELD_CONTROLLER_ORIENTATION;
+        }
+        if (ca.IndexTrigger != cb.IndexTrigger || ca.GripTrigger != cb.GripTrigger) {
+            controllerMask |= TELEOP_WIRE_FIELD_CONTROLLER_TRIGGERS;
+        }
+        if (ca.Joystick[0] != cb.Joystick[0] || ca.Joystick[1] != cb.Joystick[1]) {
+            controllerMask |= TELEOP_WIRE_FIELD_CONTROLLER_JOYSTICK;
+        }
+        if (ca.Buttons != cb.Buttons || ca.Touches != cb.Touches) {
+            controllerMask |= TELEOP_WIRE_FIELD_CONTROLLER_BUTTONS;
+        }
+        mask |= controllerMask << (i * TELEOP_WIRE_CONTROLLER_FIELD_SHIFT);
+    }
+    return mask;
+}
+
+//==============================================================
+// ovrTeleopWireWriter
+// Appends little endian values to a fixed buffer.
+class ovrTeleopWireWriter {
+   public:
+    ovrTeleopWireWriter(uint8_t* data, const int size)
+        : Data(data), Size(size), Offset(0), Overflow(false) {}
+
+    void Put8(const uint8_t v) {
+        PutBytes(v, 1);
+    }
+    void Put16(const uint16_t v) {
+        PutBytes(v, 2);
+    }
+    void Put32(const uint32_t v) {
+        PutBytes(v, 4);
+    }
+    void PutPose(const ovrTeleopWirePose& pose, const bool position, const bool orientation) {
+        if (position) {
+            for (int i = 0; i < 3; i++) {
+                Put16(static_cast<uint16_t>(pose.Position[i]));
+            }
+        }
+        if (orientation) {
+            Put32(pose.Orientation);
+        }
+    }
+
+    // 0 if anything didn't fit
+    int GetSize() const {
+        return Overflow ? 0 : Offset;
+    }
+
+   private:
+    uint8_t* Data;
+    int Size;
+    int Offset;
+    bool Overflow;
+
+    void PutBytes(const uint32_t v, const int numBytes) {
+        if (Offset + numBytes > Size) {
+            Overflow = true;
+            return;
+        }
+        for (int i = 0; i < numBytes; i++) {
+            Data[Offset++] = static_cast<uint8_t>(v >> (i * 8));
+        }
+    }
+};
+
+//==============================================================
+// ovrTeleopWireReader
+// Reads little endian values, and remembers if it ran past the end.
+class ovrTeleopWireReader {
+   public:
+    ovrTeleopWireReader(const uint8_t* data, const int size)
+        : Data(data), Size(size), Offset(0), Overflow(false) {}
+
+    uint8_t Get8() {
+        return static_cast<uint8_t>(GetBytes(1));
+    }
+    uint16_t Get16() {
+        return static_cast<uint16_t>(GetBytes(2));
+    }
+    uint32_t Get32() {
+        return GetBytes(4);
+    }
+    void GetPose(ovrTeleopWirePose& pose, const bool position, const bool orientation) {
+        if (position) {
+            for (int i = 0; i < 3; i++) {
+                pose.Position[i] = static_cast<int16_t>(Get16());
+            }
+        }
+        if (orientation) {
+            pose.Orientation = Get32();
+        }
+    }
+
+    bool IsValid() const {
+        return !Overflow;
+    }
+    bool IsAtEnd() const {
+        return Offset == Size;
+    }
+
+   private:
+    const uint8_t* Data;
+    int Size;
+    int Offset;
+    bool Overflow;
+
+    uint32_t GetBytes(const int numBytes) {
+        if (Offset + numBytes > Size) {
+            Overflow = true;
+            return 0;
+        }
+        uint32_t v = 0;
+        for (int i = 0; i < numBytes; i++) {
+            v |= static_cast<uint32_t>(Data[Offset++]) << (i * 8);
+        }
+        return v;
+    }
+};
+
+inline void TeleopWriteFields(
+    ovrTeleopWireWriter& writer,
+    const ovrTeleopWireState& state,
+    const uint16_t mask) {
+    writer.PutPose(
+        state.Head,
+        (mask & TELEOP_WIRE_FIELD_HEAD_POSITION) != 0,
+        (mask & TELEOP_WIRE_FIELD_HEAD_ORIENTATION) != 0);
+    for (int i = 0; i < TELEOP_WIRE_MAX_CONTROLLERS; i++) {
+        const ovrTeleopWireController& c = state.Controllers[i];
+        const uint16_t m = mask >> (i * TELEOP_WIRE_CONTROLLER_FIELD_SHIFT);
+        writer.PutPose(
+            c.Pose,
+            (m & TELEOP_WIRE_FIELD_CONTROLLER_POSITION) != 0,
+            (m & TELEOP_WIRE_FIELD_CONTROLLER_ORIENTATION) != 0);
+        if ((m & TELEOP_WIRE_FIELD_CONTROLLER_TRIGGERS) != 0) {
+            writer.Put8(c.IndexTrigger);
+            writer.Put8(c.GripTrigger);
+        }
+        if ((m & TELEOP_WIRE_FIELD_CONTROLLER_JOYSTICK) != 0) {
+            writer.Put8(static_cast<uint8_t>(c.Joystick[0]));
+            writer.Put8(static_cast<uint8_t>(c.Joystick[1]));
+        }
+        if ((m & TELEOP_WIRE_FIELD_CONTROLLER_BUTTONS) != 0) {
+            writer.Put16(c.Buttons);
+            writer.Put16(c.Touches);
+        }
+    }
+}
+
+inline void
+TeleopReadFields(ovrTeleopWireReader& reader, ovrTeleopWireState& state, const uint16_t mask) {
+    reader.GetPose(
+        state.Head,
+        (mask & TELEOP_WIRE_FIELD_HEAD_POSITION) != 0,
+        (mask & TELEOP_WIRE_FIELD_HEAD_ORIENTATION) != 0);
+    for (int i = 0; i < TELEOP_WIRE_MAX_CONTROLLERS; i++) {
+        ovrTeleopWireController& c = state.Controllers[i];
+        const uint16_t m = mask >> (i * TELEOP_WIRE_CONTROLLER_FIELD_SHIFT);
+        reader.GetPose(
+            c.Pose,
+            (m & TELEOP_WIRE_FIELD_CONTROLLER_POSITION) != 0,
+            (m & TELEOP_WIRE_FIELD_CONTROLLER_ORIENTATION) != 0);
+        if ((m & TELEOP_WIRE_FIELD_CONTROLLER_TRIGGERS) != 0) {
+            c.IndexTrigger = reader.Get8();
+            c.GripTrigger = reader.Get8();
+        }
+        if ((m & TELEOP_WIRE_FIELD_CONTROLLER_JOYSTICK) != 0) {
+            c.Joystick[0] = static_cast<int8_t>(reader.Get8());
+            c.Joystick[1] = static_cast<int8_t>(reader.Get8());
+        }
+        if ((m & TELEOP_WIRE_FIELD_CONTROLLER_BUTTONS) != 0) {
+            c.Buttons = reader.Get16();
+            c.Touches = reader.Get16();
+        }
+    }
+}
+
+//==============================================================
+// ovrTeleopWireHistory
+// The states of the last HISTORY_SIZE sequence numbers, for resolving delta bases.
+class ovrTeleopWireHistory {
+   public:
+    static const int HISTORY_SIZE = 64;
+
+    ovrTeleopWireHistory() {
+        Clear();
+    }
+
+    void Clear() {
+        for (int i = 0; i < HISTORY_SIZE; i++) {
+            Valid[i] = false;
+        }
+    }
+
+    void Add(const uint32_t sequence, const ovrTeleopWireState& state) {
+        const int slot = sequence % HISTORY_SIZE;
+        Sequences[slot] = sequence;
+        States[slot] = state;
+        Valid[slot] = true;
+    }
+
+    const ovrTeleopWireState* Find(const uint32_t sequence) const {
+        const int slot = sequence % HISTORY_SIZE;
+        return (Valid[slot] && Sequences[slot] == sequence) ? &States[slot] : nullptr;
+    }
+
+   private:
+    uint32_t Sequences[HISTORY_SIZE];
+    ovrTeleopWireState States[HISTORY_SIZE];
+    bool Valid[HISTORY_SIZE];
+};
+
+//==============================================================
+// ovrTeleopEncoder
+// Sender side. Encode() numbers the packets itself; Acknowledge() is fed the sequence numbers
+// the receiver reports having decoded. Sequence numbers are never 0, which acknowledgements use
+// for none.
+class ovrTeleopEncoder {
+   public:
+    ovrTeleopEncoder() : NextSequence(1), AckedSequence(0), HaveAck(false) {}
+
+    // Starts over with keyframes. A sender that stops and starts again passes the sequence it
+    // got to, since the receiver ignores packets older than the newest it has acted on.
+    void Reset(const uint32_t nextSequence = 1) {
+        NextSequence = nextSequence != 0 ? nextSequence : 1;
+        HaveAck = false;
+        History.Clear();
+    }
+
+    uint32_t GetNextSequence() const {
+        return NextSequence;
+    }
+
+    void Acknowledge(const uint32_t sequence) {
+        // only move forward, and only to packets that were sent
+        if (History.Find(sequence) == nullptr ||
+            (HaveAck && static_cast<int32_t>(sequence - AckedSequence) <= 0)) {
+            return;
+        }
+        AckedSequence = sequence;
+        HaveAck = true;
+    }
+
+    // Returns the packet size, or 0 if the buffer is too small.
+    int Encode(
+        const ovrTeleopWireState& state,
+        const uint32_t sendTimeMicros,
+        const int32_t poseTimeOffsetMicros,
+        uint8_t* buffer,
+        const int bufferSize) {
+        const uint32_t sequence = NextSequence++;
+        if (NextSequence == 0) {
+            NextSequence = 1;
+        }
+
+        // the base has to be recent enough that the receiver still has it
+        const ovrTeleopWireState* base = nullptr;
+        if (HaveAck && sequence - AckedSequence < ovrTeleopWireHistory::HISTORY_SIZE) {
+            base = History.Find(AckedSequence);
+        }
+        const uint16_t mask =
+            base != nullptr ? TeleopDiffWireState(state, *base) : TELEOP_WIRE_ALL_FIELDS;
+
+        uint8_t flags = state.Connected & TELEOP_WIRE_FLAG_CONNECTED_MASK;
+        if (base != nullptr) {
+            flags |= TELEOP_WIRE_FLAG_DELTA;
+        }
+
+        ovrTeleopWireWriter writer(buffer, bufferSize);
+        writer.Put16(TELEOP_WIRE_MAGIC);
+        writer.Put8(TELEOP_WIRE_VERSION);
+        writer.Put8(flags);
+        writer.Put32(sequence);
+        if (base != nullptr) {
+            writer.Put32(AckedSequence);
+        }
+        writer.Put32(sendTimeMicros);
+        writer.Put32(static_cast<uint32_t>(poseTimeOffsetMicros));
+        writer.Put16(mask);
+        TeleopWriteFields(writer, state, mask);
+
+        History.Add(sequence, state);
+        return writer.GetSize();
+    }
+
+   private:
+    uint32_t NextSequence;
+    uint32_t AckedSequence;
+    bool HaveAck;
+    ovrTeleopWireHistory History;
+};
+
+enum ovrTeleopDecodeResult {
+    TELEOP_DECODE_OK,
+    TELEOP_DECODE_MALFORMED, // wrong magic or version, truncated, or trailing bytes
+    TELEOP_DECODE_MISSING_BASE, // a delta against a packet that wasn't received
+};
+
+//==============================================================
+// ovrTeleopDecoder
+// Receiver side. Packets may be decoded in any order; it's up to the caller to ignore ones
+// older than the newest it has acted on, using the header's sequence number.
+class ovrTeleopDecoder {
+   public:
+    void Reset() {
+        History.Clear();
+    }
+
+    ovrTeleopDecodeResult Decode(
+        const uint8_t* buffer,
+        const int size,
+        ovrTeleopWireHeader& header,
+        ovrTeleopWireState& state) {
+        ovrTeleopWireReader reader(buffer, size);
+        const uint16_t magic = reader.Get16();
+        const uint8_t version = reader.Get8();
+        const uint8_t flags = reader.Get8();
+        if (!reader.IsValid() || magic != TELEOP_WIRE_MAGIC || version != TELEOP_WIRE_VERSION) {
+            return TELEOP_DECODE_MALFORMED;
+        }
+        header.Delta = (flags & TELEOP_WIRE_FLAG_DELTA) != 0;
+        header.Sequence = reader.Get32();
+        header.BaseSequence = header.Delta ? reader.Get32() : 0;
+        header.SendTimeMicros = reader.Get32();
+        header.PoseTimeOffsetMicros = static_cast<int32_t>(reader.Get32());
+        const uint16_t mask = reader.Get16();
+        if (!reader.IsValid() || (mask & ~TELEOP_WIRE_ALL_FIELDS) != 0) {
+            return TELEOP_DECODE_MALFORMED;
+        }
+
+        ovrTeleopWireState decoded;
+        if (header.Delta) {
+            const ovrTeleopWireState* base = History.Find(header.BaseSequence);
+            if (base == nullptr) {
+                return TELEOP_DECODE_MISSING_BASE;
+            }
+            decoded = *base;
+        } else {
+            TeleopClearWireState(decoded);
+        }
+        decoded.Connected = flags & TELEOP_WIRE_FLAG_CONNECTED_MASK;
+        TeleopReadFields(reader, decoded, mask);
+        if (!reader.IsValid() || !reader.IsAtEnd()) {
+            return TELEOP_DECODE_MALFORMED;
+        }
+
+        History.Add(header.Sequence, decoded);
+        state = decoded;
+        return TELEOP_DECODE_OK;
+    }
+
+   private:
+    ovrTeleopWireHistory History;
+};
+
+//==============================================================
+// Telemetry
+
+static const uint16_t TELEMETRY_WIRE_MAGIC = ('W' << 0) | ('R' << 8);
+static const uint8_t TELEMETRY_WIRE_VERSION = 1;
+static const int TELEMETRY_MAX_SERVOS = 8;
+static const int TELEMETRY_MAX_MOTORS = 4;
+static const int TELEMETRY_WIRE_MAX_PACKET_SIZE =
+    32 + TELEMETRY_MAX_SERVOS * 4 + TELEMETRY_MAX_MOTORS * 2;
+
+struct ovrTeleopTelemetry {
+    uint32_t Sequence;
+    uint32_t AckedSequence; // 0 if the robot hasn't decoded a teleop packet yet
+    uint32_t AckedSendTimeMicros;
+    uint32_t AckHoldMicros; // from the robot receiving the acknowledged packet to sending this
+    float BatteryVolts;
+    uint8_t BatteryPercent;
+    int8_t WifiRssi; // dBm
+    uint32_t TeleopPacketsReceived;
+    uint32_t TeleopPacketsLost;
+    int NumServos;
+    float ServoPositionDegrees[TELEMETRY_MAX_SERVOS];
+    float ServoCurrentAmps[TELEMETRY_MAX_SERVOS];
+    int NumMotors;
+    float MotorTemperatureCelsius[TELEMETRY_MAX_MOTORS];
+};
+
+inline int16_t TelemetryQuantize(const float v, const float scale) {
+    const float q = roundf(v * scale);
+    return static_cast<int16_t>(q < -32767.0f ? -32767.0f : (q > 32767.0f ? 32767.0f : q));
+}
+
+// Returns the packet size, or 0 if the buffer is too small.
+inline int
+TelemetryEncode(const ovrTeleopTelemetry& telemetry, uint8_t* buffer, const int bufferSize) {
+    const int numServos = telemetry.NumServos < 0
+        ? 0
+        : (telemetry.NumServos > TELEMETRY_MAX_SERVOS ? TELEMETRY_MAX_SERVOS : telemetry.NumServos);
+    const int numMotors = telemetry.NumMotors < 0
+        ? 0
+        : (telemetry.NumMotors > TELEMETRY_MAX_MOTORS ? TELEMETRY_MAX_MOTORS : telemetry.NumMotors);
+    const float millivolts = roundf(telemetry.BatteryVolts * 1000.0f);
+
+    ovrTeleopWireWriter writer(buffer, bufferSize);
+    writer.Put16(TELEMETRY_WIRE_MAGIC);
+    writer.Put8(TELEMETRY_WIRE_VERSION);
+    writer.Put8(static_cast<uint8_t>(numServos << 4 | numMotors));
+    writer.Put32(telemetry.Sequence);
+    writer.Put32(telemetry.AckedSequence);
+    writer.Put32(telemetry.AckedSendTimeMicros);
+    writer.Put32(telemetry.AckHoldMicros);
+    writer.Put16(static_cast<uint16_t>(
+        millivolts < 0.0f ? 0.0f : (millivolts > 65535.0f ? 65535.0f : millivolts)));
+    writer.Put8(telemetry.BatteryPercent);
+    writer.Put8(static_cast<uint8_t>(telemetry.WifiRssi));
+    writer.Put32(telemetry.TeleopPacketsReceived);
+    writer.Put32(telemetry.TeleopPacketsLost);
+    for (int i = 0; i < numServos; i++) {
+        writer.Put16(static_cast<uint16_t>(
+            TelemetryQuantize(telemetry.ServoPositionDegrees[i], 100.0f)));
+        const float milliamps = roundf(telemetry.ServoCurrentAmps[i] * 1000.0f);
+        writer.Put16(static_cast<uint16_t>(
+            milliamps < 0.0f ? 0.0f : (milliamps > 65535.0f ? 65535.0f : milliamps)));
+    }
+    for (int i = 0; i < numMotors; i++) {
+        writer.Put16(static_cast<uint16_t>(
+            TelemetryQuantize(telemetry.MotorTemperatureCelsius[i], 10.0f)));
+    }
+    return writer.GetSize();
+}
+
+// Returns false if the packet is malformed.
+inline bool
+TelemetryDecode(const uint8_t* buffer, const int size, ovrTeleopTelemetry& telemetry) {
+    ovrTeleopWireReader reader(buffer, size);
+    const uint16_t magic = reader.Get16();
+    const uint8_t version = reader.Get8();
+    const uint8_t counts = reader.Get8();
+    if (!reader.IsValid() || magic != TELEMETRY_WIRE_MAGIC || version != TELEMETRY_WIRE_VERSION) {
+        return false;
+    }
+    const int numServos = counts >> 4;
+    const int numMotors = counts & 15;
+    if (numServos > TELEMETRY_MAX_SERVOS || numMotors > TELEMETRY_MAX_MOTORS) {
+        return false;
+    }
+
+    ovrTeleopTelemetry decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    decoded.Sequence = reader.Get32();
+    decoded.AckedSequence = reader.Get32();
+    decoded.AckedSendTimeMicros = reader.Get32();
+    decoded.AckHoldMicros = reader.Get32();
+    decoded.BatteryVolts = reader.Get16() * 0.001f;
+    decoded.BatteryPercent = reader.Get8();
+    decoded.WifiRssi = static_cast<int8_t>(reader.Get8());
+    decoded.TeleopPacketsReceived = reader.Get32();
+    decoded.TeleopPacketsLost = reader.Get32();
+    decoded.NumServos = numServos;
+    for (int i = 0; i < numServos; i++) {
+        decoded.ServoPositionDegrees[i] = static_cast<int16_t>(reader.Get16()) * 0.01f;
+        decoded.ServoCurrentAmps[i] = reader.Get16() * 0.001f;
+    }
+    decoded.NumMotors = numMotors;
+    for (int i = 0; i < numMotors; i++) {
+        decoded.MotorTemperatureCelsius[i] = static_cast<int16_t>(reader.Get16()) * 0.1f;
+    }
+    if (!reader.IsValid() || !reader.IsAtEnd()) {
+        return false;
+    }
+    telemetry = decoded;
+    return true;
+}
+
+} // namespace OVRFW
@@ -0,0 +1,308 @@
+/************************************************************************************
+
+Filename    :   TeleopSender.cpp
+Content     :   Streams the operator's head and controller state to the robot over UDP at a
+                fixed rate, from a thread of its own.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#include "TeleopSender.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Misc/Log.h"
+
+namespace OVRFW {
+
+// log the send stats this often
+static const double STATS_LOG_INTERVAL_SECONDS = 10.0;
+
+// DSCP expedited forwarding, which Wi-Fi maps to the voice access category
+static const int TELEOP_IP_TOS = 0xB8;
+
+ovrTeleopSender::ovrTeleopSender()
+    : RoundTripMicros(static_cast<uint32_t>(DEFAULT_ROUND_TRIP_SECONDS * 1e6)),
+      Port(0),
+      RateHz(0),
+      Running(false),
+      NextSequence(1),
+      AckedSequence(0),
+      PacketsSent(0),
+      BytesSent(0),
+      SendErrors(0),
+      MissedTicks(0),
+      JitterSumMicros(0),
+      JitterMaxMicros(0),
+      JitterCount(0) {}
+
+ovrTeleopSender::~ovrTeleopSender() {
+    Stop();
+}
+
+//==============================
+// ovrTeleopSender::Start
+bool ovrTeleopSender::Start(const char* host, const int port, const int rateHz) {
+    Stop();
+    if (host == nullptr || host[0] == '\0' || port <= 0 || port > 65535 || rateHz <= 0) {
+        ALOGW("ovrTeleopSender: invalid destination %s:%i at %i Hz", host, port, rateHz);
+        return false;
+    }
+    Host = host;
+    Port = port;
+    RateHz = rateHz;
+    AckedSequence.store(0);
+    Running.store(true);
+    Thread = std::thread(&ovrTeleopSender::SenderThread, this);
+    return true;
+}
+
+//==============================
+// ovrTeleopSender::Stop
+void ovrTeleopSender::Stop() {
+    Running.store(false);
+    if (Thread.joinable()) {
+        Thread.join();
+    }
+    // don't send a stale pose when streaming starts again
+    State.SetState(ovrTeleopState());
+}
+
+//==============================
+// ovrTeleopSender::GetStats
+ovrTeleopSenderStats ovrTeleopSender::GetStats() {
+    ovrTeleopSenderStats stats;
+    stats.PacketsSent = PacketsSent.exchange(0);
+    stats.BytesSent = BytesSent.exchange(0);
+    stats.SendErrors = SendErrors.exchange(0);
+    stats.MissedTicks = MissedTicks.exchange(0);
+    const uint64_t jitterSum = JitterSumMicros.exchange(0);
+    const uint32_t jitterCount = JitterCount.exchange(0);
+    stats.MeanJitterSeconds = jitterCount > 0 ? jitterSum * 1e-6 / jitterCount : 0.0;
+    stats.MaxJitterSeconds = JitterMaxMicros.exchange(0) * 1e-6;
+    return stats;
+}
+
+//==============================
+// ovrTeleopSender::GetTimeMicros
+uint64_t ovrTeleopSender::GetTimeMicros() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000ull + now.tv_nsec / 1000;
+}
+
+static void ToWirePose(const ovrPosef& pose, ovrTeleopWirePose& wire) {
+    wire.Position[0] = TeleopQuantizePosition(pose.Position.x);
+    wire.Position[1] = TeleopQuantizePosition(pose.Position.y);
+    wire.Position[2] = TeleopQuantizePosition(pose.Position.z);
+    const float q[4] = {
+        pose.Orientation.x, pose.Orientation.y, pose.Orientation.z, pose.Orientation.w};
+    wire.Orientation = TeleopQuantizeOrientation(q);
+}
+
+//==============================
+// ovrTeleopSender::ToWireState
+void ovrTeleopSender::ToWireState(const ovrTeleopState& state, ovrTeleopWireState& wire) {
+    TeleopClearWireState(wire);
+    for (int i = 0; i < TELEOP_HAND_MAX; i++) {
+        const ovrTeleopControllerState& controller = state.Controllers[i];
+        if (!controller.Connected) {
+            continue; // leave disconnected controllers at rest so they don't show up in deltas
+        }
+        ovrTeleopWireController& c = wire.Controllers[i];
+        wire.Connected |= 1 << i;
+        ToWirePose(controller.Pose.Pose, c.Pose);
+        c.IndexTrigger = TeleopQuantizeUnit(controller.IndexTrigger);
+        c.GripTrigger = TeleopQuantizeUnit(controller.GripTrigger);
+        c.Joystick[0] = TeleopQuantizeSigned(controller.Joystick.x);
+        c.Joystick[1] = TeleopQuantizeSigned(controller.Joystick.y);
+        TeleopPackInput(controller.Buttons, controller.Touches, c.Buttons, c.Touches);
+    }
+    ToWirePose(state.HeadPose.Pose, wire.Head);
+}
+
+//==============================
+// ovrTeleopSender::OpenSocket
+int ovrTeleopSender::OpenSocket() const {
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    struct addrinfo* addresses = nullptr;
+    const std::string port = std::to_string(Port);
+    const int error = getaddrinfo(Host.c_str(), port.c_str(), &hints, &addresses);
+    if (error != 0 || addresses == nullptr) {
+        ALOGW("ovrTeleopSender: couldn't resolve %s: %s", Host.c_str(), gai_strerror(error));
+        return -1;
+    }
+
+    const int fd = socket(addresses->ai_family, addresses->ai_socktype, addresses->ai_protocol);
+    if (fd < 0) {
+        ALOGW("ovrTeleopSender: socket() failed: %s", strerror(errno));
+        freeaddrinfo(addresses);
+        return -1;
+    }
+
+    // connected so send() doesn't look the route up per packet
+    if (connect(fd, addresses->ai_addr, addresses->ai_addrlen) != 0) {
+        ALOGW("ovrTeleopSender: connect() failed: %s", strerror(errno));
+        freeaddrinfo(addresses);
+        close(fd);
+        return -1;
+    }
+    freeaddrinfo(addresses);
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    const int tos = TELEOP_IP_TOS;
+    if (setsockopt(fd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos)) != 0) {
+        ALOGW("ovrTeleopSender: couldn't set IP_TOS: %s", strerror(errno));
+    }
+    return fd;
+}
+
+static void AddTime(struct timespec& t, const int64_t nanoseconds) {
+    const int64_t ns = t.tv_nsec + nanoseconds;
+    t.tv_sec += ns / 1000000000;
+    t.tv_nsec = ns % 1000000000;
+}
+
+static int64_t DiffTime(const struct timespec& a, const struct timespec& b) {
+    return (static_cast<int64_t>(a.tv_sec) - b.tv_sec) * 1000000000 + (a.tv_nsec - b.tv_nsec);
+}
+
+//==============================
+// ovrTeleopSender::SenderThread
+void ovrTeleopSender::SenderThread() {
+    pthread_setname_np(pthread_self(), "OVR::Teleop");
+
+    const int fd = OpenSocket();
+    if (fd < 0) {
+        Running.store(false);
+        return;
+    }
+    ALOG("ovrTeleopSender: streaming to %s:%i at %i Hz", Host.c_str(), Port, RateHz);
+
+    const int64_t periodNanos = 1000000000ll / RateHz;
+    uint32_t numPackets = 0;
+    uint8_t packet[TELEOP_WIRE_MAX_PACKET_SIZE];
+    ovrTeleopState state;
+    ovrTeleopWireState wireState;
+    ovrTeleopEncoder encoder;
+    encoder.Reset(NextSequence);
+    ovrTeleopPredictor headPredictor;
+    ovrTeleopPredictor controllerPredictors[TELEOP_HAND_MAX];
+    ovrTeleopPredictionParms predictionParms;
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    uint64_t lastSendMicros = 0;
+    uint64_t lastLogMicros = GetTimeMicros();
+
+    while (Running.load(std::memory_order_relaxed)) {
+        AddTime(next, periodNanos);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr) == EINTR) {
+        }
+
+        // if the thread was held off for more than a period, skip the missed ticks instead of
+        // sending a burst of identical packets
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        const int64_t late = DiffTime(now, next);
+        if (late > periodNanos) {
+            const int64_t missed = late / periodNanos;
+            MissedTicks.fetch_add(static_cast<uint32_t>(missed), std::memory_order_relaxed);
+            AddTime(next, missed * periodNanos);
+        }
+
+        State.GetState(state);
+        if (state.PoseTime == 0.0) {
+            continue; // nothing from the render loop yet
+        }
+
+        const uint32_t acked = AckedSequence.load(std::memory_order_relaxed);
+        if (acked != 0) {
+            encoder.Acknowledge(acked);
+        }
+
+        const uint64_t sendMicros = GetTimeMicros();
+
+        // predict to when the robot acts on this packet
+        PredictionParms.GetState(predictionParms);
+        const double targetTime = sendMicros * 1e-6 +
+            RoundTripMicros.load(std::memory_order_relaxed) * 0.5e-6 +
+            predictionParms.ActuatorLagSeconds;
+        state.HeadPose = headPredictor.Predict(state.HeadPose, targetTime, predictionParms);
+        for (int i = 0; i < TELEOP_HAND_MAX; i++) {
+            ovrTeleopControllerState& controller = state.Controllers[i];
+            if (controller.Connected) {
+                controller.Pose =
+                    controllerPredictors[i].Predict(controller.Pose, targetTime, predictionParms);
+            } else {
+                controllerPredictors[i].Reset();
+            }
+        }
+        state.PoseTime = state.HeadPose.TimeInSeconds;
+
+        ToWireState(state, wireState);
+        const int64_t poseOffset = std::max<int64_t>(
+            std::min<int64_t>(
+                static_cast<int64_t>(state.PoseTime * 1e6) - static_cast<int64_t>(sendMicros),
+                INT32_MAX),
+            INT32_MIN);
+        const int size = encoder.Encode(
+            wireState,
+            static_cast<uint32_t>(sendMicros),
+            static_cast<int32_t>(poseOffset),
+            packet,
+            sizeof(packet));
+        if (size <= 0 || send(fd, packet, size, 0) != size) {
+            SendErrors.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            PacketsSent.fetch_add(1, std::memory_order_relaxed);
+            BytesSent.fetch_add(size, std::memory_order_relaxed);
+        }
+        numPackets++;
+
+        if (lastSendMicros != 0) {
+            const int64_t interval = static_cast<int64_t>(sendMicros - lastSendMicros);
+            const uint64_t jitter =
+                static_cast<uint64_t>(std::abs(interval - periodNanos / 1000));
+            JitterSumMicros.fetch_add(jitter, std::memory_order_relaxed);
+            JitterCount.fetch_add(1, std::memory_order_relaxed);
+            if (jitter > JitterMaxMicros.load(std::memory_order_relaxed)) {
+                JitterMaxMicros.store(jitter, std::memory_order_relaxed);
+            }
+        }
+        lastSendMicros = sendMicros;
+
+        if ((sendMicros - lastLogMicros) * 1e-6 > STATS_LOG_INTERVAL_SECONDS) {
+            lastLogMicros = sendMicros;
+            ALOG(
+                "ovrTeleopSender: %u packets, %u send errors, %u missed ticks, max jitter %.0f us",
+                numPackets,
+                SendErrors.load(std::memory_order_relaxed),
+                MissedTicks.load(std::memory_order_relaxed),
+                static_cast<double>(JitterMaxMicros.load(std::memory_order_relaxed)));
+        }
+    }
+
+    close(fd);
+    NextSequence = encoder.GetNextSequence();
+    ALOG("ovrTeleopSender: stopped after %u packets", numPackets);
+}
+
+} // namespace OVRFW
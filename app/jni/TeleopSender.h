@@ -0,0 +1,147 @@
+/************************************************************************************
+
+Filename    :   TeleopSender.h
+Content     :   Streams the operator's head and controller state to the robot over UDP at a
+                fixed rate, from a thread of its own.
+Created     :   October 18, 2026
+Authors     :
+
+Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All rights reserved.
+
+*************************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "OVR_Lockless.h"
+#include "VrApi_Types.h"
+
+#include "TeleopPredictor.h"
+#include "TeleopProtocol.h"
+
+namespace OVRFW {
+
+enum ovrTeleopHand { TELEOP_HAND_LEFT, TELEOP_HAND_RIGHT, TELEOP_HAND_MAX };
+
+struct ovrTeleopControllerState {
+    bool Connected = false;
+    ovrRigidBodyPosef Pose = {};
+    float IndexTrigger = 0.0f;
+    float GripTrigger = 0.0f;
+    ovrVector2f Joystick = {0.0f, 0.0f};
+    uint32_t Buttons = 0; // ovrButton bits
+    uint32_t Touches = 0; // ovrTouch bits
+};
+
+// The most recent operator input, published by the render loop once per frame.
+struct ovrTeleopState {
+    // The vrapi_GetTimeInSeconds() time the poses were predicted for, 0 until the first frame.
+    double PoseTime = 0.0;
+    ovrRigidBodyPosef HeadPose = {};
+    ovrTeleopControllerState Controllers[TELEOP_HAND_MAX];
+};
+
+// Send timing since the last ovrTeleopSender::GetStats() call.
+struct ovrTeleopSenderStats {
+    uint32_t PacketsSent = 0;
+    uint32_t BytesSent = 0;
+    uint32_t SendErrors = 0;
+    uint32_t MissedTicks = 0; // ticks skipped because the thread woke up a whole period late
+    double MeanJitterSeconds = 0.0; // mean |actual send interval - period|
+    double MaxJitterSeconds = 0.0;
+};
+
+//==============================================================
+// ovrTeleopSender
+// The render loop hands its latest state over with SetState(), which only writes one of the
+// two slots of an OVR::LocklessUpdater, so a frame never waits on the network or on the sender
+// thread. The sender thread wakes at absolute times on CLOCK_MONOTONIC, picks up whatever state
+// is newest and sends one datagram per tick, so the robot sees a steady rate regardless of the
+// display rate and of frames that take too long. The socket is non-blocking; a datagram the
+// stack can't take right away is dropped, since the next tick sends newer state anyway.
+//
+// Just before each send, the poses are extrapolated with ovrTeleopPredictor to when the robot is
+// expected to have acted on them: the send time plus half the measured round trip time plus the
+// actuator lag. Only the uplink half of the round trip is between the send and the robot.
+//
+// Packets use the quantized format in TeleopProtocol.h. They are keyframes until the robot
+// acknowledges a sequence number through Acknowledge(), and deltas against the latest
+// acknowledged state after that. Sequence numbers carry on across Stop() and Start(), so a robot
+// that ignores packets older than the newest it has acted on follows a resumed stream at once.
+class ovrTeleopSender {
+   public:
+    ovrTeleopSender();
+    ~ovrTeleopSender();
+
+    // Starts the sender thread streaming to host:port at rateHz. The host name is resolved on
+    // the sender thread.
+    bool Start(const char* host, const int port, const int rateHz);
+    void Stop();
+
+    bool IsRunning() const {
+        return Running.load(std::memory_order_relaxed);
+    }
+
+    // Never blocks; safe to call from the render thread every frame.
+    void SetState(const ovrTeleopState& state) {
+        State.SetState(state);
+    }
+
+    // Returns the stats gathered since the previous call and starts a new window.
+    ovrTeleopSenderStats GetStats();
+
+    // Safe to call from any thread; takes effect on the next tick.
+    void SetPredictionParms(const ovrTeleopPredictionParms& parms) {
+        PredictionParms.SetState(parms);
+    }
+    // The latest measured round trip time to the robot, from any thread.
+    void SetRoundTripTime(const double seconds) {
+        RoundTripMicros.store(static_cast<uint32_t>(seconds * 1e6), std::memory_order_relaxed);
+    }
+
+    // Called with the sequence numbers the robot reports having decoded, from any thread.
+    void Acknowledge(const uint32_t sequence) {
+        AckedSequence.store(sequence, std::memory_order_relaxed);
+    }
+
+    static void ToWireState(const ovrTeleopState& state, ovrTeleopWireState& wire);
+
+    // CLOCK_MONOTONIC in microseconds.
+    static uint64_t GetTimeMicros();
+
+   private:
+    // used until SetRoundTripTime() is called
+    static constexpr double DEFAULT_ROUND_TRIP_SECONDS = 0.01;
+
+    OVR::LocklessUpdater<ovrTeleopState> State;
+    OVR::LocklessUpdater<ovrTeleopPredictionParms> PredictionParms;
+    std::atomic<uint32_t> RoundTripMicros;
+
+    std::string Host;
+    int Port;
+    int RateHz;
+
+    std::thread Thread;
+    std::atomic<bool> Running;
+    // carried over from one Start() to the next, only used by the sender thread
+    uint32_t NextSequence;
+    std::atomic<uint32_t> AckedSequence; // 0 if none
+
+    // written by the sender thread, read and reset by GetStats()
+    std::atomic<uint32_t> PacketsSent;
+    std::atomic<uint32_t> BytesSent;
+    std::atomic<uint32_t> SendErrors;
+    std::atomic<uint32_t> MissedTicks;
+    std::atomic<uint64_t> JitterSumMicros;
+    std::atomic<uint64_t> JitterMaxMicros;
+    std::atomic<uint32_t> JitterCount;
+
+    void SenderThread();
+    int OpenSocket() const;
+};
+
+} // namespace OVRFW
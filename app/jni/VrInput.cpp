@@ -13,11 +13,16 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "ControllerGUI.h"
 
 #include "VrApi.h"
+#include "JniUtils.h"
+
+#include <sys/stat.h>
+#include <errno.h>
 
 #include "GUI/GuiSys.h"
 #include "GUI/GazeCursor.h"
 #include "Locale/OVR_Locale.h"
 #include "Misc/Log.h"
+#include "Render/TextureManager.h"
 
 using OVR::Axis_X;
 using OVR::Axis_Y;
@@ -42,6 +47,10 @@ static const int NUM_RIBBON_POINTS = 32;
 
 static const Vector4f LASER_COLOR(0.0f, 1.0f, 1.0f, 1.0f);
 
+// GPU and CPU memory the GUI's textures may use before unused ones are evicted and the rest
+// drop mip levels. Set before any menu loads a texture, so textures keep the levels to drop to.
+static const size_t GUI_TEXTURE_BUDGET_BYTES = 64 * 1024 * 1024;
+
 static const char* OculusTouchVertexShaderSrc = R"glsl(
 attribute highp vec4 Position;
 attribute highp vec3 Normal;
@@ -304,13 +313,18 @@ ovrVrInput::ovrVrInput(
       ControllerModelOculusQuest2TouchLeft(nullptr),
       ControllerModelOculusQuest2TouchRight(nullptr),
       LastGamepadUpdateTimeInSeconds(0),
+      Menu(nullptr),
       Ribbons{nullptr, nullptr},
       ActiveInputDeviceID(uint32_t(-1)),
-      DeviceType(ovrDeviceType::VRAPI_DEVICE_TYPE_OCULUSQUEST) {}
+      DeviceType(ovrDeviceType::VRAPI_DEVICE_TYPE_OCULUSQUEST),
+      HasTelemetry(false),
+      FrameTimings("VrInput frame") {}
 
 //==============================
 // ovrVrInput::~ovrVrInput
 ovrVrInput::~ovrVrInput() {
+    AssetLoader.Shutdown();
+
     for (int i = 0; i < ovrArmModel::HAND_MAX; ++i) {
         delete Ribbons[i];
         Ribbons[i] = nullptr;
@@ -349,6 +363,27 @@ bool ovrVrInput::AppInit(const OVRFW::ovrAppContext* context) {
         return false;
     }
 
+    // Set up the cache folders before anything builds programs, so the GUI, debug line and
+    // controller programs are loaded from the program binary cache after the first run.
+    {
+        char packageName[ovrFileSys::OVR_MAX_PATH_LEN];
+        ovr_GetCurrentPackageName(jj.Env, jj.ActivityObject, packageName, sizeof(packageName));
+        std::string const cacheFolder = std::string("/data/data/") + packageName + "/cache/";
+        std::string const folder = cacheFolder + "models/";
+        mkdir(cacheFolder.c_str(), 0770);
+        if (mkdir(folder.c_str(), 0770) == 0 || errno == EEXIST) {
+            ModelCacheFolder = folder;
+        } else {
+            ALOGW("Couldn't create model cache folder '%s'", folder.c_str());
+        }
+        std::string const programFolder = cacheFolder + "programs/";
+        if (mkdir(programFolder.c_str(), 0770) == 0 || errno == EEXIST) {
+            GlProgram::SetBinaryCacheFolder(programFolder.c_str());
+        } else {
+            ALOGW("Couldn't create program cache folder '%s'", programFolder.c_str());
+        }
+    }
+
     Locale = ovrLocale::Create(*ctx.Env, ctx.ActivityObject, "default");
     if (nullptr == Locale) {
         ALOGE("Couldn't create Locale");
@@ -378,6 +413,7 @@ bool ovrVrInput::AppInit(const OVRFW::ovrAppContext* context) {
     GetLocale().GetLocalizedString("@string/font_name", "efigs.fnt", fontName);
 
     GuiSys->Init(FileSys, *SoundEffectPlayer, fontName.c_str(), DebugLines);
+    GuiSys->GetTextureManager().SetMemoryBudget(GUI_TEXTURE_BUDGET_BYTES);
 
     static ovrProgramParm OculusTouchUniformParms[] = {
         {"Texture0", ovrProgramParmType::TEXTURE_SAMPLED},
@@ -398,138 +434,48 @@ bool ovrVrInput::AppInit(const OVRFW::ovrAppContext* context) {
         OculusTouchUniformParms,
         sizeof(OculusTouchUniformParms) / sizeof(ovrProgramParm));
 
-    {
-        ModelGlPrograms programs;
-        const char* controllerModelFile =
-            "apk:///assets/oculusQuest_oculusTouch_Left.gltf.ovrscene";
-        programs.ProgSingleTexture = &ProgOculusTouch;
-        programs.ProgBaseColorPBR = &ProgOculusTouch;
-        programs.ProgSkinnedBaseColorPBR = &ProgOculusTouch;
-        programs.ProgLightMapped = &ProgOculusTouch;
-        programs.ProgBaseColorEmissivePBR = &ProgOculusTouch;
-        programs.ProgSkinnedBaseColorEmissivePBR = &ProgOculusTouch;
-        MaterialParms materials;
-        ControllerModelOculusQuestTouchLeft =
-            LoadModelFile(GuiSys->GetFileSys(), controllerModelFile, programs, materials);
-
-        if (ControllerModelOculusQuestTouchLeft == NULL ||
-            static_cast<int>(ControllerModelOculusQuestTouchLeft->Models.size()) < 1) {
-            ALOGE_FAIL("Couldn't load Oculus Touch for Oculus Quest Controller left model");
-        }
-
-        for (auto& model : ControllerModelOculusQuestTouchLeft->Models) {
-            auto& gc = model.surfaces[0].surfaceDef.graphicsCommand;
-            gc.UniformData[0].Data = &gc.Textures[0];
-            gc.UniformData[1].Data = &SpecularLightDirection;
-            gc.UniformData[2].Data = &SpecularLightColor;
-            gc.UniformData[3].Data = &AmbientLightColor;
-            gc.UniformData[4].Data = &gc.Textures[1];
-        }
-    }
-    {
-        ModelGlPrograms programs;
-        const char* controllerModelFile =
-            "apk:///assets/oculusQuest_oculusTouch_Right.gltf.ovrscene";
-        programs.ProgSingleTexture = &ProgOculusTouch;
-        programs.ProgBaseColorPBR = &ProgOculusTouch;
-        programs.ProgSkinnedBaseColorPBR = &ProgOculusTouch;
-        programs.ProgLightMapped = &ProgOculusTouch;
-        programs.ProgBaseColorEmissivePBR = &ProgOculusTouch;
-        programs.ProgSkinnedBaseColorEmissivePBR = &ProgOculusTouch;
-        MaterialParms materials;
-        ControllerModelOculusQuestTouchRight =
-            LoadModelFile(GuiSys->GetFileSys(), controllerModelFile, programs, materials);
-
-        if (ControllerModelOculusQuestTouchRight == NULL ||
-            static_cast<int>(ControllerModelOculusQuestTouchRight->Models.size()) < 1) {
-            ALOGE_FAIL(
-                "Couldn't load Oculus Touch for Oculus Quest Controller Controller right model");
-        }
-
-        for (auto& model : ControllerModelOculusQuestTouchRight->Models) {
-            auto& gc = model.surfaces[0].surfaceDef.graphicsCommand;
-            gc.UniformData[0].Data = &gc.Textures[0];
-            gc.UniformData[1].Data = &SpecularLightDirection;
-            gc.UniformData[2].Data = &SpecularLightColor;
-            gc.UniformData[3].Data = &AmbientLightColor;
-            gc.UniformData[4].Data = &gc.Textures[1];
-        }
-    }
-
-    {
-        ModelGlPrograms programs;
-        const char* controllerModelFile =
-            "apk:///assets/oculusQuest2_oculusTouch_Left.gltf.ovrscene";
-        programs.ProgSingleTexture = &ProgOculusTouch;
-        programs.ProgBaseColorPBR = &ProgOculusTouch;
-        programs.ProgSkinnedBaseColorPBR = &ProgOculusTouch;
-        programs.ProgLightMapped = &ProgOculusTouch;
-        programs.ProgBaseColorEmissivePBR = &ProgOculusTouch;
-        programs.ProgSkinnedBaseColorEmissivePBR = &ProgOculusTouch;
-        MaterialParms materials;
-        ControllerModelOculusQuest2TouchLeft =
-            LoadModelFile(GuiSys->GetFileSys(), controllerModelFile, programs, materials);
-
-        if (ControllerModelOculusQuest2TouchLeft == NULL ||
-            static_cast<int>(ControllerModelOculusQuest2TouchLeft->Models.size()) < 1) {
-            ALOGE_FAIL("Couldn't load Oculus Touch for Oculus Quest Controller left model");
-        }
-
-        for (auto& model : ControllerModelOculusQuest2TouchLeft->Models) {
-            auto& gc = model.surfaces[0].surfaceDef.graphicsCommand;
-            gc.UniformData[0].Data = &gc.Textures[0];
-            gc.UniformData[1].Data = &SpecularLightDirection;
-            gc.UniformData[2].Data = &SpecularLightColor;
-            gc.UniformData[3].Data = &AmbientLightColor;
-            gc.UniformData[4].Data = &gc.Textures[1];
-        }
-    }
-    {
-        ModelGlPrograms programs;
-        const char* controllerModelFile =
-            "apk:///assets/oculusQuest2_oculusTouch_Right.gltf.ovrscene";
-        programs.ProgSingleTexture = &ProgOculusTouch;
-        programs.ProgBaseColorPBR = &ProgOculusTouch;
-        programs.ProgSkinnedBaseColorPBR = &ProgOculusTouch;
-        programs.ProgLightMapped = &ProgOculusTouch;
-        programs.ProgBaseColorEmissivePBR = &ProgOculusTouch;
-        programs.ProgSkinnedBaseColorEmissivePBR = &ProgOculusTouch;
-        MaterialParms materials;
-        ControllerModelOculusQuest2TouchRight =
-            LoadModelFile(GuiSys->GetFileSys(), controllerModelFile, programs, materials);
-
-        if (ControllerModelOculusQuest2TouchRight == NULL ||
-            static_cast<int>(ControllerModelOculusQuest2TouchRight->Models.size()) < 1) {
-            ALOGE_FAIL(
-                "Couldn't load Oculus Touch for Oculus Quest Controller Controller right model");
-        }
-
-        for (auto& model : ControllerModelOculusQuest2TouchRight->Models) {
-            auto& gc = model.surfaces[0].surfaceDef.graphicsCommand;
-            gc.UniformData[0].Data = &gc.Textures[0];
-            gc.UniformData[1].Data = &SpecularLightDirection;
-            gc.UniformData[2].Data = &SpecularLightColor;
-            gc.UniformData[3].Data = &AmbientLightColor;
-            gc.UniformData[4].Data = &gc.Textures[1];
-        }
-    }
+    // The controller and scene models finish loading over the first few frames; the controller
+    // surfaces are filled in by SetControllerSurfaces() once they arrive.
+    AssetLoader.Init();
+
+    LoadControllerModelAsync(
+        "apk:///assets/oculusQuest_oculusTouch_Left.gltf.ovrscene",
+        &ControllerModelOculusQuestTouchLeft);
+    LoadControllerModelAsync(
+        "apk:///assets/oculusQuest_oculusTouch_Right.gltf.ovrscene",
+        &ControllerModelOculusQuestTouchRight);
+    LoadControllerModelAsync(
+        "apk:///assets/oculusQuest2_oculusTouch_Left.gltf.ovrscene",
+        &ControllerModelOculusQuest2TouchLeft);
+    LoadControllerModelAsync(
+        "apk:///assets/oculusQuest2_oculusTouch_Right.gltf.ovrscene",
+        &ControllerModelOculusQuest2TouchRight);
 
     {
         MaterialParms materialParms;
         materialParms.UseSrgbTextureFormats = false;
+        materialParms.CompactVertices = true;
+        materialParms.OptimizeMeshes = true;
         const char* sceneUri = "apk:///assets/box.ovrscene";
-        SceneModel = LoadModelFile(
-            GuiSys->GetFileSys(), sceneUri, Scene.GetDefaultGLPrograms(), materialParms);
-
-        if (SceneModel != nullptr) {
-            Scene.SetWorldModel(*SceneModel);
-            Vector3f modelOffset;
-            modelOffset.x = 0.5f;
-            modelOffset.y = 0.0f;
-            modelOffset.z = -2.25f;
-            Scene.GetWorldModel()->State.SetMatrix(
-                Matrix4f::Scaling(2.5f, 2.5f, 2.5f) * Matrix4f::Translation(modelOffset));
-        }
+        LoadModelFileAsync(
+            AssetLoader,
+            GuiSys->GetFileSys(),
+            sceneUri,
+            Scene.GetDefaultGLPrograms(),
+            materialParms,
+            [this](ModelFile* model) {
+                SceneModel = model;
+                if (SceneModel != nullptr) {
+                    Scene.SetWorldModel(*SceneModel);
+                    Vector3f modelOffset;
+                    modelOffset.x = 0.5f;
+                    modelOffset.y = 0.0f;
+                    modelOffset.z = -2.25f;
+                    Scene.GetWorldModel()->State.SetMatrix(
+                        Matrix4f::Scaling(2.5f, 2.5f, 2.5f) * Matrix4f::Translation(modelOffset));
+                }
+            },
+            GetModelCachePath(sceneUri).c_str());
     }
 
     //------------------------------------------------------------------------------------------
@@ -580,6 +526,103 @@ bool ovrVrInput::AppInit(const OVRFW::ovrAppContext* context) {
     return true;
 }
 
+//==============================
+// ovrVrInput::LoadControllerModelAsync
+void ovrVrInput::LoadControllerModelAsync(const char* uri, ModelFile** outModel) {
+    ModelGlPrograms programs;
+    programs.ProgSingleTexture = &ProgOculusTouch;
+    programs.ProgBaseColorPBR = &ProgOculusTouch;
+    programs.ProgSkinnedBaseColorPBR = &ProgOculusTouch;
+    programs.ProgLightMapped = &ProgOculusTouch;
+    programs.ProgBaseColorEmissivePBR = &ProgOculusTouch;
+    programs.ProgSkinnedBaseColorEmissivePBR = &ProgOculusTouch;
+    MaterialParms materials;
+    materials.CompactVertices = true;
+    materials.OptimizeMeshes = true;
+    std::string const uriString = uri;
+    LoadModelFileAsync(
+        AssetLoader,
+        GuiSys->GetFileSys(),
+        uri,
+        programs,
+        materials,
+        [this, uriString, outModel](ModelFile* model) {
+            if (model == nullptr || static_cast<int>(model->Models.size()) < 1) {
+                ALOGE_FAIL("Couldn't load controller model '%s'", uriString.c_str());
+                return;
+            }
+
+            for (auto& m : model->Models) {
+                auto& gc = m.surfaces[0].surfaceDef.graphicsCommand;
+                gc.UniformData[0].Data = &gc.Textures[0];
+                gc.UniformData[1].Data = &SpecularLightDirection;
+                gc.UniformData[2].Data = &SpecularLightColor;
+                gc.UniformData[3].Data = &AmbientLightColor;
+                gc.UniformData[4].Data = &gc.Textures[1];
+            }
+            *outModel = model;
+
+            // controllers that connected before their model arrived
+            for (ovrInputDeviceBase* device : InputDevices) {
+                if (device != nullptr && device->GetType() == ovrControllerType_TrackedRemote) {
+                    SetControllerSurfaces(*static_cast<ovrInputDevice_TrackedRemote*>(device));
+                }
+            }
+        },
+        GetModelCachePath(uri).c_str());
+}
+
+//==============================
+// ovrVrInput::GetModelCachePath
+std::string ovrVrInput::GetModelCachePath(const char* uri) const {
+    if (ModelCacheFolder.empty()) {
+        return std::string();
+    }
+    // one flat folder, so fold the uri into a file name
+    std::string name = uri;
+    for (char& c : name) {
+        if (c == '/' || c == ':') {
+            c = '_';
+        }
+    }
+    return ModelCacheFolder + name + ".cooked";
+}
+
+//==============================
+// ovrVrInput::SetControllerSurfaces
+void ovrVrInput::SetControllerSurfaces(ovrInputDevice_TrackedRemote& trDevice) {
+    ModelFile* modelFile = ControllerModelOculusQuestTouchLeft;
+
+    if (trDevice.GetTrackedRemoteCaps().ControllerCapabilities &
+        ovrControllerCaps_ModelOculusTouch) {
+        if (DeviceType >= VRAPI_DEVICE_TYPE_OCULUSQUEST2_START &&
+            DeviceType <= VRAPI_DEVICE_TYPE_OCULUSQUEST2_END) {
+            if (trDevice.GetHand() == ovrArmModel::HAND_LEFT) {
+                modelFile = ControllerModelOculusQuest2TouchLeft;
+            } else {
+                modelFile = ControllerModelOculusQuest2TouchRight;
+            }
+        } else {
+            if (trDevice.GetHand() == ovrArmModel::HAND_LEFT) {
+                modelFile = ControllerModelOculusQuestTouchLeft;
+            } else {
+                modelFile = ControllerModelOculusQuestTouchRight;
+            }
+        }
+    }
+
+    std::vector<ovrDrawSurface>& controllerSurfaces = trDevice.GetControllerSurfaces();
+    controllerSurfaces.clear();
+    if (modelFile == nullptr) {
+        return; // still loading
+    }
+    for (auto& model : modelFile->Models) {
+        ovrDrawSurface controllerSurface;
+        controllerSurface.surface = &(model.surfaces[0].surfaceDef);
+        controllerSurfaces.push_back(controllerSurface);
+    }
+}
+
 //==============================
 // ovrVrInput::ResetLaserPointer
 void ovrVrInput::ResetLaserPointer() {
@@ -600,6 +643,11 @@ void ovrVrInput::ResetLaserPointer() {
 // ovrVrInput::AppShutdown
 void ovrVrInput::AppShutdown(const OVRFW::ovrAppContext* context) {
     ALOG("AppShutdown");
+    FrameTimings.Report(); // the frames since the last periodic report
+    TelemetryReceiver.Stop();
+    TeleopSender.Stop();
+    AssetLoader.Shutdown();
+
     for (int i = InputDevices.size() - 1; i >= 0; --i) {
         OnDeviceDisconnected(InputDevices[i]->GetDeviceID());
     }
@@ -671,13 +719,13 @@ void ovrVrInput::RenderRunningFrame(
 
     //------------------------------------------------------------------------------------------
 
-    const ovrJava* java = reinterpret_cast<const ovrJava*>(GetContext()->ContextForVrApi());
+    // all input comes from the snapshot ovrAppl captured at the start of the frame
+    assert(in.Input != nullptr);
+    const ovrInputSnapshot& input = *in.Input;
 
-    EnumerateInputDevices();
+    EnumerateInputDevices(input);
     bool hasActiveController = false;
-    int iActiveInputDeviceID;
-    vrapi_GetPropertyInt(java, VRAPI_ACTIVE_INPUT_DEVICE_ID, &iActiveInputDeviceID);
-    ActiveInputDeviceID = (uint32_t)iActiveInputDeviceID;
+    ActiveInputDeviceID = input.GetActiveInputDeviceID();
 
     ClearAndHideMenuItems();
 
@@ -699,13 +747,12 @@ void ovrVrInput::RenderRunningFrame(
                 *static_cast<ovrInputDevice_TrackedRemote*>(device);
 
             if (deviceID != ovrDeviceIdType_Invalid) {
-                ovrTracking remoteTracking;
-                ovrResult result = vrapi_GetInputTrackingState(
-                    GetSessionObject(), deviceID, in.PredictedDisplayTime, &remoteTracking);
-                if (result != ovrSuccess) {
+                const ovrInputDeviceSnapshot* snapshot = input.FindDevice(deviceID);
+                if (snapshot == nullptr || !snapshot->TrackingValid) {
                     OnDeviceDisconnected(deviceID);
                     continue;
                 }
+                const ovrTracking& remoteTracking = snapshot->Tracking;
 
                 trDevice.SetTracking(remoteTracking);
 
@@ -715,7 +762,7 @@ void ovrVrInput::RenderRunningFrame(
                 Quatf r(remoteTracking.HeadPose.Pose.Orientation);
                 r.GetEulerAngles<Axis_Y, Axis_X, Axis_Z>(&yaw, &pitch, &roll);
                 trDevice.IsActiveInputDevice = (trDevice.GetDeviceID() == ActiveInputDeviceID);
-                result = PopulateRemoteControllerInfo(trDevice);
+                const ovrResult result = PopulateRemoteControllerInfo(trDevice, input, *snapshot);
 
                 if (result == ovrSuccess) {
                     if (trDevice.IsActiveInputDevice) {
@@ -730,6 +777,20 @@ void ovrVrInput::RenderRunningFrame(
         }
     }
 
+    PublishTeleopState(in);
+
+    if (TelemetryReceiver.GetLatest(LatestTelemetry)) {
+        HasTelemetry = true;
+    }
+    if (Menu != nullptr) {
+        Menu->UpdateTelemetry(
+            *GuiSys,
+            HasTelemetry ? &LatestTelemetry : nullptr,
+            TelemetryReceiver,
+            ovrTeleopSender::GetTimeMicros());
+    }
+    FrameTimings.EndPhase("input");
+
     //------------------------------------------------------------------------------------------
 
     // if the orientation is tracked by the headset, don't allow the gamepad to rotate the view
@@ -746,6 +807,7 @@ void ovrVrInput::RenderRunningFrame(
 
     Scene.GetFrameMatrices(SuggestedEyeFovDegreesX, SuggestedEyeFovDegreesY, out.FrameMatrices);
     Scene.GenerateFrameSurfaceList(out.FrameMatrices, out.Surfaces);
+    FrameTimings.EndPhase("scene");
 
     //------------------------------------------------------------------------------------------
     // calculate the controller pose from the most recent scene pose
@@ -755,6 +817,7 @@ void ovrVrInput::RenderRunningFrame(
     // loop through all devices to update controller arm models and place the pointer for the
     // dominant hand
     Matrix4f traceMat(out.FrameMatrices.CenterView.Inverted());
+    const float forceFeedback = GetForceFeedback();
     for (int i = (int)InputDevices.size() - 1; i >= 0; --i) {
         ovrInputDeviceBase* device = InputDevices[i];
         if (device == nullptr) {
@@ -779,7 +842,7 @@ void ovrVrInput::RenderRunningFrame(
                 controllerSurfaces[k].modelMatrix = mat;
             }
 
-            trDevice.UpdateHaptics(GetSessionObject(), in);
+            trDevice.UpdateHaptics(GetSessionObject(), in, forceFeedback);
 
             // only do the trace for the user's dominant hand
             bool updateLaser = trDevice.IsActiveInputDevice;
@@ -806,6 +869,7 @@ void ovrVrInput::RenderRunningFrame(
             }
         }
     }
+    FrameTimings.EndPhase("controllers");
     //------------------------------------------------------------------------------------------
 
     //------------------------------------------------------------------------------------------
@@ -892,12 +956,15 @@ void ovrVrInput::RenderRunningFrame(
     } else {
         ResetLaserPointer();
     }
+    FrameTimings.EndPhase("laser");
 
     GuiSys->Frame(in, out.FrameMatrices.CenterView, traceMat);
+    FrameTimings.EndPhase("gui");
 
     // since we don't delete any lines, we don't need to run its frame at all
     RemoteBeamRenderer->Frame(in, out.FrameMatrices.CenterView, *BeamAtlas);
     ParticleSystem->Frame(in, SpriteAtlas, out.FrameMatrices.CenterView);
+    FrameTimings.EndPhase("particles");
 
     GuiSys->AppendSurfaceList(out.FrameMatrices.CenterView, &out.Surfaces);
 
@@ -929,6 +996,7 @@ void ovrVrInput::RenderRunningFrame(
     const Matrix4f projectionMatrix;
     ParticleSystem->RenderEyeView(out.FrameMatrices.CenterView, projectionMatrix, out.Surfaces);
     RemoteBeamRenderer->RenderEyeView(out.FrameMatrices.CenterView, projectionMatrix, out.Surfaces);
+    FrameTimings.EndPhase("surfaces");
 }
 
 void ovrVrInput::AppRenderEye(
@@ -944,6 +1012,12 @@ void ovrVrInput::AppRenderEye(
 }
 
 void ovrVrInput::AppRenderFrame(const OVRFW::ovrApplFrameIn& in, OVRFW::ovrRendererOutput& out) {
+    FrameTimings.BeginFrame();
+
+    // finish any loads whose CPU work is done, without hitching the frame
+    AssetLoader.Update(ASSET_UPLOAD_BUDGET_SECONDS);
+    FrameTimings.EndPhase("assets");
+
     switch (RenderState) {
         case RENDER_STATE_LOADING: {
             DefaultRenderFrame_Loading(in, out);
@@ -953,6 +1027,64 @@ void ovrVrInput::AppRenderFrame(const OVRFW::ovrApplFrameIn& in, OVRFW::ovrRende
             DefaultRenderFrame_Running(in, out);
         } break;
     }
+    FrameTimings.EndPhase("render");
+    FrameTimings.EndFrame();
+}
+
+//==============================
+// ovrVrInput::PublishTeleopState
+// Hands the poses and input sampled this frame to the teleop sender thread.
+void ovrVrInput::PublishTeleopState(const OVRFW::ovrApplFrameIn& in) {
+    ovrTeleopState state;
+    state.PoseTime = in.PredictedDisplayTime;
+    state.HeadPose = Tracking.HeadPose;
+    state.HeadPose.TimeInSeconds = in.PredictedDisplayTime;
+
+    for (ovrInputDeviceBase* device : InputDevices) {
+        if (device == nullptr || device->GetType() != ovrControllerType_TrackedRemote) {
+            continue;
+        }
+        const ovrInputDevice_TrackedRemote& trDevice =
+            *static_cast<const ovrInputDevice_TrackedRemote*>(device);
+        const ovrInputStateTrackedRemote& inputState = trDevice.GetInputState();
+
+        ovrTeleopControllerState& controller =
+            state.Controllers[trDevice.GetHand() == ovrArmModel::HAND_LEFT ? TELEOP_HAND_LEFT
+                                                                            : TELEOP_HAND_RIGHT];
+        controller.Connected = true;
+        controller.Pose = trDevice.GetTracking().HeadPose;
+        // the controllers were sampled for the same display time as the head
+        controller.Pose.TimeInSeconds = in.PredictedDisplayTime;
+        controller.IndexTrigger = inputState.IndexTrigger;
+        controller.GripTrigger = inputState.GripTrigger;
+        controller.Joystick = inputState.Joystick;
+        controller.Buttons = inputState.Buttons;
+        controller.Touches = inputState.Touches;
+    }
+
+    TeleopSender.SetState(state);
+}
+
+//==============================
+// ovrVrInput::GetForceFeedback
+// The haptic intensity for the load on the robot's servos, 0 without recent telemetry.
+float ovrVrInput::GetForceFeedback() const {
+    if (!HasTelemetry) {
+        return 0.0f;
+    }
+    const uint64_t now = ovrTeleopSender::GetTimeMicros();
+    if (now > LatestTelemetry.ReceiveTimeMicros &&
+        (now - LatestTelemetry.ReceiveTimeMicros) * 1e-6 > FORCE_FEEDBACK_STALE_SECONDS) {
+        return 0.0f;
+    }
+    const ovrTeleopTelemetry& telemetry = LatestTelemetry.Telemetry;
+    float amps = 0.0f;
+    for (int i = 0; i < telemetry.NumServos && i < TELEMETRY_MAX_SERVOS; ++i) {
+        amps = telemetry.ServoCurrentAmps[i] > amps ? telemetry.ServoCurrentAmps[i] : amps;
+    }
+    const float intensity =
+        (amps - FORCE_FEEDBACK_MIN_AMPS) / (FORCE_FEEDBACK_MAX_AMPS - FORCE_FEEDBACK_MIN_AMPS);
+    return intensity < 0.0f ? 0.0f : (intensity > 1.0f ? 1.0f : intensity);
 }
 
 void ovrVrInput::ClearAndHideMenuItems() {
@@ -1050,28 +1182,25 @@ void ovrVrInput::ClearAndHideMenuItems() {
     SetObjectVisible(*GuiSys, Menu, "tertiary_input_header", false);
 }
 
-ovrResult ovrVrInput::PopulateRemoteControllerInfo(ovrInputDevice_TrackedRemote& trDevice) {
+ovrResult ovrVrInput::PopulateRemoteControllerInfo(
+    ovrInputDevice_TrackedRemote& trDevice,
+    const ovrInputSnapshot& input,
+    const ovrInputDeviceSnapshot& snapshot) {
     ovrDeviceID deviceID = trDevice.GetDeviceID();
 
     const ovrArmModel::ovrHandedness controllerHand = trDevice.GetHand();
 
-    const ovrJava* java = reinterpret_cast<const ovrJava*>(GetContext()->ContextForVrApi());
-    ovrArmModel::ovrHandedness dominantHand =
-        vrapi_GetSystemPropertyInt(java, VRAPI_SYS_PROP_DOMINANT_HAND) == VRAPI_HAND_LEFT
+    ovrArmModel::ovrHandedness dominantHand = input.GetDominantHand() == VRAPI_HAND_LEFT
         ? ovrArmModel::HAND_LEFT
         : ovrArmModel::HAND_RIGHT;
 
-    ovrInputStateTrackedRemote remoteInputState;
-    remoteInputState.Header.ControllerType = trDevice.GetType();
-
-    ovrResult result;
-    result = vrapi_GetCurrentInputState(GetSessionObject(), deviceID, &remoteInputState.Header);
-
-    if (result != ovrSuccess) {
-        ALOG("ERROR %i getting remote input state!", result);
+    if (!snapshot.StateValid) {
+        ALOG("ERROR getting remote input state!");
         OnDeviceDisconnected(deviceID);
-        return result;
+        return ovrError_DeviceUnavailable;
     }
+    const ovrInputStateTrackedRemote& remoteInputState = snapshot.RemoteState;
+    trDevice.SetInputState(remoteInputState);
 
     std::string headerObjectName;
     std::string triggerObjectName;
@@ -1519,7 +1648,7 @@ ovrResult ovrVrInput::PopulateRemoteControllerInfo(ovrInputDevice_TrackedRemote&
         "Battery: %d",
         remoteInputState.BatteryPercentRemaining);
 
-    return result;
+    return ovrSuccess;
 }
 
 //---------------------------------------------------------------------------------------------------
@@ -1559,69 +1688,33 @@ bool ovrVrInput::IsDeviceTracked(const ovrDeviceID deviceID) const {
 
 //==============================
 // ovrVrInput::EnumerateInputDevices
-void ovrVrInput::EnumerateInputDevices() {
-    for (uint32_t deviceIndex = 0;; deviceIndex++) {
-        ovrInputCapabilityHeader curCaps;
-
-        if (vrapi_EnumerateInputDevices(GetSessionObject(), deviceIndex, &curCaps) < 0) {
-            // ALOG( "Input - No more devices!" );
-            break; // no more devices
-        }
-
-        if (!IsDeviceTracked(curCaps.DeviceID)) {
+void ovrVrInput::EnumerateInputDevices(const ovrInputSnapshot& input) {
+    for (int i = 0; i < input.GetNumDevices(); ++i) {
+        const ovrInputDeviceSnapshot& device = input.GetDevice(i);
+        if (!IsDeviceTracked(device.Header.DeviceID)) {
             ALOG("Input -      tracked");
-            OnDeviceConnected(curCaps);
+            OnDeviceConnected(device);
         }
     }
 }
 
 //==============================
 // ovrVrInput::OnDeviceConnected
-void ovrVrInput::OnDeviceConnected(const ovrInputCapabilityHeader& capsHeader) {
+void ovrVrInput::OnDeviceConnected(const ovrInputDeviceSnapshot& snapshot) {
+    const ovrInputCapabilityHeader& capsHeader = snapshot.Header;
     ovrInputDeviceBase* device = nullptr;
-    ovrResult result = ovrError_NotInitialized;
+    const ovrResult result = snapshot.CapsValid ? ovrResult(ovrSuccess) : ovrError_NotInitialized;
     switch (capsHeader.Type) {
         case ovrControllerType_TrackedRemote: {
             ALOG("Controller connected, ID = %u", capsHeader.DeviceID);
 
-            ovrInputTrackedRemoteCapabilities remoteCapabilities;
-            remoteCapabilities.Header = capsHeader;
-            result =
-                vrapi_GetInputDeviceCapabilities(GetSessionObject(), &remoteCapabilities.Header);
-            if (result == ovrSuccess) {
-                device =
-                    ovrInputDevice_TrackedRemote::Create(*this, *GuiSys, *Menu, remoteCapabilities);
+            const ovrInputTrackedRemoteCapabilities& remoteCapabilities = snapshot.RemoteCaps;
+            // a remote that can't report its input state isn't usable yet
+            if (result == ovrSuccess && snapshot.StateValid) {
+                device = ovrInputDevice_TrackedRemote::Create(*GuiSys, *Menu, remoteCapabilities);
 
                 // populate model surfaces.
-                ovrInputDevice_TrackedRemote& trDevice =
-                    *static_cast<ovrInputDevice_TrackedRemote*>(device);
-                std::vector<ovrDrawSurface>& controllerSurfaces = trDevice.GetControllerSurfaces();
-                ModelFile* modelFile = ControllerModelOculusQuestTouchLeft;
-
-                if (trDevice.GetTrackedRemoteCaps().ControllerCapabilities &
-                    ovrControllerCaps_ModelOculusTouch) {
-                    if (DeviceType >= VRAPI_DEVICE_TYPE_OCULUSQUEST2_START &&
-                        DeviceType <= VRAPI_DEVICE_TYPE_OCULUSQUEST2_END) {
-                        if (trDevice.GetHand() == ovrArmModel::HAND_LEFT) {
-                            modelFile = ControllerModelOculusQuest2TouchLeft;
-                        } else {
-                            modelFile = ControllerModelOculusQuest2TouchRight;
-                        }
-                    } else {
-                        if (trDevice.GetHand() == ovrArmModel::HAND_LEFT) {
-                            modelFile = ControllerModelOculusQuestTouchLeft;
-                        } else {
-                            modelFile = ControllerModelOculusQuestTouchRight;
-                        }
-                    }
-                }
-
-                controllerSurfaces.clear();
-                for (auto& model : modelFile->Models) {
-                    ovrDrawSurface controllerSurface;
-                    controllerSurface.surface = &(model.surfaces[0].surfaceDef);
-                    controllerSurfaces.push_back(controllerSurface);
-                }
+                SetControllerSurfaces(*static_cast<ovrInputDevice_TrackedRemote*>(device));
 
                 // reflect the device type in the UI
                 VRMenuObject* header = Menu->ObjectForName(*GuiSys, "primary_input_header");
@@ -1635,12 +1728,8 @@ void ovrVrInput::OnDeviceConnected(const ovrInputCapabilityHeader& capsHeader) {
             break;
         }
         case ovrControllerType_StandardPointer: {
-            ovrInputStandardPointerCapabilities standardPointerCapabilities;
-            standardPointerCapabilities.Header = capsHeader;
-            result = vrapi_GetInputDeviceCapabilities(
-                GetSessionObject(), &standardPointerCapabilities.Header);
             if (result == ovrSuccess) {
-                device = new ovrInputDevice_StandardPointer(standardPointerCapabilities);
+                device = new ovrInputDevice_StandardPointer(snapshot.PointerCaps);
             }
             break;
         }
@@ -1671,155 +1760,82 @@ void ovrVrInput::OnDeviceDisconnected(const ovrDeviceID deviceID) {
 void ovrVrInput::AppResumed(const OVRFW::ovrAppContext* /* context */) {
     ALOGV("ovrVrInput::AppResumed");
     RenderState = RENDER_STATE_RUNNING;
+    TeleopSender.Start(TELEOP_HOST, TELEOP_PORT, TELEOP_RATE_HZ);
+    TelemetryReceiver.Start(TELEMETRY_PORT, &TeleopSender);
 }
 
 void ovrVrInput::AppPaused(const OVRFW::ovrAppContext* /* context */) {
     ALOGV("ovrVrInput::AppPaused");
+    // the robot should not keep following a headset that was taken off
+    TelemetryReceiver.Stop();
+    TeleopSender.Stop();
 }
 
 //==============================
 // ovrInputDevice_TrackedRemote::Create
 ovrInputDeviceBase* ovrInputDevice_TrackedRemote::Create(
-    OVRFW::ovrAppl& app,
     OvrGuiSys& guiSys,
     VRMenu& menu,
     const ovrInputTrackedRemoteCapabilities& remoteCapabilities) {
     ALOG("ovrInputDevice_TrackedRemote::Create");
 
-    ovrInputStateTrackedRemote remoteInputState;
-    remoteInputState.Header.ControllerType = remoteCapabilities.Header.Type;
-    ovrResult result = vrapi_GetCurrentInputState(
-        app.GetSessionObject(), remoteCapabilities.Header.DeviceID, &remoteInputState.Header);
-    if (result == ovrSuccess) {
-        ovrInputDevice_TrackedRemote* device = new ovrInputDevice_TrackedRemote(remoteCapabilities);
+    ovrInputDevice_TrackedRemote* device = new ovrInputDevice_TrackedRemote(remoteCapabilities);
 
-        ovrArmModel::ovrHandedness controllerHand = ovrArmModel::HAND_RIGHT;
-        if ((remoteCapabilities.ControllerCapabilities & ovrControllerCaps_LeftHand) != 0) {
-            controllerHand = ovrArmModel::HAND_LEFT;
-        }
-
-        char const* handStr = controllerHand == ovrArmModel::HAND_LEFT ? "left" : "right";
-        ALOG(
-            "Controller caps: hand = %s, Button %x, Controller %x, MaxX %d, MaxY %d, SizeX %f SizeY %f",
-            handStr,
-            remoteCapabilities.ButtonCapabilities,
-            remoteCapabilities.ControllerCapabilities,
-            remoteCapabilities.TrackpadMaxX,
-            remoteCapabilities.TrackpadMaxY,
-            remoteCapabilities.TrackpadSizeX,
-            remoteCapabilities.TrackpadSizeY);
-
-        device->HapticState = 0;
-        device->HapticsSimpleValue = 0.0f;
-
-        return device;
-    } else {
-        ALOG("vrapi_GetCurrentInputState: Error %i", result);
+    ovrArmModel::ovrHandedness controllerHand = ovrArmModel::HAND_RIGHT;
+    if ((remoteCapabilities.ControllerCapabilities & ovrControllerCaps_LeftHand) != 0) {
+        controllerHand = ovrArmModel::HAND_LEFT;
     }
 
-    return nullptr;
-}
+    char const* handStr = controllerHand == ovrArmModel::HAND_LEFT ? "left" : "right";
+    ALOG(
+        "Controller caps: hand = %s, Button %x, Controller %x, MaxX %d, MaxY %d, SizeX %f SizeY %f",
+        handStr,
+        remoteCapabilities.ButtonCapabilities,
+        remoteCapabilities.ControllerCapabilities,
+        remoteCapabilities.TrackpadMaxX,
+        remoteCapabilities.TrackpadMaxY,
+        remoteCapabilities.TrackpadSizeX,
+        remoteCapabilities.TrackpadSizeY);
 
-enum HapticStates {
-    HAPTICS_NONE = 0,
-    HAPTICS_BUFFERED = 1,
-    HAPTICS_SIMPLE = 2,
-    HAPTICS_SIMPLE_CLICKED = 3
-};
+    return device;
+}
 
 //==============================
-// ovrInputDevice_TrackedRemote::Create
-void ovrInputDevice_TrackedRemote::UpdateHaptics(ovrMobile* ovr, const ovrApplFrameIn& vrFrame) {
-    if (GetTrackedRemoteCaps().ControllerCapabilities &
-            ovrControllerCaps_HasSimpleHapticVibration ||
-        GetTrackedRemoteCaps().ControllerCapabilities &
-            ovrControllerCaps_HasBufferedHapticVibration) {
-        ovrResult result;
-        ovrInputStateTrackedRemote remoteInputState;
-        remoteInputState.Header.ControllerType = GetType();
-        result = vrapi_GetCurrentInputState(ovr, GetDeviceID(), &remoteInputState.Header);
-
-        bool gripDown = (remoteInputState.Buttons & ovrButton_GripTrigger) > 0;
-        bool trigDown = (remoteInputState.Buttons & ovrButton_A) > 0;
-        trigDown |= (remoteInputState.Buttons & ovrButton_Trigger) > 0;
-        bool touchDown = remoteInputState.TrackpadStatus;
-        bool touchClicked = (remoteInputState.Buttons & ovrButton_Enter ||
-                             remoteInputState.Buttons & ovrButton_Joystick) > 0;
-
-        const int maxSamples = GetTrackedRemoteCaps().HapticSamplesMax;
-
-        if (gripDown && (touchDown || touchClicked)) {
-            if (trigDown) {
-                if (GetTrackedRemoteCaps().ControllerCapabilities &
-                    ovrControllerCaps_HasBufferedHapticVibration) {
-                    // buffered haptics
-                    float intensity = 0.0f;
-                    intensity = fmodf(vrFrame.PredictedDisplayTime, 1.0f);
-
-                    ovrHapticBuffer hapticBuffer;
-                    uint8_t dataBuffer[maxSamples];
-                    hapticBuffer.BufferTime = vrFrame.PredictedDisplayTime;
-                    hapticBuffer.NumSamples = maxSamples;
-                    hapticBuffer.HapticBuffer = dataBuffer;
-                    hapticBuffer.Terminated = false;
-
-                    for (int i = 0; i < maxSamples; i++) {
-                        dataBuffer[i] = intensity * 255;
-                        intensity += (float)GetTrackedRemoteCaps().HapticSampleDurationMS * 0.001f;
-                        intensity = fmodf(intensity, 1.0f);
-                    }
-
-                    vrapi_SetHapticVibrationBuffer(ovr, GetDeviceID(), &hapticBuffer);
-                    HapticState = HAPTICS_BUFFERED;
-                } else {
-                    ALOG("Device does not support buffered haptics?");
-                }
-
-            } else {
-                // simple haptics
-                if (touchClicked) {
-                    if (GetTrackedRemoteCaps().ControllerCapabilities &
-                        ovrControllerCaps_HasSimpleHapticVibration) {
-                        if (HapticState != HAPTICS_SIMPLE_CLICKED) {
-                            vrapi_SetHapticVibrationSimple(ovr, GetDeviceID(), 1.0f);
-                            HapticState = HAPTICS_SIMPLE_CLICKED;
-                            HapticsSimpleValue = 1.0f;
-                        }
-                    } else {
-                        ALOG("Device does not support simple haptics?");
-                    }
-                } else {
-                    // huge epsilon value since there is so much noise in the grip trigger
-                    // and currently a problem with sending too many haptics values.
-                    if (HapticsSimpleValue < (remoteInputState.GripTrigger - 0.05f) ||
-                        HapticsSimpleValue > (remoteInputState.GripTrigger + 0.05f)) {
-                        vrapi_SetHapticVibrationSimple(
-                            ovr, GetDeviceID(), remoteInputState.GripTrigger);
-                        HapticState = HAPTICS_SIMPLE;
-                        HapticsSimpleValue = remoteInputState.GripTrigger;
-                    }
-                }
-            }
-        } else if (HapticState == HAPTICS_BUFFERED) {
-            ovrHapticBuffer hapticBuffer;
-            uint8_t dataBuffer[maxSamples];
-            hapticBuffer.BufferTime = vrFrame.PredictedDisplayTime;
-            hapticBuffer.NumSamples = maxSamples;
-            hapticBuffer.HapticBuffer = dataBuffer;
-            hapticBuffer.Terminated = true;
-
-            for (int i = 0; i < maxSamples; i++) {
-                dataBuffer[i] = (((float)i) / (float)maxSamples) * 255;
-            }
-
-            vrapi_SetHapticVibrationBuffer(ovr, GetDeviceID(), &hapticBuffer);
-            HapticState = HAPTICS_NONE;
-        } else if (HapticState == HAPTICS_SIMPLE || HapticState == HAPTICS_SIMPLE_CLICKED) {
-            vrapi_SetHapticVibrationSimple(ovr, GetDeviceID(), 0.0f);
-            HapticState = HAPTICS_NONE;
-            HapticsSimpleValue = 0.0f;
-        }
-    }
+// ovrInputDevice_TrackedRemote::UpdateHaptics
+void ovrInputDevice_TrackedRemote::UpdateHaptics(
+    ovrMobile* ovr,
+    const ovrApplFrameIn& vrFrame,
+    const float forceFeedback) {
+    // set from this frame's input snapshot
+    const ovrInputStateTrackedRemote& remoteInputState = GetInputState();
+
+    bool gripDown = (remoteInputState.Buttons & ovrButton_GripTrigger) > 0;
+    bool trigDown = (remoteInputState.Buttons & ovrButton_A) > 0;
+    trigDown |= (remoteInputState.Buttons & ovrButton_Trigger) > 0;
+    bool touchDown = remoteInputState.TrackpadStatus;
+    bool touchClicked = (remoteInputState.Buttons & ovrButton_Enter ||
+                         remoteInputState.Buttons & ovrButton_Joystick) > 0;
+
+    // with the grip held and the thumb down, the trigger plays a one second sawtooth, otherwise
+    // a click vibrates fully and the grip trigger sets the strength
+    const bool hapticsInput = gripDown && (touchDown || touchClicked);
+    const bool sawtooth = hapticsInput && trigDown;
+    float inputIntensity = 0.0f;
+    if (hapticsInput && !sawtooth) {
+        inputIntensity = touchClicked ? 1.0f : remoteInputState.GripTrigger;
+    }
+    Haptics.SetSustained(HAPTIC_CHANNEL_INPUT, inputIntensity);
+    if (sawtooth && SawtoothEffect < 0) {
+        SawtoothEffect = Haptics.Play(vrFrame.PredictedDisplayTime, 1.0, 0.0f, 1.0f, true);
+    } else if (!sawtooth && SawtoothEffect >= 0) {
+        Haptics.Stop(SawtoothEffect);
+        SawtoothEffect = -1;
+    }
+
+    Haptics.SetSustained(HAPTIC_CHANNEL_FORCE, forceFeedback);
+
+    ovrVrApiHapticsSink sink(ovr, GetDeviceID());
+    Haptics.Update(vrFrame.PredictedDisplayTime, sink);
 }
 
 } // namespace OVRFW
@@ -17,6 +17,8 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "VrApi_Input.h"
 
 #include "Appl.h"
+#include "AsyncLoader.h"
+#include "FrameTimings.h"
 #include "OVR_FileSys.h"
 #include "Model/SceneView.h"
 #include "Render/SurfaceRender.h"
@@ -27,6 +29,9 @@ Copyright   :   Copyright (c) Facebook Technologies, LLC and its affiliates. All
 #include "Render/Ribbon.h"
 #include "GUI/GuiSys.h"
 #include "Input/ArmModel.h"
+#include "Input/Haptics.h"
+#include "TeleopSender.h"
+#include "TelemetryReceiver.h"
 
 namespace OVRFW {
 
@@ -35,6 +40,7 @@ class ovrTextureAtlas;
 class ovrParticleSystem;
 class ovrTextureAtlas;
 class ovrBeamRenderer;
+class ovrControllerGUI;
 
 typedef std::vector<std::pair<ovrParticleSystem::handle_t, ovrBeamRenderer::handle_t>>
     jointHandles_t;
@@ -61,16 +67,17 @@ class ovrInputDevice_TrackedRemote : public ovrInputDeviceBase {
     ovrInputDevice_TrackedRemote(const ovrInputTrackedRemoteCapabilities& caps)
         : ovrInputDeviceBase(), MinTrackpad(FLT_MAX), MaxTrackpad(-FLT_MAX), Caps(caps) {
         IsActiveInputDevice = false;
+        Haptics.SetCapabilities(caps);
     }
 
     virtual ~ovrInputDevice_TrackedRemote() {}
 
     static ovrInputDeviceBase* Create(
-        OVRFW::ovrAppl& app,
         OvrGuiSys& guiSys,
         VRMenu& menu,
         const ovrInputTrackedRemoteCapabilities& capsHeader);
-    void UpdateHaptics(ovrMobile* ovr, const ovrApplFrameIn& vrFrame);
+    // forceFeedback is how hard the robot pushes back, 0 to 1
+    void UpdateHaptics(ovrMobile* ovr, const ovrApplFrameIn& vrFrame, const float forceFeedback);
     virtual const ovrInputCapabilityHeader* GetCaps() const override {
         return &Caps.Header;
     }
@@ -104,6 +111,13 @@ class ovrInputDevice_TrackedRemote : public ovrInputDeviceBase {
         return Caps;
     }
 
+    const ovrInputStateTrackedRemote& GetInputState() const {
+        return InputState;
+    }
+    void SetInputState(const ovrInputStateTrackedRemote& inputState) {
+        InputState = inputState;
+    }
+
     OVR::Vector2f MinTrackpad;
     OVR::Vector2f MaxTrackpad;
     bool IsActiveInputDevice;
@@ -112,8 +126,9 @@ class ovrInputDevice_TrackedRemote : public ovrInputDeviceBase {
     ovrInputTrackedRemoteCapabilities Caps;
     std::vector<ovrDrawSurface> Surfaces;
     ovrTracking Tracking;
-    uint32_t HapticState;
-    float HapticsSimpleValue;
+    ovrInputStateTrackedRemote InputState = {};
+    ovrHapticsEngine Haptics;
+    int SawtoothEffect = -1;
 };
 
 //==============================================================
@@ -241,7 +256,7 @@ class ovrVrInput : public OVRFW::ovrAppl {
 
     double LastGamepadUpdateTimeInSeconds;
 
-    VRMenu* Menu;
+    ovrControllerGUI* Menu;
 
     // because a single GO controller can be a left or right controller dependent on the
     // user's handedness (dominant hand) setting, we can't simply track controllers using a left
@@ -257,19 +272,51 @@ class ovrVrInput : public OVRFW::ovrAppl {
 
     ovrDeviceType DeviceType;
 
+    // time spent on asset uploads on the render thread each frame, a texture or buffer at a time
+    static constexpr double ASSET_UPLOAD_BUDGET_SECONDS = 0.002;
+    OVRFW::ovrAsyncLoader AssetLoader;
+    // cooked model geometry, empty if the app's cache folder isn't usable
+    std::string ModelCacheFolder;
+
+    // head and controller state streamed to the robot, independent of the display rate
+    static constexpr const char* TELEOP_HOST = "192.168.1.239";
+    static constexpr int TELEOP_PORT = 5005;
+    static constexpr int TELEOP_RATE_HZ = 250;
+    ovrTeleopSender TeleopSender;
+    // robot telemetry, which also acknowledges teleop packets and measures the round trip
+    static constexpr int TELEMETRY_PORT = 5006;
+    ovrTelemetryReceiver TelemetryReceiver;
+    ovrTelemetrySample LatestTelemetry;
+    bool HasTelemetry;
+    // servo current that maps to no and to full force feedback on the controllers
+    static constexpr float FORCE_FEEDBACK_MIN_AMPS = 0.5f;
+    static constexpr float FORCE_FEEDBACK_MAX_AMPS = 2.0f;
+    static constexpr double FORCE_FEEDBACK_STALE_SECONDS = 0.5;
+    // CPU time of each part of AppRenderFrame, logged every few seconds
+    OVRFW::ovrFrameTimings FrameTimings;
+
    private:
     void ClearAndHideMenuItems();
-    ovrResult PopulateRemoteControllerInfo(ovrInputDevice_TrackedRemote& trDevice);
+    void LoadControllerModelAsync(const char* uri, ModelFile** outModel);
+    std::string GetModelCachePath(const char* uri) const;
+    void SetControllerSurfaces(ovrInputDevice_TrackedRemote& trDevice);
+    ovrResult PopulateRemoteControllerInfo(
+        ovrInputDevice_TrackedRemote& trDevice,
+        const ovrInputSnapshot& input,
+        const ovrInputDeviceSnapshot& snapshot);
     void ResetLaserPointer();
 
     int FindInputDevice(const ovrDeviceID deviceID) const;
     void RemoveDevice(const ovrDeviceID deviceID);
     bool IsDeviceTracked(const ovrDeviceID deviceID) const;
 
-    void EnumerateInputDevices();
+    void PublishTeleopState(const OVRFW::ovrApplFrameIn& in);
+    float GetForceFeedback() const;
+
+    void EnumerateInputDevices(const ovrInputSnapshot& input);
     void RenderRunningFrame(const OVRFW::ovrApplFrameIn& in, OVRFW::ovrRendererOutput& out);
 
-    void OnDeviceConnected(const ovrInputCapabilityHeader& capsHeader);
+    void OnDeviceConnected(const ovrInputDeviceSnapshot& snapshot);
     void OnDeviceDisconnected(ovrDeviceID const disconnectedDeviceID);
     bool OnKeyEvent(const int keyCode, const int action);
 };